@@ -19,10 +19,16 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
 */
 
-#include <time.h>
 #include "ximaging.h"
+#include "xrandom.h"
+
+// Number of pixels to generate random numbers for at once
+#define RANDOM_BLOCK_SIZE (64)
 
 // Add uniform additive noise to the specified image
+//
+// Random numbers come from the counter based generator keyed by the seed and pixel's coordinates,
+// so rows can be processed in parallel, while the result does not depend on number of threads.
 XErrorCode UniformAdditiveNoise( ximage* src, uint32_t seed, uint8_t amplitude )
 {
     XErrorCode ret = SuccessCode;
@@ -40,53 +46,51 @@ XErrorCode UniformAdditiveNoise( ximage* src, uint32_t seed, uint8_t amplitude )
     else
     {
         int32_t     noiseAmplitude = amplitude;
-        int32_t     randMax = noiseAmplitude * 2 + 1;
-        int32_t     value;
-        int         width  = src->width;
-        int         height = src->height;
-        int         stride = src->stride;
-        int         x, y;
+        uint32_t    randMax   = (uint32_t) noiseAmplitude * 2 + 1;
+        int         width     = src->width;
+        int         height    = src->height;
+        int         stride    = src->stride;
+        int         pixelSize = ( src->format == XPixelFormatGrayscale8 ) ? 1 : ( ( src->format == XPixelFormatRGB24 ) ? 3 : 4 );
+        int         y;
         uint8_t*    ptr = src->data;
-        uint8_t*    row;
-
-        // initialize random number generator
-        srand( seed );
 
-        if ( src->format == XPixelFormatGrayscale8 )
+        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, seed, noiseAmplitude, randMax )
+        for ( y = 0; y < height; y++ )
         {
-            for ( y = 0; y < height; y++ )
+            uint8_t* row = ptr + y * stride;
+            uint32_t randoms[RANDOM_BLOCK_SIZE * 4];
+            uint32_t* rnd;
+            int32_t  value;
+            int      x, blockStart, blockSize;
+
+            for ( blockStart = 0; blockStart < width; blockStart += RANDOM_BLOCK_SIZE )
             {
-                row = ptr + y * stride;
+                blockSize = XMIN( RANDOM_BLOCK_SIZE, width - blockStart );
 
-                for ( x = 0; x < width; x++ )
+                XRandom4Batch( seed, 0, (uint32_t) y, (uint32_t) blockStart, (uint32_t) blockSize, randoms );
+
+                if ( pixelSize == 1 )
                 {
-                    value = ( rand( ) % randMax ) - noiseAmplitude + *row;
-                    *row = (uint8_t) XINRANGE( value, 0, 255 );
-                    row++;
+                    for ( x = 0, rnd = randoms; x < blockSize; x++, rnd += 4, row++ )
+                    {
+                        value = (int32_t) XRANDOM_RANGE( rnd[0], randMax ) - noiseAmplitude + *row;
+                        *row = (uint8_t) XINRANGE( value, 0, 255 );
+                    }
                 }
-            }
-        }
-        else
-        {
-            int pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
-
-            for ( y = 0; y < height; y++ )
-            {
-                row = ptr + y * stride;
-
-                for ( x = 0; x < width; x++ )
+                else
                 {
-                    // red
-                    value = ( rand( ) % randMax ) - noiseAmplitude + row[RedIndex];
-                    row[RedIndex] = (uint8_t) XINRANGE( value, 0, 255 );
-                    // green
-                    value = ( rand( ) % randMax ) - noiseAmplitude + row[GreenIndex];
-                    row[GreenIndex] = (uint8_t) XINRANGE( value, 0, 255 );
-                    // blue
-                    value = ( rand( ) % randMax ) - noiseAmplitude + row[BlueIndex];
-                    row[BlueIndex] = (uint8_t) XINRANGE( value, 0, 255 );
-
-                    row += pixelSize;
+                    for ( x = 0, rnd = randoms; x < blockSize; x++, rnd += 4, row += pixelSize )
+                    {
+                        // red
+                        value = (int32_t) XRANDOM_RANGE( rnd[0], randMax ) - noiseAmplitude + row[RedIndex];
+                        row[RedIndex] = (uint8_t) XINRANGE( value, 0, 255 );
+                        // green
+                        value = (int32_t) XRANDOM_RANGE( rnd[1], randMax ) - noiseAmplitude + row[GreenIndex];
+                        row[GreenIndex] = (uint8_t) XINRANGE( value, 0, 255 );
+                        // blue
+                        value = (int32_t) XRANDOM_RANGE( rnd[2], randMax ) - noiseAmplitude + row[BlueIndex];
+                        row[BlueIndex] = (uint8_t) XINRANGE( value, 0, 255 );
+                    }
                 }
             }
         }
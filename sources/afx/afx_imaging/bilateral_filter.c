@@ -0,0 +1,443 @@
+/*
+    Imaging library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "ximaging.h"
+#include "xcpuid.h"
+
+// SSE intrinsics
+#ifdef _MSC_VER
+    #include <intrin.h>
+#elif __GNUC__
+    #include <x86intrin.h>
+#endif
+
+// Bilateral filter is implemented using bilateral grid (Chen, Paris, Durand - "Real-time Edge-Aware Image
+// Processing with the Bilateral Grid"). Image pixels are accumulated into a 3D grid, which is downsampled by
+// spatial sigma in X/Y dimensions and by color sigma in intensity dimension. The grid is then blurred with
+// a small Gaussian kernel and the result is sliced back by trilinear interpolation. Since the grid is smaller
+// than the image by spatialSigma^2 * colorSigma, the cost does not depend much on the filter size.
+//
+// Color images use luminance for the intensity dimension, while accumulating all RGB values in the grid.
+
+// Number of empty cells around the grid, so the [1 4 6 4 1] blur kernel does not need to check boundaries
+#define GRID_PADDING (2)
+
+// The grid - every cell keeps weight (number of pixels accumulated) and sum of pixel values
+typedef struct
+{
+    int    width;
+    int    height;
+    int    depth;
+    int    channels;
+    float* cells;
+}
+BilateralGrid;
+
+// Interpolation position within the grid
+typedef struct
+{
+    int   index;
+    float weight;
+}
+GridPosition;
+
+// forward declaration ----
+static void SplatImage( const ximage* src, BilateralGrid* grid, const int* gridX, const int* gridY, const int* gridZ, float spatialSigma );
+static XErrorCode BlurGrid( BilateralGrid* grid );
+static void SliceImage( const ximage* src, ximage* dst, const BilateralGrid* grid, GridPosition* posX, float spatialSigma, float colorSigma );
+// ------------------------
+
+// Edge preserving smoothing, which averages pixels taking into account both spatial distance and color similarity
+XErrorCode BilateralFilter( const ximage* src, ximage* dst, float spatialSigma, float colorSigma )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( src == 0 ) || ( dst == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( src->format != XPixelFormatGrayscale8 ) &&
+              ( src->format != XPixelFormatRGB24 ) &&
+              ( src->format != XPixelFormatRGBA32 ) )
+    {
+        ret = ErrorUnsupportedPixelFormat;
+    }
+    else if ( ( dst->width  != src->width  ) || ( dst->height != src->height ) || ( dst->format != src->format ) )
+    {
+        ret = ErrorImageParametersMismatch;
+    }
+    else if ( ( spatialSigma < 1.0f ) || ( colorSigma < 1.0f ) )
+    {
+        ret = ErrorArgumentOutOfRange;
+    }
+    else
+    {
+        int  width  = src->width;
+        int  height = src->height;
+        int* gridX  = (int*) malloc( sizeof( int ) * width );
+        int* gridY  = (int*) malloc( sizeof( int ) * height );
+        int  gridZ[256];
+        int  i;
+
+        // interpolation positions for slicing the grid
+        GridPosition* posX = (GridPosition*) malloc( sizeof( GridPosition ) * width );
+
+        BilateralGrid grid;
+
+        grid.width    = (int) ( ( width  - 1 ) / spatialSigma + 0.5f ) + 1 + 2 * GRID_PADDING;
+        grid.height   = (int) ( ( height - 1 ) / spatialSigma + 0.5f ) + 1 + 2 * GRID_PADDING;
+        grid.depth    = (int) ( 255 / colorSigma + 0.5f ) + 1 + 2 * GRID_PADDING;
+        grid.channels = ( src->format == XPixelFormatGrayscale8 ) ? 2 : 4;
+        grid.cells    = (float*) calloc( (size_t) grid.width * grid.height * grid.depth * grid.channels, sizeof( float ) );
+
+        if ( ( gridX == 0 ) || ( gridY == 0 ) || ( posX == 0 ) || ( grid.cells == 0 ) )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            // grid cells to accumulate pixels into
+            for ( i = 0; i < width; i++ )
+            {
+                gridX[i] = (int) ( i / spatialSigma + 0.5f ) + GRID_PADDING;
+            }
+            for ( i = 0; i < height; i++ )
+            {
+                gridY[i] = (int) ( i / spatialSigma + 0.5f ) + GRID_PADDING;
+            }
+            for ( i = 0; i < 256; i++ )
+            {
+                gridZ[i] = (int) ( i / colorSigma + 0.5f ) + GRID_PADDING;
+            }
+
+            SplatImage( src, &grid, gridX, gridY, gridZ, spatialSigma );
+
+            ret = BlurGrid( &grid );
+
+            if ( ret == SuccessCode )
+            {
+                SliceImage( src, dst, &grid, posX, spatialSigma, colorSigma );
+            }
+        }
+
+        free( gridX );
+        free( gridY );
+        free( posX );
+        free( grid.cells );
+    }
+
+    return ret;
+}
+
+// Accumulate image pixels into grid cells
+static void SplatImage( const ximage* src, BilateralGrid* grid, const int* gridX, const int* gridY, const int* gridZ, float spatialSigma )
+{
+    int      width      = src->width;
+    int      height     = src->height;
+    int      stride     = src->stride;
+    int      pixelSize  = ( src->format == XPixelFormatGrayscale8 ) ? 1 : ( ( src->format == XPixelFormatRGB24 ) ? 3 : 4 );
+    int      channels   = grid->channels;
+    int      cellStride = grid->depth * channels;
+    int      rowStride  = grid->width * cellStride;
+    uint8_t* ptr        = src->data;
+    int      gy;
+
+    // every thread takes the grid rows, which don't intersect with other threads
+    #pragma omp parallel for schedule(static) shared( ptr, width, height, stride, pixelSize, channels, cellStride, rowStride, gridX, gridY, gridZ, grid, spatialSigma )
+    for ( gy = GRID_PADDING; gy < grid->height - GRID_PADDING; gy++ )
+    {
+        float* gridRow = grid->cells + gy * rowStride;
+        int    y, x;
+
+        // find the first image row going into this grid row
+        y = (int) ( ( gy - GRID_PADDING - 0.5f ) * spatialSigma );
+        y = XMAX( 0, XMIN( y, height - 1 ) );
+        while ( ( y > 0 ) && ( gridY[y] >= gy ) )
+        {
+            y--;
+        }
+        while ( ( y < height ) && ( gridY[y] < gy ) )
+        {
+            y++;
+        }
+
+        for ( ; ( y < height ) && ( gridY[y] == gy ); y++ )
+        {
+            const uint8_t* row = ptr + y * stride;
+            float*         cell;
+
+            if ( channels == 2 )
+            {
+                for ( x = 0; x < width; x++, row++ )
+                {
+                    cell = gridRow + gridX[x] * cellStride + gridZ[*row] * 2;
+
+                    cell[0] += 1.0f;
+                    cell[1] += *row;
+                }
+            }
+            else
+            {
+                for ( x = 0; x < width; x++, row += pixelSize )
+                {
+                    cell = gridRow + gridX[x] * cellStride +
+                           gridZ[RGB_TO_GRAY( row[RedIndex], row[GreenIndex], row[BlueIndex] )] * 4;
+
+                    cell[0] += 1.0f;
+                    cell[1] += row[RedIndex];
+                    cell[2] += row[GreenIndex];
+                    cell[3] += row[BlueIndex];
+                }
+            }
+        }
+    }
+}
+
+// Maximum number of floats processed by one blur task
+#define BLUR_CHUNK_SIZE (512)
+
+// Blur a chunk of grid data along one dimension with [1 4 6 4 1] kernel - cells outside of the grid are treated
+// as empty. The chunk has "count" blocks of "size" floats, which are "step" floats apart. Blurring is done in place,
+// keeping copies of the two previous (original) blocks. Kernel is not normalized, since the final value is a ratio of
+// blurred sum and blurred weight.
+static void BlurGridChunk( float* data, int count, int step, int size, float* prev2, float* prev1, float* temp )
+{
+    float* swap;
+    int    i, k;
+
+    memset( prev2, 0, sizeof( float ) * size );
+    memset( prev1, 0, sizeof( float ) * size );
+
+    for ( i = 0; i < count; i++ )
+    {
+        float*       block = data + i * step;
+        const float* next1 = ( i + 1 < count ) ? block + step     : 0;
+        const float* next2 = ( i + 2 < count ) ? block + 2 * step : 0;
+
+        for ( k = 0; k < size; k++ )
+        {
+            temp[k] = prev2[k] + 4.0f * prev1[k] + 6.0f * block[k];
+        }
+        if ( next1 != 0 )
+        {
+            for ( k = 0; k < size; k++ )
+            {
+                temp[k] += 4.0f * next1[k];
+            }
+        }
+        if ( next2 != 0 )
+        {
+            for ( k = 0; k < size; k++ )
+            {
+                temp[k] += next2[k];
+            }
+        }
+
+        // original block becomes previous one, while blurred values are put into the grid
+        swap  = prev2;
+        prev2 = prev1;
+        prev1 = swap;
+
+        memcpy( prev1, block, sizeof( float ) * size );
+        memcpy( block, temp,  sizeof( float ) * size );
+    }
+}
+
+// Blur the grid in all 3 dimensions
+static XErrorCode BlurGrid( BilateralGrid* grid )
+{
+    int  channels    = grid->channels;
+    bool outOfMemory = false;
+    int  dimension;
+
+    // grid data is treated as "outer x count x inner" array for each dimension to blur (X, Y and Z)
+    int outers[3] = { grid->height, 1, grid->height * grid->width };
+    int counts[3] = { grid->width, grid->height, grid->depth };
+    int inners[3] = { grid->depth * channels, grid->width * grid->depth * channels, channels };
+
+    for ( dimension = 0; dimension < 3; dimension++ )
+    {
+        int count     = counts[dimension];
+        int inner     = inners[dimension];
+        int chunkSize = XMIN( inner, BLUR_CHUNK_SIZE );
+        int chunks    = ( inner + chunkSize - 1 ) / chunkSize;
+        int tasks     = outers[dimension] * chunks;
+
+        #pragma omp parallel shared( grid, count, inner, chunkSize, chunks, tasks, outOfMemory )
+        {
+            float* buffers = (float*) malloc( sizeof( float ) * chunkSize * 3 );
+            int    task;
+
+            #pragma omp for schedule(static)
+            for ( task = 0; task < tasks; task++ )
+            {
+                int chunkStart = ( task % chunks ) * chunkSize;
+
+                if ( buffers != 0 )
+                {
+                    BlurGridChunk( grid->cells + ( task / chunks ) * count * inner + chunkStart, count, inner,
+                                   XMIN( chunkSize, inner - chunkStart ), buffers, buffers + chunkSize, buffers + 2 * chunkSize );
+                }
+                else
+                {
+                    outOfMemory = true;
+                }
+            }
+
+            free( buffers );
+        }
+    }
+
+    return ( outOfMemory ) ? ErrorOutOfMemory : SuccessCode;
+}
+
+static GridPosition GetGridPosition( float coordinate, int maxIndex )
+{
+    GridPosition pos;
+
+    pos.index  = (int) coordinate;
+    pos.weight = coordinate - pos.index;
+
+    if ( pos.index >= maxIndex )
+    {
+        pos.index  = maxIndex - 1;
+        pos.weight = 1.0f;
+    }
+
+    return pos;
+}
+
+// Get result image by interpolating blurred grid
+void SliceImage( const ximage* src, ximage* dst, const BilateralGrid* grid, GridPosition* posX, float spatialSigma, float colorSigma )
+{
+    int      width      = src->width;
+    int      height     = src->height;
+    int      srcStride  = src->stride;
+    int      dstStride  = dst->stride;
+    int      pixelSize  = ( src->format == XPixelFormatGrayscale8 ) ? 1 : ( ( src->format == XPixelFormatRGB24 ) ? 3 : 4 );
+    int      channels   = grid->channels;
+    int      cellStride = grid->depth * channels;
+    int      rowStride  = grid->width * cellStride;
+    uint8_t* srcPtr     = src->data;
+    uint8_t* dstPtr     = dst->data;
+    bool     useSSE     = IsSSE2( );
+    int      y, i;
+
+    GridPosition posZ[256];
+
+    for ( i = 0; i < width; i++ )
+    {
+        posX[i] = GetGridPosition( i / spatialSigma + GRID_PADDING, grid->width - 1 );
+    }
+    for ( i = 0; i < 256; i++ )
+    {
+        posZ[i] = GetGridPosition( i / colorSigma + GRID_PADDING, grid->depth - 1 );
+    }
+
+    #pragma omp parallel for schedule(static) shared( srcPtr, dstPtr, width, srcStride, dstStride, pixelSize, channels, cellStride, rowStride, posX, posZ, grid, spatialSigma, useSSE )
+    for ( y = 0; y < height; y++ )
+    {
+        const uint8_t* srcRow = srcPtr + y * srcStride;
+        uint8_t*       dstRow = dstPtr + y * dstStride;
+        GridPosition   py     = GetGridPosition( y / spatialSigma + GRID_PADDING, grid->height - 1 );
+        const float*   row0   = grid->cells + py.index * rowStride;
+        const float*   row1   = row0 + rowStride;
+        float          wy1    = py.weight;
+        float          wy0    = 1.0f - wy1;
+        float          sums[4];
+        int            x, c, value;
+
+        for ( x = 0; x < width; x++, srcRow += pixelSize, dstRow += pixelSize )
+        {
+            GridPosition px = posX[x];
+            GridPosition pz;
+            const float* c000;
+            float        w[8];
+
+            value = ( pixelSize == 1 ) ? *srcRow : (int) RGB_TO_GRAY( srcRow[RedIndex], srcRow[GreenIndex], srcRow[BlueIndex] );
+            pz    = posZ[value];
+
+            w[0] = wy0 * ( 1.0f - px.weight ) * ( 1.0f - pz.weight );
+            w[1] = wy0 * ( 1.0f - px.weight ) * pz.weight;
+            w[2] = wy0 * px.weight * ( 1.0f - pz.weight );
+            w[3] = wy0 * px.weight * pz.weight;
+            w[4] = wy1 * ( 1.0f - px.weight ) * ( 1.0f - pz.weight );
+            w[5] = wy1 * ( 1.0f - px.weight ) * pz.weight;
+            w[6] = wy1 * px.weight * ( 1.0f - pz.weight );
+            w[7] = wy1 * px.weight * pz.weight;
+
+            if ( ( useSSE ) && ( channels == 4 ) )
+            {
+                // all 4 values of a cell are interpolated at once
+                const float* c100;
+                __m128       acc;
+
+                c000 = row0 + px.index * cellStride + pz.index * 4;
+                c100 = row1 + px.index * cellStride + pz.index * 4;
+
+                acc = _mm_mul_ps( _mm_set1_ps( w[0] ), _mm_loadu_ps( c000 ) );
+                acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( w[1] ), _mm_loadu_ps( c000 + 4 ) ) );
+                acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( w[2] ), _mm_loadu_ps( c000 + cellStride ) ) );
+                acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( w[3] ), _mm_loadu_ps( c000 + cellStride + 4 ) ) );
+                acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( w[4] ), _mm_loadu_ps( c100 ) ) );
+                acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( w[5] ), _mm_loadu_ps( c100 + 4 ) ) );
+                acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( w[6] ), _mm_loadu_ps( c100 + cellStride ) ) );
+                acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( w[7] ), _mm_loadu_ps( c100 + cellStride + 4 ) ) );
+
+                _mm_storeu_ps( sums, acc );
+            }
+            else
+            {
+                for ( c = 0; c < channels; c++ )
+                {
+                    c000 = row0 + px.index * cellStride + pz.index * channels + c;
+
+                    sums[c] = w[0] * c000[0] + w[1] * c000[channels] + w[2] * c000[cellStride] + w[3] * c000[cellStride + channels];
+
+                    c000 = row1 + px.index * cellStride + pz.index * channels + c;
+
+                    sums[c] += w[4] * c000[0] + w[5] * c000[channels] + w[6] * c000[cellStride] + w[7] * c000[cellStride + channels];
+                }
+            }
+
+            // the pixel itself always contributes to the grid, so weight is never zero
+            sums[0] = 1.0f / sums[0];
+
+            if ( pixelSize == 1 )
+            {
+                *dstRow = (uint8_t) XMIN( 255, (int) ( sums[1] * sums[0] + 0.5f ) );
+            }
+            else
+            {
+                dstRow[RedIndex]   = (uint8_t) XMIN( 255, (int) ( sums[1] * sums[0] + 0.5f ) );
+                dstRow[GreenIndex] = (uint8_t) XMIN( 255, (int) ( sums[2] * sums[0] + 0.5f ) );
+                dstRow[BlueIndex]  = (uint8_t) XMIN( 255, (int) ( sums[3] * sums[0] + 0.5f ) );
+
+                if ( pixelSize == 4 )
+                {
+                    dstRow[AlphaIndex] = srcRow[AlphaIndex];
+                }
+            }
+        }
+    }
+}
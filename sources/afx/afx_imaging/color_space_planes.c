@@ -0,0 +1,889 @@
+/*
+    Imaging library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <stdlib.h>
+#include <math.h>
+#include "ximaging.h"
+#include "xcpuid.h"
+#include "xonce.h"
+
+// SSE intrinsics
+#ifdef _MSC_VER
+    #include <intrin.h>
+#elif __GNUC__
+    #include <x86intrin.h>
+#endif
+
+// Color spaces supported by the bulk conversion
+enum
+{
+    ColorSpaceHsl = 0,
+    ColorSpaceHsv,
+    ColorSpaceYCbCr,
+    ColorSpaceLab
+};
+
+// Mapping of natural channel values into 8 bpp planes: value8 = value * scale + offset
+static const float PlaneScale[4][3] =
+{
+    { 0.5f, 255.0f, 255.0f },   // HSL
+    { 0.5f, 255.0f, 255.0f },   // HSV
+    { 1.0f,   1.0f,   1.0f },   // YCbCr
+    { 2.55f,  1.0f,   1.0f }    // Lab
+};
+static const float PlaneOffset[4][3] =
+{
+    { 0.0f, 0.0f,   0.0f },
+    { 0.0f, 0.0f,   0.0f },
+    { 0.0f, 0.0f,   0.0f },
+    { 0.0f, 128.0f, 128.0f }
+};
+
+// Size of the table used to convert linear RGB values back to sRGB
+#define LINEAR_TO_SRGB_LUT_SIZE (16384)
+
+// Lookup tables for sRGB <-> linear RGB conversion (Lab color space)
+static float   SrgbToLinearLut[256];
+static uint8_t LinearToSrgbLut[LINEAR_TO_SRGB_LUT_SIZE + 1];
+static xonce    LabLutsOnce = XONCE_INIT;
+
+// Fill lookup tables for sRGB <-> linear RGB conversion
+static void FillLabLuts( void )
+{
+    int i;
+
+    for ( i = 0; i < 256; i++ )
+    {
+        double v = i / 255.0;
+
+        SrgbToLinearLut[i] = (float) ( ( v <= 0.04045 ) ? ( v / 12.92 ) : pow( ( v + 0.055 ) / 1.055, 2.4 ) );
+    }
+
+    for ( i = 0; i <= LINEAR_TO_SRGB_LUT_SIZE; i++ )
+    {
+        double v = (double) i / LINEAR_TO_SRGB_LUT_SIZE;
+
+        v = ( v <= 0.0031308 ) ? ( v * 12.92 ) : ( 1.055 * pow( v, 1.0 / 2.4 ) - 0.055 );
+
+        LinearToSrgbLut[i] = (uint8_t) XINRANGE( (int) ( v * 255.0 + 0.5 ), 0, 255 );
+    }
+}
+
+// Make sure lookup tables are filled (images may be converted by several threads)
+static void InitLabLuts( void )
+{
+    XCallOnce( &LabLutsOnce, FillLabLuts );
+}
+
+// Constants of Lab conversion - sRGB primaries and D65 white point (folded into the matrices)
+#define LAB_EPSILON     (0.008856f)
+#define LAB_KAPPA       (7.787f)
+#define LAB_F_EPSILON   (0.206893f)
+#define LAB_16_116      (0.137931f)
+
+static const float RgbToXyz[9] =
+{
+    0.4124564f / 0.95047f, 0.3575761f / 0.95047f, 0.1804375f / 0.95047f,
+    0.2126729f,            0.7151522f,            0.0721750f,
+    0.0193339f / 1.08883f, 0.1191920f / 1.08883f, 0.9503041f / 1.08883f
+};
+static const float XyzToRgb[9] =
+{
+     3.2404542f * 0.95047f, -1.5371385f, -0.4985314f * 1.08883f,
+    -0.9692660f * 0.95047f,  1.8760108f,  0.0415560f * 1.08883f,
+     0.0556434f * 0.95047f, -0.2040259f,  1.0572252f * 1.08883f
+};
+
+// ----- Scalar routines working with single pixel -----
+
+// Fast cube root for positive values - initial guess from the exponent bits refined with Newton's method
+static float CubeRoot( float x )
+{
+    union { float f; int32_t i; } v;
+    float y;
+
+    v.f = x;
+    v.i = (int32_t) ( (float) v.i * ( 1.0f / 3.0f ) ) + 0x2A5137A0;
+    y   = v.f;
+
+    y = ( 2.0f * y + x / ( y * y ) ) * ( 1.0f / 3.0f );
+    y = ( 2.0f * y + x / ( y * y ) ) * ( 1.0f / 3.0f );
+    y = ( 2.0f * y + x / ( y * y ) ) * ( 1.0f / 3.0f );
+
+    return y;
+}
+
+// Get hue in [0, 360) range from normalized RGB values and their max/delta
+static float CalculateHue( float r, float g, float b, float max, float delta )
+{
+    float hue = 0.0f;
+
+    if ( delta > 0.0f )
+    {
+        if ( r == max )
+        {
+            hue = ( g - b ) / delta;
+            if ( hue < 0.0f ) hue += 6.0f;
+        }
+        else if ( g == max )
+        {
+            hue = 2.0f + ( b - r ) / delta;
+        }
+        else
+        {
+            hue = 4.0f + ( r - g ) / delta;
+        }
+
+        hue *= 60.0f;
+    }
+
+    return hue;
+}
+
+static void RgbToHsl( float r, float g, float b, float* h, float* s, float* l )
+{
+    float max   = XMAX3( r, g, b );
+    float min   = XMIN3( r, g, b );
+    float delta = max - min;
+    float sum   = max + min;
+
+    *h = CalculateHue( r, g, b, max, delta );
+    *l = sum * 0.5f;
+    *s = ( delta > 0.0f ) ? delta / ( ( *l <= 0.5f ) ? sum : ( 2.0f - max - min ) ) : 0.0f;
+}
+
+static void RgbToHsv( float r, float g, float b, float* h, float* s, float* v )
+{
+    float max   = XMAX3( r, g, b );
+    float min   = XMIN3( r, g, b );
+    float delta = max - min;
+
+    *h = CalculateHue( r, g, b, max, delta );
+    *s = ( max > 0.0f ) ? delta / max : 0.0f;
+    *v = max;
+}
+
+// Wrap hue value into [0, 360) range
+static float WrapHue( float hue )
+{
+    return hue - 360.0f * (float) floor( hue * ( 1.0f / 360.0f ) );
+}
+
+// HSL to normalized RGB, where every channel is "L - a * max( -1, min( k - 3, 9 - k, 1 ) )" and "k = ( n + H / 30 ) mod 12"
+static float HslChannel( float n, float h, float l, float a )
+{
+    float k = n + h * ( 1.0f / 30.0f );
+
+    if ( k >= 12.0f ) k -= 12.0f;
+
+    return l - a * XINRANGE( XMIN( k - 3.0f, 9.0f - k ), -1.0f, 1.0f );
+}
+
+static void HslToRgb( float h, float s, float l, float* r, float* g, float* b )
+{
+    float a = s * XMIN( l, 1.0f - l );
+
+    h  = WrapHue( h );
+    *r = HslChannel( 0.0f, h, l, a );
+    *g = HslChannel( 8.0f, h, l, a );
+    *b = HslChannel( 4.0f, h, l, a );
+}
+
+// HSV to normalized RGB, where every channel is "V - V * S * max( 0, min( k, 4 - k, 1 ) )" and "k = ( n + H / 60 ) mod 6"
+static float HsvChannel( float n, float h, float vs, float v )
+{
+    float k = n + h * ( 1.0f / 60.0f );
+
+    if ( k >= 6.0f ) k -= 6.0f;
+
+    return v - vs * XINRANGE( XMIN( k, 4.0f - k ), 0.0f, 1.0f );
+}
+
+static void HsvToRgb( float h, float s, float v, float* r, float* g, float* b )
+{
+    float vs = v * s;
+
+    h  = WrapHue( h );
+    *r = HsvChannel( 5.0f, h, vs, v );
+    *g = HsvChannel( 3.0f, h, vs, v );
+    *b = HsvChannel( 1.0f, h, vs, v );
+}
+
+static void RgbToYCbCr( float r, float g, float b, float* y, float* cb, float* cr )
+{
+    *y  =           0.299f    * r + 0.587f    * g + 0.114f    * b;
+    *cb = 128.0f -  0.168736f * r - 0.331264f * g + 0.5f      * b;
+    *cr = 128.0f +  0.5f      * r - 0.418688f * g - 0.081312f * b;
+}
+
+static void YCbCrToRgb( float y, float cb, float cr, float* r, float* g, float* b )
+{
+    cb -= 128.0f;
+    cr -= 128.0f;
+
+    *r = y + 1.402f    * cr;
+    *g = y - 0.344136f * cb - 0.714136f * cr;
+    *b = y + 1.772f    * cb;
+}
+
+static float LabF( float t )
+{
+    return ( t > LAB_EPSILON ) ? CubeRoot( t ) : LAB_KAPPA * t + LAB_16_116;
+}
+
+static float LabInvF( float f )
+{
+    return ( f > LAB_F_EPSILON ) ? f * f * f : ( f - LAB_16_116 ) * ( 1.0f / LAB_KAPPA );
+}
+
+// Lab conversion takes linear RGB values in [0, 1] range
+static void LinearRgbToLab( float r, float g, float b, float* l, float* a, float* bb )
+{
+    float fx = LabF( RgbToXyz[0] * r + RgbToXyz[1] * g + RgbToXyz[2] * b );
+    float fy = LabF( RgbToXyz[3] * r + RgbToXyz[4] * g + RgbToXyz[5] * b );
+    float fz = LabF( RgbToXyz[6] * r + RgbToXyz[7] * g + RgbToXyz[8] * b );
+
+    *l  = 116.0f * fy - 16.0f;
+    *a  = 500.0f * ( fx - fy );
+    *bb = 200.0f * ( fy - fz );
+}
+
+static void LabToLinearRgb( float l, float a, float bb, float* r, float* g, float* b )
+{
+    float fy = ( l + 16.0f ) * ( 1.0f / 116.0f );
+    float x  = LabInvF( fy + a  * ( 1.0f / 500.0f ) );
+    float y  = LabInvF( fy );
+    float z  = LabInvF( fy - bb * ( 1.0f / 200.0f ) );
+
+    *r = XyzToRgb[0] * x + XyzToRgb[1] * y + XyzToRgb[2] * z;
+    *g = XyzToRgb[3] * x + XyzToRgb[4] * y + XyzToRgb[5] * z;
+    *b = XyzToRgb[6] * x + XyzToRgb[7] * y + XyzToRgb[8] * z;
+}
+
+// Convert normalized float value to 8 bit, rounding and clamping it
+static uint8_t UnitToByte( float v )
+{
+    v = v * 255.0f + 0.5f;
+    return (uint8_t) ( ( v <= 0.0f ) ? 0 : ( ( v >= 255.0f ) ? 255 : (int) v ) );
+}
+
+static uint8_t LinearToSrgb( float v )
+{
+    v = XINRANGE( v, 0.0f, 1.0f );
+    return LinearToSrgbLut[(int) ( v * LINEAR_TO_SRGB_LUT_SIZE + 0.5f )];
+}
+
+// ----- SSE2 routines working with 4 pixels at a time -----
+
+static __m128 SelectSSE2( __m128 mask, __m128 a, __m128 b )
+{
+    return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+static __m128 ClampSSE2( __m128 v, __m128 min, __m128 max )
+{
+    return _mm_min_ps( _mm_max_ps( v, min ), max );
+}
+
+// Floor for values, which fit into 32 bit integer
+static __m128 FloorSSE2( __m128 v )
+{
+    __m128 t = _mm_cvtepi32_ps( _mm_cvttps_epi32( v ) );
+    return _mm_sub_ps( t, _mm_and_ps( _mm_cmpgt_ps( t, v ), _mm_set1_ps( 1.0f ) ) );
+}
+
+static __m128 CubeRootSSE2( __m128 x )
+{
+    __m128 third = _mm_set1_ps( 1.0f / 3.0f );
+    __m128 two   = _mm_set1_ps( 2.0f );
+    __m128i bits = _mm_cvttps_epi32( _mm_mul_ps( _mm_cvtepi32_ps( _mm_castps_si128( x ) ), third ) );
+    __m128 y     = _mm_castsi128_ps( _mm_add_epi32( bits, _mm_set1_epi32( 0x2A5137A0 ) ) );
+
+    y = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( two, y ), _mm_div_ps( x, _mm_mul_ps( y, y ) ) ), third );
+    y = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( two, y ), _mm_div_ps( x, _mm_mul_ps( y, y ) ) ), third );
+    y = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( two, y ), _mm_div_ps( x, _mm_mul_ps( y, y ) ) ), third );
+
+    return y;
+}
+
+static __m128 CalculateHueSSE2( __m128 r, __m128 g, __m128 b, __m128 max, __m128 delta )
+{
+    __m128 zero     = _mm_setzero_ps( );
+    __m128 one      = _mm_set1_ps( 1.0f );
+    __m128 notGray  = _mm_cmpgt_ps( delta, zero );
+    __m128 isRed    = _mm_cmpeq_ps( r, max );
+    __m128 isGreen  = _mm_andnot_ps( isRed, _mm_cmpeq_ps( g, max ) );
+    __m128 divisor  = SelectSSE2( notGray, delta, one );
+    __m128 hr, hg, hb;
+
+    hr = _mm_div_ps( _mm_sub_ps( g, b ), divisor );
+    hr = _mm_add_ps( hr, _mm_and_ps( _mm_cmplt_ps( hr, zero ), _mm_set1_ps( 6.0f ) ) );
+    hg = _mm_add_ps( _mm_set1_ps( 2.0f ), _mm_div_ps( _mm_sub_ps( b, r ), divisor ) );
+    hb = _mm_add_ps( _mm_set1_ps( 4.0f ), _mm_div_ps( _mm_sub_ps( r, g ), divisor ) );
+
+    return _mm_and_ps( notGray, _mm_mul_ps( SelectSSE2( isRed, hr, SelectSSE2( isGreen, hg, hb ) ), _mm_set1_ps( 60.0f ) ) );
+}
+
+static void RgbToHslSSE2( __m128 r, __m128 g, __m128 b, __m128* h, __m128* s, __m128* l )
+{
+    __m128 max     = _mm_max_ps( r, _mm_max_ps( g, b ) );
+    __m128 min     = _mm_min_ps( r, _mm_min_ps( g, b ) );
+    __m128 delta   = _mm_sub_ps( max, min );
+    __m128 sum     = _mm_add_ps( max, min );
+    __m128 one     = _mm_set1_ps( 1.0f );
+    __m128 notGray = _mm_cmpgt_ps( delta, _mm_setzero_ps( ) );
+    __m128 lum     = _mm_mul_ps( sum, _mm_set1_ps( 0.5f ) );
+    __m128 divisor = SelectSSE2( _mm_cmple_ps( lum, _mm_set1_ps( 0.5f ) ), sum, _mm_sub_ps( _mm_sub_ps( _mm_set1_ps( 2.0f ), max ), min ) );
+
+    *h = CalculateHueSSE2( r, g, b, max, delta );
+    *s = _mm_and_ps( notGray, _mm_div_ps( delta, SelectSSE2( notGray, divisor, one ) ) );
+    *l = lum;
+}
+
+static void RgbToHsvSSE2( __m128 r, __m128 g, __m128 b, __m128* h, __m128* s, __m128* v )
+{
+    __m128 max      = _mm_max_ps( r, _mm_max_ps( g, b ) );
+    __m128 min      = _mm_min_ps( r, _mm_min_ps( g, b ) );
+    __m128 delta    = _mm_sub_ps( max, min );
+    __m128 notBlack = _mm_cmpgt_ps( max, _mm_setzero_ps( ) );
+
+    *h = CalculateHueSSE2( r, g, b, max, delta );
+    *s = _mm_and_ps( notBlack, _mm_div_ps( delta, SelectSSE2( notBlack, max, _mm_set1_ps( 1.0f ) ) ) );
+    *v = max;
+}
+
+static __m128 WrapHueSSE2( __m128 hue )
+{
+    return _mm_sub_ps( hue, _mm_mul_ps( _mm_set1_ps( 360.0f ), FloorSSE2( _mm_mul_ps( hue, _mm_set1_ps( 1.0f / 360.0f ) ) ) ) );
+}
+
+static __m128 HslChannelSSE2( float n, __m128 h, __m128 l, __m128 a )
+{
+    __m128 twelve = _mm_set1_ps( 12.0f );
+    __m128 k      = _mm_add_ps( _mm_set1_ps( n ), _mm_mul_ps( h, _mm_set1_ps( 1.0f / 30.0f ) ) );
+
+    k = _mm_sub_ps( k, _mm_and_ps( _mm_cmpge_ps( k, twelve ), twelve ) );
+
+    return _mm_sub_ps( l, _mm_mul_ps( a, ClampSSE2( _mm_min_ps( _mm_sub_ps( k, _mm_set1_ps( 3.0f ) ), _mm_sub_ps( _mm_set1_ps( 9.0f ), k ) ),
+                                                    _mm_set1_ps( -1.0f ), _mm_set1_ps( 1.0f ) ) ) );
+}
+
+static void HslToRgbSSE2( __m128 h, __m128 s, __m128 l, __m128* r, __m128* g, __m128* b )
+{
+    __m128 a = _mm_mul_ps( s, _mm_min_ps( l, _mm_sub_ps( _mm_set1_ps( 1.0f ), l ) ) );
+
+    h  = WrapHueSSE2( h );
+    *r = HslChannelSSE2( 0.0f, h, l, a );
+    *g = HslChannelSSE2( 8.0f, h, l, a );
+    *b = HslChannelSSE2( 4.0f, h, l, a );
+}
+
+static __m128 HsvChannelSSE2( float n, __m128 h, __m128 vs, __m128 v )
+{
+    __m128 six = _mm_set1_ps( 6.0f );
+    __m128 k   = _mm_add_ps( _mm_set1_ps( n ), _mm_mul_ps( h, _mm_set1_ps( 1.0f / 60.0f ) ) );
+
+    k = _mm_sub_ps( k, _mm_and_ps( _mm_cmpge_ps( k, six ), six ) );
+
+    return _mm_sub_ps( v, _mm_mul_ps( vs, ClampSSE2( _mm_min_ps( k, _mm_sub_ps( _mm_set1_ps( 4.0f ), k ) ),
+                                                     _mm_setzero_ps( ), _mm_set1_ps( 1.0f ) ) ) );
+}
+
+static void HsvToRgbSSE2( __m128 h, __m128 s, __m128 v, __m128* r, __m128* g, __m128* b )
+{
+    __m128 vs = _mm_mul_ps( v, s );
+
+    h  = WrapHueSSE2( h );
+    *r = HsvChannelSSE2( 5.0f, h, vs, v );
+    *g = HsvChannelSSE2( 3.0f, h, vs, v );
+    *b = HsvChannelSSE2( 1.0f, h, vs, v );
+}
+
+// Linear combination of 3 vectors plus a constant
+static __m128 Combine3SSE2( float c0, float c1, float c2, float add, __m128 v0, __m128 v1, __m128 v2 )
+{
+    return _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_set1_ps( add ), _mm_mul_ps( _mm_set1_ps( c0 ), v0 ) ),
+                                   _mm_mul_ps( _mm_set1_ps( c1 ), v1 ) ), _mm_mul_ps( _mm_set1_ps( c2 ), v2 ) );
+}
+
+static __m128 LabFSSE2( __m128 t )
+{
+    __m128 small  = _mm_add_ps( _mm_mul_ps( t, _mm_set1_ps( LAB_KAPPA ) ), _mm_set1_ps( LAB_16_116 ) );
+    __m128 isHigh = _mm_cmpgt_ps( t, _mm_set1_ps( LAB_EPSILON ) );
+
+    // cube root is calculated for the high values only, so it does not need to deal with zeros
+    return SelectSSE2( isHigh, CubeRootSSE2( SelectSSE2( isHigh, t, _mm_set1_ps( 1.0f ) ) ), small );
+}
+
+static __m128 LabInvFSSE2( __m128 f )
+{
+    __m128 cube  = _mm_mul_ps( _mm_mul_ps( f, f ), f );
+    __m128 small = _mm_mul_ps( _mm_sub_ps( f, _mm_set1_ps( LAB_16_116 ) ), _mm_set1_ps( 1.0f / LAB_KAPPA ) );
+
+    return SelectSSE2( _mm_cmpgt_ps( f, _mm_set1_ps( LAB_F_EPSILON ) ), cube, small );
+}
+
+// ----- Row conversion routines -----
+
+// Convert a row of RGB pixels into 3 rows of channel values
+static void RgbRowToChannels( int colorSpace, const uint8_t* src, int pixelSize, int width,
+                              float* c1, float* c2, float* c3, bool useSSE )
+{
+    int x = 0;
+
+    if ( useSSE )
+    {
+        __m128 normVec = _mm_set1_ps( 255.0f );
+        __m128 r, g, b, v1, v2, v3;
+
+        for ( ; x <= width - 4; x += 4, src += 4 * pixelSize )
+        {
+            if ( colorSpace == ColorSpaceLab )
+            {
+                r = _mm_set_ps( SrgbToLinearLut[src[3 * pixelSize + RedIndex]],   SrgbToLinearLut[src[2 * pixelSize + RedIndex]],
+                                SrgbToLinearLut[src[pixelSize + RedIndex]],       SrgbToLinearLut[src[RedIndex]] );
+                g = _mm_set_ps( SrgbToLinearLut[src[3 * pixelSize + GreenIndex]], SrgbToLinearLut[src[2 * pixelSize + GreenIndex]],
+                                SrgbToLinearLut[src[pixelSize + GreenIndex]],     SrgbToLinearLut[src[GreenIndex]] );
+                b = _mm_set_ps( SrgbToLinearLut[src[3 * pixelSize + BlueIndex]],  SrgbToLinearLut[src[2 * pixelSize + BlueIndex]],
+                                SrgbToLinearLut[src[pixelSize + BlueIndex]],      SrgbToLinearLut[src[BlueIndex]] );
+            }
+            else
+            {
+                r = _mm_set_ps( src[3 * pixelSize + RedIndex],   src[2 * pixelSize + RedIndex],   src[pixelSize + RedIndex],   src[RedIndex] );
+                g = _mm_set_ps( src[3 * pixelSize + GreenIndex], src[2 * pixelSize + GreenIndex], src[pixelSize + GreenIndex], src[GreenIndex] );
+                b = _mm_set_ps( src[3 * pixelSize + BlueIndex],  src[2 * pixelSize + BlueIndex],  src[pixelSize + BlueIndex],  src[BlueIndex] );
+            }
+
+            switch ( colorSpace )
+            {
+            case ColorSpaceHsl:
+                RgbToHslSSE2( _mm_div_ps( r, normVec ), _mm_div_ps( g, normVec ), _mm_div_ps( b, normVec ), &v1, &v2, &v3 );
+                break;
+            case ColorSpaceHsv:
+                RgbToHsvSSE2( _mm_div_ps( r, normVec ), _mm_div_ps( g, normVec ), _mm_div_ps( b, normVec ), &v1, &v2, &v3 );
+                break;
+            case ColorSpaceYCbCr:
+                v1 = Combine3SSE2(  0.299f,     0.587f,     0.114f,   0.0f,   r, g, b );
+                v2 = Combine3SSE2( -0.168736f, -0.331264f,  0.5f,     128.0f, r, g, b );
+                v3 = Combine3SSE2(  0.5f,      -0.418688f, -0.081312f, 128.0f, r, g, b );
+                break;
+            default:
+                {
+                    __m128 fx = LabFSSE2( Combine3SSE2( RgbToXyz[0], RgbToXyz[1], RgbToXyz[2], 0.0f, r, g, b ) );
+                    __m128 fy = LabFSSE2( Combine3SSE2( RgbToXyz[3], RgbToXyz[4], RgbToXyz[5], 0.0f, r, g, b ) );
+                    __m128 fz = LabFSSE2( Combine3SSE2( RgbToXyz[6], RgbToXyz[7], RgbToXyz[8], 0.0f, r, g, b ) );
+
+                    v1 = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( 116.0f ), fy ), _mm_set1_ps( 16.0f ) );
+                    v2 = _mm_mul_ps( _mm_set1_ps( 500.0f ), _mm_sub_ps( fx, fy ) );
+                    v3 = _mm_mul_ps( _mm_set1_ps( 200.0f ), _mm_sub_ps( fy, fz ) );
+                }
+                break;
+            }
+
+            _mm_storeu_ps( c1 + x, v1 );
+            _mm_storeu_ps( c2 + x, v2 );
+            _mm_storeu_ps( c3 + x, v3 );
+        }
+    }
+
+    for ( ; x < width; x++, src += pixelSize )
+    {
+        switch ( colorSpace )
+        {
+        case ColorSpaceHsl:
+            RgbToHsl( src[RedIndex] / 255.0f, src[GreenIndex] / 255.0f, src[BlueIndex] / 255.0f, &c1[x], &c2[x], &c3[x] );
+            break;
+        case ColorSpaceHsv:
+            RgbToHsv( src[RedIndex] / 255.0f, src[GreenIndex] / 255.0f, src[BlueIndex] / 255.0f, &c1[x], &c2[x], &c3[x] );
+            break;
+        case ColorSpaceYCbCr:
+            RgbToYCbCr( src[RedIndex], src[GreenIndex], src[BlueIndex], &c1[x], &c2[x], &c3[x] );
+            break;
+        default:
+            LinearRgbToLab( SrgbToLinearLut[src[RedIndex]], SrgbToLinearLut[src[GreenIndex]], SrgbToLinearLut[src[BlueIndex]],
+                            &c1[x], &c2[x], &c3[x] );
+            break;
+        }
+    }
+}
+
+// Convert 3 rows of channel values into a row of RGB pixels
+static void ChannelsToRgbRow( int colorSpace, const float* c1, const float* c2, const float* c3,
+                              uint8_t* dst, int pixelSize, int width, bool useSSE )
+{
+    float r, g, b;
+    int   x = 0;
+
+    if ( useSSE )
+    {
+        __m128  zero = _mm_setzero_ps( );
+        __m128  one  = _mm_set1_ps( 1.0f );
+        __m128  vr, vg, vb, v1, v2, v3;
+        __m128i packed;
+        int     lut[12];
+        int     i;
+
+        for ( ; x <= width - 4; x += 4, dst += 4 * pixelSize )
+        {
+            v1 = _mm_loadu_ps( c1 + x );
+            v2 = _mm_loadu_ps( c2 + x );
+            v3 = _mm_loadu_ps( c3 + x );
+
+            switch ( colorSpace )
+            {
+            case ColorSpaceHsl:
+                HslToRgbSSE2( v1, v2, v3, &vr, &vg, &vb );
+                break;
+            case ColorSpaceHsv:
+                HsvToRgbSSE2( v1, v2, v3, &vr, &vg, &vb );
+                break;
+            case ColorSpaceYCbCr:
+                v2 = _mm_sub_ps( v2, _mm_set1_ps( 128.0f ) );
+                v3 = _mm_sub_ps( v3, _mm_set1_ps( 128.0f ) );
+                vr = Combine3SSE2( 1.0f / 255, 0.0f,                1.402f / 255,    0.0f, v1, v2, v3 );
+                vg = Combine3SSE2( 1.0f / 255, -0.344136f / 255,    -0.714136f / 255, 0.0f, v1, v2, v3 );
+                vb = Combine3SSE2( 1.0f / 255, 1.772f / 255,        0.0f,            0.0f, v1, v2, v3 );
+                break;
+            default:
+                {
+                    __m128 fy = _mm_mul_ps( _mm_add_ps( v1, _mm_set1_ps( 16.0f ) ), _mm_set1_ps( 1.0f / 116.0f ) );
+                    __m128 tx = LabInvFSSE2( _mm_add_ps( fy, _mm_mul_ps( v2, _mm_set1_ps( 1.0f / 500.0f ) ) ) );
+                    __m128 ty = LabInvFSSE2( fy );
+                    __m128 tz = LabInvFSSE2( _mm_sub_ps( fy, _mm_mul_ps( v3, _mm_set1_ps( 1.0f / 200.0f ) ) ) );
+                    __m128 lutScale = _mm_set1_ps( (float) LINEAR_TO_SRGB_LUT_SIZE );
+                    __m128 half     = _mm_set1_ps( 0.5f );
+
+                    vr = Combine3SSE2( XyzToRgb[0], XyzToRgb[1], XyzToRgb[2], 0.0f, tx, ty, tz );
+                    vg = Combine3SSE2( XyzToRgb[3], XyzToRgb[4], XyzToRgb[5], 0.0f, tx, ty, tz );
+                    vb = Combine3SSE2( XyzToRgb[6], XyzToRgb[7], XyzToRgb[8], 0.0f, tx, ty, tz );
+
+                    // gamma compression is done with lookup table
+                    _mm_storeu_si128( (__m128i*) lut,       _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( ClampSSE2( vr, zero, one ), lutScale ), half ) ) );
+                    _mm_storeu_si128( (__m128i*) ( lut + 4 ), _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( ClampSSE2( vg, zero, one ), lutScale ), half ) ) );
+                    _mm_storeu_si128( (__m128i*) ( lut + 8 ), _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( ClampSSE2( vb, zero, one ), lutScale ), half ) ) );
+
+                    for ( i = 0; i < 4; i++ )
+                    {
+                        dst[i * pixelSize + RedIndex]   = LinearToSrgbLut[lut[i]];
+                        dst[i * pixelSize + GreenIndex] = LinearToSrgbLut[lut[i + 4]];
+                        dst[i * pixelSize + BlueIndex]  = LinearToSrgbLut[lut[i + 8]];
+                    }
+                }
+                continue;
+            }
+
+            {
+                __m128 scale = _mm_set1_ps( 255.0f );
+                __m128 half  = _mm_set1_ps( 0.5f );
+
+                // round to integers and saturate into [0, 255] range - 32 bit integers are packed, so only the
+                // lowest byte of every 32 bit value matters for us
+                packed = _mm_packus_epi16(
+                            _mm_packs_epi32( _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( ClampSSE2( vr, zero, one ), scale ), half ) ),
+                                             _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( ClampSSE2( vg, zero, one ), scale ), half ) ) ),
+                            _mm_packs_epi32( _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( ClampSSE2( vb, zero, one ), scale ), half ) ),
+                                             _mm_setzero_si128( ) ) );
+                _mm_storeu_si128( (__m128i*) lut, packed );
+
+                for ( i = 0; i < 4; i++ )
+                {
+                    dst[i * pixelSize + RedIndex]   = ( (uint8_t*) lut )[i];
+                    dst[i * pixelSize + GreenIndex] = ( (uint8_t*) lut )[i + 4];
+                    dst[i * pixelSize + BlueIndex]  = ( (uint8_t*) lut )[i + 8];
+                }
+            }
+        }
+    }
+
+    for ( ; x < width; x++, dst += pixelSize )
+    {
+        switch ( colorSpace )
+        {
+        case ColorSpaceHsl:
+            HslToRgb( c1[x], c2[x], c3[x], &r, &g, &b );
+            break;
+        case ColorSpaceHsv:
+            HsvToRgb( c1[x], c2[x], c3[x], &r, &g, &b );
+            break;
+        case ColorSpaceYCbCr:
+            YCbCrToRgb( c1[x], c2[x], c3[x], &r, &g, &b );
+            r *= ( 1.0f / 255 );
+            g *= ( 1.0f / 255 );
+            b *= ( 1.0f / 255 );
+            break;
+        default:
+            LabToLinearRgb( c1[x], c2[x], c3[x], &r, &g, &b );
+            dst[RedIndex]   = LinearToSrgb( r );
+            dst[GreenIndex] = LinearToSrgb( g );
+            dst[BlueIndex]  = LinearToSrgb( b );
+            continue;
+        }
+
+        dst[RedIndex]   = UnitToByte( r );
+        dst[GreenIndex] = UnitToByte( g );
+        dst[BlueIndex]  = UnitToByte( b );
+    }
+}
+
+// Convert channel values into 8 bit plane's row
+static void ChannelToByteRow( const float* src, uint8_t* dst, int width, float scale, float offset, bool useSSE )
+{
+    int x = 0;
+
+    if ( useSSE )
+    {
+        __m128 scaleVec  = _mm_set1_ps( scale );
+        __m128 offsetVec = _mm_set1_ps( offset + 0.5f );
+
+        for ( ; x <= width - 8; x += 8 )
+        {
+            // values are floored by conversion since they are positive after saturation
+            __m128i lo = _mm_cvttps_epi32( _mm_max_ps( _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( src + x ),     scaleVec ), offsetVec ), _mm_setzero_ps( ) ) );
+            __m128i hi = _mm_cvttps_epi32( _mm_max_ps( _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( src + x + 4 ), scaleVec ), offsetVec ), _mm_setzero_ps( ) ) );
+
+            _mm_storel_epi64( (__m128i*) ( dst + x ), _mm_packus_epi16( _mm_packs_epi32( lo, hi ), _mm_setzero_si128( ) ) );
+        }
+    }
+
+    for ( ; x < width; x++ )
+    {
+        float v = src[x] * scale + offset + 0.5f;
+        dst[x] = (uint8_t) ( ( v <= 0.0f ) ? 0 : ( ( v >= 255.0f ) ? 255 : (int) v ) );
+    }
+}
+
+// Convert 8 bit plane's row into channel values
+static void ByteRowToChannel( const uint8_t* src, float* dst, int width, float scale, float offset )
+{
+    float invScale = 1.0f / scale;
+    int   x;
+
+    for ( x = 0; x < width; x++ )
+    {
+        dst[x] = ( src[x] - offset ) * invScale;
+    }
+}
+
+// ----- Image level conversion -----
+
+// Check that color image and its channel planes are compatible
+static XErrorCode CheckPlanes( const ximage* color, const ximage* plane1, const ximage* plane2, const ximage* plane3 )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( color == 0 ) || ( plane1 == 0 ) || ( plane2 == 0 ) || ( plane3 == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( ( color->format != XPixelFormatRGB24 ) && ( color->format != XPixelFormatRGBA32 ) ) ||
+              ( ( plane1->format != XPixelFormatGrayscale8 ) && ( plane1->format != XPixelFormatGrayscaleR4 ) ) )
+    {
+        ret = ErrorUnsupportedPixelFormat;
+    }
+    else if ( ( plane1->format != plane2->format ) || ( plane1->format != plane3->format ) ||
+              ( plane1->width  != color->width   ) || ( plane1->height != color->height  ) ||
+              ( plane2->width  != color->width   ) || ( plane2->height != color->height  ) ||
+              ( plane3->width  != color->width   ) || ( plane3->height != color->height  ) )
+    {
+        ret = ErrorImageParametersMismatch;
+    }
+
+    return ret;
+}
+
+static XErrorCode ColorImageToPlanes( int colorSpace, const ximage* src, ximage* plane1, ximage* plane2, ximage* plane3 )
+{
+    XErrorCode ret = CheckPlanes( src, plane1, plane2, plane3 );
+
+    if ( ret == SuccessCode )
+    {
+        int  width       = src->width;
+        int  height      = src->height;
+        int  pixelSize   = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
+        bool floatPlanes = ( plane1->format == XPixelFormatGrayscaleR4 );
+        bool useSSE      = IsSSE2( );
+        bool outOfMemory = false;
+
+        if ( colorSpace == ColorSpaceLab )
+        {
+            InitLabLuts( );
+        }
+
+        #pragma omp parallel shared( src, plane1, plane2, plane3, width, height, pixelSize, floatPlanes, useSSE, outOfMemory )
+        {
+            // per thread buffer for 8 bpp planes
+            float* buffer = ( floatPlanes ) ? 0 : (float*) malloc( sizeof( float ) * 3 * width );
+            int    y;
+
+            #pragma omp for schedule(static)
+            for ( y = 0; y < height; y++ )
+            {
+                const uint8_t* srcRow = src->data + y * src->stride;
+                uint8_t*       row1   = plane1->data + y * plane1->stride;
+                uint8_t*       row2   = plane2->data + y * plane2->stride;
+                uint8_t*       row3   = plane3->data + y * plane3->stride;
+
+                if ( floatPlanes )
+                {
+                    RgbRowToChannels( colorSpace, srcRow, pixelSize, width, (float*) row1, (float*) row2, (float*) row3, useSSE );
+                }
+                else if ( buffer != 0 )
+                {
+                    RgbRowToChannels( colorSpace, srcRow, pixelSize, width, buffer, buffer + width, buffer + 2 * width, useSSE );
+
+                    ChannelToByteRow( buffer,             row1, width, PlaneScale[colorSpace][0], PlaneOffset[colorSpace][0], useSSE );
+                    ChannelToByteRow( buffer + width,     row2, width, PlaneScale[colorSpace][1], PlaneOffset[colorSpace][1], useSSE );
+                    ChannelToByteRow( buffer + 2 * width, row3, width, PlaneScale[colorSpace][2], PlaneOffset[colorSpace][2], useSSE );
+                }
+                else
+                {
+                    outOfMemory = true;
+                }
+            }
+
+            free( buffer );
+        }
+
+        if ( outOfMemory )
+        {
+            ret = ErrorOutOfMemory;
+        }
+    }
+
+    return ret;
+}
+
+static XErrorCode PlanesToColorImage( int colorSpace, const ximage* plane1, const ximage* plane2, const ximage* plane3, ximage* dst )
+{
+    XErrorCode ret = CheckPlanes( dst, plane1, plane2, plane3 );
+
+    if ( ret == SuccessCode )
+    {
+        int  width       = dst->width;
+        int  height      = dst->height;
+        int  pixelSize   = ( dst->format == XPixelFormatRGB24 ) ? 3 : 4;
+        bool floatPlanes = ( plane1->format == XPixelFormatGrayscaleR4 );
+        bool useSSE      = IsSSE2( );
+        bool outOfMemory = false;
+
+        if ( colorSpace == ColorSpaceLab )
+        {
+            InitLabLuts( );
+        }
+
+        #pragma omp parallel shared( dst, plane1, plane2, plane3, width, height, pixelSize, floatPlanes, useSSE, outOfMemory )
+        {
+            float* buffer = ( floatPlanes ) ? 0 : (float*) malloc( sizeof( float ) * 3 * width );
+            int    y, x;
+
+            #pragma omp for schedule(static)
+            for ( y = 0; y < height; y++ )
+            {
+                const uint8_t* row1   = plane1->data + y * plane1->stride;
+                const uint8_t* row2   = plane2->data + y * plane2->stride;
+                const uint8_t* row3   = plane3->data + y * plane3->stride;
+                uint8_t*       dstRow = dst->data + y * dst->stride;
+
+                if ( floatPlanes )
+                {
+                    ChannelsToRgbRow( colorSpace, (const float*) row1, (const float*) row2, (const float*) row3, dstRow, pixelSize, width, useSSE );
+                }
+                else if ( buffer != 0 )
+                {
+                    ByteRowToChannel( row1, buffer,             width, PlaneScale[colorSpace][0], PlaneOffset[colorSpace][0] );
+                    ByteRowToChannel( row2, buffer + width,     width, PlaneScale[colorSpace][1], PlaneOffset[colorSpace][1] );
+                    ByteRowToChannel( row3, buffer + 2 * width, width, PlaneScale[colorSpace][2], PlaneOffset[colorSpace][2] );
+
+                    ChannelsToRgbRow( colorSpace, buffer, buffer + width, buffer + 2 * width, dstRow, pixelSize, width, useSSE );
+                }
+                else
+                {
+                    outOfMemory = true;
+                }
+
+                if ( pixelSize == 4 )
+                {
+                    for ( x = 0; x < width; x++ )
+                    {
+                        dstRow[x * 4 + AlphaIndex] = NotTransparent8bpp;
+                    }
+                }
+            }
+
+            free( buffer );
+        }
+
+        if ( outOfMemory )
+        {
+            ret = ErrorOutOfMemory;
+        }
+    }
+
+    return ret;
+}
+
+// Convert RGB image into HSL planes
+XErrorCode ColorImageToHslPlanes( const ximage* src, ximage* hue, ximage* saturation, ximage* luminance )
+{
+    return ColorImageToPlanes( ColorSpaceHsl, src, hue, saturation, luminance );
+}
+
+// Convert HSL planes into RGB image
+XErrorCode HslPlanesToColorImage( const ximage* hue, const ximage* saturation, const ximage* luminance, ximage* dst )
+{
+    return PlanesToColorImage( ColorSpaceHsl, hue, saturation, luminance, dst );
+}
+
+// Convert RGB image into HSV planes
+XErrorCode ColorImageToHsvPlanes( const ximage* src, ximage* hue, ximage* saturation, ximage* value )
+{
+    return ColorImageToPlanes( ColorSpaceHsv, src, hue, saturation, value );
+}
+
+// Convert HSV planes into RGB image
+XErrorCode HsvPlanesToColorImage( const ximage* hue, const ximage* saturation, const ximage* value, ximage* dst )
+{
+    return PlanesToColorImage( ColorSpaceHsv, hue, saturation, value, dst );
+}
+
+// Convert RGB image into YCbCr planes
+XErrorCode ColorImageToYCbCrPlanes( const ximage* src, ximage* y, ximage* cb, ximage* cr )
+{
+    return ColorImageToPlanes( ColorSpaceYCbCr, src, y, cb, cr );
+}
+
+// Convert YCbCr planes into RGB image
+XErrorCode YCbCrPlanesToColorImage( const ximage* y, const ximage* cb, const ximage* cr, ximage* dst )
+{
+    return PlanesToColorImage( ColorSpaceYCbCr, y, cb, cr, dst );
+}
+
+// Convert RGB image into Lab planes
+XErrorCode ColorImageToLabPlanes( const ximage* src, ximage* l, ximage* a, ximage* b )
+{
+    return ColorImageToPlanes( ColorSpaceLab, src, l, a, b );
+}
+
+// Convert Lab planes into RGB image
+XErrorCode LabPlanesToColorImage( const ximage* l, const ximage* a, const ximage* b, ximage* dst )
+{
+    return PlanesToColorImage( ColorSpaceLab, l, a, b, dst );
+}
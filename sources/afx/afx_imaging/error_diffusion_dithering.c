@@ -19,19 +19,214 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
 */
 
+#include <stdlib.h>
 #include "ximaging.h"
 
+#ifdef _WIN32
+    #include <windows.h>
+    #define YieldThread( ) SwitchToThread( )
+#else
+    #include <sched.h>
+    #define YieldThread( ) sched_yield( )
+#endif
+
+#ifdef _OPENMP
+    #include <omp.h>
+#else
+    #define omp_get_max_threads( ) ( 1 )
+    #define omp_get_num_procs( )   ( 1 )
+    #define omp_get_num_threads( ) ( 1 )
+    #define omp_get_thread_num( )  ( 0 )
+#endif
+
 #define THRESHOLD (128)
 
+// Thresholding errors are in the [-127, 127] range
+#define ERROR_OFFSET (127)
+#define ERRORS_COUNT (255)
+
+// Number of pixels a row processes before reporting its progress to the row below
+#define PROGRESS_STEP (64)
+
+// Number of checks of row's progress to spin before giving CPU to other threads
+#define SPIN_COUNT (1000)
+
+/*
+   Error diffusion is sequential by nature - every pixel depends on the error diffused from the pixels
+   processed before it. However, a pixel depends only on few pixels of the rows above. So rows can be
+   processed concurrently as a wavefront, when every row lags behind the row above it by the number of pixels
+   covering diffusion window's width. Since rows are processed strictly left to right and each row waits for
+   the row above to get far enough, every pixel receives diffused errors in exactly the same order as with
+   sequential processing - the result is bit exact.
+
+   Instead of a temporary image, only a ring of few rows is kept. A row gets loaded into the ring when the
+   first row diffusing error to it starts, and its slot gets reused after it is completely processed.
+*/
+
+// Context shared by all threads performing error diffusion
+typedef struct
+{
+    const ximage*     src;
+    ximage*           dst;
+    int32_t           linesCount;
+    const int32_t*    linesLength;
+    const int16_t**   diffusionTables;   // diffused error for each line/coefficient/error
+    int16_t*          rows;              // ring of rows being processed
+    int32_t           rowsCount;
+    int32_t           rowStride;
+    int32_t           rowPadding;
+    int32_t           lag;
+    volatile int32_t* progress;          // number of pixels processed in each row
+}
+DiffusionContext;
+
+// Wait till the specified row processes the specified number of pixels. Spinning is cheap when every
+// thread has its own core, but with more threads than cores the thread to wait for may not run at all,
+// so CPU is yielded after spinning for a while.
+static void WaitForRowProgress( volatile int32_t* progress, int32_t required )
+{
+    int32_t spins = 0;
+
+    for ( ; ; )
+    {
+        #pragma omp flush
+        if ( *progress >= required )
+        {
+            break;
+        }
+
+        if ( ++spins >= SPIN_COUNT )
+        {
+            YieldThread( );
+            spins = 0;
+        }
+    }
+}
+
+// Get row of the ring buffer, which keeps the specified row of the image
+static int16_t* GetDiffusionRow( const DiffusionContext* context, int32_t y )
+{
+    return context->rows + ( y % context->rowsCount ) * context->rowStride + context->rowPadding;
+}
+
+// Load the specified row of the source image into the ring buffer
+static void LoadDiffusionRow( const DiffusionContext* context, int32_t y )
+{
+    if ( y < context->src->height )
+    {
+        const uint8_t* srcRow = context->src->data + y * context->src->stride;
+        int16_t*       row    = GetDiffusionRow( context, y );
+        int32_t        width  = context->src->width;
+        int32_t        x;
+
+        // the row previously kept in the slot must be done first
+        if ( y >= context->rowsCount )
+        {
+            WaitForRowProgress( &context->progress[y - context->rowsCount], width );
+        }
+
+        for ( x = 0; x < width; x++ )
+        {
+            row[x] = srcRow[x];
+        }
+    }
+}
+
+// Threshold the specified row and diffuse its errors to the neighbour pixels
+static void DiffuseRow( const DiffusionContext* context, int32_t y )
+{
+    int32_t  width      = context->src->width;
+    int32_t  linesCount = XMIN( context->linesCount, context->src->height - y );
+    uint8_t* dstRow     = context->dst->data + y * context->dst->stride;
+    int16_t* row        = GetDiffusionRow( context, y );
+    int32_t  errors[PROGRESS_STEP];
+    int32_t  x, x0, x1, i, k, value, error, diffusion;
+
+    for ( x0 = 0; x0 < width; x0 = x1 )
+    {
+        x1 = XMIN( x0 + PROGRESS_STEP, width );
+
+        // make sure the row above diffused all its error which may get to this chunk or get diffused from it
+        if ( y != 0 )
+        {
+            WaitForRowProgress( &context->progress[y - 1], XMIN( x1 + context->lag, width ) );
+        }
+
+        // thresholding and error diffusion to the pixels on the right of the processed one
+        {
+            int32_t        coefficientsCount = context->linesLength[0];
+            const int16_t* table             = context->diffusionTables[0];
+            const int16_t* errorTable;
+            int16_t*       target;
+
+            int32_t        mask;
+
+            for ( x = x0; x < x1; x++ )
+            {
+                // branchless thresholding, since dithered pixels are hardly predictable
+                value = row[x];
+                mask  = -( value >= THRESHOLD );
+                error = value - ( mask & 255 );
+
+                dstRow[x >> 3] |= (uint8_t) ( mask & ( 0x80 >> ( x & 7 ) ) );
+
+                errors[x - x0] = error + ERROR_OFFSET;
+                errorTable     = table + error + ERROR_OFFSET;
+                target         = row + x + 1;
+
+                for ( k = 0; k < coefficientsCount; k++ )
+                {
+                    diffusion = target[k] + errorTable[k * ERRORS_COUNT];
+                    target[k] = (int16_t) XINRANGE( diffusion, 0, 255 );
+                }
+            }
+        }
+
+        // error diffusion to the pixels under the processed ones
+        for ( i = 1; i < linesCount; i++ )
+        {
+            int32_t        coefficientsCount = context->linesLength[i];
+            const int16_t* table             = context->diffusionTables[i];
+            int16_t*       target            = GetDiffusionRow( context, y + i ) - ( coefficientsCount >> 1 );
+            int32_t        kMin, kMax;
+
+            // every target pixel collects errors of the chunk's pixels in the order they were processed,
+            // which avoids dependencies between neighbour targets
+            for ( x = x0; x < x1 + coefficientsCount - 1; x++ )
+            {
+                kMin  = XMAX( 0, x - x1 + 1 );
+                kMax  = XMIN( coefficientsCount - 1, x - x0 );
+                value = target[x];
+
+                for ( k = kMax; k >= kMin; k-- )
+                {
+                    diffusion = value + table[k * ERRORS_COUNT + errors[x - k - x0]];
+                    value     = XINRANGE( diffusion, 0, 255 );
+                }
+
+                target[x] = (int16_t) value;
+            }
+        }
+
+        #pragma omp flush
+        context->progress[y] = x1;
+        #pragma omp flush
+    }
+}
+
 // Perform error diffusion dithering of the specified 8 bpp grayscale image putting result into the specified 1 bpp binary image
 // Note: destination image must be "clean" - black pixels only
+// Note: temporary image is not used any more - kept for compatibility only
 XErrorCode BinaryErrorDiffusionDithering( const ximage* src, ximage* dst, ximage* tmp,
                                           int32_t diffusionLinesCount, const int32_t* diffusionLinesLength,
                                           const uint8_t** diffusionLinesCoefficients )
 {
     XErrorCode ret = SuccessCode;
     int32_t    coefficientsSum = 0;
-    ximage*    tempImage = 0;
+    int32_t    coefficientsTotal = 0;
+    int32_t    maxLineLength = 0;
+
+    XUNREFERENCED_PARAMETER( tmp );
 
     if ( ( src == 0 ) || ( dst == 0 ) || ( diffusionLinesLength == 0 ) || ( diffusionLinesCoefficients == 0 ) )
     {
@@ -69,153 +264,98 @@ XErrorCode BinaryErrorDiffusionDithering( const ximage* src, ximage* dst, ximage
             {
                 for ( j = 0; j < diffusionLinesLength[i]; j++ )
                 {
-                    if ( diffusionLinesCoefficients[i][j] < 0 )
-                    {
-                        ret = ErrorInvalidArgument;
-                    }
-                    else
-                    {
-                        coefficientsSum += diffusionLinesCoefficients[i][j];
-                    }
+                    coefficientsSum += diffusionLinesCoefficients[i][j];
                 }
-            }
-        }
-    }
 
-    if ( ret == SuccessCode )
-    {
-        // check specified temp image to see if it can be reused
-        if ( tmp != 0 )
-        {
-            if ( ( tmp->format != XPixelFormatGrayscale8 ) ||
-                 ( tmp->width < src->width ) ||
-                 ( tmp->height < src->height ) )
-            {
-                // although we could create our own temp image, we
-                // better report an error here, so user know he gave junk
-                ret = ErrorImageParametersMismatch;
-            }
-            else
-            {
-                // since we allow bigger temp images, we need to get its sub-image
-                ret = XImageGetSubImage( tmp, &tempImage, 0, 0, src->width, src->height );
+                coefficientsTotal += diffusionLinesLength[i];
+                maxLineLength      = XMAX( maxLineLength, diffusionLinesLength[i] );
             }
         }
-        else
+
+        if ( ( ret == SuccessCode ) && ( coefficientsSum == 0 ) )
         {
-            // allocate our own temp image
-            ret = XImageAllocate( src->width, src->height, XPixelFormatGrayscale8, &tempImage );
+            ret = ErrorInvalidArgument;
         }
     }
 
     if ( ret == SuccessCode )
     {
-        int      width     = src->width;
-        int      height    = src->height;
-        int      dstStride = dst->stride;
-        int      tmpStride = tempImage->stride;
-        int      x, y;
-        uint32_t shift;
-        int32_t  error;
-        int32_t  diffusion;
-        int      i;
-
-        uint8_t* tmpPtr = tempImage->data;
-        uint8_t* dstPtr = dst->data;
-        uint8_t* tmpRow2;
-        int32_t  value;
-
-        int      imageIndex;
-        int      coefficientIndex;
-        int      coefficientsCount;
-
-        const uint8_t* coefficients;
-
-        // copy source image to temp, since we need to modify it
-        XImageCopyData( src, tempImage );
-
-        for ( y = 0; y < height; y++ )
+        int32_t           width        = src->width;
+        int32_t           height       = src->height;
+        // spinning rows would only slow each other down if there are more threads than processors
+        int32_t           threadsCount = XMAX( 1, XMIN3( omp_get_max_threads( ), omp_get_num_procs( ), height ) );
+        DiffusionContext  context;
+        int16_t*          tables;
+        const int16_t**   linesTables;
+        int16_t*          rows;
+        volatile int32_t* progress;
+
+        // rows are padded, so diffusion never needs to check image boundaries
+        context.src         = src;
+        context.dst         = dst;
+        context.linesCount  = diffusionLinesCount;
+        context.linesLength = diffusionLinesLength;
+        context.rowPadding  = maxLineLength;
+        context.rowStride   = width + maxLineLength * 2;
+        context.lag         = maxLineLength * 2;
+        context.rowsCount   = diffusionLinesCount + threadsCount * 2;
+
+        tables      = (int16_t*) malloc( sizeof( int16_t ) * ERRORS_COUNT * coefficientsTotal );
+        linesTables = (const int16_t**) malloc( sizeof( int16_t* ) * diffusionLinesCount );
+        rows        = (int16_t*) calloc( (size_t) context.rowStride * context.rowsCount, sizeof( int16_t ) );
+        progress    = (volatile int32_t*) calloc( height, sizeof( int32_t ) );
+
+        if ( ( tables == 0 ) || ( linesTables == 0 ) || ( rows == 0 ) || ( progress == 0 ) )
         {
-            uint8_t* tmpRow = tmpPtr + y * tmpStride;
-            uint8_t* dstRow = dstPtr + y * dstStride;
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            int16_t* table = tables;
+            int32_t  i, k, error;
 
-            for ( x = 0; x < width; x++ )
+            // pre-calculate diffused errors for every coefficient, so division is not needed
+            for ( i = 0; i < diffusionLinesCount; i++ )
             {
-                value = (int32_t) *tmpRow;
-                shift = 7 - ( x & 7 );
+                linesTables[i] = table;
 
-                // thresholding and error calculation
-                if ( value >= THRESHOLD )
+                for ( k = 0; k < diffusionLinesLength[i]; k++ )
                 {
-                    *dstRow |= ( 1 << shift );
-                    error = value - 255;
-                }
-                else
-                {
-                    error = value;
-                }
-
-                // error diffusion to the pixels on the right of the just processed one
-                coefficients = diffusionLinesCoefficients[0];
-                coefficientsCount = diffusionLinesLength[0];
-
-                for ( coefficientIndex = 0, imageIndex = 1; coefficientIndex < coefficientsCount; coefficientIndex++, imageIndex++ )
-                {
-                    if ( x + imageIndex >= width )
+                    for ( error = -ERROR_OFFSET; error <= ERROR_OFFSET; error++ )
                     {
-                        break;
+                        *table = (int16_t) ( ( error * diffusionLinesCoefficients[i][k] ) / coefficientsSum );
+                        table++;
                     }
-
-                    diffusion = ( error * coefficients[coefficientIndex] ) / coefficientsSum + tmpRow[imageIndex];
-                    diffusion = XINRANGE( diffusion, 0, 255 );
-                    tmpRow[imageIndex] = (uint8_t) diffusion;
                 }
+            }
 
-                // error diffusion to the pixels under the one just processed
-                for ( i = 1; i < diffusionLinesCount; i++ )
-                {
-                    if ( y + i >= height )
-                    {
-                        break;
-                    }
-
-                    // get the line to diffuse error to
-                    tmpRow2 = tmpRow + i * tmpStride;
+            context.diffusionTables = linesTables;
+            context.rows            = rows;
+            context.progress        = progress;
 
-                    coefficients = diffusionLinesCoefficients[i];
-                    coefficientsCount = diffusionLinesLength[i];
+            // load rows the first row diffuses its error to
+            for ( i = 0; i < diffusionLinesCount - 1; i++ )
+            {
+                LoadDiffusionRow( &context, i );
+            }
 
-                    for  ( coefficientIndex = 0, imageIndex = -( coefficientsCount >> 1 ); coefficientIndex < coefficientsCount; coefficientIndex++, imageIndex++ )
-                    {
-                        if ( x + imageIndex >= width )
-                        {
-                            break;
-                        }
-                        if ( x + imageIndex < 0 )
-                        {
-                            continue;
-                        }
-
-                        diffusion = ( error * coefficients[coefficientIndex] ) / coefficientsSum + tmpRow2[imageIndex];
-                        diffusion = XINRANGE( diffusion, 0, 255 );
-                        tmpRow2[imageIndex] = (uint8_t) diffusion;
-                    }
-                }
+            #pragma omp parallel num_threads( threadsCount )
+            {
+                int32_t threadStep = omp_get_num_threads( );
+                int32_t y;
 
-                // increment pointers
-                if ( shift == 0 )
+                for ( y = omp_get_thread_num( ); y < height; y += threadStep )
                 {
-                    dstRow++;
+                    LoadDiffusionRow( &context, y + diffusionLinesCount - 1 );
+                    DiffuseRow( &context, y );
                 }
-                tmpRow++;
             }
         }
 
-        // free temp image
-        if ( tempImage != 0 )
-        {
-            XImageFree( &tempImage );
-        }
+        free( tables );
+        free( (void*) linesTables );
+        free( rows );
+        free( (void*) progress );
     }
 
     return ret;
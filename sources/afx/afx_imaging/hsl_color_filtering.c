@@ -21,91 +21,111 @@
 
 #include "ximaging.h"
 
-// Remove colors outside/inside of the specified HSL range
-XErrorCode HslColorFiltering( ximage* src, xhsl minValues, xhsl maxValues, bool fillOutside, xargb fillColor )
+// Number of image rows converted into color space planes at once
+#define STRIP_HEIGHT (32)
+
+// Bulk conversion of color image into hue/saturation/luminance(value) planes
+typedef XErrorCode ( *ColorToPlanesHandler )( const ximage* src, ximage* hue, ximage* saturation, ximage* third );
+
+// Remove colors outside/inside of the specified range of hue, saturation and luminance/value
+static XErrorCode HueSaturationFiltering( ximage* src, ColorToPlanesHandler toPlanes,
+                                          uint16_t hueMin, uint16_t hueMax, float saturationMin, float saturationMax,
+                                          float thirdMin, float thirdMax, bool fillOutside, xargb fillColor )
 {
+    int      width     = src->width;
+    int      height    = src->height;
+    int      stride    = src->stride;
+    int      pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
+    ximage*  planes[3] = { 0, 0, 0 };
+    int      i;
+
     XErrorCode ret = SuccessCode;
 
-    if ( src == 0 )
-    {
-        ret = ErrorNullParameter;
-    }
-    if ( ( src->format != XPixelFormatRGB24 ) && ( src->format != XPixelFormatRGBA32 ) )
+    for ( i = 0; ( i < 3 ) && ( ret == SuccessCode ); i++ )
     {
-        ret = ErrorUnsupportedPixelFormat;
+        ret = XImageAllocateRaw( width, XMIN( height, STRIP_HEIGHT ), XPixelFormatGrayscaleR4, &planes[i] );
     }
-    else
+
+    if ( ret == SuccessCode )
     {
-        uint8_t* ptr  = src->data;
-        int width     = src->width;
-        int height    = src->height;
-        int stride    = src->stride;
-        int pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
-
-        uint16_t hueMin        = minValues.Hue % 360;
-        uint16_t hueMax        = maxValues.Hue % 360;
-        float    saturationMin = minValues.Saturation;
-        float    saturationMax = maxValues.Saturation;
-        float    luminanceMin  = minValues.Luminance;
-        float    luminanceMax  = maxValues.Luminance;
-
-        int y;
-
-        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, hueMin, hueMax, saturationMin, saturationMax, luminanceMin, luminanceMax, fillOutside, fillColor  )
-        for ( y = 0; y < height; y++ )
+        int stripStart;
+
+        for ( stripStart = 0; ( stripStart < height ) && ( ret == SuccessCode ); stripStart += STRIP_HEIGHT )
         {
-            uint8_t* row = ptr + y * stride;
-            int      x;
-            xargb    rgb;
-            xhsl     hsl;
-            bool     updatePixel;
+            // the strip of source image and planes of the same height
+            ximage   strip       = *src;
+            ximage   hue         = *planes[0];
+            ximage   saturation  = *planes[1];
+            ximage   third       = *planes[2];
+            int      stripHeight = XMIN( STRIP_HEIGHT, height - stripStart );
+            uint8_t* ptr         = src->data + stripStart * stride;
+            int      y;
 
-            for ( x = 0; x < width; x++, row += pixelSize )
-            {
-                updatePixel = false;
-
-                rgb.components.r = row[RedIndex];
-                rgb.components.g = row[GreenIndex];
-                rgb.components.b = row[BlueIndex];
-
-                Rgb2Hsl( &rgb, &hsl );
-
-                if (
-                    ( hsl.Saturation >= saturationMin ) && ( hsl.Saturation <= saturationMax ) &&
-                    ( hsl.Luminance >= luminanceMin ) && ( hsl.Luminance <= luminanceMax ) &&
-                    (
-                        ( ( hueMin < hueMax ) &&   ( hsl.Hue >= hueMin ) && ( hsl.Hue <= hueMax ) ) ||
-                        ( ( hueMin > hueMax ) && ( ( hsl.Hue >= hueMin ) || ( hsl.Hue <= hueMax ) ) )
-                    )
-                   )
-                {
-                    updatePixel = ( fillOutside == false );
-                }
-                else
-                {
-                    updatePixel = ( fillOutside == true );
-                }
+            strip.data   = ptr;
+            strip.height = hue.height = saturation.height = third.height = stripHeight;
 
-                if ( updatePixel )
-                {
-                    row[RedIndex]   = fillColor.components.r;
-                    row[GreenIndex] = fillColor.components.g;
-                    row[BlueIndex]  = fillColor.components.b;
+            ret = toPlanes( &strip, &hue, &saturation, &third );
 
-                    if ( pixelSize == 4 )
+            if ( ret == SuccessCode )
+            {
+                #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, hue, saturation, third, hueMin, hueMax, saturationMin, saturationMax, thirdMin, thirdMax, fillOutside, fillColor )
+                for ( y = 0; y < stripHeight; y++ )
+                {
+                    uint8_t*     row           = ptr + y * stride;
+                    const float* hueRow        = (const float*) ( hue.data + y * hue.stride );
+                    const float* saturationRow = (const float*) ( saturation.data + y * saturation.stride );
+                    const float* thirdRow      = (const float*) ( third.data + y * third.stride );
+                    int          x;
+                    uint16_t     pixelHue;
+                    bool         updatePixel;
+
+                    for ( x = 0; x < width; x++, row += pixelSize )
                     {
-                        row[AlphaIndex] = fillColor.components.a;
+                        pixelHue = (uint16_t) hueRow[x];
+
+                        if (
+                            ( saturationRow[x] >= saturationMin ) && ( saturationRow[x] <= saturationMax ) &&
+                            ( thirdRow[x] >= thirdMin ) && ( thirdRow[x] <= thirdMax ) &&
+                            (
+                                ( ( hueMin < hueMax ) &&   ( pixelHue >= hueMin ) && ( pixelHue <= hueMax ) ) ||
+                                ( ( hueMin > hueMax ) && ( ( pixelHue >= hueMin ) || ( pixelHue <= hueMax ) ) )
+                            )
+                           )
+                        {
+                            updatePixel = ( fillOutside == false );
+                        }
+                        else
+                        {
+                            updatePixel = ( fillOutside == true );
+                        }
+
+                        if ( updatePixel )
+                        {
+                            row[RedIndex]   = fillColor.components.r;
+                            row[GreenIndex] = fillColor.components.g;
+                            row[BlueIndex]  = fillColor.components.b;
+
+                            if ( pixelSize == 4 )
+                            {
+                                row[AlphaIndex] = fillColor.components.a;
+                            }
+                        }
                     }
                 }
             }
         }
     }
 
+    for ( i = 0; i < 3; i++ )
+    {
+        XImageFree( &planes[i] );
+    }
+
     return ret;
 }
 
-// Remove colors outside/inside of the specified HSV range
-XErrorCode HsvColorFiltering( ximage* src, xhsv minValues, xhsv maxValues, bool fillOutside, xargb fillColor )
+// Remove colors outside/inside of the specified HSL range
+XErrorCode HslColorFiltering( ximage* src, xhsl minValues, xhsl maxValues, bool fillOutside, xargb fillColor )
 {
     XErrorCode ret = SuccessCode;
 
@@ -113,75 +133,38 @@ XErrorCode HsvColorFiltering( ximage* src, xhsv minValues, xhsv maxValues, bool
     {
         ret = ErrorNullParameter;
     }
-    if ( ( src->format != XPixelFormatRGB24 ) && ( src->format != XPixelFormatRGBA32 ) )
+    else if ( ( src->format != XPixelFormatRGB24 ) && ( src->format != XPixelFormatRGBA32 ) )
     {
         ret = ErrorUnsupportedPixelFormat;
     }
     else
     {
-        uint8_t* ptr  = src->data;
-        int width     = src->width;
-        int height    = src->height;
-        int stride    = src->stride;
-        int pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
-
-        uint16_t hueMin        = minValues.Hue % 360;
-        uint16_t hueMax        = maxValues.Hue % 360;
-        float    saturationMin = minValues.Saturation;
-        float    saturationMax = maxValues.Saturation;
-        float    valueMin      = minValues.Value;
-        float    valueMax      = maxValues.Value;
-
-        int y;
-
-        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, hueMin, hueMax, saturationMin, saturationMax, valueMin, valueMax, fillOutside, fillColor  )
-        for ( y = 0; y < height; y++ )
-        {
-            uint8_t* row = ptr + y * stride;
-            int      x;
-            xargb    rgb;
-            xhsv     hsv;
-            int      updatePixel;
+        ret = HueSaturationFiltering( src, ColorImageToHslPlanes, minValues.Hue % 360, maxValues.Hue % 360,
+                                      minValues.Saturation, maxValues.Saturation, minValues.Luminance, maxValues.Luminance,
+                                      fillOutside, fillColor );
+    }
 
-            for ( x = 0; x < width; x++, row += pixelSize )
-            {
-                updatePixel = 0;
-
-                rgb.components.r = row[RedIndex];
-                rgb.components.g = row[GreenIndex];
-                rgb.components.b = row[BlueIndex];
-
-                Rgb2Hsv( &rgb, &hsv );
-
-                if (
-                    ( hsv.Saturation >= saturationMin ) && ( hsv.Saturation <= saturationMax ) &&
-                    ( hsv.Value >= valueMin ) && ( hsv.Value <= valueMax ) &&
-                    (
-                        ( ( hueMin < hueMax ) &&   ( hsv.Hue >= hueMin ) && ( hsv.Hue <= hueMax ) ) ||
-                        ( ( hueMin > hueMax ) && ( ( hsv.Hue >= hueMin ) || ( hsv.Hue <= hueMax ) ) )
-                    )
-                   )
-                {
-                    updatePixel = ( fillOutside == false );
-                }
-                else
-                {
-                    updatePixel = ( fillOutside == true );
-                }
+    return ret;
+}
 
-                if ( updatePixel )
-                {
-                    row[RedIndex]   = fillColor.components.r;
-                    row[GreenIndex] = fillColor.components.g;
-                    row[BlueIndex]  = fillColor.components.b;
+// Remove colors outside/inside of the specified HSV range
+XErrorCode HsvColorFiltering( ximage* src, xhsv minValues, xhsv maxValues, bool fillOutside, xargb fillColor )
+{
+    XErrorCode ret = SuccessCode;
 
-                    if ( pixelSize == 4 )
-                    {
-                        row[AlphaIndex] = fillColor.components.a;
-                    }
-                }
-            }
-        }
+    if ( src == 0 )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( src->format != XPixelFormatRGB24 ) && ( src->format != XPixelFormatRGBA32 ) )
+    {
+        ret = ErrorUnsupportedPixelFormat;
+    }
+    else
+    {
+        ret = HueSaturationFiltering( src, ColorImageToHsvPlanes, minValues.Hue % 360, maxValues.Hue % 360,
+                                      minValues.Saturation, maxValues.Saturation, minValues.Value, maxValues.Value,
+                                      fillOutside, fillColor );
     }
 
     return ret;
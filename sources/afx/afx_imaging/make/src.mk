@@ -5,8 +5,8 @@ VPATH = ../../
 
 # source files
 SRC =  additive_noise.c alpha.c \
-	binary_dilatation_3x3.c binary_erosion_3x3.c binary2grayscale.c blob_counter.c blur_image.c \
-	canny_edge_detector.c color_conversion.c color_filtering.c color_maps.c color_remapping.c color2grayscale.c \
+	bilateral_filter.c binary_dilatation_3x3.c binary_erosion_3x3.c binary2grayscale.c blob_counter.c blur_image.c \
+	canny_edge_detector.c color_conversion.c color_filtering.c color_maps.c color_remapping.c color_space_planes.c color2grayscale.c \
 	contrast_stretching.c convolution.c \
 	dilatation_3x3.c distance_transform.c drawing.c drawing_text.c \
 	edge_detectors.c erosion_3x3.c error_diffusion_dithering.c extract_channel.c extract_channel_nrgb.c \
@@ -19,10 +19,16 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
 */
 
-#include <time.h>
 #include "ximaging.h"
+#include "xrandom.h"
+
+// Number of pixels to generate random numbers for at once
+#define RANDOM_BLOCK_SIZE (64)
 
 // Add salt-and-pepper noise to the specified image
+//
+// Random numbers come from the counter based generator keyed by the seed and pixel's coordinates,
+// so rows can be processed in parallel, while the result does not depend on number of threads.
 XErrorCode SaltAndPepperNoise( ximage* src, uint32_t seed, float noiseAmount, uint8_t pepperValue, uint8_t saltValue )
 {
     XErrorCode ret = SuccessCode;
@@ -39,55 +45,52 @@ XErrorCode SaltAndPepperNoise( ximage* src, uint32_t seed, float noiseAmount, ui
     }
     else
     {
-        int         noiseThreshold = (int) ( XINRANGE( noiseAmount, 0.0f, 100.0f ) * 100 );
-        int         width  = src->width;
-        int         height = src->height;
-        int         stride = src->stride;
-        int         x, y;
+        uint32_t    noiseThreshold = (uint32_t) ( XINRANGE( noiseAmount, 0.0f, 100.0f ) * 100 );
+        int         width     = src->width;
+        int         height    = src->height;
+        int         stride    = src->stride;
+        int         pixelSize = ( src->format == XPixelFormatGrayscale8 ) ? 1 : ( ( src->format == XPixelFormatRGB24 ) ? 3 : 4 );
+        int         y;
         uint8_t*    ptr = src->data;
-        uint8_t*    row;
 
         uint8_t     noiseValues[2];
 
         noiseValues[0] = pepperValue;
         noiseValues[1] = saltValue;
 
-        // initialize random number generator
-        srand( seed );
-
-        if ( src->format == XPixelFormatGrayscale8 )
+        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, seed, noiseThreshold, noiseValues )
+        for ( y = 0; y < height; y++ )
         {
-            for ( y = 0; y < height; y++ )
+            uint8_t* row = ptr + y * stride;
+            uint32_t randoms[RANDOM_BLOCK_SIZE * 4];
+            uint32_t* rnd;
+            int      x, blockStart, blockSize;
+
+            for ( blockStart = 0; blockStart < width; blockStart += RANDOM_BLOCK_SIZE )
             {
-                row = ptr + y * stride;
+                blockSize = XMIN( RANDOM_BLOCK_SIZE, width - blockStart );
 
-                for ( x = 0; x < width; x++ )
+                XRandom4Batch( seed, 0, (uint32_t) y, (uint32_t) blockStart, (uint32_t) blockSize, randoms );
+
+                if ( pixelSize == 1 )
                 {
-                    if ( ( rand( ) % 10000 ) < noiseThreshold )
+                    for ( x = 0, rnd = randoms; x < blockSize; x++, rnd += 4, row++ )
                     {
-                        *row = noiseValues[rand( ) & 1];
+                        if ( XRANDOM_RANGE( rnd[0], 10000 ) < noiseThreshold )
+                        {
+                            *row = noiseValues[rnd[1] >> 31];
+                        }
                     }
-
-                    row++;
                 }
-            }
-        }
-        else
-        {
-            uint32_t pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
-
-            for ( y = 0; y < height; y++ )
-            {
-                row = ptr + y * stride;
-
-                for ( x = 0; x < width; x++ )
+                else
                 {
-                    if ( ( rand( ) % 10000 ) < noiseThreshold )
+                    for ( x = 0, rnd = randoms; x < blockSize; x++, rnd += 4, row += pixelSize )
                     {
-                        row[rand( ) % 3] = noiseValues[rand( ) & 1];
+                        if ( XRANDOM_RANGE( rnd[0], 10000 ) < noiseThreshold )
+                        {
+                            row[XRANDOM_RANGE( rnd[2], 3 )] = noiseValues[rnd[1] >> 31];
+                        }
                     }
-
-                    row += pixelSize;
                 }
             }
         }
@@ -21,7 +21,11 @@
 
 #include "ximaging.h"
 
-// Set hue value of all pixels to same value
+// Set hue value of all pixels to same value.
+//
+// Changing hue keeps maximum and minimum of RGB components the same (saturation and value in HSV terms), so every
+// component of a pixel is "min + ( max - min ) * weight", where weights depend on the hue only. Those are calculated
+// once for the entire image instead of doing RGB->HSV->RGB conversion for every pixel.
 XErrorCode SetImageHue( ximage* src, uint16_t hue )
 {
     XErrorCode ret = SuccessCode;
@@ -42,32 +46,39 @@ XErrorCode SetImageHue( ximage* src, uint16_t hue )
         int height    = src->height;
         int stride    = src->stride;
         int pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
-        int y;
+        int y, i;
+
+        // 16.16 fixed point weights of red, green and blue components
+        int weights[3];
 
         // make sure hue value is in correct range
         hue = hue % 360;
 
-        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, hue )
+        for ( i = 0; i < 3; i++ )
+        {
+            // weight of a component is "1 - max( 0, min( k, 4 - k, 1 ) )", where "k = ( n + H / 60 ) mod 6"
+            // and "n" is 5, 3 and 1 for red, green and blue
+            float k = ( 5 - 2 * i ) + hue / 60.0f;
+
+            if ( k >= 6.0f ) k -= 6.0f;
+
+            weights[i] = (int) ( ( 1.0f - XINRANGE( XMIN( k, 4.0f - k ), 0.0f, 1.0f ) ) * 65536.0f + 0.5f );
+        }
+
+        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, weights )
         for ( y = 0; y < height; y++ )
         {
             uint8_t* row = ptr + y * stride;
-            int      x;
-            xargb    rgb;
-            xhsv     hsv;
+            int      x, min, delta;
 
             for ( x = 0; x < width; x++, row += pixelSize )
             {
-                rgb.components.r = row[RedIndex];
-                rgb.components.g = row[GreenIndex];
-                rgb.components.b = row[BlueIndex];
-
-                Rgb2Hsv( &rgb, &hsv );
-                hsv.Hue = hue;
-                Hsv2Rgb( &hsv, &rgb );
+                min   = XMIN3( row[RedIndex], row[GreenIndex], row[BlueIndex] );
+                delta = XMAX3( row[RedIndex], row[GreenIndex], row[BlueIndex] ) - min;
 
-                row[RedIndex]   = rgb.components.r;
-                row[GreenIndex] = rgb.components.g;
-                row[BlueIndex]  = rgb.components.b;
+                row[RedIndex]   = (uint8_t) ( min + ( ( delta * weights[0] + 0x8000 ) >> 16 ) );
+                row[GreenIndex] = (uint8_t) ( min + ( ( delta * weights[1] + 0x8000 ) >> 16 ) );
+                row[BlueIndex]  = (uint8_t) ( min + ( ( delta * weights[2] + 0x8000 ) >> 16 ) );
             }
         }
     }
@@ -20,6 +20,20 @@
 */
 
 #include "ximaging.h"
+#include "xcpuid.h"
+
+// SSE intrinsics
+#ifdef _MSC_VER
+    #include <intrin.h>
+#elif __GNUC__
+    #include <x86intrin.h>
+#endif
+
+// Plain C code of FadeImages(), AddImages() and SubtractImages() must round float values same way as their
+// SSE2 versions do, which is not the case for x87 code generated by 32 bit GCC by default
+#if defined( __GNUC__ ) && defined( __i386__ )
+    #pragma GCC target( "fpmath=sse" )
+#endif
 
 // Make sure provided images are valid
 static XErrorCode CheckImages( ximage* image1, const ximage* image2 )
@@ -46,6 +60,326 @@ static XErrorCode CheckImages( ximage* image1, const ximage* image2 )
     return ret;
 }
 
+// ======= SSE2 versions of row processing =======
+// Each of the functions below processes as many bytes of a row as it can using 16 byte blocks and
+// returns number of processed bytes. The remaining bytes are left for plain C code.
+
+// Integer division by 255 of 16 bit values in [0, 65025] range: ( x + 1 + ( x >> 8 ) ) >> 8
+static __m128i DivideBy255SSE2( __m128i x )
+{
+    return _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( x, _mm_set1_epi16( 1 ) ), _mm_srli_epi16( x, 8 ) ), 8 );
+}
+
+// Integer division by 255 of doubled 16 bit values in [0, 65025] range: ( 2 * x ) / 255
+static __m128i DoubleDivideBy255SSE2( __m128i x )
+{
+    // 2 * x / 255 = 2 * q + ( ( 2 * r >= 255 ) ? 1 : 0 ), where q = x / 255 and r = x - 255 * q
+    __m128i q = DivideBy255SSE2( x );
+    __m128i r = _mm_sub_epi16( x, _mm_sub_epi16( _mm_slli_epi16( q, 8 ), q ) );
+
+    return _mm_sub_epi16( _mm_add_epi16( q, q ), _mm_cmpgt_epi16( r, _mm_set1_epi16( 127 ) ) );
+}
+
+// Convert 16 unsigned bytes into 4 vectors of floats
+static void BytesToFloatsSSE2( __m128i v, __m128 f[4] )
+{
+    __m128i zero = _mm_setzero_si128( );
+    __m128i lo   = _mm_unpacklo_epi8( v, zero );
+    __m128i hi   = _mm_unpackhi_epi8( v, zero );
+
+    f[0] = _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) );
+    f[1] = _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) );
+    f[2] = _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) );
+    f[3] = _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) );
+}
+
+// Convert 4 vectors of floats in [0, 255] range into 16 unsigned bytes, truncating them as C cast does
+static __m128i FloatsToBytesSSE2( const __m128 f[4] )
+{
+    __m128i lo = _mm_packs_epi32( _mm_cvttps_epi32( f[0] ), _mm_cvttps_epi32( f[1] ) );
+    __m128i hi = _mm_packs_epi32( _mm_cvttps_epi32( f[2] ), _mm_cvttps_epi32( f[3] ) );
+
+    return _mm_packus_epi16( lo, hi );
+}
+
+// Absolute difference of unsigned bytes
+static __m128i AbsDiffSSE2( __m128i v1, __m128i v2 )
+{
+    return _mm_or_si128( _mm_subs_epu8( v1, v2 ), _mm_subs_epu8( v2, v1 ) );
+}
+
+// Pack color into 32 bit value, which has same byte order as pixels of 32 bpp image
+static uint32_t PackPixel32( uint8_t r, uint8_t g, uint8_t b, uint8_t a )
+{
+    return ( (uint32_t) r << ( RedIndex * 8 ) ) | ( (uint32_t) g << ( GreenIndex * 8 ) ) |
+           ( (uint32_t) b << ( BlueIndex * 8 ) ) | ( (uint32_t) a << ( AlphaIndex * 8 ) );
+}
+
+// row1 = max( row1, row2 )
+static int MergeRowSSE2( uint8_t* row1, const uint8_t* row2, int length )
+{
+    int x;
+
+    for ( x = 0; x + 16 <= length; x += 16 )
+    {
+        __m128i v1 = _mm_loadu_si128( (const __m128i*) ( row1 + x ) );
+        __m128i v2 = _mm_loadu_si128( (const __m128i*) ( row2 + x ) );
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), _mm_max_epu8( v1, v2 ) );
+    }
+
+    return x;
+}
+
+// row1 = min( row1, row2 )
+static int IntersectRowSSE2( uint8_t* row1, const uint8_t* row2, int length )
+{
+    int x;
+
+    for ( x = 0; x + 16 <= length; x += 16 )
+    {
+        __m128i v1 = _mm_loadu_si128( (const __m128i*) ( row1 + x ) );
+        __m128i v2 = _mm_loadu_si128( (const __m128i*) ( row2 + x ) );
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), _mm_min_epu8( v1, v2 ) );
+    }
+
+    return x;
+}
+
+// Move row1 values towards row2 values by the specified step
+static int MoveTowardsRowSSE2( uint8_t* row1, const uint8_t* row2, int length, uint8_t step )
+{
+    __m128i stepVec = _mm_set1_epi8( (char) step );
+    int     x;
+
+    for ( x = 0; x + 16 <= length; x += 16 )
+    {
+        __m128i v1   = _mm_loadu_si128( (const __m128i*) ( row1 + x ) );
+        __m128i v2   = _mm_loadu_si128( (const __m128i*) ( row2 + x ) );
+        __m128i up   = _mm_min_epu8( _mm_subs_epu8( v2, v1 ), stepVec );
+        __m128i down = _mm_min_epu8( _mm_subs_epu8( v1, v2 ), stepVec );
+
+        // only one of up/down can be non zero, so no saturation actually happens
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), _mm_sub_epi8( _mm_add_epi8( v1, up ), down ) );
+    }
+
+    return x;
+}
+
+// row1 = factor1 * row1 + factor2 * row2 (same float operations as plain C code does, so result is exactly the same)
+static int FadeRowSSE2( uint8_t* row1, const uint8_t* row2, int length, float factor1, float factor2 )
+{
+    __m128 f1 = _mm_set1_ps( factor1 );
+    __m128 f2 = _mm_set1_ps( factor2 );
+    __m128 v1[4], v2[4];
+    int    x, i;
+
+    for ( x = 0; x + 16 <= length; x += 16 )
+    {
+        BytesToFloatsSSE2( _mm_loadu_si128( (const __m128i*) ( row1 + x ) ), v1 );
+        BytesToFloatsSSE2( _mm_loadu_si128( (const __m128i*) ( row2 + x ) ), v2 );
+
+        for ( i = 0; i < 4; i++ )
+        {
+            v1[i] = _mm_add_ps( _mm_mul_ps( f1, v1[i] ), _mm_mul_ps( f2, v2[i] ) );
+        }
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), FloatsToBytesSSE2( v1 ) );
+    }
+
+    return x;
+}
+
+// row1 = factor2 * row2 + row1, clamped to [0, 255] range (used for both adding and subtracting, when factor is negative)
+static int AddScaledRowSSE2( uint8_t* row1, const uint8_t* row2, int length, float factor2 )
+{
+    __m128 f2   = _mm_set1_ps( factor2 );
+    __m128 zero = _mm_setzero_ps( );
+    __m128 max  = _mm_set1_ps( 255.0f );
+    __m128 v1[4], v2[4];
+    int    x, i;
+
+    for ( x = 0; x + 16 <= length; x += 16 )
+    {
+        BytesToFloatsSSE2( _mm_loadu_si128( (const __m128i*) ( row1 + x ) ), v1 );
+        BytesToFloatsSSE2( _mm_loadu_si128( (const __m128i*) ( row2 + x ) ), v2 );
+
+        for ( i = 0; i < 4; i++ )
+        {
+            v1[i] = _mm_min_ps( _mm_max_ps( _mm_add_ps( _mm_mul_ps( f2, v2[i] ), v1[i] ), zero ), max );
+        }
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), FloatsToBytesSSE2( v1 ) );
+    }
+
+    return x;
+}
+
+// row1 = abs( row1 - row2 ) for all bytes, except those set in keepMask (for which row1 is not changed)
+static int DiffRowSSE2( uint8_t* row1, const uint8_t* row2, int length, __m128i keepMask )
+{
+    int x;
+
+    for ( x = 0; x + 16 <= length; x += 16 )
+    {
+        __m128i v1   = _mm_loadu_si128( (const __m128i*) ( row1 + x ) );
+        __m128i v2   = _mm_loadu_si128( (const __m128i*) ( row2 + x ) );
+        __m128i diff = AbsDiffSSE2( v1, v2 );
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), _mm_or_si128( _mm_andnot_si128( keepMask, diff ), _mm_and_si128( keepMask, v1 ) ) );
+    }
+
+    return x;
+}
+
+// Thresholded difference of 8 bpp grayscale rows, which also counts pixels with difference above threshold
+// (threshold must be in [0, 255] range)
+static int DiffThresholdedRow8SSE2( uint8_t* row1, const uint8_t* row2, int width, int threshold,
+                                    uint8_t hiValue, uint8_t lowValue, uint32_t* counter )
+{
+    __m128i zero     = _mm_setzero_si128( );
+    __m128i ones     = _mm_set1_epi8( 1 );
+    __m128i thVec    = _mm_set1_epi8( (char) threshold );
+    __m128i hiVec    = _mm_set1_epi8( (char) hiValue );
+    __m128i lowVec   = _mm_set1_epi8( (char) lowValue );
+    __m128i countVec = _mm_setzero_si128( );
+    int     x;
+
+    for ( x = 0; x + 16 <= width; x += 16 )
+    {
+        __m128i v1   = _mm_loadu_si128( (const __m128i*) ( row1 + x ) );
+        __m128i v2   = _mm_loadu_si128( (const __m128i*) ( row2 + x ) );
+        __m128i diff = AbsDiffSSE2( v1, v2 );
+        // diff >= threshold
+        __m128i mask = _mm_cmpeq_epi8( _mm_max_epu8( diff, thVec ), diff );
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), _mm_or_si128( _mm_and_si128( mask, hiVec ), _mm_andnot_si128( mask, lowVec ) ) );
+
+        // sum up number of set bytes
+        countVec = _mm_add_epi64( countVec, _mm_sad_epu8( _mm_and_si128( mask, ones ), zero ) );
+    }
+
+    *counter += (uint32_t) ( _mm_cvtsi128_si32( countVec ) + _mm_cvtsi128_si32( _mm_srli_si128( countVec, 8 ) ) );
+
+    return x;
+}
+
+// Thresholded difference of 32 bpp color rows, which also counts pixels with difference above threshold
+// (sum of RGB differences is compared with the threshold; returns number of processed pixels)
+static int DiffThresholdedRow32SSE2( uint8_t* row1, const uint8_t* row2, int width, int threshold,
+                                     uint32_t hiPixel, uint32_t lowPixel, uint32_t* counter )
+{
+    __m128i zero     = _mm_setzero_si128( );
+    __m128i ones     = _mm_set1_epi16( 1 );
+    __m128i rgbMask  = _mm_set1_epi32( (int) ~PackPixel32( 0, 0, 0, 255 ) );
+    __m128i thVec    = _mm_set1_epi32( threshold - 1 );
+    __m128i hiVec    = _mm_set1_epi32( (int) hiPixel );
+    __m128i lowVec   = _mm_set1_epi32( (int) lowPixel );
+    __m128i countVec = _mm_setzero_si128( );
+    int     x;
+
+    for ( x = 0; x + 4 <= width; x += 4 )
+    {
+        __m128i v1   = _mm_loadu_si128( (const __m128i*) ( row1 + x * 4 ) );
+        __m128i v2   = _mm_loadu_si128( (const __m128i*) ( row2 + x * 4 ) );
+        __m128i diff = _mm_and_si128( AbsDiffSSE2( v1, v2 ), rgbMask );
+        __m128i sumLo, sumHi, mask;
+
+        // sum RGB differences of each pixel - first pairs of 16 bit values, then pairs of 32 bit values
+        sumLo = _mm_madd_epi16( _mm_unpacklo_epi8( diff, zero ), ones );
+        sumHi = _mm_madd_epi16( _mm_unpackhi_epi8( diff, zero ), ones );
+        sumLo = _mm_add_epi32( sumLo, _mm_shuffle_epi32( sumLo, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+        sumHi = _mm_add_epi32( sumHi, _mm_shuffle_epi32( sumHi, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+        // collect per pixel sums into single register
+        sumLo = _mm_unpacklo_epi64( _mm_shuffle_epi32( sumLo, _MM_SHUFFLE( 3, 1, 2, 0 ) ), _mm_shuffle_epi32( sumHi, _MM_SHUFFLE( 3, 1, 2, 0 ) ) );
+
+        // sum >= threshold
+        mask = _mm_cmpgt_epi32( sumLo, thVec );
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x * 4 ), _mm_or_si128( _mm_and_si128( mask, hiVec ), _mm_andnot_si128( mask, lowVec ) ) );
+
+        // mask is -1 for pixels above threshold
+        countVec = _mm_sub_epi32( countVec, mask );
+    }
+
+    countVec = _mm_add_epi32( countVec, _mm_srli_si128( countVec, 8 ) );
+    countVec = _mm_add_epi32( countVec, _mm_srli_si128( countVec, 4 ) );
+    *counter += (uint32_t) _mm_cvtsi128_si32( countVec );
+
+    return x;
+}
+
+// Multiply blending: row1 = row1 * row2 / 255
+static int BlendMultiplyRowSSE2( uint8_t* row1, const uint8_t* row2, int length )
+{
+    __m128i zero = _mm_setzero_si128( );
+    int     x;
+
+    for ( x = 0; x + 16 <= length; x += 16 )
+    {
+        __m128i v1 = _mm_loadu_si128( (const __m128i*) ( row1 + x ) );
+        __m128i v2 = _mm_loadu_si128( (const __m128i*) ( row2 + x ) );
+        __m128i lo = DivideBy255SSE2( _mm_mullo_epi16( _mm_unpacklo_epi8( v1, zero ), _mm_unpacklo_epi8( v2, zero ) ) );
+        __m128i hi = DivideBy255SSE2( _mm_mullo_epi16( _mm_unpackhi_epi8( v1, zero ), _mm_unpackhi_epi8( v2, zero ) ) );
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), _mm_packus_epi16( lo, hi ) );
+    }
+
+    return x;
+}
+
+// Screen blending: row1 = 255 - ( 255 - row1 ) * ( 255 - row2 ) / 255
+static int BlendScreenRowSSE2( uint8_t* row1, const uint8_t* row2, int length )
+{
+    __m128i zero = _mm_setzero_si128( );
+    __m128i all  = _mm_set1_epi8( (char) 0xFF );
+    int     x;
+
+    for ( x = 0; x + 16 <= length; x += 16 )
+    {
+        // 255 - v is same as inverting all bits of a byte
+        __m128i v1 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*) ( row1 + x ) ), all );
+        __m128i v2 = _mm_xor_si128( _mm_loadu_si128( (const __m128i*) ( row2 + x ) ), all );
+        __m128i lo = DivideBy255SSE2( _mm_mullo_epi16( _mm_unpacklo_epi8( v1, zero ), _mm_unpacklo_epi8( v2, zero ) ) );
+        __m128i hi = DivideBy255SSE2( _mm_mullo_epi16( _mm_unpackhi_epi8( v1, zero ), _mm_unpackhi_epi8( v2, zero ) ) );
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), _mm_xor_si128( _mm_packus_epi16( lo, hi ), all ) );
+    }
+
+    return x;
+}
+
+// Overlay blending of 8 values extended to 16 bit
+static __m128i BlendOverlaySSE2( __m128i a, __m128i b )
+{
+    __m128i max  = _mm_set1_epi16( 255 );
+    __m128i mask = _mm_cmplt_epi16( b, _mm_set1_epi16( 128 ) );
+    __m128i dark = DoubleDivideBy255SSE2( _mm_mullo_epi16( a, b ) );
+    __m128i lite = _mm_sub_epi16( max, DoubleDivideBy255SSE2( _mm_mullo_epi16( _mm_sub_epi16( max, a ), _mm_sub_epi16( max, b ) ) ) );
+
+    return _mm_or_si128( _mm_and_si128( mask, dark ), _mm_andnot_si128( mask, lite ) );
+}
+
+// Overlay blending: row1 = ( row2 < 128 ) ? 2 * row1 * row2 / 255 : 255 - 2 * ( 255 - row1 ) * ( 255 - row2 ) / 255
+static int BlendOverlayRowSSE2( uint8_t* row1, const uint8_t* row2, int length )
+{
+    __m128i zero = _mm_setzero_si128( );
+    int     x;
+
+    for ( x = 0; x + 16 <= length; x += 16 )
+    {
+        __m128i v1 = _mm_loadu_si128( (const __m128i*) ( row1 + x ) );
+        __m128i v2 = _mm_loadu_si128( (const __m128i*) ( row2 + x ) );
+        __m128i lo = BlendOverlaySSE2( _mm_unpacklo_epi8( v1, zero ), _mm_unpacklo_epi8( v2, zero ) );
+        __m128i hi = BlendOverlaySSE2( _mm_unpackhi_epi8( v1, zero ), _mm_unpackhi_epi8( v2, zero ) );
+
+        _mm_storeu_si128( (__m128i*) ( row1 + x ), _mm_packus_epi16( lo, hi ) );
+    }
+
+    return x;
+}
+
 // Apply mask to an image by setting its pixels to fill color if corresponding pixels of the mask have 0 value
 // and fillOnZero is set to true. If fillOnZero is set to false, then filling happens if mask has non zero value.
 XErrorCode MaskImage( ximage* image, const ximage* mask, xargb fillColor, bool fillOnZero )
@@ -236,20 +570,27 @@ XErrorCode MergeImages( ximage* image1, const ximage* image2 )
                         ( image1->format == XPixelFormatRGB24 ) ? 3 : 4;
         int lineSize  = pixelSize * image1->width;
         int y;
+        bool useSSE2  = IsSSE2( );
 
         uint8_t* ptr1 = image1->data;
         uint8_t* ptr2 = image2->data;
 
-        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2 )
+        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, useSSE2 )
         for ( y = 0; y < height; y++ )
         {
             uint8_t* row1 = ptr1 + y * stride1;
             uint8_t* row2 = ptr2 + y * stride2;
-            int x;
+            int x = 0;
+
+            // pixels are processed as plain bytes, so all pixel formats are handled in the same way
+            if ( useSSE2 )
+            {
+                x = MergeRowSSE2( row1, row2, lineSize );
+                row1 += x;
+                row2 += x;
+            }
 
-            // for 24/32 bpp image the loop can be unrolled a bit to increase performance.
-            // however it is left like this for now because 8 bpp grayscale images are the main aim.
-            for ( x = 0; x < lineSize; x++ )
+            for ( ; x < lineSize; x++ )
             {
                 if ( *row2 > *row1 )
                 {
@@ -279,20 +620,27 @@ XErrorCode IntersectImages( ximage* image1, const ximage* image2 )
                         ( image1->format == XPixelFormatRGB24 ) ? 3 : 4;
         int lineSize  = pixelSize * image1->width;
         int y;
+        bool useSSE2  = IsSSE2( );
 
         uint8_t* ptr1 = image1->data;
         uint8_t* ptr2 = image2->data;
 
-        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2 )
+        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, useSSE2 )
         for ( y = 0; y < height; y++ )
         {
             uint8_t* row1 = ptr1 + y * stride1;
             uint8_t* row2 = ptr2 + y * stride2;
-            int x;
+            int x = 0;
 
-            // for 24/32 bpp image the loop can be unrolled a bit to increase performance.
-            // however it is left like this for now because 8 bpp grayscale images are the main aim.
-            for ( x = 0; x < lineSize; x++ )
+            // pixels are processed as plain bytes, so all pixel formats are handled in the same way
+            if ( useSSE2 )
+            {
+                x = IntersectRowSSE2( row1, row2, lineSize );
+                row1 += x;
+                row2 += x;
+            }
+
+            for ( ; x < lineSize; x++ )
             {
                 if ( *row2 < *row1 )
                 {
@@ -323,19 +671,26 @@ XErrorCode MoveTowardsImages( ximage* image1, const ximage* image2, uint8_t step
         int lineSize  = pixelSize * image1->width;
         int step      = stepSize;
         int y;
+        bool useSSE2  = IsSSE2( );
 
         uint8_t* ptr1 = image1->data;
         uint8_t* ptr2 = image2->data;
 
-        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, step )
+        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, step, useSSE2 )
         for ( y = 0; y < height; y++ )
         {
             uint8_t* row1 = ptr1 + y * stride1;
             uint8_t* row2 = ptr2 + y * stride2;
-            int      x, diff;
+            int      x = 0, diff;
+
+            if ( useSSE2 )
+            {
+                x = MoveTowardsRowSSE2( row1, row2, lineSize, stepSize );
+                row1 += x;
+                row2 += x;
+            }
 
-            // for 24/32 bpp image the loop can be unrolled a bit to increase performance
-            for ( x = 0; x < lineSize; x++ )
+            for ( ; x < lineSize; x++ )
             {
                 diff = (int) *row2 - *row1;
 
@@ -381,21 +736,28 @@ XErrorCode FadeImages( ximage* image1, const ximage* image2, float factor )
                         ( image1->format == XPixelFormatRGB24 ) ? 3 : 4;
         int lineSize  = pixelSize * image1->width;
         int y;
+        bool useSSE2  = IsSSE2( );
 
         uint8_t* ptr1 = image1->data;
         uint8_t* ptr2 = image2->data;
 
         float    factor2 = 1.0f - factor;
 
-        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, factor, factor2 )
+        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, factor, factor2, useSSE2 )
         for ( y = 0; y < height; y++ )
         {
             uint8_t* row1 = ptr1 + y * stride1;
             uint8_t* row2 = ptr2 + y * stride2;
-            int x;
+            int x = 0;
 
-            // for 24/32 bpp image the loop can be unrolled a bit to increase performance
-            for ( x = 0; x < lineSize; x++ )
+            if ( useSSE2 )
+            {
+                x = FadeRowSSE2( row1, row2, lineSize, factor, factor2 );
+                row1 += x;
+                row2 += x;
+            }
+
+            for ( ; x < lineSize; x++ )
             {
                 *row1 = (uint8_t) ( factor * *row1 + factor2 * *row2 );
 
@@ -424,20 +786,27 @@ XErrorCode AddImages( ximage* image1, const ximage* image2, float factor2 )
                         ( image1->format == XPixelFormatRGB24 ) ? 3 : 4;
         int lineSize  = pixelSize * image1->width;
         int y;
+        bool useSSE2  = IsSSE2( );
 
         uint8_t* ptr1 = image1->data;
         uint8_t* ptr2 = image2->data;
 
-        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, factor2 )
+        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, factor2, useSSE2 )
         for ( y = 0; y < height; y++ )
         {
             uint8_t* row1 = ptr1 + y * stride1;
             uint8_t* row2 = ptr2 + y * stride2;
-            int      x;
+            int      x = 0;
             float    v;
 
-            // for 24/32 bpp image the loop can be unrolled a bit to increase performance
-            for ( x = 0; x < lineSize; x++ )
+            if ( useSSE2 )
+            {
+                x = AddScaledRowSSE2( row1, row2, lineSize, factor2 );
+                row1 += x;
+                row2 += x;
+            }
+
+            for ( ; x < lineSize; x++ )
             {
                 v = factor2 * *row2 + *row1;
 
@@ -475,20 +844,27 @@ XErrorCode SubtractImages( ximage* image1, const ximage* image2, float factor2 )
                         ( image1->format == XPixelFormatRGB24 ) ? 3 : 4;
         int lineSize  = pixelSize * image1->width;
         int y;
+        bool useSSE2  = IsSSE2( );
 
         uint8_t* ptr1 = image1->data;
         uint8_t* ptr2 = image2->data;
 
-        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, factor2 )
+        #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, factor2, useSSE2 )
         for ( y = 0; y < height; y++ )
         {
             uint8_t* row1 = ptr1 + y * stride1;
             uint8_t* row2 = ptr2 + y * stride2;
-            int      x;
+            int      x = 0;
             float    v;
 
-            // for 24/32 bpp image the loop can be unrolled a bit to increase performance
-            for ( x = 0; x < lineSize; x++ )
+            if ( useSSE2 )
+            {
+                x = AddScaledRowSSE2( row1, row2, lineSize, factor2 );
+                row1 += x;
+                row2 += x;
+            }
+
+            for ( ; x < lineSize; x++ )
             {
                 v = factor2 * *row2 + *row1;
 
@@ -528,6 +904,7 @@ XErrorCode DiffImages( ximage* image1, const ximage* image2 )
         int stride1   = image1->stride;
         int stride2   = image2->stride;
         int y;
+        bool useSSE2  = IsSSE2( );
 
         uint8_t* ptr1 = image1->data;
         uint8_t* ptr2 = image2->data;
@@ -535,15 +912,22 @@ XErrorCode DiffImages( ximage* image1, const ximage* image2 )
         if ( image1->format == XPixelFormatGrayscale8 )
         {
             // grayscale version
-            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, width, stride1, stride2 )
+            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, width, stride1, stride2, useSSE2 )
             for ( y = 0; y < height; y++ )
             {
                 uint8_t* row1 = ptr1 + y * stride1;
                 uint8_t* row2 = ptr2 + y * stride2;
-                int      x;
+                int      x = 0;
                 int16_t  diff;
 
-                for ( x = 0; x < width; x++ )
+                if ( useSSE2 )
+                {
+                    x = DiffRowSSE2( row1, row2, width, _mm_setzero_si128( ) );
+                    row1 += x;
+                    row2 += x;
+                }
+
+                for ( ; x < width; x++ )
                 {
                     COMPUTE_VALUE
                 }
@@ -555,15 +939,28 @@ XErrorCode DiffImages( ximage* image1, const ximage* image2 )
 
             int is32bpp = ( image1->format == XPixelFormatRGB24 ) ? 0 : 1;
 
-            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, width, stride1, stride2, is32bpp )
+            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, width, stride1, stride2, is32bpp, useSSE2 )
             for ( y = 0; y < height; y++ )
             {
                 uint8_t* row1 = ptr1 + y * stride1;
                 uint8_t* row2 = ptr2 + y * stride2;
-                int      x;
+                int      x = 0;
                 int16_t  diff;
 
-                for ( x = 0; x < width; x++ )
+                if ( useSSE2 )
+                {
+                    // process only whole pixels, keeping alpha bytes of the first image untouched
+                    __m128i keepMask  = ( is32bpp ) ? _mm_set1_epi32( (int) PackPixel32( 0, 0, 0, 255 ) ) : _mm_setzero_si128( );
+                    int     pixelSize = 3 + is32bpp;
+                    int     blockSize = ( is32bpp ) ? 16 : 48;
+                    int     lineSize  = width * pixelSize;
+
+                    x = DiffRowSSE2( row1, row2, lineSize - lineSize % blockSize, keepMask ) / pixelSize;
+                    row1 += x * pixelSize;
+                    row2 += x * pixelSize;
+                }
+
+                for ( ; x < width; x++ )
                 {
                     // process 3 color channels
                     COMPUTE_VALUE
@@ -594,7 +991,7 @@ XErrorCode DiffImagesThresholded( ximage* image1, const ximage* image2, int16_t
         int height    = image1->height;
         int stride1   = image1->stride;
         int stride2   = image2->stride;
-        int x, y;
+        int y;
 
         uint8_t* ptr1 = image1->data;
         uint8_t* ptr2 = image2->data;
@@ -603,40 +1000,47 @@ XErrorCode DiffImagesThresholded( ximage* image1, const ximage* image2, int16_t
 
         if ( image1->format == XPixelFormatGrayscale8 )
         {
-            int     offset1  = stride1 - width;
-            int     offset2  = stride2 - width;
-            int16_t diff;
             uint8_t hiValue  = (uint8_t) ( RGB_TO_GRAY(  hiColor.components.r,  hiColor.components.g,  hiColor.components.b ) * 255 /  hiColor.components.a );
             uint8_t lowValue = (uint8_t) ( RGB_TO_GRAY( lowColor.components.r, lowColor.components.g, lowColor.components.b ) * 255 / lowColor.components.a );
+            bool    useSSE2  = ( ( IsSSE2( ) ) && ( threshold <= 255 ) );
+            int     th       = XMAX( threshold, 0 );
 
             // grayscale version
-            for ( y = 0; y < height; ++y )
+            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, width, stride1, stride2, threshold, th, hiValue, lowValue, useSSE2 ) reduction(+:counter)
+            for ( y = 0; y < height; y++ )
             {
-                for ( x = 0; x < width; ++x, ++ptr1, ++ptr2 )
+                uint8_t* row1 = ptr1 + y * stride1;
+                uint8_t* row2 = ptr2 + y * stride2;
+                int      x    = 0;
+                int16_t  diff;
+
+                if ( useSSE2 )
                 {
-                    diff = (int16_t) *ptr1 - *ptr2;
+                    x = DiffThresholdedRow8SSE2( row1, row2, width, th, hiValue, lowValue, &counter );
+                    row1 += x;
+                    row2 += x;
+                }
+
+                for ( ; x < width; ++x, ++row1, ++row2 )
+                {
+                    diff = (int16_t) *row1 - *row2;
                     if ( diff < 0 ) diff = -diff;
 
                     if ( diff >= threshold )
                     {
-                        *ptr1 = hiValue;
+                        *row1 = hiValue;
                         ++counter;
                     }
                     else
                     {
-                        *ptr1 = lowValue;
+                        *row1 = lowValue;
                     }
                 }
-
-                ptr1 += offset1;
-                ptr2 += offset2;
             }
         }
         else if ( image1->format == XPixelFormatRGB24 )
         {
             // 24 bpp version
-            int offset1  = stride1 - width * 3;
-            int offset2  = stride2 - width * 3;
             uint8_t hiR  = (uint8_t) (  hiColor.components.r * 255 /  hiColor.components.a );
             uint8_t hiG  = (uint8_t) (  hiColor.components.g * 255 /  hiColor.components.a );
             uint8_t hiB  = (uint8_t) (  hiColor.components.b * 255 /  hiColor.components.a );
@@ -644,15 +1048,19 @@ XErrorCode DiffImagesThresholded( ximage* image1, const ximage* image2, int16_t
             uint8_t lowG = (uint8_t) ( lowColor.components.g * 255 / lowColor.components.a );
             uint8_t lowB = (uint8_t) ( lowColor.components.b * 255 / lowColor.components.a );
 
-            int16_t  diffR, diffG, diffB;
-
-            for ( y = 0; y < height; ++y )
+            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, width, stride1, stride2, threshold, hiR, hiG, hiB, lowR, lowG, lowB ) reduction(+:counter)
+            for ( y = 0; y < height; y++ )
             {
-                for ( x = 0; x < width; ++x, ptr1 += 3, ptr2 += 3 )
+                uint8_t* row1 = ptr1 + y * stride1;
+                uint8_t* row2 = ptr2 + y * stride2;
+                int      x;
+                int16_t  diffR, diffG, diffB;
+
+                for ( x = 0; x < width; ++x, row1 += 3, row2 += 3 )
                 {
-                    diffR = (int16_t) ptr1[RedIndex]   - ptr2[RedIndex];
-                    diffG = (int16_t) ptr1[GreenIndex] - ptr2[GreenIndex];
-                    diffB = (int16_t) ptr1[BlueIndex]  - ptr2[BlueIndex];
+                    diffR = (int16_t) row1[RedIndex]   - row2[RedIndex];
+                    diffG = (int16_t) row1[GreenIndex] - row2[GreenIndex];
+                    diffB = (int16_t) row1[BlueIndex]  - row2[BlueIndex];
 
                     if ( diffR < 0 ) diffR = -diffR;
                     if ( diffG < 0 ) diffG = -diffG;
@@ -660,38 +1068,47 @@ XErrorCode DiffImagesThresholded( ximage* image1, const ximage* image2, int16_t
 
                     if ( diffR + diffG + diffB >= threshold )
                     {
-                        ptr1[RedIndex]   = hiR;
-                        ptr1[GreenIndex] = hiG;
-                        ptr1[BlueIndex]  = hiB;
+                        row1[RedIndex]   = hiR;
+                        row1[GreenIndex] = hiG;
+                        row1[BlueIndex]  = hiB;
                         ++counter;
                     }
                     else
                     {
-                        ptr1[RedIndex]   = lowR;
-                        ptr1[GreenIndex] = lowG;
-                        ptr1[BlueIndex]  = lowB;
+                        row1[RedIndex]   = lowR;
+                        row1[GreenIndex] = lowG;
+                        row1[BlueIndex]  = lowB;
                     }
                 }
-
-                ptr1 += offset1;
-                ptr2 += offset2;
             }
         }
         else
         {
             // 32 bpp version (Alpha channel is ignored, only set to specified value)
-            int offset1  = stride1 - width * 4;
-            int offset2  = stride2 - width * 4;
-
-            int16_t  diffR, diffG, diffB;
+            uint32_t hiPixel  = PackPixel32(  hiColor.components.r,  hiColor.components.g,  hiColor.components.b,  hiColor.components.a );
+            uint32_t lowPixel = PackPixel32( lowColor.components.r, lowColor.components.g, lowColor.components.b, lowColor.components.a );
+            bool     useSSE2  = IsSSE2( );
 
-            for ( y = 0; y < height; ++y )
+            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, width, stride1, stride2, threshold, hiColor, lowColor, hiPixel, lowPixel, useSSE2 ) reduction(+:counter)
+            for ( y = 0; y < height; y++ )
             {
-                for ( x = 0; x < width; ++x, ptr1 += 4, ptr2 += 4 )
+                uint8_t* row1 = ptr1 + y * stride1;
+                uint8_t* row2 = ptr2 + y * stride2;
+                int      x    = 0;
+                int16_t  diffR, diffG, diffB;
+
+                if ( useSSE2 )
+                {
+                    x = DiffThresholdedRow32SSE2( row1, row2, width, threshold, hiPixel, lowPixel, &counter );
+                    row1 += x * 4;
+                    row2 += x * 4;
+                }
+
+                for ( ; x < width; ++x, row1 += 4, row2 += 4 )
                 {
-                    diffR = (int16_t) ptr1[RedIndex]   - ptr2[RedIndex];
-                    diffG = (int16_t) ptr1[GreenIndex] - ptr2[GreenIndex];
-                    diffB = (int16_t) ptr1[BlueIndex]  - ptr2[BlueIndex];
+                    diffR = (int16_t) row1[RedIndex]   - row2[RedIndex];
+                    diffG = (int16_t) row1[GreenIndex] - row2[GreenIndex];
+                    diffB = (int16_t) row1[BlueIndex]  - row2[BlueIndex];
 
                     if ( diffR < 0 ) diffR = -diffR;
                     if ( diffG < 0 ) diffG = -diffG;
@@ -699,23 +1116,20 @@ XErrorCode DiffImagesThresholded( ximage* image1, const ximage* image2, int16_t
 
                     if ( diffR + diffG + diffB >= threshold )
                     {
-                        ptr1[RedIndex]   = hiColor.components.r;
-                        ptr1[GreenIndex] = hiColor.components.g;
-                        ptr1[BlueIndex]  = hiColor.components.b;
-                        ptr1[AlphaIndex] = hiColor.components.a;
+                        row1[RedIndex]   = hiColor.components.r;
+                        row1[GreenIndex] = hiColor.components.g;
+                        row1[BlueIndex]  = hiColor.components.b;
+                        row1[AlphaIndex] = hiColor.components.a;
                         ++counter;
                     }
                     else
                     {
-                        ptr1[RedIndex]   = lowColor.components.r;
-                        ptr1[GreenIndex] = lowColor.components.g;
-                        ptr1[BlueIndex]  = lowColor.components.b;
-                        ptr1[AlphaIndex] = lowColor.components.a;
+                        row1[RedIndex]   = lowColor.components.r;
+                        row1[GreenIndex] = lowColor.components.g;
+                        row1[BlueIndex]  = lowColor.components.b;
+                        row1[AlphaIndex] = lowColor.components.a;
                     }
                 }
-
-                ptr1 += offset1;
-                ptr2 += offset2;
             }
         }
 
@@ -742,6 +1156,7 @@ XErrorCode BlendImages( ximage* image1, const ximage* image2, XBlendMode blendMo
                         ( image1->format == XPixelFormatRGB24 ) ? 3 : 4;
         int lineSize  = pixelSize * image1->width;
         int y;
+        bool useSSE2  = IsSSE2( );
 
         uint8_t* ptr1 = image1->data;
         uint8_t* ptr2 = image2->data;
@@ -758,15 +1173,21 @@ XErrorCode BlendImages( ximage* image1, const ximage* image2, XBlendMode blendMo
                 f(a, b) = a * b / 255       , a,b in [0, 255]
             */
 
-            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2 )
+            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, useSSE2 )
             for ( y = 0; y < height; y++ )
             {
                 uint8_t* row1 = ptr1 + y * stride1;
                 uint8_t* row2 = ptr2 + y * stride2;
-                int x;
+                int x = 0;
 
-                // for 24/32 bpp image the loop can be unrolled a bit to increase performance
-                for ( x = 0; x < lineSize; x++ )
+                if ( useSSE2 )
+                {
+                    x = BlendMultiplyRowSSE2( row1, row2, lineSize );
+                    row1 += x;
+                    row2 += x;
+                }
+
+                for ( ; x < lineSize; x++ )
                 {
                     *row1 = (uint8_t) ( ( *row1 * *row2 ) / 255 );
 
@@ -782,15 +1203,21 @@ XErrorCode BlendImages( ximage* image1, const ximage* image2, XBlendMode blendMo
                 f(a, b) = 255 - ( 255 - a ) * ( 255 - b ) / 255     , a,b in [0, 255]
             */
 
-            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2 )
+            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, useSSE2 )
             for ( y = 0; y < height; y++ )
             {
                 uint8_t* row1 = ptr1 + y * stride1;
                 uint8_t* row2 = ptr2 + y * stride2;
-                int x;
+                int x = 0;
 
-                // for 24/32 bpp image the loop can be unrolled a bit to increase performance
-                for ( x = 0; x < lineSize; x++ )
+                if ( useSSE2 )
+                {
+                    x = BlendScreenRowSSE2( row1, row2, lineSize );
+                    row1 += x;
+                    row2 += x;
+                }
+
+                for ( ; x < lineSize; x++ )
                 {
                     *row1 = (uint8_t) ( 255 - ( 255 - *row1 ) * ( 255 - *row2 ) / 255 );
 
@@ -810,15 +1237,21 @@ XErrorCode BlendImages( ximage* image1, const ximage* image2, XBlendMode blendMo
                           | 255 - 2 * ( 255 - a ) * ( 255 - b ) / 255  , otherwise
             */
 
-            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2 )
+            #pragma omp parallel for schedule(static) shared( ptr1, ptr2, lineSize, stride1, stride2, useSSE2 )
             for ( y = 0; y < height; y++ )
             {
                 uint8_t* row1 = ptr1 + y * stride1;
                 uint8_t* row2 = ptr2 + y * stride2;
-                int x;
+                int x = 0;
 
-                // for 24/32 bpp image the loop can be unrolled a bit to increase performance
-                for ( x = 0; x < lineSize; x++ )
+                if ( useSSE2 )
+                {
+                    x = BlendOverlayRowSSE2( row1, row2, lineSize );
+                    row1 += x;
+                    row2 += x;
+                }
+
+                for ( ; x < lineSize; x++ )
                 {
                     if ( *row2 < 128 )
                     {
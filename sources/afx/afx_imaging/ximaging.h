@@ -354,6 +354,7 @@ XErrorCode BinaryOrderedDithering4( const ximage* src, ximage* dst );
 XErrorCode BinaryOrderedDithering8( const ximage* src, ximage* dst );
 
 // Perform error diffusion dithering of the specified 8 bpp grayscale image putting result into the specified 1 bpp binary image
+// (rows are dithered concurrently as a wavefront; the temporary image is not used any more and can be NULL)
 XErrorCode BinaryErrorDiffusionDithering( const ximage* src, ximage* dst, ximage* tmp,
                                           int32_t diffusionLinesCount, const int32_t* diffusionLinesLength,
                                           const uint8_t** diffusionLinesCoefficients );
@@ -376,6 +377,9 @@ XErrorCode Mean3x3( const ximage* src, ximage* dst );
 // for averaging - those, which color is withing the specified distance from the color of the
 // window's ceter pixel.
 XErrorCode MeanShift( const ximage* src, ximage* dst, uint16_t radius, uint16_t colorDistance );
+// Edge preserving smoothing (bilateral filter) done with downsampled bilateral grid, so its cost does not depend much
+// on the spatial sigma value. Can be done in place (source and destination may be the same image).
+XErrorCode BilateralFilter( const ximage* src, ximage* dst, float spatialSigma, float colorSigma );
 // Blur image using 5x5 kernel
 XErrorCode BlurImage( const ximage* src, ximage* dst );
 // Perform Gaussian blur with the specified sigma value and blurring radius
@@ -613,6 +617,33 @@ XErrorCode Rgb2Hsv( const xargb* rgb, xhsv* hsv );
 // Convert HSV color to RGB
 XErrorCode Hsv2Rgb( const xhsv* hsv, xargb* rgb );
 
+// ===== Bulk color space conversion =====
+// Color image is converted to/from 3 planes of the same size, which are either all 8 bpp grayscale or all
+// GrayscaleR4 images. Float planes keep natural ranges of the channels: hue is in [0, 360) and saturation/luminance/value
+// are in [0, 1] for HSL/HSV; Y, Cb and Cr are in [0, 255] (full range JPEG conversion); L is in [0, 100], while
+// a and b are roughly in [-128, 127] for Lab (sRGB, D65). 8 bpp planes keep hue divided by 2, saturation/luminance/value
+// multiplied by 255, YCbCr as is, L multiplied by 2.55, a and b shifted by 128.
+
+// Convert RGB image into HSL planes
+XErrorCode ColorImageToHslPlanes( const ximage* src, ximage* hue, ximage* saturation, ximage* luminance );
+// Convert HSL planes into RGB image
+XErrorCode HslPlanesToColorImage( const ximage* hue, const ximage* saturation, const ximage* luminance, ximage* dst );
+
+// Convert RGB image into HSV planes
+XErrorCode ColorImageToHsvPlanes( const ximage* src, ximage* hue, ximage* saturation, ximage* value );
+// Convert HSV planes into RGB image
+XErrorCode HsvPlanesToColorImage( const ximage* hue, const ximage* saturation, const ximage* value, ximage* dst );
+
+// Convert RGB image into YCbCr planes
+XErrorCode ColorImageToYCbCrPlanes( const ximage* src, ximage* y, ximage* cb, ximage* cr );
+// Convert YCbCr planes into RGB image
+XErrorCode YCbCrPlanesToColorImage( const ximage* y, const ximage* cb, const ximage* cr, ximage* dst );
+
+// Convert RGB image into Lab planes
+XErrorCode ColorImageToLabPlanes( const ximage* src, ximage* l, ximage* a, ximage* b );
+// Convert Lab planes into RGB image
+XErrorCode LabPlanesToColorImage( const ximage* l, const ximage* a, const ximage* b, ximage* dst );
+
 
 #ifdef __cplusplus
 }
@@ -21,7 +21,10 @@
 
 #include "ximaging.h"
 
-// Set hue and saturation of all pixels to the specified values
+// Set hue and saturation of all pixels to the specified values.
+//
+// With hue and saturation fixed, the result depends only on the value component of a pixel (maximum of its RGB
+// components). So the RGB->HSV->RGB conversion is done once for all 256 values and then used as a lookup table.
 XErrorCode ColorizeImage( ximage* src, uint16_t hue, float saturation )
 {
     XErrorCode ret = SuccessCode;
@@ -42,32 +45,34 @@ XErrorCode ColorizeImage( ximage* src, uint16_t hue, float saturation )
         int height    = src->height;
         int stride    = src->stride;
         int pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
-        int y;
+        int y, i;
+
+        xargb lut[256];
+        xhsv  hsv;
 
         // make sure passed values are in the correct range
         hue = hue % 360;
         saturation = XINRANGE( saturation, 0.0f, 1.0f );
 
-        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, hue, saturation )
+        hsv.Hue        = hue;
+        hsv.Saturation = saturation;
+
+        for ( i = 0; i < 256; i++ )
+        {
+            hsv.Value = i / 255.0f;
+            Hsv2Rgb( &hsv, &lut[i] );
+        }
+
+        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, lut )
         for ( y = 0; y < height; y++ )
         {
             uint8_t* row = ptr + y * stride;
             int      x;
             xargb    rgb;
-            xhsv     hsv;
 
             for ( x = 0; x < width; x++, row += pixelSize )
             {
-                rgb.components.r = row[RedIndex];
-                rgb.components.g = row[GreenIndex];
-                rgb.components.b = row[BlueIndex];
-
-                Rgb2Hsv( &rgb, &hsv );
-
-                hsv.Hue        = hue;
-                hsv.Saturation = saturation;
-
-                Hsv2Rgb( &hsv, &rgb );
+                rgb = lut[XMAX3( row[RedIndex], row[GreenIndex], row[BlueIndex] )];
 
                 row[RedIndex]   = rgb.components.r;
                 row[GreenIndex] = rgb.components.g;
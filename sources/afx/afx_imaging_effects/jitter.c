@@ -19,16 +19,22 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
 */
 
-#include <time.h>
 #include "ximaging.h"
+#include "xrandom.h"
+
+// Number of pixels to generate random numbers for at once
+#define RANDOM_BLOCK_SIZE (64)
 
 // forward declaration ----
-static void ImageJitter8( ximage* src, uint8_t radius );
-static void ImageJitter24( ximage* src, uint8_t radius );
+static void ImageJitterRows( const ximage* src, ximage* dst, uint32_t seed, uint8_t radius );
 // ------------------------
 
 // Perform jittering on the image
-XErrorCode ImageJitter( ximage* src, uint8_t radius )
+//
+// Every pixel is replaced with a random pixel from its neighbourhood of the original image. Random numbers
+// come from the counter based generator keyed by the seed and pixel's coordinates, so rows are processed in
+// parallel, while the result does not depend on number of threads.
+XErrorCode ImageJitter( ximage* src, uint32_t seed, uint8_t radius )
 {
     XErrorCode ret = SuccessCode;
 
@@ -36,95 +42,74 @@ XErrorCode ImageJitter( ximage* src, uint8_t radius )
     {
         ret = ErrorNullParameter;
     }
-    else if ( src->format == XPixelFormatGrayscale8 )
-    {
-        ImageJitter8( src, radius );
-    }
-    else if ( ( src->format == XPixelFormatRGB24 ) || ( src->format == XPixelFormatRGBA32 ) )
+    else if ( ( src->format != XPixelFormatGrayscale8 ) &&
+              ( src->format != XPixelFormatRGB24 ) &&
+              ( src->format != XPixelFormatRGBA32 ) )
     {
-        ImageJitter24( src, radius );
+        ret = ErrorUnsupportedPixelFormat;
     }
     else
     {
-        ret = ErrorUnsupportedPixelFormat;
-    }
+        ximage* original = 0;
 
-    return ret;
-}
-
-// Performs jittering on 8 bpp grayscale images
-void ImageJitter8( ximage* src, uint8_t radius )
-{
-    int width  = src->width;
-    int height = src->height;
-    int stride = src->stride;
-    int x, y;
-    int sx, sy;
-    uint8_t* ptr = src->data;
-    uint8_t* p;
+        // keep copy of the original image, so neighbours are taken from it and not from already updated rows
+        ret = XImageClone( src, &original );
 
-    // maximum value for random number generator
-    int maxRand = (int) radius * 2 + 1;
-
-    for ( y = 0; y < height; y++ )
-    {
-        uint8_t* row = ptr + y * stride;
-
-        for ( x = 0; x < width; x++ )
+        if ( ret == SuccessCode )
         {
-            sx = x + ( rand( ) % maxRand ) - radius;
-            sy = y + ( rand( ) % maxRand ) - radius;
-
-            if ( ( sx >= 0 ) && ( sy >= 0 ) && ( sx < width ) && ( sy < height ) )
-            {
-                p = ptr + sy * stride + sx;
-                *row = *p;
-            }
-
-            row++;
+            ImageJitterRows( original, src, seed, radius );
+            XImageFree( &original );
         }
     }
+
+    return ret;
 }
 
-// Performs jittering on 24/32 bpp color images
-void ImageJitter24( ximage* src, uint8_t radius )
+// Performs jittering on 8/24/32 bpp images
+void ImageJitterRows( const ximage* src, ximage* dst, uint32_t seed, uint8_t radius )
 {
-    int width  = src->width;
-    int height = src->height;
-    int stride = src->stride;
-    int pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
-    int x, y, i;
-    int sx, sy;
-    uint8_t* ptr = src->data;
-    uint8_t* p;
+    int width     = src->width;
+    int height    = src->height;
+    int srcStride = src->stride;
+    int dstStride = dst->stride;
+    int pixelSize = ( src->format == XPixelFormatGrayscale8 ) ? 1 : ( ( src->format == XPixelFormatRGB24 ) ? 3 : 4 );
+    int y;
+    const uint8_t* srcPtr = src->data;
+    uint8_t*       dstPtr = dst->data;
 
     // maximum value for random number generator
-    int maxRand = (int) radius * 2 + 1;
+    uint32_t maxRand = (uint32_t) radius * 2 + 1;
 
+    #pragma omp parallel for schedule(static) shared( srcPtr, dstPtr, width, height, srcStride, dstStride, pixelSize, seed, radius, maxRand )
     for ( y = 0; y < height; y++ )
     {
-        uint8_t* row = ptr + y * stride;
+        uint8_t*       row = dstPtr + y * dstStride;
+        const uint8_t* p;
+        uint32_t       randoms[RANDOM_BLOCK_SIZE * 4];
+        uint32_t*      rnd;
+        int            x, i, sx, sy, blockStart, blockSize;
 
-        for ( x = 0; x < width; x++ )
+        for ( blockStart = 0; blockStart < width; blockStart += RANDOM_BLOCK_SIZE )
         {
-            sx = x + ( rand( ) % maxRand ) - radius;
-            sy = y + ( rand( ) % maxRand ) - radius;
+            blockSize = XMIN( RANDOM_BLOCK_SIZE, width - blockStart );
+
+            XRandom4Batch( seed, 0, (uint32_t) y, (uint32_t) blockStart, (uint32_t) blockSize, randoms );
 
-            if ( ( sx >= 0 ) && ( sy >= 0 ) && ( sx < width ) && ( sy < height ) )
+            for ( x = blockStart, rnd = randoms; x < blockStart + blockSize; x++, rnd += 4, row += pixelSize )
             {
-                p = ptr + sy * stride + sx * pixelSize;
+                sx = x + (int) XRANDOM_RANGE( rnd[0], maxRand ) - radius;
+                sy = y + (int) XRANDOM_RANGE( rnd[1], maxRand ) - radius;
 
-                for ( i = 0; i < pixelSize; i++ )
+                if ( ( sx >= 0 ) && ( sy >= 0 ) && ( sx < width ) && ( sy < height ) )
                 {
-                    *row = *p;
-                    row++;
-                    p++;
+                    p = srcPtr + sy * srcStride + sx * pixelSize;
+
+                    for ( i = 0; i < pixelSize; i++ )
+                    {
+                        row[i] = p[i];
+                    }
                 }
             }
-            else
-            {
-                row += pixelSize;
-            }
         }
     }
 }
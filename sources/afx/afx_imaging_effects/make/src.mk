@@ -13,7 +13,7 @@ SRC = colorize.c \
 	perlin_noise_textures.c \
     rotate_hue.c \
 	saturation.c vignetting.c \
-	textures.c
+	texture_cache.c textures.c
 
 # additional include folders
 INCLUDES = -I../../../afx_types -I../../../afx_imaging
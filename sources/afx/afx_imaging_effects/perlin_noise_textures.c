@@ -25,6 +25,21 @@
 #include <time.h>
 #include "xtextures.h"
 #include "ximaging.h"
+#include "xcpuid.h"
+#include "xonce.h"
+
+// SSE intrinsics
+#ifdef _MSC_VER
+    #include <intrin.h>
+#elif __GNUC__
+    #include <x86intrin.h>
+#endif
+
+// Maximum number of octaves supported by the line based noise generator
+#define MAX_OCTAVES (8)
+
+// Size of the look-up table used for cosine interpolation
+#define COSINE_LUT_SIZE (1024)
 
 // ======= Local types =======
 // ===========================
@@ -55,6 +70,24 @@ typedef struct perlinNoiseSettingsTag
 }
 PerlinNoiseSettings;
 
+// Pre-calculated interpolation data for the axis, along which lines of 2D Perlin noise are generated.
+// All lines of a texture share the same set of coordinates along the axis, so lattice cells and
+// interpolation weights of every sample are calculated only once per texture.
+typedef struct perlinNoiseAxisTag
+{
+    int     count;                      // number of samples along the axis
+    int     octaves;                    // number of octaves
+    double  frequency[MAX_OCTAVES];     // frequency of each octave
+    float   amplitude[MAX_OCTAVES];     // amplitude of each octave
+    int     cellStart[MAX_OCTAVES];     // first lattice cell used by each octave
+    int     cellCount[MAX_OCTAVES];     // number of lattice values required by each octave
+    bool    useLattice[MAX_OCTAVES];    // pre-interpolate lattice values or not (not worth it for high frequencies)
+    int     maxCellCount;               // maximum number of lattice values of those octaves, which use them
+    int*    cellIndex;                  // [octaves][count] lattice cell of each sample, relative to cellStart
+    float*  cellWeight;                 // [octaves][count] cosine interpolation weight of each sample
+}
+PerlinNoiseAxis;
+
 // ======= Local functions =======
 // ===============================
 
@@ -72,6 +105,32 @@ static void GetDefaultPerlinNoiseSettings( PerlinNoiseSettings* settings )
 }
 */
 
+// Look-up table of cosine interpolation weights - ( 1 - cos( a * PI ) ) / 2, for a in [0, 1]
+// (two extra entries are kept to allow interpolation between table's values for a == 1)
+static float CosineLut[COSINE_LUT_SIZE + 2];
+static xonce CosineLutOnce = XONCE_INIT;
+
+// Fill the cosine interpolation look-up table
+static void FillCosineLut( void )
+{
+    int i;
+
+    for ( i = 0; i < COSINE_LUT_SIZE + 2; i++ )
+    {
+        CosineLut[i] = (float) ( ( 1.0 - cos( (double) i / COSINE_LUT_SIZE * XPI ) ) * 0.5 );
+    }
+}
+
+// Get cosine interpolation weight for the [0, 1] fraction using look-up table
+static float CosineWeight( float a )
+{
+    float pos  = a * COSINE_LUT_SIZE;
+    int   i    = (int) pos;
+    float frac = pos - i;
+
+    return CosineLut[i] + ( CosineLut[i + 1] - CosineLut[i] ) * frac;
+}
+
 // Cosine interpolation function
 static double CosineInterpolate( double x1, double x2, double a )
 {
@@ -86,12 +145,12 @@ static double Noise1D( int x )
 
     return ( 1.0 - ( ( n * ( n * n * 15731 + 789221 ) + 1376312589 ) & 0x7fffffff ) / 1073741824.0 );
 }
-static double Noise2D( int x, int y )
+static float Noise2Df( int x, int y )
 {
     int n = x + y * 57;
     n = ( n << 13 ) ^ n;
 
-    return ( 1.0 - ( ( n * ( n * n * 15731 + 789221 ) + 1376312589 ) & 0x7fffffff ) / 1073741824.0 );
+    return ( 1.0f - ( ( n * ( n * n * 15731 + 789221 ) + 1376312589 ) & 0x7fffffff ) / 1073741824.0f );
 }
 
 // Smoothed noise generation functions
@@ -102,25 +161,6 @@ static double SmoothedNoise1D( double x )
 
     return CosineInterpolate( Noise1D( xInt ), Noise1D( xInt + 1 ), xFrac );
 }
-static double SmoothedNoise2D( double x, double y )
-{
-    int     xInt = (int) x;
-    int     yInt = (int) y;
-    double  xFrac = x - xInt;
-    double  yFrac = y - yInt;
-
-    // get four noise values
-    double  x0y0 = Noise2D( xInt,     yInt );
-    double  x1y0 = Noise2D( xInt + 1, yInt );
-    double  x0y1 = Noise2D( xInt,     yInt + 1 );
-    double  x1y1 = Noise2D( xInt + 1, yInt + 1 );
-
-    // x interpolation
-    double  v1 = CosineInterpolate( x0y0, x1y0, xFrac );
-    double  v2 = CosineInterpolate( x0y1, x1y1, xFrac );
-    // y interpolation
-    return CosineInterpolate( v1, v2, yFrac );
-}
 
 // 1D Perlin noise function
 static double PerlinNoise1D( const PerlinNoiseSettings* settings, double x )
@@ -145,27 +185,347 @@ static double PerlinNoise1D( const PerlinNoiseSettings* settings, double x )
     return sum;
 }
 
-// 2D Perlin noise function
-static double PerlinNoise2D( const PerlinNoiseSettings* settings, double x, double y )
+// Prepare axis data for generating lines of 2D Perlin noise. Coordinates of the samples along the
+// axis are calculated as "scale * ( i + offset )", where i = [0, count).
+static XErrorCode PerlinNoiseAxisInit( PerlinNoiseAxis* axis, const PerlinNoiseSettings* settings, int count, double scale, double offset )
 {
-    double  sum = 0;
+    XErrorCode ret = SuccessCode;
+    double     frequency = settings->initFrequency;
+    double     amplitude = settings->initAmplitude;
+    int        octave, i;
 
-    if ( settings != 0 )
-    {
-        double  frequency = settings->initFrequency;
-        double  amplitude = settings->initAmplitude;
-        int     i;
+    // textures may be generated by several threads, so the table is filled only once
+    XCallOnce( &CosineLutOnce, FillCosineLut );
 
-        // octaves
-        for ( i = 0; i < settings->octaves; i++ )
+    axis->count        = count;
+    axis->octaves      = XMIN( settings->octaves, MAX_OCTAVES );
+    axis->maxCellCount = 1;
+    axis->cellIndex    = (int*) malloc( sizeof( int ) * axis->octaves * count );
+    axis->cellWeight   = (float*) malloc( sizeof( float ) * axis->octaves * count );
+
+    if ( ( axis->cellIndex == 0 ) || ( axis->cellWeight == 0 ) )
+    {
+        free( axis->cellIndex );
+        free( axis->cellWeight );
+        axis->cellIndex  = 0;
+        axis->cellWeight = 0;
+        ret = ErrorOutOfMemory;
+    }
+    else
+    {
+        for ( octave = 0; octave < axis->octaves; octave++ )
         {
-            sum += SmoothedNoise2D( x * frequency, y * frequency ) * amplitude;
+            int*   cellIndex  = axis->cellIndex  + octave * count;
+            float* cellWeight = axis->cellWeight + octave * count;
+            int    cellStart  = (int) ( scale * offset * frequency );
+            int    cellEnd    = (int) ( scale * ( count - 1 + offset ) * frequency );
+
+            for ( i = 0; i < count; i++ )
+            {
+                double v    = scale * ( i + offset ) * frequency;
+                int    vInt = (int) v;
+
+                cellIndex[i]  = vInt - cellStart;
+                cellWeight[i] = CosineWeight( (float) ( v - vInt ) );
+            }
+
+            axis->frequency[octave] = frequency;
+            axis->amplitude[octave] = (float) amplitude;
+            axis->cellStart[octave] = cellStart;
+            axis->cellCount[octave] = cellEnd - cellStart + 2;
+
+            // when there are more lattice cells than samples, it is cheaper to interpolate noise for each sample directly
+            axis->useLattice[octave] = ( axis->cellCount[octave] <= count );
+
+            if ( axis->useLattice[octave] )
+            {
+                axis->maxCellCount = XMAX( axis->maxCellCount, axis->cellCount[octave] );
+            }
 
             frequency *= 2;
             amplitude *= settings->persistence;
         }
     }
-    return sum;
+
+    return ret;
+}
+
+// Release memory allocated for axis data
+static void PerlinNoiseAxisFree( PerlinNoiseAxis* axis )
+{
+    free( axis->cellIndex );
+    free( axis->cellWeight );
+    axis->cellIndex  = 0;
+    axis->cellWeight = 0;
+}
+
+// Add one octave of noise to the line by interpolating between the lattice values
+static void AccumulateOctave( float* line, const float* lattice, const int* cellIndex, const float* cellWeight, int count, float amplitude, bool useSSE )
+{
+    int i = 0;
+
+    if ( useSSE )
+    {
+        __m128 amp = _mm_set1_ps( amplitude );
+        __m128 v0, v1, weight;
+
+        for ( ; i + 4 <= count; i += 4 )
+        {
+            v0 = _mm_set_ps( lattice[cellIndex[i + 3]],     lattice[cellIndex[i + 2]],
+                             lattice[cellIndex[i + 1]],     lattice[cellIndex[i]] );
+            v1 = _mm_set_ps( lattice[cellIndex[i + 3] + 1], lattice[cellIndex[i + 2] + 1],
+                             lattice[cellIndex[i + 1] + 1], lattice[cellIndex[i] + 1] );
+            weight = _mm_loadu_ps( cellWeight + i );
+
+            // v0 + ( v1 - v0 ) * weight
+            v0 = _mm_add_ps( v0, _mm_mul_ps( _mm_sub_ps( v1, v0 ), weight ) );
+
+            _mm_storeu_ps( line + i, _mm_add_ps( _mm_loadu_ps( line + i ), _mm_mul_ps( v0, amp ) ) );
+        }
+    }
+
+    for ( ; i < count; i++ )
+    {
+        float v0 = lattice[cellIndex[i]];
+        float v1 = lattice[cellIndex[i] + 1];
+
+        line[i] += ( v0 + ( v1 - v0 ) * cellWeight[i] ) * amplitude;
+    }
+}
+
+// Generate line of 2D Perlin noise for all samples of the axis, while the other coordinate is fixed.
+// For horizontal lines axis samples are used as X coordinates, for vertical lines - as Y coordinates.
+// The lattice buffer must have space for axis->maxCellCount values.
+static void PerlinNoiseLine( const PerlinNoiseAxis* axis, bool isHorizontal, double fixedCoordinate, float* lattice, float* line, bool useSSE )
+{
+    int octave, i;
+
+    memset( line, 0, sizeof( float ) * axis->count );
+
+    for ( octave = 0; octave < axis->octaves; octave++ )
+    {
+        double v         = fixedCoordinate * axis->frequency[octave];
+        int    vInt      = (int) v;
+        float  weight    = CosineWeight( (float) ( v - vInt ) );
+        int    cellStart = axis->cellStart[octave];
+        int    cellCount = axis->cellCount[octave];
+        float  v0, v1;
+
+        const int*   cellIndex  = axis->cellIndex  + octave * axis->count;
+        const float* cellWeight = axis->cellWeight + octave * axis->count;
+
+        if ( axis->useLattice[octave] )
+        {
+            // interpolate lattice values along the fixed coordinate - this leaves 1D interpolation per sample
+            for ( i = 0; i < cellCount; i++ )
+            {
+                if ( isHorizontal )
+                {
+                    v0 = Noise2Df( cellStart + i, vInt );
+                    v1 = Noise2Df( cellStart + i, vInt + 1 );
+                }
+                else
+                {
+                    v0 = Noise2Df( vInt,     cellStart + i );
+                    v1 = Noise2Df( vInt + 1, cellStart + i );
+                }
+
+                lattice[i] = v0 + ( v1 - v0 ) * weight;
+            }
+
+            AccumulateOctave( line, lattice, cellIndex, cellWeight, axis->count, axis->amplitude[octave], useSSE );
+        }
+        else
+        {
+            float amplitude = axis->amplitude[octave];
+
+            for ( i = 0; i < axis->count; i++ )
+            {
+                int   cell = cellStart + cellIndex[i];
+                float c0, c1;
+
+                if ( isHorizontal )
+                {
+                    c0 = Noise2Df( cell,     vInt );
+                    c1 = Noise2Df( cell + 1, vInt );
+                    v0 = Noise2Df( cell,     vInt + 1 );
+                    v1 = Noise2Df( cell + 1, vInt + 1 );
+                }
+                else
+                {
+                    c0 = Noise2Df( vInt,     cell );
+                    c1 = Noise2Df( vInt,     cell + 1 );
+                    v0 = Noise2Df( vInt + 1, cell );
+                    v1 = Noise2Df( vInt + 1, cell + 1 );
+                }
+
+                c0 += ( v0 - c0 ) * weight;
+                c1 += ( v1 - c1 ) * weight;
+
+                line[i] += ( c0 + ( c1 - c0 ) * cellWeight[i] ) * amplitude;
+            }
+        }
+    }
+}
+
+// Convert line of noise values to 8 bpp values: ( noise * factor + offset ) clamped to [0, 255]
+static void NoiseLineToBytes( const float* line, uint8_t* row, int count, float factor, float offset, bool useSSE )
+{
+    int i = 0;
+
+    if ( useSSE )
+    {
+        __m128  f = _mm_set1_ps( factor );
+        __m128  o = _mm_set1_ps( offset );
+        __m128i lo, hi;
+
+        for ( ; i + 8 <= count; i += 8 )
+        {
+            lo = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( line + i ),     f ), o ) );
+            hi = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( line + i + 4 ), f ), o ) );
+
+            // saturating packing does clamping to [0, 255]
+            lo = _mm_packs_epi32( lo, hi );
+            lo = _mm_packus_epi16( lo, lo );
+
+            _mm_storel_epi64( (__m128i*) ( row + i ), lo );
+        }
+    }
+
+    for ( ; i < count; i++ )
+    {
+        float value = line[i] * factor + offset;
+
+        value  = XINRANGE( value, 0.0f, 255.0f );
+        row[i] = (uint8_t) value;
+    }
+}
+
+// Handler, which converts line of noise values into a row of texture
+typedef void ( *NoiseRowHandler )( const float* line, uint8_t* row, int y, int width, const void* userData, bool useSSE );
+
+// Generate 2D Perlin noise for every row of the 8 bpp texture and let the handler to convert it into pixel values.
+// Noise coordinates of a pixel are "scale * ( x + offset )" and "scale * ( y + offset )".
+static XErrorCode GeneratePerlinNoiseRows( ximage* texture, const PerlinNoiseSettings* settings, double scale, double offset,
+                                           NoiseRowHandler handler, const void* userData )
+{
+    int      width  = texture->width;
+    int      height = texture->height;
+    int      stride = texture->stride;
+    uint8_t* ptr    = texture->data;
+    bool     useSSE = IsSSE2( );
+    bool     outOfMemory = false;
+
+    PerlinNoiseAxis axis;
+    XErrorCode      ret = PerlinNoiseAxisInit( &axis, settings, width, scale, offset );
+
+    if ( ret == SuccessCode )
+    {
+        #pragma omp parallel shared( ptr, width, height, stride, axis, scale, offset, handler, userData, useSSE, outOfMemory )
+        {
+            // per thread buffers
+            float* lattice = (float*) malloc( sizeof( float ) * axis.maxCellCount );
+            float* line    = (float*) malloc( sizeof( float ) * width );
+            int    y;
+
+            #pragma omp for schedule(static)
+            for ( y = 0; y < height; y++ )
+            {
+                if ( ( lattice != 0 ) && ( line != 0 ) )
+                {
+                    PerlinNoiseLine( &axis, true, scale * ( y + offset ), lattice, line, useSSE );
+                    handler( line, ptr + y * stride, y, width, userData, useSSE );
+                }
+                else
+                {
+                    outOfMemory = true;
+                }
+            }
+
+            free( lattice );
+            free( line );
+        }
+
+        PerlinNoiseAxisFree( &axis );
+
+        if ( outOfMemory )
+        {
+            ret = ErrorOutOfMemory;
+        }
+    }
+
+    return ret;
+}
+
+// Parameters of textile texture's rows handler
+typedef struct
+{
+    double factor;
+    int    stitchOffset;
+}
+TextileRowParams;
+
+// Convert noise to textile texture's row
+static void TextileRowHandler( const float* line, uint8_t* row, int y, int width, const void* userData, bool useSSE )
+{
+    const TextileRowParams* params = (const TextileRowParams*) userData;
+    double factor  = params->factor;
+    double yPhase  = factor * ( y + params->stitchOffset );
+    double value;
+    int    x;
+
+    XUNREFERENCED_PARAMETER( useSSE )
+
+    for ( x = 0; x < width; x++ )
+    {
+        value = ( ( sin( factor * ( x + params->stitchOffset ) + line[x] ) +
+                    sin( yPhase + line[x] ) ) * 0.25 + 0.5 ) * 255;
+
+        value  = XINRANGE( value, 0.0, 255.0 );
+        row[x] = (uint8_t) value;
+    }
+}
+
+// Parameters of marble texture's rows handler
+typedef struct
+{
+    double xFact;
+    double yFact;
+}
+MarbleRowParams;
+
+// Convert noise to marble texture's row
+static void MarbleRowHandler( const float* line, uint8_t* row, int y, int width, const void* userData, bool useSSE )
+{
+    const MarbleRowParams* params = (const MarbleRowParams*) userData;
+    double xFact  = params->xFact;
+    double yPhase = y * params->yFact;
+    double value;
+    int    x;
+
+    XUNREFERENCED_PARAMETER( useSSE )
+
+    for ( x = 0; x < width; x++ )
+    {
+        value = sin( ( x * xFact + yPhase + line[x] ) * XPI ) * 255;
+
+        if ( value < 0 )
+        {
+            value = -value;
+        }
+
+        row[x] = (uint8_t) value;
+    }
+}
+
+// Convert noise to clouds texture's row
+static void CloudsRowHandler( const float* line, uint8_t* row, int y, int width, const void* userData, bool useSSE )
+{
+    XUNREFERENCED_PARAMETER( y )
+    XUNREFERENCED_PARAMETER( userData )
+
+    // ( noise * 0.5 + 0.5 ) * 255
+    NoiseLineToBytes( line, row, width, 127.5f, 127.5f, useSSE );
 }
 
 // ======= Public API =======
@@ -186,54 +546,19 @@ XErrorCode GenerateTextileTexture( ximage* texture, uint16_t randNumber, uint8_t
     }
     else
     {
-        int width  = texture->width;
-        int height = texture->height;
-        int stride = texture->stride;
-        int randN  = (int) randNumber;
-        int y;
-
-        uint8_t* ptr = texture->data;
-
-        // scaling factor
-        double factor = 2.0 * XPI / stitchSize;
-
         PerlinNoiseSettings perlinSettngs;
+        TextileRowParams    params;
 
         perlinSettngs.octaves       = 3;
         perlinSettngs.persistence   = 0.65;
         perlinSettngs.initFrequency = 1.0 / 8;
         perlinSettngs.initAmplitude = 1.0;
 
-        #pragma omp parallel for schedule(static) shared( ptr, width, stride )
-        for ( y = 0; y < height; y++ )
-        {
-            uint8_t* row = ptr + y * stride;
-            double   px, py, value;
-            int      x;
-
-            for ( x = 0; x < width; x++ )
-            {
-                px = factor * ( x + randN );
-                py = factor * ( y + randN );
-
-                value = ( (
-                          sin( factor * ( x + stitchOffset ) + PerlinNoise2D( &perlinSettngs, px, py ) ) +
-                          sin( factor * ( y + stitchOffset ) + PerlinNoise2D( &perlinSettngs, px, py ) )
-                        ) * 0.25 + 0.5 ) * 255;
-
-                if ( value < 0.0 )
-                {
-                    value = 0.0;
-                }
-                if ( value > 255.0 )
-                {
-                    value = 255.0;
-                }
+        // scaling factor
+        params.factor       = 2.0 * XPI / stitchSize;
+        params.stitchOffset = stitchOffset;
 
-                *row = (uint8_t) value;
-                row++;
-            }
-        }
+        ret = GeneratePerlinNoiseRows( texture, &perlinSettngs, params.factor, randNumber, TextileRowHandler, &params );
     }
 
     return ret;
@@ -254,42 +579,18 @@ XErrorCode GenerateMarbleTexture( ximage* texture, uint16_t randNumber, float xP
     }
     else
     {
-        int      width  = texture->width;
-        int      height = texture->height;
-        int      stride = texture->stride;
-        int      randN  = (int) randNumber;
-        double   xFact  = xPeriod / width;
-        double   yFact  = yPeriod / height;
-        int      y;
-        uint8_t* ptr = texture->data;
-
         PerlinNoiseSettings perlinSettngs;
+        MarbleRowParams     params;
 
         perlinSettngs.octaves       = 2;
         perlinSettngs.persistence   = 0.65;
         perlinSettngs.initFrequency = 1.0 / 32;
         perlinSettngs.initAmplitude = 1.0;
 
-        #pragma omp parallel for schedule(static) shared( ptr, width, stride, xFact, yFact )
-        for ( y = 0; y < height; y++ )
-        {
-            uint8_t* row = ptr + y * stride;
-            double   value;
-            int      x;
-
-            for ( x = 0; x < width; x++ )
-            {
-                value = sin( ( x * xFact + y * yFact + PerlinNoise2D( &perlinSettngs, x + randN, y + randN ) ) * XPI ) * 255;
-
-                if ( value < 0 )
-                {
-                    value = -value;
-                }
+        params.xFact = xPeriod / texture->width;
+        params.yFact = yPeriod / texture->height;
 
-                *row = (uint8_t) value;
-                row++;
-            }
-        }
+        ret = GeneratePerlinNoiseRows( texture, &perlinSettngs, 1.0, randNumber, MarbleRowHandler, &params );
     }
 
     return ret;
@@ -310,13 +611,6 @@ XErrorCode GenerateCloudsTexture( ximage* texture, uint16_t randNumber )
     }
     else
     {
-        int      width  = texture->width;
-        int      height = texture->height;
-        int      stride = texture->stride;
-        int      randN  = (int) randNumber;
-        int      y;
-        uint8_t* ptr = texture->data;
-
         PerlinNoiseSettings perlinSettngs;
 
         perlinSettngs.octaves       = 8;
@@ -324,21 +618,7 @@ XErrorCode GenerateCloudsTexture( ximage* texture, uint16_t randNumber )
         perlinSettngs.initFrequency = 1.0 / 32;
         perlinSettngs.initAmplitude = 1.0;
 
-        #pragma omp parallel for schedule(static) shared( ptr, width, stride )
-        for ( y = 0; y < height; y++ )
-        {
-            uint8_t* row = ptr + y * stride;
-            double   value;
-            int      x;
-
-            for ( x = 0; x < width; x++ )
-            {
-                value = ( PerlinNoise2D( &perlinSettngs, x + randN, y + randN ) * 0.5 + 0.5 ) * 255;
-                value = XINRANGE(value, 0, 255);
-                *row  = (uint8_t) value;
-                row++;
-            }
-        }
+        ret = GeneratePerlinNoiseRows( texture, &perlinSettngs, 1.0, randNumber, CloudsRowHandler, 0 );
     }
 
     return ret;
@@ -545,69 +825,101 @@ XErrorCode GenerateGrainTexture( ximage* texture, uint16_t randNumber, uint16_t
         int      height   = texture->height;
         int      stride   = texture->stride;
         int      randN    = (int) randNumber;
-        int      x, y, value;
+        int      lineSize = ( isVertical ) ? height : width;
+        int      x, y;
         uint8_t* ptr = texture->data;
         uint8_t* row;
-        double   dec = 0.25 * ( 1.0 - XINRANGE( density, 0.0, 1.0 ) );
+        float    dec = 0.25f * ( 1.0f - XINRANGE( density, 0.0f, 1.0f ) );
+        bool     useSSE = IsSSE2( );
+        float*   lattice = 0;
+        float*   line    = (float*) malloc( sizeof( float ) * lineSize );
+        uint8_t* values  = (uint8_t*) malloc( lineSize );
 
         PerlinNoiseSettings perlinSettngs;
+        PerlinNoiseAxis     axis;
 
         perlinSettngs.octaves       = 8;
         perlinSettngs.persistence   = 0.75;
         perlinSettngs.initFrequency = 1.0 / 2;
         perlinSettngs.initAmplitude = 1.0;
 
-        // initialize random number generator
-        srand( randNumber );
-
-        // min spacing is 1
-        spacing = XMAX( spacing, 1 );
-
-        // make sure the picture is clean
-        for ( y = 0; y < height; y++ )
+        if ( ( line == 0 ) || ( values == 0 ) )
         {
-            row = ptr + y * stride;
-            memset( row, 0, stride );
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            ret = PerlinNoiseAxisInit( &axis, &perlinSettngs, lineSize, 1.0, randN );
         }
 
-        if ( isVertical )
+        if ( ret == SuccessCode )
         {
-            // create vertical grain
-            x = rand( ) % spacing + 1;
+            lattice = (float*) malloc( sizeof( float ) * axis.maxCellCount );
 
-            for ( ; x < width; )
+            if ( lattice == 0 )
             {
-                row = ptr + x;
-
-                for ( y = 0; y < height; y++ )
-                {
-                    value = (int) ( ( PerlinNoise2D( &perlinSettngs, x + randN, y + randN ) * 0.25 - dec ) * 255 );
-                    *row = (uint8_t) ( ( value > 255 ) ? 255 : ( ( value < 0 ) ? 0 : value ) );
-                    row += stride;
-                }
-
-                x += rand( ) % spacing + 1;
+                PerlinNoiseAxisFree( &axis );
+                ret = ErrorOutOfMemory;
             }
         }
-        else
+
+        if ( ret == SuccessCode )
         {
-            // create horizontal grain
-            y = rand( ) % spacing + 1;
+            // initialize random number generator
+            srand( randNumber );
+
+            // min spacing is 1
+            spacing = XMAX( spacing, 1 );
 
-            for ( ; y < height; )
+            // make sure the picture is clean
+            for ( y = 0; y < height; y++ )
             {
-                row = ptr + stride * y;
+                row = ptr + y * stride;
+                memset( row, 0, stride );
+            }
+
+            if ( isVertical )
+            {
+                // create vertical grain
+                x = rand( ) % spacing + 1;
 
-                for ( x = 0; x < width; x++ )
+                for ( ; x < width; )
                 {
-                    value = (int) ( ( PerlinNoise2D( &perlinSettngs, x + randN, y + randN ) * 0.25 - dec ) * 255 );
-                    *row = (uint8_t) ( ( value > 255 ) ? 255 : ( ( value < 0 ) ? 0 : value ) );
-                    row++;
+                    // ( noise * 0.25 - dec ) * 255
+                    PerlinNoiseLine( &axis, false, x + randN, lattice, line, useSSE );
+                    NoiseLineToBytes( line, values, height, 63.75f, -dec * 255, useSSE );
+
+                    row = ptr + x;
+
+                    for ( y = 0; y < height; y++ )
+                    {
+                        *row = values[y];
+                        row += stride;
+                    }
+
+                    x += rand( ) % spacing + 1;
                 }
+            }
+            else
+            {
+                // create horizontal grain
+                y = rand( ) % spacing + 1;
+
+                for ( ; y < height; )
+                {
+                    PerlinNoiseLine( &axis, true, y + randN, lattice, line, useSSE );
+                    NoiseLineToBytes( line, ptr + stride * y, width, 63.75f, -dec * 255, useSSE );
 
-                y += rand( ) % spacing + 1;
+                    y += rand( ) % spacing + 1;
+                }
             }
+
+            PerlinNoiseAxisFree( &axis );
         }
+
+        free( lattice );
+        free( line );
+        free( values );
     }
 
     return ret;
@@ -21,7 +21,16 @@
 
 #include "ximaging_effects.h"
 
-// Shift hue of all pixels by the specified value, which looks like hue rotation
+// Fixed point representation of hue - [0, 6) range is mapped to [0, HUE_SIX)
+#define HUE_SHIFT (16)
+#define HUE_ONE   ( 1 << HUE_SHIFT )
+#define HUE_SIX   ( 6 << HUE_SHIFT )
+
+// Shift hue of all pixels by the specified value, which looks like hue rotation.
+//
+// Rotating hue does not change minimum and maximum of RGB components (saturation and luminance in HSL terms), so only
+// hue position of a pixel is calculated with fixed point arithmetic and then it is converted back to weights of RGB
+// components instead of doing full RGB->HSL->RGB conversion for every pixel.
 XErrorCode RotateImageHue( ximage* src, uint16_t hueAngle )
 {
     XErrorCode ret = SuccessCode;
@@ -42,35 +51,70 @@ XErrorCode RotateImageHue( ximage* src, uint16_t hueAngle )
         int height    = src->height;
         int stride    = src->stride;
         int pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
-        int y;
+        int y, i;
+
+        // inverse values of the difference between maximum and minimum RGB components
+        int invDelta[256];
+        int hueShift;
 
         // make sure hue angle value is in the correct range
         hueAngle = hueAngle % 360;
+        hueShift = ( hueAngle * HUE_ONE + 30 ) / 60;
+
+        invDelta[0] = 0;
+        for ( i = 1; i < 256; i++ )
+        {
+            invDelta[i] = ( HUE_ONE + i / 2 ) / i;
+        }
 
-        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, hueAngle )
+        #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, hueShift, invDelta )
         for ( y = 0; y < height; y++ )
         {
             uint8_t* row = ptr + y * stride;
-            int      x;
-            xargb    rgb;
-            xhsl     hsl;
+            int      x, r, g, b, max, min, delta, hue, k;
 
             for ( x = 0; x < width; x++, row += pixelSize )
             {
-                rgb.components.r = row[RedIndex];
-                rgb.components.g = row[GreenIndex];
-                rgb.components.b = row[BlueIndex];
+                r = row[RedIndex];
+                g = row[GreenIndex];
+                b = row[BlueIndex];
+
+                max   = XMAX3( r, g, b );
+                min   = XMIN3( r, g, b );
+                delta = max - min;
 
-                Rgb2Hsl( &rgb, &hsl );
+                if ( delta != 0 )
+                {
+                    if ( r == max )
+                    {
+                        hue = ( g - b ) * invDelta[delta];
+                        if ( hue < 0 ) hue += HUE_SIX;
+                    }
+                    else if ( g == max )
+                    {
+                        hue = 2 * HUE_ONE + ( b - r ) * invDelta[delta];
+                    }
+                    else
+                    {
+                        hue = 4 * HUE_ONE + ( r - g ) * invDelta[delta];
+                    }
 
-                hsl.Hue += hueAngle;
-                hsl.Hue %= 360;
+                    hue += hueShift;
+                    if ( hue >= HUE_SIX ) hue -= HUE_SIX;
 
-                Hsl2Rgb( &hsl, &rgb );
+                    // every component is "min + delta * ( 1 - max( 0, min( k, 4 - k, 1 ) ) )", where "k = ( n + hue ) mod 6"
+                    // and "n" is 5, 3 and 1 for red, green and blue
+                    k = 5 * HUE_ONE + hue; if ( k >= HUE_SIX ) k -= HUE_SIX;
+                    r = min + ( ( delta * ( HUE_ONE - XINRANGE( XMIN( k, 4 * HUE_ONE - k ), 0, HUE_ONE ) ) + HUE_ONE / 2 ) >> HUE_SHIFT );
+                    k = 3 * HUE_ONE + hue; if ( k >= HUE_SIX ) k -= HUE_SIX;
+                    g = min + ( ( delta * ( HUE_ONE - XINRANGE( XMIN( k, 4 * HUE_ONE - k ), 0, HUE_ONE ) ) + HUE_ONE / 2 ) >> HUE_SHIFT );
+                    k = 1 * HUE_ONE + hue; if ( k >= HUE_SIX ) k -= HUE_SIX;
+                    b = min + ( ( delta * ( HUE_ONE - XINRANGE( XMIN( k, 4 * HUE_ONE - k ), 0, HUE_ONE ) ) + HUE_ONE / 2 ) >> HUE_SHIFT );
 
-                row[RedIndex]   = rgb.components.r;
-                row[GreenIndex] = rgb.components.g;
-                row[BlueIndex]  = rgb.components.b;
+                    row[RedIndex]   = (uint8_t) r;
+                    row[GreenIndex] = (uint8_t) g;
+                    row[BlueIndex]  = (uint8_t) b;
+                }
             }
         }
     }
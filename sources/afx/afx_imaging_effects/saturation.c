@@ -21,6 +21,9 @@
 
 #include "ximaging_effects.h"
 
+// Changing saturation in HSV color space keeps maximum of RGB components (value) and hue the same. So instead of
+// RGB->HSV->RGB conversion, every component is moved towards/away from the maximum: "c' = max - ( max - c ) * S' / S".
+
 // Reduce saturation level in a color image (change is in [0, 100] range - 0: no changes, 100: grayscale)
 XErrorCode ReduceSaturation( const ximage* src, uint8_t change )
 {
@@ -46,29 +49,22 @@ XErrorCode ReduceSaturation( const ximage* src, uint8_t change )
             int pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
             int y;
 
-            float changeFactor = 1.0f - ( (float) XMIN( change, 100 ) / 100.0f );
+            // saturation change factor as 16.16 fixed point value
+            int changeFactor = ( ( 100 - XMIN( change, 100 ) ) * 65536 + 50 ) / 100;
 
             #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, changeFactor )
             for ( y = 0; y < height; y++ )
             {
                 uint8_t* row = ptr + y * stride;
-                int      x;
-                xargb    rgb;
-                xhsv     hsv;
+                int      x, max;
 
                 for ( x = 0; x < width; x++, row += pixelSize )
                 {
-                    rgb.components.r = row[RedIndex];
-                    rgb.components.g = row[GreenIndex];
-                    rgb.components.b = row[BlueIndex];
-
-                    Rgb2Hsv( &rgb, &hsv );
-                    hsv.Saturation *= changeFactor;
-                    Hsv2Rgb( &hsv, &rgb );
+                    max = XMAX3( row[RedIndex], row[GreenIndex], row[BlueIndex] );
 
-                    row[RedIndex]   = rgb.components.r;
-                    row[GreenIndex] = rgb.components.g;
-                    row[BlueIndex]  = rgb.components.b;
+                    row[RedIndex]   = (uint8_t) ( max - ( ( ( max - row[RedIndex]   ) * changeFactor + 0x8000 ) >> 16 ) );
+                    row[GreenIndex] = (uint8_t) ( max - ( ( ( max - row[GreenIndex] ) * changeFactor + 0x8000 ) >> 16 ) );
+                    row[BlueIndex]  = (uint8_t) ( max - ( ( ( max - row[BlueIndex]  ) * changeFactor + 0x8000 ) >> 16 ) );
                 }
             }
         }
@@ -102,35 +98,37 @@ XErrorCode IncreaseSaturation( const ximage* src, uint8_t change )
             int height    = src->height;
             int stride    = src->stride;
             int pixelSize = ( src->format == XPixelFormatRGB24 ) ? 3 : 4;
-            int y;
+            int y, i;
 
             float changeFactor = (float) XMIN( change, 100 ) / 100.0f;
+            float invMax[256];
 
-            #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, changeFactor )
+            for ( i = 1; i < 256; i++ )
+            {
+                invMax[i] = changeFactor / i;
+            }
+            invMax[0] = 0.0f;
+
+            #pragma omp parallel for schedule(static) shared( ptr, width, stride, pixelSize, invMax )
             for ( y = 0; y < height; y++ )
             {
                 uint8_t* row = ptr + y * stride;
-                int      x;
-                xargb    rgb;
-                xhsv     hsv;
+                int      x, max, min;
+                float    factor;
 
                 for ( x = 0; x < width; x++, row += pixelSize )
                 {
-                    rgb.components.r = row[RedIndex];
-                    rgb.components.g = row[GreenIndex];
-                    rgb.components.b = row[BlueIndex];
-
-                    Rgb2Hsv( &rgb, &hsv );
-                    // the remaining saturation capacity is multiplied by change factor
-                    // and also is multiplied by current saturation to make sure
-                    // low saturation values are not increased much (so hue artifacts don't
-                    // come up)
-                    hsv.Saturation += ( 1.0f - hsv.Saturation ) * changeFactor * hsv.Saturation;
-                    Hsv2Rgb( &hsv, &rgb );
-
-                    row[RedIndex]   = rgb.components.r;
-                    row[GreenIndex] = rgb.components.g;
-                    row[BlueIndex]  = rgb.components.b;
+                    max = XMAX3( row[RedIndex], row[GreenIndex], row[BlueIndex] );
+                    min = XMIN3( row[RedIndex], row[GreenIndex], row[BlueIndex] );
+
+                    // the remaining saturation capacity (1 - S) is multiplied by change factor and also is multiplied
+                    // by current saturation to make sure low saturation values are not increased much (so hue artifacts
+                    // don't come up): S' = S + ( 1 - S ) * changeFactor * S, where ( 1 - S ) = min / max
+                    factor = 1.0f + min * invMax[max];
+
+                    row[RedIndex]   = (uint8_t) XMAX( 0, max - (int) ( ( max - row[RedIndex]   ) * factor + 0.5f ) );
+                    row[GreenIndex] = (uint8_t) XMAX( 0, max - (int) ( ( max - row[GreenIndex] ) * factor + 0.5f ) );
+                    row[BlueIndex]  = (uint8_t) XMAX( 0, max - (int) ( ( max - row[BlueIndex]  ) * factor + 0.5f ) );
                 }
             }
         }
@@ -0,0 +1,232 @@
+/*
+    Imaging effects library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <stdlib.h>
+#include "xtextures.h"
+
+// Single entry of the texture cache
+typedef struct _xtexturecacheentry
+{
+    xtextureparams params;
+    ximage*        texture;
+    uint32_t       lastUsed;
+}
+xtexturecacheentry;
+
+// Texture cache structure
+struct _xtexturecache
+{
+    xtexturecacheentry* entries;
+    uint32_t            capacity;
+    uint32_t            counter;
+};
+
+// Check if two sets of texture parameters are equal
+static bool AreTextureParamsEqual( const xtextureparams* params1, const xtextureparams* params2 )
+{
+    return ( ( params1->generator  == params2->generator ) &&
+             ( params1->randNumber == params2->randNumber ) &&
+             ( params1->param1     == params2->param1 ) &&
+             ( params1->param2     == params2->param2 ) &&
+             ( params1->param3     == params2->param3 ) );
+}
+
+// Generate texture using the specified parameters
+static XErrorCode GenerateTextureFromParams( ximage* texture, const xtextureparams* params )
+{
+    XErrorCode ret = SuccessCode;
+
+    switch ( params->generator )
+    {
+    case TextureGenerator_Textile:
+        ret = GenerateTextileTexture( texture, params->randNumber, (uint8_t) params->param1, (uint8_t) params->param2 );
+        break;
+
+    case TextureGenerator_Marble:
+        ret = GenerateMarbleTexture( texture, params->randNumber, params->param1, params->param2 );
+        break;
+
+    case TextureGenerator_Clouds:
+        ret = GenerateCloudsTexture( texture, params->randNumber );
+        break;
+
+    case TextureGenerator_Grain:
+        ret = GenerateGrainTexture( texture, params->randNumber, (uint16_t) params->param1, params->param2, ( params->param3 != 0 ) );
+        break;
+
+    default:
+        ret = ErrorInvalidArgument;
+        break;
+    }
+
+    return ret;
+}
+
+// Create texture cache, which keeps up to the specified number of most recently used textures
+XErrorCode XTextureCacheCreate( uint32_t capacity, xtexturecache** cache )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( cache == 0 )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( capacity == 0 )
+    {
+        ret = ErrorArgumentOutOfRange;
+    }
+    else
+    {
+        *cache = (xtexturecache*) malloc( sizeof( xtexturecache ) );
+
+        if ( *cache == 0 )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            ( *cache )->entries  = (xtexturecacheentry*) calloc( capacity, sizeof( xtexturecacheentry ) );
+            ( *cache )->capacity = capacity;
+            ( *cache )->counter  = 0;
+
+            if ( ( *cache )->entries == 0 )
+            {
+                free( *cache );
+                *cache = 0;
+                ret = ErrorOutOfMemory;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Free texture cache and all the textures kept by it
+void XTextureCacheFree( xtexturecache** cache )
+{
+    if ( ( cache != 0 ) && ( *cache != 0 ) )
+    {
+        XTextureCacheClear( *cache );
+
+        free( ( *cache )->entries );
+        free( *cache );
+        *cache = 0;
+    }
+}
+
+// Remove all textures from the cache
+void XTextureCacheClear( xtexturecache* cache )
+{
+    if ( cache != 0 )
+    {
+        uint32_t i;
+
+        for ( i = 0; i < cache->capacity; i++ )
+        {
+            XImageFree( &cache->entries[i].texture );
+        }
+    }
+}
+
+// Get texture generated with the specified parameters, generating it only if the cache does not have it yet
+XErrorCode XTextureCacheGetTexture( xtexturecache* cache, const xtextureparams* params, int32_t width, int32_t height, const ximage** texture )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( cache == 0 ) || ( params == 0 ) || ( texture == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( width <= 0 ) || ( height <= 0 ) )
+    {
+        ret = ErrorInvalidImageSize;
+    }
+    else
+    {
+        xtexturecacheentry* entry = 0;
+        uint32_t            i;
+
+        *texture = 0;
+        cache->counter++;
+
+        // look for the texture in the cache
+        for ( i = 0; i < cache->capacity; i++ )
+        {
+            xtexturecacheentry* current = &cache->entries[i];
+
+            if ( ( current->texture != 0 ) && ( current->texture->width == width ) && ( current->texture->height == height ) &&
+                 ( AreTextureParamsEqual( &current->params, params ) ) )
+            {
+                entry = current;
+                break;
+            }
+        }
+
+        if ( entry == 0 )
+        {
+            // take an empty entry or the least recently used one
+            entry = &cache->entries[0];
+
+            for ( i = 0; ( i < cache->capacity ) && ( entry->texture != 0 ); i++ )
+            {
+                xtexturecacheentry* current = &cache->entries[i];
+
+                if ( ( current->texture == 0 ) || ( current->lastUsed < entry->lastUsed ) )
+                {
+                    entry = current;
+                }
+            }
+
+            // reuse memory of the evicted texture if its size matches
+            if ( ( entry->texture != 0 ) && ( ( entry->texture->width != width ) || ( entry->texture->height != height ) ) )
+            {
+                XImageFree( &entry->texture );
+            }
+
+            if ( entry->texture == 0 )
+            {
+                ret = XImageAllocateTextureRaw( width, height, &entry->texture );
+            }
+
+            if ( ret == SuccessCode )
+            {
+                ret = GenerateTextureFromParams( entry->texture, params );
+            }
+
+            if ( ret == SuccessCode )
+            {
+                entry->params = *params;
+            }
+            else
+            {
+                XImageFree( &entry->texture );
+            }
+        }
+
+        if ( ret == SuccessCode )
+        {
+            entry->lastUsed = cache->counter;
+            *texture = entry->texture;
+        }
+    }
+
+    return ret;
+}
@@ -34,8 +34,8 @@ extern "C" {
 
     // Perform pixellation of the specified image
 XErrorCode ImagePixellate( ximage* src, uint8_t pixelWidth, uint8_t pixelHeight );
-// Perform jittering on the image
-XErrorCode ImageJitter( ximage* src, uint8_t radius );
+// Perform jittering on the image (result is defined by the seed of random numbers generator)
+XErrorCode ImageJitter( ximage* src, uint32_t seed, uint8_t radius );
 // Create image with emboss effect
 XErrorCode EmbossImage( const ximage* src, ximage* dst, float azimuth, float elevation, float depth );
 // Create image with effect of light dropped at the image surface from the specified direction
@@ -112,6 +112,57 @@ XErrorCode GenerateFuzzyBorderTexture( ximage* texture, uint16_t randNumber, uin
  */
 XErrorCode GenerateRoundedBorderTexture( ximage* texture, uint16_t borderWidth, uint16_t xRoundness, uint16_t yRoundness, uint16_t xRoundnessShift, uint16_t yRoundnessShift, bool addBloor );
 
+/* ===== Texture cache =====
+   -------------------------
+ */
+
+/* Texture generators supported by texture cache */
+enum
+{
+    TextureGenerator_Textile = 0,
+    TextureGenerator_Marble  = 1,
+    TextureGenerator_Clouds  = 2,
+    TextureGenerator_Grain   = 3
+};
+typedef uint8_t XTextureGenerator;
+
+/* Parameters of texture generation, which identify a cached texture (together with its size).
+ * Parameters not used by the generator must be set to 0.
+ *
+ * TextureGenerator_Textile  param1 - stitch size, param2 - stitch offset.
+ * TextureGenerator_Marble   param1 - X period, param2 - Y period.
+ * TextureGenerator_Clouds   no extra parameters.
+ * TextureGenerator_Grain    param1 - spacing, param2 - density, param3 - vertical (non zero) or horizontal grain.
+ */
+typedef struct _xtextureparams
+{
+    XTextureGenerator generator;
+    uint16_t          randNumber;
+    float             param1;
+    float             param2;
+    float             param3;
+}
+xtextureparams;
+
+/* Cache of generated textures, which allows to avoid regenerating same textures again and again.
+   Not thread safe - the cache is supposed to be owned by single user (plug-in instance, etc). */
+typedef struct _xtexturecache xtexturecache;
+
+/* Create texture cache, which keeps up to the specified number of most recently used textures. */
+XErrorCode XTextureCacheCreate( uint32_t capacity, xtexturecache** cache );
+
+/* Free texture cache and all the textures kept by it. */
+void XTextureCacheFree( xtexturecache** cache );
+
+/* Remove all textures from the cache. */
+void XTextureCacheClear( xtexturecache* cache );
+
+/* Get texture of the specified size generated with the specified parameters. The texture is generated only
+ * if the cache does not have it yet, otherwise the cached one is provided. Returned texture is owned by the
+ * cache and stays valid until the next call to the cache.
+ */
+XErrorCode XTextureCacheGetTexture( xtexturecache* cache, const xtextureparams* params, int32_t width, int32_t height, const ximage** texture );
+
 #ifdef __cplusplus
 }
 #endif
@@ -37,13 +37,63 @@ XErrorCode XDecodeJpeg( const char* fileName, ximage** image );
 XErrorCode XDecodeJpegFromMemory( const uint8_t* buffer, int bufferLength, ximage** image );
 // Encode image into the specified JPEG file (quiality: [0, 100])
 XErrorCode XEncodeJpeg( const char* fileName, const ximage* image, uint32_t quality );
+// Encode image into memory buffer (quality: [0, 100])
+// (Note: the buffer is allocated with XMAlloc() and grown as required, so it can be reused
+// for encoding of subsequent images; encodedSize is set to the size of the produced JPEG data)
+XErrorCode XEncodeJpegToMemory( const ximage* image, uint32_t quality, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize );
 
-// Decode PNG image from the specified file
+// PNG compression strategies (zlib's strategies)
+enum
+{
+    PngStrategy_Default     = 0,    // libpng's choice - tuned for filtered data, unless filtering is disabled
+    PngStrategy_Filtered    = 1,
+    PngStrategy_HuffmanOnly = 2,    // no string matching - fastest, but compresses worse
+    PngStrategy_Rle         = 3,    // matches only repeated bytes - fast and good for synthetic images
+    PngStrategy_Fixed       = 4     // fixed Huffman codes
+};
+typedef uint8_t XPngStrategy;
+
+// PNG filters applied to image rows before compression
+enum
+{
+    PngFilter_Adaptive = 0,         // filter is chosen for every row (libpng's default)
+    PngFilter_None     = 1,
+    PngFilter_Sub      = 2,
+    PngFilter_Up       = 3,
+    PngFilter_Average  = 4,
+    PngFilter_Paeth    = 5
+};
+typedef uint8_t XPngFilter;
+
+#define XPNG_STRIPS_AUTO (0xFFFF)
+
+/* PNG encoding options. NULL options passed to encoding functions mean libpng's defaults.
+ *
+ * compressionLevel - zlib's compression level [0, 9], -1 for default (6).
+ * stripsCount      - 0 or 1 to encode the image with libpng in one go. Otherwise the image is split into
+ *                    the specified number of row strips, which are filtered and compressed in parallel. The
+ *                    result is still a standard PNG, which is a bit bigger than the one done in one go.
+ *                    XPNG_STRIPS_AUTO sets number of strips to the number of processors.
+ */
+typedef struct _xpngoptions
+{
+    int8_t       compressionLevel;
+    XPngStrategy strategy;
+    XPngFilter   filter;
+    uint16_t     stripsCount;
+}
+xpngoptions;
+
+// Decode PNG image from the specified file or memory buffer
 // (Note: if user provides already allocated image, from previous decoding for example,
 // then it will be reused in case its size/format matches)
 XErrorCode XDecodePng( const char* fileName, ximage** image );
-// Encode image into the specified PNG file
-XErrorCode XEncodePng( const char* fileName, const ximage* image );
+XErrorCode XDecodePngFromMemory( const uint8_t* buffer, int bufferLength, ximage** image );
+// Encode image into the specified PNG file (options can be NULL)
+XErrorCode XEncodePng( const char* fileName, const ximage* image, const xpngoptions* options );
+// Encode image into memory buffer (options can be NULL)
+// (Note: the buffer is allocated/grown same way as by XEncodeJpegToMemory())
+XErrorCode XEncodePngToMemory( const ximage* image, const xpngoptions* options, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize );
 
 #ifdef __cplusplus
 }
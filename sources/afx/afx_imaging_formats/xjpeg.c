@@ -24,8 +24,10 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 #include <setjmp.h>
 #include <jpeglib.h>
+#include <jerror.h>
 #include "ximaging_formats.h"
 
 #ifdef AFX_CORRECT_ORIENTATION
@@ -36,6 +38,7 @@ static XErrorCode CorrectJpegOrientation( const char* fileName, ximage** image )
 #endif
 
 static XErrorCode PerformJpegDecoding( struct jpeg_decompress_struct* cinfo, ximage** image );
+static void PerformJpegEncoding( struct jpeg_compress_struct* cinfo, const ximage* image, uint32_t quality );
 
 // Structure which is used for custom error handling from libjpeg
 #ifdef _MSC_VER
@@ -250,7 +253,6 @@ XErrorCode XEncodeJpeg( const char* fileName, const ximage* image, uint32_t qual
     struct jpeg_compress_struct cinfo;
     struct CustomeErrorManager  jerr;
     FILE*                       file = NULL;
-    JSAMPROW                    row_pointer[1];
     XErrorCode                  ret = SuccessCode;
 
     if ( ( fileName == 0 ) || ( image == 0 ) )
@@ -310,44 +312,142 @@ XErrorCode XEncodeJpeg( const char* fileName, const ximage* image, uint32_t qual
             // 2 - specify data destination
             jpeg_stdio_dest( &cinfo, file );
 
-            // 3 - set parameters for compression
-            cinfo.image_width  = image->width;
-            cinfo.image_height = image->height;
+            // 3-6 - perform actual encoding
+            PerformJpegEncoding( &cinfo, image, quality );
 
-            if ( image->format == XPixelFormatRGB24 )
-            {
-                cinfo.input_components = 3;
-                cinfo.in_color_space   = JCS_RGB;
-            }
-            else
-            {
-                cinfo.input_components = 1;
-                cinfo.in_color_space   = JCS_GRAYSCALE;
-            }
+            // 7 - clean up
+            fclose( file );
+            jpeg_destroy_compress( &cinfo );
+        }
+    }
+
+    return ret;
+}
+
+// Destination manager, which writes compressed data into a growing memory buffer
+struct MemoryDestinationManager
+{
+    struct jpeg_destination_mgr pub;
+    uint8_t*    buffer;
+    uint32_t    bufferSize;
+    XErrorCode  error;
+};
+
+static void memory_init_destination( j_compress_ptr cinfo )
+{
+    struct MemoryDestinationManager* dest = (struct MemoryDestinationManager*) cinfo->dest;
+
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer   = dest->bufferSize;
+}
+
+static boolean memory_empty_output_buffer( j_compress_ptr cinfo )
+{
+    struct MemoryDestinationManager* dest = (struct MemoryDestinationManager*) cinfo->dest;
+    // libjpeg calls this when the whole buffer is full, so double its size
+    uint32_t newSize   = dest->bufferSize * 2;
+    uint8_t* newBuffer = (uint8_t*) XMAlloc( newSize );
+
+    if ( newBuffer == 0 )
+    {
+        dest->error = ErrorOutOfMemory;
+        ERREXIT1( cinfo, JERR_OUT_OF_MEMORY, 10 );
+    }
+
+    memcpy( newBuffer, dest->buffer, dest->bufferSize );
+    XFree( (void**) &dest->buffer );
+
+    dest->pub.next_output_byte = newBuffer + dest->bufferSize;
+    dest->pub.free_in_buffer   = newSize - dest->bufferSize;
+
+    dest->buffer     = newBuffer;
+    dest->bufferSize = newSize;
+
+    return TRUE;
+}
+
+static void memory_term_destination( j_compress_ptr cinfo )
+{
+    // nothing to do - size of the encoded data is calculated by the caller
+    XUNREFERENCED_PARAMETER( cinfo )
+}
+
+// Encode image into the specified memory buffer (quality: [0, 100])
+XErrorCode XEncodeJpegToMemory( const ximage* image, uint32_t quality, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize )
+{
+    struct jpeg_compress_struct         cinfo;
+    struct CustomeErrorManager          jerr;
+    struct MemoryDestinationManager     dest;
+    XErrorCode                          ret = SuccessCode;
+
+    if ( ( image == 0 ) || ( buffer == 0 ) || ( bufferSize == 0 ) || ( encodedSize == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( image->format != XPixelFormatGrayscale8 ) &&
+              ( image->format != XPixelFormatRGB24 ) )
+    {
+        ret = ErrorUnsupportedPixelFormat;
+    }
+    else
+    {
+        *encodedSize = 0;
 
-            // set default compression parameters
-            jpeg_set_defaults( &cinfo ) ;
-            // set quality
-            quality = XMIN( quality, 100 );
-            quality = XMAX( quality, 0 );
-            jpeg_set_quality( &cinfo, (int) quality, TRUE /* limit to baseline-JPEG values */ );
+        // make sure there is a buffer to start with - a quarter of the raw image size
+        // is enough for most of the images, so it does not need to grow often
+        if ( ( *buffer == 0 ) || ( *bufferSize == 0 ) )
+        {
+            uint32_t initialSize = XMAX( 4096, (uint32_t) image->stride * image->height / 4 );
 
-            // 4 - start compressor
-            jpeg_start_compress( &cinfo, TRUE );
+            XFree( (void**) buffer );
+            *buffer     = (uint8_t*) XMAlloc( initialSize );
+            *bufferSize = ( *buffer != 0 ) ? initialSize : 0;
+        }
 
-            // 5 - do compression
-            while ( cinfo.next_scanline < cinfo.image_height )
+        if ( *buffer == 0 )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            dest.pub.init_destination    = memory_init_destination;
+            dest.pub.empty_output_buffer = memory_empty_output_buffer;
+            dest.pub.term_destination    = memory_term_destination;
+            dest.buffer                  = *buffer;
+            dest.bufferSize              = *bufferSize;
+            dest.error                   = SuccessCode;
+
+            // 1 - allocate and initialize JPEG compression object
+            cinfo.err               = jpeg_std_error( &jerr.pub );
+            jerr.pub.error_exit     = my_error_exit;
+            jerr.pub.output_message = my_output_message;
+
+            // establish the setjmp return context
+            if ( setjmp( jerr.setjmpBuffer ) )
             {
-                row_pointer[0] = image->data + image->stride * cinfo.next_scanline;
+                // if we get here, the JPEG code has signaled an error
+                jpeg_destroy_compress( &cinfo );
+
+                // the buffer could have been re-allocated before the failure
+                *buffer     = dest.buffer;
+                *bufferSize = dest.bufferSize;
 
-                jpeg_write_scanlines( &cinfo, row_pointer, 1 );
+                return ( dest.error != SuccessCode ) ? dest.error : ErrorFailedImageEncoding;
             }
 
-            // 6 - finish compression
-            jpeg_finish_compress( &cinfo );
+            jpeg_create_compress( &cinfo );
+
+            // 2 - specify data destination
+            cinfo.dest = &dest.pub;
+
+            // 3-6 - perform actual encoding
+            PerformJpegEncoding( &cinfo, image, quality );
+
+            *buffer      = dest.buffer;
+            *bufferSize  = dest.bufferSize;
+            *encodedSize = dest.bufferSize - (uint32_t) dest.pub.free_in_buffer;
 
             // 7 - clean up
-            fclose( file );
             jpeg_destroy_compress( &cinfo );
         }
     }
@@ -355,6 +455,48 @@ XErrorCode XEncodeJpeg( const char* fileName, const ximage* image, uint32_t qual
     return ret;
 }
 
+// Perform actual encoding of JPEG image
+static void PerformJpegEncoding( struct jpeg_compress_struct* cinfo, const ximage* image, uint32_t quality )
+{
+    JSAMPROW row_pointer[1];
+
+    // 3 - set parameters for compression
+    cinfo->image_width  = image->width;
+    cinfo->image_height = image->height;
+
+    if ( image->format == XPixelFormatRGB24 )
+    {
+        cinfo->input_components = 3;
+        cinfo->in_color_space   = JCS_RGB;
+    }
+    else
+    {
+        cinfo->input_components = 1;
+        cinfo->in_color_space   = JCS_GRAYSCALE;
+    }
+
+    // set default compression parameters
+    jpeg_set_defaults( cinfo ) ;
+    // set quality
+    quality = XMIN( quality, 100 );
+    quality = XMAX( quality, 0 );
+    jpeg_set_quality( cinfo, (int) quality, TRUE /* limit to baseline-JPEG values */ );
+
+    // 4 - start compressor
+    jpeg_start_compress( cinfo, TRUE );
+
+    // 5 - do compression
+    while ( cinfo->next_scanline < cinfo->image_height )
+    {
+        row_pointer[0] = image->data + image->stride * cinfo->next_scanline;
+
+        jpeg_write_scanlines( cinfo, row_pointer, 1 );
+    }
+
+    // 6 - finish compression
+    jpeg_finish_compress( cinfo );
+}
+
 #ifdef AFX_CORRECT_ORIENTATION
 // Correct image's orientation based on EXIF information
 static XErrorCode CorrectJpegOrientation( const char* fileName, ximage** image )
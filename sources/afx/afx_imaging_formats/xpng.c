@@ -23,7 +23,18 @@
     #include <windows.h>
 #endif
 
+#ifdef _OPENMP
+    #include <omp.h>
+#else
+    #define omp_get_max_threads( ) ( 1 )
+    #define omp_get_num_procs( )   ( 1 )
+    #define omp_get_thread_num( )  ( 0 )
+#endif
+
+#include <memory.h>
+#include <stdlib.h>
 #include <png.h>
+#include <zlib.h>
 #include "ximaging_formats.h"
 
 // Get AForgeX pixel format from PNG's color type and number of bits per pixel
@@ -117,13 +128,124 @@ static XErrorCode GetPngColorPalette( png_structp ptrPng, png_infop ptrInfo, xpa
     return ret;
 }
 
-// Decode PNG image from the specified file
-XErrorCode XDecodePng( const char* fileName, ximage** image )
+// Source of PNG data kept in memory
+typedef struct _pngMemorySource
+{
+    const uint8_t* buffer;
+    uint32_t       size;
+    uint32_t       offset;
+}
+PngMemorySource;
+
+// Destination of PNG data - memory buffer growing as required
+typedef struct _pngMemoryDestination
+{
+    uint8_t*   buffer;
+    uint32_t   bufferSize;
+    uint32_t   dataSize;
+    XErrorCode error;
+}
+PngMemoryDestination;
+
+// Provide libpng with the next chunk of data from memory buffer
+static void PngMemoryRead( png_structp ptrPng, png_bytep data, png_size_t length )
+{
+    PngMemorySource* source = (PngMemorySource*) png_get_io_ptr( ptrPng );
+
+    if ( length > (png_size_t) ( source->size - source->offset ) )
+    {
+        png_error( ptrPng, "Unexpected end of PNG data" );
+    }
+
+    memcpy( data, source->buffer + source->offset, length );
+    source->offset += (uint32_t) length;
+}
+
+// Append data to memory buffer, growing it if required
+static XErrorCode AppendToMemoryDestination( PngMemoryDestination* dest, const uint8_t* data, uint32_t length )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( length > dest->bufferSize - dest->dataSize )
+    {
+        uint32_t newSize   = XMAX( dest->bufferSize * 2, dest->dataSize + length );
+        uint8_t* newBuffer = (uint8_t*) XMAlloc( newSize );
+
+        if ( newBuffer == 0 )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            memcpy( newBuffer, dest->buffer, dest->dataSize );
+            XFree( (void**) &dest->buffer );
+
+            dest->buffer     = newBuffer;
+            dest->bufferSize = newSize;
+        }
+    }
+
+    if ( ret == SuccessCode )
+    {
+        memcpy( dest->buffer + dest->dataSize, data, length );
+        dest->dataSize += length;
+    }
+
+    return ret;
+}
+
+// Put data provided by libpng into memory buffer
+static void PngMemoryWrite( png_structp ptrPng, png_bytep data, png_size_t length )
+{
+    PngMemoryDestination* dest = (PngMemoryDestination*) png_get_io_ptr( ptrPng );
+
+    dest->error = AppendToMemoryDestination( dest, data, (uint32_t) length );
+
+    if ( dest->error != SuccessCode )
+    {
+        png_error( ptrPng, "Out of memory" );
+    }
+}
+
+static void PngMemoryFlush( png_structp ptrPng )
+{
+    XUNREFERENCED_PARAMETER( ptrPng )
+}
+
+// Open file with the specified UTF8 name
+static FILE* OpenPngFile( const char* fileName, int forWriting )
+{
+    FILE* file = NULL;
+
+    #ifdef WIN32
+        {
+            int charsRequired = MultiByteToWideChar( CP_UTF8, 0, fileName, -1, NULL, 0 );
+
+            if ( charsRequired > 0 )
+            {
+                WCHAR* filenameUtf16 = (WCHAR*) malloc( sizeof( WCHAR ) * charsRequired );
+
+                if ( MultiByteToWideChar( CP_UTF8, 0, fileName, -1, filenameUtf16, charsRequired ) > 0 )
+                {
+                    file = _wfopen( filenameUtf16, ( forWriting ) ? L"wb" : L"rb" );
+                }
+
+                free( filenameUtf16 );
+            }
+        }
+    #else
+        file = fopen( fileName, ( forWriting ) ? "wb" : "rb" );
+    #endif
+
+    return file;
+}
+
+// Decode PNG image from the specified file or memory source (one of them must be set)
+static XErrorCode DecodePng( FILE* file, PngMemorySource* source, ximage** image )
 {
     png_structp  ptrPng;
     png_infop    ptrInfo;
 
-    FILE*        file = NULL;
     XErrorCode   ret  = SuccessCode;
 
     png_uint_32  width, height;
@@ -132,391 +254,925 @@ XErrorCode XDecodePng( const char* fileName, ximage** image )
 
     XPixelFormat outputPixelFormat = XPixelFormatUnknown;
     xpalette*    palette = 0;
+    // decompression buffer must be freed if libpng fails in the middle of decoding
+    png_bytep volatile rowPtr = 0;
 
-    if ( ( fileName == 0 ) || ( image == 0 ) )
+    // get palette of the image, if it was already allocated
+    if ( *image != 0 )
     {
-        ret = ErrorNullParameter;
+        palette = (*image)->palette;
+        // set it to NULL for now, so we don't have dangling pointer in the case if palette can not be reused and must be reallocated
+        // (it will be restored on success)
+        (*image)->palette = 0;
+    }
+
+    // 1 - Initialize structures and error handling
+    ptrPng  = png_create_read_struct( PNG_LIBPNG_VER_STRING, 0, 0, 0 );
+    ptrInfo = png_create_info_struct( ptrPng );
+
+    if ( ( ptrPng == 0 ) || ( ptrInfo == 0 ) )
+    {
+        if ( ptrPng != 0 )
+        {
+            png_destroy_read_struct( &ptrPng, 0, 0 );
+        }
+
+        XPaletteFree( &palette );
+        XImageFree( image );
+
+        return ErrorFailedImageDecoding;
+    }
+
+    // set error handling
+    if ( setjmp( png_jmpbuf( ptrPng ) ) )
+    {
+        if ( rowPtr != 0 )
+        {
+            png_free( ptrPng, rowPtr );
+        }
+
+        png_destroy_read_struct( &ptrPng, &ptrInfo, 0 );
+
+        XPaletteFree( &palette );
+        XImageFree( image );
+
+        return ErrorFailedImageDecoding;
+    }
+
+    // 2 - tell libpng where to read from
+    if ( file != NULL )
+    {
+        png_init_io( ptrPng, file );
     }
     else
     {
-        // get palette of the image, if it was already allocated
-        if ( *image != 0 )
+        png_set_read_fn( ptrPng, source, PngMemoryRead );
+    }
+
+    // 3 - read info of the image
+    png_read_info( ptrPng, ptrInfo );
+    png_get_IHDR( ptrPng, ptrInfo, &width, &height, &bitDepth, &colorType, &interlaceType, NULL, NULL );
+    channelsCount = png_get_channels( ptrPng, ptrInfo );
+
+    // 4 - configure options
+
+    /*
+    printf( "size: %dx%d \n", width, height );
+    printf( "bits: %d \n", bitDepth );
+    printf( "channels: %d \n", channelsCount );
+    printf( "color type: %d \n", colorType );
+    printf( "\n" );
+    */
+
+    // tell libpng to strip 16 bit/color files down to 8 bits/color
+    png_set_scale_16( ptrPng );
+
+    if ( ( bitDepth <= 8 ) && ( colorType == PNG_COLOR_TYPE_PALETTE ) )
+    {
+        ret = GetPngColorPalette( ptrPng, ptrInfo, &palette );
+    }
+    else if ( ( bitDepth != 1 ) || ( colorType != PNG_COLOR_TYPE_GRAY ) )
+    {
+        // extract multiple pixels with bit depths of 1, 2, and 4 from a single
+        // byte into separate bytes (useful for paletted and grayscale images)
+        png_set_packing( ptrPng );
+
+        // expand paletted colors into true RGB triplets
+        if ( colorType == PNG_COLOR_TYPE_PALETTE )
+        {
+            png_set_palette_to_rgb( ptrPng );
+        }
+
+        // expand 2 and 4 bpp grayscale images to the full 8 bits
+        if ( ( colorType == PNG_COLOR_TYPE_GRAY ) && ( bitDepth != 1 ) )
         {
-            palette = (*image)->palette;
-            // set it to NULL for now, so we don't have dangling pointer in the case if palette can not be reused and must be reallocated
-            // (it will be restored on success)
-            (*image)->palette = 0;
+            png_set_expand_gray_1_2_4_to_8( ptrPng );
         }
 
-        // open image file
-        #ifdef WIN32
+        // expand RGB images with transparency to full alpha channels
+        // so the data will be available as RGBA quartets
+        if ( png_get_valid( ptrPng, ptrInfo, PNG_INFO_tRNS ) )
+        {
+            png_set_tRNS_to_alpha( ptrPng );
+        }
+    }
+
+    if ( ret == SuccessCode )
+    {
+        // don't care of transparency for grayscale images
+        if ( colorType == PNG_COLOR_TYPE_GRAY_ALPHA )
+        {
+            png_set_strip_alpha( ptrPng );
+        }
+
+        /*
+        // flip the RGB pixels to BGR (or RGBA to BGRA)
+        if ( colorType & PNG_COLOR_MASK_COLOR )
+        {
+            png_set_bgr( ptrPng );
+        }
+        */
+
+        // 5 - update information so configuration changes are reflected
+        png_read_update_info( ptrPng, ptrInfo );
+        png_get_IHDR( ptrPng, ptrInfo, &width, &height, &bitDepth, &colorType, &interlaceType, NULL, NULL );
+        channelsCount = png_get_channels( ptrPng, ptrInfo );
+
+        /*
+        printf( "size: %dx%d \n", width, height );
+        printf( "bits: %d \n", bitDepth );
+        printf( "channels: %d \n", channelsCount );
+        printf( "color type: %d \n", colorType );
+        printf( "\n" );
+        */
+
+        // calculate bits per pixel
+        bpp = bitDepth * channelsCount;
+        // get row size in bytes
+        rowSize = png_get_rowbytes( ptrPng, ptrInfo );
+        // get final output pixel format
+        outputPixelFormat = GetPixelFormatFromColorAndBpp( colorType, bpp );
+
+        // check if output image format is resolved
+        if ( outputPixelFormat == XPixelFormatUnknown )
+        {
+            // should not happen with all the above settings, but in case it does
+            ret = ErrorUnsupportedPixelFormat;
+        }
+        else
+        {
+            // 6 - allocate image and decompression buffer
+            rowPtr = (png_bytep) png_malloc( ptrPng, rowSize );
+
+            if ( rowPtr == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
             {
-                int charsRequired = MultiByteToWideChar( CP_UTF8, 0, fileName, -1, NULL, 0 );
+                // if image's size/format matches it will not be reallocated, but reused
+                ret = XImageAllocateRaw( width, height, outputPixelFormat, image );
 
-                if ( charsRequired > 0 )
+                if ( ret == SuccessCode )
                 {
-                    WCHAR* filenameUtf16 = (WCHAR*) malloc( sizeof( WCHAR ) * charsRequired );
+                    // 7 - decode the image
+                    png_uint_32 y;
 
-                    if ( MultiByteToWideChar( CP_UTF8, 0, fileName, -1, filenameUtf16, charsRequired ) > 0 )
+                    for ( y = 0; y < height; y++ )
                     {
-                        file = _wfopen( filenameUtf16, L"rb" );
-                    }
+                        png_bytep row = rowPtr;
+
+                        png_read_rows( ptrPng, &row, NULL, 1 );
 
-                    free( filenameUtf16 );
+                        if ( XImageSetLine( *image, y, row, (uint32_t) rowSize ) != SuccessCode )
+                        {
+                            ret = ErrorFailedImageDecoding;
+                            break;
+                        }
+                    }
                 }
             }
-        #else
-            file = fopen( fileName, "rb" );
-        #endif
+
+            if ( rowPtr != 0 )
+            {
+                png_free( ptrPng, rowPtr );
+                rowPtr = 0;
+            }
+        }
+
+        // 8 - clean up
+        png_read_end( ptrPng, ptrInfo );
+    }
+
+    png_destroy_read_struct( &ptrPng, &ptrInfo, 0 );
+
+    // check for any errors
+    if ( ret != SuccessCode )
+    {
+        XPaletteFree( &palette );
+        XImageFree( image );
+    }
+    else
+    {
+        // update palette pointer
+        (*image)->palette = palette;
+    }
+
+    return ret;
+}
+
+// Decode PNG image from the specified file
+XErrorCode XDecodePng( const char* fileName, ximage** image )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( fileName == 0 ) || ( image == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else
+    {
+        FILE* file = OpenPngFile( fileName, 0 );
 
         if ( file == NULL )
         {
-            XPaletteFree( &palette );
             XImageFree( image );
 
             ret = ErrorIOFailure;
         }
         else
         {
-            // 1 - Initialize structures and error handling
-            ptrPng  = png_create_read_struct( PNG_LIBPNG_VER_STRING, 0, 0, 0 );
-            ptrInfo = png_create_info_struct( ptrPng );
+            ret = DecodePng( file, NULL, image );
+            fclose( file );
+        }
+    }
 
-            if ( ( ptrPng == 0 ) || ( ptrInfo == 0 ) )
-            {
-                if ( ptrPng != 0 )
-                {
-                    png_destroy_read_struct( &ptrPng, 0, 0 );
-                }
+    return ret;
+}
 
-                fclose( file );
+// Decode PNG image from the specified memory buffer
+XErrorCode XDecodePngFromMemory( const uint8_t* buffer, int bufferLength, ximage** image )
+{
+    XErrorCode ret = SuccessCode;
 
-                XPaletteFree( &palette );
-                XImageFree( image );
+    if ( ( buffer == 0 ) || ( image == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( bufferLength <= 0 )
+    {
+        XImageFree( image );
 
-                return ErrorFailedImageDecoding;
-            }
+        ret = ErrorFailedImageDecoding;
+    }
+    else
+    {
+        PngMemorySource source;
 
-            // set error handling
-            if ( setjmp( png_jmpbuf( ptrPng ) ) )
-            {
-                png_destroy_read_struct( &ptrPng, &ptrInfo, 0 );
-                fclose( file );
+        source.buffer = buffer;
+        source.size   = (uint32_t) bufferLength;
+        source.offset = 0;
 
-                XPaletteFree( &palette );
-                XImageFree( image );
+        ret = DecodePng( NULL, &source, image );
+    }
 
-                return ErrorFailedImageDecoding;
-            }
+    return ret;
+}
 
-            // 2 - tell libpng which file to read
-            png_init_io( ptrPng, file );
+// Get zlib's compression strategy for the specified options
+static int GetZlibStrategy( const xpngoptions* options )
+{
+    static const int strategies[] = { Z_FILTERED, Z_FILTERED, Z_HUFFMAN_ONLY, Z_RLE, Z_FIXED };
+    int strategy = strategies[XMIN( options->strategy, PngStrategy_Fixed )];
 
-            // 3 - read info of the image
-            png_read_info( ptrPng, ptrInfo );
-            png_get_IHDR( ptrPng, ptrInfo, &width, &height, &bitDepth, &colorType, &interlaceType, NULL, NULL );
-            channelsCount = png_get_channels( ptrPng, ptrInfo );
+    // same as libpng, use default strategy when rows are not filtered
+    if ( ( options->strategy == PngStrategy_Default ) && ( options->filter == PngFilter_None ) )
+    {
+        strategy = Z_DEFAULT_STRATEGY;
+    }
 
-            // 4 - configure options
+    return strategy;
+}
 
-            /*
-            printf( "size: %dx%d \n", width, height );
-            printf( "bits: %d \n", bitDepth );
-            printf( "channels: %d \n", channelsCount );
-            printf( "color type: %d \n", colorType );
-            printf( "\n" );
-            */
+// Encode image as PNG into the specified file or memory destination (one of them must be set)
+static XErrorCode EncodePng( FILE* file, PngMemoryDestination* dest, const ximage* image, const xpngoptions* options )
+{
+    png_structp ptrPng;
+    png_infop   ptrInfo;
+    png_color_8 sig_bit;
 
-            // tell libpng to strip 16 bit/color files down to 8 bits/color
-            png_set_scale_16( ptrPng );
+    XErrorCode  ret  = SuccessCode;
 
-            if ( ( bitDepth <= 8 ) && ( colorType == PNG_COLOR_TYPE_PALETTE ) )
-            {
-                ret = GetPngColorPalette( ptrPng, ptrInfo, &palette );
-            }
-            else if ( ( bitDepth != 1 ) || ( colorType != PNG_COLOR_TYPE_GRAY ) )
-            {
-                // extract multiple pixels with bit depths of 1, 2, and 4 from a single
-                // byte into separate bytes (useful for paletted and grayscale images)
-                png_set_packing( ptrPng );
+    int         bitDepth, colorType;
+    int32_t     y;
+    png_bytep   rowPtr;
 
-                // expand paletted colors into true RGB triplets
-                if ( colorType == PNG_COLOR_TYPE_PALETTE )
-                {
-                    png_set_palette_to_rgb( ptrPng );
-                }
+    // 1 - Initialize structures and error handling
+    ptrPng  = png_create_write_struct( PNG_LIBPNG_VER_STRING, 0, 0, 0 );
+    ptrInfo = png_create_info_struct( ptrPng );
 
-                // expand 2 and 4 bpp grayscale images to the full 8 bits
-                if ( ( colorType == PNG_COLOR_TYPE_GRAY ) && ( bitDepth != 1 ) )
-                {
-                    png_set_expand_gray_1_2_4_to_8( ptrPng );
-                }
+    if ( ( ptrPng == 0 ) || ( ptrInfo == 0 ) )
+    {
+        if ( ptrPng != 0 )
+        {
+            png_destroy_write_struct( &ptrPng, 0 );
+        }
+        ret = ErrorFailedImageEncoding;
+    }
+    else
+    {
+        // set error handling
+        if ( setjmp( png_jmpbuf( ptrPng ) ) )
+        {
+            png_destroy_write_struct( &ptrPng, &ptrInfo );
 
-                // expand RGB images with transparency to full alpha channels
-                // so the data will be available as RGBA quartets
-                if ( png_get_valid( ptrPng, ptrInfo, PNG_INFO_tRNS ) )
-                {
-                    png_set_tRNS_to_alpha( ptrPng );
-                }
-            }
+            return ( ( dest != NULL ) && ( dest->error != SuccessCode ) ) ? dest->error : ErrorFailedImageEncoding;
+        }
 
-            if ( ret == SuccessCode )
+        // 2 - tell libpng where to write to
+        if ( file != NULL )
+        {
+            png_init_io( ptrPng, file );
+        }
+        else
+        {
+            png_set_write_fn( ptrPng, dest, PngMemoryWrite, PngMemoryFlush );
+        }
+
+        // 3 - specify some image information
+        bitDepth = 8;
+
+        if ( image->format == XPixelFormatGrayscale8 )
+        {
+            colorType = PNG_COLOR_TYPE_GRAY;
+            sig_bit.gray = 8;
+        }
+        else if ( image->format == XPixelFormatRGB24 )
+        {
+            colorType = PNG_COLOR_TYPE_RGB;
+            sig_bit.red   = 8;
+            sig_bit.green = 8;
+            sig_bit.blue  = 8;
+        }
+        else if ( image->format == XPixelFormatRGBA32 )
+        {
+            colorType = PNG_COLOR_TYPE_RGB_ALPHA;
+            sig_bit.red   = 8;
+            sig_bit.green = 8;
+            sig_bit.blue  = 8;
+            sig_bit.alpha = 8;
+        }
+        else if ( image->format == XPixelFormatBinary1 )
+        {
+            colorType = PNG_COLOR_TYPE_GRAY;
+            sig_bit.gray = 1;
+            bitDepth = 1;
+        }
+        else
+        {
+            ret = ErrorUnsupportedPixelFormat;
+        }
+
+        if ( ret == SuccessCode )
+        {
+            // set compression options, if any
+            if ( options != NULL )
             {
-                // don't care of transparency for grayscale images
-                if ( colorType == PNG_COLOR_TYPE_GRAY_ALPHA )
+                if ( options->compressionLevel >= 0 )
                 {
-                    png_set_strip_alpha( ptrPng );
+                    png_set_compression_level( ptrPng, XMIN( options->compressionLevel, 9 ) );
                 }
-
-                /*
-                // flip the RGB pixels to BGR (or RGBA to BGRA)
-                if ( colorType & PNG_COLOR_MASK_COLOR )
+                if ( options->strategy != PngStrategy_Default )
                 {
-                    png_set_bgr( ptrPng );
+                    png_set_compression_strategy( ptrPng, GetZlibStrategy( options ) );
                 }
-                */
-
-                // 5 - update information so configuration changes are reflected
-                png_read_update_info( ptrPng, ptrInfo );
-                png_get_IHDR( ptrPng, ptrInfo, &width, &height, &bitDepth, &colorType, &interlaceType, NULL, NULL );
-                channelsCount = png_get_channels( ptrPng, ptrInfo );
-
-                /*
-                printf( "size: %dx%d \n", width, height );
-                printf( "bits: %d \n", bitDepth );
-                printf( "channels: %d \n", channelsCount );
-                printf( "color type: %d \n", colorType );
-                printf( "\n" );
-                */
-
-                // calculate bits per pixel
-                bpp = bitDepth * channelsCount;
-                // get row size in bytes
-                rowSize = png_get_rowbytes( ptrPng, ptrInfo );
-                // get final output pixel format
-                outputPixelFormat = GetPixelFormatFromColorAndBpp( colorType, bpp );
-
-                // check if output image format is resolved
-                if ( outputPixelFormat == XPixelFormatUnknown )
+                if ( ( options->filter != PngFilter_Adaptive ) && ( options->filter <= PngFilter_Paeth ) )
                 {
-                    // should not happen with all the above settings, but in case it does
-                    ret = ErrorUnsupportedPixelFormat;
+                    png_set_filter( ptrPng, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE << ( options->filter - PngFilter_None ) );
                 }
-                else
-                {
-                    // 6 - allocate image and decompression buffer
-                    png_bytep rowPtr = (png_bytep) png_malloc( ptrPng, rowSize );
-
-                    if ( rowPtr == 0 )
-                    {
-                        ret = ErrorOutOfMemory;
-                    }
-                    else
-                    {
-                        // if image's size/format matches it will not be reallocated, but reused
-                        ret = XImageAllocateRaw( width, height, outputPixelFormat, image );
+            }
 
-                        if ( ret == SuccessCode )
-                        {
-                            // 7 - decode the image
-                            png_uint_32 y;
-
-                            for ( y = 0; y < height; y++ )
-                            {
-                                png_read_rows( ptrPng, &rowPtr, NULL, 1 );
-
-                                if ( XImageSetLine( *image, y, rowPtr, (uint32_t) rowSize ) != SuccessCode )
-                                {
-                                    ret = ErrorFailedImageDecoding;
-                                    break;
-                                }
-                            }
-                        }
-                    }
+            png_set_IHDR( ptrPng, ptrInfo, image->width, image->height, bitDepth, colorType,
+                PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE );
+            png_set_sBIT( ptrPng, ptrInfo, &sig_bit );
 
-                    if ( rowPtr != 0 )
-                    {
-                        png_free( ptrPng, rowPtr );
-                    }
-                }
+            // 4 - write the file header information
+            png_write_info( ptrPng, ptrInfo );
 
-                // 8 - clean up
-                png_read_end( ptrPng, ptrInfo );
-            }
+            // 5 - some extra configuration
 
-            png_destroy_read_struct( &ptrPng, &ptrInfo, 0 );
-            fclose( file );
+            // shift the pixels up to a legal bit depth and fill in as appropriate
+            // to correctly scale the image
+            png_set_shift( ptrPng, &sig_bit );
 
-            // check for any errors
-            if ( ret != SuccessCode )
+            if ( image->format != XPixelFormatBinary1 )
             {
-                XPaletteFree( &palette );
-                XImageFree( image );
+                // pack pixels into bytes
+                png_set_packing( ptrPng );
             }
-            else
+
+            // 6 - write image
+            for ( y = 0; y < image->height; y++ )
             {
-                // update palette pointer
-                (*image)->palette = palette;
+                rowPtr = image->data + image->stride * y;
+                png_write_rows( ptrPng, &rowPtr, 1 );
             }
+
+            // 7 - write footer
+            png_write_end( ptrPng, ptrInfo );
         }
+
+        // 8 clean up
+        png_destroy_write_struct( &ptrPng, &ptrInfo );
     }
 
     return ret;
 }
 
-// Encode image into the specified PNG file
-XErrorCode XEncodePng( const char* fileName, const ximage* image )
+// ===== Parallel PNG encoding =====
+//
+// Rows of the image are filtered in parallel (filters look only at the row above, which is taken from the
+// source image). Then the filtered data is split into strips, which are deflated in parallel into raw deflate
+// streams. All strips, but the last one, are ended with sync flush, so the streams can be simply concatenated
+// into one. Each strip is given 32K of data preceding it as dictionary, so compression ratio does not suffer
+// much. Finally, the zlib header and Adler-32 checksum (combined from strips' checksums) wrap the stream, which
+// is written as IDAT chunks - one per strip.
+
+// Compressed strip of filtered image data
+typedef struct _pngStrip
 {
-    png_structp ptrPng;
-    png_infop   ptrInfo;
-    png_color_8 sig_bit;
+    uint8_t*   data;
+    uint32_t   size;
+    uint32_t   adler;
+    XErrorCode error;
+}
+PngStrip;
 
-    FILE*       file = NULL;
-    XErrorCode  ret  = SuccessCode;
+// Write data to the file or memory destination
+static XErrorCode WritePngData( FILE* file, PngMemoryDestination* dest, const uint8_t* data, uint32_t length )
+{
+    XErrorCode ret = SuccessCode;
 
-    int         bitDepth, colorType;
-    int32_t     y;
-    png_bytep   rowPtr;
+    if ( file != NULL )
+    {
+        if ( fwrite( data, 1, length, file ) != length )
+        {
+            ret = ErrorIOFailure;
+        }
+    }
+    else
+    {
+        ret = AppendToMemoryDestination( dest, data, length );
+    }
 
-    if ( ( fileName == 0 ) || ( image == 0 ) )
+    return ret;
+}
+
+// Put 32 bit value in big endian byte order
+static void PutUInt32BE( uint8_t* ptr, uint32_t value )
+{
+    ptr[0] = (uint8_t) ( value >> 24 );
+    ptr[1] = (uint8_t) ( value >> 16 );
+    ptr[2] = (uint8_t) ( value >> 8 );
+    ptr[3] = (uint8_t) ( value );
+}
+
+// Write PNG chunk of the specified type
+static XErrorCode WritePngChunk( FILE* file, PngMemoryDestination* dest, const char* type, const uint8_t* data, uint32_t length )
+{
+    XErrorCode ret;
+    uint8_t    header[8];
+    uint8_t    crcBytes[4];
+    uLong      crc = crc32( 0, (const Bytef*) type, 4 );
+
+    if ( length != 0 )
     {
-        ret = ErrorNullParameter;
+        crc = crc32( crc, data, length );
     }
-    else if ( ( image->format != XPixelFormatGrayscale8 ) &&
-              ( image->format != XPixelFormatRGB24 ) &&
-              ( image->format != XPixelFormatRGBA32 ) &&
-              ( image->format != XPixelFormatBinary1 ) )
+
+    PutUInt32BE( header, length );
+    memcpy( header + 4, type, 4 );
+    PutUInt32BE( crcBytes, (uint32_t) crc );
+
+    ret = WritePngData( file, dest, header, 8 );
+
+    if ( ( ret == SuccessCode ) && ( length != 0 ) )
     {
-        ret = ErrorUnsupportedPixelFormat;
+        ret = WritePngData( file, dest, data, length );
     }
-    else
+    if ( ret == SuccessCode )
     {
-        // open image file
-        #ifdef WIN32
-            {
-                int charsRequired = MultiByteToWideChar( CP_UTF8, 0, fileName, -1, NULL, 0 );
+        ret = WritePngData( file, dest, crcBytes, 4 );
+    }
 
-                if ( charsRequired > 0 )
-                {
-                    WCHAR* filenameUtf16 = (WCHAR*) malloc( sizeof( WCHAR ) * charsRequired );
+    return ret;
+}
 
-                    if ( MultiByteToWideChar( CP_UTF8, 0, fileName, -1, filenameUtf16, charsRequired ) > 0 )
-                    {
-                        file = _wfopen( filenameUtf16, L"wb" );
-                    }
+// Paeth predictor
+static uint8_t PaethPredictor( int a, int b, int c )
+{
+    int p  = a + b - c;
+    int pa = abs( p - a );
+    int pb = abs( p - b );
+    int pc = abs( p - c );
 
-                    free( filenameUtf16 );
-                }
+    return (uint8_t) ( ( ( pa <= pb ) && ( pa <= pc ) ) ? a : ( ( pb <= pc ) ? b : c ) );
+}
+
+// Filter image row with the specified PNG filter (0-4); previous row is NULL for the first row of the image
+static void FilterPngRow( const uint8_t* row, const uint8_t* prev, uint32_t rowBytes, uint32_t bpp, int filterType, uint8_t* out )
+{
+    uint32_t i;
+
+    switch ( filterType )
+    {
+    case 1: // Sub
+        for ( i = 0; i < bpp; i++ )
+        {
+            out[i] = row[i];
+        }
+        for ( ; i < rowBytes; i++ )
+        {
+            out[i] = (uint8_t) ( row[i] - row[i - bpp] );
+        }
+        break;
+
+    case 2: // Up
+        if ( prev == NULL )
+        {
+            memcpy( out, row, rowBytes );
+        }
+        else
+        {
+            for ( i = 0; i < rowBytes; i++ )
+            {
+                out[i] = (uint8_t) ( row[i] - prev[i] );
             }
-        #else
-            file = fopen( fileName, "wb" );
-        #endif
+        }
+        break;
 
-        if ( file == NULL )
+    case 3: // Average
+        if ( prev == NULL )
         {
-            ret = ErrorIOFailure;
+            for ( i = 0; i < bpp; i++ )
+            {
+                out[i] = row[i];
+            }
+            for ( ; i < rowBytes; i++ )
+            {
+                out[i] = (uint8_t) ( row[i] - ( row[i - bpp] >> 1 ) );
+            }
         }
         else
         {
-            // 1 - Initialize structures and error handling
-            ptrPng  = png_create_write_struct( PNG_LIBPNG_VER_STRING, 0, 0, 0 );
-            ptrInfo = png_create_info_struct( ptrPng );
+            for ( i = 0; i < bpp; i++ )
+            {
+                out[i] = (uint8_t) ( row[i] - ( prev[i] >> 1 ) );
+            }
+            for ( ; i < rowBytes; i++ )
+            {
+                out[i] = (uint8_t) ( row[i] - ( ( row[i - bpp] + prev[i] ) >> 1 ) );
+            }
+        }
+        break;
 
-            if ( ( ptrPng == 0 ) || ( ptrInfo == 0 ) )
+    case 4: // Paeth
+        if ( prev == NULL )
+        {
+            // with zero row above, Paeth predictor is the same as Sub filter
+            FilterPngRow( row, prev, rowBytes, bpp, 1, out );
+        }
+        else
+        {
+            for ( i = 0; i < bpp; i++ )
             {
-                if ( ptrPng != 0 )
-                {
-                    png_destroy_read_struct( &ptrPng, 0, 0 );
-                }
-                ret = ErrorFailedImageEncoding;
+                out[i] = (uint8_t) ( row[i] - prev[i] );
+            }
+            for ( ; i < rowBytes; i++ )
+            {
+                out[i] = (uint8_t) ( row[i] - PaethPredictor( row[i - bpp], prev[i], prev[i - bpp] ) );
+            }
+        }
+        break;
+
+    default: // None
+        memcpy( out, row, rowBytes );
+        break;
+    }
+}
+
+// Sum of absolute values of filtered bytes (treated as signed) - same heuristic as libpng uses to choose filter
+static uint32_t SumOfAbsoluteValues( const uint8_t* data, uint32_t length )
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for ( i = 0; i < length; i++ )
+    {
+        sum += ( data[i] < 128 ) ? data[i] : 256 - data[i];
+    }
+
+    return sum;
+}
+
+// Deflate the specified strip of filtered data (dictionary is the data just before the strip)
+static void DeflatePngStrip( const uint8_t* data, uint32_t length, uint32_t dictionaryLength, int level, int strategy,
+                             bool isFirst, bool isLast, PngStrip* strip )
+{
+    z_stream zs;
+    uint32_t bound;
+    uint32_t prefix = ( isFirst ) ? 2 : 0;  // space for zlib header
+    uint32_t suffix = ( isLast  ) ? 4 : 0;  // space for Adler-32 checksum
+    int      zret;
+
+    memset( &zs, 0, sizeof( zs ) );
+    strip->error = ErrorFailedImageEncoding;
+
+    if ( deflateInit2( &zs, level, Z_DEFLATED, -15, 8, strategy ) == Z_OK )
+    {
+        if ( dictionaryLength != 0 )
+        {
+            deflateSetDictionary( &zs, data - dictionaryLength, dictionaryLength );
+        }
+
+        // sync flush adds up to 5 bytes over the bound of complete stream
+        bound       = (uint32_t) deflateBound( &zs, length ) + 16;
+        strip->data = (uint8_t*) malloc( prefix + bound + suffix );
+
+        if ( strip->data == 0 )
+        {
+            strip->error = ErrorOutOfMemory;
+        }
+        else
+        {
+            zs.next_in   = (Bytef*) data;
+            zs.avail_in  = length;
+            zs.next_out  = strip->data + prefix;
+            zs.avail_out = bound;
+
+            zret = deflate( &zs, ( isLast ) ? Z_FINISH : Z_SYNC_FLUSH );
+
+            if ( ( zs.avail_in == 0 ) && ( ( isLast ) ? ( zret == Z_STREAM_END ) : ( zret == Z_OK ) ) )
+            {
+                strip->size  = prefix + ( bound - zs.avail_out ) + suffix;
+                strip->adler = (uint32_t) adler32( adler32( 0, Z_NULL, 0 ), data, length );
+                strip->error = SuccessCode;
+            }
+        }
+
+        deflateEnd( &zs );
+    }
+}
+
+// Encode image as PNG splitting it into strips, which are compressed in parallel
+static XErrorCode EncodePngParallel( FILE* file, PngMemoryDestination* dest, const ximage* image, const xpngoptions* options, int stripsCount )
+{
+    XErrorCode ret       = SuccessCode;
+    int        width     = image->width;
+    int        height    = image->height;
+    int        stride    = image->stride;
+    int        level     = ( options->compressionLevel < 0 ) ? Z_DEFAULT_COMPRESSION : XMIN( options->compressionLevel, 9 );
+    int        strategy  = GetZlibStrategy( options );
+    int        filter    = ( options->filter <= PngFilter_Paeth ) ? options->filter : PngFilter_Adaptive;
+    uint8_t    bitDepth  = 8;
+    uint8_t    colorType = PNG_COLOR_TYPE_GRAY;
+    uint32_t   bpp       = 1;
+    uint32_t   rowBytes, filteredRowBytes;
+    int        rowsPerStrip, threadsCount, y, s;
+    uint8_t*   filtered  = 0;
+    uint8_t*   scratch   = 0;
+    PngStrip*  strips    = 0;
+
+    switch ( image->format )
+    {
+    case XPixelFormatRGB24:
+        colorType = PNG_COLOR_TYPE_RGB;
+        bpp       = 3;
+        break;
+    case XPixelFormatRGBA32:
+        colorType = PNG_COLOR_TYPE_RGB_ALPHA;
+        bpp       = 4;
+        break;
+    case XPixelFormatBinary1:
+        bitDepth  = 1;
+        break;
+    }
+
+    rowBytes         = ( (uint32_t) width * bpp * bitDepth + 7 ) / 8;
+    filteredRowBytes = rowBytes + 1;
+
+    rowsPerStrip = ( height + stripsCount - 1 ) / stripsCount;
+    stripsCount  = ( height + rowsPerStrip - 1 ) / rowsPerStrip;
+    threadsCount = omp_get_max_threads( );
+
+    filtered = (uint8_t*) malloc( (size_t) filteredRowBytes * height );
+    scratch  = ( filter == PngFilter_Adaptive ) ? (uint8_t*) malloc( (size_t) rowBytes * threadsCount ) : 0;
+    strips   = (PngStrip*) calloc( stripsCount, sizeof( PngStrip ) );
+
+    if ( ( filtered == 0 ) || ( strips == 0 ) || ( ( scratch == 0 ) && ( filter == PngFilter_Adaptive ) ) )
+    {
+        ret = ErrorOutOfMemory;
+    }
+    else
+    {
+        // 1 - filter all rows
+        #pragma omp parallel for schedule(static) shared( filtered, scratch, image, height, stride, rowBytes, filteredRowBytes, bpp, filter )
+        for ( y = 0; y < height; y++ )
+        {
+            const uint8_t* row  = image->data + (size_t) y * stride;
+            const uint8_t* prev = ( y == 0 ) ? NULL : row - stride;
+            uint8_t*       out  = filtered + (size_t) y * filteredRowBytes;
+
+            if ( filter != PngFilter_Adaptive )
+            {
+                out[0] = (uint8_t) ( filter - PngFilter_None );
+                FilterPngRow( row, prev, rowBytes, bpp, out[0], out + 1 );
             }
             else
             {
-                // set error handling
-                if ( setjmp( png_jmpbuf( ptrPng ) ) )
+                uint8_t* tmp     = scratch + (size_t) rowBytes * omp_get_thread_num( );
+                uint32_t minSum  = 0xFFFFFFFF;
+                uint32_t sum;
+                int      filterType;
+
+                for ( filterType = 0; filterType <= 4; filterType++ )
                 {
-                    png_destroy_write_struct( &ptrPng, &ptrInfo );
-                    fclose( file );
+                    FilterPngRow( row, prev, rowBytes, bpp, filterType, tmp );
+                    sum = SumOfAbsoluteValues( tmp, rowBytes );
 
-                    return ErrorFailedImageDecoding;
+                    if ( sum < minSum )
+                    {
+                        minSum = sum;
+                        out[0] = (uint8_t) filterType;
+                        memcpy( out + 1, tmp, rowBytes );
+                    }
                 }
+            }
+        }
 
-                // 2 - tell libpng which file to write to
-                png_init_io( ptrPng, file );
+        // 2 - deflate strips
+        #pragma omp parallel for schedule(dynamic, 1) shared( filtered, strips, height, rowsPerStrip, stripsCount, filteredRowBytes, level, strategy )
+        for ( s = 0; s < stripsCount; s++ )
+        {
+            uint32_t offset = (uint32_t) s * rowsPerStrip * filteredRowBytes;
+            uint32_t rows   = (uint32_t) XMIN( rowsPerStrip, height - s * rowsPerStrip );
 
-                // 3 - specify some image information
-                bitDepth = 8;
+            DeflatePngStrip( filtered + offset, rows * filteredRowBytes, XMIN( offset, 32768 ), level, strategy,
+                             ( s == 0 ), ( s == stripsCount - 1 ), &strips[s] );
+        }
 
-                if ( image->format == XPixelFormatGrayscale8 )
-                {
-                    colorType = PNG_COLOR_TYPE_GRAY;
-                    sig_bit.gray = 8;
-                }
-                else if ( image->format == XPixelFormatRGB24 )
-                {
-                    colorType = PNG_COLOR_TYPE_RGB;
-                    sig_bit.red   = 8;
-                    sig_bit.green = 8;
-                    sig_bit.blue  = 8;
-                }
-                else if ( image->format == XPixelFormatRGBA32 )
-                {
-                    colorType = PNG_COLOR_TYPE_RGB_ALPHA;
-                    sig_bit.red   = 8;
-                    sig_bit.green = 8;
-                    sig_bit.blue  = 8;
-                    sig_bit.alpha = 8;
-                }
-                else if ( image->format == XPixelFormatBinary1 )
-                {
-                    colorType = PNG_COLOR_TYPE_GRAY;
-                    sig_bit.gray = 1;
-                    bitDepth = 1;
-                }
-                else
-                {
-                    ret = ErrorUnsupportedPixelFormat;
-                }
+        for ( s = 0; ( s < stripsCount ) && ( ret == SuccessCode ); s++ )
+        {
+            ret = strips[s].error;
+        }
 
-                if ( ret == SuccessCode )
-                {
-                    png_set_IHDR( ptrPng, ptrInfo, image->width, image->height, bitDepth, colorType,
-                        PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE );
-                    png_set_sBIT( ptrPng, ptrInfo, &sig_bit );
+        if ( ret == SuccessCode )
+        {
+            static const uint8_t signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+            uint8_t  ihdr[13];
+            uint32_t adler = strips[0].adler;
+            uint32_t flevel;
+            uint32_t cmfFlg;
+
+            // 3 - wrap deflate stream into zlib's header and checksum
+            for ( s = 1; s < stripsCount; s++ )
+            {
+                uint32_t rows = (uint32_t) XMIN( rowsPerStrip, height - s * rowsPerStrip );
 
-                    // 4 - write the file header information
-                    png_write_info( ptrPng, ptrInfo );
+                adler = (uint32_t) adler32_combine( adler, strips[s].adler, (z_off_t) rows * filteredRowBytes );
+            }
 
-                    // 5 - some extra configuration
+            flevel = ( level == Z_DEFAULT_COMPRESSION ) ? 2 : ( ( level < 2 ) ? 0 : ( ( level < 6 ) ? 1 : ( ( level == 6 ) ? 2 : 3 ) ) );
+            cmfFlg = ( 0x78 << 8 ) | ( flevel << 6 );
+            cmfFlg += 31 - ( cmfFlg % 31 );
 
-                    // shift the pixels up to a legal bit depth and fill in as appropriate
-                    // to correctly scale the image
-                    png_set_shift( ptrPng, &sig_bit );
+            strips[0].data[0] = (uint8_t) ( cmfFlg >> 8 );
+            strips[0].data[1] = (uint8_t) ( cmfFlg );
+            PutUInt32BE( strips[stripsCount - 1].data + strips[stripsCount - 1].size - 4, adler );
 
-                    if ( image->format != XPixelFormatBinary1 )
-                    {
-                        // pack pixels into bytes
-                        png_set_packing( ptrPng );
-                    }
+            // 4 - write PNG signature and chunks
+            PutUInt32BE( ihdr, (uint32_t) width );
+            PutUInt32BE( ihdr + 4, (uint32_t) height );
+            ihdr[8]  = bitDepth;
+            ihdr[9]  = colorType;
+            ihdr[10] = 0;   // compression method
+            ihdr[11] = 0;   // filter method
+            ihdr[12] = 0;   // no interlace
 
-                    // 6 - write image
-                    for ( y = 0; y < image->height; y++ )
-                    {
-                        rowPtr = image->data + image->stride * y;
-                        png_write_rows( ptrPng, &rowPtr, 1 );
-                    }
+            ret = WritePngData( file, dest, signature, 8 );
 
-                    // 7 - write footer
-                    png_write_end( ptrPng, ptrInfo );
-                }
+            if ( ret == SuccessCode )
+            {
+                ret = WritePngChunk( file, dest, "IHDR", ihdr, 13 );
+            }
 
-                // 8 clean up
-                png_destroy_write_struct( &ptrPng, &ptrInfo );
+            for ( s = 0; ( s < stripsCount ) && ( ret == SuccessCode ); s++ )
+            {
+                ret = WritePngChunk( file, dest, "IDAT", strips[s].data, strips[s].size );
+            }
+
+            if ( ret == SuccessCode )
+            {
+                ret = WritePngChunk( file, dest, "IEND", 0, 0 );
             }
+        }
+    }
 
+    if ( strips != 0 )
+    {
+        for ( s = 0; s < stripsCount; s++ )
+        {
+            free( strips[s].data );
+        }
+        free( strips );
+    }
+
+    free( scratch );
+    free( filtered );
+
+    return ret;
+}
+
+// Check if the image can be encoded as PNG
+static XErrorCode CheckPngEncodingFormat( const ximage* image )
+{
+    return ( ( image->format != XPixelFormatGrayscale8 ) &&
+             ( image->format != XPixelFormatRGB24 ) &&
+             ( image->format != XPixelFormatRGBA32 ) &&
+             ( image->format != XPixelFormatBinary1 ) ) ? ErrorUnsupportedPixelFormat : SuccessCode;
+}
+
+// Encode image with libpng or in parallel strips, depending on options
+static XErrorCode EncodePngWithOptions( FILE* file, PngMemoryDestination* dest, const ximage* image, const xpngoptions* options )
+{
+    int stripsCount = 1;
+
+    if ( options != NULL )
+    {
+        stripsCount = ( options->stripsCount == XPNG_STRIPS_AUTO ) ? omp_get_num_procs( ) : options->stripsCount;
+        stripsCount = XMIN( stripsCount, image->height );
+    }
+
+    return ( stripsCount > 1 ) ? EncodePngParallel( file, dest, image, options, stripsCount ) :
+                                 EncodePng( file, dest, image, options );
+}
+
+// Encode image into the specified PNG file
+XErrorCode XEncodePng( const char* fileName, const ximage* image, const xpngoptions* options )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( fileName == 0 ) || ( image == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( ret = CheckPngEncodingFormat( image ) ) == SuccessCode )
+    {
+        FILE* file = OpenPngFile( fileName, 1 );
+
+        if ( file == NULL )
+        {
+            ret = ErrorIOFailure;
+        }
+        else
+        {
+            ret = EncodePngWithOptions( file, NULL, image, options );
             fclose( file );
         }
     }
 
     return ret;
 }
+
+// Encode image as PNG into the specified memory buffer
+XErrorCode XEncodePngToMemory( const ximage* image, const xpngoptions* options, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( image == 0 ) || ( buffer == 0 ) || ( bufferSize == 0 ) || ( encodedSize == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( ret = CheckPngEncodingFormat( image ) ) == SuccessCode )
+    {
+        PngMemoryDestination dest;
+
+        *encodedSize = 0;
+
+        // make sure there is a buffer to start with - half of the raw image size, since
+        // PNG compresses worse than JPEG
+        if ( ( *buffer == 0 ) || ( *bufferSize == 0 ) )
+        {
+            uint32_t initialSize = XMAX( 4096, (uint32_t) image->stride * image->height / 2 );
+
+            XFree( (void**) buffer );
+            *buffer     = (uint8_t*) XMAlloc( initialSize );
+            *bufferSize = ( *buffer != 0 ) ? initialSize : 0;
+        }
+
+        if ( *buffer == 0 )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            dest.buffer     = *buffer;
+            dest.bufferSize = *bufferSize;
+            dest.dataSize   = 0;
+            dest.error      = SuccessCode;
+
+            ret = EncodePngWithOptions( NULL, &dest, image, options );
+
+            // the buffer could have been re-allocated, even if encoding failed
+            *buffer     = dest.buffer;
+            *bufferSize = dest.bufferSize;
+
+            if ( ret == SuccessCode )
+            {
+                *encodedSize = dest.dataSize;
+            }
+        }
+    }
+
+    return ret;
+}
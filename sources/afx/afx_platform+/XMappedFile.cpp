@@ -0,0 +1,70 @@
+/*
+    Library to wrap some platform specific code of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XMappedFile.hpp"
+#include "internal/XMappedFileImpl.hpp"
+
+namespace CVSandbox
+{
+
+XMappedFile::XMappedFile( ) :
+    mImpl( new Private::XMappedFileImpl( ) )
+{
+}
+
+XMappedFile::~XMappedFile( )
+{
+    mImpl->Close( );
+    delete mImpl;
+}
+
+// Open the file and map its content into memory
+bool XMappedFile::Open( const std::string& fileName )
+{
+    mImpl->Close( );
+    return mImpl->Open( fileName );
+}
+
+// Unmap and close the file
+void XMappedFile::Close( )
+{
+    mImpl->Close( );
+}
+
+// Check if the file is open
+bool XMappedFile::IsOpen( ) const
+{
+    return ( mImpl->Data( ) != nullptr );
+}
+
+// Get pointer to the mapped content of the file
+const uint8_t* XMappedFile::Data( ) const
+{
+    return static_cast<const uint8_t*>( mImpl->Data( ) );
+}
+
+// Get size of the mapped file
+size_t XMappedFile::Size( ) const
+{
+    return mImpl->Size( );
+}
+
+} // namespace CVSandbox
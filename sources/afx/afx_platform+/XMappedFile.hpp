@@ -0,0 +1,63 @@
+/*
+    Library to wrap some platform specific code of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XMAPPED_FILE_HPP
+#define CVS_XMAPPED_FILE_HPP
+
+#include <stdint.h>
+#include <string>
+#include <XInterfaces.hpp>
+
+namespace CVSandbox
+{
+
+namespace Private
+{
+    class XMappedFileImpl;
+}
+
+// Read-only memory mapping of a file
+class XMappedFile : private Uncopyable
+{
+public:
+    XMappedFile( );
+    ~XMappedFile( );
+
+    // Open the file (UTF8 name) and map its entire content into memory
+    bool Open( const std::string& fileName );
+    // Unmap and close the file
+    void Close( );
+
+    // Check if the file is open
+    bool IsOpen( ) const;
+    // Get pointer to the mapped content of the file
+    const uint8_t* Data( ) const;
+    // Get size of the mapped file
+    size_t Size( ) const;
+
+private:
+    Private::XMappedFileImpl* mImpl;
+};
+
+} // namespace CVSandbox
+
+#endif // CVS_XMAPPED_FILE_HPP
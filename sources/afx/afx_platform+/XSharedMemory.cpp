@@ -0,0 +1,77 @@
+/*
+    Library to wrap some platform specific code of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XSharedMemory.hpp"
+#include "internal/XSharedMemoryImpl.hpp"
+
+namespace CVSandbox
+{
+
+XSharedMemory::XSharedMemory( ) :
+    mImpl( new Private::XSharedMemoryImpl( ) )
+{
+}
+
+XSharedMemory::~XSharedMemory( )
+{
+    mImpl->Close( );
+    delete mImpl;
+}
+
+// Create shared memory block of the specified size
+bool XSharedMemory::Create( const std::string& name, size_t size )
+{
+    mImpl->Close( );
+    return mImpl->Create( name, size );
+}
+
+// Open shared memory block created by another process
+bool XSharedMemory::Open( const std::string& name )
+{
+    mImpl->Close( );
+    return mImpl->Open( name );
+}
+
+// Close shared memory block
+void XSharedMemory::Close( )
+{
+    mImpl->Close( );
+}
+
+// Check if shared memory block is open
+bool XSharedMemory::IsOpen( ) const
+{
+    return ( mImpl->Data( ) != nullptr );
+}
+
+// Get pointer to the mapped memory
+void* XSharedMemory::Data( ) const
+{
+    return mImpl->Data( );
+}
+
+// Get size of the mapped memory
+size_t XSharedMemory::Size( ) const
+{
+    return mImpl->Size( );
+}
+
+} // namespace CVSandbox
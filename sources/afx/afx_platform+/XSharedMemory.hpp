@@ -0,0 +1,67 @@
+/*
+    Library to wrap some platform specific code of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XSHARED_MEMORY_HPP
+#define CVS_XSHARED_MEMORY_HPP
+
+#include <stdint.h>
+#include <string>
+#include <XInterfaces.hpp>
+
+namespace CVSandbox
+{
+
+namespace Private
+{
+    class XSharedMemoryImpl;
+}
+
+// Named block of memory, which can be mapped by several processes
+class XSharedMemory : private Uncopyable
+{
+public:
+    XSharedMemory( );
+    ~XSharedMemory( );
+
+    // Create shared memory block of the specified size (the block is removed from the system on close,
+    // but processes which opened it keep their mapping till they close it as well). On POSIX systems a stale
+    // block with the same name is replaced by a new one, while its existing mappings are left untouched.
+    bool Create( const std::string& name, size_t size );
+    // Open shared memory block created by another process (or another instance of the class)
+    bool Open( const std::string& name );
+    // Close shared memory block, unmapping it from the process
+    void Close( );
+
+    // Check if shared memory block is open
+    bool IsOpen( ) const;
+    // Get pointer to the mapped memory
+    void* Data( ) const;
+    // Get size of the mapped memory (may be rounded up to page size for opened blocks)
+    size_t Size( ) const;
+
+private:
+    Private::XSharedMemoryImpl* mImpl;
+};
+
+} // namespace CVSandbox
+
+#endif // CVS_XSHARED_MEMORY_HPP
@@ -63,6 +63,36 @@ void XThread::Terminate( )
     pimpl->Terminate( );
 }
 
+// Get/Set name of the thread
+std::string XThread::Name( ) const
+{
+    return pimpl->Name( );
+}
+bool XThread::SetName( const std::string& name )
+{
+    return pimpl->SetName( name );
+}
+
+// Get/Set mask of CPUs the thread is allowed to run on
+uint64_t XThread::Affinity( ) const
+{
+    return pimpl->Affinity( );
+}
+bool XThread::SetAffinity( uint64_t cpuMask )
+{
+    return pimpl->SetAffinity( cpuMask );
+}
+
+// Get/Set scheduling priority of the thread
+XThreadPriority XThread::Priority( ) const
+{
+    return pimpl->Priority( );
+}
+bool XThread::SetPriority( XThreadPriority priority )
+{
+    return pimpl->SetPriority( priority );
+}
+
 // Put current thread into sleep state for the specified amount of time
 void XThread::Sleep( uint32_t msec )
 {
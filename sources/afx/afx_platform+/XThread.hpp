@@ -24,6 +24,7 @@
 #define CVS_XTHREAD_HPP
 
 #include <stdint.h>
+#include <string>
 #include <XInterfaces.hpp>
 
 namespace CVSandbox { namespace Threading {
@@ -36,6 +37,18 @@ namespace Private
 // Thread function's type
 typedef void (*XThreadFunction)( void* );
 
+// Scheduling priority of a thread
+enum class XThreadPriority
+{
+    Idle = 0,       // run only when CPU has nothing else to do
+    Lowest,
+    BelowNormal,
+    Normal,
+    AboveNormal,
+    Highest,        // real time scheduling on POSIX systems (requires privileges)
+    TimeCritical    // real time scheduling with maximum priority
+};
+
 // Thread managing class
 class XThread : public Uncopyable
 {
@@ -55,6 +68,20 @@ public:
     // Terminate the thread (try to avoid using it ever - too dangerous)
     void Terminate( );
 
+    // Name, CPU affinity and priority of the thread. They can be set before the thread is created,
+    // in which case they are applied when it starts, or for the running thread. Set methods return
+    // false if the running thread could not be updated (or the platform does not support it).
+
+    // Get/Set name of the thread to show in debuggers/profilers (only first 15 characters are used on Linux)
+    std::string Name( ) const;
+    bool SetName( const std::string& name );
+    // Get/Set mask of CPUs the thread is allowed to run on (bit N is for CPU N, 0 - any CPU)
+    uint64_t Affinity( ) const;
+    bool SetAffinity( uint64_t cpuMask );
+    // Get/Set scheduling priority of the thread
+    XThreadPriority Priority( ) const;
+    bool SetPriority( XThreadPriority priority );
+
 public:
     // Put current thread into sleep state for the specified amount of time
     static void Sleep( uint32_t msec );
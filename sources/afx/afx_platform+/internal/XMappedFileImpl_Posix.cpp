@@ -0,0 +1,111 @@
+/*
+    Library to wrap some platform specific code of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XMappedFileImpl.hpp"
+
+// Read-only file mapping implementation using POSIX mmap()
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace CVSandbox { namespace Private
+{
+
+class XMappedFileImplData
+{
+public:
+    void*   Memory;
+    size_t  Size;
+};
+
+XMappedFileImpl::XMappedFileImpl( ) :
+    mData( new XMappedFileImplData( ) )
+{
+    mData->Memory = nullptr;
+    mData->Size   = 0;
+}
+
+XMappedFileImpl::~XMappedFileImpl( )
+{
+    Close( );
+    delete mData;
+}
+
+// Open the file and map it
+bool XMappedFileImpl::Open( const std::string& fileName )
+{
+    int  fd  = open( fileName.c_str( ), O_RDONLY );
+    bool ret = false;
+
+    if ( fd != -1 )
+    {
+        struct stat info;
+
+        // empty files can not be mapped
+        if ( ( fstat( fd, &info ) == 0 ) && ( info.st_size > 0 ) )
+        {
+            size_t size   = static_cast<size_t>( info.st_size );
+            void*  memory = mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+
+            if ( memory != MAP_FAILED )
+            {
+                // frames are mostly read sequentially
+                madvise( memory, size, MADV_SEQUENTIAL );
+
+                mData->Memory = memory;
+                mData->Size   = size;
+                ret = true;
+            }
+        }
+
+        // mapping stays valid after closing the descriptor
+        close( fd );
+    }
+
+    return ret;
+}
+
+// Unmap and close the file
+void XMappedFileImpl::Close( )
+{
+    if ( mData->Memory != nullptr )
+    {
+        munmap( mData->Memory, mData->Size );
+
+        mData->Memory = nullptr;
+        mData->Size   = 0;
+    }
+}
+
+// Get pointer to the mapped memory
+const void* XMappedFileImpl::Data( ) const
+{
+    return mData->Memory;
+}
+
+// Get size of the mapped memory
+size_t XMappedFileImpl::Size( ) const
+{
+    return mData->Size;
+}
+
+} } // namespace CVSandbox::Private
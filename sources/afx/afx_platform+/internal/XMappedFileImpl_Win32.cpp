@@ -0,0 +1,142 @@
+/*
+    Library to wrap some platform specific code of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XMappedFileImpl.hpp"
+
+// Read-only file mapping implementation using Win32 file mapping objects
+#include <windows.h>
+#include <stdint.h>
+
+namespace CVSandbox { namespace Private
+{
+
+class XMappedFileImplData
+{
+public:
+    HANDLE      File;
+    HANDLE      Mapping;
+    const void* Memory;
+    size_t      Size;
+};
+
+XMappedFileImpl::XMappedFileImpl( ) :
+    mData( new XMappedFileImplData( ) )
+{
+    mData->File    = INVALID_HANDLE_VALUE;
+    mData->Mapping = NULL;
+    mData->Memory  = nullptr;
+    mData->Size    = 0;
+}
+
+XMappedFileImpl::~XMappedFileImpl( )
+{
+    Close( );
+    delete mData;
+}
+
+// Open the file and map it
+bool XMappedFileImpl::Open( const std::string& fileName )
+{
+    HANDLE file = INVALID_HANDLE_VALUE;
+    bool   ret  = false;
+    int    charsRequired = MultiByteToWideChar( CP_UTF8, 0, fileName.c_str( ), -1, NULL, 0 );
+
+    if ( charsRequired > 0 )
+    {
+        WCHAR* fileNameUtf16 = new WCHAR[charsRequired];
+
+        if ( MultiByteToWideChar( CP_UTF8, 0, fileName.c_str( ), -1, fileNameUtf16, charsRequired ) > 0 )
+        {
+            // allow others to keep writing the file, so it can be viewed while it is still being recorded
+            file = CreateFileW( fileNameUtf16, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+        }
+
+        delete [] fileNameUtf16;
+    }
+
+    if ( file != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER fileSize;
+
+        // empty files can not be mapped
+        if ( ( GetFileSizeEx( file, &fileSize ) ) && ( fileSize.QuadPart > 0 ) &&
+             ( static_cast<uint64_t>( fileSize.QuadPart ) <= static_cast<uint64_t>( SIZE_MAX ) ) )
+        {
+            HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+            if ( mapping != NULL )
+            {
+                const void* memory = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+
+                if ( memory != nullptr )
+                {
+                    mData->File    = file;
+                    mData->Mapping = mapping;
+                    mData->Memory  = memory;
+                    mData->Size    = static_cast<size_t>( fileSize.QuadPart );
+                    ret = true;
+                }
+                else
+                {
+                    CloseHandle( mapping );
+                }
+            }
+        }
+
+        if ( !ret )
+        {
+            CloseHandle( file );
+        }
+    }
+
+    return ret;
+}
+
+// Unmap and close the file
+void XMappedFileImpl::Close( )
+{
+    if ( mData->Memory != nullptr )
+    {
+        UnmapViewOfFile( mData->Memory );
+        CloseHandle( mData->Mapping );
+        CloseHandle( mData->File );
+
+        mData->File    = INVALID_HANDLE_VALUE;
+        mData->Mapping = NULL;
+        mData->Memory  = nullptr;
+        mData->Size    = 0;
+    }
+}
+
+// Get pointer to the mapped memory
+const void* XMappedFileImpl::Data( ) const
+{
+    return mData->Memory;
+}
+
+// Get size of the mapped memory
+size_t XMappedFileImpl::Size( ) const
+{
+    return mData->Size;
+}
+
+} } // namespace CVSandbox::Private
@@ -0,0 +1,59 @@
+/*
+    Library to wrap some platform specific code of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XSHARED_MEMORY_IMPL_HPP
+#define CVS_XSHARED_MEMORY_IMPL_HPP
+
+#include <stddef.h>
+#include <string>
+
+namespace CVSandbox { namespace Private
+{
+
+class XSharedMemoryImplData;
+
+// Platform specific implementation of named shared memory
+class XSharedMemoryImpl
+{
+public:
+    XSharedMemoryImpl( );
+    ~XSharedMemoryImpl( );
+
+    // Create shared memory block of the specified size and map it
+    bool Create( const std::string& name, size_t size );
+    // Open existing shared memory block and map it
+    bool Open( const std::string& name );
+    // Unmap and close shared memory block
+    void Close( );
+
+    // Get pointer to the mapped memory
+    void* Data( ) const;
+    // Get size of the mapped memory
+    size_t Size( ) const;
+
+private:
+    XSharedMemoryImplData* mData;
+};
+
+} } // namespace CVSandbox::Private
+
+#endif // CVS_XSHARED_MEMORY_IMPL_HPP
@@ -0,0 +1,187 @@
+/*
+    Library to wrap some platform specific code of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XSharedMemoryImpl.hpp"
+
+// Named shared memory implementation using POSIX shm_open() and mmap()
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace CVSandbox { namespace Private
+{
+
+class XSharedMemoryImplData
+{
+public:
+    std::string Name;
+    void*       Memory;
+    size_t      Size;
+    bool        IsOwner;
+    dev_t       Device;
+    ino_t       Inode;
+};
+
+// POSIX names of shared memory objects must start with slash
+static std::string PosixSharedMemoryName( const std::string& name )
+{
+    return ( ( !name.empty( ) ) && ( name[0] == '/' ) ) ? name : "/" + name;
+}
+
+XSharedMemoryImpl::XSharedMemoryImpl( ) :
+    mData( new XSharedMemoryImplData( ) )
+{
+    mData->Memory  = nullptr;
+    mData->Size    = 0;
+    mData->IsOwner = false;
+    mData->Device  = 0;
+    mData->Inode   = 0;
+}
+
+XSharedMemoryImpl::~XSharedMemoryImpl( )
+{
+    Close( );
+    delete mData;
+}
+
+// Create shared memory block of the specified size and map it
+bool XSharedMemoryImpl::Create( const std::string& name, size_t size )
+{
+    std::string posixName = PosixSharedMemoryName( name );
+    bool        ret       = false;
+    int         fd;
+
+    // an object left by a crashed writer must not be resized while others may still have it mapped, so the
+    // name is unlinked first (existing mappings stay valid) and a new object is created; if another creator
+    // takes the name in between, then this call fails instead of attaching to someone else's memory
+    shm_unlink( posixName.c_str( ) );
+    fd = shm_open( posixName.c_str( ), O_RDWR | O_CREAT | O_EXCL, 0666 );
+
+    if ( fd != -1 )
+    {
+        struct stat info;
+
+        if ( ( fstat( fd, &info ) == 0 ) && ( ftruncate( fd, static_cast<off_t>( size ) ) == 0 ) )
+        {
+            void* memory = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+
+            if ( memory != MAP_FAILED )
+            {
+                mData->Name    = posixName;
+                mData->Memory  = memory;
+                mData->Size    = size;
+                mData->IsOwner = true;
+                mData->Device  = info.st_dev;
+                mData->Inode   = info.st_ino;
+                ret = true;
+            }
+        }
+
+        // mapping stays valid after closing the descriptor
+        close( fd );
+
+        // the object was created by this call, so nobody else uses it yet
+        if ( !ret )
+        {
+            shm_unlink( posixName.c_str( ) );
+        }
+    }
+
+    return ret;
+}
+
+// Open existing shared memory block and map it
+bool XSharedMemoryImpl::Open( const std::string& name )
+{
+    std::string posixName = PosixSharedMemoryName( name );
+    int         fd        = shm_open( posixName.c_str( ), O_RDWR, 0 );
+    bool        ret       = false;
+
+    if ( fd != -1 )
+    {
+        struct stat info;
+
+        if ( ( fstat( fd, &info ) == 0 ) && ( info.st_size > 0 ) )
+        {
+            size_t size   = static_cast<size_t>( info.st_size );
+            void*  memory = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+
+            if ( memory != MAP_FAILED )
+            {
+                mData->Name    = posixName;
+                mData->Memory  = memory;
+                mData->Size    = size;
+                mData->IsOwner = false;
+                ret = true;
+            }
+        }
+
+        close( fd );
+    }
+
+    return ret;
+}
+
+// Unmap and close shared memory block
+void XSharedMemoryImpl::Close( )
+{
+    if ( mData->Memory != nullptr )
+    {
+        munmap( mData->Memory, mData->Size );
+
+        if ( mData->IsOwner )
+        {
+            // the name is removed only if it still refers to the object created by this instance
+            int fd = shm_open( mData->Name.c_str( ), O_RDONLY, 0 );
+
+            if ( fd != -1 )
+            {
+                struct stat info;
+
+                if ( ( fstat( fd, &info ) == 0 ) && ( info.st_dev == mData->Device ) && ( info.st_ino == mData->Inode ) )
+                {
+                    shm_unlink( mData->Name.c_str( ) );
+                }
+
+                close( fd );
+            }
+        }
+
+        mData->Memory  = nullptr;
+        mData->Size    = 0;
+        mData->IsOwner = false;
+    }
+}
+
+// Get pointer to the mapped memory
+void* XSharedMemoryImpl::Data( ) const
+{
+    return mData->Memory;
+}
+
+// Get size of the mapped memory
+size_t XSharedMemoryImpl::Size( ) const
+{
+    return mData->Size;
+}
+
+} } // namespace CVSandbox::Private
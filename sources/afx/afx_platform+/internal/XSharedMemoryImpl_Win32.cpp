@@ -0,0 +1,150 @@
+/*
+    Library to wrap some platform specific code of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XSharedMemoryImpl.hpp"
+
+// Named shared memory implementation using Win32 file mapping objects
+#include <windows.h>
+
+namespace CVSandbox { namespace Private
+{
+
+class XSharedMemoryImplData
+{
+public:
+    HANDLE  Mapping;
+    void*   Memory;
+    size_t  Size;
+};
+
+XSharedMemoryImpl::XSharedMemoryImpl( ) :
+    mData( new XSharedMemoryImplData( ) )
+{
+    mData->Mapping = NULL;
+    mData->Memory  = nullptr;
+    mData->Size    = 0;
+}
+
+XSharedMemoryImpl::~XSharedMemoryImpl( )
+{
+    Close( );
+    delete mData;
+}
+
+// Create shared memory block of the specified size and map it
+bool XSharedMemoryImpl::Create( const std::string& name, size_t size )
+{
+    uint64_t size64  = static_cast<uint64_t>( size );
+    HANDLE   mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                           static_cast<DWORD>( size64 >> 32 ), static_cast<DWORD>( size64 ),
+                                           name.c_str( ) );
+    bool     ret     = false;
+
+    if ( mapping != NULL )
+    {
+        // the mapping may still exist if some process keeps it open, so need to check it is big enough
+        bool  alreadyExists = ( GetLastError( ) == ERROR_ALREADY_EXISTS );
+        void* memory        = MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, ( alreadyExists ) ? 0 : size );
+
+        if ( ( memory != nullptr ) && ( alreadyExists ) )
+        {
+            MEMORY_BASIC_INFORMATION info;
+
+            if ( ( VirtualQuery( memory, &info, sizeof( info ) ) == 0 ) || ( info.RegionSize < size ) )
+            {
+                UnmapViewOfFile( memory );
+                memory = nullptr;
+            }
+        }
+
+        if ( memory != nullptr )
+        {
+            mData->Mapping = mapping;
+            mData->Memory  = memory;
+            mData->Size    = size;
+            ret = true;
+        }
+        else
+        {
+            CloseHandle( mapping );
+        }
+    }
+
+    return ret;
+}
+
+// Open existing shared memory block and map it
+bool XSharedMemoryImpl::Open( const std::string& name )
+{
+    HANDLE mapping = OpenFileMappingA( FILE_MAP_ALL_ACCESS, FALSE, name.c_str( ) );
+    bool   ret     = false;
+
+    if ( mapping != NULL )
+    {
+        void* memory = MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0 );
+
+        if ( memory != nullptr )
+        {
+            MEMORY_BASIC_INFORMATION info;
+
+            VirtualQuery( memory, &info, sizeof( info ) );
+
+            mData->Mapping = mapping;
+            mData->Memory  = memory;
+            mData->Size    = info.RegionSize;
+            ret = true;
+        }
+        else
+        {
+            CloseHandle( mapping );
+        }
+    }
+
+    return ret;
+}
+
+// Unmap and close shared memory block
+void XSharedMemoryImpl::Close( )
+{
+    if ( mData->Memory != nullptr )
+    {
+        UnmapViewOfFile( mData->Memory );
+        CloseHandle( mData->Mapping );
+
+        mData->Mapping = NULL;
+        mData->Memory  = nullptr;
+        mData->Size    = 0;
+    }
+}
+
+// Get pointer to the mapped memory
+void* XSharedMemoryImpl::Data( ) const
+{
+    return mData->Memory;
+}
+
+// Get size of the mapped memory
+size_t XSharedMemoryImpl::Size( ) const
+{
+    return mData->Size;
+}
+
+} } // namespace CVSandbox::Private
@@ -48,6 +48,16 @@ public:
     // Terminate the thread (try to avoid using it ever - too dangerous)
     void Terminate( );
 
+    // Get/Set name of the thread
+    std::string Name( ) const;
+    bool SetName( const std::string& name );
+    // Get/Set mask of CPUs the thread is allowed to run on
+    uint64_t Affinity( ) const;
+    bool SetAffinity( uint64_t cpuMask );
+    // Get/Set scheduling priority of the thread
+    XThreadPriority Priority( ) const;
+    bool SetPriority( XThreadPriority priority );
+
 public:
     // Put current thread into sleep state for the specified amount of time
     static void Sleep( uint32_t msec );
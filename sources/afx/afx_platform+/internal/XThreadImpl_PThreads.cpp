@@ -26,8 +26,15 @@
 #include <assert.h>
 
 #include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 #include <time.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#ifdef __linux__
+    #include <sys/syscall.h>
+#endif
 
 // Thread management implementation using POSIX PThreads (thread + mutex + condition variable)
 
@@ -40,6 +47,10 @@ class XThreadImplData
 public:
     static void* WorkerThread( void* threadid );
 
+    static bool ApplyName( pthread_t thread, const std::string& name );
+    static bool ApplyAffinity( pthread_t thread, uint64_t cpuMask );
+    static bool ApplyPriority( pthread_t thread, pid_t tid, XThreadPriority priority );
+
 public:
     pthread_t       Thread;
     pthread_mutex_t Mutex;
@@ -50,14 +61,22 @@ public:
 
     uint32_t        Counter;
     bool            IsRunning;
+
+    std::string     Name;
+    uint64_t        AffinityMask;
+    XThreadPriority Priority;
+    pid_t           Tid;            // kernel's ID of the running thread (needed to set its nice value), 0 till it starts
 };
 
 XThreadImpl::XThreadImpl( ) :
     mData( new XThreadImplData( ) )
 {
-    mData->IsRunning = false;
-    mData->Counter   = 0;
-    mData->Thread    = 0;
+    mData->IsRunning    = false;
+    mData->Counter      = 0;
+    mData->Thread       = 0;
+    mData->AffinityMask = 0;
+    mData->Priority     = XThreadPriority::Normal;
+    mData->Tid          = 0;
 
     int e1 = pthread_mutex_init( &mData->Mutex, 0 );
     int e2 = pthread_cond_init( &mData->Cond, 0 );
@@ -89,6 +108,7 @@ bool XThreadImpl::Create( XThreadFunction callback, void* param )
     {
         mData->UserCallback = callback;
         mData->UserParam    = param;
+        mData->Tid          = 0;
 
         mData->IsRunning = ( pthread_create( &mData->Thread, 0, XThreadImplData::WorkerThread, mData ) == 0 );
         ret = mData->IsRunning;
@@ -184,10 +204,220 @@ void XThreadImpl::Terminate( )
     pthread_mutex_unlock( &mData->Mutex );
 }
 
+// Get/Set name of the thread
+std::string XThreadImpl::Name( ) const
+{
+    pthread_mutex_lock( &mData->Mutex );
+    std::string ret = mData->Name;
+    pthread_mutex_unlock( &mData->Mutex );
+
+    return ret;
+}
+bool XThreadImpl::SetName( const std::string& name )
+{
+    pthread_mutex_lock( &mData->Mutex );
+    bool ret = true;
+
+    mData->Name = name;
+
+    // the thread applies settings itself when it starts, so only the one which did can be updated
+    if ( ( mData->IsRunning ) && ( mData->Tid != 0 ) )
+    {
+        ret = XThreadImplData::ApplyName( mData->Thread, name );
+    }
+
+    pthread_mutex_unlock( &mData->Mutex );
+    return ret;
+}
+
+// Get/Set mask of CPUs the thread is allowed to run on
+uint64_t XThreadImpl::Affinity( ) const
+{
+    pthread_mutex_lock( &mData->Mutex );
+    uint64_t ret = mData->AffinityMask;
+    pthread_mutex_unlock( &mData->Mutex );
+
+    return ret;
+}
+bool XThreadImpl::SetAffinity( uint64_t cpuMask )
+{
+    pthread_mutex_lock( &mData->Mutex );
+    bool ret = true;
+
+    mData->AffinityMask = cpuMask;
+
+    if ( ( mData->IsRunning ) && ( mData->Tid != 0 ) )
+    {
+        ret = XThreadImplData::ApplyAffinity( mData->Thread, cpuMask );
+    }
+
+    pthread_mutex_unlock( &mData->Mutex );
+    return ret;
+}
+
+// Get/Set scheduling priority of the thread
+XThreadPriority XThreadImpl::Priority( ) const
+{
+    pthread_mutex_lock( &mData->Mutex );
+    XThreadPriority ret = mData->Priority;
+    pthread_mutex_unlock( &mData->Mutex );
+
+    return ret;
+}
+bool XThreadImpl::SetPriority( XThreadPriority priority )
+{
+    pthread_mutex_lock( &mData->Mutex );
+    bool ret = true;
+
+    mData->Priority = priority;
+
+    if ( ( mData->IsRunning ) && ( mData->Tid != 0 ) )
+    {
+        ret = XThreadImplData::ApplyPriority( mData->Thread, mData->Tid, priority );
+    }
+
+    pthread_mutex_unlock( &mData->Mutex );
+    return ret;
+}
+
+// Set name of the specified thread
+bool XThreadImplData::ApplyName( pthread_t thread, const std::string& name )
+{
+#ifdef __linux__
+    // Linux limits names to 16 characters including the terminating zero
+    return ( pthread_setname_np( thread, name.substr( 0, 15 ).c_str( ) ) == 0 );
+#else
+    XUNREFERENCED_PARAMETER( thread );
+    XUNREFERENCED_PARAMETER( name );
+    return false;
+#endif
+}
+
+// Set mask of CPUs the specified thread is allowed to run on
+bool XThreadImplData::ApplyAffinity( pthread_t thread, uint64_t cpuMask )
+{
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    int       i;
+
+    CPU_ZERO( &cpuSet );
+
+    if ( cpuMask == 0 )
+    {
+        // let the thread run on any CPU
+        for ( i = 0; i < CPU_SETSIZE; i++ )
+        {
+            CPU_SET( i, &cpuSet );
+        }
+    }
+    else
+    {
+        for ( i = 0; i < 64; i++ )
+        {
+            if ( ( cpuMask & ( (uint64_t) 1 << i ) ) != 0 )
+            {
+                CPU_SET( i, &cpuSet );
+            }
+        }
+    }
+
+    return ( pthread_setaffinity_np( thread, sizeof( cpuSet ), &cpuSet ) == 0 );
+#else
+    XUNREFERENCED_PARAMETER( thread );
+    XUNREFERENCED_PARAMETER( cpuMask );
+    return false;
+#endif
+}
+
+// Set scheduling priority of the specified thread. Priorities up to above normal use time sharing
+// scheduling policy and are set as thread's nice value (raising it above normal needs privileges),
+// while highest/time critical priorities use real time policies.
+bool XThreadImplData::ApplyPriority( pthread_t thread, pid_t tid, XThreadPriority priority )
+{
+    struct sched_param schedParam;
+    int                policy    = SCHED_OTHER;
+    int                niceValue = 0;
+    bool               ret;
+
+    memset( &schedParam, 0, sizeof( schedParam ) );
+
+    switch ( priority )
+    {
+    case XThreadPriority::Idle:
+#ifdef SCHED_IDLE
+        policy    = SCHED_IDLE;
+#else
+        niceValue = 19;
+#endif
+        break;
+    case XThreadPriority::Lowest:
+        niceValue = 19;
+        break;
+    case XThreadPriority::BelowNormal:
+        niceValue = 10;
+        break;
+    case XThreadPriority::AboveNormal:
+        niceValue = -10;
+        break;
+    case XThreadPriority::Highest:
+        policy = SCHED_RR;
+        schedParam.sched_priority = ( sched_get_priority_min( SCHED_RR ) + sched_get_priority_max( SCHED_RR ) ) / 2;
+        break;
+    case XThreadPriority::TimeCritical:
+        policy = SCHED_FIFO;
+        schedParam.sched_priority = sched_get_priority_max( SCHED_FIFO );
+        break;
+    default:
+        break;
+    }
+
+    ret = ( pthread_setschedparam( thread, policy, &schedParam ) == 0 );
+
+    if ( ( ret ) && ( policy == SCHED_OTHER ) )
+    {
+#ifdef __linux__
+        // nice value is per thread on Linux
+        ret = ( setpriority( PRIO_PROCESS, static_cast<id_t>( tid ), niceValue ) == 0 );
+#else
+        // other systems keep nice value per process, so setting it would change priority of all threads
+        XUNREFERENCED_PARAMETER( tid );
+        ret = ( niceValue == 0 );
+#endif
+    }
+
+    return ret;
+}
+
 // Platform specific thread's worker function
 void* XThreadImplData::WorkerThread( void* param )
 {
     XThreadImplData* myData = (XThreadImplData*) param;
+
+    // apply settings, which were set before the thread was started
+    pthread_mutex_lock( &myData->Mutex );
+
+#ifdef __linux__
+    myData->Tid = static_cast<pid_t>( syscall( SYS_gettid ) );
+#else
+    // there is no kernel ID of a thread to use, but it still marks the thread as started
+    myData->Tid = getpid( );
+#endif
+
+    if ( !myData->Name.empty( ) )
+    {
+        ApplyName( pthread_self( ), myData->Name );
+    }
+    if ( myData->AffinityMask != 0 )
+    {
+        ApplyAffinity( pthread_self( ), myData->AffinityMask );
+    }
+    if ( myData->Priority != XThreadPriority::Normal )
+    {
+        ApplyPriority( pthread_self( ), myData->Tid, myData->Priority );
+    }
+
+    pthread_mutex_unlock( &myData->Mutex );
+
     myData->UserCallback( myData->UserParam );
 
     // update status and notify anyone who may wait
@@ -198,6 +428,8 @@ void* XThreadImplData::WorkerThread( void* param )
     pthread_cond_broadcast( &myData->Cond );
 
     pthread_mutex_unlock( &myData->Mutex );
+
+    return 0;
 }
 
 // Put current thread into sleep state for the specified amount of time
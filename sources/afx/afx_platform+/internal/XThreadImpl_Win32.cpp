@@ -32,11 +32,18 @@ namespace CVSandbox { namespace Threading { namespace Private {
 
 using namespace CVSandbox::Threading;
 
+// SetThreadDescription() is available starting from Windows 10 (1607), so it is resolved at run time
+typedef HRESULT ( WINAPI *SetThreadDescriptionProc )( HANDLE hThread, PCWSTR lpThreadDescription );
+
 class XThreadImplData
 {
 public:
     static DWORD WINAPI WorkerThread( LPVOID lpParam );
 
+    static bool ApplyName( HANDLE thread, const std::string& name );
+    static bool ApplyAffinity( HANDLE thread, uint64_t cpuMask );
+    static bool ApplyPriority( HANDLE thread, XThreadPriority priority );
+
 public:
     HANDLE          Thread;
     XThreadFunction UserCallback;
@@ -44,13 +51,19 @@ public:
 
     bool            IsRunning;
     XMutex          Sync;
+
+    std::string     Name;
+    uint64_t        AffinityMask;
+    XThreadPriority Priority;
 };
 
 XThreadImpl::XThreadImpl( ) :
     mData( new XThreadImplData( ) )
 {
-    mData->IsRunning = false;
-    mData->Thread    = 0;
+    mData->IsRunning    = false;
+    mData->Thread       = 0;
+    mData->AffinityMask = 0;
+    mData->Priority     = XThreadPriority::Normal;
 }
 
 XThreadImpl::~XThreadImpl( )
@@ -152,10 +165,147 @@ void XThreadImpl::Terminate( )
     }
 }
 
+// Get/Set name of the thread
+std::string XThreadImpl::Name( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->Name;
+}
+bool XThreadImpl::SetName( const std::string& name )
+{
+    XScopedLock lock( &mData->Sync );
+    bool ret = true;
+
+    mData->Name = name;
+
+    if ( IsRunning( ) )
+    {
+        ret = XThreadImplData::ApplyName( mData->Thread, name );
+    }
+
+    return ret;
+}
+
+// Get/Set mask of CPUs the thread is allowed to run on
+uint64_t XThreadImpl::Affinity( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->AffinityMask;
+}
+bool XThreadImpl::SetAffinity( uint64_t cpuMask )
+{
+    XScopedLock lock( &mData->Sync );
+    bool ret = true;
+
+    mData->AffinityMask = cpuMask;
+
+    if ( IsRunning( ) )
+    {
+        ret = XThreadImplData::ApplyAffinity( mData->Thread, cpuMask );
+    }
+
+    return ret;
+}
+
+// Get/Set scheduling priority of the thread
+XThreadPriority XThreadImpl::Priority( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->Priority;
+}
+bool XThreadImpl::SetPriority( XThreadPriority priority )
+{
+    XScopedLock lock( &mData->Sync );
+    bool ret = true;
+
+    mData->Priority = priority;
+
+    if ( IsRunning( ) )
+    {
+        ret = XThreadImplData::ApplyPriority( mData->Thread, priority );
+    }
+
+    return ret;
+}
+
+// Set name of the specified thread
+bool XThreadImplData::ApplyName( HANDLE thread, const std::string& name )
+{
+    static SetThreadDescriptionProc setThreadDescription = (SetThreadDescriptionProc)
+        GetProcAddress( GetModuleHandleW( L"kernel32.dll" ), "SetThreadDescription" );
+    bool ret = false;
+
+    if ( setThreadDescription != 0 )
+    {
+        int      charsCount = MultiByteToWideChar( CP_UTF8, 0, name.c_str( ), -1, NULL, 0 );
+        wchar_t* wideName   = new wchar_t[( charsCount > 0 ) ? charsCount : 1];
+
+        wideName[0] = 0;
+        MultiByteToWideChar( CP_UTF8, 0, name.c_str( ), -1, wideName, charsCount );
+
+        ret = SUCCEEDED( setThreadDescription( thread, wideName ) );
+
+        delete [] wideName;
+    }
+
+    return ret;
+}
+
+// Set mask of CPUs the specified thread is allowed to run on
+bool XThreadImplData::ApplyAffinity( HANDLE thread, uint64_t cpuMask )
+{
+    DWORD_PTR threadMask = static_cast<DWORD_PTR>( cpuMask );
+
+    if ( threadMask == 0 )
+    {
+        // let the thread run on any CPU available to the process
+        DWORD_PTR systemMask;
+
+        if ( !GetProcessAffinityMask( GetCurrentProcess( ), &threadMask, &systemMask ) )
+        {
+            threadMask = 0;
+        }
+    }
+
+    return ( threadMask != 0 ) && ( SetThreadAffinityMask( thread, threadMask ) != 0 );
+}
+
+// Set scheduling priority of the specified thread
+bool XThreadImplData::ApplyPriority( HANDLE thread, XThreadPriority priority )
+{
+    static const int priorityMap[] =
+    {
+        THREAD_PRIORITY_IDLE, THREAD_PRIORITY_LOWEST, THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+        THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST, THREAD_PRIORITY_TIME_CRITICAL
+    };
+
+    return ( SetThreadPriority( thread, priorityMap[static_cast<int>( priority )] ) != FALSE );
+}
+
 // Platform specific thread's worker function
 DWORD WINAPI XThreadImplData::WorkerThread( LPVOID lpParam )
 {
     XThreadImplData* myData = (XThreadImplData*) lpParam;
+
+    // apply settings, which were set before the thread was started
+    {
+        XScopedLock lock( &myData->Sync );
+        HANDLE      thread = GetCurrentThread( );
+
+        if ( !myData->Name.empty( ) )
+        {
+            ApplyName( thread, myData->Name );
+        }
+        if ( myData->AffinityMask != 0 )
+        {
+            ApplyAffinity( thread, myData->AffinityMask );
+        }
+        if ( myData->Priority != XThreadPriority::Normal )
+        {
+            ApplyPriority( thread, myData->Priority );
+        }
+    }
+
     myData->UserCallback( myData->UserParam );
 
     {
@@ -5,4 +5,4 @@ VPATH = ../../
 
 # source files
 SRC =  xalloc.c xarray.c xbits.c xcpuid.c xerrors.c xguid.c xhistogram.c ximage.c xlist.c \
-	xmath.c xpalette.c xrange.c xstring.c xvariant.c xversion.c
+	xmath.c xonce.c xpalette.c xrandom.c xrange.c xstring.c xtimestamp.c xvariant.c xversion.c
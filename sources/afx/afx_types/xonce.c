@@ -0,0 +1,60 @@
+/*
+    Core types library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "xonce.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+    #define XONCE_COMPARE_EXCHANGE( flag, newValue, oldValue ) InterlockedCompareExchange( flag, newValue, oldValue )
+    #define XONCE_YIELD( ) SwitchToThread( )
+#else
+    #include <sched.h>
+    #define XONCE_COMPARE_EXCHANGE( flag, newValue, oldValue ) __sync_val_compare_and_swap( flag, oldValue, newValue )
+    #define XONCE_YIELD( ) sched_yield( )
+#endif
+
+// States of once flag
+#define XONCE_NOT_DONE  (0)
+#define XONCE_RUNNING   (1)
+#define XONCE_DONE      (2)
+
+// Call the function if it was not called yet for the flag
+void XCallOnce( xonce* flag, void ( *func )( void ) )
+{
+    // compare-exchange is a full memory barrier, so anything done by the function before setting the
+    // flag to DONE is visible to the thread, which sees the flag set
+    long state = XONCE_COMPARE_EXCHANGE( flag, XONCE_RUNNING, XONCE_NOT_DONE );
+
+    if ( state == XONCE_NOT_DONE )
+    {
+        func( );
+        XONCE_COMPARE_EXCHANGE( flag, XONCE_DONE, XONCE_RUNNING );
+    }
+    else
+    {
+        // wait for another thread running the function
+        while ( state != XONCE_DONE )
+        {
+            XONCE_YIELD( );
+            state = XONCE_COMPARE_EXCHANGE( flag, XONCE_DONE, XONCE_DONE );
+        }
+    }
+}
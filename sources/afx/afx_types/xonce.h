@@ -0,0 +1,46 @@
+/*
+    Core types library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XONCE_H
+#define CVS_XONCE_H
+
+#include "xtypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Flag guarding code, which must run only once (initialize it with XONCE_INIT)
+typedef volatile long xonce;
+
+#define XONCE_INIT (0)
+
+// Call the function if it was not called yet for the flag. When several threads get here at the same time, only
+// one of them calls the function, while others wait till it completes - results of the function are visible to all
+// of them on return.
+void XCallOnce( xonce* flag, void ( *func )( void ) );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CVS_XONCE_H
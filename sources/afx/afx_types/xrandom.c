@@ -0,0 +1,150 @@
+/*
+    Core types library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "xrandom.h"
+#include "xcpuid.h"
+
+// SSE intrinsics
+#ifdef _MSC_VER
+    #include <intrin.h>
+#elif __GNUC__
+    #include <x86intrin.h>
+#endif
+
+// Philox4x32 constants (multipliers and Weyl sequence increments used to bump the key)
+#define PHILOX_M0       0xD2511F53
+#define PHILOX_M1       0xCD9E8D57
+#define PHILOX_W0       0x9E3779B9
+#define PHILOX_W1       0xBB67AE85
+#define PHILOX_ROUNDS   10
+
+// Second half of the key is fixed, the first one is the seed
+#define PHILOX_K1       0x6A09E667
+
+// forward declaration ----
+static void XRandom4BatchSSE2( uint32_t seed, uint32_t frame, uint32_t row, uint32_t firstIndex, uint32_t count, uint32_t* out );
+// ------------------------
+
+// Generate 4 random numbers for the specified counter
+void XRandom4( uint32_t seed, uint32_t frame, uint32_t row, uint32_t index, uint32_t* out )
+{
+    uint32_t x0 = index, x1 = row, x2 = frame, x3 = 0;
+    uint32_t k0 = seed,  k1 = PHILOX_K1;
+    uint64_t p0, p1;
+    int      i;
+
+    for ( i = 0; i < PHILOX_ROUNDS; i++ )
+    {
+        p0 = (uint64_t) PHILOX_M0 * x0;
+        p1 = (uint64_t) PHILOX_M1 * x2;
+
+        x0 = (uint32_t) ( p1 >> 32 ) ^ x1 ^ k0;
+        x1 = (uint32_t) p1;
+        x2 = (uint32_t) ( p0 >> 32 ) ^ x3 ^ k1;
+        x3 = (uint32_t) p0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = x0;
+    out[1] = x1;
+    out[2] = x2;
+    out[3] = x3;
+}
+
+// Generate 4 random numbers for each of the "count" counters starting from the specified index
+void XRandom4Batch( uint32_t seed, uint32_t frame, uint32_t row, uint32_t firstIndex, uint32_t count, uint32_t* out )
+{
+    uint32_t i = 0;
+
+    if ( IsSSE2( ) )
+    {
+        i = count & ~3u;
+        XRandom4BatchSSE2( seed, frame, row, firstIndex, i, out );
+    }
+
+    for ( ; i < count; i++ )
+    {
+        XRandom4( seed, frame, row, firstIndex + i, &out[i * 4] );
+    }
+}
+
+// Multiply 4 unsigned 32 bit values by the same multiplier providing high and low 32 bits of the products
+static void MulHiLo( __m128i a, __m128i multiplier, __m128i* hi, __m128i* lo )
+{
+    __m128i p02 = _mm_mul_epu32( a, multiplier );                         // products of lanes 0 and 2
+    __m128i p13 = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), multiplier );   // products of lanes 1 and 3
+
+    *lo = _mm_unpacklo_epi32( _mm_shuffle_epi32( p02, _MM_SHUFFLE( 0, 0, 2, 0 ) ),
+                              _mm_shuffle_epi32( p13, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+    *hi = _mm_unpacklo_epi32( _mm_shuffle_epi32( p02, _MM_SHUFFLE( 0, 0, 3, 1 ) ),
+                              _mm_shuffle_epi32( p13, _MM_SHUFFLE( 0, 0, 3, 1 ) ) );
+}
+
+// Generate random numbers for 4 counters at once (count must be multiple of 4)
+static void XRandom4BatchSSE2( uint32_t seed, uint32_t frame, uint32_t row, uint32_t firstIndex, uint32_t count, uint32_t* out )
+{
+    __m128i m0     = _mm_set1_epi32( (int) PHILOX_M0 );
+    __m128i m1     = _mm_set1_epi32( (int) PHILOX_M1 );
+    __m128i x1Init = _mm_set1_epi32( (int) row );
+    __m128i x2Init = _mm_set1_epi32( (int) frame );
+    __m128i step   = _mm_set_epi32( 3, 2, 1, 0 );
+    __m128i x0, x1, x2, x3, hi0, lo0, hi1, lo1, k0, k1;
+    __m128i t0, t1, t2, t3;
+    uint32_t i;
+    int      r;
+
+    for ( i = 0; i < count; i += 4, out += 16 )
+    {
+        x0 = _mm_add_epi32( _mm_set1_epi32( (int) ( firstIndex + i ) ), step );
+        x1 = x1Init;
+        x2 = x2Init;
+        x3 = _mm_setzero_si128( );
+        k0 = _mm_set1_epi32( (int) seed );
+        k1 = _mm_set1_epi32( (int) PHILOX_K1 );
+
+        for ( r = 0; r < PHILOX_ROUNDS; r++ )
+        {
+            MulHiLo( x0, m0, &hi0, &lo0 );
+            MulHiLo( x2, m1, &hi1, &lo1 );
+
+            x0 = _mm_xor_si128( _mm_xor_si128( hi1, x1 ), k0 );
+            x1 = lo1;
+            x2 = _mm_xor_si128( _mm_xor_si128( hi0, x3 ), k1 );
+            x3 = lo0;
+
+            k0 = _mm_add_epi32( k0, _mm_set1_epi32( (int) PHILOX_W0 ) );
+            k1 = _mm_add_epi32( k1, _mm_set1_epi32( (int) PHILOX_W1 ) );
+        }
+
+        // transpose, so numbers of every counter go together
+        t0 = _mm_unpacklo_epi32( x0, x1 );
+        t1 = _mm_unpacklo_epi32( x2, x3 );
+        t2 = _mm_unpackhi_epi32( x0, x1 );
+        t3 = _mm_unpackhi_epi32( x2, x3 );
+
+        _mm_storeu_si128( (__m128i*) ( out      ), _mm_unpacklo_epi64( t0, t1 ) );
+        _mm_storeu_si128( (__m128i*) ( out +  4 ), _mm_unpackhi_epi64( t0, t1 ) );
+        _mm_storeu_si128( (__m128i*) ( out +  8 ), _mm_unpacklo_epi64( t2, t3 ) );
+        _mm_storeu_si128( (__m128i*) ( out + 12 ), _mm_unpackhi_epi64( t2, t3 ) );
+    }
+}
@@ -0,0 +1,51 @@
+/*
+    Core types library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XRANDOM_H
+#define CVS_XRANDOM_H
+
+#include "xtypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Counter based random numbers generator (Philox4x32-10). Unlike rand(), it has no hidden state -
+// random numbers are a pure function of the seed and counter (frame, row and index of an element).
+// So they can be generated in any order and by any number of threads, giving the same result.
+
+// Map random number to the [0, range) range
+#define XRANDOM_RANGE(r, range) ((uint32_t) (((uint64_t) (r) * (uint32_t) (range)) >> 32))
+
+// Generate 4 random numbers for the specified counter
+void XRandom4( uint32_t seed, uint32_t frame, uint32_t row, uint32_t index, uint32_t* out );
+
+// Generate 4 random numbers for each of the "count" counters starting from the specified index
+// (numbers for the counter "firstIndex + i" are put into out[4 * i] ... out[4 * i + 3]).
+// Uses SSE2 if available, providing same numbers as XRandom4().
+void XRandom4Batch( uint32_t seed, uint32_t frame, uint32_t row, uint32_t firstIndex, uint32_t count, uint32_t* out );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CVS_XRANDOM_H
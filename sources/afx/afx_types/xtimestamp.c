@@ -0,0 +1,55 @@
+/*
+    Core types library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+
+#include "xtimestamp.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+// Get current time stamp - number of microseconds of a monotonic system wide clock
+int64_t XTimestampNow( void )
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER        counter;
+
+    if ( frequency.QuadPart == 0 )
+    {
+        QueryPerformanceFrequency( &frequency );
+    }
+
+    QueryPerformanceCounter( &counter );
+
+    // split to avoid overflow of multiplication
+    return ( counter.QuadPart / frequency.QuadPart ) * 1000000 +
+           ( counter.QuadPart % frequency.QuadPart ) * 1000000 / frequency.QuadPart;
+#else
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return (int64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#endif
+}
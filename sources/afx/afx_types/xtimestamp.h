@@ -0,0 +1,41 @@
+/*
+    Core types library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+
+#pragma once
+#ifndef CVS_XTIMESTAMP_H
+#define CVS_XTIMESTAMP_H
+
+#include "xtypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Get current time stamp - number of microseconds of a monotonic system wide clock. Since the clock
+// is not specific to a module, time stamps taken by plug-ins and host can be compared to each other.
+int64_t XTimestampNow( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CVS_XTIMESTAMP_H
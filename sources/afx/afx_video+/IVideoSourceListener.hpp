@@ -36,6 +36,13 @@ public:
     // New video frame notifican
     virtual void OnNewImage( const std::shared_ptr<const XImage>& image ) = 0;
 
+    // New video frame notification, which also tells when the frame was captured/received (XTimestampNow() time stamp)
+    virtual void OnNewImage( const std::shared_ptr<const XImage>& image, int64_t captureTime )
+    {
+        XUNREFERENCED_PARAMETER( captureTime )
+        OnNewImage( image );
+    }
+
     // Video source error notification
     virtual void OnError( const std::string& errorMessage ) = 0;
 };
@@ -0,0 +1,666 @@
+/*
+    Computer vision library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <math.h>
+#include <memory.h>
+#include "xvision.h"
+#include <ximaging.h>
+#include <xcpuid.h>
+
+// SSE intrinsics
+#ifdef _MSC_VER
+    #include <intrin.h>
+#elif __GNUC__
+    #include <x86intrin.h>
+#endif
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+// Number of contiguous circle's pixels, which must be all brighter or darker than the center (FAST-9)
+#define FAST_ARC_LENGTH (9)
+// Radius of the FAST circle - pixels closer to image's border are not checked
+#define FAST_RADIUS     (3)
+
+// Free parameter of Harris corner response: det(M) - k * trace(M)^2
+#define HARRIS_K        (0.04f)
+
+// Offsets of 16 pixels on the Bresenham circle of radius 3 (clockwise, starting from the top one)
+static const int FastCircleX[16] = { 0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3, -3, -3, -2, -1 };
+static const int FastCircleY[16] = { -3, -3, -2, -1, 0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3 };
+
+// Internal data of corners detection
+typedef struct _cornersDetectionData
+{
+    ximage*  GrayImage;
+    float*   ScoreMap;
+    float*   GradientsMap;      // Ixx, Iyy, Ixy - interleaved, used for Harris only
+    int32_t  MapWidth;
+    int32_t  MapHeight;
+
+    DetectedCorner* CellCorners;
+    uint32_t        CellsCount;
+
+    uint32_t AllocatedCornersCount;
+}
+CornersDetectionData;
+
+// Free corners detection context
+void FreeCornersDetectionContext( CornersDetectionContext** pContext )
+{
+    if ( ( pContext != 0 ) && ( *pContext != 0 ) )
+    {
+        CornersDetectionData* data = (CornersDetectionData*) ( *pContext )->Data;
+
+        if ( data != 0 )
+        {
+            XImageFree( &data->GrayImage );
+
+            if ( data->ScoreMap != 0 )
+            {
+                free( data->ScoreMap );
+            }
+            if ( data->GradientsMap != 0 )
+            {
+                free( data->GradientsMap );
+            }
+            if ( data->CellCorners != 0 )
+            {
+                free( data->CellCorners );
+            }
+
+            free( data );
+        }
+
+        if ( ( *pContext )->Corners != 0 )
+        {
+            free( ( *pContext )->Corners );
+        }
+
+        XFree( (void**) pContext );
+    }
+}
+
+// Allocate context and all buffers required to detect corners in an image of the specified size
+static XErrorCode AllocateContext( const ximage* image, uint16_t cellSize, uint32_t maxCorners, bool harris, CornersDetectionContext** pContext )
+{
+    XErrorCode               ret     = SuccessCode;
+    CornersDetectionContext* context = *pContext;
+    CornersDetectionData*    data    = 0;
+    int32_t                  width   = image->width;
+    int32_t                  height  = image->height;
+    uint32_t                 cellsCount = ( ( width + cellSize - 1 ) / cellSize ) * ( ( height + cellSize - 1 ) / cellSize );
+
+    if ( context == 0 )
+    {
+        context = (CornersDetectionContext*) XCAlloc( 1, sizeof( CornersDetectionContext ) );
+
+        if ( context == 0 )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            *pContext = context;
+        }
+    }
+
+    if ( ret == SuccessCode )
+    {
+        context->CornersCount = 0;
+
+        if ( context->Data == 0 )
+        {
+            context->Data = calloc( 1, sizeof( CornersDetectionData ) );
+
+            if ( context->Data == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+        }
+    }
+
+    if ( ret == SuccessCode )
+    {
+        data = (CornersDetectionData*) context->Data;
+
+        // buffers depending on image size
+        if ( ( data->MapWidth != width ) || ( data->MapHeight != height ) )
+        {
+            if ( data->ScoreMap != 0 )
+            {
+                free( data->ScoreMap );
+            }
+            if ( data->GradientsMap != 0 )
+            {
+                free( data->GradientsMap );
+                data->GradientsMap = 0;
+            }
+
+            data->MapWidth  = 0;
+            data->MapHeight = 0;
+            data->ScoreMap  = (float*) malloc( (size_t) width * height * sizeof( float ) );
+
+            if ( data->ScoreMap == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
+            {
+                data->MapWidth  = width;
+                data->MapHeight = height;
+            }
+        }
+
+        if ( ( ret == SuccessCode ) && ( harris ) && ( data->GradientsMap == 0 ) )
+        {
+            data->GradientsMap = (float*) malloc( (size_t) width * height * 3 * sizeof( float ) );
+
+            if ( data->GradientsMap == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+        }
+
+        if ( ( ret == SuccessCode ) && ( image->format != XPixelFormatGrayscale8 ) )
+        {
+            ret = XImageAllocateRaw( width, height, XPixelFormatGrayscale8, &data->GrayImage );
+        }
+
+        // one candidate for every grid's cell
+        if ( ( ret == SuccessCode ) && ( data->CellsCount != cellsCount ) )
+        {
+            if ( data->CellCorners != 0 )
+            {
+                free( data->CellCorners );
+            }
+
+            data->CellsCount  = 0;
+            data->CellCorners = (DetectedCorner*) malloc( cellsCount * sizeof( DetectedCorner ) );
+
+            if ( data->CellCorners == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
+            {
+                data->CellsCount = cellsCount;
+            }
+        }
+
+        if ( ( ret == SuccessCode ) && ( ( context->Corners == 0 ) || ( data->AllocatedCornersCount < maxCorners ) ) )
+        {
+            if ( context->Corners != 0 )
+            {
+                free( context->Corners );
+            }
+
+            data->AllocatedCornersCount = 0;
+            context->Corners = (DetectedCorner*) malloc( maxCorners * sizeof( DetectedCorner ) );
+
+            if ( context->Corners == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
+            {
+                data->AllocatedCornersCount = maxCorners;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Calculate FAST score of the pixel (0 if it is not a corner)
+static float GetFastScore( const uint8_t* ptr, const int* offsets, int threshold )
+{
+    int      center    = *ptr;
+    int      highLimit = center + threshold;
+    int      lowLimit  = center - threshold;
+    int      brightCount, darkCount, brightSum, darkSum, pixel, diff, j;
+    uint32_t brightMask, darkMask, arcMask;
+    float    score = 0;
+
+    // quick rejection - an arc of 9 pixels covers at least one of any two opposite pixels,
+    // and at least 2 of the 4 compass points
+    pixel = ptr[offsets[0]];
+    diff  = ptr[offsets[8]];
+
+    if ( ( pixel <= highLimit ) && ( pixel >= lowLimit ) && ( diff <= highLimit ) && ( diff >= lowLimit ) )
+    {
+        return 0;
+    }
+
+    brightCount = ( ptr[offsets[0]] > highLimit ) + ( ptr[offsets[4]] > highLimit ) +
+                  ( ptr[offsets[8]] > highLimit ) + ( ptr[offsets[12]] > highLimit );
+    darkCount   = ( ptr[offsets[0]] < lowLimit ) + ( ptr[offsets[4]] < lowLimit ) +
+                  ( ptr[offsets[8]] < lowLimit ) + ( ptr[offsets[12]] < lowLimit );
+
+    if ( ( brightCount < 2 ) && ( darkCount < 2 ) )
+    {
+        return 0;
+    }
+
+    brightMask = darkMask = 0;
+    brightSum  = darkSum  = 0;
+
+    for ( j = 0; j < 16; j++ )
+    {
+        pixel = ptr[offsets[j]];
+        diff  = pixel - center;
+
+        if ( pixel > highLimit )
+        {
+            brightMask |= ( 1u << j );
+            brightSum  += diff - threshold;
+        }
+        else if ( pixel < lowLimit )
+        {
+            darkMask |= ( 1u << j );
+            darkSum  += -diff - threshold;
+        }
+    }
+
+    // check for contiguous arc of the required length (the circle wraps around)
+    arcMask = ( brightSum > darkSum ) ? ( brightMask | ( brightMask << 16 ) ) : ( darkMask | ( darkMask << 16 ) );
+
+    for ( j = 1; ( j < FAST_ARC_LENGTH ) && ( arcMask != 0 ); j++ )
+    {
+        arcMask &= ( arcMask >> 1 );
+    }
+
+    if ( arcMask != 0 )
+    {
+        score = (float) XMAX( brightSum, darkSum );
+    }
+
+    return score;
+}
+
+// Calculate FAST score for every pixel of the image (0 for pixels, which are not corners)
+static void CalculateFastScores( const ximage* image, uint8_t threshold, float* scoreMap )
+{
+    int  width   = image->width;
+    int  height  = image->height;
+    int  stride  = image->stride;
+    bool useSSE2 = IsSSE2( );
+    int  offsets[16];
+    int  y, i;
+
+    for ( i = 0; i < 16; i++ )
+    {
+        offsets[i] = FastCircleY[i] * stride + FastCircleX[i];
+    }
+
+    #pragma omp parallel for schedule(static) shared( image, threshold, scoreMap, width, height, stride, offsets, useSSE2 )
+    for ( y = 0; y < height; y++ )
+    {
+        float*   scoreRow = scoreMap + y * width;
+        uint8_t* row      = image->data + y * stride;
+        int      x        = FAST_RADIUS;
+        int      mask, j;
+
+        memset( scoreRow, 0, width * sizeof( float ) );
+
+        if ( ( y < FAST_RADIUS ) || ( y >= height - FAST_RADIUS ) )
+        {
+            continue;
+        }
+
+        if ( useSSE2 )
+        {
+            __m128i thresholdV = _mm_set1_epi8( (char) threshold );
+            __m128i zero       = _mm_setzero_si128( );
+            __m128i center, high, low, p1, p2, out1, out2;
+
+            // reject 16 pixels at once, if none of them has both vertical and horizontal
+            // opposite pairs of compass points with a pixel differing from the center
+            for ( ; x + 16 <= width - FAST_RADIUS; x += 16 )
+            {
+                center = _mm_loadu_si128( (const __m128i*) ( row + x ) );
+                high   = _mm_adds_epu8( center, thresholdV );
+                low    = _mm_subs_epu8( center, thresholdV );
+
+                p1     = _mm_loadu_si128( (const __m128i*) ( row + x + offsets[0] ) );
+                p2     = _mm_loadu_si128( (const __m128i*) ( row + x + offsets[8] ) );
+                out1   = _mm_or_si128( _mm_or_si128( _mm_subs_epu8( p1, high ), _mm_subs_epu8( low, p1 ) ),
+                                       _mm_or_si128( _mm_subs_epu8( p2, high ), _mm_subs_epu8( low, p2 ) ) );
+
+                p1     = _mm_loadu_si128( (const __m128i*) ( row + x + offsets[4] ) );
+                p2     = _mm_loadu_si128( (const __m128i*) ( row + x + offsets[12] ) );
+                out2   = _mm_or_si128( _mm_or_si128( _mm_subs_epu8( p1, high ), _mm_subs_epu8( low, p1 ) ),
+                                       _mm_or_si128( _mm_subs_epu8( p2, high ), _mm_subs_epu8( low, p2 ) ) );
+
+                mask = ~( _mm_movemask_epi8( _mm_cmpeq_epi8( out1, zero ) ) | _mm_movemask_epi8( _mm_cmpeq_epi8( out2, zero ) ) ) & 0xFFFF;
+
+                for ( j = 0; mask != 0; j++, mask >>= 1 )
+                {
+                    if ( mask & 1 )
+                    {
+                        scoreRow[x + j] = GetFastScore( row + x + j, offsets, threshold );
+                    }
+                }
+            }
+        }
+
+        for ( ; x < width - FAST_RADIUS; x++ )
+        {
+            scoreRow[x] = GetFastScore( row + x, offsets, threshold );
+        }
+    }
+}
+
+// Calculate Harris corner response for every pixel of the image
+static void CalculateHarrisScores( const ximage* image, float* gradientsMap, float* scoreMap )
+{
+    int width  = image->width;
+    int height = image->height;
+    int stride = image->stride;
+    int y;
+
+    // 1 - products of image's derivatives calculated with Sobel operator (scaled to keep values small)
+    #pragma omp parallel for schedule(static) shared( image, gradientsMap, width, height, stride )
+    for ( y = 0; y < height; y++ )
+    {
+        float*   gradRow = gradientsMap + y * width * 3;
+        uint8_t* ptr;
+        int      x;
+        float    gx, gy;
+
+        if ( ( y == 0 ) || ( y == height - 1 ) )
+        {
+            memset( gradRow, 0, width * 3 * sizeof( float ) );
+            continue;
+        }
+
+        ptr = image->data + y * stride + 1;
+
+        gradRow[0] = gradRow[1] = gradRow[2] = 0;
+        gradRow[( width - 1 ) * 3] = gradRow[( width - 1 ) * 3 + 1] = gradRow[( width - 1 ) * 3 + 2] = 0;
+
+        for ( x = 1; x < width - 1; x++, ptr++ )
+        {
+            gx = (float) ( ptr[-stride + 1] + 2 * ptr[1] + ptr[stride + 1] - ptr[-stride - 1] - 2 * ptr[-1] - ptr[stride - 1] ) / 8.0f;
+            gy = (float) ( ptr[stride - 1] + 2 * ptr[stride] + ptr[stride + 1] - ptr[-stride - 1] - 2 * ptr[-stride] - ptr[-stride + 1] ) / 8.0f;
+
+            gradRow[x * 3    ] = gx * gx;
+            gradRow[x * 3 + 1] = gy * gy;
+            gradRow[x * 3 + 2] = gx * gy;
+        }
+    }
+
+    // 2 - sum products over 3x3 window and calculate response (sums of 3 columns are kept
+    //     while moving along the row, so only one new column is summed for every pixel)
+    #pragma omp parallel for schedule(static) shared( gradientsMap, scoreMap, width, height )
+    for ( y = 0; y < height; y++ )
+    {
+        float* scoreRow = scoreMap + y * width;
+        float* row0;
+        float* row1;
+        float* row2;
+        float  col[3][3];
+        float  sxx, syy, sxy, trace;
+        int    x, c, i;
+
+        memset( scoreRow, 0, width * sizeof( float ) );
+
+        if ( ( y < 2 ) || ( y >= height - 2 ) )
+        {
+            continue;
+        }
+
+        row0 = gradientsMap + ( y - 1 ) * width * 3;
+        row1 = row0 + width * 3;
+        row2 = row1 + width * 3;
+
+        // sums of columns 1 and 2 (sum of column N is kept in N % 3 element)
+        for ( c = 1; c < 3; c++ )
+        {
+            for ( i = 0; i < 3; i++ )
+            {
+                col[c][i] = row0[c * 3 + i] + row1[c * 3 + i] + row2[c * 3 + i];
+            }
+        }
+
+        for ( x = 2; x < width - 2; x++ )
+        {
+            c = ( x + 1 ) % 3;
+
+            for ( i = 0; i < 3; i++ )
+            {
+                col[c][i] = row0[( x + 1 ) * 3 + i] + row1[( x + 1 ) * 3 + i] + row2[( x + 1 ) * 3 + i];
+            }
+
+            sxx = col[0][0] + col[1][0] + col[2][0];
+            syy = col[0][1] + col[1][1] + col[2][1];
+            sxy = col[0][2] + col[1][2] + col[2][2];
+
+            trace       = sxx + syy;
+            scoreRow[x] = sxx * syy - sxy * sxy - HARRIS_K * trace * trace;
+        }
+    }
+}
+
+// Find the strongest positive local maximum of the score map in every cell of the grid (score is set to 0
+// for cells without corners)
+static void FindCellMaximums( const float* scoreMap, int width, int height, int cellSize, DetectedCorner* cellCorners )
+{
+    int cellsX     = ( width  + cellSize - 1 ) / cellSize;
+    int cellsY     = ( height + cellSize - 1 ) / cellSize;
+    int cellsCount = cellsX * cellsY;
+    int cell;
+
+    #pragma omp parallel for schedule(dynamic, 16) shared( scoreMap, width, height, cellSize, cellCorners, cellsX )
+    for ( cell = 0; cell < cellsCount; cell++ )
+    {
+        int            startX = ( cell % cellsX ) * cellSize;
+        int            startY = ( cell / cellsX ) * cellSize;
+        int            stopX  = XMIN( startX + cellSize, width  - 1 );
+        int            stopY  = XMIN( startY + cellSize, height - 1 );
+        DetectedCorner best;
+        const float*   ptr;
+        float          score;
+        int            x, y;
+
+        best.Point.x = best.Point.y = 0;
+        best.Score   = 0;
+
+        for ( y = XMAX( startY, 1 ); y < stopY; y++ )
+        {
+            ptr = scoreMap + y * width;
+
+            for ( x = XMAX( startX, 1 ); x < stopX; x++ )
+            {
+                score = ptr[x];
+
+                // must be better than the current best and be a local maximum in 3x3 neighbourhood
+                // (for equal scores the first one in raster order wins)
+                if ( ( score > best.Score ) &&
+                     ( score >  ptr[x - width - 1] ) && ( score >  ptr[x - width] ) && ( score >  ptr[x - width + 1] ) &&
+                     ( score >  ptr[x - 1] )         && ( score >= ptr[x + 1] ) &&
+                     ( score >= ptr[x + width - 1] ) && ( score >= ptr[x + width] ) && ( score >= ptr[x + width + 1] ) )
+                {
+                    best.Point.x = x;
+                    best.Point.y = y;
+                    best.Score   = score;
+                }
+            }
+        }
+
+        cellCorners[cell] = best;
+    }
+}
+
+// Compare corners so they are sorted by score in descending order
+static int CompareCorners( const void* p1, const void* p2 )
+{
+    const DetectedCorner* corner1 = (const DetectedCorner*) p1;
+    const DetectedCorner* corner2 = (const DetectedCorner*) p2;
+    int                   ret     = 0;
+
+    if ( corner1->Score != corner2->Score )
+    {
+        ret = ( corner1->Score > corner2->Score ) ? -1 : 1;
+    }
+    else if ( corner1->Point.y != corner2->Point.y )
+    {
+        ret = ( corner1->Point.y < corner2->Point.y ) ? -1 : 1;
+    }
+    else if ( corner1->Point.x != corner2->Point.x )
+    {
+        ret = ( corner1->Point.x < corner2->Point.x ) ? -1 : 1;
+    }
+
+    return ret;
+}
+
+// Collect the strongest corners found in grid's cells
+static void CollectCorners( CornersDetectionContext* context, float minScore, uint32_t maxCorners )
+{
+    CornersDetectionData* data  = (CornersDetectionData*) context->Data;
+    uint32_t              count = 0;
+    uint32_t              i;
+
+    // compact cells having corners to the beginning of the array
+    for ( i = 0; i < data->CellsCount; i++ )
+    {
+        if ( ( data->CellCorners[i].Score > 0 ) && ( data->CellCorners[i].Score >= minScore ) )
+        {
+            data->CellCorners[count++] = data->CellCorners[i];
+        }
+    }
+
+    qsort( data->CellCorners, count, sizeof( DetectedCorner ), CompareCorners );
+
+    context->CornersCount = XMIN( count, maxCorners );
+    memcpy( context->Corners, data->CellCorners, context->CornersCount * sizeof( DetectedCorner ) );
+}
+
+// Check common arguments of corners detection functions
+static XErrorCode CheckCornersArguments( const ximage* image, CornersDetectionContext** pContext )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( image == 0 ) || ( pContext == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( image->format != XPixelFormatGrayscale8 ) &&
+              ( image->format != XPixelFormatRGB24 ) &&
+              ( image->format != XPixelFormatRGBA32 ) )
+    {
+        ret = ErrorUnsupportedPixelFormat;
+    }
+    else if ( ( image->width <= FAST_RADIUS * 2 ) || ( image->height <= FAST_RADIUS * 2 ) )
+    {
+        ret = ErrorImageIsTooSmall;
+    }
+
+    return ret;
+}
+
+// Find corners in the specified image using FAST-9 corner detector
+XErrorCode FindFastCorners( const ximage* image, uint8_t threshold, uint16_t cellSize, uint32_t maxCorners, CornersDetectionContext** pContext )
+{
+    XErrorCode ret = CheckCornersArguments( image, pContext );
+
+    if ( ret == SuccessCode )
+    {
+        CornersDetectionData* data      = 0;
+        const ximage*         grayImage = image;
+
+        threshold  = XMAX( threshold, 1 );
+        cellSize   = XMAX( cellSize, 2 );
+        maxCorners = XMAX( maxCorners, 1 );
+
+        ret = AllocateContext( image, cellSize, maxCorners, false, pContext );
+
+        if ( ret == SuccessCode )
+        {
+            data = (CornersDetectionData*) ( *pContext )->Data;
+
+            if ( image->format != XPixelFormatGrayscale8 )
+            {
+                ret       = ColorToGrayscale( image, data->GrayImage );
+                grayImage = data->GrayImage;
+            }
+        }
+
+        if ( ret == SuccessCode )
+        {
+            CalculateFastScores( grayImage, threshold, data->ScoreMap );
+            FindCellMaximums( data->ScoreMap, image->width, image->height, cellSize, data->CellCorners );
+            CollectCorners( *pContext, 0.0f, maxCorners );
+        }
+    }
+
+    return ret;
+}
+
+// Find corners in the specified image using Harris corner detector
+XErrorCode FindHarrisCorners( const ximage* image, float qualityLevel, uint16_t cellSize, uint32_t maxCorners, CornersDetectionContext** pContext )
+{
+    XErrorCode ret = CheckCornersArguments( image, pContext );
+
+    if ( ret == SuccessCode )
+    {
+        CornersDetectionData* data      = 0;
+        const ximage*         grayImage = image;
+
+        qualityLevel = XINRANGE( qualityLevel, 0.0f, 1.0f );
+        cellSize     = XMAX( cellSize, 2 );
+        maxCorners   = XMAX( maxCorners, 1 );
+
+        ret = AllocateContext( image, cellSize, maxCorners, true, pContext );
+
+        if ( ret == SuccessCode )
+        {
+            data = (CornersDetectionData*) ( *pContext )->Data;
+
+            if ( image->format != XPixelFormatGrayscale8 )
+            {
+                ret       = ColorToGrayscale( image, data->GrayImage );
+                grayImage = data->GrayImage;
+            }
+        }
+
+        if ( ret == SuccessCode )
+        {
+            float    maxScore = 0;
+            uint32_t i;
+
+            CalculateHarrisScores( grayImage, data->GradientsMap, data->ScoreMap );
+            FindCellMaximums( data->ScoreMap, image->width, image->height, cellSize, data->CellCorners );
+
+            // the strongest response is among cells' maximums
+            for ( i = 0; i < data->CellsCount; i++ )
+            {
+                maxScore = XMAX( maxScore, data->CellCorners[i].Score );
+            }
+
+            CollectCorners( *pContext, maxScore * qualityLevel, maxCorners );
+        }
+    }
+
+    return ret;
+}
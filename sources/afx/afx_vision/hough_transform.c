@@ -0,0 +1,1099 @@
+/*
+    Computer vision library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <math.h>
+#include <memory.h>
+#include "xvision.h"
+
+#ifdef _OPENMP
+    #include <omp.h>
+#else
+    #define omp_get_max_threads( ) ( 1 )
+    #define omp_get_num_procs( )   ( 1 )
+    #define omp_get_num_threads( ) ( 1 )
+    #define omp_get_thread_num( )  ( 0 )
+#endif
+
+// Number of theta steps in Hough space of lines (1 degree resolution)
+#define THETA_STEPS (180)
+
+// Radius of neighbourhood used to estimate orientation of edges from the edges image itself
+#define EDGE_ORIENTATION_RADIUS (2)
+// Minimum number of neighbour edge pixels required to estimate orientation of an edge
+#define EDGE_ORIENTATION_MIN_NEIGHBOURS (2)
+
+// Radius of neighbourhood, where candidate center of a circle must have maximum votes
+#define CIRCLE_CENTER_PEAK_RADIUS (2)
+// Maximum number of candidate centers to check for every requested circle
+#define CIRCLE_CANDIDATES_PER_CIRCLE (10)
+
+// Edge pixel along with direction of its normal (gradient)
+typedef struct _edgePoint
+{
+    int32_t X;
+    int32_t Y;
+    int32_t Theta;  // in [0, 180) degrees range, -1 if unknown
+}
+EdgePoint;
+
+// Local maximum found in Hough space
+typedef struct _houghPeak
+{
+    uint32_t Index;
+    uint32_t Intensity;
+}
+HoughPeak;
+
+// Internal data of lines/circles detection contexts
+typedef struct _houghData
+{
+    int32_t    Width;
+    int32_t    Height;
+
+    float      CosTable[THETA_STEPS];
+    float      SinTable[THETA_STEPS];
+
+    EdgePoint* Points;
+    uint32_t   PointsCount;
+    uint32_t   AllocatedPointsCount;
+
+    // accumulator of every thread - the first one gets the merged result
+    uint32_t*  Accumulators;
+    uint32_t   AccumulatorSize;
+    int32_t    ThreadsCount;
+    int32_t    UsedThreadsCount;
+
+    HoughPeak* Peaks;
+    uint32_t   PeaksCount;
+    uint32_t   AllocatedPeaksCount;
+
+    uint32_t*  RadiusHistogram;
+    uint32_t   AllocatedHistogramSize;
+
+    uint32_t   AllocatedResultsCount;
+}
+HoughData;
+
+// Free internal data of Hough transform
+static void FreeHoughData( HoughData* data )
+{
+    if ( data != 0 )
+    {
+        if ( data->Points != 0 )
+        {
+            free( data->Points );
+        }
+        if ( data->Accumulators != 0 )
+        {
+            free( data->Accumulators );
+        }
+        if ( data->Peaks != 0 )
+        {
+            free( data->Peaks );
+        }
+        if ( data->RadiusHistogram != 0 )
+        {
+            free( data->RadiusHistogram );
+        }
+
+        free( data );
+    }
+}
+
+// Free Hough lines detection context
+void FreeHoughLinesContext( HoughLinesContext** pContext )
+{
+    if ( ( pContext != 0 ) && ( *pContext != 0 ) )
+    {
+        FreeHoughData( (HoughData*) ( *pContext )->Data );
+
+        if ( ( *pContext )->Lines != 0 )
+        {
+            free( ( *pContext )->Lines );
+        }
+
+        XFree( (void**) pContext );
+    }
+}
+
+// Free Hough circles detection context
+void FreeHoughCirclesContext( HoughCirclesContext** pContext )
+{
+    if ( ( pContext != 0 ) && ( *pContext != 0 ) )
+    {
+        FreeHoughData( (HoughData*) ( *pContext )->Data );
+
+        if ( ( *pContext )->Circles != 0 )
+        {
+            free( ( *pContext )->Circles );
+        }
+
+        XFree( (void**) pContext );
+    }
+}
+
+// Make sure internal data is allocated and has accumulators of the required size
+static XErrorCode PrepareHoughData( void** pData, const ximage* edges, uint32_t accumulatorSize )
+{
+    XErrorCode ret  = SuccessCode;
+    HoughData* data = (HoughData*) *pData;
+
+    if ( data == 0 )
+    {
+        data = (HoughData*) calloc( 1, sizeof( HoughData ) );
+
+        if ( data == 0 )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            int i;
+
+            for ( i = 0; i < THETA_STEPS; i++ )
+            {
+                data->CosTable[i] = (float) cos( i * XPI / THETA_STEPS );
+                data->SinTable[i] = (float) sin( i * XPI / THETA_STEPS );
+            }
+
+            data->ThreadsCount = XMAX( 1, XMIN( omp_get_max_threads( ), omp_get_num_procs( ) ) );
+
+            *pData = data;
+        }
+    }
+
+    if ( ret == SuccessCode )
+    {
+        data->Width  = edges->width;
+        data->Height = edges->height;
+
+        if ( data->AccumulatorSize != accumulatorSize )
+        {
+            if ( data->Accumulators != 0 )
+            {
+                free( data->Accumulators );
+            }
+
+            data->AccumulatorSize = 0;
+            data->Accumulators    = (uint32_t*) malloc( (size_t) accumulatorSize * data->ThreadsCount * sizeof( uint32_t ) );
+
+            if ( data->Accumulators == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
+            {
+                data->AccumulatorSize = accumulatorSize;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Estimate direction of edge's normal using Sobel operator on the grayscale image
+static int32_t GetGradientDirection( const ximage* grayImage, int32_t x, int32_t y )
+{
+    int32_t theta = -1;
+
+    if ( ( x > 0 ) && ( y > 0 ) && ( x < grayImage->width - 1 ) && ( y < grayImage->height - 1 ) )
+    {
+        int      stride = grayImage->stride;
+        uint8_t* ptr    = grayImage->data + y * stride + x;
+        int      gx, gy;
+
+        gx = ptr[-stride + 1] + 2 * ptr[1] + ptr[stride + 1] - ptr[-stride - 1] - 2 * ptr[-1] - ptr[stride - 1];
+        gy = ptr[stride - 1] + 2 * ptr[stride] + ptr[stride + 1] - ptr[-stride - 1] - 2 * ptr[-stride] - ptr[-stride + 1];
+
+        if ( ( gx != 0 ) || ( gy != 0 ) )
+        {
+            theta = (int32_t) floor( atan2( (double) gy, (double) gx ) * THETA_STEPS / XPI + 0.5 );
+            theta = ( ( theta % THETA_STEPS ) + THETA_STEPS ) % THETA_STEPS;
+        }
+    }
+
+    return theta;
+}
+
+// Estimate direction of edge's normal from the orientation of neighbour edge pixels
+static int32_t GetEdgeDirection( const ximage* edges, int32_t x, int32_t y )
+{
+    int32_t  theta  = -1;
+    int      stride = edges->stride;
+    int32_t  startX = XMAX( x - EDGE_ORIENTATION_RADIUS, 0 );
+    int32_t  startY = XMAX( y - EDGE_ORIENTATION_RADIUS, 0 );
+    int32_t  stopX  = XMIN( x + EDGE_ORIENTATION_RADIUS, edges->width  - 1 );
+    int32_t  stopY  = XMIN( y + EDGE_ORIENTATION_RADIUS, edges->height - 1 );
+    int32_t  count  = 0;
+    int32_t  sxx = 0, syy = 0, sxy = 0;
+    int32_t  ix, iy, dx, dy;
+    uint8_t* row;
+
+    for ( iy = startY; iy <= stopY; iy++ )
+    {
+        row = edges->data + iy * stride;
+        dy  = iy - y;
+
+        for ( ix = startX; ix <= stopX; ix++ )
+        {
+            if ( row[ix] != 0 )
+            {
+                dx = ix - x;
+
+                sxx += dx * dx;
+                syy += dy * dy;
+                sxy += dx * dy;
+                count++;
+            }
+        }
+    }
+
+    // the pixel itself is counted as well
+    if ( count > EDGE_ORIENTATION_MIN_NEIGHBOURS )
+    {
+        // orientation of the main axis of neighbour pixels is the edge's tangent, rotate it to get the normal
+        double tangent = 0.5 * atan2( (double) ( 2 * sxy ), (double) ( sxx - syy ) );
+
+        theta = (int32_t) floor( tangent * THETA_STEPS / XPI + 0.5 ) + THETA_STEPS / 2;
+        theta = ( ( theta % THETA_STEPS ) + THETA_STEPS ) % THETA_STEPS;
+    }
+
+    return theta;
+}
+
+// Collect edge pixels and estimate their directions if required
+static XErrorCode CollectEdgePoints( HoughData* data, const ximage* edges, const ximage* grayImage, bool needDirection )
+{
+    XErrorCode ret    = SuccessCode;
+    int32_t    width  = edges->width;
+    int32_t    height = edges->height;
+    uint32_t   count  = 0;
+    int32_t    x, y;
+    uint8_t*   row;
+
+    for ( y = 0; y < height; y++ )
+    {
+        row = edges->data + y * edges->stride;
+
+        for ( x = 0; x < width; x++ )
+        {
+            if ( row[x] != 0 )
+            {
+                count++;
+            }
+        }
+    }
+
+    if ( count > data->AllocatedPointsCount )
+    {
+        // allocate a bit more to avoid reallocation when the number of edges changes slightly
+        uint32_t newCount = count + count / 4;
+
+        if ( data->Points != 0 )
+        {
+            free( data->Points );
+        }
+
+        data->AllocatedPointsCount = 0;
+        data->Points               = (EdgePoint*) malloc( newCount * sizeof( EdgePoint ) );
+
+        if ( data->Points == 0 )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            data->AllocatedPointsCount = newCount;
+        }
+    }
+
+    if ( ret == SuccessCode )
+    {
+        EdgePoint* points = data->Points;
+        int        pointsCount, i;
+
+        count = 0;
+
+        for ( y = 0; y < height; y++ )
+        {
+            row = edges->data + y * edges->stride;
+
+            for ( x = 0; x < width; x++ )
+            {
+                if ( row[x] != 0 )
+                {
+                    points[count].X     = x;
+                    points[count].Y     = y;
+                    points[count].Theta = -1;
+                    count++;
+                }
+            }
+        }
+
+        data->PointsCount = count;
+        pointsCount       = (int) count;
+
+        if ( needDirection )
+        {
+            #pragma omp parallel for schedule(static) shared( points, pointsCount, edges, grayImage )
+            for ( i = 0; i < pointsCount; i++ )
+            {
+                points[i].Theta = ( grayImage != 0 ) ? GetGradientDirection( grayImage, points[i].X, points[i].Y ) :
+                                                       GetEdgeDirection( edges, points[i].X, points[i].Y );
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Sum accumulators of all threads into the first one
+static void MergeAccumulators( HoughData* data, int rowsCount, uint32_t rowLength )
+{
+    if ( data->UsedThreadsCount > 1 )
+    {
+        uint32_t* accumulators    = data->Accumulators;
+        uint32_t  accumulatorSize = data->AccumulatorSize;
+        int32_t   threadsCount    = data->UsedThreadsCount;
+        int       y;
+
+        #pragma omp parallel for schedule(static) shared( accumulators, accumulatorSize, threadsCount, rowLength )
+        for ( y = 0; y < rowsCount; y++ )
+        {
+            uint32_t* dst = accumulators + y * rowLength;
+            uint32_t* src;
+            uint32_t  i;
+            int32_t   t;
+
+            for ( t = 1; t < threadsCount; t++ )
+            {
+                src = accumulators + t * accumulatorSize + y * rowLength;
+
+                for ( i = 0; i < rowLength; i++ )
+                {
+                    dst[i] += src[i];
+                }
+            }
+        }
+    }
+}
+
+// Add peak of Hough space to the list
+static XErrorCode AddPeak( HoughData* data, uint32_t index, uint32_t intensity )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( data->PeaksCount == data->AllocatedPeaksCount )
+    {
+        uint32_t   newCount = XMAX( 64, data->AllocatedPeaksCount * 2 );
+        HoughPeak* newPeaks = (HoughPeak*) realloc( data->Peaks, newCount * sizeof( HoughPeak ) );
+
+        if ( newPeaks == 0 )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            data->Peaks               = newPeaks;
+            data->AllocatedPeaksCount = newCount;
+        }
+    }
+
+    if ( ret == SuccessCode )
+    {
+        data->Peaks[data->PeaksCount].Index     = index;
+        data->Peaks[data->PeaksCount].Intensity = intensity;
+        data->PeaksCount++;
+    }
+
+    return ret;
+}
+
+// Compare peaks so they are sorted by intensity in descending order (and by index for equal intensities)
+static int ComparePeaks( const void* p1, const void* p2 )
+{
+    const HoughPeak* peak1 = (const HoughPeak*) p1;
+    const HoughPeak* peak2 = (const HoughPeak*) p2;
+    int              ret   = 0;
+
+    if ( peak1->Intensity != peak2->Intensity )
+    {
+        ret = ( peak1->Intensity > peak2->Intensity ) ? -1 : 1;
+    }
+    else if ( peak1->Index != peak2->Index )
+    {
+        ret = ( peak1->Index < peak2->Index ) ? -1 : 1;
+    }
+
+    return ret;
+}
+
+// Make sure the results array can keep the specified number of items
+static XErrorCode PrepareResults( HoughData* data, void** results, uint32_t itemSize, uint32_t count )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( *results == 0 ) || ( data->AllocatedResultsCount < count ) )
+    {
+        if ( *results != 0 )
+        {
+            free( *results );
+        }
+
+        data->AllocatedResultsCount = 0;
+        *results = malloc( count * itemSize );
+
+        if ( *results == 0 )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else
+        {
+            data->AllocatedResultsCount = count;
+        }
+    }
+
+    return ret;
+}
+
+// ===== Lines =====
+
+// Find straight lines in the edges image
+XErrorCode FindHoughLines( const ximage* edges, const ximage* grayImage, uint16_t gradientWindow,
+                           uint32_t minIntensity, uint16_t localPeakRadius, uint32_t maxLines, HoughLinesContext** pContext )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( edges == 0 ) || ( pContext == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( edges->format != XPixelFormatGrayscale8 ) ||
+              ( ( grayImage != 0 ) && ( grayImage->format != XPixelFormatGrayscale8 ) ) )
+    {
+        ret = ErrorUnsupportedPixelFormat;
+    }
+    else if ( ( grayImage != 0 ) && ( ( grayImage->width != edges->width ) || ( grayImage->height != edges->height ) ) )
+    {
+        ret = ErrorImageParametersMismatch;
+    }
+    else
+    {
+        HoughLinesContext* context = *pContext;
+        HoughData*         data    = 0;
+        int32_t            centerX = edges->width  / 2;
+        int32_t            centerY = edges->height / 2;
+        int32_t            maxRadius   = (int32_t) ceil( sqrt( (double) centerX * centerX + (double) centerY * centerY ) ) + 1;
+        int32_t            radiusCount = maxRadius * 2 + 1;
+
+        gradientWindow  = XMIN( gradientWindow, THETA_STEPS / 2 - 1 );
+        localPeakRadius = XMAX( localPeakRadius, 1 );
+        minIntensity    = XMAX( minIntensity, 1 );
+        maxLines        = XMAX( maxLines, 1 );
+
+        if ( context == 0 )
+        {
+            context = (HoughLinesContext*) XCAlloc( 1, sizeof( HoughLinesContext ) );
+
+            if ( context == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
+            {
+                *pContext = context;
+            }
+        }
+
+        if ( ret == SuccessCode )
+        {
+            context->LinesCount = 0;
+
+            ret = PrepareHoughData( &context->Data, edges, (uint32_t) ( THETA_STEPS * radiusCount ) );
+        }
+
+        if ( ret == SuccessCode )
+        {
+            data = (HoughData*) context->Data;
+            ret  = PrepareResults( data, (void**) &context->Lines, sizeof( HoughLine ), maxLines );
+        }
+
+        // 1 - collect edge pixels
+        if ( ret == SuccessCode )
+        {
+            ret = CollectEdgePoints( data, edges, grayImage, ( gradientWindow != 0 ) );
+        }
+
+        // 2 - vote for lines going through every edge pixel, using per thread accumulators
+        if ( ret == SuccessCode )
+        {
+            EdgePoint* points          = data->Points;
+            int        pointsCount     = (int) data->PointsCount;
+            uint32_t*  accumulators    = data->Accumulators;
+            uint32_t   accumulatorSize = data->AccumulatorSize;
+            float*     cosTable        = data->CosTable;
+            float*     sinTable        = data->SinTable;
+            int32_t    window          = gradientWindow;
+
+            #pragma omp parallel num_threads( data->ThreadsCount ) shared( data, points, pointsCount, accumulators, accumulatorSize, cosTable, sinTable, window, centerX, centerY, maxRadius, radiusCount )
+            {
+                uint32_t* accumulator = accumulators + omp_get_thread_num( ) * accumulatorSize;
+                float     x, y;
+                int32_t   t, tStart, tEnd, theta, r;
+                int       i;
+
+                #pragma omp master
+                {
+                    data->UsedThreadsCount = omp_get_num_threads( );
+                }
+
+                memset( accumulator, 0, accumulatorSize * sizeof( uint32_t ) );
+
+                #pragma omp for schedule(static)
+                for ( i = 0; i < pointsCount; i++ )
+                {
+                    x = (float) ( points[i].X - centerX );
+                    y = (float) ( points[i].Y - centerY );
+
+                    if ( window == 0 )
+                    {
+                        tStart = 0;
+                        tEnd   = THETA_STEPS - 1;
+                    }
+                    else if ( points[i].Theta < 0 )
+                    {
+                        // pixels with unknown direction don't vote
+                        continue;
+                    }
+                    else
+                    {
+                        tStart = points[i].Theta - window;
+                        tEnd   = points[i].Theta + window;
+                    }
+
+                    for ( t = tStart; t <= tEnd; t++ )
+                    {
+                        theta = ( t + THETA_STEPS ) % THETA_STEPS;
+                        r     = (int32_t) floorf( x * cosTable[theta] + y * sinTable[theta] + 0.5f ) + maxRadius;
+
+                        accumulator[theta * radiusCount + r]++;
+                    }
+                }
+            }
+
+            MergeAccumulators( data, THETA_STEPS, (uint32_t) radiusCount );
+        }
+
+        // 3 - find local maximums in Hough space
+        if ( ret == SuccessCode )
+        {
+            uint32_t* accumulator = data->Accumulators;
+            int32_t   peakRadius  = localPeakRadius;
+            int32_t   t, r, dt, dr, tt, rr;
+            uint32_t  value, neighbour, index, neighbourIndex;
+            bool      isPeak;
+
+            data->PeaksCount = 0;
+
+            for ( t = 0; ( t < THETA_STEPS ) && ( ret == SuccessCode ); t++ )
+            {
+                for ( r = 0; r < radiusCount; r++ )
+                {
+                    index = t * radiusCount + r;
+                    value = accumulator[index];
+
+                    if ( value < minIntensity )
+                    {
+                        continue;
+                    }
+
+                    isPeak = true;
+
+                    for ( dt = -peakRadius; ( dt <= peakRadius ) && ( isPeak ); dt++ )
+                    {
+                        tt = t + dt;
+                        rr = r;
+
+                        // theta wraps around, while radius changes its sign
+                        if ( ( tt < 0 ) || ( tt >= THETA_STEPS ) )
+                        {
+                            tt = ( tt + THETA_STEPS ) % THETA_STEPS;
+                            rr = radiusCount - 1 - r;
+                        }
+
+                        for ( dr = -peakRadius; dr <= peakRadius; dr++ )
+                        {
+                            if ( ( ( rr + dr ) < 0 ) || ( ( rr + dr ) >= radiusCount ) || ( ( dt == 0 ) && ( dr == 0 ) ) )
+                            {
+                                continue;
+                            }
+
+                            neighbourIndex = tt * radiusCount + rr + dr;
+                            neighbour      = accumulator[neighbourIndex];
+
+                            // for equal values only the first one is the peak
+                            if ( ( neighbour > value ) || ( ( neighbour == value ) && ( neighbourIndex < index ) ) )
+                            {
+                                isPeak = false;
+                                break;
+                            }
+                        }
+                    }
+
+                    if ( isPeak )
+                    {
+                        ret = AddPeak( data, index, value );
+
+                        if ( ret != SuccessCode )
+                        {
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        // 4 - provide the most intensive lines
+        if ( ret == SuccessCode )
+        {
+            uint32_t i;
+
+            // the peaks array may not be allocated when there are no peaks
+            if ( data->PeaksCount != 0 )
+            {
+                qsort( data->Peaks, data->PeaksCount, sizeof( HoughPeak ), ComparePeaks );
+            }
+
+            context->LinesCount = XMIN( data->PeaksCount, maxLines );
+
+            for ( i = 0; i < context->LinesCount; i++ )
+            {
+                context->Lines[i].Theta     = (float) ( data->Peaks[i].Index / radiusCount ) * 180.0f / THETA_STEPS;
+                context->Lines[i].Radius    = (float) ( (int32_t) ( data->Peaks[i].Index % radiusCount ) - maxRadius );
+                context->Lines[i].Intensity = data->Peaks[i].Intensity;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Get points where the specified line crosses borders of the image
+XErrorCode GetHoughLineEndPoints( const HoughLine* line, int32_t imageWidth, int32_t imageHeight, xpoint* point1, xpoint* point2 )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( line == 0 ) || ( point1 == 0 ) || ( point2 == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else
+    {
+        double theta   = line->Theta * XPI / 180.0;
+        double cosT    = cos( theta );
+        double sinT    = sin( theta );
+        double centerX = imageWidth  / 2;
+        double centerY = imageHeight / 2;
+        double maxX    = imageWidth  - 1;
+        double maxY    = imageHeight - 1;
+        // point of the line closest to image's center and direction of the line
+        double x0      = centerX + line->Radius * cosT;
+        double y0      = centerY + line->Radius * sinT;
+        double dx      = -sinT;
+        double dy      = cosT;
+        double tMin    = 0, tMax = 0, t, x, y;
+        bool   found   = false;
+        int    i;
+
+        // intersect with left, right, top and bottom borders
+        for ( i = 0; i < 4; i++ )
+        {
+            if ( i < 2 )
+            {
+                if ( fabs( dx ) < 1e-9 )
+                {
+                    continue;
+                }
+
+                x = ( i == 0 ) ? 0 : maxX;
+                t = ( x - x0 ) / dx;
+                y = y0 + t * dy;
+
+                if ( ( y < -0.5 ) || ( y > maxY + 0.5 ) )
+                {
+                    continue;
+                }
+            }
+            else
+            {
+                if ( fabs( dy ) < 1e-9 )
+                {
+                    continue;
+                }
+
+                y = ( i == 2 ) ? 0 : maxY;
+                t = ( y - y0 ) / dy;
+                x = x0 + t * dx;
+
+                if ( ( x < -0.5 ) || ( x > maxX + 0.5 ) )
+                {
+                    continue;
+                }
+            }
+
+            if ( !found )
+            {
+                tMin  = tMax = t;
+                found = true;
+            }
+            else
+            {
+                tMin = XMIN( tMin, t );
+                tMax = XMAX( tMax, t );
+            }
+        }
+
+        if ( !found )
+        {
+            ret = ErrorFailed;
+        }
+        else
+        {
+            point1->x = (int32_t) floor( x0 + tMin * dx + 0.5 );
+            point1->y = (int32_t) floor( y0 + tMin * dy + 0.5 );
+            point2->x = (int32_t) floor( x0 + tMax * dx + 0.5 );
+            point2->y = (int32_t) floor( y0 + tMax * dy + 0.5 );
+        }
+    }
+
+    return ret;
+}
+
+// ===== Circles =====
+
+// Find circles in the edges image
+XErrorCode FindHoughCircles( const ximage* edges, const ximage* grayImage, uint32_t minRadius, uint32_t maxRadius,
+                             uint32_t minIntensity, uint32_t maxCircles, HoughCirclesContext** pContext )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( edges == 0 ) || ( pContext == 0 ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( edges->format != XPixelFormatGrayscale8 ) ||
+              ( ( grayImage != 0 ) && ( grayImage->format != XPixelFormatGrayscale8 ) ) )
+    {
+        ret = ErrorUnsupportedPixelFormat;
+    }
+    else if ( ( grayImage != 0 ) && ( ( grayImage->width != edges->width ) || ( grayImage->height != edges->height ) ) )
+    {
+        ret = ErrorImageParametersMismatch;
+    }
+    else if ( ( minRadius == 0 ) || ( maxRadius < minRadius ) )
+    {
+        ret = ErrorArgumentOutOfRange;
+    }
+    else
+    {
+        HoughCirclesContext* context = *pContext;
+        HoughData*           data    = 0;
+        int32_t              width   = edges->width;
+        int32_t              height  = edges->height;
+
+        minIntensity = XMAX( minIntensity, 1 );
+        maxCircles   = XMAX( maxCircles, 1 );
+
+        if ( context == 0 )
+        {
+            context = (HoughCirclesContext*) XCAlloc( 1, sizeof( HoughCirclesContext ) );
+
+            if ( context == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
+            {
+                *pContext = context;
+            }
+        }
+
+        if ( ret == SuccessCode )
+        {
+            context->CirclesCount = 0;
+
+            ret = PrepareHoughData( &context->Data, edges, (uint32_t) ( width * height ) );
+        }
+
+        if ( ret == SuccessCode )
+        {
+            data = (HoughData*) context->Data;
+            ret  = PrepareResults( data, (void**) &context->Circles, sizeof( HoughCircle ), maxCircles );
+        }
+
+        // make sure radius histogram is allocated
+        if ( ( ret == SuccessCode ) && ( data->AllocatedHistogramSize < maxRadius + 2 ) )
+        {
+            if ( data->RadiusHistogram != 0 )
+            {
+                free( data->RadiusHistogram );
+            }
+
+            data->AllocatedHistogramSize = 0;
+            data->RadiusHistogram        = (uint32_t*) malloc( ( maxRadius + 2 ) * sizeof( uint32_t ) );
+
+            if ( data->RadiusHistogram == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
+            {
+                data->AllocatedHistogramSize = maxRadius + 2;
+            }
+        }
+
+        // 1 - collect edge pixels along with their gradient directions
+        if ( ret == SuccessCode )
+        {
+            ret = CollectEdgePoints( data, edges, grayImage, true );
+        }
+
+        // 2 - every edge pixel votes for centers lying on its gradient line within the radius range
+        if ( ret == SuccessCode )
+        {
+            EdgePoint* points          = data->Points;
+            int        pointsCount     = (int) data->PointsCount;
+            uint32_t*  accumulators    = data->Accumulators;
+            uint32_t   accumulatorSize = data->AccumulatorSize;
+            float*     cosTable        = data->CosTable;
+            float*     sinTable        = data->SinTable;
+            int32_t    rMin            = (int32_t) minRadius;
+            int32_t    rMax            = (int32_t) maxRadius;
+
+            #pragma omp parallel num_threads( data->ThreadsCount ) shared( data, points, pointsCount, accumulators, accumulatorSize, cosTable, sinTable, rMin, rMax, width, height )
+            {
+                uint32_t* accumulator = accumulators + omp_get_thread_num( ) * accumulatorSize;
+                float     x, y, nx, ny;
+                int32_t   r, cx, cy;
+                int       i;
+
+                #pragma omp master
+                {
+                    data->UsedThreadsCount = omp_get_num_threads( );
+                }
+
+                memset( accumulator, 0, accumulatorSize * sizeof( uint32_t ) );
+
+                #pragma omp for schedule(static)
+                for ( i = 0; i < pointsCount; i++ )
+                {
+                    if ( points[i].Theta < 0 )
+                    {
+                        continue;
+                    }
+
+                    x  = (float) points[i].X;
+                    y  = (float) points[i].Y;
+                    nx = cosTable[points[i].Theta];
+                    ny = sinTable[points[i].Theta];
+
+                    // the center can be on any side of the edge
+                    for ( r = rMin; r <= rMax; r++ )
+                    {
+                        cx = (int32_t) floorf( x + r * nx + 0.5f );
+                        cy = (int32_t) floorf( y + r * ny + 0.5f );
+
+                        if ( ( cx >= 0 ) && ( cy >= 0 ) && ( cx < width ) && ( cy < height ) )
+                        {
+                            accumulator[cy * width + cx]++;
+                        }
+
+                        cx = (int32_t) floorf( x - r * nx + 0.5f );
+                        cy = (int32_t) floorf( y - r * ny + 0.5f );
+
+                        if ( ( cx >= 0 ) && ( cy >= 0 ) && ( cx < width ) && ( cy < height ) )
+                        {
+                            accumulator[cy * width + cx]++;
+                        }
+                    }
+                }
+            }
+
+            MergeAccumulators( data, height, (uint32_t) width );
+        }
+
+        // 3 - find candidate centers - local maximums with at least half of the required intensity, since
+        //     votes of a circle's edge pixels spread around its center because of rounding
+        if ( ret == SuccessCode )
+        {
+            uint32_t* accumulator  = data->Accumulators;
+            uint32_t  minVotes     = XMAX( minIntensity / 2, 1 );
+            int32_t   x, y, dx, dy, nx, ny;
+            uint32_t  value, neighbour, index, neighbourIndex;
+            bool      isPeak;
+
+            data->PeaksCount = 0;
+
+            for ( y = 0; ( y < height ) && ( ret == SuccessCode ); y++ )
+            {
+                for ( x = 0; x < width; x++ )
+                {
+                    index = y * width + x;
+                    value = accumulator[index];
+
+                    if ( value < minVotes )
+                    {
+                        continue;
+                    }
+
+                    isPeak = true;
+
+                    for ( dy = -CIRCLE_CENTER_PEAK_RADIUS; ( dy <= CIRCLE_CENTER_PEAK_RADIUS ) && ( isPeak ); dy++ )
+                    {
+                        ny = y + dy;
+
+                        if ( ( ny < 0 ) || ( ny >= height ) )
+                        {
+                            continue;
+                        }
+
+                        for ( dx = -CIRCLE_CENTER_PEAK_RADIUS; dx <= CIRCLE_CENTER_PEAK_RADIUS; dx++ )
+                        {
+                            nx = x + dx;
+
+                            if ( ( nx < 0 ) || ( nx >= width ) || ( ( dx == 0 ) && ( dy == 0 ) ) )
+                            {
+                                continue;
+                            }
+
+                            neighbourIndex = ny * width + nx;
+                            neighbour      = accumulator[neighbourIndex];
+
+                            if ( ( neighbour > value ) || ( ( neighbour == value ) && ( neighbourIndex < index ) ) )
+                            {
+                                isPeak = false;
+                                break;
+                            }
+                        }
+                    }
+
+                    if ( isPeak )
+                    {
+                        ret = AddPeak( data, index, value );
+
+                        if ( ret != SuccessCode )
+                        {
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        // 4 - check candidates starting from the strongest ones and find radius supported by most edge pixels
+        if ( ret == SuccessCode )
+        {
+            uint32_t*  histogram      = data->RadiusHistogram;
+            EdgePoint* points         = data->Points;
+            uint32_t   candidatesLeft = maxCircles * CIRCLE_CANDIDATES_PER_CIRCLE;
+            int32_t    minDistance    = XMAX( (int32_t) minRadius, CIRCLE_CENTER_PEAK_RADIUS + 1 );
+            int32_t    maxDistance    = (int32_t) maxRadius + 1;
+            uint32_t   i, j, p, r, support, bestSupport, bestRadius;
+            int32_t    cx, cy, dx, dy, distance;
+            bool       tooClose;
+
+            if ( data->PeaksCount != 0 )
+            {
+                qsort( data->Peaks, data->PeaksCount, sizeof( HoughPeak ), ComparePeaks );
+            }
+
+            for ( i = 0; ( i < data->PeaksCount ) && ( context->CirclesCount < maxCircles ) && ( candidatesLeft != 0 ); i++, candidatesLeft-- )
+            {
+                cx = (int32_t) ( data->Peaks[i].Index % width );
+                cy = (int32_t) ( data->Peaks[i].Index / width );
+
+                // skip centers too close to already found circles
+                tooClose = false;
+
+                for ( j = 0; j < context->CirclesCount; j++ )
+                {
+                    dx = cx - context->Circles[j].Center.x;
+                    dy = cy - context->Circles[j].Center.y;
+
+                    if ( dx * dx + dy * dy < minDistance * minDistance )
+                    {
+                        tooClose = true;
+                        break;
+                    }
+                }
+
+                if ( tooClose )
+                {
+                    continue;
+                }
+
+                memset( histogram, 0, ( maxRadius + 2 ) * sizeof( uint32_t ) );
+
+                for ( p = 0; p < data->PointsCount; p++ )
+                {
+                    dx = points[p].X - cx;
+                    dy = points[p].Y - cy;
+
+                    if ( ( dx >= -maxDistance ) && ( dx <= maxDistance ) && ( dy >= -maxDistance ) && ( dy <= maxDistance ) )
+                    {
+                        distance = (int32_t) floor( sqrt( (double) ( dx * dx + dy * dy ) ) + 0.5 );
+
+                        if ( distance <= maxDistance )
+                        {
+                            histogram[distance]++;
+                        }
+                    }
+                }
+
+                // edges are not perfect circles, so take neighbour radiuses into account as well
+                bestSupport = 0;
+                bestRadius  = minRadius;
+
+                for ( r = minRadius; r <= maxRadius; r++ )
+                {
+                    support = histogram[r - 1] + histogram[r] + histogram[r + 1];
+
+                    if ( support > bestSupport )
+                    {
+                        bestSupport = support;
+                        bestRadius  = r;
+                    }
+                }
+
+                if ( bestSupport >= minIntensity )
+                {
+                    context->Circles[context->CirclesCount].Center.x  = cx;
+                    context->Circles[context->CirclesCount].Center.y  = cy;
+                    context->Circles[context->CirclesCount].Radius    = bestRadius;
+                    context->Circles[context->CirclesCount].Intensity = bestSupport;
+                    context->CirclesCount++;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
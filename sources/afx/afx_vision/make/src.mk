@@ -4,7 +4,8 @@
 VPATH = ../../
 
 # source files
-SRC = barcode_detector.c glyph_detector.c integral_image.c
+SRC = barcode_detector.c corner_detector.c glyph_detector.c hough_transform.c \
+    integral_image.c optical_flow.c
 
 # additional include folders
 INCLUDES = -I../../../afx_types -I../../../afx_imaging
@@ -0,0 +1,532 @@
+/*
+    Computer vision library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <math.h>
+#include <memory.h>
+#include "xvision.h"
+#include <ximaging.h>
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+// Maximum number of pyramid levels and maximum size of tracking window
+#define MAX_PYRAMID_LEVELS  (6)
+#define MAX_WINDOW_SIZE     (31)
+// Minimum size of pyramid's smallest level
+#define MIN_LEVEL_SIZE      (16)
+
+// Tracking of a point stops, when its position changes less than this value (in pixels)
+#define LK_EPSILON          (0.01f)
+// Minimum eigen value of spatial gradient matrix (per pixel) - smaller values mean there is not enough texture to track
+#define LK_MIN_EIGEN_VALUE  (1.0f)
+
+// Pyramid of grayscale images - every next level is half the size of the previous one
+typedef struct _imagePyramid
+{
+    ximage* Levels[MAX_PYRAMID_LEVELS];
+    int     LevelsCount;
+}
+ImagePyramid;
+
+// Internal data of optical flow calculation
+typedef struct _opticalFlowData
+{
+    ImagePyramid Pyramids[2];
+    int          CurrentPyramid;
+    bool         HasPreviousImage;
+    uint32_t     AllocatedPointsCount;
+}
+OpticalFlowData;
+
+// Free optical flow context
+void FreeOpticalFlowContext( OpticalFlowContext** pContext )
+{
+    if ( ( pContext != 0 ) && ( *pContext != 0 ) )
+    {
+        OpticalFlowData* data = (OpticalFlowData*) ( *pContext )->Data;
+
+        if ( data != 0 )
+        {
+            int i, j;
+
+            for ( i = 0; i < 2; i++ )
+            {
+                for ( j = 0; j < MAX_PYRAMID_LEVELS; j++ )
+                {
+                    XImageFree( &data->Pyramids[i].Levels[j] );
+                }
+            }
+
+            free( data );
+        }
+
+        if ( ( *pContext )->Points != 0 )
+        {
+            free( ( *pContext )->Points );
+        }
+
+        XFree( (void**) pContext );
+    }
+}
+
+// Downsample image twice using [1 2 1] x [1 2 1] smoothing kernel
+static void DownsampleImage( const ximage* src, ximage* dst )
+{
+    int srcWidth  = src->width;
+    int srcHeight = src->height;
+    int srcStride = src->stride;
+    int dstWidth  = dst->width;
+    int dstHeight = dst->height;
+    int y;
+
+    #pragma omp parallel for schedule(static) shared( src, dst, srcWidth, srcHeight, srcStride, dstWidth, dstHeight )
+    for ( y = 0; y < dstHeight; y++ )
+    {
+        int      sy      = y * 2;
+        uint8_t* srcRow0 = src->data + XMAX( sy - 1, 0 ) * srcStride;
+        uint8_t* srcRow1 = src->data + sy * srcStride;
+        uint8_t* srcRow2 = src->data + XMIN( sy + 1, srcHeight - 1 ) * srcStride;
+        uint8_t* dstRow  = dst->data + y * dst->stride;
+        int      x, sx, sx0, sx2;
+
+        for ( x = 0; x < dstWidth; x++ )
+        {
+            sx  = x * 2;
+            sx0 = sx - 1;
+            sx2 = sx + 1;
+
+            // only the first and the last columns need clamping
+            if ( ( x == 0 ) || ( x == dstWidth - 1 ) )
+            {
+                sx0 = XMAX( sx0, 0 );
+                sx2 = XMIN( sx2, srcWidth - 1 );
+            }
+
+            dstRow[x] = (uint8_t) ( (     srcRow0[sx0] + 2 * srcRow0[sx] +     srcRow0[sx2] +
+                                      2 * srcRow1[sx0] + 4 * srcRow1[sx] + 2 * srcRow1[sx2] +
+                                          srcRow2[sx0] + 2 * srcRow2[sx] +     srcRow2[sx2] + 8 ) >> 4 );
+        }
+    }
+}
+
+// Build pyramid of the specified image
+static XErrorCode BuildPyramid( const ximage* image, int levelsCount, ImagePyramid* pyramid )
+{
+    XErrorCode ret    = SuccessCode;
+    int32_t    width  = image->width;
+    int32_t    height = image->height;
+    int        level;
+
+    pyramid->LevelsCount = 0;
+
+    ret = XImageAllocateRaw( width, height, XPixelFormatGrayscale8, &pyramid->Levels[0] );
+
+    if ( ret == SuccessCode )
+    {
+        ret = ( image->format == XPixelFormatGrayscale8 ) ? XImageCopyData( image, pyramid->Levels[0] ) :
+                                                            ColorToGrayscale( image, pyramid->Levels[0] );
+    }
+
+    if ( ret == SuccessCode )
+    {
+        pyramid->LevelsCount = 1;
+
+        for ( level = 1; level < levelsCount; level++ )
+        {
+            width  = ( width  + 1 ) / 2;
+            height = ( height + 1 ) / 2;
+
+            if ( ( width < MIN_LEVEL_SIZE ) || ( height < MIN_LEVEL_SIZE ) )
+            {
+                break;
+            }
+
+            ret = XImageAllocateRaw( width, height, XPixelFormatGrayscale8, &pyramid->Levels[level] );
+
+            if ( ret != SuccessCode )
+            {
+                break;
+            }
+
+            DownsampleImage( pyramid->Levels[level - 1], pyramid->Levels[level] );
+            pyramid->LevelsCount++;
+        }
+    }
+
+    return ret;
+}
+
+// Sample square patch of the image centered at the specified point using bilinear interpolation
+// (coordinates are clamped to image's borders)
+static void SamplePatch( const ximage* image, float x, float y, int radius, float* patch )
+{
+    int      size   = radius * 2 + 1;
+    int      stride = image->stride;
+    int      maxX   = image->width  - 1;
+    int      maxY   = image->height - 1;
+    int      ix     = (int) floorf( x );
+    int      iy     = (int) floorf( y );
+    float    fx     = x - ix;
+    float    fy     = y - iy;
+    // fractional part is the same for all pixels of the patch, so are the interpolation weights
+    float    w00    = ( 1.0f - fx ) * ( 1.0f - fy );
+    float    w10    = fx * ( 1.0f - fy );
+    float    w01    = ( 1.0f - fx ) * fy;
+    float    w11    = fx * fy;
+    uint8_t* row0;
+    uint8_t* row1;
+    int      i, j;
+
+    ix -= radius;
+    iy -= radius;
+
+    if ( ( ix >= 0 ) && ( iy >= 0 ) && ( ix + size <= maxX ) && ( iy + size <= maxY ) )
+    {
+        for ( j = 0; j < size; j++ )
+        {
+            row0 = image->data + ( iy + j ) * stride + ix;
+            row1 = row0 + stride;
+
+            for ( i = 0; i < size; i++, patch++ )
+            {
+                *patch = w00 * row0[i] + w10 * row0[i + 1] + w01 * row1[i] + w11 * row1[i + 1];
+            }
+        }
+    }
+    else
+    {
+        int x0, x1;
+
+        for ( j = 0; j < size; j++ )
+        {
+            row0 = image->data + XINRANGE( iy + j,     0, maxY ) * stride;
+            row1 = image->data + XINRANGE( iy + j + 1, 0, maxY ) * stride;
+
+            for ( i = 0; i < size; i++, patch++ )
+            {
+                x0 = XINRANGE( ix + i,     0, maxX );
+                x1 = XINRANGE( ix + i + 1, 0, maxX );
+
+                *patch = w00 * row0[x0] + w10 * row0[x1] + w01 * row1[x0] + w11 * row1[x1];
+            }
+        }
+    }
+}
+
+// Track single point from previous pyramid to the current one
+static void TrackPoint( const ImagePyramid* prevPyramid, const ImagePyramid* curPyramid, int levelsCount,
+                        xpointf point, int radius, int maxIterations, TrackedPoint* result )
+{
+    float   extPatch[( MAX_WINDOW_SIZE + 2 ) * ( MAX_WINDOW_SIZE + 2 )];
+    float   patchI[MAX_WINDOW_SIZE * MAX_WINDOW_SIZE];
+    float   gradX[MAX_WINDOW_SIZE * MAX_WINDOW_SIZE];
+    float   gradY[MAX_WINDOW_SIZE * MAX_WINDOW_SIZE];
+    float   patchJ[MAX_WINDOW_SIZE * MAX_WINDOW_SIZE];
+    int     size       = radius * 2 + 1;
+    int     extSize    = size + 2;
+    int     pixels     = size * size;
+    float   guessX     = 0, guessY = 0;
+    float   vx, vy, px, py, qx, qy, dx, dy, bx, by, diff;
+    float   gxx, gyy, gxy, det, minEigen;
+    bool    found      = true;
+    int     level, iteration, i, j, k;
+    const ximage* prevImage;
+    const ximage* curImage;
+
+    for ( level = levelsCount - 1; ( level >= 0 ) && ( found ); level-- )
+    {
+        float scale = 1.0f / (float) ( 1 << level );
+
+        prevImage = prevPyramid->Levels[level];
+        curImage  = curPyramid->Levels[level];
+
+        px = point.x * scale;
+        py = point.y * scale;
+
+        // 1 - patch of the previous image along with its gradients
+        SamplePatch( prevImage, px, py, radius + 1, extPatch );
+
+        gxx = gyy = gxy = 0;
+
+        for ( j = 0, k = 0; j < size; j++ )
+        {
+            float* row = extPatch + ( j + 1 ) * extSize + 1;
+
+            for ( i = 0; i < size; i++, k++ )
+            {
+                patchI[k] = row[i];
+                gradX[k]  = ( row[i + 1] - row[i - 1] ) * 0.5f;
+                gradY[k]  = ( row[i + extSize] - row[i - extSize] ) * 0.5f;
+
+                gxx += gradX[k] * gradX[k];
+                gyy += gradY[k] * gradY[k];
+                gxy += gradX[k] * gradY[k];
+            }
+        }
+
+        det      = gxx * gyy - gxy * gxy;
+        minEigen = ( gxx + gyy - sqrtf( ( gxx - gyy ) * ( gxx - gyy ) + 4.0f * gxy * gxy ) ) * 0.5f / pixels;
+
+        if ( ( minEigen < LK_MIN_EIGEN_VALUE ) || ( det < 1e-6f ) )
+        {
+            // not enough texture - the point is lost if it happens on the original image,
+            // otherwise just propagate the current guess to the next level
+            if ( level == 0 )
+            {
+                found = false;
+            }
+            else
+            {
+                guessX *= 2.0f;
+                guessY *= 2.0f;
+            }
+            continue;
+        }
+
+        // 2 - iteratively refine displacement at this level
+        vx = vy = 0;
+
+        for ( iteration = 0; iteration < maxIterations; iteration++ )
+        {
+            qx = px + guessX + vx;
+            qy = py + guessY + vy;
+
+            if ( ( qx < 0 ) || ( qy < 0 ) || ( qx > curImage->width - 1 ) || ( qy > curImage->height - 1 ) )
+            {
+                found = false;
+                break;
+            }
+
+            SamplePatch( curImage, qx, qy, radius, patchJ );
+
+            bx = by = 0;
+
+            for ( k = 0; k < pixels; k++ )
+            {
+                diff = patchI[k] - patchJ[k];
+                bx  += diff * gradX[k];
+                by  += diff * gradY[k];
+            }
+
+            dx = (  gyy * bx - gxy * by ) / det;
+            dy = ( -gxy * bx + gxx * by ) / det;
+
+            vx += dx;
+            vy += dy;
+
+            if ( dx * dx + dy * dy < LK_EPSILON * LK_EPSILON )
+            {
+                break;
+            }
+        }
+
+        if ( level != 0 )
+        {
+            guessX = 2.0f * ( guessX + vx );
+            guessY = 2.0f * ( guessY + vy );
+        }
+        else
+        {
+            guessX += vx;
+            guessY += vy;
+        }
+    }
+
+    if ( found )
+    {
+        qx = point.x + guessX;
+        qy = point.y + guessY;
+
+        curImage = curPyramid->Levels[0];
+
+        if ( ( qx < 0 ) || ( qy < 0 ) || ( qx > curImage->width - 1 ) || ( qy > curImage->height - 1 ) )
+        {
+            found = false;
+        }
+        else
+        {
+            // error is the average absolute difference between final patches
+            SamplePatch( curImage, qx, qy, radius, patchJ );
+
+            diff = 0;
+            for ( k = 0; k < pixels; k++ )
+            {
+                diff += fabsf( patchI[k] - patchJ[k] );
+            }
+
+            result->Point.x = qx;
+            result->Point.y = qy;
+            result->Error   = diff / pixels;
+        }
+    }
+
+    if ( !found )
+    {
+        result->Point = point;
+        result->Error = 0;
+    }
+
+    result->Found = found;
+}
+
+// Track points from the previously provided image to the specified one using pyramidal Lucas-Kanade optical flow
+XErrorCode TrackPointsLucasKanade( const ximage* image, const xpointf* points, uint32_t pointsCount,
+                                   uint16_t windowSize, uint8_t pyramidLevels, uint8_t maxIterations, OpticalFlowContext** pContext )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( image == 0 ) || ( pContext == 0 ) || ( ( points == 0 ) && ( pointsCount != 0 ) ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( image->format != XPixelFormatGrayscale8 ) &&
+              ( image->format != XPixelFormatRGB24 ) &&
+              ( image->format != XPixelFormatRGBA32 ) )
+    {
+        ret = ErrorUnsupportedPixelFormat;
+    }
+    else
+    {
+        OpticalFlowContext* context = *pContext;
+        OpticalFlowData*    data    = 0;
+
+        // window size must be odd
+        windowSize    = XINRANGE( windowSize, 3, MAX_WINDOW_SIZE ) | 1;
+        pyramidLevels = XINRANGE( pyramidLevels, 1, MAX_PYRAMID_LEVELS );
+        maxIterations = XMAX( maxIterations, 1 );
+
+        if ( context == 0 )
+        {
+            context = (OpticalFlowContext*) XCAlloc( 1, sizeof( OpticalFlowContext ) );
+
+            if ( context == 0 )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
+            {
+                *pContext = context;
+            }
+        }
+
+        if ( ret == SuccessCode )
+        {
+            context->PointsCount = 0;
+
+            if ( context->Data == 0 )
+            {
+                context->Data = calloc( 1, sizeof( OpticalFlowData ) );
+
+                if ( context->Data == 0 )
+                {
+                    ret = ErrorOutOfMemory;
+                }
+            }
+        }
+
+        if ( ret == SuccessCode )
+        {
+            data = (OpticalFlowData*) context->Data;
+
+            if ( ( context->Points == 0 ) || ( data->AllocatedPointsCount < pointsCount ) )
+            {
+                if ( context->Points != 0 )
+                {
+                    free( context->Points );
+                }
+
+                data->AllocatedPointsCount = 0;
+                context->Points = (TrackedPoint*) malloc( XMAX( pointsCount, 1 ) * sizeof( TrackedPoint ) );
+
+                if ( context->Points == 0 )
+                {
+                    ret = ErrorOutOfMemory;
+                }
+                else
+                {
+                    data->AllocatedPointsCount = XMAX( pointsCount, 1 );
+                }
+            }
+        }
+
+        // build pyramid of the new image, keeping the previous one
+        if ( ret == SuccessCode )
+        {
+            data->CurrentPyramid ^= 1;
+
+            ret = BuildPyramid( image, pyramidLevels, &data->Pyramids[data->CurrentPyramid] );
+
+            if ( ret != SuccessCode )
+            {
+                data->HasPreviousImage = false;
+            }
+        }
+
+        if ( ret == SuccessCode )
+        {
+            const ImagePyramid* curPyramid  = &data->Pyramids[data->CurrentPyramid];
+            const ImagePyramid* prevPyramid = &data->Pyramids[data->CurrentPyramid ^ 1];
+            TrackedPoint*       results     = context->Points;
+            int                 count       = (int) pointsCount;
+            int                 radius      = windowSize / 2;
+            int                 iterations  = maxIterations;
+            int                 levelsCount = XMIN( curPyramid->LevelsCount, prevPyramid->LevelsCount );
+            int                 i;
+
+            if ( ( !data->HasPreviousImage ) ||
+                 ( prevPyramid->Levels[0]->width  != image->width ) ||
+                 ( prevPyramid->Levels[0]->height != image->height ) )
+            {
+                // nothing to track from
+                for ( i = 0; i < count; i++ )
+                {
+                    results[i].Point = points[i];
+                    results[i].Found = false;
+                    results[i].Error = 0;
+                }
+            }
+            else
+            {
+                #pragma omp parallel for schedule(dynamic, 8) shared( curPyramid, prevPyramid, results, points, count, radius, iterations, levelsCount )
+                for ( i = 0; i < count; i++ )
+                {
+                    TrackPoint( prevPyramid, curPyramid, levelsCount, points[i], radius, iterations, &results[i] );
+                }
+            }
+
+            context->PointsCount   = pointsCount;
+            data->HasPreviousImage = true;
+        }
+    }
+
+    return ret;
+}
+
+// Forget the previously provided image, so tracking starts from scratch
+void ResetOpticalFlowContext( OpticalFlowContext* context )
+{
+    if ( ( context != 0 ) && ( context->Data != 0 ) )
+    {
+        ( (OpticalFlowData*) context->Data )->HasPreviousImage = false;
+        context->PointsCount = 0;
+    }
+}
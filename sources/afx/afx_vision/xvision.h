@@ -89,6 +89,137 @@ void FreeBarcodeDetectionContext( BarcodeDetectionContext** pContext );
 // Find 1D linear bar codes in the specified image. Context is allocated and can be reused by subsequent call.
 XErrorCode FindBarcodes( const ximage* image, uint32_t maxBarcodes, BarcodeDetectionContext** pContext );
 
+// ===== Hough transform =====
+
+// Straight line found by Hough transform. It is described in polar coordinates relative to the image's center
+// ( width / 2, height / 2 ): x * cos( Theta ) + y * sin( Theta ) = Radius, where Y axis goes down like image's rows.
+typedef struct _houghLine
+{
+    float    Theta;      // angle of line's normal in degrees, [0, 180)
+    float    Radius;     // signed distance from image's center to the line
+    uint32_t Intensity;  // number of edge pixels voted for the line
+}
+HoughLine;
+
+// Circle found by Hough transform
+typedef struct _houghCircle
+{
+    xpoint   Center;
+    uint32_t Radius;
+    uint32_t Intensity;  // number of edge pixels lying on the circle
+}
+HoughCircle;
+
+// Hough lines detection context containing found lines, as well as internal data structures required for detection
+typedef struct _houghLinesContext
+{
+    void*      Data;
+    uint32_t   LinesCount;
+    HoughLine* Lines;
+}
+HoughLinesContext;
+
+// Hough circles detection context containing found circles, as well as internal data structures required for detection
+typedef struct _houghCirclesContext
+{
+    void*        Data;
+    uint32_t     CirclesCount;
+    HoughCircle* Circles;
+}
+HoughCirclesContext;
+
+// Free Hough lines detection context allocated by FindHoughLines()
+void FreeHoughLinesContext( HoughLinesContext** pContext );
+
+// Free Hough circles detection context allocated by FindHoughCircles()
+void FreeHoughCirclesContext( HoughCirclesContext** pContext );
+
+// Find straight lines in the edges image (8bpp grayscale, non zero pixels are edges). If gradient window is
+// not 0, every edge pixel votes only for lines with normal deviating from its gradient direction by up to the
+// specified number of degrees. Gradient directions are calculated from the optional grayscale image (the one
+// edges were detected on) or estimated from orientation of neighbour edge pixels, if it is not provided.
+// Lines are local maximums of Hough space within the specified radius, sorted by intensity in descending order.
+// Context is allocated and can be reused by subsequent call.
+XErrorCode FindHoughLines( const ximage* edges, const ximage* grayImage, uint16_t gradientWindow,
+                           uint32_t minIntensity, uint16_t localPeakRadius, uint32_t maxLines, HoughLinesContext** pContext );
+
+// Get points where the specified line crosses borders of the image it was found in
+XErrorCode GetHoughLineEndPoints( const HoughLine* line, int32_t imageWidth, int32_t imageHeight, xpoint* point1, xpoint* point2 );
+
+// Find circles with radius in the specified range in the edges image (8bpp grayscale, non zero pixels are edges).
+// Every edge pixel votes for centers along its gradient direction, which is calculated from the optional grayscale
+// image or estimated from orientation of neighbour edge pixels. Intensity of a circle is the number of edge pixels
+// lying on it. Found circles are sorted by votes of their centers in descending order.
+// Context is allocated and can be reused by subsequent call.
+XErrorCode FindHoughCircles( const ximage* edges, const ximage* grayImage, uint32_t minRadius, uint32_t maxRadius,
+                             uint32_t minIntensity, uint32_t maxCircles, HoughCirclesContext** pContext );
+
+// ===== Corners detection =====
+
+// Information about detected corner
+typedef struct _detectedCorner
+{
+    xpoint Point;
+    float  Score;
+}
+DetectedCorner;
+
+// Corners detection context containing detected corners, as well as internal data structures required for detection
+typedef struct _cornersDetectionContext
+{
+    void*           Data;
+    uint32_t        CornersCount;
+    DetectedCorner* Corners;
+}
+CornersDetectionContext;
+
+// Free corners detection context allocated by corners detection functions
+void FreeCornersDetectionContext( CornersDetectionContext** pContext );
+
+// Find corners in the specified image using FAST-9 detector - a pixel is a corner if at least 9 contiguous pixels of
+// the circle around it are all brighter or darker by the threshold. The image is divided into grid of cells and only
+// the strongest corner is kept in each cell, so corners are distributed evenly. Corners are sorted by score.
+// Context is allocated and can be reused by subsequent call.
+XErrorCode FindFastCorners( const ximage* image, uint8_t threshold, uint16_t cellSize, uint32_t maxCorners, CornersDetectionContext** pContext );
+
+// Find corners in the specified image using Harris detector. Corners with response less than quality level multiplied
+// by the strongest response are ignored. Only the strongest corner is kept in each cell of the grid, same as for FAST.
+// Context is allocated and can be reused by subsequent call.
+XErrorCode FindHarrisCorners( const ximage* image, float qualityLevel, uint16_t cellSize, uint32_t maxCorners, CornersDetectionContext** pContext );
+
+// ===== Optical flow =====
+
+// Point tracked by optical flow
+typedef struct _trackedPoint
+{
+    xpointf Point;  // position in the last image (or the original position if the point was lost)
+    bool    Found;
+    float   Error;  // average absolute difference of pixels around the point in previous and last images
+}
+TrackedPoint;
+
+// Optical flow context containing tracked points, as well as pyramid of the last image
+typedef struct _opticalFlowContext
+{
+    void*         Data;
+    uint32_t      PointsCount;
+    TrackedPoint* Points;
+}
+OpticalFlowContext;
+
+// Free optical flow context allocated by TrackPointsLucasKanade()
+void FreeOpticalFlowContext( OpticalFlowContext** pContext );
+
+// Forget the previously provided image, so the next call does not track anything
+void ResetOpticalFlowContext( OpticalFlowContext* context );
+
+// Track points from the previously provided image to the specified one using sparse pyramidal Lucas-Kanade
+// optical flow. Pyramid of the image is kept in the context and used as the previous one by the next call, so
+// every image is processed once. If there is no previous image (first call or image size changed), all points
+// are reported as not found. Window size must be odd, up to 31.
+XErrorCode TrackPointsLucasKanade( const ximage* image, const xpointf* points, uint32_t pointsCount,
+                                   uint16_t windowSize, uint8_t pyramidLevels, uint8_t maxIterations, OpticalFlowContext** pContext );
+
 #ifdef __cplusplus
 }
 #endif
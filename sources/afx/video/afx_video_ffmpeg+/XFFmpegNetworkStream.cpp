@@ -25,6 +25,7 @@
 #include <XManualResetEvent.hpp>
 #include <XThread.hpp>
 #include <XTimer.hpp>
+#include <xtimestamp.h>
 
 #include <algorithm>
 #include <functional>
@@ -471,6 +472,9 @@ void XFFmpegNetworkStream::RunVideo( )
                                             {
                                                 if ( packet.stream_index == videoStreamIndex )
                                                 {
+                                                    // packet is received - time stamp it before decoding
+                                                    int64_t captureTime = XTimestampNow( );
+
                                                     // decode video frame
                                                     avcodec_decode_video2( codecContext, frame, &frameFinished, &packet );
 
@@ -493,7 +497,7 @@ void XFFmpegNetworkStream::RunVideo( )
 
                                                                 if ( guardedImage )
                                                                 {
-                                                                    mData->Listener->OnNewImage( guardedImage );
+                                                                    mData->Listener->OnNewImage( guardedImage, captureTime );
                                                                 }
                                                             }
                                                         }
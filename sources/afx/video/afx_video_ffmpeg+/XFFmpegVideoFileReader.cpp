@@ -20,6 +20,8 @@
 */
 
 #include "XFFmpegVideoFileReader.hpp"
+#include <vector>
+#include <algorithm>
 
 extern "C"
 {
@@ -49,6 +51,29 @@ namespace Private
         #define dstFormatRgb AV_PIX_FMT_RGB24
     #endif
 
+    // Signature and version of key frames' index files
+    static const uint32_t KEY_FRAMES_INDEX_MAGIC   = 0x4B535643; // "CVSK"
+    static const uint32_t KEY_FRAMES_INDEX_VERSION = 1;
+    static const char*    KEY_FRAMES_INDEX_EXTENSION = ".cvskfi";
+
+    // Header of key frames' index file
+    struct KeyFramesIndexHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        int64_t  FileSize;
+        int64_t  FramesTotal;
+        uint32_t StreamIndex;
+        uint32_t KeyFramesCount;
+    };
+
+    // Entry of key frames' index - time stamp (in stream's time base units) and number of the key frame
+    struct KeyFrameEntry
+    {
+        int64_t Timestamp;
+        int64_t FrameNumber;
+    };
+
     class XFFmpegVideoFileReaderData
     {
     private:
@@ -64,6 +89,12 @@ namespace Private
         int              VideoStreamIndex;
         int              BytesRemaining;
 
+        vector<KeyFrameEntry> KeyFrames;
+        AVRational       TimeBase;
+        int64_t          StartTimestamp;
+        int64_t          FrameDuration;
+        bool             FramePending;
+
     public:
         string  CodecName;
         string  CodecLongName;
@@ -71,12 +102,16 @@ namespace Private
         int32_t FrameHeight;
         float   FrameRate;
         int64_t FramesTotal;
+        int64_t Duration;
+        int64_t NextFrameNumber;
 
     public:
         XFFmpegVideoFileReaderData( ) :
             FormatContext( nullptr ), CodecContext( nullptr ), CodecOptions( nullptr ), FrameConversionContext( nullptr ), Packet( ),
             NativeFrame( nullptr ), RgbFrame( nullptr ), VideoStreamIndex( -1 ), BytesRemaining( 0 ),
-            CodecName( ), CodecLongName( ), FrameWidth( 0 ), FrameHeight( 0 ), FrameRate( 0 ), FramesTotal( 0 )
+            KeyFrames( ), TimeBase( { 0, 1 } ), StartTimestamp( 0 ), FrameDuration( 1 ), FramePending( false ),
+            CodecName( ), CodecLongName( ), FrameWidth( 0 ), FrameHeight( 0 ), FrameRate( 0 ), FramesTotal( 0 ),
+            Duration( 0 ), NextFrameNumber( 0 )
         {
             // register all formats known to FFmpeg
             av_register_all( );
@@ -86,11 +121,37 @@ namespace Private
 
         XErrorCode Open( string fileName );
         XErrorCode GetNextFrame( shared_ptr<XImage>& image );
+        XErrorCode SeekToFrame( int64_t frameNumber );
+        XErrorCode SeekToTime( int64_t timeMs );
         void Close( );
         bool IsOpen( );
 
+        size_t KeyFramesCount( ) const
+        {
+            return KeyFrames.size( );
+        }
+        int64_t KeyFrameNumber( size_t index ) const
+        {
+            return ( index < KeyFrames.size( ) ) ? KeyFrames[index].FrameNumber : -1;
+        }
+        int64_t FrameTime( ) const
+        {
+            return ( ( NextFrameNumber == 0 ) || ( FrameRate <= 0 ) ) ? 0 :
+                static_cast<int64_t>( ( NextFrameNumber - 1 ) * 1000 / FrameRate );
+        }
+
     private:
+        XErrorCode DecodeFrame( );
         XErrorCode GetFrame( shared_ptr<XImage>& image );
+        const KeyFrameEntry FindKeyFrame( int64_t frameNumber ) const;
+        XErrorCode SeekToKeyFrame( const KeyFrameEntry& keyFrame );
+        int64_t TimestampToFrameNumber( int64_t timestamp ) const;
+
+        void BuildKeyFramesIndex( const string& fileName );
+        bool LoadKeyFramesIndex( const string& indexFileName );
+        void SaveKeyFramesIndex( const string& indexFileName );
+        bool CollectContainerKeyFrames( );
+        bool ScanKeyFrames( );
 
     };
 }
@@ -138,6 +199,30 @@ XErrorCode XFFmpegVideoFileReader::GetNextFrame( shared_ptr<XImage>& image )
     return ( mData->IsOpen( ) ) ? mData->GetNextFrame( image ) : ErrorFailed;
 }
 
+// Seek to the specified frame, so it is provided by the next call to GetNextFrame()
+XErrorCode XFFmpegVideoFileReader::SeekToFrame( int64_t frameNumber )
+{
+    return ( mData->IsOpen( ) ) ? mData->SeekToFrame( frameNumber ) : ErrorFailed;
+}
+
+// Seek to the specified time (ms), so the frame displayed at that time is provided by the next call to GetNextFrame()
+XErrorCode XFFmpegVideoFileReader::SeekToTime( int64_t timeMs )
+{
+    return ( mData->IsOpen( ) ) ? mData->SeekToTime( timeMs ) : ErrorFailed;
+}
+
+// Number of the frame to be provided by the next call to GetNextFrame()
+int64_t XFFmpegVideoFileReader::NextFrameNumber( ) const
+{
+    return mData->NextFrameNumber;
+}
+
+// Time (ms) of the frame provided by the last call to GetNextFrame()
+int64_t XFFmpegVideoFileReader::FrameTime( ) const
+{
+    return mData->FrameTime( );
+}
+
 // Get codec name
 const string XFFmpegVideoFileReader::CodecName( ) const
 {
@@ -162,6 +247,24 @@ int64_t XFFmpegVideoFileReader::FramesTotal( ) const
     return mData->FramesTotal;
 }
 
+// Duration of the video (ms)
+int64_t XFFmpegVideoFileReader::Duration( ) const
+{
+    return mData->Duration;
+}
+
+// Number of key frames found in the video
+size_t XFFmpegVideoFileReader::KeyFramesCount( ) const
+{
+    return mData->KeyFramesCount( );
+}
+
+// Number of the key frame with the specified index (zero based)
+int64_t XFFmpegVideoFileReader::KeyFrameNumber( size_t index ) const
+{
+    return mData->KeyFrameNumber( index );
+}
+
 namespace Private
 {
 
@@ -257,6 +360,30 @@ XErrorCode XFFmpegVideoFileReaderData::Open( string fileName )
                                 FrameConversionContext = sws_getContext( FrameWidth, FrameHeight, CodecContext->pix_fmt,
                                                                          FrameWidth, FrameHeight, dstFormatRgb, SWS_BILINEAR,
                                                                          nullptr, nullptr, nullptr );
+
+                                TimeBase       = videoStream->time_base;
+                                StartTimestamp = ( videoStream->start_time != AV_NOPTS_VALUE ) ? videoStream->start_time : 0;
+
+                                if ( videoStream->r_frame_rate.num > 0 )
+                                {
+                                    FrameDuration = XMAX( av_rescale_q( 1, av_inv_q( videoStream->r_frame_rate ), TimeBase ), 1 );
+                                }
+
+                                if ( videoStream->duration != AV_NOPTS_VALUE )
+                                {
+                                    Duration = av_rescale_q( videoStream->duration, TimeBase, { 1, 1000 } );
+                                }
+                                else if ( FormatContext->duration != AV_NOPTS_VALUE )
+                                {
+                                    Duration = FormatContext->duration / ( AV_TIME_BASE / 1000 );
+                                }
+
+                                BuildKeyFramesIndex( fileName );
+
+                                if ( ( Duration <= 0 ) && ( FrameRate > 0 ) )
+                                {
+                                    Duration = static_cast<int64_t>( FramesTotal * 1000 / FrameRate );
+                                }
                             }
                         }
                     }
@@ -322,6 +449,11 @@ void XFFmpegVideoFileReaderData::Close( )
     VideoStreamIndex = -1;
     BytesRemaining   = 0;
 
+    KeyFrames.clear( );
+    StartTimestamp  = 0;
+    FrameDuration   = 1;
+    FramePending    = false;
+
     CodecName.clear( );
     CodecLongName.clear( );
 
@@ -329,6 +461,9 @@ void XFFmpegVideoFileReaderData::Close( )
     FrameHeight = 0;
     FrameRate   = 0;
     FramesTotal = 0;
+    Duration    = 0;
+
+    NextFrameNumber = 0;
 }
 
 // Check if there is an open video file
@@ -339,6 +474,34 @@ bool XFFmpegVideoFileReaderData::IsOpen( )
 
 // Get the next frame of the opened video file
 XErrorCode XFFmpegVideoFileReaderData::GetNextFrame( shared_ptr<XImage>& image )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( FramePending )
+    {
+        // the frame was already decoded while seeking
+        FramePending = false;
+    }
+    else
+    {
+        ret = DecodeFrame( );
+    }
+
+    if ( ret == SuccessCode )
+    {
+        ret = GetFrame( image );
+
+        if ( ret == SuccessCode )
+        {
+            NextFrameNumber++;
+        }
+    }
+
+    return ret;
+}
+
+// Decode the next frame of the opened video file into the native frame
+XErrorCode XFFmpegVideoFileReaderData::DecodeFrame( )
 {
     XErrorCode ret           = SuccessCode;
     int        bytesDecoded  = 0;
@@ -371,7 +534,6 @@ XErrorCode XFFmpegVideoFileReaderData::GetNextFrame( shared_ptr<XImage>& image )
 
             if ( frameFinished )
             {
-                ret = GetFrame( image );
                 break;
             }
         }
@@ -429,6 +591,268 @@ XErrorCode XFFmpegVideoFileReaderData::GetFrame( shared_ptr<XImage>& image )
     return ret;
 }
 
+// Seek to the specified frame, so it is provided by the next call to GetNextFrame()
+XErrorCode XFFmpegVideoFileReaderData::SeekToFrame( int64_t frameNumber )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( frameNumber < 0 )
+    {
+        ret = ErrorArgumentOutOfRange;
+    }
+    else
+    {
+        ret = SeekToKeyFrame( FindKeyFrame( frameNumber ) );
+
+        // decode forward till the requested frame
+        while ( ret == SuccessCode )
+        {
+            ret = DecodeFrame( );
+
+            if ( ret == SuccessCode )
+            {
+                if ( NextFrameNumber >= frameNumber )
+                {
+                    FramePending = true;
+                    break;
+                }
+
+                NextFrameNumber++;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Seek to the specified time (ms), so the frame displayed at that time is provided by the next call to GetNextFrame()
+XErrorCode XFFmpegVideoFileReaderData::SeekToTime( int64_t timeMs )
+{
+    // same as the video source plays files, frame rate is used to time frames (presentation time is ignored)
+    return ( timeMs < 0 ) ? ErrorArgumentOutOfRange :
+        SeekToFrame( static_cast<int64_t>( timeMs * ( ( FrameRate > 0 ) ? FrameRate : 30.0f ) / 1000 ) );
+}
+
+// Find the closest key frame at or before the specified frame
+const KeyFrameEntry XFFmpegVideoFileReaderData::FindKeyFrame( int64_t frameNumber ) const
+{
+    KeyFrameEntry keyFrame = { StartTimestamp, 0 };
+
+    if ( !KeyFrames.empty( ) )
+    {
+        auto next = upper_bound( KeyFrames.begin( ), KeyFrames.end( ), frameNumber,
+            []( int64_t number, const KeyFrameEntry& entry ) { return number < entry.FrameNumber; } );
+
+        // frames before the first key frame can not be decoded anyway
+        keyFrame = ( next == KeyFrames.begin( ) ) ? *next : *( next - 1 );
+    }
+
+    return keyFrame;
+}
+
+// Seek to the specified key frame and reset decoder's state
+XErrorCode XFFmpegVideoFileReaderData::SeekToKeyFrame( const KeyFrameEntry& keyFrame )
+{
+    XErrorCode ret           = SuccessCode;
+    int        frameFinished = 0;
+
+    // let decoder consume the rest of the current packet first - after a partial decode it does
+    // not expect anything else, which is not cleared by flushing its buffers
+    while ( BytesRemaining > 0 )
+    {
+        int bytesDecoded = avcodec_decode_video2( CodecContext, NativeFrame, &frameFinished, &Packet );
+
+        if ( bytesDecoded <= 0 )
+        {
+            break;
+        }
+
+        BytesRemaining -= bytesDecoded;
+    }
+
+    if ( av_seek_frame( FormatContext, VideoStreamIndex, keyFrame.Timestamp, AVSEEK_FLAG_BACKWARD ) < 0 )
+    {
+        ret = ErrorIOFailure;
+    }
+    else
+    {
+        // drop everything decoded/read before the seek
+        avcodec_flush_buffers( CodecContext );
+
+        if ( Packet.data != nullptr )
+        {
+            av_free_packet( &Packet );
+            Packet.data = nullptr;
+        }
+
+        BytesRemaining  = 0;
+        FramePending    = false;
+        NextFrameNumber = keyFrame.FrameNumber;
+    }
+
+    return ret;
+}
+
+// Convert time stamp (in stream's time base units) to frame number using frame rate
+int64_t XFFmpegVideoFileReaderData::TimestampToFrameNumber( int64_t timestamp ) const
+{
+    return ( timestamp - StartTimestamp + FrameDuration / 2 ) / FrameDuration;
+}
+
+// Build index of key frames - take it from container, load previously saved or scan the video file
+void XFFmpegVideoFileReaderData::BuildKeyFramesIndex( const string& fileName )
+{
+    string indexFileName = fileName + KEY_FRAMES_INDEX_EXTENSION;
+
+    if ( ( !CollectContainerKeyFrames( ) ) && ( !LoadKeyFramesIndex( indexFileName ) ) )
+    {
+        if ( ScanKeyFrames( ) )
+        {
+            SaveKeyFramesIndex( indexFileName );
+        }
+    }
+}
+
+// Collect key frames from the index provided by container (if any)
+bool XFFmpegVideoFileReaderData::CollectContainerKeyFrames( )
+{
+    AVStream* videoStream = FormatContext->streams[VideoStreamIndex];
+    // if container indexes all frames, then frame numbers are simply positions in the index
+    bool      allFramesIndexed = ( videoStream->nb_frames > 0 ) && ( videoStream->nb_index_entries == videoStream->nb_frames );
+
+    KeyFrames.clear( );
+
+    for ( int i = 0; i < videoStream->nb_index_entries; i++ )
+    {
+        const AVIndexEntry& entry = videoStream->index_entries[i];
+
+        if ( ( ( entry.flags & AVINDEX_KEYFRAME ) != 0 ) && ( ( entry.flags & AVINDEX_DISCARD_FRAME ) == 0 ) )
+        {
+            KeyFrames.push_back( { entry.timestamp, ( allFramesIndexed ) ? i : TimestampToFrameNumber( entry.timestamp ) } );
+        }
+    }
+
+    return ( !KeyFrames.empty( ) );
+}
+
+// Scan video packets of the file to find key frames (packets are not decoded)
+bool XFFmpegVideoFileReaderData::ScanKeyFrames( )
+{
+    bool ret = false;
+
+    KeyFrames.clear( );
+
+    // nothing to do if we can not get back to the beginning of the file
+    if ( ( FormatContext->pb != nullptr ) && ( ( FormatContext->pb->seekable & AVIO_SEEKABLE_NORMAL ) != 0 ) )
+    {
+        AVPacket packet;
+        int64_t  framesCount = 0;
+
+        av_init_packet( &packet );
+        packet.data = nullptr;
+        packet.size = 0;
+
+        while ( av_read_frame( FormatContext, &packet ) >= 0 )
+        {
+            if ( packet.stream_index == VideoStreamIndex )
+            {
+                if ( ( packet.flags & AV_PKT_FLAG_KEY ) != 0 )
+                {
+                    int64_t timestamp = ( packet.dts != AV_NOPTS_VALUE ) ? packet.dts : packet.pts;
+
+                    if ( timestamp != AV_NOPTS_VALUE )
+                    {
+                        KeyFrames.push_back( { timestamp, framesCount } );
+                    }
+                }
+
+                framesCount++;
+            }
+
+            av_free_packet( &packet );
+        }
+
+        if ( FramesTotal <= 0 )
+        {
+            FramesTotal = framesCount;
+        }
+
+        // rewind back to the first frame
+        if ( ( !KeyFrames.empty( ) ) &&
+             ( av_seek_frame( FormatContext, VideoStreamIndex, KeyFrames[0].Timestamp, AVSEEK_FLAG_BACKWARD ) >= 0 ) )
+        {
+            ret = true;
+        }
+        else
+        {
+            KeyFrames.clear( );
+            av_seek_frame( FormatContext, VideoStreamIndex, 0, AVSEEK_FLAG_BYTE );
+        }
+    }
+
+    return ret;
+}
+
+// Load previously saved index of key frames, if it was built for the same file
+bool XFFmpegVideoFileReaderData::LoadKeyFramesIndex( const string& indexFileName )
+{
+    AVIOContext* indexFile = nullptr;
+    bool         ret       = false;
+
+    if ( avio_open( &indexFile, indexFileName.c_str( ), AVIO_FLAG_READ ) >= 0 )
+    {
+        KeyFramesIndexHeader header;
+
+        if ( ( avio_read( indexFile, reinterpret_cast<unsigned char*>( &header ), sizeof( header ) ) == sizeof( header ) ) &&
+             ( header.Magic == KEY_FRAMES_INDEX_MAGIC ) && ( header.Version == KEY_FRAMES_INDEX_VERSION ) &&
+             ( header.FileSize == avio_size( FormatContext->pb ) ) &&
+             ( header.StreamIndex == static_cast<uint32_t>( VideoStreamIndex ) ) &&
+             ( header.KeyFramesCount != 0 ) && ( header.KeyFramesCount <= INT32_MAX / sizeof( KeyFrameEntry ) ) )
+        {
+            int entriesSize = static_cast<int>( header.KeyFramesCount * sizeof( KeyFrameEntry ) );
+
+            KeyFrames.resize( header.KeyFramesCount );
+
+            if ( avio_read( indexFile, reinterpret_cast<unsigned char*>( KeyFrames.data( ) ), entriesSize ) == entriesSize )
+            {
+                if ( FramesTotal <= 0 )
+                {
+                    FramesTotal = header.FramesTotal;
+                }
+
+                ret = true;
+            }
+            else
+            {
+                KeyFrames.clear( );
+            }
+        }
+
+        avio_closep( &indexFile );
+    }
+
+    return ret;
+}
+
+// Save index of key frames, so the video file does not need to be scanned next time
+void XFFmpegVideoFileReaderData::SaveKeyFramesIndex( const string& indexFileName )
+{
+    AVIOContext* indexFile = nullptr;
+
+    // failure is not an error - the file may simply be on read only media
+    if ( avio_open( &indexFile, indexFileName.c_str( ), AVIO_FLAG_WRITE ) >= 0 )
+    {
+        KeyFramesIndexHeader header = { KEY_FRAMES_INDEX_MAGIC, KEY_FRAMES_INDEX_VERSION, avio_size( FormatContext->pb ),
+                                        FramesTotal, static_cast<uint32_t>( VideoStreamIndex ),
+                                        static_cast<uint32_t>( KeyFrames.size( ) ) };
+
+        avio_write( indexFile, reinterpret_cast<const unsigned char*>( &header ), sizeof( header ) );
+        avio_write( indexFile, reinterpret_cast<const unsigned char*>( KeyFrames.data( ) ),
+                    static_cast<int>( KeyFrames.size( ) * sizeof( KeyFrameEntry ) ) );
+        avio_closep( &indexFile );
+    }
+}
+
 } // namespace Private
 
 } } } // namespace CVSandbox::Video::FFmpeg
@@ -48,7 +48,8 @@ public:
 
     static const std::shared_ptr<XFFmpegVideoFileReader> Create( );
 
-    // Open video file with the specified name
+    // Open video file with the specified name. If the file's container does not provide index of key frames, the file
+    // is scanned to build it on the first open. The index is then kept next to the video file (*.cvskfi) for later use.
     XErrorCode Open( std::string fileName  );
     // Close currently opened video file
     void Close( );
@@ -58,6 +59,15 @@ public:
     // Get next video frame of the opened file
     XErrorCode GetNextFrame( std::shared_ptr<CVSandbox::XImage>& image );
 
+    // Seek to the specified frame (zero based), so it is provided by the next call to GetNextFrame()
+    XErrorCode SeekToFrame( int64_t frameNumber );
+    // Seek to the specified time (ms), so the frame displayed at that time is provided by the next call to GetNextFrame()
+    XErrorCode SeekToTime( int64_t timeMs );
+    // Number of the frame to be provided by the next call to GetNextFrame()
+    int64_t NextFrameNumber( ) const;
+    // Time (ms) of the frame provided by the last call to GetNextFrame()
+    int64_t FrameTime( ) const;
+
     // Get codec name
     const std::string CodecName( ) const;
     const std::string CodecLongName( ) const;
@@ -66,6 +76,12 @@ public:
     const CVSandbox::XSize FrameSize( ) const;
     float FrameRate( ) const;
     int64_t FramesTotal( ) const;
+    // Duration of the video (ms)
+    int64_t Duration( ) const;
+    // Number of key frames found in the video
+    size_t KeyFramesCount( ) const;
+    // Number of the key frame with the specified index (zero based)
+    int64_t KeyFrameNumber( size_t index ) const;
 
 private:
     Private::XFFmpegVideoFileReaderData* mData;
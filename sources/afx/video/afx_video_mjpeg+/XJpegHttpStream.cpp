@@ -20,6 +20,9 @@
 */
 
 #include <time.h>
+#include <vector>
+#include <deque>
+#include <map>
 #include "XJpegHttpStream.hpp"
 
 #include <XMutex.hpp>
@@ -27,6 +30,7 @@
 #include <XThread.hpp>
 #include <XTimer.hpp>
 #include <ximaging_formats.h>
+#include <xtimestamp.h>
 
 #include <curl/curl.h>
 #include "base64.hpp"
@@ -42,6 +46,42 @@ namespace CVSandbox { namespace Video { namespace MJpeg
 // Namespace with some private stuff to hide
 namespace Private
 {
+    // Snapshot request kept in flight when running several concurrent requests
+    class SnapshotRequest
+    {
+    public:
+        SnapshotRequest( ) :
+            Curl( nullptr ), HeaderList( nullptr ), Buffer( nullptr ), BufferSize( 0 ), ReadSoFar( 0 ),
+            BufferOverflow( false ), IsBusy( false ), Sequence( 0 ), StartTickCount( 0 )
+        {
+        }
+
+    public:
+        CURL*               Curl;
+        struct curl_slist*  HeaderList;
+        uint8_t*            Buffer;
+        int                 BufferSize;
+        uint32_t            ReadSoFar;
+        bool                BufferOverflow;
+        bool                IsBusy;
+        uint32_t            Sequence;
+        uint64_t            StartTickCount;
+    };
+
+    // Downloaded JPEG image waiting to be decoded
+    class EncodedSnapshot
+    {
+    public:
+        EncodedSnapshot( ) : Failed( false ), Data( ), CaptureTime( 0 )
+        {
+        }
+
+    public:
+        bool                Failed;
+        vector<uint8_t>     Data;
+        int64_t             CaptureTime;
+    };
+
     // Internal class which hides private parts of the XJpegHttpStream class,
     // so those are not exposed in the main class
     class XJpegHttpStreamData
@@ -49,18 +89,32 @@ namespace Private
     public:
         XJpegHttpStreamData( const string& jpegUrl ) :
             JpegUrl( jpegUrl ), UserName( ), Password( ), UserAgent( ), ForceBasicAuthorization( false ), FrameIntervalMs( 100 ),
-            Listener( 0 ),
+            ConcurrentRequests( 1 ), Listener( 0 ),
             Sync( ), ExitEvent( ), BackgroundThread( ), FramesCounter( 0 ),
             TimeToSleepBeforeNextTry( 0 ), FailureDetected( false ),
-            CommunicationBuffer( nullptr), CommunicationBufferSize( 0 ), ReadSoFar( 0 )
+            CommunicationBuffer( nullptr), CommunicationBufferSize( 0 ), ReadSoFar( 0 ),
+            DecodeSync( ), DecodeEvent( ), DecodingThread( ), DecodeQueue( ), NeedToStopDecoding( false )
         {
         }
 
         // Run video loop in a background worker thread
         static void WorkerThreadHandler( void* param );
+        // Decode JPEG images in a background thread (concurrent requests mode)
+        static void DecodingThreadHandler( void* param );
 
         // Notify about error in the video source
         void NotifyError( const string& errorMessage );
+        // Notify listener about failure of a single request (concurrent requests mode, which has own pause on errors)
+        void ReportError( const string& errorMessage );
+
+        // Set options of libcurl handle, which are common for all requests - returns list of extra
+        // HTTP headers to be freed once the handle is not needed
+        struct curl_slist* ConfigureCurlHandle( CURL* curl );
+
+        // Queue downloaded JPEG image for decoding
+        void QueueForDecoding( EncodedSnapshot& snapshot, size_t maxQueueLength );
+        // Decode queued JPEG images and provide them to listener
+        void RunDecoding( );
 
     public:
         string                JpegUrl;
@@ -69,6 +123,7 @@ namespace Private
         string                UserAgent;
         bool                  ForceBasicAuthorization;
         uint16_t              FrameIntervalMs;
+        uint16_t              ConcurrentRequests;
 
         IVideoSourceListener* Listener;
 
@@ -82,6 +137,12 @@ namespace Private
         uint8_t*              CommunicationBuffer;
         int                   CommunicationBufferSize;
         uint32_t              ReadSoFar;
+
+        XMutex                  DecodeSync;
+        XManualResetEvent       DecodeEvent;
+        XThread                 DecodingThread;
+        deque<EncodedSnapshot>  DecodeQueue;
+        bool                    NeedToStopDecoding;
     };
 
     // Magic word of JPEG image
@@ -100,6 +161,11 @@ namespace Private
 
     // Callback function called by libcurl when data arrives
     static size_t CurlWriteMemoryCallback( void* contents, size_t size, size_t nmemb, void* userp );
+    // Callback function called by libcurl when data arrives for one of concurrent requests
+    static size_t CurlWriteRequestCallback( void* contents, size_t size, size_t nmemb, void* userp );
+
+    // Get error message for the specified HTTP response code
+    static string GetResponseErrorMessage( long responseCode, uint8_t* buffer, int bufferSize, uint32_t readSoFar );
 } // namespace Private
 
 // ==========================================================================
@@ -279,6 +345,21 @@ bool XJpegHttpStream::SetFrameInterval( uint16_t frameIntervalMs )
     return ret;
 }
 
+// Set number of snapshot requests to keep in flight
+bool XJpegHttpStream::SetConcurrentRequests( uint16_t requestsCount )
+{
+    XScopedLock lock( &mData->Sync );
+    bool        ret = false;
+
+    if ( !IsRunning( ) )
+    {
+        mData->ConcurrentRequests = XMAX( requestsCount, 1 );
+        ret = true;
+    }
+
+    return ret;
+}
+
 // Run video acquisition loop
 void XJpegHttpStream::RunVideo( )
 {
@@ -308,51 +389,10 @@ void XJpegHttpStream::RunVideo( )
 
         if ( ( curl != nullptr ) && ( multiHandle != nullptr ) )
         {
-            struct curl_slist* extraHeaderList = nullptr;
+            struct curl_slist* extraHeaderList = mData->ConfigureCurlHandle( curl );
 
             curl_easy_setopt( curl, CURLOPT_WRITEFUNCTION, Private::CurlWriteMemoryCallback );
             curl_easy_setopt( curl, CURLOPT_WRITEDATA, mData );
-            curl_easy_setopt( curl, CURLOPT_NOSIGNAL, 1 );
-
-            //curl_easy_setopt( curl, CURLOPT_VERBOSE, 1L );
-
-            if ( !mData->UserAgent.empty( ) )
-            {
-                string header = "User-Agent: " + mData->UserAgent;
-                extraHeaderList = curl_slist_append( extraHeaderList, header.c_str( ) );
-            }
-
-            // set user name/password if it was supplied
-            if ( !mData->UserName.empty( ) )
-            {
-                if ( !mData->ForceBasicAuthorization )
-                {
-                    curl_easy_setopt( curl, CURLOPT_USERNAME, mData->UserName.c_str( ) );
-                    curl_easy_setopt( curl, CURLOPT_PASSWORD, mData->Password.c_str( ) );
-                    curl_easy_setopt( curl, CURLOPT_HTTPAUTH, (long) CURLAUTH_ANY );
-                }
-                else
-                {
-                    // use custom header for basic authorization instead of libcurl's API,
-                    // because found a camera, which keeps rejecting libcurl's authorization
-
-                    string  loginWithPassword = mData->UserName + ":" + mData->Password;
-                    size_t  authLen           = Private::Base64EncodeLength( loginWithPassword.size( ) + 21 );
-                    char*   authorization     = new char[authLen];
-
-                    strcpy( authorization, "Authorization: Basic " );
-
-                    Private::Base64Encode( &(authorization[21]), loginWithPassword.c_str( ), loginWithPassword.size( ) );
-
-                    extraHeaderList = curl_slist_append( extraHeaderList, authorization );
-                    delete [] authorization;
-                }
-            }
-
-            if ( extraHeaderList != nullptr )
-            {
-                curl_easy_setopt( curl, CURLOPT_HTTPHEADER, extraHeaderList );
-            }
 
             while ( !mData->ExitEvent.Wait( mData->TimeToSleepBeforeNextTry ) )
             {
@@ -433,53 +473,8 @@ void XJpegHttpStream::RunVideo( )
 
                             if ( responseCode != 200 )
                             {
-                                string errorMessage;
-
-                                switch ( responseCode )
-                                {
-                                case 0:
-                                    errorMessage = "Connection failed";
-                                    break;
-
-                                case 401:
-                                    errorMessage = "HTTP 401: Not authorized";
-                                    break;
-
-                                case 404:
-                                    errorMessage = "HTTP 404: File not found";
-                                    break;
-
-                                default:
-                                    {
-                                        char msgBuffer[64];
-                                        sprintf( msgBuffer, "HTTP response code: %d", static_cast<int32_t>( responseCode ) );
-                                        errorMessage = msgBuffer;
-
-                                        if ( mData->ReadSoFar != 0 )
-                                        {
-                                            mData->CommunicationBuffer[mData->ReadSoFar] = 0;
-
-                                            bool   isHtml    = false;
-                                            string htmlTitle = Private::ExtractTitle( (char*) mData->CommunicationBuffer, &isHtml );
-
-                                            if ( !htmlTitle.empty( ) )
-                                            {
-                                                errorMessage += ", ";
-                                                errorMessage += htmlTitle;
-                                            }
-                                            else if ( !isHtml )
-                                            {
-                                                char* newLinePos = strchr( (char*) mData->CommunicationBuffer, '\n' );
-
-                                                errorMessage += ", ";
-                                                errorMessage += string( (char*) mData->CommunicationBuffer, ( newLinePos == nullptr ) ? mData->ReadSoFar : ( (uint8_t*) newLinePos - buffer ) );
-                                            }
-                                        }
-                                    }
-                                    break;
-                                }
-
-                                mData->NotifyError( errorMessage );
+                                mData->NotifyError( Private::GetResponseErrorMessage( responseCode, mData->CommunicationBuffer,
+                                                                                      mData->CommunicationBufferSize, mData->ReadSoFar ) );
                             }
                             else
                             {
@@ -495,6 +490,8 @@ void XJpegHttpStream::RunVideo( )
 
                                         if ( mData->Listener != 0 )
                                         {
+                                            // image is fully received - time stamp it before decoding
+                                            int64_t    captureTime = XTimestampNow( );
                                             // decode image only if someone needs it
                                             XErrorCode ret = XDecodeJpegFromMemory( &mData->CommunicationBuffer[jpegStartIndex], mData->ReadSoFar - jpegStartIndex, &image );
 
@@ -504,7 +501,7 @@ void XJpegHttpStream::RunVideo( )
 
                                                 if ( guardedImage )
                                                 {
-                                                    mData->Listener->OnNewImage( guardedImage );
+                                                    mData->Listener->OnNewImage( guardedImage, captureTime );
                                                 }
                                             }
                                             else
@@ -578,12 +575,417 @@ void XJpegHttpStream::RunVideo( )
     XImageFree( &image );
 }
 
+// Run video acquisition loop, which keeps several snapshot requests in flight. Requests are sent over
+// persistent connections, while downloaded images are decoded by a separate thread and provided to
+// listener in the order the requests were made.
+void XJpegHttpStream::RunConcurrentVideo( )
+{
+    vector<Private::SnapshotRequest>            requests( mData->ConcurrentRequests );
+    map<uint32_t, Private::EncodedSnapshot>     completedSnapshots;
+    CURLM*      multiHandle      = curl_multi_init( );
+    char*       url              = static_cast<char*>( malloc( mData->JpegUrl.size( ) + 32 ) );
+    char        paramSeparator   = ( mData->JpegUrl.find( '?' ) == string::npos ) ? '?' : '&';
+    bool        initialized      = ( ( multiHandle != nullptr ) && ( url != nullptr ) );
+    uint32_t    nextSequence     = 0;
+    uint32_t    deliverSequence  = 0;
+    uint64_t    lastRequestTicks = 0;
+    uint64_t    pauseTillTicks   = 0;
+
+    srand( static_cast<uint32_t>( time( 0 ) ) );
+
+    for ( auto& request : requests )
+    {
+        request.Curl       = curl_easy_init( );
+        request.Buffer     = static_cast<uint8_t*>( malloc( Private::InitialBufferSize ) );
+        request.BufferSize = Private::InitialBufferSize;
+
+        if ( ( request.Curl == nullptr ) || ( request.Buffer == nullptr ) )
+        {
+            initialized = false;
+        }
+        else
+        {
+            request.HeaderList = mData->ConfigureCurlHandle( request.Curl );
+
+            curl_easy_setopt( request.Curl, CURLOPT_WRITEFUNCTION, Private::CurlWriteRequestCallback );
+            curl_easy_setopt( request.Curl, CURLOPT_WRITEDATA, &request );
+            curl_easy_setopt( request.Curl, CURLOPT_PRIVATE, &request );
+        }
+    }
+
+    if ( !initialized )
+    {
+        mData->NotifyError( "Fatal: Failed initializing libcurl session" );
+    }
+    else
+    {
+        // keep a connection per request alive, so new requests don't need to reconnect
+        curl_multi_setopt( multiHandle, CURLMOPT_MAXCONNECTS, static_cast<long>( requests.size( ) ) );
+
+        mData->NeedToStopDecoding = false;
+        mData->DecodeQueue.clear( );
+        mData->DecodeEvent.Reset( );
+
+        if ( !mData->DecodingThread.Create( Private::XJpegHttpStreamData::DecodingThreadHandler, mData ) )
+        {
+            mData->NotifyError( "Fatal: Failed starting decoding thread" );
+        }
+        else
+        {
+            while ( !mData->ExitEvent.IsSignaled( ) )
+            {
+                uint64_t    nowTicks     = XTimer::GetTickCount( );
+                uint32_t    waitMs       = 100;
+                int         stillRunning = 0;
+                int         numfds       = 0;
+                int         msgsLeft     = 0;
+                CURLMsg*    curlMsg;
+                CURLMcode   curlMcode;
+
+                // start new requests if there are idle handles and it is time for the next one
+                for ( auto& request : requests )
+                {
+                    if ( request.IsBusy )
+                    {
+                        continue;
+                    }
+                    if ( nowTicks < pauseTillTicks )
+                    {
+                        waitMs = static_cast<uint32_t>( XMIN( waitMs, pauseTillTicks - nowTicks ) );
+                        break;
+                    }
+                    if ( ( nextSequence != 0 ) && ( nowTicks - lastRequestTicks < mData->FrameIntervalMs ) )
+                    {
+                        waitMs = static_cast<uint32_t>( XMIN( waitMs, mData->FrameIntervalMs - ( nowTicks - lastRequestTicks ) ) );
+                        break;
+                    }
+
+                    sprintf( url, "%s%c%d", mData->JpegUrl.c_str( ), paramSeparator, rand( ) );
+                    curl_easy_setopt( request.Curl, CURLOPT_URL, url );
+
+                    request.ReadSoFar      = 0;
+                    request.BufferOverflow = false;
+                    request.IsBusy         = true;
+                    request.Sequence       = nextSequence++;
+                    request.StartTickCount = nowTicks;
+                    lastRequestTicks       = nowTicks;
+
+                    curl_multi_add_handle( multiHandle, request.Curl );
+                }
+
+                curlMcode = curl_multi_perform( multiHandle, &stillRunning );
+                if ( curlMcode != CURLM_OK )
+                {
+                    // failure of the multi handle is not related to any request - make a pause before next try
+                    mData->NotifyError( string( "Request error: " ) + curl_multi_strerror( curlMcode ) );
+                    pauseTillTicks = nowTicks + Private::PauseOnErrorMs;
+                    mData->ExitEvent.Wait( Private::PauseOnErrorMs );
+                    mData->FailureDetected = false;
+                    continue;
+                }
+
+                // collect finished requests
+                while ( ( curlMsg = curl_multi_info_read( multiHandle, &msgsLeft ) ) != nullptr )
+                {
+                    if ( curlMsg->msg == CURLMSG_DONE )
+                    {
+                        Private::SnapshotRequest*   request      = nullptr;
+                        CURL*                       curl         = curlMsg->easy_handle;
+                        CURLcode                    curlCode     = curlMsg->data.result;
+                        long                        responseCode = 0;
+                        string                      errorMessage;
+
+                        // the message is not valid any more once its handle is removed
+                        curl_easy_getinfo( curl, CURLINFO_PRIVATE, reinterpret_cast<char**>( &request ) );
+                        curl_easy_getinfo( curl, CURLINFO_RESPONSE_CODE, &responseCode );
+                        curl_multi_remove_handle( multiHandle, curl );
+
+                        Private::EncodedSnapshot& result = completedSnapshots[request->Sequence];
+
+                        request->IsBusy = false;
+
+                        if ( responseCode != 200 )
+                        {
+                            errorMessage = Private::GetResponseErrorMessage( responseCode, request->Buffer, request->BufferSize, request->ReadSoFar );
+                        }
+                        else if ( curlCode != CURLE_OK )
+                        {
+                            errorMessage = string( "Request error: " ) + curl_easy_strerror( curlCode );
+                        }
+                        else if ( request->BufferOverflow )
+                        {
+                            errorMessage = "Too small communication buffer";
+                        }
+                        else
+                        {
+                            int jpegStartIndex = Private::MemFind( request->Buffer, request->ReadSoFar, Private::JpegMagic, Private::JpegMagicSize );
+
+                            if ( jpegStartIndex >= 0 )
+                            {
+                                result.Data.assign( request->Buffer + jpegStartIndex, request->Buffer + request->ReadSoFar );
+                                result.CaptureTime = XTimestampNow( );
+                            }
+                            else
+                            {
+                                errorMessage = "The response does not contain JPEG image";
+                            }
+                        }
+
+                        if ( !errorMessage.empty( ) )
+                        {
+                            result.Failed = true;
+
+                            // report error once and make a pause before next requests
+                            if ( nowTicks >= pauseTillTicks )
+                            {
+                                pauseTillTicks = nowTicks + Private::PauseOnErrorMs;
+                                mData->ReportError( errorMessage );
+                            }
+                        }
+                    }
+                }
+
+                // abort requests, which did not complete in time
+                nowTicks = XTimer::GetTickCount( );
+
+                for ( auto& request : requests )
+                {
+                    if ( ( request.IsBusy ) && ( nowTicks - request.StartTickCount > Private::ConnectionTimeoutMs ) )
+                    {
+                        curl_multi_remove_handle( multiHandle, request.Curl );
+
+                        request.IsBusy = false;
+                        completedSnapshots[request.Sequence].Failed = true;
+
+                        if ( nowTicks >= pauseTillTicks )
+                        {
+                            pauseTillTicks = nowTicks + Private::PauseOnErrorMs;
+                            mData->ReportError( "Connection time out" );
+                        }
+                    }
+                }
+
+                // pass downloaded images for decoding in the order they were requested
+                while ( ( !completedSnapshots.empty( ) ) && ( completedSnapshots.begin( )->first == deliverSequence ) )
+                {
+                    if ( !completedSnapshots.begin( )->second.Failed )
+                    {
+                        mData->QueueForDecoding( completedSnapshots.begin( )->second, requests.size( ) );
+                    }
+
+                    completedSnapshots.erase( completedSnapshots.begin( ) );
+                    deliverSequence++;
+                }
+
+                curlMcode = curl_multi_wait( multiHandle, nullptr, 0, waitMs, &numfds );
+                if ( curlMcode != CURLM_OK )
+                {
+                    mData->NotifyError( string( "Request error: " ) + curl_multi_strerror( curlMcode ) );
+                    pauseTillTicks = XTimer::GetTickCount( ) + Private::PauseOnErrorMs;
+                    mData->ExitEvent.Wait( Private::PauseOnErrorMs );
+                    mData->FailureDetected = false;
+                }
+            }
+
+            // stop decoding thread
+            {
+                XScopedLock lock( &mData->DecodeSync );
+
+                mData->NeedToStopDecoding = true;
+                mData->DecodeQueue.clear( );
+                mData->DecodeEvent.Signal( );
+            }
+
+            mData->DecodingThread.Join( );
+        }
+    }
+
+    // clean up
+    for ( auto& request : requests )
+    {
+        if ( request.Curl != nullptr )
+        {
+            if ( request.IsBusy )
+            {
+                curl_multi_remove_handle( multiHandle, request.Curl );
+            }
+            curl_easy_cleanup( request.Curl );
+        }
+        if ( request.HeaderList != nullptr )
+        {
+            curl_slist_free_all( request.HeaderList );
+        }
+        if ( request.Buffer != nullptr )
+        {
+            free( request.Buffer );
+        }
+    }
+
+    if ( multiHandle != nullptr )
+    {
+        curl_multi_cleanup( multiHandle );
+    }
+    if ( url != nullptr )
+    {
+        free( url );
+    }
+}
+
 namespace Private
 {
     // Run video loop in a background thread
     void XJpegHttpStreamData::WorkerThreadHandler( void* param )
     {
-        static_cast<XJpegHttpStream*>( param )->RunVideo( );
+        XJpegHttpStream* stream = static_cast<XJpegHttpStream*>( param );
+
+        if ( stream->mData->ConcurrentRequests > 1 )
+        {
+            stream->RunConcurrentVideo( );
+        }
+        else
+        {
+            stream->RunVideo( );
+        }
+    }
+
+    // Decode JPEG images in a background thread
+    void XJpegHttpStreamData::DecodingThreadHandler( void* param )
+    {
+        static_cast<XJpegHttpStreamData*>( param )->RunDecoding( );
+    }
+
+    // Set options of libcurl handle, which are common for all requests
+    struct curl_slist* XJpegHttpStreamData::ConfigureCurlHandle( CURL* curl )
+    {
+        struct curl_slist* extraHeaderList = nullptr;
+
+        curl_easy_setopt( curl, CURLOPT_NOSIGNAL, 1 );
+
+        //curl_easy_setopt( curl, CURLOPT_VERBOSE, 1L );
+
+        if ( !UserAgent.empty( ) )
+        {
+            string header = "User-Agent: " + UserAgent;
+            extraHeaderList = curl_slist_append( extraHeaderList, header.c_str( ) );
+        }
+
+        // set user name/password if it was supplied
+        if ( !UserName.empty( ) )
+        {
+            if ( !ForceBasicAuthorization )
+            {
+                curl_easy_setopt( curl, CURLOPT_USERNAME, UserName.c_str( ) );
+                curl_easy_setopt( curl, CURLOPT_PASSWORD, Password.c_str( ) );
+                curl_easy_setopt( curl, CURLOPT_HTTPAUTH, (long) CURLAUTH_ANY );
+            }
+            else
+            {
+                // use custom header for basic authorization instead of libcurl's API,
+                // because found a camera, which keeps rejecting libcurl's authorization
+
+                string  loginWithPassword = UserName + ":" + Password;
+                size_t  authLen           = Base64EncodeLength( loginWithPassword.size( ) + 21 );
+                char*   authorization     = new char[authLen];
+
+                strcpy( authorization, "Authorization: Basic " );
+
+                Base64Encode( &(authorization[21]), loginWithPassword.c_str( ), loginWithPassword.size( ) );
+
+                extraHeaderList = curl_slist_append( extraHeaderList, authorization );
+                delete [] authorization;
+            }
+        }
+
+        if ( extraHeaderList != nullptr )
+        {
+            curl_easy_setopt( curl, CURLOPT_HTTPHEADER, extraHeaderList );
+        }
+
+        return extraHeaderList;
+    }
+
+    // Queue downloaded JPEG image for decoding - the oldest image is dropped if decoding does not keep up
+    void XJpegHttpStreamData::QueueForDecoding( EncodedSnapshot& snapshot, size_t maxQueueLength )
+    {
+        XScopedLock lock( &DecodeSync );
+
+        while ( DecodeQueue.size( ) >= maxQueueLength )
+        {
+            DecodeQueue.pop_front( );
+        }
+
+        DecodeQueue.push_back( EncodedSnapshot( ) );
+        DecodeQueue.back( ).Data.swap( snapshot.Data );
+        DecodeQueue.back( ).CaptureTime = snapshot.CaptureTime;
+        DecodeEvent.Signal( );
+    }
+
+    // Decode queued JPEG images and provide them to listener
+    void XJpegHttpStreamData::RunDecoding( )
+    {
+        ximage*         image = nullptr;
+        vector<uint8_t> jpegData;
+        int64_t         captureTime = 0;
+
+        for ( ; ; )
+        {
+            bool haveImage = false;
+
+            {
+                XScopedLock lock( &DecodeSync );
+
+                if ( !DecodeQueue.empty( ) )
+                {
+                    jpegData.swap( DecodeQueue.front( ).Data );
+                    captureTime = DecodeQueue.front( ).CaptureTime;
+                    DecodeQueue.pop_front( );
+                    haveImage = true;
+                }
+                else if ( NeedToStopDecoding )
+                {
+                    break;
+                }
+                else
+                {
+                    DecodeEvent.Reset( );
+                }
+            }
+
+            if ( !haveImage )
+            {
+                DecodeEvent.Wait( );
+                continue;
+            }
+
+            XScopedLock lock( &Sync );
+
+            FramesCounter++;
+
+            if ( Listener != 0 )
+            {
+                // decode image only if someone needs it
+                XErrorCode ret = XDecodeJpegFromMemory( jpegData.data( ), static_cast<int>( jpegData.size( ) ), &image );
+
+                if ( ret == SuccessCode )
+                {
+                    if ( !ExitEvent.IsSignaled( ) )
+                    {
+                        shared_ptr<const XImage> guardedImage = XImage::Create( image );
+
+                        if ( guardedImage )
+                        {
+                            Listener->OnNewImage( guardedImage, captureTime );
+                        }
+                    }
+                }
+                else
+                {
+                    Listener->OnError( "Failed decoding JPEG image" );
+                }
+            }
+        }
+
+        XImageFree( &image );
     }
 
     // Notify about error in the video source
@@ -605,6 +1007,17 @@ namespace Private
         }
     }
 
+    // Notify listener about failure of a single request
+    void XJpegHttpStreamData::ReportError( const string& errorMessage )
+    {
+        XScopedLock lock( &Sync );
+
+        if ( Listener != 0 )
+        {
+            Listener->OnError( errorMessage );
+        }
+    }
+
     // Callback function called by libcurl when data arrives
     size_t CurlWriteMemoryCallback( void* contents, size_t size, size_t nmemb, void* userp )
     {
@@ -637,6 +1050,90 @@ namespace Private
         return realSize;
     }
 
+    // Callback function called by libcurl when data arrives for one of concurrent requests
+    size_t CurlWriteRequestCallback( void* contents, size_t size, size_t nmemb, void* userp )
+    {
+        size_t              realSize = size * nmemb;
+        SnapshotRequest*    request  = static_cast<SnapshotRequest*>( userp );
+
+        // keep one byte spare, so the response could be zero terminated
+        if ( realSize >= request->BufferSize - request->ReadSoFar )
+        {
+            size_t   newSize   = XMIN( MaxBufferSize, ( size_t ) ( ( realSize + request->ReadSoFar ) * 1.5f ) );
+            uint8_t* newBuffer = (uint8_t*) realloc( request->Buffer, newSize );
+
+            if ( newBuffer )
+            {
+                request->Buffer     = newBuffer;
+                request->BufferSize = (int) newSize;
+            }
+        }
+
+        if ( realSize >= request->BufferSize - request->ReadSoFar )
+        {
+            request->BufferOverflow = true;
+        }
+        else
+        {
+            memcpy( &(request->Buffer[request->ReadSoFar]), contents, realSize );
+            request->ReadSoFar += static_cast<uint32_t>( realSize );
+        }
+
+        return realSize;
+    }
+
+    // Get error message for the specified HTTP response code
+    string GetResponseErrorMessage( long responseCode, uint8_t* buffer, int bufferSize, uint32_t readSoFar )
+    {
+        string errorMessage;
+
+        switch ( responseCode )
+        {
+        case 0:
+            errorMessage = "Connection failed";
+            break;
+
+        case 401:
+            errorMessage = "HTTP 401: Not authorized";
+            break;
+
+        case 404:
+            errorMessage = "HTTP 404: File not found";
+            break;
+
+        default:
+            {
+                char msgBuffer[64];
+                sprintf( msgBuffer, "HTTP response code: %d", static_cast<int32_t>( responseCode ) );
+                errorMessage = msgBuffer;
+
+                if ( ( readSoFar != 0 ) && ( readSoFar < static_cast<uint32_t>( bufferSize ) ) )
+                {
+                    buffer[readSoFar] = 0;
+
+                    bool   isHtml    = false;
+                    string htmlTitle = ExtractTitle( (char*) buffer, &isHtml );
+
+                    if ( !htmlTitle.empty( ) )
+                    {
+                        errorMessage += ", ";
+                        errorMessage += htmlTitle;
+                    }
+                    else if ( !isHtml )
+                    {
+                        char* newLinePos = strchr( (char*) buffer, '\n' );
+
+                        errorMessage += ", ";
+                        errorMessage += string( (char*) buffer, ( newLinePos == nullptr ) ? readSoFar : ( (uint8_t*) newLinePos - buffer ) );
+                    }
+                }
+            }
+            break;
+        }
+
+        return errorMessage;
+    }
+
 } // namespace Private
 
 } } } // namespace CVSandbox::Video::MJpeg
@@ -73,10 +73,14 @@ public:
     bool SetForceBasicAuthorization( bool setForceBasic );
     // Set interval between frames in milliseconds
     bool SetFrameInterval( uint16_t frameIntervalMs );
+    // Set number of snapshot requests to keep in flight (1 - request next snapshot only after the previous one is received)
+    bool SetConcurrentRequests( uint16_t requestsCount );
 
 private:
     // Run video acquisition loop
     void RunVideo( );
+    // Run video acquisition loop, which keeps several snapshot requests in flight
+    void RunConcurrentVideo( );
 
 private:
     Private::XJpegHttpStreamData* mData;
@@ -26,6 +26,7 @@
 #include <XThread.hpp>
 #include <XTimer.hpp>
 #include <ximaging_formats.h>
+#include <xtimestamp.h>
 
 #include <curl/curl.h>
 #include "base64.hpp"
@@ -763,6 +764,8 @@ namespace Private
 
                             if ( data->Listener != 0 )
                             {
+                                // image is fully received - time stamp it before decoding
+                                int64_t    captureTime = XTimestampNow( );
                                 // decode image only if someone needs it
                                 XErrorCode ret = XDecodeJpegFromMemory( &( data->CommunicationBuffer[data->JpegImageStart] ),
                                                                         jpegEnd - data->JpegImageStart, &data->DecodedImage );
@@ -773,7 +776,7 @@ namespace Private
 
                                     if ( guardedImage )
                                     {
-                                        data->Listener->OnNewImage( guardedImage );
+                                        data->Listener->OnNewImage( guardedImage, captureTime );
                                     }
                                 }
                                 else
@@ -27,6 +27,7 @@
 #include <map>
 #include <stdint.h>
 #include <chrono>
+#include <XFrameMemoryInfo.hpp>
 
 class IPerformanceMonitorService
 {
@@ -39,6 +40,7 @@ public:
 
     virtual float TotalCpuLoad( ) const = 0;
     virtual float TotalFrameRate( ) const = 0;
+    virtual CVSandbox::Automation::XFrameMemoryInfo FrameMemoryInfo( ) const = 0;
 
     virtual std::chrono::system_clock::duration UpTime( ) const = 0;
 };
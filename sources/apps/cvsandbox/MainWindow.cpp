@@ -49,6 +49,7 @@
 #include "VideoSnapshotDialog.hpp"
 
 #include <XScriptingEnginePlugin.hpp>
+#include <XMetricsHttpServer.hpp>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -106,6 +107,9 @@ namespace Private
         bool        FitCamerasToScreen;
         bool        HideProjectObjectTree;
         bool        NoSystemSleep;
+        uint16_t    MetricsPort;
+        QString     CaptureFolder;
+        float       CaptureThreshold;
 
     public:
         ApplicationOptions( ) :
@@ -115,7 +119,8 @@ namespace Private
             ApplicationSettingsFileName( QFileInfo( DefaultSettingsFolder, "app.ini" ).filePath( ) ),
             ProjectObjectToStart( ),
             StartFullScreen( false ), FitCamerasToScreen( false ),
-            HideProjectObjectTree( false ), NoSystemSleep( false )
+            HideProjectObjectTree( false ), NoSystemSleep( false ), MetricsPort( 0 ),
+            CaptureFolder( ), CaptureThreshold( 0.0f )
         {
 
         }
@@ -135,8 +140,8 @@ namespace Private
             commands( ), appOptions( ),
             projectTreeFrame( new ProjectTreeFrame( ) ),
             variablesMonitorFrame( new SandboxVariablesMonitorFrame( ) ),
-            uptimeLabel( nullptr ), fpsLabel( nullptr ), cpuLabel( nullptr ),
-            scriptEditor( nullptr ), snapshotDialog( nullptr )
+            uptimeLabel( nullptr ), fpsLabel( nullptr ), cpuLabel( nullptr ), memoryLabel( nullptr ),
+            scriptEditor( nullptr ), snapshotDialog( nullptr ), metricsServer( )
         {
         }
 
@@ -149,9 +154,12 @@ namespace Private
         QLabel*               uptimeLabel;
         QLabel*               fpsLabel;
         QLabel*               cpuLabel;
+        QLabel*               memoryLabel;
 
         ScriptEditorDialog*   scriptEditor;
         VideoSnapshotDialog*  snapshotDialog;
+
+        shared_ptr<XMetricsHttpServer> metricsServer;
     };
 }
 
@@ -180,6 +188,31 @@ MainWindow::MainWindow( QWidget* parent ) :
     smi.SetAutomationServer( XAutomationServer::Create( pluginsEngine, AppTitle, AppVersion ) );
     smi.SetFavouritePluginsManager( shared_ptr<FavouritePluginsManager>( new FavouritePluginsManager( ) ) );
 
+    // provide metrics of automation server over HTTP if requested
+    if ( mData->appOptions.MetricsPort != 0 )
+    {
+        mData->metricsServer = XMetricsHttpServer::Create( smi.GetAutomationServer( ) );
+
+        if ( ( mData->metricsServer ) && ( mData->metricsServer->Start( mData->appOptions.MetricsPort ) != SuccessCode ) )
+        {
+            qDebug( "Failed starting metrics server on port %u", mData->appOptions.MetricsPort );
+            mData->metricsServer.reset( );
+        }
+    }
+
+    // capture failed/slow video processing steps if requested, so those could be replayed with cvsreplay
+    if ( !mData->appOptions.CaptureFolder.isEmpty( ) )
+    {
+        XStepCaptureConfiguration captureConfig;
+
+        QDir( ).mkpath( mData->appOptions.CaptureFolder );
+
+        captureConfig.Folder           = mData->appOptions.CaptureFolder.toUtf8( ).data( );
+        captureConfig.LatencyThreshold = mData->appOptions.CaptureThreshold;
+
+        smi.GetAutomationServer( )->SetStepCaptureConfiguration( captureConfig );
+    }
+
     // some UI initialization
     ui->setupUi( this );
     ui->projectTreeDockWidget->setWidget( mData->projectTreeFrame );
@@ -260,6 +293,12 @@ MainWindow::~MainWindow( )
     smi.GetAutomationServer( )->GetVideoSourceCount( &notStarted, &running, &finalizing );
     qDebug( "notStarted = %u, running = %u, finalizing = %u", notStarted, running, finalizing );
 
+    if ( mData->metricsServer )
+    {
+        mData->metricsServer->Stop( );
+        mData->metricsServer.reset( );
+    }
+
     smi.GetAutomationServer( )->SignalToStop( );
     smi.GetAutomationServer( )->WaitForStop( );
 
@@ -434,10 +473,19 @@ void MainWindow::SetupStatuBar( )
     mData->fpsLabel->setToolTip( "Total frame rate from all running cameras" );
     mData->fpsLabel->setVisible( false );
 
+    // frame memory label
+    mData->memoryLabel = new QLabel( this );
+
+    mData->memoryLabel->setMinimumWidth( 100 );
+    mData->memoryLabel->setFrameShape( QFrame::Panel );
+    mData->memoryLabel->setFrameShadow( QFrame::Sunken );
+    mData->memoryLabel->setVisible( false );
+
     // add them all
     ui->statusBar->addPermanentWidget( mData->uptimeLabel );
     ui->statusBar->addPermanentWidget( mData->cpuLabel );
     ui->statusBar->addPermanentWidget( mData->fpsLabel );
+    ui->statusBar->addPermanentWidget( mData->memoryLabel );
 }
 
 // Handle different command line options
@@ -668,6 +716,8 @@ void MainWindow::on_performanceMonitor_update( )
     float totalCpu    = perfMonitor->TotalCpuLoad( );
     float totalFps    = perfMonitor->TotalFrameRate( );
 
+    XFrameMemoryInfo frameMemory = perfMonitor->FrameMemoryInfo( );
+
     system_clock::duration upTime = perfMonitor->UpTime( );
     uint32_t upSeconds = static_cast<uint32_t>( duration_cast<std::chrono::seconds>( upTime ).count( ) );
     uint32_t upMinutes = static_cast<uint32_t>( duration_cast<std::chrono::minutes>( upTime ).count( ) );
@@ -695,6 +745,33 @@ void MainWindow::on_performanceMonitor_update( )
         mData->fpsLabel->setVisible( true );
     }
 
+    if ( frameMemory.Used == 0 )
+    {
+        mData->memoryLabel->setVisible( false );
+        mData->memoryLabel->setText( QString::null );
+    }
+    else
+    {
+        QString strMemory = QString( "Frames: %0 MB" ).arg( static_cast<double>( frameMemory.Used ) / ( 1024 * 1024 ), 0, 'f', 1 );
+
+        if ( frameMemory.Budget != 0 )
+        {
+            strMemory += QString( " / %0 MB" ).arg( frameMemory.Budget / ( 1024 * 1024 ) );
+
+            if ( frameMemory.IsThrottling )
+            {
+                strMemory += " (throttling)";
+            }
+        }
+
+        mData->memoryLabel->setText( strMemory );
+        mData->memoryLabel->setToolTip( QString( "Memory taken by video frames of all running cameras\n"
+                                                 "Peak: %0 MB, frames throttled to fit into budget: %1" ).
+                                        arg( static_cast<double>( frameMemory.PeakUsed ) / ( 1024 * 1024 ), 0, 'f', 1 ).
+                                        arg( frameMemory.FramesThrottled ) );
+        mData->memoryLabel->setVisible( true );
+    }
+
     if ( upSeconds == 0 )
     {
         mData->uptimeLabel->setVisible( false );
@@ -898,6 +975,30 @@ void ApplicationOptions::ParseCommandLineArguments( )
             {
                 NoSystemSleep = true;
             }
+            else if ( ( option.startsWith( "metrics:" ) ) && ( option.size( ) > 8 ) )
+            {
+                bool     isNumber = false;
+                uint32_t port     = option.mid( 8 ).toUInt( &isNumber );
+
+                if ( ( isNumber ) && ( port <= 65535 ) )
+                {
+                    MetricsPort = static_cast<uint16_t>( port );
+                }
+            }
+            else if ( ( option.startsWith( "capture:" ) ) && ( option.size( ) > 8 ) )
+            {
+                CaptureFolder = option.mid( 8 );
+            }
+            else if ( ( option.startsWith( "capturems:" ) ) && ( option.size( ) > 10 ) )
+            {
+                bool  isNumber  = false;
+                float threshold = option.mid( 10 ).toFloat( &isNumber );
+
+                if ( ( isNumber ) && ( threshold >= 0.0f ) )
+                {
+                    CaptureThreshold = threshold;
+                }
+            }
         }
     }
 }
@@ -65,6 +65,7 @@ namespace Private
 
             TotalFps        = -1;
             TotalCpuLoad    = -1;
+            FrameMemory     = XFrameMemoryInfo( );
 
             StartTime = steady_clock::now( );
             TimeSinceStarted = duration_cast<milliseconds>( StartTime - StartTime );
@@ -72,10 +73,12 @@ namespace Private
 
         void UpdateFrameRateInfo( );
         void UpdateCpuLoadInfo( );
+        void UpdateFrameMemoryInfo( );
 
     public:
         float                   TotalFps;
         float                   TotalCpuLoad;
+        XFrameMemoryInfo        FrameMemory;
 
         QTimer                  UpdateTimer;
         QTime                   LastUpdated;
@@ -185,6 +188,7 @@ void PerformanceMonitorService::on_UpdateTimer_timeout( )
 {
     mData->UpdateFrameRateInfo( );
     mData->UpdateCpuLoadInfo( );
+    mData->UpdateFrameMemoryInfo( );
 
     mData->TimeSinceStarted = duration_cast<milliseconds>( steady_clock::now( ) - mData->StartTime );
 
@@ -201,6 +205,11 @@ float PerformanceMonitorService::TotalFrameRate( ) const
     return mData->TotalFps;
 }
 
+XFrameMemoryInfo PerformanceMonitorService::FrameMemoryInfo( ) const
+{
+    return mData->FrameMemory;
+}
+
 system_clock::duration PerformanceMonitorService::UpTime( ) const
 {
     return mData->TimeSinceStarted;
@@ -254,6 +263,12 @@ void PerformanceMonitorServiceData::UpdateFrameRateInfo( )
     LastUpdated.restart( );
 }
 
+// Update memory taken by video frames of all running cameras and throttling of frames to fit into its budget
+void PerformanceMonitorServiceData::UpdateFrameMemoryInfo( )
+{
+    FrameMemory = ServiceManager::Instance( ).GetAutomationServer( )->GetFrameMemoryInfo( );
+}
+
 // Helper to get file time difference
 static uint64_t FileTimeDiff( const FILETIME& timeOld, const FILETIME& timeNew )
 {
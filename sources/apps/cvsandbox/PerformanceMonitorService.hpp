@@ -45,6 +45,7 @@ public:
 
     virtual float TotalCpuLoad( ) const;
     virtual float TotalFrameRate( ) const;
+    virtual CVSandbox::Automation::XFrameMemoryInfo FrameMemoryInfo( ) const;
 
     virtual std::chrono::system_clock::duration UpTime( ) const;
 
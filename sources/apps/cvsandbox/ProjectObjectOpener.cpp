@@ -20,6 +20,7 @@
 */
 
 #include <map>
+#include <QThread>
 #include <UITools.hpp>
 #include "ProjectObjectOpener.hpp"
 #include "ServiceManager.hpp"
@@ -135,6 +136,10 @@ void ProjectObjectOpener::Open( const shared_ptr<SandboxProjectObject>& po )
         const shared_ptr<XAutomationServer>&     server         = ServiceManager::Instance( ).GetAutomationServer( );
 
         const map<XGuid, XVideoSourceProcessingGraph> videoProcessingGraphs = po->GetCamerasProcessingGraphs( );
+        const SandboxSettings                         sandboxSettings       = po->Settings( );
+
+        // number of CPU cores to pin video processing threads to (if requested)
+        int cpuCoresCount = XINRANGE( QThread::idealThreadCount( ), 1, 64 );
 
         map<XGuid, uint32_t> videoSourceMap;
         map<XGuid, uint32_t> threadsMap;
@@ -181,6 +186,11 @@ void ProjectObjectOpener::Open( const shared_ptr<SandboxProjectObject>& po )
                         // set confguration of the plugin
                         pluginDesc->SetPluginConfiguration( plugin, cameraObject->PluginProperties( ) );
 
+                        // set priority of the video processing thread and pin it to a CPU core if required
+                        server->SetVideoProcessingThreadScheduling( vsId,
+                            ( sandboxSettings.PinVideoProcessingThreads( ) ) ? ( (uint64_t) 1 << ( videoSourceIds.size( ) % cpuCoresCount ) ) : 0,
+                            sandboxSettings.VideoProcessingPriority( ) );
+
                         // create mapping between device ID and video source managed by automation server
                         videoSourceMap.insert( pair<XGuid, uint32_t>( cameraObject->Id( ), vsId ) );
 
@@ -211,6 +221,8 @@ void ProjectObjectOpener::Open( const shared_ptr<SandboxProjectObject>& po )
 
                     uint32_t threadServerId = server->AddThread( static_pointer_cast<XScriptingEnginePlugin>( plugin ), threadDesc.Interval( ) );
 
+                    server->SetScriptingThreadScheduling( threadServerId, 0, sandboxSettings.ScriptingThreadsPriority( ) );
+
                     threadsMap.insert( pair<XGuid, uint32_t>( threadDesc.Id( ), threadServerId ) );
                 }
                 else
@@ -226,6 +238,11 @@ void ProjectObjectOpener::Open( const shared_ptr<SandboxProjectObject>& po )
         sandboxView->SetThreads( threadsMap );
         mainWindowService->SetCentralWidget( sandboxView );
 
+        // limit memory taken by video frames of the sandbox's cameras (done after the previous view is
+        // replaced, since it resets the budget when closed)
+        server->SetFrameMemoryBudget( static_cast<uint64_t>( sandboxSettings.FrameMemoryBudget( ) ) * 1024 * 1024,
+                                      sandboxSettings.FrameMemoryPolicy( ) );
+
         // start all threads and cameras
         server->StartAllThreads( );
         server->StartAllVideoSources( );
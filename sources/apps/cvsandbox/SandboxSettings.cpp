@@ -26,6 +26,12 @@
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
 
+using namespace CVSandbox::Threading;
+using namespace CVSandbox::Automation;
+
+// Max frame memory budget, MB
+#define MAX_FRAME_MEMORY_BUDGET (65536)
+
 static const QString STR_SETTINGS          = QString::fromUtf8( "Settings" );
 static const QString STR_VIEW_SETTINGS     = QString::fromUtf8( "ViewSettings" );
 static const QString STR_ROTATION          = QString::fromUtf8( "Rotation" );
@@ -34,6 +40,11 @@ static const QString STR_ROTATION_TIME     = QString::fromUtf8( "RotationTime" )
 static const QString STR_BUTTONS_POSITION  = QString::fromUtf8( "ButtonsPosition" );
 static const QString STR_BUTTONS_ALIGNMENT = QString::fromUtf8( "ButtonsAlignment" );
 static const QString STR_DROP_FRMAES       = QString::fromUtf8( "DropFrames" );
+static const QString STR_PROCESSING_PRIO   = QString::fromUtf8( "ProcessingPriority" );
+static const QString STR_SCRIPTING_PRIO    = QString::fromUtf8( "ScriptingPriority" );
+static const QString STR_PIN_PROCESSING    = QString::fromUtf8( "PinProcessingThreads" );
+static const QString STR_MEMORY_BUDGET     = QString::fromUtf8( "FrameMemoryBudget" );
+static const QString STR_MEMORY_POLICY     = QString::fromUtf8( "FrameMemoryPolicy" );
 
 
 SandboxSettings::SandboxSettings( ) :
@@ -42,7 +53,12 @@ SandboxSettings::SandboxSettings( ) :
     mViewsRotationTimeSec( 15 ),
     mViewButtonsPosition( SandboxSettings::ViewButtonsPosition::VerticalRight ),
     mViewButtonsAlignment( SandboxSettings::ViewButtonsAlignment::Center ),
-    mDropFrameOnSlowProcessing( false )
+    mDropFrameOnSlowProcessing( false ),
+    mVideoProcessingPriority( XThreadPriority::Normal ),
+    mScriptingThreadsPriority( XThreadPriority::Normal ),
+    mPinVideoProcessingThreads( false ),
+    mFrameMemoryBudgetMb( 0 ),
+    mFrameMemoryPolicy( XFrameMemoryPolicy::DropFrames )
 {
 
 }
@@ -55,7 +71,12 @@ bool SandboxSettings::operator==( const SandboxSettings& rhs ) const
              ( mViewsRotationTimeSec == rhs.mViewsRotationTimeSec ) &&
              ( mViewButtonsPosition  == rhs.mViewButtonsPosition ) &&
              ( mViewButtonsAlignment == rhs.mViewButtonsAlignment ) &&
-             ( mDropFrameOnSlowProcessing == rhs.mDropFrameOnSlowProcessing ));
+             ( mDropFrameOnSlowProcessing == rhs.mDropFrameOnSlowProcessing ) &&
+             ( mVideoProcessingPriority   == rhs.mVideoProcessingPriority ) &&
+             ( mScriptingThreadsPriority  == rhs.mScriptingThreadsPriority ) &&
+             ( mPinVideoProcessingThreads == rhs.mPinVideoProcessingThreads ) &&
+             ( mFrameMemoryBudgetMb       == rhs.mFrameMemoryBudgetMb ) &&
+             ( mFrameMemoryPolicy         == rhs.mFrameMemoryPolicy ) );
 }
 
 // Get/Set views rotation flag
@@ -118,6 +139,56 @@ void SandboxSettings::SetDropFramesOnSlowProcessing( bool drop )
     mDropFrameOnSlowProcessing = drop;
 }
 
+// Get/Set priority of video processing threads
+XThreadPriority SandboxSettings::VideoProcessingPriority( ) const
+{
+    return mVideoProcessingPriority;
+}
+void SandboxSettings::SetVideoProcessingPriority( XThreadPriority priority )
+{
+    mVideoProcessingPriority = priority;
+}
+
+// Get/Set priority of scripting threads
+XThreadPriority SandboxSettings::ScriptingThreadsPriority( ) const
+{
+    return mScriptingThreadsPriority;
+}
+void SandboxSettings::SetScriptingThreadsPriority( XThreadPriority priority )
+{
+    mScriptingThreadsPriority = priority;
+}
+
+// Get/Set if video processing threads should be pinned to CPU cores
+bool SandboxSettings::PinVideoProcessingThreads( ) const
+{
+    return mPinVideoProcessingThreads;
+}
+void SandboxSettings::SetPinVideoProcessingThreads( bool pin )
+{
+    mPinVideoProcessingThreads = pin;
+}
+
+// Get/Set budget of memory taken by video frames of all video sources (MB, 0 - no limit)
+int SandboxSettings::FrameMemoryBudget( ) const
+{
+    return mFrameMemoryBudgetMb;
+}
+void SandboxSettings::SetFrameMemoryBudget( int budgetMb )
+{
+    mFrameMemoryBudgetMb = XINRANGE( budgetMb, 0, MAX_FRAME_MEMORY_BUDGET );
+}
+
+// Get/Set policy to apply while frame memory budget is exceeded
+XFrameMemoryPolicy SandboxSettings::FrameMemoryPolicy( ) const
+{
+    return mFrameMemoryPolicy;
+}
+void SandboxSettings::SetFrameMemoryPolicy( XFrameMemoryPolicy policy )
+{
+    mFrameMemoryPolicy = policy;
+}
+
 
 // Returns enclosing XML tag name used for saving the setting
 const QString SandboxSettings::XmlTagName( )
@@ -137,6 +208,11 @@ void SandboxSettings::Save( QXmlStreamWriter& xmlWriter ) const
     xmlWriter.writeAttribute( STR_BUTTONS_POSITION, QString::number( static_cast<int>( mViewButtonsPosition ) ) );
     xmlWriter.writeAttribute( STR_BUTTONS_ALIGNMENT, QString::number( static_cast<int>( mViewButtonsAlignment ) ) );
     xmlWriter.writeAttribute( STR_DROP_FRMAES, QString::number( ( mDropFrameOnSlowProcessing ) ? 1 : 0 ) );
+    xmlWriter.writeAttribute( STR_PROCESSING_PRIO, QString::number( static_cast<int>( mVideoProcessingPriority ) ) );
+    xmlWriter.writeAttribute( STR_SCRIPTING_PRIO, QString::number( static_cast<int>( mScriptingThreadsPriority ) ) );
+    xmlWriter.writeAttribute( STR_PIN_PROCESSING, QString::number( ( mPinVideoProcessingThreads ) ? 1 : 0 ) );
+    xmlWriter.writeAttribute( STR_MEMORY_BUDGET, QString::number( mFrameMemoryBudgetMb ) );
+    xmlWriter.writeAttribute( STR_MEMORY_POLICY, QString::number( static_cast<int>( mFrameMemoryPolicy ) ) );
     xmlWriter.writeEndElement( );
 
     xmlWriter.writeEndElement( );
@@ -198,6 +274,43 @@ bool SandboxSettings::Load( QXmlStreamReader& xmlReader )
                 mDropFrameOnSlowProcessing = ( strRef.toString( ).toInt( ) == 1 );
             }
 
+            // priority of video processing threads
+            strRef = xmlAttrs.value( STR_PROCESSING_PRIO );
+            if ( !strRef.isEmpty( ) )
+            {
+                mVideoProcessingPriority = static_cast<XThreadPriority>( XINRANGE( strRef.toString( ).toInt( ),
+                    static_cast<int>( XThreadPriority::Idle ), static_cast<int>( XThreadPriority::TimeCritical ) ) );
+            }
+
+            // priority of scripting threads
+            strRef = xmlAttrs.value( STR_SCRIPTING_PRIO );
+            if ( !strRef.isEmpty( ) )
+            {
+                mScriptingThreadsPriority = static_cast<XThreadPriority>( XINRANGE( strRef.toString( ).toInt( ),
+                    static_cast<int>( XThreadPriority::Idle ), static_cast<int>( XThreadPriority::TimeCritical ) ) );
+            }
+
+            // pinning of video processing threads
+            strRef = xmlAttrs.value( STR_PIN_PROCESSING );
+            if ( !strRef.isEmpty( ) )
+            {
+                mPinVideoProcessingThreads = ( strRef.toString( ).toInt( ) == 1 );
+            }
+
+            // frame memory budget and policy
+            strRef = xmlAttrs.value( STR_MEMORY_BUDGET );
+            if ( !strRef.isEmpty( ) )
+            {
+                mFrameMemoryBudgetMb = XINRANGE( strRef.toString( ).toInt( ), 0, MAX_FRAME_MEMORY_BUDGET );
+            }
+
+            strRef = xmlAttrs.value( STR_MEMORY_POLICY );
+            if ( !strRef.isEmpty( ) )
+            {
+                mFrameMemoryPolicy = static_cast<XFrameMemoryPolicy>( XINRANGE( strRef.toString( ).toInt( ),
+                    static_cast<int>( XFrameMemoryPolicy::DropFrames ), static_cast<int>( XFrameMemoryPolicy::ReduceResolution ) ) );
+            }
+
             xmlReader.skipCurrentElement( );
 
             ret = true;
@@ -23,6 +23,9 @@
 #ifndef CVS_SANDBOX_SETTINGS_HPP
 #define CVS_SANDBOX_SETTINGS_HPP
 
+#include <XThread.hpp>
+#include <XFrameMemoryInfo.hpp>
+
 class QXmlStreamWriter;
 class QXmlStreamReader;
 class QString;
@@ -79,6 +82,26 @@ public:
     bool DropFramesOnSlowProcessing( ) const;
     void SetDropFramesOnSlowProcessing( bool drop );
 
+    // Get/Set priority of video processing threads
+    CVSandbox::Threading::XThreadPriority VideoProcessingPriority( ) const;
+    void SetVideoProcessingPriority( CVSandbox::Threading::XThreadPriority priority );
+
+    // Get/Set priority of scripting threads
+    CVSandbox::Threading::XThreadPriority ScriptingThreadsPriority( ) const;
+    void SetScriptingThreadsPriority( CVSandbox::Threading::XThreadPriority priority );
+
+    // Get/Set if video processing threads should be pinned to CPU cores (one core per video source in round robin manner)
+    bool PinVideoProcessingThreads( ) const;
+    void SetPinVideoProcessingThreads( bool pin );
+
+    // Get/Set budget of memory taken by video frames of all video sources (MB, 0 - no limit)
+    int FrameMemoryBudget( ) const;
+    void SetFrameMemoryBudget( int budgetMb );
+
+    // Get/Set policy to apply while frame memory budget is exceeded
+    CVSandbox::Automation::XFrameMemoryPolicy FrameMemoryPolicy( ) const;
+    void SetFrameMemoryPolicy( CVSandbox::Automation::XFrameMemoryPolicy policy );
+
 public:
     static const QString XmlTagName( );
     virtual void Save( QXmlStreamWriter& xmlWriter ) const;
@@ -92,6 +115,13 @@ private:
     ViewButtonsAlignment    mViewButtonsAlignment;
 
     bool                    mDropFrameOnSlowProcessing;
+
+    CVSandbox::Threading::XThreadPriority mVideoProcessingPriority;
+    CVSandbox::Threading::XThreadPriority mScriptingThreadsPriority;
+    bool                                  mPinVideoProcessingThreads;
+
+    int                                       mFrameMemoryBudgetMb;
+    CVSandbox::Automation::XFrameMemoryPolicy mFrameMemoryPolicy;
 };
 
 #endif // CVS_SANDBOX_SETTINGS_HPP
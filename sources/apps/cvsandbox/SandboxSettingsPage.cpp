@@ -24,6 +24,26 @@
 
 #include "SandboxSettings.hpp"
 
+using namespace CVSandbox::Threading;
+using namespace CVSandbox::Automation;
+
+// Names of thread priorities, in the order of XThreadPriority values
+static const char* const PRIORITY_NAMES[] =
+{
+    "Idle", "Lowest", "Below Normal", "Normal", "Above Normal", "Highest", "Time Critical"
+};
+
+// Policies to apply when frame memory budget is exceeded (sandboxes don't mark cameras
+// as low priority ones, so decimation of such is not offered)
+static const XFrameMemoryPolicy MEMORY_POLICIES[] =
+{
+    XFrameMemoryPolicy::DropFrames, XFrameMemoryPolicy::ReduceResolution
+};
+static const char* const MEMORY_POLICY_NAMES[] =
+{
+    "Drop frames", "Reduce resolution"
+};
+
 namespace Private
 {
     class SandboxSettingsPageData
@@ -57,6 +77,21 @@ SandboxSettingsPage::SandboxSettingsPage( QWidget* parent ) :
     ui->viewButtonsAlignmentComboBox->addItem( "Center" );
     ui->viewButtonsAlignmentComboBox->addItem( "Bottom/Right" );
     ui->viewButtonsAlignmentComboBox->setCurrentIndex( 1 );
+
+    for ( const char* priorityName : PRIORITY_NAMES )
+    {
+        ui->processingPriorityComboBox->addItem( priorityName );
+        ui->scriptingPriorityComboBox->addItem( priorityName );
+    }
+    ui->processingPriorityComboBox->setCurrentIndex( static_cast<int>( XThreadPriority::Normal ) );
+    ui->scriptingPriorityComboBox->setCurrentIndex( static_cast<int>( XThreadPriority::Normal ) );
+
+    for ( const char* policyName : MEMORY_POLICY_NAMES )
+    {
+        ui->frameMemoryPolicyComboBox->addItem( policyName );
+    }
+    ui->frameMemoryPolicyComboBox->setCurrentIndex( 0 );
+    ui->frameMemoryPolicyComboBox->setEnabled( false );
 }
 
 SandboxSettingsPage::~SandboxSettingsPage( )
@@ -86,6 +121,19 @@ void SandboxSettingsPage::SetSettings( const SandboxSettings& settings )
     ui->viewButtonsPositionComboBox->setCurrentIndex( static_cast<int>( settings.GetViewButtonsPosition( ) ) );
     ui->viewButtonsAlignmentComboBox->setCurrentIndex( static_cast<int>( settings.GetViewButtonsAlignment( ) ) );
     ui->dropFramesCheckBox->setChecked( settings.DropFramesOnSlowProcessing( ) );
+    ui->processingPriorityComboBox->setCurrentIndex( static_cast<int>( settings.VideoProcessingPriority( ) ) );
+    ui->scriptingPriorityComboBox->setCurrentIndex( static_cast<int>( settings.ScriptingThreadsPriority( ) ) );
+    ui->pinProcessingThreadsCheckBox->setChecked( settings.PinVideoProcessingThreads( ) );
+    ui->frameMemoryBudgetSpinBox->setValue( settings.FrameMemoryBudget( ) );
+    ui->frameMemoryPolicyComboBox->setEnabled( settings.FrameMemoryBudget( ) != 0 );
+
+    for ( int i = 0, n = sizeof( MEMORY_POLICIES ) / sizeof( MEMORY_POLICIES[0] ); i < n; i++ )
+    {
+        if ( MEMORY_POLICIES[i] == settings.FrameMemoryPolicy( ) )
+        {
+            ui->frameMemoryPolicyComboBox->setCurrentIndex( i );
+        }
+    }
 }
 
 void SandboxSettingsPage::on_viewRotationCheckBox_clicked( bool checked )
@@ -117,3 +165,32 @@ void SandboxSettingsPage::on_dropFramesCheckBox_clicked( bool checked )
 {
     mData->settings.SetDropFramesOnSlowProcessing( checked );
 }
+
+void SandboxSettingsPage::on_processingPriorityComboBox_currentIndexChanged( int index )
+{
+    mData->settings.SetVideoProcessingPriority( static_cast<XThreadPriority>( index ) );
+}
+
+void SandboxSettingsPage::on_scriptingPriorityComboBox_currentIndexChanged( int index )
+{
+    mData->settings.SetScriptingThreadsPriority( static_cast<XThreadPriority>( index ) );
+}
+
+void SandboxSettingsPage::on_pinProcessingThreadsCheckBox_clicked( bool checked )
+{
+    mData->settings.SetPinVideoProcessingThreads( checked );
+}
+
+void SandboxSettingsPage::on_frameMemoryBudgetSpinBox_valueChanged( int value )
+{
+    mData->settings.SetFrameMemoryBudget( value );
+    ui->frameMemoryPolicyComboBox->setEnabled( value != 0 );
+}
+
+void SandboxSettingsPage::on_frameMemoryPolicyComboBox_currentIndexChanged( int index )
+{
+    if ( ( index >= 0 ) && ( index < static_cast<int>( sizeof( MEMORY_POLICIES ) / sizeof( MEMORY_POLICIES[0] ) ) ) )
+    {
+        mData->settings.SetFrameMemoryPolicy( MEMORY_POLICIES[index] );
+    }
+}
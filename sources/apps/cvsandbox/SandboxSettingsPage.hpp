@@ -59,6 +59,11 @@ private slots:
     void on_viewButtonsPositionComboBox_currentIndexChanged( int index );
     void on_viewButtonsAlignmentComboBox_currentIndexChanged( int index );
     void on_dropFramesCheckBox_clicked( bool checked );
+    void on_processingPriorityComboBox_currentIndexChanged( int index );
+    void on_scriptingPriorityComboBox_currentIndexChanged( int index );
+    void on_pinProcessingThreadsCheckBox_clicked( bool checked );
+    void on_frameMemoryBudgetSpinBox_valueChanged( int value );
+    void on_frameMemoryPolicyComboBox_currentIndexChanged( int index );
 
 private:
     Ui::SandboxSettingsPage*            ui;
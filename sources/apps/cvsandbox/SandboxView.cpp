@@ -289,6 +289,9 @@ SandboxView::~SandboxView( )
     // clear any possible variable stored on the server
     server->ClearAllVariables( );
 
+    // remove frame memory budget set for the sandbox
+    server->SetFrameMemoryBudget( 0 );
+
     mData->SetCurrentView( 0, ui->currentViewFrame->layout( ) );
 
     delete mData;
@@ -467,6 +467,15 @@ void VideoProcessingInfoDialogData::CheckForPerformanceIssues( )
 
     ServiceManager::Instance( ).GetAutomationServer( )->GetVideoSourceFrameInfo( VideoSourceId, &frameInfo );
 
+    // latency of frames - from capture to the end of processing
+    Ui->latencyLabel->setText( QString( "%0 (max %1)" ).
+                               arg( frameInfo.AverageTotalLatency, 0, 'f', 1 ).
+                               arg( frameInfo.MaxTotalLatency, 0, 'f', 1 ) );
+    Ui->latencyLabel->setToolTip( QString( "Video source: %0 ms\nWaiting for processing: %1 ms\nProcessing: %2 ms" ).
+                                  arg( frameInfo.AverageSourceLatency, 0, 'f', 1 ).
+                                  arg( frameInfo.AverageQueueLatency, 0, 'f', 1 ).
+                                  arg( frameInfo.AverageProcessingLatency, 0, 'f', 1 ) );
+
     if ( ( frameInfo.FramesBlocked != 0 ) || ( frameInfo.FramesDropped != 0 ) )
     {
         if ( !Ui->performanceGroupBox->isVisible( ) )
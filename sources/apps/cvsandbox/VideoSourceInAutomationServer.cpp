@@ -81,7 +81,9 @@ void VideoSourceInAutomationServer::SetListener( IVideoSourceListener* listener
 
     if ( mListener != 0 )
     {
-        mServer->AddVideoSourceListener( mVideoSourceId, static_cast<IAutomationVideoSourceListener*>( this ) ) ;
+        // get frames through a mailbox keeping the latest frame only, so slow displaying
+        // does not hold video processing thread
+        mServer->AddVideoSourceListener( mVideoSourceId, static_cast<IAutomationVideoSourceListener*>( this ), true, 1 ) ;
     }
 }
 
@@ -140,6 +140,15 @@ void VideoSourceInPlugin::OnNewImage( const shared_ptr<const XImage>& image )
     }
 }
 
+// New video frame notification with capture time
+void VideoSourceInPlugin::OnNewImage( const shared_ptr<const XImage>& image, int64_t captureTime )
+{
+    if ( mListener != 0 )
+    {
+        mListener->OnNewImage( image, captureTime );
+    }
+}
+
 // Video source error notification
 void VideoSourceInPlugin::OnError( const string& errorMessage )
 {
@@ -54,6 +54,7 @@ private:
 
     // New video frame notification
     virtual void OnNewImage( const std::shared_ptr<const CVSandbox::XImage>& image );
+    virtual void OnNewImage( const std::shared_ptr<const CVSandbox::XImage>& image, int64_t captureTime );
     // Video source error notification
     virtual void OnError( const std::string& errorMessage );
 
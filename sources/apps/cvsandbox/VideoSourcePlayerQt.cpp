@@ -27,6 +27,11 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QMouseEvent>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWindow>
+#include <ximaging.h>
 
 using namespace std;
 using namespace CVSandbox;
@@ -39,6 +44,9 @@ using namespace CVSandbox::Video;
 // Border width around image
 #define BORDER_WIDTH (4)
 
+// Refresh rate to assume if the screen does not tell it
+#define DEFAULT_REFRESH_RATE (60)
+
 // Message to display when waiting for camera
 static const QString STR_WAITING_VIDEO_SOURCE  = QString::fromUtf8( "Waiting for video source ..." );
 
@@ -52,14 +60,20 @@ namespace Private
             syncMutex( ),
             imageWidth( DEFAULT_IMAGE_WIDTH ), imageHeight( DEFAULT_IMAGE_HEIGHT ),
             isWaitingForFirstFrame( false ), isFirstFrame( false ), isMouseHighlighted( false ), isHighlighted( false ),
-            imageToDisplay( 0 ), errorMessage( )
+            imageToDisplay( 0 ), errorMessage( ),
+            isDisplayVisible( false ), isUpdatePending( false ), displayWidth( 0 ), displayHeight( 0 ),
+            minFrameInterval( 1000000000 / DEFAULT_REFRESH_RATE ), lastFrameTime( 0 ),
+            clock( ), backImage( 0 )
         {
+            clock.start( );
         }
 
         ~VideoSourcePlayerQtData( )
         {
         }
 
+        void PrepareImageToDisplay( const shared_ptr<const XImage>& image, int targetWidth, int targetHeight );
+
     public:
         QMutex  syncMutex;
         int     imageWidth;
@@ -72,6 +86,18 @@ namespace Private
 
         shared_ptr<QImage> imageToDisplay;
         string             errorMessage;
+
+        // display parameters set by UI thread and used by the thread delivering video frames
+        bool    isDisplayVisible;
+        bool    isUpdatePending;
+        int     displayWidth;
+        int     displayHeight;
+        qint64  minFrameInterval;
+        qint64  lastFrameTime;
+
+        QElapsedTimer      clock;
+        // image being prepared by the video thread, which gets swapped with the one to display
+        shared_ptr<QImage> backImage;
     };
 }
 
@@ -83,8 +109,9 @@ VideoSourcePlayerQt::VideoSourcePlayerQt( QWidget* parent ) :
     setAttribute( Qt::WA_NoSystemBackground, true );
 
     SetMyContolSize( );
+    UpdateDisplayParameters( );
 
-    connect( this, SIGNAL( OnUpdateRequired( ) ), this, SLOT( update( ) ), Qt::QueuedConnection );
+    connect( this, SIGNAL( OnUpdateRequired( ) ), this, SLOT( UpdateRequired( ) ), Qt::QueuedConnection );
 }
 
 VideoSourcePlayerQt::~VideoSourcePlayerQt( )
@@ -118,6 +145,27 @@ QSize VideoSourcePlayerQt::NonScaledSize( )
     return QSize( mData->imageWidth  + BORDER_WIDTH * 2,  mData->imageHeight + BORDER_WIDTH * 2 );
 }
 
+// Update display parameters used by video thread to prepare images for displaying
+void VideoSourcePlayerQt::UpdateDisplayParameters( )
+{
+    QWindow* window      = this->window( )->windowHandle( );
+    QScreen* screen      = ( window != 0 ) ? window->screen( ) : QGuiApplication::primaryScreen( );
+    qreal    refreshRate = ( screen != 0 ) ? screen->refreshRate( ) : 0;
+    int      pixelRatio  = devicePixelRatio( );
+
+    if ( refreshRate < 1 )
+    {
+        refreshRate = DEFAULT_REFRESH_RATE;
+    }
+
+    QMutexLocker locker( &mData->syncMutex );
+
+    mData->isDisplayVisible = isVisible( );
+    mData->displayWidth     = XMAX( 0, width( )  - BORDER_WIDTH * 2 ) * pixelRatio;
+    mData->displayHeight    = XMAX( 0, height( ) - BORDER_WIDTH * 2 ) * pixelRatio;
+    mData->minFrameInterval = static_cast<qint64>( 1000000000 / refreshRate );
+}
+
 // Get UI widget of the the player
 QWidget* VideoSourcePlayerQt::PlayerWidget( )
 {
@@ -158,30 +206,72 @@ void VideoSourcePlayerQt::OnNewVideoSource( )
 // On new video frame arrived
 void VideoSourcePlayerQt::OnNewImageImpl( const shared_ptr<const XImage>& image )
 {
-    QMutexLocker locker( &mData->syncMutex );
+    bool   prepareImage = false;
+    bool   emitUpdate   = false;
+    int    targetWidth  = 0;
+    int    targetHeight = 0;
+    qint64 now          = 0;
 
-    // copy video frame into Qt image
-    XImageInterface::XtoQimage( image, mData->imageToDisplay );
-    // reset error message
-    mData->errorMessage.clear( );
-
-    if ( mData->isWaitingForFirstFrame )
     {
-        mData->imageWidth             = image->Width( );
-        mData->imageHeight            = image->Height( );
-        mData->isFirstFrame           = true;
-        mData->isWaitingForFirstFrame = false;
+        QMutexLocker locker( &mData->syncMutex );
+
+        // reset error message
+        mData->errorMessage.clear( );
+
+        if ( mData->isWaitingForFirstFrame )
+        {
+            mData->imageWidth             = image->Width( );
+            mData->imageHeight            = image->Height( );
+            mData->isFirstFrame           = true;
+            mData->isWaitingForFirstFrame = false;
+            emitUpdate                    = true;
+        }
+        else if ( ( mData->imageWidth  != image->Width( ) ) ||
+                  ( mData->imageHeight != image->Height( ) ) )
+        {
+            // a hack to resize control if video size has changed
+            mData->imageWidth   = image->Width( );
+            mData->imageHeight  = image->Height( );
+            mData->isFirstFrame = true;
+            emitUpdate          = true;
+        }
+
+        // don't spend time on preparing frames for a hidden player or more often than the screen
+        // can show them (a quarter of the interval is tolerated, so that frames coming at exactly
+        // display rate are not dropped because of jitter)
+        now = mData->clock.nsecsElapsed( );
+
+        if ( ( mData->isDisplayVisible ) &&
+             ( now - mData->lastFrameTime >= mData->minFrameInterval - mData->minFrameInterval / 4 ) )
+        {
+            prepareImage         = true;
+            targetWidth          = mData->displayWidth;
+            targetHeight         = mData->displayHeight;
+            mData->lastFrameTime = now;
+        }
     }
-    else if ( ( mData->imageWidth  != image->Width( ) ) ||
-              ( mData->imageHeight != image->Height( ) ) )
+
+    if ( prepareImage )
     {
-        // a hack to resize control if video size has changed
-        mData->imageWidth   = image->Width( );
-        mData->imageHeight  = image->Height( );
-        mData->isFirstFrame = true;
+        // the image is prepared outside of the lock, so painting is not blocked by it
+        mData->PrepareImageToDisplay( image, targetWidth, targetHeight );
+
+        QMutexLocker locker( &mData->syncMutex );
+
+        mData->imageToDisplay.swap( mData->backImage );
+
+        // don't flood UI thread with update requests, if it did not get to the previous one yet
+        if ( !mData->isUpdatePending )
+        {
+            mData->isUpdatePending = true;
+            emitUpdate             = true;
+        }
     }
 
-    emit OnUpdateRequired( );
+    if ( emitUpdate )
+    {
+        emit OnUpdateRequired( );
+    }
 }
 
 // On new error message from video source
@@ -194,6 +284,16 @@ void VideoSourcePlayerQt::OnErrorImpl( const std::string& errorMessage )
     emit OnUpdateRequired( );
 }
 
+// Update of the control was requested from video thread
+void VideoSourcePlayerQt::UpdateRequired( )
+{
+    {
+        QMutexLocker locker( &mData->syncMutex );
+        mData->isUpdatePending = false;
+    }
+    update( );
+}
+
 // Paint the control
 void VideoSourcePlayerQt::paintEvent( QPaintEvent* )
 {
@@ -205,7 +305,8 @@ void VideoSourcePlayerQt::paintEvent( QPaintEvent* )
     }
 
     QPainter painter;
-    QRect    myRect = rect( );
+    QRect    myRect     = rect( );
+    int      pixelRatio = devicePixelRatio( );
 
     painter.begin( this );
     painter.setRenderHints( QPainter::Antialiasing            |
@@ -220,8 +321,10 @@ void VideoSourcePlayerQt::paintEvent( QPaintEvent* )
 
         if ( mData->imageToDisplay )
         {
-            if ( ( mData->imageWidth  != myRect.width( ) - BORDER_WIDTH * 2  ) ||
-                 ( mData->imageHeight != myRect.height( ) - BORDER_WIDTH * 2 ) )
+            // the image is usually prepared to fit the control already, but it still may need scaling
+            // if the control got resized or the image is smaller
+            if ( ( mData->imageToDisplay->width( )  != ( myRect.width( )  - BORDER_WIDTH * 2 ) * pixelRatio ) ||
+                 ( mData->imageToDisplay->height( ) != ( myRect.height( ) - BORDER_WIDTH * 2 ) * pixelRatio ) )
             {
                 painter.setRenderHints( QPainter::SmoothPixmapTransform, true );
             }
@@ -294,5 +397,86 @@ void VideoSourcePlayerQt::leaveEvent( QEvent* event )
     mData->isMouseHighlighted = false;
     update( );
     QWidget::leaveEvent( event );
+}
+
+// Control was resized - video frames need to be prepared for the new size
+void VideoSourcePlayerQt::resizeEvent( QResizeEvent* event )
+{
+    UpdateDisplayParameters( );
+    QWidget::resizeEvent( event );
+}
+
+// Control became visible - resume preparing video frames for displaying
+void VideoSourcePlayerQt::showEvent( QShowEvent* event )
+{
+    UpdateDisplayParameters( );
+    QWidget::showEvent( event );
+}
+
+// Control got hidden (or its window minimized) - stop preparing video frames for displaying
+void VideoSourcePlayerQt::hideEvent( QHideEvent* event )
+{
+    {
+        QMutexLocker locker( &mData->syncMutex );
+        mData->isDisplayVisible = false;
+    }
+    QWidget::hideEvent( event );
+}
+
+namespace Private
+{
+
+// Prepare video frame for displaying. Images bigger than the display area are downsampled directly
+// into the display buffer in the thread delivering video frames, so UI thread only needs to copy
+// screen's amount of pixels no matter what resolution the video source has.
+void VideoSourcePlayerQtData::PrepareImageToDisplay( const shared_ptr<const XImage>& image, int targetWidth, int targetHeight )
+{
+    XPixelFormat srcFormat = image->Format( );
+    bool         downsize  = ( targetWidth > 0 ) && ( targetHeight > 0 ) &&
+                             ( ( image->Width( ) > targetWidth ) || ( image->Height( ) > targetHeight ) ) &&
+                             ( ( srcFormat == XPixelFormatGrayscale8 ) ||
+                               ( srcFormat == XPixelFormatRGB24 ) ||
+                               ( srcFormat == XPixelFormatRGBA32 ) );
+
+    if ( !downsize )
+    {
+        // copy video frame into Qt image (reusing the buffer if possible)
+        XImageInterface::XtoQimage( image, backImage );
+    }
+    else
+    {
+        // Qt formats having same memory layout as the source image, so that it can be resized
+        // straight into the buffer of Qt image
+        QImage::Format qFormat = ( srcFormat == XPixelFormatGrayscale8 ) ? QImage::Format_Indexed8 :
+                                 ( srcFormat == XPixelFormatRGB24 ) ? QImage::Format_RGB888 : QImage::Format_RGBA8888;
 
+        if ( ( !backImage ) || ( backImage->width( ) != targetWidth ) ||
+             ( backImage->height( ) != targetHeight ) || ( backImage->format( ) != qFormat ) )
+        {
+            backImage.reset( new QImage( targetWidth, targetHeight, qFormat ) );
+
+            if ( qFormat == QImage::Format_Indexed8 )
+            {
+                backImage->setColorCount( 256 );
+                for ( int i = 0; i < 256; i++ )
+                {
+                    backImage->setColor( i, 0xFF000000 + ( i << 16 ) + ( i << 8 ) + i );
+                }
+            }
+        }
+
+        // wrap Qt image's buffer as XImage
+        shared_ptr<XImage> dstImage = XImage::Create( (uint8_t*) backImage->bits( ), targetWidth, targetHeight,
+                                                      backImage->bytesPerLine( ), srcFormat );
+
+        if ( dstImage )
+        {
+            XErrorCode errorCode = ResizeImageBilinear( image->ImageData( ), dstImage->ImageData( ) );
+
+            Q_ASSERT( errorCode == SuccessCode );
+            XUNREFERENCED_PARAMETER( errorCode );
+        }
+    }
 }
+
+} // namespace Private
@@ -62,13 +62,20 @@ private:
     virtual void paintEvent( QPaintEvent* event );
     virtual void enterEvent( QEvent* event );
     virtual void leaveEvent( QEvent* event );
+    virtual void resizeEvent( QResizeEvent* event );
+    virtual void showEvent( QShowEvent* event );
+    virtual void hideEvent( QHideEvent* event );
 
 private:
     void SetMyContolSize( );
+    void UpdateDisplayParameters( );
 
 signals:
     void OnUpdateRequired( );
 
+private slots:
+    void UpdateRequired( );
+
 private:
     Private::VideoSourcePlayerQtData* mData;
 };
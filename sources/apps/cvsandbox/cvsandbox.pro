@@ -10,6 +10,7 @@ INCLUDEPATH += ../../afx/afx_types/ \
                ../../afx/afx_types+/ \
                ../../afx/afx_imaging/ \
                ../../afx/afx_video+/ \
+               ../../afx/afx_platform+/ \
                ../../core/iplugin/ \
                ../../core/pluginmgr/ \
                ../../core/automationserver/ \
@@ -59,6 +60,7 @@ contains(MAKEFILE_GENERATOR, "MSBUILD") || contains(MAKEFILE_GENERATOR, "MSVC.NE
 
     LIBS += -lPdh
     LIBS += -lWinmm
+    LIBS += -lws2_32
 }
 
 contains(MAKEFILE_GENERATOR, "MINGW") {
@@ -83,6 +85,7 @@ contains(MAKEFILE_GENERATOR, "MINGW") {
 
     LIBS += -lPdh
     LIBS += -lWinmm
+    LIBS += -lws2_32
 }
 
 contains(MAKEFILE_GENERATOR, "MSBUILD") || contains(MAKEFILE_GENERATOR, "MSVC.NET") {
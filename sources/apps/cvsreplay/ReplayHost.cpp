@@ -0,0 +1,321 @@
+/*
+    Computer Vision Sandbox Step Capture Replay application
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <stdio.h>
+#include "ReplayHost.hpp"
+
+using namespace std;
+using namespace CVSandbox;
+using namespace CVSandbox::Automation;
+
+ReplayHost::ReplayHost( const shared_ptr<XPluginsEngine>& pluginsEngine, const XVideoFrameTimestamps& timestamps ) :
+    mPluginsEngine( pluginsEngine ), mTimestamps( timestamps ), mImage( ), mVariables( ), mImageVariables( )
+{
+}
+
+// Set callbacks of the scripting engine, then initialize it, load and initialize its script
+XErrorCode ReplayHost::PrepareScriptingEngine( const shared_ptr<XScriptingEnginePlugin>& scriptingEngine )
+{
+    ScriptingEnginePluginCallbacks callbacks;
+    XErrorCode                     ret;
+
+    callbacks.GetHostName          = Callback_GetHostName;
+    callbacks.GetHostVersion       = Callback_GetHostVersion;
+    callbacks.PrintString          = Callback_PrintString;
+    callbacks.CreatePluginInstance = Callback_CreatePluginInstance;
+    callbacks.GetImage             = Callback_GetImage;
+    callbacks.SetImage             = Callback_SetImage;
+    callbacks.GetVariable          = Callback_GetVariable;
+    callbacks.SetVariable          = Callback_SetVariable;
+    callbacks.GetImageVariable     = Callback_GetImageVariable;
+    callbacks.SetImageVariable     = Callback_SetImageVariable;
+    callbacks.GetVideoSource       = Callback_GetVideoSource;
+    callbacks.GetFrameTimestamps   = Callback_GetFrameTimestamps;
+
+    scriptingEngine->SetCallbacks( &callbacks, this );
+
+    if ( ( ( ret = scriptingEngine->Init( ) ) == SuccessCode ) &&
+         ( ( ret = scriptingEngine->LoadScript( ) ) == SuccessCode ) )
+    {
+        ret = scriptingEngine->InitScript( );
+    }
+
+    return ret;
+}
+
+// Set image to provide to the script on next run
+void ReplayHost::SetImage( const shared_ptr<XImage>& image )
+{
+    mImage = image;
+}
+
+// Callback to get name of the host running scripting engine plug-in
+xstring ReplayHost::Callback_GetHostName( void* userParam )
+{
+    XUNREFERENCED_PARAMETER( userParam )
+    return XStringAlloc( "Automation Server" );
+}
+
+// Callback to get version of the host running scripting engine plug-in
+void ReplayHost::Callback_GetHostVersion( void* userParam, xversion* version )
+{
+    XUNREFERENCED_PARAMETER( userParam )
+
+    if ( version )
+    {
+        version->major    = 1;
+        version->minor    = 0;
+        version->revision = 1;
+    }
+}
+
+// Callback to print a string message at the host
+void ReplayHost::Callback_PrintString( void* userParam, xstring message )
+{
+    XUNREFERENCED_PARAMETER( userParam )
+    printf( "Script: %s \n", message );
+}
+
+// Callback to create plug-in instance (plug-in name may be prefixed with module name)
+XErrorCode ReplayHost::Callback_CreatePluginInstance( void* userParam, xstring xPluginName, PluginDescriptor** pDescriptor, void** pPlugin )
+{
+    ReplayHost* self = static_cast<ReplayHost*>( userParam );
+    XErrorCode  ret  = SuccessCode;
+
+    if ( ( pDescriptor == nullptr ) || ( pPlugin == nullptr ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else
+    {
+        string                              pluginName( xPluginName );
+        size_t                              dotIndex = pluginName.find( '.' );
+        shared_ptr<const XPluginDescriptor> pluginDesc;
+
+        if ( dotIndex == string::npos )
+        {
+            pluginDesc = self->mPluginsEngine->GetPlugin( pluginName );
+        }
+        else
+        {
+            shared_ptr<const XPluginsModule> module = self->mPluginsEngine->GetModule( pluginName.substr( 0, dotIndex ) );
+
+            if ( module )
+            {
+                pluginDesc = module->GetPlugin( pluginName.substr( dotIndex + 1 ) );
+            }
+        }
+
+        if ( !pluginDesc )
+        {
+            ret = ErrorPluginNotFound;
+        }
+        else
+        {
+            PluginDescriptor* tempDescriptor = pluginDesc->GetPluginDescriptorCopy( );
+
+            *pPlugin = tempDescriptor->Creator( );
+
+            if ( *pPlugin == nullptr )
+            {
+                ret = ErrorFailedPluginInstantiation;
+                FreePluginDescriptor( &tempDescriptor );
+            }
+            else
+            {
+                *pDescriptor = tempDescriptor;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Callback to get xvariant variable from the host side
+XErrorCode ReplayHost::Callback_GetVariable( void* userParam, xstring name, xvariant* value )
+{
+    ReplayHost* self = static_cast<ReplayHost*>( userParam );
+    XErrorCode  ret  = ErrorNullParameter;
+
+    if ( ( name != nullptr ) && ( value != nullptr ) )
+    {
+        map<string, XVariant>::const_iterator it = self->mVariables.find( name );
+
+        ret = XVariantCopy( ( it != self->mVariables.end( ) ) ? it->second : XVariant( ), value );
+    }
+
+    return ret;
+}
+
+// Callback to store xvariant variable on the host side
+XErrorCode ReplayHost::Callback_SetVariable( void* userParam, xstring name, const xvariant* value )
+{
+    ReplayHost* self = static_cast<ReplayHost*>( userParam );
+    XErrorCode  ret  = ErrorNullParameter;
+
+    if ( ( name != nullptr ) && ( value != nullptr ) )
+    {
+        ret = SuccessCode;
+
+        if ( value->type == XVT_Image )
+        {
+            // still store it as image, not variant
+            ret = Callback_SetImageVariable( userParam, name, value->value.imageVal );
+        }
+        else
+        {
+            XVariant variable( *value );
+
+            self->mImageVariables.erase( name );
+
+            if ( variable.IsNullOrEmpty( ) )
+            {
+                self->mVariables.erase( name );
+            }
+            else
+            {
+                self->mVariables[name] = variable;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Callback to get image variable from the host side
+XErrorCode ReplayHost::Callback_GetImageVariable( void* userParam, xstring name, ximage** value )
+{
+    ReplayHost* self = static_cast<ReplayHost*>( userParam );
+    XErrorCode  ret  = ErrorNullParameter;
+
+    if ( ( name != nullptr ) && ( value != nullptr ) )
+    {
+        map<string, shared_ptr<XImage>>::const_iterator it = self->mImageVariables.find( name );
+
+        *value = nullptr;
+        ret    = SuccessCode;
+
+        if ( it != self->mImageVariables.end( ) )
+        {
+            shared_ptr<XImage> image = it->second->Clone( );
+
+            if ( image )
+            {
+                *value = image->ImageData( );
+                // reset C++ image to null, so it no longer responsible for C structure life time
+                image->Reset( nullptr );
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Callback to store image variable on the host side
+XErrorCode ReplayHost::Callback_SetImageVariable( void* userParam, xstring name, const ximage* value )
+{
+    ReplayHost* self = static_cast<ReplayHost*>( userParam );
+    XErrorCode  ret  = ErrorNullParameter;
+
+    if ( name != nullptr )
+    {
+        ret = SuccessCode;
+
+        self->mVariables.erase( name );
+
+        if ( value == nullptr )
+        {
+            self->mImageVariables.erase( name );
+        }
+        else if ( !XImage::Create( value )->CopyDataOrClone( self->mImageVariables[name] ) )
+        {
+            ret = ErrorOutOfMemory;
+        }
+    }
+
+    return ret;
+}
+
+// Callback to get current image available on the host side
+XErrorCode ReplayHost::Callback_GetImage( void* userParam, ximage** image )
+{
+    ReplayHost* self = static_cast<ReplayHost*>( userParam );
+    XErrorCode  ret  = ErrorFailed;
+
+    if ( self->mImage )
+    {
+        ximage* hostImage = self->mImage->ImageData( );
+
+        ret = XImageCreate( hostImage->data, hostImage->width, hostImage->height, hostImage->stride, hostImage->format, image );
+    }
+
+    return ret;
+}
+
+// Callback to set/replace current image on the host side
+XErrorCode ReplayHost::Callback_SetImage( void* userParam, ximage* image )
+{
+    ReplayHost* self = static_cast<ReplayHost*>( userParam );
+    XErrorCode  ret  = ErrorFailed;
+
+    if ( self->mImage )
+    {
+        ret = SuccessCode;
+
+        if ( ( self->mImage->Data( ) != image->data ) &&
+             ( !XImage::Create( image )->CopyDataOrClone( self->mImage ) ) )
+        {
+            ret = ErrorOutOfMemory;
+        }
+    }
+
+    return ret;
+}
+
+// Callback to get video source associated with the running script - not available when replaying
+XErrorCode ReplayHost::Callback_GetVideoSource( void* userParam, PluginDescriptor** pDescriptor, void** pPlugin )
+{
+    XUNREFERENCED_PARAMETER( userParam )
+    XUNREFERENCED_PARAMETER( pDescriptor )
+    XUNREFERENCED_PARAMETER( pPlugin )
+    return ErrorNotImplemented;
+}
+
+// Callback to get time stamps of the captured video frame
+XErrorCode ReplayHost::Callback_GetFrameTimestamps( void* userParam, xframetimestamps* timestamps )
+{
+    ReplayHost* self = static_cast<ReplayHost*>( userParam );
+    XErrorCode  ret  = SuccessCode;
+
+    if ( timestamps == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else
+    {
+        timestamps->captured           = self->mTimestamps.Captured;
+        timestamps->arrived            = self->mTimestamps.Arrived;
+        timestamps->processingStarted  = self->mTimestamps.ProcessingStarted;
+        timestamps->processingFinished = self->mTimestamps.ProcessingFinished;
+    }
+
+    return ret;
+}
@@ -0,0 +1,73 @@
+/*
+    Computer Vision Sandbox Step Capture Replay application
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_REPLAY_HOST_HPP
+#define CVS_REPLAY_HOST_HPP
+
+#include <string>
+#include <map>
+#include <memory>
+#include <XInterfaces.hpp>
+#include <XVariant.hpp>
+#include <XImage.hpp>
+#include <XPluginsEngine.hpp>
+#include <XScriptingEnginePlugin.hpp>
+#include <XStepCaptureCase.hpp>
+
+// Host for scripting engine plug-ins replaying captured step. It provides captured frame and its time
+// stamps to the script. Host variables are not captured, so the script starts with empty ones, which are
+// then kept between iterations. Video source is not available to the script.
+class ReplayHost : private CVSandbox::Uncopyable
+{
+public:
+    ReplayHost( const std::shared_ptr<XPluginsEngine>& pluginsEngine,
+                const CVSandbox::Automation::XVideoFrameTimestamps& timestamps );
+
+    // Set callbacks of the scripting engine, then initialize it, load and initialize its script
+    XErrorCode PrepareScriptingEngine( const std::shared_ptr<XScriptingEnginePlugin>& scriptingEngine );
+
+    // Set image to provide to the script on next run
+    void SetImage( const std::shared_ptr<CVSandbox::XImage>& image );
+
+private:
+    static xstring Callback_GetHostName( void* userParam );
+    static void Callback_GetHostVersion( void* userParam, xversion* version );
+    static void Callback_PrintString( void* userParam, xstring message );
+    static XErrorCode Callback_CreatePluginInstance( void* userParam, xstring pluginName, PluginDescriptor** pDescriptor, void** pPlugin );
+    static XErrorCode Callback_GetVariable( void* userParam, xstring name, xvariant* value );
+    static XErrorCode Callback_SetVariable( void* userParam, xstring name, const xvariant* value );
+    static XErrorCode Callback_GetImageVariable( void* userParam, xstring name, ximage** value );
+    static XErrorCode Callback_SetImageVariable( void* userParam, xstring name, const ximage* value );
+    static XErrorCode Callback_GetImage( void* userParam, ximage** image );
+    static XErrorCode Callback_SetImage( void* userParam, ximage* image );
+    static XErrorCode Callback_GetVideoSource( void* userParam, PluginDescriptor** pDescriptor, void** pPlugin );
+    static XErrorCode Callback_GetFrameTimestamps( void* userParam, xframetimestamps* timestamps );
+
+private:
+    std::shared_ptr<XPluginsEngine>                         mPluginsEngine;
+    CVSandbox::Automation::XVideoFrameTimestamps            mTimestamps;
+    std::shared_ptr<CVSandbox::XImage>                      mImage;
+    std::map<std::string, CVSandbox::XVariant>              mVariables;
+    std::map<std::string, std::shared_ptr<CVSandbox::XImage>> mImageVariables;
+};
+
+#endif // CVS_REPLAY_HOST_HPP
@@ -0,0 +1,370 @@
+/*
+    Computer Vision Sandbox Step Capture Replay application
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#ifdef _MSC_VER
+#define _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <map>
+#include <chrono>
+#include <XError.hpp>
+#include <XPluginsEngine.hpp>
+#include <XImageProcessingFilterPlugin.hpp>
+#include <XVideoProcessingPlugin.hpp>
+#include <XDetectionPlugin.hpp>
+#include <XScriptingEnginePlugin.hpp>
+#include <XStepCaptureCase.hpp>
+#include "ReplayHost.hpp"
+
+using namespace std;
+using namespace std::chrono;
+using namespace CVSandbox;
+using namespace CVSandbox::Automation;
+
+// Application's name and version
+const char* APP_NAME    =  "Computer Vision Sandbox Step Capture Replay";
+xversion    APP_VERSION = { 1, 0, 0 };
+
+// Some error code the app may return
+enum
+{
+    Error_NoArguments                = -1,
+    Error_InvalidArgument            = -2,
+    Error_FailedLoadingCapture       = -3,
+    Error_PluginNotFound             = -4,
+    Error_FailedPluginInstantiation  = -5,
+    Error_FailedPluginConfiguration  = -6,
+    Error_FailedScriptPreparation    = -7,
+    Error_UnsupportedPluginType      = -8,
+    Error_StepFailed                 = -9
+};
+
+// Options of the application
+struct ReplayOptions
+{
+    string   CaptureFileName;
+    string   PluginsFolder;
+    uint32_t Iterations;
+    bool     InfoOnly;
+
+    ReplayOptions( ) :
+        CaptureFileName( ), PluginsFolder( "./cvsplugins/" ), Iterations( 1 ), InfoOnly( false )
+    {
+    }
+};
+
+// Some forward declarations -------
+static int CheckArguments( int argc, char* argv[], ReplayOptions& options );
+static void PrintCaptureInfo( const XStepCaptureCase& captureCase );
+static int ReplayStep( const shared_ptr<XPluginsEngine>& pluginsEngine, const XStepCaptureCase& captureCase, uint32_t iterations );
+// ---------------------------------
+
+// Let's finally start here
+int main( int argc, char* argv[] )
+{
+    int rc = 0;
+
+    {
+        ReplayOptions options;
+
+        rc = CheckArguments( argc, argv, options );
+
+        if ( rc == 0 )
+        {
+            XStepCaptureCase captureCase;
+            XErrorCode       errorCode = captureCase.Load( options.CaptureFileName );
+
+            if ( errorCode != SuccessCode )
+            {
+                rc = Error_FailedLoadingCapture;
+                printf( "Error: Failed loading the captured step. \n" );
+                printf( "%s \n\n", XError::Description( errorCode ).c_str( ) );
+            }
+            else
+            {
+                PrintCaptureInfo( captureCase );
+
+                if ( !options.InfoOnly )
+                {
+                    shared_ptr<XPluginsEngine> pluginsEngine = XPluginsEngine::Create( );
+
+                    pluginsEngine->CollectModules( options.PluginsFolder );
+
+                    rc = ReplayStep( pluginsEngine, captureCase, options.Iterations );
+                }
+            }
+        }
+    }
+
+    #ifdef _MSC_VER
+    _CrtDumpMemoryLeaks();
+    #endif
+
+    return rc;
+}
+
+// Print application's help and usage info
+static void ShowHelp( )
+{
+    printf( "%s v%d.%d.%d \n", APP_NAME, APP_VERSION.major, APP_VERSION.minor, APP_VERSION.revision );
+    printf( "\n" );
+    printf( "Usage: cvsreplay <captured_step.cvscap> [-n iterations] [-p plugins_folder] [-info]\n" );
+    printf( "\n" );
+    printf( "Runs video processing step captured by automation server (failed or slow one) on its \n" );
+    printf( "captured input frame using the same plug-in and configuration, so it could be debugged \n" );
+    printf( "or profiled in isolation. \n" );
+    printf( "\n" );
+    printf( "  -n      Number of times to run the step, each time on a fresh copy of the frame (1 by default). \n" );
+    printf( "  -p      Folder to load plug-ins from (./cvsplugins/ by default). \n" );
+    printf( "  -info   Show information about the captured step only. \n" );
+    printf( "\n" );
+    printf( "Note: Scripts start with empty host variables since those are not captured. Video source \n" );
+    printf( "      is not available to them either. \n" );
+
+    printf( "\n" );
+}
+
+// Check/process application's arguments
+int CheckArguments( int argc, char* argv[], ReplayOptions& options )
+{
+    int ret = 0;
+
+    if ( argc <= 1 )
+    {
+        ret = Error_NoArguments;
+        ShowHelp( );
+    }
+    else
+    {
+        options.CaptureFileName = argv[1];
+
+        for ( int i = 2; ( i < argc ) && ( ret == 0 ); i++ )
+        {
+            if ( strcmp( argv[i], "-info" ) == 0 )
+            {
+                options.InfoOnly = true;
+            }
+            else if ( ( ( strcmp( argv[i], "-n" ) == 0 ) || ( strcmp( argv[i], "-p" ) == 0 ) ) && ( i + 1 < argc ) )
+            {
+                if ( argv[i][1] == 'p' )
+                {
+                    options.PluginsFolder = argv[++i];
+                }
+                else
+                {
+                    int iterations = atoi( argv[++i] );
+
+                    if ( iterations <= 0 )
+                    {
+                        printf( "Error: Number of iterations must be positive. \n\n" );
+                        ret = Error_InvalidArgument;
+                    }
+                    else
+                    {
+                        options.Iterations = static_cast<uint32_t>( iterations );
+                    }
+                }
+            }
+            else
+            {
+                printf( "Error: Don't know what to do with \"%s\". \n\n", argv[i] );
+                ret = Error_InvalidArgument;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Print information about the captured step
+static void PrintCaptureInfo( const XStepCaptureCase& captureCase )
+{
+    printf( "Captured step    : #%d \"%s\" of video source %u \n", captureCase.StepIndex, captureCase.StepName.c_str( ), captureCase.VideoSourceId );
+    printf( "Plug-in          : %s %s \n", captureCase.PluginName.c_str( ), captureCase.PluginId.ToString( ).c_str( ) );
+
+    if ( captureCase.Reason == XStepCaptureReason::Error )
+    {
+        printf( "Reason           : error - %s \n", captureCase.ErrorMessage.c_str( ) );
+    }
+    else
+    {
+        printf( "Reason           : slow - over %.2f ms \n", captureCase.LatencyThreshold );
+    }
+
+    printf( "Time taken       : %.2f ms \n", captureCase.TimeTaken );
+
+    if ( captureCase.Image )
+    {
+        printf( "Frame            : %dx%d %s \n", captureCase.Image->Width( ), captureCase.Image->Height( ),
+                XImage::PixelFormatName( captureCase.Image->Format( ) ).c_str( ) );
+    }
+
+    for ( map<string, XVariant>::const_iterator it = captureCase.Configuration.begin( ); it != captureCase.Configuration.end( ); ++it )
+    {
+        printf( "  %-15s: %s \n", it->first.c_str( ), it->second.ToString( ).c_str( ) );
+    }
+
+    printf( "\n" );
+}
+
+// Run the captured step the specified number of times and print timing of it
+static int ReplayStep( const shared_ptr<XPluginsEngine>& pluginsEngine, const XStepCaptureCase& captureCase, uint32_t iterations )
+{
+    shared_ptr<const XPluginDescriptor> pluginDesc = pluginsEngine->GetPlugin( captureCase.PluginId );
+    shared_ptr<XPlugin>                 plugin;
+    ReplayHost                          host( pluginsEngine, captureCase.Timestamps );
+    XErrorCode                          errorCode;
+
+    if ( !pluginDesc )
+    {
+        printf( "Error: The plug-in of the step was not found. \n\n" );
+        return Error_PluginNotFound;
+    }
+
+    if ( !( plugin = pluginDesc->CreateInstance( ) ) )
+    {
+        printf( "Error: Failed creating instance of the plug-in. \n\n" );
+        return Error_FailedPluginInstantiation;
+    }
+
+    if ( ( errorCode = pluginDesc->SetPluginConfiguration( plugin, captureCase.Configuration ) ) != SuccessCode )
+    {
+        printf( "Error: Failed setting configuration of the plug-in. \n" );
+        printf( "%s \n\n", XError::Description( errorCode ).c_str( ) );
+        return Error_FailedPluginConfiguration;
+    }
+
+    if ( pluginDesc->Type( ) == PluginType_ScriptingEngine )
+    {
+        shared_ptr<XScriptingEnginePlugin> scriptingEngine = static_pointer_cast<XScriptingEnginePlugin>( plugin );
+
+        if ( ( errorCode = host.PrepareScriptingEngine( scriptingEngine ) ) != SuccessCode )
+        {
+            printf( "Error: Failed loading/initializing the script. \n" );
+            printf( "%s \n\n", scriptingEngine->GetLastErrorMessage( ).c_str( ) );
+            return Error_FailedScriptPreparation;
+        }
+    }
+    else if ( ( pluginDesc->Type( ) != PluginType_ImageProcessingFilter ) &&
+              ( pluginDesc->Type( ) != PluginType_VideoProcessing ) &&
+              ( pluginDesc->Type( ) != PluginType_Detection ) )
+    {
+        printf( "Error: The plug-in type is not supported in video processing steps. \n\n" );
+        return Error_UnsupportedPluginType;
+    }
+
+    shared_ptr<XImage> image;
+    shared_ptr<XImage> outputImage;
+    uint32_t           failedRuns = 0;
+    XErrorCode         lastError  = SuccessCode;
+    float              minTime    = 0.0f;
+    float              maxTime    = 0.0f;
+    float              totalTime  = 0.0f;
+
+    for ( uint32_t i = 0; i < iterations; i++ )
+    {
+        // every run gets a fresh copy, since the step may change the frame
+        if ( !captureCase.Image->CopyDataOrClone( image ) )
+        {
+            printf( "Error: Not enough memory to copy the frame. \n\n" );
+            return Error_StepFailed;
+        }
+
+        steady_clock::time_point startTime = steady_clock::now( );
+
+        switch ( pluginDesc->Type( ) )
+        {
+        case PluginType_ImageProcessingFilter:
+            {
+                shared_ptr<XImageProcessingFilterPlugin> filter = static_pointer_cast<XImageProcessingFilterPlugin>( plugin );
+
+                if ( !filter->IsPixelFormatSupported( image->Format( ) ) )
+                {
+                    errorCode = ErrorUnsupportedPixelFormat;
+                }
+                else if ( filter->CanProcessInPlace( ) )
+                {
+                    errorCode = filter->ProcessImage( image );
+                }
+                else
+                {
+                    errorCode = filter->ProcessImage( image, outputImage );
+                }
+            }
+            break;
+
+        case PluginType_VideoProcessing:
+            errorCode = ( static_pointer_cast<XVideoProcessingPlugin>( plugin )->IsPixelFormatSupported( image->Format( ) ) ) ?
+                          static_pointer_cast<XVideoProcessingPlugin>( plugin )->ProcessImage( image ) : ErrorUnsupportedPixelFormat;
+            break;
+
+        case PluginType_Detection:
+            errorCode = ( static_pointer_cast<XDetectionPlugin>( plugin )->IsPixelFormatSupported( image->Format( ) ) ) ?
+                          static_pointer_cast<XDetectionPlugin>( plugin )->ProcessImage( image ) : ErrorUnsupportedPixelFormat;
+            break;
+
+        default:
+            host.SetImage( image );
+            errorCode = static_pointer_cast<XScriptingEnginePlugin>( plugin )->RunScript( );
+            break;
+        }
+
+        float timeTaken = static_cast<float>( duration_cast<std::chrono::microseconds>( steady_clock::now( ) - startTime ).count( ) ) / 1000.0f;
+
+        totalTime += timeTaken;
+        minTime    = ( ( i == 0 ) || ( timeTaken < minTime ) ) ? timeTaken : minTime;
+        maxTime    = ( ( i == 0 ) || ( timeTaken > maxTime ) ) ? timeTaken : maxTime;
+
+        if ( errorCode != SuccessCode )
+        {
+            failedRuns++;
+            lastError = errorCode;
+        }
+    }
+
+    printf( "Runs             : %u (%u failed) \n", iterations, failedRuns );
+    printf( "Time (ms)        : min %.3f, avg %.3f, max %.3f \n", minTime, totalTime / iterations, maxTime );
+
+    if ( failedRuns != 0 )
+    {
+        string errorMessage;
+
+        if ( ( lastError == ErrorFailedRunningScript ) && ( pluginDesc->Type( ) == PluginType_ScriptingEngine ) )
+        {
+            errorMessage = static_pointer_cast<XScriptingEnginePlugin>( plugin )->GetLastErrorMessage( );
+        }
+        if ( errorMessage.empty( ) )
+        {
+            errorMessage = XError::Description( lastError );
+        }
+
+        printf( "Last error       : %s \n", errorMessage.c_str( ) );
+    }
+
+    printf( "\n" );
+
+    return ( failedRuns != 0 ) ? Error_StepFailed : 0;
+}
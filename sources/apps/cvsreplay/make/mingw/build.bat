@@ -0,0 +1,4 @@
+@echo off
+call make.bat clean
+call make.bat
+call make.bat clean
@@ -0,0 +1,2 @@
+@set PATH=%PATH%;%MINGW_BIN%
+%MINGW_BIN%\mingw32-make.exe %1
@@ -0,0 +1,9 @@
+@echo off
+
+if "%1"=="clean" (
+	msbuild cvsreplay.sln /t:Clean /p:Configuration=Debug /p:Platform=Win32
+	msbuild cvsreplay.sln /t:Clean /p:Configuration=Release /p:Platform=Win32
+) else (
+	msbuild cvsreplay.sln /p:Configuration=Debug /p:Platform=Win32
+	msbuild cvsreplay.sln /p:Configuration=Release /p:Platform=Win32
+)
@@ -0,0 +1,15 @@
+# cvsreplay application's source files
+
+# search path for source files
+VPATH = ../../
+
+# source files
+SRC = cvsreplay.cpp ReplayHost.cpp
+
+# additional include folders
+INCLUDES = -I../../../../afx/afx_types -I../../../../afx/afx_types+ \
+	-I../../../../core/iplugin -I../../../../core/pluginmgr \
+	-I../../../../core/automationserver
+
+# libraries to use
+LIBS = -lautomationserver -lpluginmgr -liplugin -lafx_platform+ -lafx_types+ -lafx_types
@@ -2,7 +2,8 @@
 
 set BUILD_FOLDERS=..\..\cvsandboxtools\make\mingw ^
                   ..\..\cvsandbox\make\mingw ^
-                  ..\..\cvssr\make\mingw
+                  ..\..\cvssr\make\mingw ^
+                  ..\..\cvsreplay\make\mingw
 
 set MY_FOLDER=%cd%
 
@@ -3,6 +3,7 @@
 set BUILD_FOLDERS=..\..\cvsandboxtools\make\msvc ^
                   ..\..\cvsandbox\make\msvc ^
                   ..\..\cvssr\make\msvc ^
+                  ..\..\cvsreplay\make\msvc ^
                   ..\..\cvs_vcam\make\msvc
 
 set MY_FOLDER=%cd%
@@ -23,6 +23,8 @@
 #ifndef CVS_IAUTOMATION_VIDEO_SOURCE_LISTENER_HPP
 #define CVS_IAUTOMATION_VIDEO_SOURCE_LISTENER_HPP
 
+#include "XVideoSourceFrameInfo.hpp"
+
 namespace CVSandbox { namespace Automation
 {
 
@@ -33,6 +35,13 @@ public:
 
     virtual void OnNewVideoFrame( uint32_t videoSourceId, const std::shared_ptr<const XImage>& image ) = 0;
 
+    // New video frame notification along with time stamps of the frame (capture, arrival, processing)
+    virtual void OnNewVideoFrame( uint32_t videoSourceId, const std::shared_ptr<const XImage>& image, const XVideoFrameTimestamps& timestamps )
+    {
+        XUNREFERENCED_PARAMETER( timestamps )
+        OnNewVideoFrame( videoSourceId, image );
+    }
+
     virtual void OnErrorMessage( uint32_t videoSourceId, const std::string& errorMessage ) = 0;
 };
 
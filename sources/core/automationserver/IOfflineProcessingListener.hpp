@@ -0,0 +1,66 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_IOFFLINE_PROCESSING_LISTENER_HPP
+#define CVS_IOFFLINE_PROCESSING_LISTENER_HPP
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <XImage.hpp>
+#include <XVariant.hpp>
+
+namespace CVSandbox { namespace Automation
+{
+
+// Outputs of video processing graph for a single video frame
+struct XOfflineFrameResult
+{
+    // Number of the video frame in the processed video (zero based)
+    uint32_t                                                    FrameNumber;
+    // Processed video frame (provided only if enabled)
+    std::shared_ptr<const CVSandbox::XImage>                    Image;
+    // Host variables set by the processing graph while processing the frame
+    std::vector<std::pair<std::string, CVSandbox::XVariant>>    Variables;
+    // Indexes of detection steps, which triggered on the frame
+    std::vector<int32_t>                                        TriggeredDetectionSteps;
+    // Error reported while processing the frame (if any)
+    std::string                                                 ErrorMessage;
+
+    XOfflineFrameResult( ) : FrameNumber( 0 ), Image( ), Variables( ), TriggeredDetectionSteps( ), ErrorMessage( )
+    {
+    }
+};
+
+class IOfflineProcessingListener
+{
+public:
+    virtual ~IOfflineProcessingListener( ) { }
+
+    // Called for every processed video frame in the order of frames in the video
+    virtual void OnFrameProcessed( const XOfflineFrameResult& frameResult ) = 0;
+};
+
+} } // namespace CVSandbox::Automation
+
+#endif // CVS_IOFFLINE_PROCESSING_LISTENER_HPP
@@ -0,0 +1,65 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_IVIDEO_SOURCE_SYNC_GROUP_LISTENER_HPP
+#define CVS_IVIDEO_SOURCE_SYNC_GROUP_LISTENER_HPP
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include <XImage.hpp>
+
+#include "XVideoSourceFrameInfo.hpp"
+
+namespace CVSandbox { namespace Automation
+{
+
+// Video frames of all video sources of a synchronization group, which were captured at nearly the same time.
+// Items of all vectors go in the order of video sources specified when creating the group.
+struct XSynchronizedFrames
+{
+    std::vector<uint32_t>                                   VideoSourceIds;
+    // Frames of the video sources (null, if there was no matching frame within the timeout)
+    std::vector<std::shared_ptr<const CVSandbox::XImage>>   Images;
+    std::vector<XVideoFrameTimestamps>                      Timestamps;
+    // Difference (ms) between capture time of the newest and the oldest frame
+    float                                                   Skew;
+    // Frames of some video sources are missing
+    bool                                                    IsPartial;
+
+    XSynchronizedFrames( ) : VideoSourceIds( ), Images( ), Timestamps( ), Skew( 0.0f ), IsPartial( false )
+    {
+    }
+};
+
+class IVideoSourceSyncGroupListener
+{
+public:
+    virtual ~IVideoSourceSyncGroupListener( ) { }
+
+    // Called for every group of matched video frames (on the synchronization thread of the group)
+    virtual void OnSynchronizedFrames( const XSynchronizedFrames& frames ) = 0;
+};
+
+} } // namespace CVSandbox::Automation
+
+#endif // CVS_IVIDEO_SOURCE_SYNC_GROUP_LISTENER_HPP
@@ -25,9 +25,11 @@
 #include <stdio.h>
 #include <map>
 #include <list>
+#include <deque>
 #include <algorithm>
 #include <numeric>
 #include <chrono>
+#include <sys/stat.h>
 
 #include <XMutex.hpp>
 #include <XManualResetEvent.hpp>
@@ -39,6 +41,9 @@
 #include <XDetectionPlugin.hpp>
 #include <XScriptingEnginePlugin.hpp>
 
+#include <ximaging.h>
+#include <xtimestamp.h>
+
 using namespace std;
 using namespace std::chrono;
 using namespace CVSandbox;
@@ -51,12 +56,283 @@ namespace CVSandbox { namespace Automation
 // Number of performance measurements to average
 #define PERFORMANCE_HISTORY_LENGTH (40)
 
+// Throttling of frames stops when memory taken by them gets below this % of the budget
+#define FRAME_MEMORY_LOW_WATERMARK (90)
+// Low priority video sources process only every Nth frame while frame memory budget is exceeded
+#define LOW_PRIORITY_DECIMATION_FACTOR (4)
+// Max number of times resolution of frames is halved while frame memory budget is exceeded
+#define MAX_RESOLUTION_REDUCTION (3)
+
 namespace Private
 {
+    // Make name of server's thread from the prefix and ID of the object it serves
+    static string MakeThreadName( const char* prefix, uint32_t id )
+    {
+        char buffer[32];
+
+        sprintf( buffer, "%s%u", prefix, id );
+
+        return string( buffer );
+    }
+
     typedef list<IAutomationVideoSourceListener*> ListenersList;
 
     class XAutomationServerData;
 
+    // Upper bounds (seconds) of buckets of latency histograms provided as metrics
+    static const double LatencyBucketBounds[] = { 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0, 2.0, 5.0 };
+    static const size_t LatencyBucketsCount   = sizeof( LatencyBucketBounds ) / sizeof( LatencyBucketBounds[0] );
+
+    // Histogram of latency values - counts of values falling into each bucket (the last one is for values
+    // above all bounds), so adding a value is cheap enough to be done for every frame
+    struct LatencyHistogram
+    {
+        uint64_t Buckets[LatencyBucketsCount + 1];
+        uint64_t Count;
+        double   Sum;
+
+        LatencyHistogram( ) : Count( 0 ), Sum( 0.0 )
+        {
+            std::fill( Buckets, Buckets + LatencyBucketsCount + 1, 0 );
+        }
+
+        void Add( double seconds )
+        {
+            size_t bucket = 0;
+
+            while ( ( bucket < LatencyBucketsCount ) && ( seconds > LatencyBucketBounds[bucket] ) )
+            {
+                bucket++;
+            }
+
+            Buckets[bucket]++;
+            Count++;
+            Sum += seconds;
+        }
+    };
+
+    // Values of a video source's metrics copied at once, so they could be grouped into families when printed
+    struct VideoSourceMetrics
+    {
+        string                  Labels;
+        XVideoSourceFrameInfo   FrameInfo;
+        LatencyHistogram        TotalLatency;
+        LatencyHistogram        ProcessingLatency;
+        vector<string>          StepNames;
+        vector<float>           StepAverageTime;
+        uint32_t                ListenersQueued;
+        uint32_t                ListenersDelivered;
+        uint32_t                ListenersDropped;
+
+        VideoSourceMetrics( ) :
+            Labels( ), FrameInfo( ), TotalLatency( ), ProcessingLatency( ), StepNames( ), StepAverageTime( ),
+            ListenersQueued( 0 ), ListenersDelivered( 0 ), ListenersDropped( 0 )
+        {
+        }
+    };
+
+    // Escape value of metric's label as required by Prometheus text format
+    static string EscapeMetricLabel( const string& value )
+    {
+        string escaped;
+
+        escaped.reserve( value.size( ) );
+
+        for ( string::const_iterator it = value.begin( ); it != value.end( ); ++it )
+        {
+            switch ( *it )
+            {
+            case '\\': escaped += "\\\\"; break;
+            case '"':  escaped += "\\\""; break;
+            case '\n': escaped += "\\n"; break;
+            default:   escaped += *it; break;
+            }
+        }
+
+        return escaped;
+    }
+
+    // Append HELP/TYPE lines of a metric family
+    static void AppendMetricFamily( string& out, const char* name, const char* type, const char* help )
+    {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += "\n# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += '\n';
+    }
+
+    // Append single sample of a metric (integer values are printed exactly up to 2^53)
+    static void AppendMetricSample( string& out, const char* name, const string& labels, double value, bool isInteger = true )
+    {
+        char buffer[64];
+
+        sprintf( buffer, ( isInteger ) ? "%.0f" : "%g", value );
+
+        out += name;
+        if ( !labels.empty( ) )
+        {
+            out += '{';
+            out += labels;
+            out += '}';
+        }
+        out += ' ';
+        out += buffer;
+        out += '\n';
+    }
+
+    // Append all samples of a latency histogram - cumulative buckets, sum and count
+    static void AppendMetricHistogram( string& out, const char* name, const string& labels, const LatencyHistogram& histogram )
+    {
+        string   bucketName = string( name ) + "_bucket";
+        string   prefix     = ( labels.empty( ) ) ? string( ) : labels + ",";
+        uint64_t cumulative = 0;
+        char     bound[32];
+
+        for ( size_t i = 0; i < LatencyBucketsCount; i++ )
+        {
+            cumulative += histogram.Buckets[i];
+            sprintf( bound, "%g", LatencyBucketBounds[i] );
+
+            AppendMetricSample( out, bucketName.c_str( ), prefix + "le=\"" + bound + "\"", static_cast<double>( cumulative ) );
+        }
+
+        AppendMetricSample( out, bucketName.c_str( ), prefix + "le=\"+Inf\"", static_cast<double>( histogram.Count ) );
+        AppendMetricSample( out, ( string( name ) + "_sum" ).c_str( ), labels, histogram.Sum, false );
+        AppendMetricSample( out, ( string( name ) + "_count" ).c_str( ), labels, static_cast<double>( histogram.Count ) );
+    }
+
+    // Mailbox of a listener, which gets notifications asynchronously - on its own dispatcher thread. Video
+    // frames are queued up to the specified length. If the listener does not keep up, the oldest queued
+    // frame is dropped, so video processing never waits for the listener. Error messages are never dropped.
+    class ListenerMailbox : private Uncopyable
+    {
+    private:
+        ListenerMailbox( uint32_t videoSourceId, IAutomationVideoSourceListener* listener, uint32_t queueLength ) :
+            Listener( listener ), VideoSourceId( videoSourceId ), QueueLength( queueLength ),
+            Sync( ), NewItemEvent( ), Items( ), FramesQueued( 0 ), FramesDelivered( 0 ), FramesDropped( 0 ),
+            NeedToExit( false ), DispatcherThreadId( 0 ), DispatcherThread( )
+        {
+            DispatcherThread.SetName( MakeThreadName( "cvs-mbox-", videoSourceId ) );
+        }
+
+    public:
+        static shared_ptr<ListenerMailbox> Create( uint32_t videoSourceId, IAutomationVideoSourceListener* listener, uint32_t queueLength )
+        {
+            shared_ptr<ListenerMailbox> mailbox( new (nothrow) ListenerMailbox( videoSourceId, listener, queueLength ) );
+
+            if ( ( mailbox ) && ( !mailbox->DispatcherThread.Create( DispatcherThreadHandler, mailbox.get( ) ) ) )
+            {
+                mailbox.reset( );
+            }
+
+            return mailbox;
+        }
+
+        ~ListenerMailbox( )
+        {
+            SignalToStop( );
+            DispatcherThread.Join( );
+        }
+
+        // Queue new video frame for the listener
+        void PostFrame( const shared_ptr<const XImage>& image, const XVideoFrameTimestamps& timestamps );
+        // Queue error message for the listener
+        void PostError( const string& errorMessage );
+        // Signal dispatcher thread to exit (without waiting for it)
+        void SignalToStop( );
+        // Check if the dispatcher thread has exited
+        bool IsStopped( );
+        // Wait for the dispatcher thread to exit (must be signalled to stop first)
+        void WaitForStop( );
+        // Check if the caller runs on the dispatcher thread (the listener is being notified)
+        bool IsDispatcherThread( ) const;
+        // Get number of frames delivered to the listener, dropped because it did not keep up and still queued
+        void GetStatistics( uint32_t* framesDelivered, uint32_t* framesDropped, uint32_t* framesQueued = nullptr );
+
+    private:
+        static void DispatcherThreadHandler( void* param );
+
+    private:
+        // Item of the mailbox - either video frame or error message
+        struct MailboxItem
+        {
+            shared_ptr<const XImage> Image;
+            XVideoFrameTimestamps    Timestamps;
+            string                   ErrorMessage;
+        };
+
+    public:
+        IAutomationVideoSourceListener* const   Listener;
+
+    private:
+        uint32_t                VideoSourceId;
+        uint32_t                QueueLength;
+        XMutex                  Sync;                   // mutex to protect items and counters
+        XManualResetEvent       NewItemEvent;           // event to signal if there is something for the dispatcher
+        deque<MailboxItem>      Items;
+        uint32_t                FramesQueued;
+        uint32_t                FramesDelivered;
+        uint32_t                FramesDropped;
+        volatile bool           NeedToExit;
+        volatile uint32_t       DispatcherThreadId;
+        XThread                 DispatcherThread;
+    };
+
+    typedef list<shared_ptr<ListenerMailbox>> MailboxList;
+
+    // Writer of captured video processing steps. Cases are saved on own low priority thread, so video processing
+    // is not delayed by disk IO, into a ring of files overwriting the oldest ones. Only few cases may wait to be
+    // saved - new ones are dropped while the writer is busy.
+    class StepCaptureWriter : private Uncopyable
+    {
+    public:
+        StepCaptureWriter( ) :
+            Sync( ), Configuration( ), Info( ), NextSlot( 0 ), Pending( ),
+            NewCaseEvent( ), NeedToExit( false ), WriterThread( )
+        {
+            WriterThread.SetName( "cvs-capture" );
+        }
+
+        ~StepCaptureWriter( )
+        {
+            NeedToExit = true;
+            NewCaseEvent.Signal( );
+            WriterThread.Join( );
+        }
+
+        // Set/get configuration of capturing (the writer thread is started when capturing gets enabled first time)
+        void SetConfiguration( const XStepCaptureConfiguration& config );
+        XStepCaptureConfiguration GetConfiguration( );
+        // Get number of saved/dropped/failed cases
+        XStepCaptureInfo GetInfo( );
+        // Check if capturing is enabled and get latency threshold of steps
+        bool IsEnabled( float* latencyThreshold );
+        // Queue captured case to save
+        void Post( const shared_ptr<XStepCaptureCase>& captureCase );
+
+    private:
+        static void WriterThreadHandler( void* param );
+        string SlotFileName( uint32_t slot ) const;
+        uint32_t FindNextSlot( ) const;
+
+    private:
+        static const size_t MAX_PENDING_CASES = 2;
+
+        XMutex                              Sync;
+        XStepCaptureConfiguration           Configuration;
+        XStepCaptureInfo                    Info;
+        uint32_t                            NextSlot;
+        deque<shared_ptr<XStepCaptureCase>> Pending;
+        XManualResetEvent                   NewCaseEvent;
+        volatile bool                       NeedToExit;
+        XThread                             WriterThread;
+    };
+
     // Internal class to group some data/functions related to video source
     class VideoSourceData : public IVideoSourcePluginListener, Uncopyable
     {
@@ -66,15 +342,19 @@ namespace Private
                          const shared_ptr<XVideoSourcePlugin>& videoSource,
                          XAutomationServerData* server ) :
             VideoSourceId( videoSourceId ), VideoSourceDescriptor( pluginDescriptor), VideoSource( videoSource ),
-            Server( server ), Listeners( ), ListenerSync( ),
+            Server( server ), Listeners( ), Mailboxes( ), RetiredMailboxes( ), MailboxFramePool( ), ListenerSync( ),
             LastImage( ), LastError( ), ProcessingGraph( ), ProcessingGraphBuffer( ),
             VideoProcessingSync( ), NewFrameIsAvailableEvent( ), ProcessingThreadIsFreeEvent( ),
             NeedToExitProcessingThread( false ), VideoProcessingThread( ), FrameInfo( ),
             NeedToRunPerformanceMonitor( false ), IsPerformanceMonitroRunning( false ),
             StepFailedInitialization( -1 ), StepFailedMessage( ),
             DropVideoFramesWhenBusy( false ), FramesDropped( 0 ), FramesBlocked( 0 ),
+            LowPriority( false ), FramesThrottled( 0 ), FramesDecimationCounter( 0 ), ResolutionReduction( 0 ), FrameMemoryUsed( 0 ),
+            FrameTimestamps( ), LatencyHistory( ), LatencyHistoryIndex( 0 ),
+            TotalLatencyHistogram( ), ProcessingLatencyHistogram( ), StepInputImage( ),
             UpdatedVideoProcessingConfig( )
         {
+            VideoProcessingThread.SetName( MakeThreadName( "cvs-vproc-", videoSourceId ) );
         }
 
     public:
@@ -86,29 +366,41 @@ namespace Private
             return shared_ptr<VideoSourceData>( new (nothrow) VideoSourceData( videoSourceId, pluginDescriptor, videoSource, server ) );
         }
 
-        ~VideoSourceData( )
-        {
-            NeedToExitProcessingThread = true;
-            NewFrameIsAvailableEvent.Signal( );
-            VideoProcessingThread.Join( );
-        }
+        ~VideoSourceData( );
 
         // Handler of video processing thread - each video source has a separate one, so all
         // video processing is done separately without blocking video source's background thread.
         static void VideoProcessingThreadHandler( void* param );
 
-        // New video frame notification
+        // New video frame notification (with and without capture time)
         virtual void OnNewImage( const shared_ptr<const XImage>& image );
+        virtual void OnNewImage( const shared_ptr<const XImage>& image, int64_t captureTime );
         // Video source error notification
         virtual void OnError( const string& errorMessage );
 
     public:
         void ReportError( const string& errorMessage );
+        // Add listener to notify synchronously (queue length is 0) or through a mailbox
+        bool AddListener( IAutomationVideoSourceListener* listener, uint32_t queueLength );
+        // Remove listener - returns its mailbox if the caller needs to wait for its dispatcher to finish
+        shared_ptr<ListenerMailbox> RemoveListener( IAutomationVideoSourceListener* listener );
+        // Remove all listeners without waiting for dispatchers of their mailboxes
+        void ClearListeners( MailboxList* mailboxesToWait );
+        // Notify just added listener with the last image/error
+        void NotifyListenerWithRecent( IAutomationVideoSourceListener* listener );
 
     private:
         void PreparePlugins( );
         void NotifyNewFrame( );
+        shared_ptr<const XImage> CopyLastImageForMailboxes( );
+        bool IsMailboxFramePoolBusy( ) const;
+        bool CopyNewImage( const shared_ptr<const XImage>& image );
+        void UpdateFrameMemoryUsage( bool releaseUnusedFrames );
+        void UpdateResolutionReduction( );
+        void UpdateLatencyStatistics( );
         void PerformNewFrameProcessing( );
+        void CaptureProcessingStep( const XVideoSourceProcessingStep& step, int32_t stepIndex, XErrorCode errorCode,
+                                    const string& errorMessage, float timeTaken, float latencyThreshold );
         XErrorCode DoImageProcessingFilterPlugin( const shared_ptr<XImageProcessingFilterPlugin>& plugin, size_t& currrentGraphBufferIndex );
         XErrorCode DoVideoProcessingPlugin( const shared_ptr<XVideoProcessingPlugin>& plugin );
         XErrorCode DoDetectionPlugin( const shared_ptr<XDetectionPlugin>& plugin );
@@ -127,6 +419,7 @@ namespace Private
         static XErrorCode ScriptingEnginePluginCallback_GetImage( void* userParam, ximage** image );
         static XErrorCode ScriptingEnginePluginCallback_SetImage( void* userParam, ximage* image );
         static XErrorCode ScriptingEnginePluginCallback_GetVideoSource( void* userParam, PluginDescriptor** pDescriptor, void** pPlugin );
+        static XErrorCode ScriptingEnginePluginCallback_GetFrameTimestamps( void* userParam, xframetimestamps* timestamps );
 
     public:
         uint32_t                            VideoSourceId;
@@ -134,6 +427,9 @@ namespace Private
         shared_ptr<XVideoSourcePlugin>      VideoSource;
         XAutomationServerData*              Server;
         ListenersList                       Listeners;                      // list of listeners to notify (new frames, error, etc.)
+        MailboxList                         Mailboxes;                      // mailboxes of listeners notified asynchronously
+        MailboxList                         RetiredMailboxes;               // removed mailboxes, which dispatchers may still run
+        vector<shared_ptr<XImage>>          MailboxFramePool;               // copies of frames given to mailboxes (guarded by VideoProcessingSync)
         XMutex                              ListenerSync;                   // mutex to protect listener list
         shared_ptr<XImage>                  LastImage;                      // image given to client -last image arrived from video source
                                                                             // (if processing graph is empty) - or result video processing -
@@ -166,6 +462,19 @@ namespace Private
         uint32_t                            FramesDropped;
         uint32_t                            FramesBlocked;
 
+        bool                                LowPriority;                   // decimate frames first when frame memory budget is exceeded
+        uint32_t                            FramesThrottled;               // frames dropped/reduced because of frame memory budget
+        uint32_t                            FramesDecimationCounter;
+        int                                 ResolutionReduction;           // number of times to halve resolution of new frames (guarded by VideoProcessingSync)
+        uint64_t                            FrameMemoryUsed;               // memory taken by frames of the video source (guarded by VideoProcessingSync)
+
+        XVideoFrameTimestamps               FrameTimestamps;               // time stamps of the frame being processed (guarded by VideoProcessingSync)
+        vector<XVideoFrameTimestamps>       LatencyHistory;                // time stamps of recently processed frames (guarded by VideoFrameInfoSync)
+        int                                 LatencyHistoryIndex;
+        LatencyHistogram                    TotalLatencyHistogram;         // capture to processing end (guarded by VideoFrameInfoSync)
+        LatencyHistogram                    ProcessingLatencyHistogram;    // processing graph time (guarded by VideoFrameInfoSync)
+        shared_ptr<XImage>                  StepInputImage;                // copy of current step's input while capturing steps (guarded by VideoProcessingSync)
+
         map<int32_t, map<string, XVariant>> UpdatedVideoProcessingConfig;
     };
 
@@ -177,6 +486,7 @@ namespace Private
             ThreadId( threadId ), MsecInterval( msecInterval ), ScriptingEngine( scriptingEngine ), Server( server ),
             ScriptProcessingThread( ), NeedToExit( )
         {
+            ScriptProcessingThread.SetName( MakeThreadName( "cvs-script-", threadId ) );
         }
 
     public:
@@ -206,6 +516,7 @@ namespace Private
         static XErrorCode ScriptingEnginePluginCallback_GetImage( void* userParam, ximage** image );
         static XErrorCode ScriptingEnginePluginCallback_SetImage( void* userParam, ximage* image );
         static XErrorCode ScriptingEnginePluginCallback_GetVideoSource( void* userParam, PluginDescriptor** pDescriptor, void** pPlugin );
+        static XErrorCode ScriptingEnginePluginCallback_GetFrameTimestamps( void* userParam, xframetimestamps* timestamps );
 
     public:
         uint32_t                           ThreadId;
@@ -235,6 +546,14 @@ namespace Private
         XManualResetEvent   ExitEvent;
         XThread             ServerThread;
 
+        // Budget of memory taken by video frames and its current usage (declared before video sources,
+        // so is still valid while they are destroyed)
+        XMutex              FrameMemorySync;
+        XFrameMemoryInfo    FrameMemory;
+
+        // Writer of failed/slow processing steps (declared before video sources, which post to it)
+        StepCaptureWriter   StepCapture;
+
         VsdMap              AddedVideoSources;
         VsdMap              RunningVideoSources;
         VsdMap              FinalizingVideoSources;
@@ -255,6 +574,7 @@ namespace Private
             PluginsEngine( pluginsEngine ), DeviceCounter( 0 ),
             HostName( "Automation Server" ), HostVersion( { 1, 0, 1 } ),
             ServerSync( ), ExitEvent( ), ServerThread( ),
+            FrameMemorySync( ), FrameMemory( ), StepCapture( ),
             AddedVideoSources( ), RunningVideoSources( ), FinalizingVideoSources( ),
             AddedThreads( ), RunningThreads( ), FinalizingThreads( ),
             VariablesSync( ), HostVariables( ), HostImageVariables( ), VariablesListener( nullptr )
@@ -265,8 +585,8 @@ namespace Private
         // Server's background thread - used to monitor finalization queue
         static void ServerWorkerThreadHandler( void* param );
 
-        // Signal video source to stop
-        void FinalizeVideoSource( int id );
+        // Signal video source to stop (mailboxes of its listeners are provided to wait for, if requested)
+        void FinalizeVideoSource( int id, MailboxList* mailboxesToWait = nullptr );
         // Signal all video sources to stop and move them to finalization queue
         void FinalizeAllRunningObjects( );
         // Wait till all video sources finish
@@ -288,6 +608,15 @@ namespace Private
         // Clear variables listener, so no more change notifications are sent
         void ClearVariablesListener( );
 
+        // Update total memory taken by video frames, when usage of one of the video sources changes
+        void UpdateFrameMemoryUsage( uint64_t oldUsage, uint64_t newUsage );
+        // Check if frame memory budget is exceeded and frames need to be throttled according to the policy
+        bool IsFrameMemoryThrottling( XFrameMemoryPolicy* policy );
+        // Check if frame memory usage can grow by the specified amount without exceeding low watermark of the budget
+        bool IsFrameMemoryAvailable( uint64_t extraUsage );
+        // Account frame dropped/reduced because of frame memory budget
+        void CountThrottledFrame( );
+
     public:
         // Implementation of common scripting engine callbacks
         xstring ScriptingEnginePluginCallback_GetHostName( );
@@ -336,6 +665,7 @@ XErrorCode XAutomationServer::Start( )
     else
     {
         mData->ExitEvent.Reset( );
+        mData->ServerThread.SetName( "cvs-server" );
 
         if ( mData->ServerThread.Create( XAutomationServerData::ServerWorkerThreadHandler, mData.get( ) ) )
         {
@@ -591,32 +921,141 @@ void XAutomationServer::StartAllVideoSources( )
 // Move the specified video source into finalization queue
 bool XAutomationServer::FinalizeVideoSource( uint32_t videoSourceId )
 {
-    XScopedLock         lock( &mData->ServerSync );
-    bool                ret           = false;
-    VsdMap::iterator    itVideoSource = mData->RunningVideoSources.find( videoSourceId );
+    bool                        ret = false;
+    MailboxList                 mailboxesToWait;
+    shared_ptr<VideoSourceData> removedVideoSource;
 
-    if ( itVideoSource != mData->RunningVideoSources.end( ) )
     {
-        mData->FinalizeVideoSource( videoSourceId );
-        ret = true;
-    }
-    else
-    {
-        itVideoSource = mData->AddedVideoSources.find( videoSourceId );
+        XScopedLock         lock( &mData->ServerSync );
+        VsdMap::iterator    itVideoSource = mData->RunningVideoSources.find( videoSourceId );
 
-        if ( itVideoSource != mData->AddedVideoSources.end( ) )
+        if ( itVideoSource != mData->RunningVideoSources.end( ) )
         {
-            // remove something which has never run
-            mData->AddedVideoSources.erase( itVideoSource );
+            mData->FinalizeVideoSource( videoSourceId, &mailboxesToWait );
             ret = true;
         }
+        else
+        {
+            itVideoSource = mData->AddedVideoSources.find( videoSourceId );
+
+            if ( itVideoSource != mData->AddedVideoSources.end( ) )
+            {
+                // remove something which has never run (released below, since its mailboxes wait for dispatchers)
+                removedVideoSource = itVideoSource->second;
+                mData->AddedVideoSources.erase( itVideoSource );
+                ret = true;
+            }
+        }
+    }
+
+    // wait for dispatchers of the listeners' mailboxes (not holding server's lock, in case a listener
+    // is calling the server right now), so listeners are not called after this method returns
+    for ( MailboxList::iterator it = mailboxesToWait.begin( ); it != mailboxesToWait.end( ); ++it )
+    {
+        (*it)->WaitForStop( );
+    }
+
+    return ret;
+}
+
+// Set CPU affinity mask and priority of the specified video source's processing thread
+bool XAutomationServer::SetVideoProcessingThreadScheduling( uint32_t videoSourceId, uint64_t cpuMask, XThreadPriority priority )
+{
+    XScopedLock                 lock( &mData->ServerSync );
+    bool                        ret = false;
+    shared_ptr<VideoSourceData> vsData;
+    VsdMap::iterator            itAddedVideoSource   = mData->AddedVideoSources.find( videoSourceId );
+    VsdMap::iterator            itRunningVideoSource = mData->RunningVideoSources.find( videoSourceId );
+
+    if ( itAddedVideoSource != mData->AddedVideoSources.end( ) )
+    {
+        vsData = itAddedVideoSource->second;
+    }
+    else if ( itRunningVideoSource != mData->RunningVideoSources.end( ) )
+    {
+        vsData = itRunningVideoSource->second;
+    }
+
+    if ( vsData )
+    {
+        XThread& thread = vsData->VideoProcessingThread;
+
+        ret  = thread.SetAffinity( cpuMask );
+        ret &= thread.SetPriority( priority );
+    }
+
+    return ret;
+}
+
+// Mark the specified video source as low priority one, so its frames are decimated first when frame memory budget is exceeded
+bool XAutomationServer::SetVideoSourceLowPriority( uint32_t videoSourceId, bool lowPriority )
+{
+    XScopedLock                 lock( &mData->ServerSync );
+    bool                        ret = false;
+    shared_ptr<VideoSourceData> vsData;
+    VsdMap::iterator            itAddedVideoSource   = mData->AddedVideoSources.find( videoSourceId );
+    VsdMap::iterator            itRunningVideoSource = mData->RunningVideoSources.find( videoSourceId );
+
+    if ( itAddedVideoSource != mData->AddedVideoSources.end( ) )
+    {
+        vsData = itAddedVideoSource->second;
+    }
+    else if ( itRunningVideoSource != mData->RunningVideoSources.end( ) )
+    {
+        vsData = itRunningVideoSource->second;
+    }
+
+    if ( vsData )
+    {
+        XScopedLock infoLock( &vsData->VideoFrameInfoSync );
+
+        vsData->LowPriority = lowPriority;
+        ret = true;
     }
 
     return ret;
 }
 
+// Set budget of memory taken by video frames of all video sources and the policy to apply while it is exceeded
+void XAutomationServer::SetFrameMemoryBudget( uint64_t budget, XFrameMemoryPolicy policy )
+{
+    XScopedLock lock( &mData->FrameMemorySync );
+
+    mData->FrameMemory.Budget = budget;
+    mData->FrameMemory.Policy = policy;
+
+    // re-evaluate throttling with the new budget
+    mData->UpdateFrameMemoryUsage( 0, 0 );
+}
+
+// Get memory taken by video frames of all video sources and number of frames throttled to fit into the budget
+XFrameMemoryInfo XAutomationServer::GetFrameMemoryInfo( )
+{
+    XScopedLock lock( &mData->FrameMemorySync );
+
+    return mData->FrameMemory;
+}
+
+// Set configuration of capturing video processing steps, which fail or take longer than the latency threshold
+void XAutomationServer::SetStepCaptureConfiguration( const XStepCaptureConfiguration& config )
+{
+    mData->StepCapture.SetConfiguration( config );
+}
+
+// Get configuration of capturing video processing steps
+XStepCaptureConfiguration XAutomationServer::GetStepCaptureConfiguration( )
+{
+    return mData->StepCapture.GetConfiguration( );
+}
+
+// Get number of captured cases saved/dropped/failed to save
+XStepCaptureInfo XAutomationServer::GetStepCaptureInfo( )
+{
+    return mData->StepCapture.GetInfo( );
+}
+
 // Add listener for the specified video source
-bool XAutomationServer::AddVideoSourceListener( uint32_t videoSourceId, IAutomationVideoSourceListener* listener, bool notifyWithRecent )
+bool XAutomationServer::AddVideoSourceListener( uint32_t videoSourceId, IAutomationVideoSourceListener* listener, bool notifyWithRecent, uint32_t queueLength )
 {
     bool    ret = false;
 
@@ -628,37 +1067,18 @@ bool XAutomationServer::AddVideoSourceListener( uint32_t videoSourceId, IAutomat
 
         if ( itAddVideoSource != mData->AddedVideoSources.end( ) )
         {
-            itAddVideoSource->second->Listeners.push_back( listener );
-            ret = true;
+            ret = itAddVideoSource->second->AddListener( listener, queueLength );
         }
         else if ( itRunningVideoSource != mData->RunningVideoSources.end( ) )
         {
             shared_ptr<VideoSourceData> vsData = itRunningVideoSource->second;
 
-            {
-                XScopedLock listenerLock( &vsData->ListenerSync );
-                vsData->Listeners.push_back( listener );
-            }
+            ret = vsData->AddListener( listener, queueLength );
 
-            if ( notifyWithRecent )
+            if ( ( ret ) && ( notifyWithRecent ) )
             {
-                if ( vsData->VideoProcessingSync.TryLock( ) )
-                {
-                    // notify of last image and/or error if there are any
-                    if ( vsData->LastImage )
-                    {
-                        listener->OnNewVideoFrame( videoSourceId, vsData->LastImage );
-                    }
-                    if ( !vsData->LastError.empty( ) )
-                    {
-                        listener->OnErrorMessage( videoSourceId, vsData->LastError );
-                    }
-
-                    vsData->VideoProcessingSync.Unlock( );
-                }
+                vsData->NotifyListenerWithRecent( listener );
             }
-
-            ret = true;
         }
     }
 
@@ -668,21 +1088,63 @@ bool XAutomationServer::AddVideoSourceListener( uint32_t videoSourceId, IAutomat
 // Remove listener from the specified video source
 void XAutomationServer::RemoveVideoSourceListener( uint32_t videoSourceId, IAutomationVideoSourceListener* listener )
 {
-    XScopedLock         lock( &mData->ServerSync );
-    VsdMap::iterator    itAddVideoSource     = mData->AddedVideoSources.find( videoSourceId );
-    VsdMap::iterator    itRunningVideoSource = mData->RunningVideoSources.find( videoSourceId );
+    shared_ptr<ListenerMailbox> mailbox;
+
+    {
+        XScopedLock         lock( &mData->ServerSync );
+        VsdMap::iterator    itAddVideoSource     = mData->AddedVideoSources.find( videoSourceId );
+        VsdMap::iterator    itRunningVideoSource = mData->RunningVideoSources.find( videoSourceId );
+
+        if ( itAddVideoSource != mData->AddedVideoSources.end( ) )
+        {
+            mailbox = itAddVideoSource->second->RemoveListener( listener );
+        }
+        else if ( itRunningVideoSource != mData->RunningVideoSources.end( ) )
+        {
+            mailbox = itRunningVideoSource->second->RemoveListener( listener );
+        }
+    }
+
+    // wait for the mailbox's dispatcher to finish (not holding server's lock, in case the listener
+    // is calling the server right now), so the listener is not called after this method returns
+    mailbox.reset( );
+}
+
+// Get number of frames delivered to/dropped for the listener, which is notified asynchronously
+bool XAutomationServer::GetVideoSourceListenerStatistics( uint32_t videoSourceId, IAutomationVideoSourceListener* listener,
+                                                          uint32_t* framesDelivered, uint32_t* framesDropped )
+{
+    XScopedLock                 lock( &mData->ServerSync );
+    bool                        ret = false;
+    shared_ptr<VideoSourceData> vsData;
+    VsdMap::iterator            itAddVideoSource     = mData->AddedVideoSources.find( videoSourceId );
+    VsdMap::iterator            itRunningVideoSource = mData->RunningVideoSources.find( videoSourceId );
 
     if ( itAddVideoSource != mData->AddedVideoSources.end( ) )
     {
-        itAddVideoSource->second->Listeners.remove( listener );
+        vsData = itAddVideoSource->second;
     }
     else if ( itRunningVideoSource != mData->RunningVideoSources.end( ) )
     {
-        shared_ptr<VideoSourceData> vsData = itRunningVideoSource->second;
+        vsData = itRunningVideoSource->second;
+    }
 
+    if ( vsData )
+    {
         XScopedLock listenerLock( &vsData->ListenerSync );
-        vsData->Listeners.remove( listener );
+
+        for ( MailboxList::iterator it = vsData->Mailboxes.begin( ); it != vsData->Mailboxes.end( ); ++it )
+        {
+            if ( (*it)->Listener == listener )
+            {
+                (*it)->GetStatistics( framesDelivered, framesDropped );
+                ret = true;
+                break;
+            }
+        }
     }
+
+    return ret;
 }
 
 // Add a thread, which will run the specified script at the specified time intervals (milliseconds)
@@ -734,6 +1196,35 @@ void XAutomationServer::StartAllThreads( )
     }
 }
 
+// Set CPU affinity mask and priority of the specified scripting thread
+bool XAutomationServer::SetScriptingThreadScheduling( uint32_t threadId, uint64_t cpuMask, XThreadPriority priority )
+{
+    XScopedLock                     lock( &mData->ServerSync );
+    bool                            ret = false;
+    shared_ptr<ScriptingThreadData> threadData;
+    ThreadMap::iterator             itAddedThread   = mData->AddedThreads.find( threadId );
+    ThreadMap::iterator             itRunningThread = mData->RunningThreads.find( threadId );
+
+    if ( itAddedThread != mData->AddedThreads.end( ) )
+    {
+        threadData = itAddedThread->second;
+    }
+    else if ( itRunningThread != mData->RunningThreads.end( ) )
+    {
+        threadData = itRunningThread->second;
+    }
+
+    if ( threadData )
+    {
+        XThread& thread = threadData->ScriptProcessingThread;
+
+        ret  = thread.SetAffinity( cpuMask );
+        ret &= thread.SetPriority( priority );
+    }
+
+    return ret;
+}
+
 // Finalize the specified scripting thread
 bool XAutomationServer::FinalizeThread( uint32_t threadId )
 {
@@ -805,54 +1296,226 @@ void XAutomationServer::GetVideoSourceCount( uint32_t* notStarted, uint32_t* run
     }
 }
 
-// Server's background thread - used to monitor finalization queue
-void XAutomationServerData::ServerWorkerThreadHandler( void* param )
+// Get metrics of running video sources and the server in Prometheus text exposition format
+string XAutomationServer::GetMetrics( )
 {
-    XAutomationServerData* self = static_cast<XAutomationServerData*>( param );
-
-    while ( !self->ExitEvent.Wait( 200 ) )
-    {
-        XScopedLock lock( &self->ServerSync );
-        self->CleanAlreadyFinalized( );
-    }
+    vector<shared_ptr<VideoSourceData>> videoSources;
+    vector<VideoSourceMetrics>          metrics;
+    uint32_t                            notStarted, running, finalizing;
+    XFrameMemoryInfo                    memoryInfo = GetFrameMemoryInfo( );
+    string                              out;
+    char                                buffer[32];
 
+    // take only references to video sources while server is locked, all other locks are taken one by one
     {
-        XScopedLock lock( &self->ServerSync );
+        XScopedLock lock( &mData->ServerSync );
 
-        self->AddedVideoSources.clear( );
-        self->AddedThreads.clear( );
+        notStarted = static_cast<uint32_t>( mData->AddedVideoSources.size( ) );
+        running    = static_cast<uint32_t>( mData->RunningVideoSources.size( ) );
+        finalizing = static_cast<uint32_t>( mData->FinalizingVideoSources.size( ) );
 
-        self->FinalizeAllRunningObjects( );
-        self->WaitAllFinalizingObjects( );
+        for ( VsdMap::const_iterator it = mData->RunningVideoSources.begin( ); it != mData->RunningVideoSources.end( ); ++it )
+        {
+            videoSources.push_back( it->second );
+        }
     }
-}
 
-// Signal video source to stop
-void XAutomationServerData::FinalizeVideoSource( int id )
-{
-    VsdMap::iterator vsDataIt = RunningVideoSources.find( id );
+    metrics.resize( videoSources.size( ) );
 
-    if ( vsDataIt != RunningVideoSources.end( ) )
+    for ( size_t i = 0; i < videoSources.size( ); i++ )
     {
-        shared_ptr<VideoSourceData> vsData = vsDataIt->second;
+        const shared_ptr<VideoSourceData>& vsData = videoSources[i];
+        VideoSourceMetrics&                vsm    = metrics[i];
+        MailboxList                        mailboxes;
 
-        // signal video processing thread to finish
-        vsData->NeedToExitProcessingThread = true;
-        vsData->NewFrameIsAvailableEvent.Signal( );
+        sprintf( buffer, "%u", vsData->VideoSourceId );
+        vsm.Labels = string( "source=\"" ) + buffer + "\",plugin=\"" +
+                     ( ( vsData->VideoSourceDescriptor ) ? EscapeMetricLabel( vsData->VideoSourceDescriptor->ShortName( ) ) : string( ) ) + "\"";
 
-        // don't need any notifications from the video source
         {
-            XScopedLock lock( &vsData->ListenerSync );
-            vsData->Listeners.clear( );
-        }
+            XScopedLock infoLock( &vsData->VideoFrameInfoSync );
 
-        vsData->VideoSource->SetListener( nullptr );
-        vsData->VideoSource->SignalToStop( );
+            vsm.FrameInfo         = vsData->FrameInfo;
+            vsm.TotalLatency      = vsData->TotalLatencyHistogram;
+            vsm.ProcessingLatency = vsData->ProcessingLatencyHistogram;
 
-        FinalizingVideoSources.insert( VsdMap::value_type( id, vsData ) );
-        RunningVideoSources.erase( id );
-    }
-}
+            if ( vsData->IsPerformanceMonitroRunning )
+            {
+                vsm.StepAverageTime = vsData->ProcessingStepAverageTime;
+            }
+        }
+
+        // processing graph does not change while video source is running
+        for ( XVideoSourceProcessingGraph::ConstIterator stepIt = vsData->ProcessingGraph.begin( );
+              ( stepIt != vsData->ProcessingGraph.end( ) ) && ( vsm.StepNames.size( ) < vsm.StepAverageTime.size( ) ); ++stepIt )
+        {
+            vsm.StepNames.push_back( stepIt->Name( ) );
+        }
+
+        {
+            XScopedLock listenerLock( &vsData->ListenerSync );
+            mailboxes = vsData->Mailboxes;
+        }
+
+        for ( MailboxList::const_iterator it = mailboxes.begin( ); it != mailboxes.end( ); ++it )
+        {
+            uint32_t delivered = 0, dropped = 0, queued = 0;
+
+            (*it)->GetStatistics( &delivered, &dropped, &queued );
+
+            vsm.ListenersDelivered += delivered;
+            vsm.ListenersDropped   += dropped;
+            vsm.ListenersQueued    += queued;
+        }
+    }
+
+    // nothing is locked any more - print everything
+    out.reserve( 1024 + metrics.size( ) * 4096 );
+
+    AppendMetricFamily( out, "cvs_video_sources", "gauge", "Number of video sources of the automation server by state." );
+    AppendMetricSample( out, "cvs_video_sources", "state=\"not_started\"", notStarted );
+    AppendMetricSample( out, "cvs_video_sources", "state=\"running\"", running );
+    AppendMetricSample( out, "cvs_video_sources", "state=\"finalizing\"", finalizing );
+
+    AppendMetricFamily( out, "cvs_frame_memory_used_bytes", "gauge", "Memory taken by video frames of all video sources." );
+    AppendMetricSample( out, "cvs_frame_memory_used_bytes", string( ), static_cast<double>( memoryInfo.Used ) );
+    AppendMetricFamily( out, "cvs_frame_memory_peak_bytes", "gauge", "Peak memory taken by video frames of all video sources." );
+    AppendMetricSample( out, "cvs_frame_memory_peak_bytes", string( ), static_cast<double>( memoryInfo.PeakUsed ) );
+    AppendMetricFamily( out, "cvs_frame_memory_budget_bytes", "gauge", "Budget of memory taken by video frames (0 - no limit)." );
+    AppendMetricSample( out, "cvs_frame_memory_budget_bytes", string( ), static_cast<double>( memoryInfo.Budget ) );
+    AppendMetricFamily( out, "cvs_frame_memory_throttling", "gauge", "Frame memory budget is exceeded and video frames are throttled (1) or not (0)." );
+    AppendMetricSample( out, "cvs_frame_memory_throttling", string( ), ( memoryInfo.IsThrottling ) ? 1 : 0 );
+    AppendMetricFamily( out, "cvs_frame_memory_throttling_events_total", "counter", "Number of times frame memory budget was exceeded." );
+    AppendMetricSample( out, "cvs_frame_memory_throttling_events_total", string( ), memoryInfo.ThrottlingEvents );
+
+    AppendMetricFamily( out, "cvs_frames_received_total", "counter", "Video frames received from video source and given to processing." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_frames_received_total", it->Labels, it->FrameInfo.FramesReceived );
+    }
+    AppendMetricFamily( out, "cvs_frames_dropped_total", "counter", "Video frames dropped since video processing was still busy." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_frames_dropped_total", it->Labels, it->FrameInfo.FramesDropped );
+    }
+    AppendMetricFamily( out, "cvs_frames_blocked_total", "counter", "Video frames, which had to wait for video processing to finish with previous frame." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_frames_blocked_total", it->Labels, it->FrameInfo.FramesBlocked );
+    }
+    AppendMetricFamily( out, "cvs_frames_throttled_total", "counter", "Video frames dropped or reduced to fit into frame memory budget." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_frames_throttled_total", it->Labels, it->FrameInfo.FramesThrottled );
+    }
+    AppendMetricFamily( out, "cvs_errors_total", "counter", "Errors reported by video source and its processing steps." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_errors_total", it->Labels, it->FrameInfo.ErrorsReported );
+    }
+    AppendMetricFamily( out, "cvs_video_source_frame_memory_bytes", "gauge", "Memory taken by video frames of video source." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_video_source_frame_memory_bytes", it->Labels, static_cast<double>( it->FrameInfo.FrameMemoryUsed ) );
+    }
+
+    AppendMetricFamily( out, "cvs_frame_latency_seconds", "histogram", "Latency from video frame capture to end of its processing." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricHistogram( out, "cvs_frame_latency_seconds", it->Labels, it->TotalLatency );
+    }
+    AppendMetricFamily( out, "cvs_frame_processing_seconds", "histogram", "Time taken by video processing graph." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricHistogram( out, "cvs_frame_processing_seconds", it->Labels, it->ProcessingLatency );
+    }
+    AppendMetricFamily( out, "cvs_frame_average_latency_seconds", "gauge", "Latency of recent video frames by stage: capture to arrival (source), "
+                                                                           "arrival to processing start (queue), processing and total." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_frame_average_latency_seconds", it->Labels + ",stage=\"source\"", it->FrameInfo.AverageSourceLatency / 1000.0, false );
+        AppendMetricSample( out, "cvs_frame_average_latency_seconds", it->Labels + ",stage=\"queue\"", it->FrameInfo.AverageQueueLatency / 1000.0, false );
+        AppendMetricSample( out, "cvs_frame_average_latency_seconds", it->Labels + ",stage=\"processing\"", it->FrameInfo.AverageProcessingLatency / 1000.0, false );
+        AppendMetricSample( out, "cvs_frame_average_latency_seconds", it->Labels + ",stage=\"total\"", it->FrameInfo.AverageTotalLatency / 1000.0, false );
+    }
+    AppendMetricFamily( out, "cvs_processing_step_average_seconds", "gauge", "Time taken by video processing steps averaged over recent frames "
+                                                                             "(provided while performance monitor is enabled)." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        for ( size_t i = 0; i < it->StepNames.size( ); i++ )
+        {
+            sprintf( buffer, "%u", static_cast<uint32_t>( i ) );
+
+            AppendMetricSample( out, "cvs_processing_step_average_seconds",
+                                it->Labels + ",step=\"" + buffer + "\",name=\"" + EscapeMetricLabel( it->StepNames[i] ) + "\"",
+                                it->StepAverageTime[i] / 1000.0, false );
+        }
+    }
+
+    AppendMetricFamily( out, "cvs_listener_queue_depth", "gauge", "Video frames queued for asynchronously notified listeners." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_listener_queue_depth", it->Labels, it->ListenersQueued );
+    }
+    AppendMetricFamily( out, "cvs_listener_frames_delivered_total", "counter", "Video frames delivered to asynchronously notified listeners." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_listener_frames_delivered_total", it->Labels, it->ListenersDelivered );
+    }
+    AppendMetricFamily( out, "cvs_listener_frames_dropped_total", "counter", "Video frames dropped since asynchronously notified listeners did not keep up." );
+    for ( vector<VideoSourceMetrics>::const_iterator it = metrics.begin( ); it != metrics.end( ); ++it )
+    {
+        AppendMetricSample( out, "cvs_listener_frames_dropped_total", it->Labels, it->ListenersDropped );
+    }
+
+    return out;
+}
+
+// Server's background thread - used to monitor finalization queue
+void XAutomationServerData::ServerWorkerThreadHandler( void* param )
+{
+    XAutomationServerData* self = static_cast<XAutomationServerData*>( param );
+
+    while ( !self->ExitEvent.Wait( 200 ) )
+    {
+        XScopedLock lock( &self->ServerSync );
+        self->CleanAlreadyFinalized( );
+    }
+
+    {
+        XScopedLock lock( &self->ServerSync );
+
+        self->AddedVideoSources.clear( );
+        self->AddedThreads.clear( );
+
+        self->FinalizeAllRunningObjects( );
+        self->WaitAllFinalizingObjects( );
+    }
+}
+
+// Signal video source to stop
+void XAutomationServerData::FinalizeVideoSource( int id, MailboxList* mailboxesToWait )
+{
+    VsdMap::iterator vsDataIt = RunningVideoSources.find( id );
+
+    if ( vsDataIt != RunningVideoSources.end( ) )
+    {
+        shared_ptr<VideoSourceData> vsData = vsDataIt->second;
+
+        // signal video processing thread to finish
+        vsData->NeedToExitProcessingThread = true;
+        vsData->NewFrameIsAvailableEvent.Signal( );
+
+        // don't need any notifications from the video source
+        vsData->ClearListeners( mailboxesToWait );
+
+        vsData->VideoSource->SetListener( nullptr );
+        vsData->VideoSource->SignalToStop( );
+
+        FinalizingVideoSources.insert( VsdMap::value_type( id, vsData ) );
+        RunningVideoSources.erase( id );
+    }
+}
 
 // Signal all video sources to stop and move them to finalization queue
 void XAutomationServerData::FinalizeAllRunningObjects( )
@@ -1057,6 +1720,64 @@ void XAutomationServerData::ClearVariablesListener( )
     VariablesListener = nullptr;
 }
 
+// Update total memory taken by video frames, when usage of one of the video sources changes
+void XAutomationServerData::UpdateFrameMemoryUsage( uint64_t oldUsage, uint64_t newUsage )
+{
+    XScopedLock lock( &FrameMemorySync );
+
+    FrameMemory.Used = FrameMemory.Used - oldUsage + newUsage;
+
+    if ( FrameMemory.Used > FrameMemory.PeakUsed )
+    {
+        FrameMemory.PeakUsed = FrameMemory.Used;
+    }
+
+    if ( FrameMemory.Budget == 0 )
+    {
+        FrameMemory.IsThrottling = false;
+    }
+    else if ( FrameMemory.Used > FrameMemory.Budget )
+    {
+        if ( !FrameMemory.IsThrottling )
+        {
+            FrameMemory.IsThrottling = true;
+            FrameMemory.ThrottlingEvents++;
+        }
+    }
+    else if ( FrameMemory.Used <= FrameMemory.Budget / 100 * FRAME_MEMORY_LOW_WATERMARK )
+    {
+        // stop throttling only once there is some room, so it does not toggle on every frame
+        FrameMemory.IsThrottling = false;
+    }
+}
+
+// Check if frame memory budget is exceeded and frames need to be throttled according to the policy
+bool XAutomationServerData::IsFrameMemoryThrottling( XFrameMemoryPolicy* policy )
+{
+    XScopedLock lock( &FrameMemorySync );
+
+    *policy = FrameMemory.Policy;
+
+    return FrameMemory.IsThrottling;
+}
+
+// Check if frame memory usage can grow by the specified amount without exceeding low watermark of the budget
+bool XAutomationServerData::IsFrameMemoryAvailable( uint64_t extraUsage )
+{
+    XScopedLock lock( &FrameMemorySync );
+
+    return ( ( FrameMemory.Budget == 0 ) ||
+             ( FrameMemory.Used + extraUsage <= FrameMemory.Budget / 100 * FRAME_MEMORY_LOW_WATERMARK ) );
+}
+
+// Account frame dropped/reduced because of frame memory budget
+void XAutomationServerData::CountThrottledFrame( )
+{
+    XScopedLock lock( &FrameMemorySync );
+
+    FrameMemory.FramesThrottled++;
+}
+
 // Prepares plug-ins of the video processing graph, so those are ready to be used for new frame processing
 void VideoSourceData::PreparePlugins( )
 {
@@ -1096,6 +1817,7 @@ void VideoSourceData::PreparePlugins( )
                         callbacks.GetImageVariable     = ScriptingEnginePluginCallback_GetImageVariable;
                         callbacks.SetImageVariable     = ScriptingEnginePluginCallback_SetImageVariable;
                         callbacks.GetVideoSource       = ScriptingEnginePluginCallback_GetVideoSource;
+                        callbacks.GetFrameTimestamps   = ScriptingEnginePluginCallback_GetFrameTimestamps;
 
                         // set callback first to allow script interface with the host
                         scriptingEngine->SetCallbacks( &callbacks, this );
@@ -1132,169 +1854,835 @@ void VideoSourceData::PreparePlugins( )
             }
         }
 
-        if ( !StepFailedMessage.empty( ) )
+        if ( !StepFailedMessage.empty( ) )
+        {
+            ReportError( StepFailedMessage );
+        }
+    }
+}
+
+VideoSourceData::~VideoSourceData( )
+{
+    NeedToExitProcessingThread = true;
+    NewFrameIsAvailableEvent.Signal( );
+    VideoProcessingThread.Join( );
+
+    // frames of the video source are released along with it
+    Server->UpdateFrameMemoryUsage( FrameMemoryUsed, 0 );
+}
+
+// Handler of video processing thread
+void VideoSourceData::VideoProcessingThreadHandler( void* param )
+{
+    VideoSourceData* self = static_cast<VideoSourceData*>( param );
+    XErrorCode       ecode;
+
+    // prepare plug-ins for the video processing graph
+    self->PreparePlugins( );
+
+    // finally start the video source
+    ecode = self->VideoSource->Start( );
+    if ( ecode != SuccessCode )
+    {
+        string errorMessage = string( "Failed starting video source: " );
+        errorMessage.append( XError::Description( ecode ) );
+        self->ReportError( errorMessage );
+    }
+    else
+    {
+        // something to process is welcome now
+        self->ProcessingThreadIsFreeEvent.Signal( );
+
+        while ( !self->NeedToExitProcessingThread )
+        {
+            // TODO: better have auto reset event here
+            self->NewFrameIsAvailableEvent.Wait( );
+            self->NewFrameIsAvailableEvent.Reset( );
+
+            if ( !self->NeedToExitProcessingThread )
+            {
+                // from now we are busy processing the new frame
+                self->ProcessingThreadIsFreeEvent.Reset( );
+
+                self->PerformNewFrameProcessing( );
+
+                // signal we are free to process new frame
+                self->ProcessingThreadIsFreeEvent.Signal( );
+            }
+        }
+    }
+}
+
+// New video frame notification - video source does not tell capture time, so use arrival time
+void VideoSourceData::OnNewImage( const shared_ptr<const XImage>& image )
+{
+    OnNewImage( image, XTimestampNow( ) );
+}
+
+// New video frame notification along with its capture time
+void VideoSourceData::OnNewImage( const shared_ptr<const XImage>& image, int64_t captureTime )
+{
+    if ( !NeedToExitProcessingThread )
+    {
+        int64_t arrivalTime = XTimestampNow( );
+        XFrameMemoryPolicy memoryPolicy = XFrameMemoryPolicy::DropFrames;
+        bool isThrottling = Server->IsFrameMemoryThrottling( &memoryPolicy );
+        bool dropFrames   = ( isThrottling ) && ( memoryPolicy == XFrameMemoryPolicy::DropFrames );
+        bool dropIfBusy   = ( this->DropVideoFramesWhenBusy ) || ( dropFrames );
+        bool dropIt       = false;
+        bool throttleIt   = false;
+
+        if ( ( isThrottling ) && ( memoryPolicy == XFrameMemoryPolicy::DecimateLowPriority ) && ( LowPriority ) )
+        {
+            // let low priority video source process only every Nth frame
+            throttleIt = ( ( ++FramesDecimationCounter % LOW_PRIORITY_DECIMATION_FACTOR ) != 0 );
+        }
+
+        if ( throttleIt )
+        {
+            FramesDropped++;
+            dropIt = true;
+        }
+        // check if processing thread is still busy
+        else if ( !ProcessingThreadIsFreeEvent.IsSignaled( ) )
+        {
+            FramesBlocked++;
+
+            if ( dropIfBusy )
+            {
+                FramesDropped++;
+                dropIt     = true;
+                throttleIt = !this->DropVideoFramesWhenBusy;
+            }
+            else
+            {
+                // make sure the video processing thread is free
+                ProcessingThreadIsFreeEvent.Wait( );
+            }
+        }
+
+        if ( !dropIt )
+        {
+            XScopedLock lock( &VideoProcessingSync );
+
+            if ( ( dropFrames ) && ( IsMailboxFramePoolBusy( ) ) )
+            {
+                // listeners are still busy with earlier frames - drop this one instead of queuing more frames for them
+                FramesDropped++;
+                dropIt     = true;
+                throttleIt = true;
+
+                UpdateFrameMemoryUsage( true );
+            }
+            else if ( !CopyNewImage( image ) )
+            {
+                ReportError( "Not enough memory to get video frame" );
+            }
+            else
+            {
+                // clear any error if the video source is active
+                LastError.clear( );
+
+                FrameTimestamps = XVideoFrameTimestamps( );
+                FrameTimestamps.Captured = captureTime;
+                FrameTimestamps.Arrived  = arrivalTime;
+
+                // frame's resolution was reduced to fit into memory budget
+                throttleIt = ( LastImage->Width( ) != image->Width( ) );
+
+                // signal video processing thread that there is some job for it
+                NewFrameIsAvailableEvent.Signal( );
+            }
+        }
+
+        if ( throttleIt )
+        {
+            FramesThrottled++;
+            Server->CountThrottledFrame( );
+        }
+
+        // update counters
+        {
+            XScopedLock lock( &VideoFrameInfoSync );
+            FrameInfo.FramesBlocked   = FramesBlocked;
+            FrameInfo.FramesDropped   = FramesDropped;
+            FrameInfo.FramesThrottled = FramesThrottled;
+
+            if ( !dropIt )
+            {
+                FrameInfo.FramesReceived++;
+            }
+        }
+    }
+}
+
+// Copy image coming from video source into the processing buffer (reducing its resolution if required)
+bool VideoSourceData::CopyNewImage( const shared_ptr<const XImage>& image )
+{
+    bool copied = false;
+
+    LastImage.reset( );
+
+    if ( !ProcessingGraphBuffer.empty( ) )
+    {
+        LastImage = ProcessingGraphBuffer[0];
+    }
+
+    if ( ResolutionReduction != 0 )
+    {
+        int32_t      width  = std::max( image->Width( )  >> ResolutionReduction, 1 );
+        int32_t      height = std::max( image->Height( ) >> ResolutionReduction, 1 );
+        XPixelFormat format = image->Format( );
+
+        if ( ( !LastImage ) || ( LastImage->Width( ) != width ) || ( LastImage->Height( ) != height ) || ( LastImage->Format( ) != format ) )
+        {
+            LastImage = XImage::AllocateRaw( width, height, format );
+        }
+
+        copied = ( ( LastImage ) && ( ResizeImageBilinear( image->ImageData( ), LastImage->ImageData( ) ) == SuccessCode ) );
+    }
+
+    if ( !copied )
+    {
+        // make a copy of the image coming from video source (also for pixel formats, which can not be resized)
+        copied = image->CopyDataOrClone( LastImage );
+    }
+
+    if ( copied )
+    {
+        // update image in the processing buffer
+        if ( ProcessingGraphBuffer.empty( ) )
+        {
+            ProcessingGraphBuffer.push_back( LastImage );
+        }
+        else
+        {
+            ProcessingGraphBuffer[0] = LastImage;
+        }
+    }
+    else
+    {
+        LastImage.reset( );
+    }
+
+    return copied;
+}
+
+// Video source error notification
+void VideoSourceData::OnError( const string& errorMessage )
+{
+    ReportError( errorMessage );
+}
+
+// Report error to video source listeners
+void VideoSourceData::ReportError( const string& errorMessage )
+{
+    {
+        XScopedLock infoLock( &VideoFrameInfoSync );
+        FrameInfo.ErrorsReported++;
+    }
+
+    XScopedLock lock( &ListenerSync );
+
+    LastError = errorMessage;
+
+    for ( MailboxList::iterator it = Mailboxes.begin( ); it != Mailboxes.end( ); ++it )
+    {
+        (*it)->PostError( LastError );
+    }
+
+    for ( ListenersList::iterator it = Listeners.begin( ); it != Listeners.end( ); )
+    {
+        IAutomationVideoSourceListener* listener = *it;
+
+        // increment before calling listener, allowing it unsubscribe from handler
+        ++it;
+
+        listener->OnErrorMessage( VideoSourceId, LastError );
+    }
+}
+
+// Notify listeners of the new video frame available
+void VideoSourceData::NotifyNewFrame( )
+{
+    XScopedLock lock( &ListenerSync );
+
+    if ( !Mailboxes.empty( ) )
+    {
+        // all mailboxes share the same copy of the frame
+        shared_ptr<const XImage> imageCopy = CopyLastImageForMailboxes( );
+
+        if ( imageCopy )
+        {
+            for ( MailboxList::iterator it = Mailboxes.begin( ); it != Mailboxes.end( ); ++it )
+            {
+                (*it)->PostFrame( imageCopy, FrameTimestamps );
+            }
+        }
+    }
+    else if ( !MailboxFramePool.empty( ) )
+    {
+        MailboxFramePool.clear( );
+    }
+
+    for ( ListenersList::iterator it = Listeners.begin( ); it != Listeners.end( ); )
+    {
+        IAutomationVideoSourceListener* listener = *it;
+
+        // increment before calling listener, allowing it unsubscribe from handler
+        ++it;
+
+        listener->OnNewVideoFrame( VideoSourceId, LastImage, FrameTimestamps );
+    }
+}
+
+// Copy the last image for mailboxes - processing graph reuses its images, so listeners notified asynchronously
+// need their own copy. Copies which are not referenced by anyone else are reused for next frames.
+shared_ptr<const XImage> VideoSourceData::CopyLastImageForMailboxes( )
+{
+    size_t freeIndex = 0;
+
+    while ( ( freeIndex < MailboxFramePool.size( ) ) && ( MailboxFramePool[freeIndex].use_count( ) > 1 ) )
+    {
+        freeIndex++;
+    }
+
+    if ( freeIndex == MailboxFramePool.size( ) )
+    {
+        MailboxFramePool.push_back( shared_ptr<XImage>( ) );
+    }
+
+    if ( !LastImage->CopyDataOrClone( MailboxFramePool[freeIndex] ) )
+    {
+        MailboxFramePool[freeIndex].reset( );
+    }
+
+    return MailboxFramePool[freeIndex];
+}
+
+// Check if any of the frames copied for mailboxes is still queued or being delivered to a listener
+bool VideoSourceData::IsMailboxFramePoolBusy( ) const
+{
+    bool isBusy = false;
+
+    for ( size_t i = 0, n = MailboxFramePool.size( ); ( i < n ) && ( !isBusy ); i++ )
+    {
+        isBusy = ( MailboxFramePool[i].use_count( ) > 1 );
+    }
+
+    return isBusy;
+}
+
+// Recalculate memory taken by frames of the video source and update server's total. Frames copied for
+// mailboxes, which are not used by anyone at the moment, can be released to reduce memory usage.
+void VideoSourceData::UpdateFrameMemoryUsage( bool releaseUnusedFrames )
+{
+    uint64_t memoryUsed = 0;
+
+    if ( releaseUnusedFrames )
+    {
+        MailboxFramePool.erase( std::remove_if( MailboxFramePool.begin( ), MailboxFramePool.end( ),
+                                                [] ( const shared_ptr<XImage>& image ) { return image.use_count( ) <= 1; } ),
+                                MailboxFramePool.end( ) );
+    }
+
+    for ( size_t i = 0, n = ProcessingGraphBuffer.size( ); i < n; i++ )
+    {
+        if ( ProcessingGraphBuffer[i] )
+        {
+            memoryUsed += static_cast<uint64_t>( ProcessingGraphBuffer[i]->Stride( ) ) * ProcessingGraphBuffer[i]->Height( );
+        }
+    }
+
+    for ( size_t i = 0, n = MailboxFramePool.size( ); i < n; i++ )
+    {
+        if ( MailboxFramePool[i] )
+        {
+            memoryUsed += static_cast<uint64_t>( MailboxFramePool[i]->Stride( ) ) * MailboxFramePool[i]->Height( );
+        }
+    }
+
+    if ( memoryUsed != FrameMemoryUsed )
+    {
+        Server->UpdateFrameMemoryUsage( FrameMemoryUsed, memoryUsed );
+        FrameMemoryUsed = memoryUsed;
+
+        XScopedLock infoLock( &VideoFrameInfoSync );
+        FrameInfo.FrameMemoryUsed = memoryUsed;
+    }
+}
+
+// Decide if resolution of new frames needs to be reduced/restored to fit into frame memory budget
+void VideoSourceData::UpdateResolutionReduction( )
+{
+    XFrameMemoryPolicy memoryPolicy = XFrameMemoryPolicy::DropFrames;
+    bool               isThrottling = Server->IsFrameMemoryThrottling( &memoryPolicy );
+
+    if ( memoryPolicy != XFrameMemoryPolicy::ReduceResolution )
+    {
+        ResolutionReduction = 0;
+    }
+    else if ( isThrottling )
+    {
+        if ( ResolutionReduction < MAX_RESOLUTION_REDUCTION )
+        {
+            ResolutionReduction++;
+        }
+    }
+    // doubling resolution takes 4 times more memory for the video source's frames
+    else if ( ( ResolutionReduction != 0 ) && ( Server->IsFrameMemoryAvailable( FrameMemoryUsed * 3 ) ) )
+    {
+        ResolutionReduction--;
+    }
+}
+
+// Add listener to notify synchronously (queue length is 0) or through a mailbox
+bool VideoSourceData::AddListener( IAutomationVideoSourceListener* listener, uint32_t queueLength )
+{
+    XScopedLock lock( &ListenerSync );
+    bool        ret = true;
+
+    if ( queueLength == 0 )
+    {
+        Listeners.push_back( listener );
+    }
+    else
+    {
+        shared_ptr<ListenerMailbox> mailbox = ListenerMailbox::Create( VideoSourceId, listener, queueLength );
+
+        if ( mailbox )
+        {
+            Mailboxes.push_back( mailbox );
+        }
+        else
+        {
+            ret = false;
+        }
+    }
+
+    return ret;
+}
+
+// Remove listener - returns its mailbox if the caller needs to wait for its dispatcher to finish
+shared_ptr<ListenerMailbox> VideoSourceData::RemoveListener( IAutomationVideoSourceListener* listener )
+{
+    XScopedLock                 lock( &ListenerSync );
+    shared_ptr<ListenerMailbox> mailbox;
+
+    Listeners.remove( listener );
+
+    for ( MailboxList::iterator it = Mailboxes.begin( ); it != Mailboxes.end( ); ++it )
+    {
+        if ( (*it)->Listener == listener )
+        {
+            mailbox = *it;
+            Mailboxes.erase( it );
+            break;
+        }
+    }
+
+    // forget retired mailboxes, which are done already
+    for ( MailboxList::iterator it = RetiredMailboxes.begin( ); it != RetiredMailboxes.end( ); )
+    {
+        if ( (*it)->IsStopped( ) )
+        {
+            it = RetiredMailboxes.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if ( mailbox )
+    {
+        mailbox->SignalToStop( );
+
+        // the listener unsubscribes from its own handler - can not wait for the dispatcher to finish
+        if ( mailbox->IsDispatcherThread( ) )
+        {
+            RetiredMailboxes.push_back( mailbox );
+            mailbox.reset( );
+        }
+    }
+
+    return mailbox;
+}
+
+// Remove all listeners without waiting for dispatchers of their mailboxes - those are provided to the
+// caller to wait for (if it asks and does not run on one of them) or retired otherwise
+void VideoSourceData::ClearListeners( MailboxList* mailboxesToWait )
+{
+    XScopedLock lock( &ListenerSync );
+
+    Listeners.clear( );
+
+    for ( MailboxList::iterator it = Mailboxes.begin( ); it != Mailboxes.end( ); ++it )
+    {
+        (*it)->SignalToStop( );
+
+        if ( ( mailboxesToWait != nullptr ) && ( !(*it)->IsDispatcherThread( ) ) )
+        {
+            mailboxesToWait->push_back( *it );
+        }
+        else
+        {
+            RetiredMailboxes.push_back( *it );
+        }
+    }
+
+    Mailboxes.clear( );
+}
+
+// Notify just added listener with the last image/error
+void VideoSourceData::NotifyListenerWithRecent( IAutomationVideoSourceListener* listener )
+{
+    if ( VideoProcessingSync.TryLock( ) )
+    {
+        shared_ptr<ListenerMailbox> mailbox;
+
+        {
+            XScopedLock lock( &ListenerSync );
+
+            for ( MailboxList::iterator it = Mailboxes.begin( ); it != Mailboxes.end( ); ++it )
+            {
+                if ( (*it)->Listener == listener )
+                {
+                    mailbox = *it;
+                }
+            }
+        }
+
+        // notify of last image and/or error if there are any
+        if ( LastImage )
+        {
+            if ( mailbox )
+            {
+                shared_ptr<const XImage> imageCopy = CopyLastImageForMailboxes( );
+
+                if ( imageCopy )
+                {
+                    mailbox->PostFrame( imageCopy, FrameTimestamps );
+                }
+            }
+            else
+            {
+                listener->OnNewVideoFrame( VideoSourceId, LastImage, FrameTimestamps );
+            }
+        }
+        if ( !LastError.empty( ) )
+        {
+            if ( mailbox )
+            {
+                mailbox->PostError( LastError );
+            }
+            else
+            {
+                listener->OnErrorMessage( VideoSourceId, LastError );
+            }
+        }
+
+        VideoProcessingSync.Unlock( );
+    }
+}
+
+// Queue new video frame for the listener
+void ListenerMailbox::PostFrame( const shared_ptr<const XImage>& image, const XVideoFrameTimestamps& timestamps )
+{
+    XScopedLock lock( &Sync );
+
+    if ( FramesQueued >= QueueLength )
+    {
+        // drop the oldest queued frame
+        for ( deque<MailboxItem>::iterator it = Items.begin( ); it != Items.end( ); ++it )
         {
-            ReportError( StepFailedMessage );
+            if ( it->Image )
+            {
+                Items.erase( it );
+                break;
+            }
         }
+
+        FramesQueued--;
+        FramesDropped++;
     }
+
+    Items.push_back( MailboxItem( ) );
+    Items.back( ).Image      = image;
+    Items.back( ).Timestamps = timestamps;
+    FramesQueued++;
+
+    NewItemEvent.Signal( );
 }
 
-// Handler of video processing thread
-void VideoSourceData::VideoProcessingThreadHandler( void* param )
+// Queue error message for the listener
+void ListenerMailbox::PostError( const string& errorMessage )
 {
-    VideoSourceData* self = static_cast<VideoSourceData*>( param );
-    XErrorCode       ecode;
+    XScopedLock lock( &Sync );
 
-    // prepare plug-ins for the video processing graph
-    self->PreparePlugins( );
+    Items.push_back( MailboxItem( ) );
+    Items.back( ).ErrorMessage = errorMessage;
 
-    // finally start the video source
-    ecode = self->VideoSource->Start( );
-    if ( ecode != SuccessCode )
-    {
-        string errorMessage = string( "Failed starting video source: " );
-        errorMessage.append( XError::Description( ecode ) );
-        self->ReportError( errorMessage );
-    }
-    else
-    {
-        // something to process is welcome now
-        self->ProcessingThreadIsFreeEvent.Signal( );
+    NewItemEvent.Signal( );
+}
 
-        while ( !self->NeedToExitProcessingThread )
-        {
-            // TODO: better have auto reset event here
-            self->NewFrameIsAvailableEvent.Wait( );
-            self->NewFrameIsAvailableEvent.Reset( );
+// Signal dispatcher thread to exit (without waiting for it)
+void ListenerMailbox::SignalToStop( )
+{
+    NeedToExit = true;
+    NewItemEvent.Signal( );
+}
 
-            if ( !self->NeedToExitProcessingThread )
-            {
-                // from now we are busy processing the new frame
-                self->ProcessingThreadIsFreeEvent.Reset( );
+// Check if the dispatcher thread has exited
+bool ListenerMailbox::IsStopped( )
+{
+    return !DispatcherThread.IsRunning( );
+}
 
-                self->PerformNewFrameProcessing( );
+// Wait for the dispatcher thread to exit (must be signalled to stop first)
+void ListenerMailbox::WaitForStop( )
+{
+    DispatcherThread.Join( );
+}
 
-                // signal we are free to process new frame
-                self->ProcessingThreadIsFreeEvent.Signal( );
-            }
-        }
+// Check if the caller runs on the dispatcher thread (the listener is being notified)
+bool ListenerMailbox::IsDispatcherThread( ) const
+{
+    return ( DispatcherThreadId == XThread::ThreadId( ) );
+}
+
+// Get number of frames delivered to the listener, dropped because it did not keep up and still queued
+void ListenerMailbox::GetStatistics( uint32_t* framesDelivered, uint32_t* framesDropped, uint32_t* framesQueued )
+{
+    XScopedLock lock( &Sync );
+
+    if ( framesQueued != nullptr )
+    {
+        *framesQueued = FramesQueued;
+    }
+
+    if ( framesDelivered != nullptr )
+    {
+        *framesDelivered = FramesDelivered;
+    }
+    if ( framesDropped != nullptr )
+    {
+        *framesDropped = FramesDropped;
     }
 }
 
-// New video frame notification
-void VideoSourceData::OnNewImage( const shared_ptr<const XImage>& image )
+// Dispatcher thread of a mailbox - delivers queued items to the listener
+void ListenerMailbox::DispatcherThreadHandler( void* param )
 {
-    if ( !NeedToExitProcessingThread )
+    ListenerMailbox* self = static_cast<ListenerMailbox*>( param );
+    MailboxItem      item;
+
+    self->DispatcherThreadId = XThread::ThreadId( );
+
+    for ( ; ; )
     {
-        bool dropIfBusy = this->DropVideoFramesWhenBusy;
-        bool dropIt     = false;
+        self->NewItemEvent.Wait( );
 
-        // check if processing thread is still busy
-        if ( !ProcessingThreadIsFreeEvent.IsSignaled( ) )
+        if ( self->NeedToExit )
         {
-            FramesBlocked++;
+            break;
+        }
 
-            if ( dropIfBusy )
+        {
+            XScopedLock lock( &self->Sync );
+
+            if ( self->Items.empty( ) )
             {
-                FramesDropped++;
-                dropIt = true;
+                self->NewItemEvent.Reset( );
+                continue;
             }
-            else
+
+            item = self->Items.front( );
+            self->Items.pop_front( );
+
+            if ( item.Image )
             {
-                // make sure the video processing thread is free
-                ProcessingThreadIsFreeEvent.Wait( );
+                self->FramesQueued--;
             }
         }
 
-        // update counters
+        if ( item.Image )
         {
-            XScopedLock lock( &VideoFrameInfoSync );
-            FrameInfo.FramesBlocked = FramesBlocked;
-            FrameInfo.FramesDropped = FramesDropped;
+            self->Listener->OnNewVideoFrame( self->VideoSourceId, item.Image, item.Timestamps );
 
-            if ( !dropIt )
-            {
-                FrameInfo.FramesReceived++;
-            }
-        }
+            // release the frame, so the video source could reuse it
+            item.Image.reset( );
 
-        if ( !dropIt )
+            XScopedLock lock( &self->Sync );
+            self->FramesDelivered++;
+        }
+        else
         {
-            XScopedLock lock( &VideoProcessingSync );
+            self->Listener->OnErrorMessage( self->VideoSourceId, item.ErrorMessage );
+        }
+    }
+}
 
-            LastImage.reset( );
+// Set configuration of capturing (the writer thread is started when capturing gets enabled first time)
+void StepCaptureWriter::SetConfiguration( const XStepCaptureConfiguration& config )
+{
+    XScopedLock lock( &Sync );
 
-            if ( !ProcessingGraphBuffer.empty( ) )
-            {
-                LastImage = ProcessingGraphBuffer[0];
-            }
+    Configuration = config;
 
-            // make a copy of the image coming from video source
-            image->CopyDataOrClone( LastImage );
+    if ( Configuration.MaxCases == 0 )
+    {
+        Configuration.MaxCases = 1;
+    }
+
+    if ( Configuration.Folder.empty( ) )
+    {
+        Pending.clear( );
+    }
+    else
+    {
+        // continue the ring after the most recent case left by previous run
+        NextSlot = FindNextSlot( );
 
-            if ( !LastImage )
+        if ( !WriterThread.IsRunning( ) )
+        {
+            if ( WriterThread.Create( WriterThreadHandler, this ) )
             {
-                ReportError( "Not enough memory to get video frame" );
+                WriterThread.SetPriority( XThreadPriority::BelowNormal );
             }
             else
             {
-                // clear any error if the video source is active
-                LastError.clear( );
-
-                // update image in the processing buffer
-                if ( ProcessingGraphBuffer.empty( ) )
-                {
-                    ProcessingGraphBuffer.push_back( LastImage );
-                }
-                else
-                {
-                    ProcessingGraphBuffer[0] = LastImage;
-                }
-
-                // signal video processing thread that there is some job for it
-                NewFrameIsAvailableEvent.Signal( );
+                Configuration.Folder.clear( );
             }
         }
     }
 }
 
-// Video source error notification
-void VideoSourceData::OnError( const string& errorMessage )
+// Get configuration of capturing
+XStepCaptureConfiguration StepCaptureWriter::GetConfiguration( )
 {
-    ReportError( errorMessage );
+    XScopedLock lock( &Sync );
+    return Configuration;
 }
 
-// Report error to video source listeners
-void VideoSourceData::ReportError( const string& errorMessage )
+// Get number of saved/dropped/failed cases
+XStepCaptureInfo StepCaptureWriter::GetInfo( )
 {
-    XScopedLock lock( &ListenerSync );
+    XScopedLock lock( &Sync );
+    return Info;
+}
 
-    LastError = errorMessage;
+// Check if capturing is enabled and get latency threshold of steps
+bool StepCaptureWriter::IsEnabled( float* latencyThreshold )
+{
+    XScopedLock lock( &Sync );
 
-    for ( ListenersList::iterator it = Listeners.begin( ); it != Listeners.end( ); )
+    *latencyThreshold = Configuration.LatencyThreshold;
+
+    return ( !Configuration.Folder.empty( ) );
+}
+
+// Queue captured case to save
+void StepCaptureWriter::Post( const shared_ptr<XStepCaptureCase>& captureCase )
+{
+    XScopedLock lock( &Sync );
+
+    if ( !Configuration.Folder.empty( ) )
     {
-        IAutomationVideoSourceListener* listener = *it;
+        if ( Pending.size( ) >= MAX_PENDING_CASES )
+        {
+            Info.CasesDropped++;
+        }
+        else
+        {
+            Pending.push_back( captureCase );
+            NewCaseEvent.Signal( );
+        }
+    }
+}
 
-        // increment before calling listener, allowing it unsubscribe from handler
-        ++it;
+// Get name of the file for the specified slot of the ring
+string StepCaptureWriter::SlotFileName( uint32_t slot ) const
+{
+    char   buffer[32];
+    string fileName = Configuration.Folder;
+    char   lastChar = fileName[fileName.length( ) - 1];
 
-        listener->OnErrorMessage( VideoSourceId, LastError );
+    if ( ( lastChar != '/' ) && ( lastChar != '\\' ) )
+    {
+        fileName += '/';
     }
+
+    sprintf( buffer, "step_capture_%03u.cvscap", slot );
+
+    return fileName + buffer;
 }
 
-// Notify listeners of the new video frame available
-void VideoSourceData::NotifyNewFrame( )
+// Find slot following the most recently written file
+uint32_t StepCaptureWriter::FindNextSlot( ) const
 {
-    XScopedLock lock( &ListenerSync );
+    uint32_t nextSlot   = 0;
+    time_t   latestTime = 0;
 
-    for ( ListenersList::iterator it = Listeners.begin( ); it != Listeners.end( ); )
+    for ( uint32_t slot = 0; slot < Configuration.MaxCases; slot++ )
     {
-        IAutomationVideoSourceListener* listener = *it;
+        struct stat fileInfo;
 
-        // increment before calling listener, allowing it unsubscribe from handler
-        ++it;
+        if ( ( stat( SlotFileName( slot ).c_str( ), &fileInfo ) == 0 ) && ( fileInfo.st_mtime >= latestTime ) )
+        {
+            latestTime = fileInfo.st_mtime;
+            nextSlot   = ( slot + 1 ) % Configuration.MaxCases;
+        }
+    }
 
-        listener->OnNewVideoFrame( VideoSourceId, LastImage );
+    return nextSlot;
+}
+
+// Writer thread - saves queued cases into files
+void StepCaptureWriter::WriterThreadHandler( void* param )
+{
+    StepCaptureWriter* self = static_cast<StepCaptureWriter*>( param );
+
+    for ( ; ; )
+    {
+        shared_ptr<XStepCaptureCase> captureCase;
+        string                       fileName;
+
+        self->NewCaseEvent.Wait( );
+
+        if ( self->NeedToExit )
+        {
+            break;
+        }
+
+        {
+            XScopedLock lock( &self->Sync );
+
+            if ( self->Pending.empty( ) )
+            {
+                self->NewCaseEvent.Reset( );
+                continue;
+            }
+
+            captureCase = self->Pending.front( );
+            self->Pending.pop_front( );
+
+            fileName = self->SlotFileName( self->NextSlot );
+            self->NextSlot = ( self->NextSlot + 1 ) % self->Configuration.MaxCases;
+        }
+
+        XErrorCode ret = captureCase->Save( fileName );
+
+        XScopedLock lock( &self->Sync );
+
+        if ( ret == SuccessCode )
+        {
+            self->Info.CasesSaved++;
+        }
+        else
+        {
+            self->Info.CasesFailed++;
+        }
     }
 }
 
@@ -1312,11 +2700,22 @@ void VideoSourceData::PerformNewFrameProcessing( )
     XPixelFormat    originalPixelFormat = LastImage->Format( );
     int32_t         videoProcessingStepsDone = 0;
     float           graphTimeTaken      = 0.0f;
+    vector<int32_t> triggeredDetectionSteps;
+
+    FrameTimestamps.ProcessingStarted = XTimestampNow( );
 
     // apply video processing graph if any
     if ( ProcessingGraph.StepsCount( ) != 0 )
     {
         steady_clock::time_point    processingGraphStartTime;
+        float                       captureThreshold = 0.0f;
+        bool                        captureSteps     = Server->StepCapture.IsEnabled( &captureThreshold );
+
+        if ( !captureSteps )
+        {
+            // release copy of step's input once capturing gets disabled
+            StepInputImage.reset( );
+        }
 
         if ( IsPerformanceMonitroRunning )
         {
@@ -1342,8 +2741,15 @@ void VideoSourceData::PerformNewFrameProcessing( )
                 else
                 {
                     steady_clock::time_point    processingStepStartTime;
+                    float                       stepTimeTaken = 0.0f;
 
-                    if ( IsPerformanceMonitroRunning )
+                    // keep input of the step, so it could be captured if the step fails or runs too long
+                    if ( ( captureSteps ) && ( !LastImage->CopyDataOrClone( StepInputImage ) ) )
+                    {
+                        StepInputImage.reset( );
+                    }
+
+                    if ( ( IsPerformanceMonitroRunning ) || ( captureSteps ) )
                     {
                         processingStepStartTime = steady_clock::now( );
                     }
@@ -1360,6 +2766,11 @@ void VideoSourceData::PerformNewFrameProcessing( )
 
                     case PluginType_Detection:
                         errorCode = DoDetectionPlugin( static_pointer_cast<XDetectionPlugin>( plugin ) );
+
+                        if ( ( errorCode == SuccessCode ) && ( static_pointer_cast<XDetectionPlugin>( plugin )->Detected( ) ) )
+                        {
+                            triggeredDetectionSteps.push_back( currentStepIndex );
+                        }
                         break;
 
                     case PluginType_ScriptingEngine:
@@ -1371,13 +2782,17 @@ void VideoSourceData::PerformNewFrameProcessing( )
                         break;
                     }
 
-                    // get time taken by the video processing step if performance monitor is enabled
-                    if ( IsPerformanceMonitroRunning )
+                    // get time taken by the video processing step if performance monitor or capturing is enabled
+                    if ( ( IsPerformanceMonitroRunning ) || ( captureSteps ) )
                     {
-                        float timeTaken = static_cast<float>(
+                        stepTimeTaken = static_cast<float>(
                             duration_cast<std::chrono::microseconds>(
                             steady_clock::now( ) - processingStepStartTime ).count( ) ) / 1000.0f;
+                    }
 
+                    if ( IsPerformanceMonitroRunning )
+                    {
+                        float timeTaken = stepTimeTaken;
 
                         if ( ProcessingStepTimeTaken[currentStepIndex].size( ) < PERFORMANCE_HISTORY_LENGTH )
                         {
@@ -1420,6 +2835,12 @@ void VideoSourceData::PerformNewFrameProcessing( )
                             break;
                         }
                     }
+
+                    if ( ( captureSteps ) &&
+                         ( ( !errorMessage.empty( ) ) || ( ( captureThreshold > 0.0f ) && ( stepTimeTaken > captureThreshold ) ) ) )
+                    {
+                        CaptureProcessingStep( *stepIt, currentStepIndex, errorCode, errorMessage, stepTimeTaken, captureThreshold );
+                    }
                 }
 
                 ++currentStepIndex;
@@ -1435,14 +2856,19 @@ void VideoSourceData::PerformNewFrameProcessing( )
         }
     }
 
+    FrameTimestamps.ProcessingFinished = XTimestampNow( );
+
     // update video frame information
     {
         XScopedLock infoLock( &VideoFrameInfoSync );
 
+        UpdateLatencyStatistics( );
+
         FrameInfo.OriginalFrameWidth       = originalFrameWidth;
         FrameInfo.OriginalFrameHeight      = originalFrameHeight;
         FrameInfo.OriginalPixelFormat      = originalPixelFormat;
         FrameInfo.VideoProcessingStepsDone = videoProcessingStepsDone;
+        FrameInfo.TriggeredDetectionSteps.swap( triggeredDetectionSteps );
 
         FrameInfo.ProcessedFrameWidth  = LastImage->Width( );
         FrameInfo.ProcessedFrameHeight = LastImage->Height( );
@@ -1503,12 +2929,93 @@ void VideoSourceData::PerformNewFrameProcessing( )
     // we provide the new video frame even if processing graph is not complete
     NotifyNewFrame( );
 
+    // account memory taken by frames after processing graph and listeners got their images
+    {
+        XFrameMemoryPolicy memoryPolicy;
+
+        UpdateFrameMemoryUsage( Server->IsFrameMemoryThrottling( &memoryPolicy ) );
+        UpdateResolutionReduction( );
+    }
+
     if ( !errorMessage.empty( ) )
     {
         ReportError( errorMessage );
     }
 }
 
+// Update latency statistics with time stamps of the just processed frame (VideoFrameInfoSync must be locked)
+void VideoSourceData::UpdateLatencyStatistics( )
+{
+    float sourceLatency = 0.0f, queueLatency = 0.0f, processingLatency = 0.0f, totalLatency = 0.0f, maxTotalLatency = 0.0f;
+
+    if ( LatencyHistory.size( ) < PERFORMANCE_HISTORY_LENGTH )
+    {
+        LatencyHistory.push_back( FrameTimestamps );
+    }
+    else
+    {
+        LatencyHistory[LatencyHistoryIndex++] = FrameTimestamps;
+        LatencyHistoryIndex %= PERFORMANCE_HISTORY_LENGTH;
+    }
+
+    for ( vector<XVideoFrameTimestamps>::const_iterator it = LatencyHistory.begin( ); it != LatencyHistory.end( ); ++it )
+    {
+        float total = static_cast<float>( it->ProcessingFinished - it->Captured ) / 1000.0f;
+
+        sourceLatency     += static_cast<float>( it->Arrived - it->Captured ) / 1000.0f;
+        queueLatency      += static_cast<float>( it->ProcessingStarted - it->Arrived ) / 1000.0f;
+        processingLatency += static_cast<float>( it->ProcessingFinished - it->ProcessingStarted ) / 1000.0f;
+        totalLatency      += total;
+        maxTotalLatency    = std::max( maxTotalLatency, total );
+    }
+
+    TotalLatencyHistogram.Add( static_cast<double>( FrameTimestamps.ProcessingFinished - FrameTimestamps.Captured ) / 1000000.0 );
+    ProcessingLatencyHistogram.Add( static_cast<double>( FrameTimestamps.ProcessingFinished - FrameTimestamps.ProcessingStarted ) / 1000000.0 );
+
+    FrameInfo.LastFrameTimestamps      = FrameTimestamps;
+    FrameInfo.AverageSourceLatency     = sourceLatency     / LatencyHistory.size( );
+    FrameInfo.AverageQueueLatency      = queueLatency      / LatencyHistory.size( );
+    FrameInfo.AverageProcessingLatency = processingLatency / LatencyHistory.size( );
+    FrameInfo.AverageTotalLatency      = totalLatency      / LatencyHistory.size( );
+    FrameInfo.MaxTotalLatency          = maxTotalLatency;
+}
+
+// Queue input frame, configuration and timing of the step, which failed or ran over the latency threshold, to be saved
+void VideoSourceData::CaptureProcessingStep( const XVideoSourceProcessingStep& step, int32_t stepIndex, XErrorCode errorCode,
+                                             const string& errorMessage, float timeTaken, float latencyThreshold )
+{
+    shared_ptr<XStepCaptureCase> captureCase;
+
+    if ( StepInputImage )
+    {
+        captureCase.reset( new (nothrow) XStepCaptureCase( ) );
+    }
+
+    if ( captureCase )
+    {
+        shared_ptr<const XPluginDescriptor> pluginDesc = Server->PluginsEngine->GetPlugin( step.PluginId( ) );
+
+        captureCase->Reason           = ( errorMessage.empty( ) ) ? XStepCaptureReason::Slow : XStepCaptureReason::Error;
+        captureCase->VideoSourceId    = VideoSourceId;
+        captureCase->StepIndex        = stepIndex;
+        captureCase->StepName         = step.Name( );
+        captureCase->PluginId         = step.PluginId( );
+        captureCase->PluginName       = ( pluginDesc ) ? pluginDesc->ShortName( ) : string( );
+        captureCase->ErrorCode        = errorCode;
+        captureCase->ErrorMessage     = errorMessage;
+        captureCase->TimeTaken        = timeTaken;
+        captureCase->LatencyThreshold = latencyThreshold;
+        captureCase->Timestamps       = FrameTimestamps;
+        captureCase->Configuration    = step.GetPluginInstanceConfiguration( );
+
+        // the copy is given to the writer, so next step makes a new one
+        captureCase->Image = StepInputImage;
+        StepInputImage.reset( );
+
+        Server->StepCapture.Post( captureCase );
+    }
+}
+
 // Run image processing filter plug-in on the current image
 XErrorCode VideoSourceData::DoImageProcessingFilterPlugin( const shared_ptr<XImageProcessingFilterPlugin>& plugin, size_t& currrentGraphBufferIndex )
 {
@@ -1865,6 +3372,27 @@ XErrorCode VideoSourceData::ScriptingEnginePluginCallback_GetVideoSource( void*
     return ret;
 }
 
+// Callback to get time stamps of the video frame being processed (it is not finished yet, so processing end time is 0)
+XErrorCode VideoSourceData::ScriptingEnginePluginCallback_GetFrameTimestamps( void* userParam, xframetimestamps* timestamps )
+{
+    VideoSourceData* self = static_cast<VideoSourceData*>( userParam );
+    XErrorCode       ret  = SuccessCode;
+
+    if ( timestamps == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else
+    {
+        timestamps->captured           = self->FrameTimestamps.Captured;
+        timestamps->arrived            = self->FrameTimestamps.Arrived;
+        timestamps->processingStarted  = self->FrameTimestamps.ProcessingStarted;
+        timestamps->processingFinished = self->FrameTimestamps.ProcessingFinished;
+    }
+
+    return ret;
+}
+
 // ================== Scripting thread specific callbacks ==================
 
 // Callback to get name of the host running scripting engine plug-in
@@ -1940,6 +3468,14 @@ XErrorCode ScriptingThreadData::ScriptingEnginePluginCallback_GetVideoSource( vo
     return ErrorNotImplemented;
 }
 
+// Callback to get time stamps of the video frame being processed - not supported for threads
+XErrorCode ScriptingThreadData::ScriptingEnginePluginCallback_GetFrameTimestamps( void* userParam, xframetimestamps* timestamps )
+{
+    XUNREFERENCED_PARAMETER( userParam )
+    XUNREFERENCED_PARAMETER( timestamps )
+    return ErrorNotImplemented;
+}
+
 // =========================================================================
 
 // Handler of script processing thread
@@ -1961,6 +3497,7 @@ void ScriptingThreadData::ScriptProcessingThreadHandler( void* param )
     callbacks.GetImageVariable     = ScriptingEnginePluginCallback_GetImageVariable;
     callbacks.SetImageVariable     = ScriptingEnginePluginCallback_SetImageVariable;
     callbacks.GetVideoSource       = ScriptingEnginePluginCallback_GetVideoSource;
+    callbacks.GetFrameTimestamps   = ScriptingEnginePluginCallback_GetFrameTimestamps;
 
     // set callback first to allow script interface with the host
     self->ScriptingEngine->SetCallbacks( &callbacks, self );
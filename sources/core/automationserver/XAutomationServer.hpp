@@ -27,12 +27,15 @@
 #include <xtypes.h>
 #include <XInterfaces.hpp>
 
+#include <XThread.hpp>
 #include <XPluginsEngine.hpp>
 #include <XVideoSourcePlugin.hpp>
 #include <XScriptingEnginePlugin.hpp>
 
 #include "IAutomationVideoSourceListener.hpp"
 #include "IAutomationVariablesListener.hpp"
+#include "XFrameMemoryInfo.hpp"
+#include "XStepCaptureCase.hpp"
 
 namespace CVSandbox { namespace Automation
 {
@@ -93,13 +96,40 @@ public:
     std::vector<float> GetVideoProcessingGraphTiming( uint32_t videoSourceId, float* totalTime = nullptr );
     // Start all video sources
     void StartAllVideoSources( );
-    // Move the specified video source into finalization queue
+    // Move the specified video source into finalization queue (its listeners are not called anymore once
+    // the method returns, unless it is called from a listener's handler)
     bool FinalizeVideoSource( uint32_t videoSourceId );
-
-    // Add listener for the specified video source
-    bool AddVideoSourceListener( uint32_t videoSourceId, IAutomationVideoSourceListener* listener, bool notifyWithRecent = true );
-    // Remove listener from the specified video source
+    // Set CPU affinity mask (bit N is for CPU N, 0 - any CPU) and priority of the video processing thread of the
+    // specified video source (can be set before the video source is started or while it is running)
+    bool SetVideoProcessingThreadScheduling( uint32_t videoSourceId, uint64_t cpuMask, CVSandbox::Threading::XThreadPriority priority );
+
+    // Mark the specified video source as low priority one, so its frames are decimated first when frame memory budget is exceeded
+    bool SetVideoSourceLowPriority( uint32_t videoSourceId, bool lowPriority );
+
+    // Set budget of memory taken by video frames of all video sources (bytes, 0 - no limit) and the policy
+    // to apply while it is exceeded
+    void SetFrameMemoryBudget( uint64_t budget, XFrameMemoryPolicy policy = XFrameMemoryPolicy::DropFrames );
+    // Get memory taken by video frames of all video sources and number of frames throttled to fit into the budget
+    XFrameMemoryInfo GetFrameMemoryInfo( );
+
+    // Set configuration of capturing video processing steps, which fail or take longer than the latency threshold.
+    // Input frame, configuration and timing of such steps are saved on a background thread into a ring of files
+    // in the specified (existing) folder. While capturing is enabled, input frame of every step is copied.
+    void SetStepCaptureConfiguration( const XStepCaptureConfiguration& config );
+    XStepCaptureConfiguration GetStepCaptureConfiguration( );
+    // Get number of captured cases saved/dropped/failed to save
+    XStepCaptureInfo GetStepCaptureInfo( );
+
+    // Add listener for the specified video source. With zero queue length the listener is notified synchronously
+    // on the video processing thread. Otherwise it gets own mailbox and dispatcher thread, so a slow listener does
+    // not stall video processing - the mailbox keeps up to the specified number of frames dropping the oldest
+    // one when full (1 - the latest frame only).
+    bool AddVideoSourceListener( uint32_t videoSourceId, IAutomationVideoSourceListener* listener, bool notifyWithRecent = true, uint32_t queueLength = 0 );
+    // Remove listener from the specified video source (it is not called anymore once the method returns)
     void RemoveVideoSourceListener( uint32_t videoSourceId, IAutomationVideoSourceListener* listener );
+    // Get number of frames delivered to/dropped for the listener, which is notified asynchronously
+    bool GetVideoSourceListenerStatistics( uint32_t videoSourceId, IAutomationVideoSourceListener* listener,
+                                           uint32_t* framesDelivered, uint32_t* framesDropped );
 
     // Add a thread, which will run the specified script at the specified time intervals (milliseconds)
     uint32_t AddThread( const std::shared_ptr<XScriptingEnginePlugin>& scriptToRun, uint32_t msecInterval );
@@ -109,6 +139,8 @@ public:
     void StartAllThreads( );
     // Finalize the specified scripting thread
     bool FinalizeThread( uint32_t threadId );
+    // Set CPU affinity mask (0 - any CPU) and priority of the specified scripting thread
+    bool SetScriptingThreadScheduling( uint32_t threadId, uint64_t cpuMask, CVSandbox::Threading::XThreadPriority priority );
 
     // Clear all variables stored in the automation server
     void ClearAllVariables( );
@@ -124,6 +156,11 @@ public:
     // For debug purposes mostly - get number of video sources in each group
     void GetVideoSourceCount( uint32_t* notStarted, uint32_t* running, uint32_t* finalizing );
 
+    // Get counters/histograms of all running video sources and frame memory of the server in Prometheus
+    // text exposition format. Counters are copied under short locks only, so it can be called at any time
+    // (from any thread) without holding video processing.
+    std::string GetMetrics( );
+
 private:
     const std::auto_ptr<Private::XAutomationServerData> mData;
 };
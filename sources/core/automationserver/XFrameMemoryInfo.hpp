@@ -0,0 +1,68 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XFRAME_MEMORY_INFO_HPP
+#define CVS_XFRAME_MEMORY_INFO_HPP
+
+#include <stdint.h>
+
+namespace CVSandbox { namespace Automation
+{
+
+// What to do with new video frames, when memory taken by frames of all video sources exceeds the budget
+enum class XFrameMemoryPolicy
+{
+    // Drop new frames of a video source, while its processing thread or any of its listeners is still busy with earlier frames
+    DropFrames = 0,
+    // Let low priority video sources process only every Nth frame (other video sources are not throttled)
+    DecimateLowPriority,
+    // Halve resolution of new frames (down to 1/8 of original size) until frames fit into the budget
+    ReduceResolution
+};
+
+// Information about memory taken by video frames of all video sources of the automation server - images
+// copied from video sources, produced by processing graphs and copied for listeners notified asynchronously.
+// Memory allocated by plug-ins internally is not accounted.
+struct XFrameMemoryInfo
+{
+    // Memory budget in bytes (0 - no limit)
+    uint64_t           Budget;
+    XFrameMemoryPolicy Policy;
+    // Memory currently taken by video frames and its peak value
+    uint64_t           Used;
+    uint64_t           PeakUsed;
+    // Budget is currently exceeded and the backpressure policy is applied
+    bool               IsThrottling;
+    // Number of times the budget was exceeded and total number of frames dropped/reduced because of it
+    uint32_t           ThrottlingEvents;
+    uint32_t           FramesThrottled;
+
+    XFrameMemoryInfo( ) :
+        Budget( 0 ), Policy( XFrameMemoryPolicy::DropFrames ), Used( 0 ), PeakUsed( 0 ),
+        IsThrottling( false ), ThrottlingEvents( 0 ), FramesThrottled( 0 )
+    {
+    }
+};
+
+} } // namespace CVSandbox::Automation
+
+#endif // CVS_XFRAME_MEMORY_INFO_HPP
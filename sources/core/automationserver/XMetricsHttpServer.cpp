@@ -0,0 +1,507 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+
+    typedef SOCKET socket_t;
+
+    #define CLOSE_SOCKET( s )   closesocket( s )
+    #define WOULD_BLOCK( )      ( WSAGetLastError( ) == WSAEWOULDBLOCK )
+    #define SEND_FLAGS          0
+#else
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <errno.h>
+
+    typedef int socket_t;
+
+    #define INVALID_SOCKET      ( -1 )
+    #define SOCKET_ERROR        ( -1 )
+    #define CLOSE_SOCKET( s )   close( s )
+    #define WOULD_BLOCK( )      ( ( errno == EAGAIN ) || ( errno == EWOULDBLOCK ) || ( errno == EINTR ) )
+    #define SEND_FLAGS          MSG_NOSIGNAL
+#endif
+
+#include "XMetricsHttpServer.hpp"
+#include "XAutomationServer.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <list>
+#include <chrono>
+
+#include <XMutex.hpp>
+#include <XThread.hpp>
+
+using namespace std;
+using namespace std::chrono;
+using namespace CVSandbox;
+using namespace CVSandbox::Threading;
+using namespace CVSandbox::Automation::Private;
+
+namespace CVSandbox { namespace Automation { namespace Private
+{
+    static const uint32_t MAX_CLIENTS           = 8;
+    static const uint32_t MAX_REQUEST_LENGTH    = 4096;
+    // Time (ms) to wait for clients' activity before checking if the server needs to exit
+    static const uint32_t SELECT_TIMEOUT_MS     = 200;
+    // Time (ms) given to a client to send its request and receive response
+    static const uint32_t CLIENT_TIMEOUT_MS     = 5000;
+
+    // State of a single connected client
+    struct MetricsClient
+    {
+        socket_t                    Socket;
+        string                      Request;
+        string                      Response;
+        size_t                      ResponseSent;
+        bool                        IsDone;
+        steady_clock::time_point    ConnectedTime;
+
+        MetricsClient( socket_t socket ) :
+            Socket( socket ), Request( ), Response( ), ResponseSent( 0 ), IsDone( false ), ConnectedTime( steady_clock::now( ) )
+        {
+        }
+    };
+
+    class XMetricsHttpServerData : private Uncopyable
+    {
+    public:
+        XMetricsHttpServerData( const shared_ptr<XAutomationServer>& server ) :
+            Server( server ), ListenSocket( INVALID_SOCKET ), Port( 0 ),
+            Sync( ), RequestsServed( 0 ), NeedToExit( false ), ServerThread( ), Clients( )
+        {
+            ServerThread.SetName( "cvs-metrics" );
+        }
+
+        bool CreateSocket( uint16_t port, bool localOnly );
+        void CloseSocket( );
+
+        static void ServerThreadHandler( void* param );
+
+    private:
+        void AcceptClients( );
+        void ReadRequest( MetricsClient& client );
+        void SendResponse( MetricsClient& client );
+        void PrepareResponse( MetricsClient& client, const char* status, const string& body );
+
+    public:
+        const shared_ptr<XAutomationServer> Server;
+        socket_t                            ListenSocket;
+        uint16_t                            Port;
+
+        mutable XMutex                      Sync;
+        uint32_t                            RequestsServed;
+        volatile bool                       NeedToExit;
+        XThread                             ServerThread;
+
+    private:
+        list<MetricsClient>                 Clients;
+    };
+
+    // Switch the socket into non-blocking mode
+    static bool SetNonBlocking( socket_t socket )
+    {
+    #ifdef WIN32
+        u_long mode = 1;
+        return ( ioctlsocket( socket, FIONBIO, &mode ) == 0 );
+    #else
+        int flags = fcntl( socket, F_GETFL, 0 );
+        return ( flags != -1 ) && ( fcntl( socket, F_SETFL, flags | O_NONBLOCK ) == 0 );
+    #endif
+    }
+} } } // namespace CVSandbox::Automation::Private
+
+namespace CVSandbox { namespace Automation
+{
+
+XMetricsHttpServer::XMetricsHttpServer( const shared_ptr<XAutomationServer>& server ) :
+    mData( new XMetricsHttpServerData( server ) )
+{
+}
+
+XMetricsHttpServer::~XMetricsHttpServer( )
+{
+    Stop( );
+}
+
+const shared_ptr<XMetricsHttpServer> XMetricsHttpServer::Create( const shared_ptr<XAutomationServer>& server )
+{
+    shared_ptr<XMetricsHttpServer> metricsServer;
+
+    if ( server )
+    {
+        metricsServer.reset( new (nothrow) XMetricsHttpServer( server ) );
+    }
+
+    return metricsServer;
+}
+
+// Start serving metrics on the specified port
+XErrorCode XMetricsHttpServer::Start( uint16_t port, bool localOnly )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( mData->ServerThread.IsRunning( ) )
+    {
+        ret = ErrorFailed;
+    }
+    else
+    {
+#ifdef WIN32
+        WSADATA wsaData;
+
+        if ( WSAStartup( MAKEWORD( 2, 2 ), &wsaData ) != 0 )
+        {
+            return ErrorInitializationFailed;
+        }
+#endif
+
+        mData->NeedToExit     = false;
+        mData->RequestsServed = 0;
+
+        if ( !mData->CreateSocket( port, localOnly ) )
+        {
+            ret = ErrorConnectionFailed;
+        }
+        else if ( !mData->ServerThread.Create( XMetricsHttpServerData::ServerThreadHandler, mData.get( ) ) )
+        {
+            ret = ErrorInitializationFailed;
+        }
+        else
+        {
+            // scraping should not compete with video processing
+            mData->ServerThread.SetPriority( XThreadPriority::BelowNormal );
+            mData->Port = port;
+        }
+
+        if ( ret != SuccessCode )
+        {
+            mData->CloseSocket( );
+#ifdef WIN32
+            WSACleanup( );
+#endif
+        }
+    }
+
+    return ret;
+}
+
+// Stop the server and disconnect all clients
+void XMetricsHttpServer::Stop( )
+{
+    if ( mData->ServerThread.IsRunning( ) )
+    {
+        mData->NeedToExit = true;
+        mData->ServerThread.Join( );
+
+        mData->CloseSocket( );
+        mData->Port = 0;
+#ifdef WIN32
+        WSACleanup( );
+#endif
+    }
+}
+
+// Check if the server is running
+bool XMetricsHttpServer::IsRunning( ) const
+{
+    return mData->ServerThread.IsRunning( );
+}
+
+// Get port the server is listening on
+uint16_t XMetricsHttpServer::Port( ) const
+{
+    return mData->Port;
+}
+
+// Get number of metrics requests served since the server was started
+uint32_t XMetricsHttpServer::RequestsServed( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->RequestsServed;
+}
+
+} } // namespace CVSandbox::Automation
+
+namespace CVSandbox { namespace Automation { namespace Private
+{
+
+// Create listening socket
+bool XMetricsHttpServerData::CreateSocket( uint16_t port, bool localOnly )
+{
+    sockaddr_in address;
+    int         reuse = 1;
+    bool        ret   = false;
+
+    ListenSocket = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+
+    if ( ListenSocket != INVALID_SOCKET )
+    {
+        setsockopt( ListenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>( &reuse ), sizeof( reuse ) );
+
+        memset( &address, 0, sizeof( address ) );
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl( ( localOnly ) ? INADDR_LOOPBACK : INADDR_ANY );
+        address.sin_port        = htons( port );
+
+        if ( ( bind( ListenSocket, reinterpret_cast<sockaddr*>( &address ), sizeof( address ) ) == 0 ) &&
+             ( listen( ListenSocket, SOMAXCONN ) == 0 ) &&
+             ( SetNonBlocking( ListenSocket ) ) )
+        {
+            ret = true;
+        }
+    }
+
+    if ( !ret )
+    {
+        CloseSocket( );
+    }
+
+    return ret;
+}
+
+// Close listening socket
+void XMetricsHttpServerData::CloseSocket( )
+{
+    if ( ListenSocket != INVALID_SOCKET )
+    {
+        CLOSE_SOCKET( ListenSocket );
+        ListenSocket = INVALID_SOCKET;
+    }
+}
+
+// Server thread - accepts clients and answers their requests
+void XMetricsHttpServerData::ServerThreadHandler( void* param )
+{
+    XMetricsHttpServerData* self = static_cast<XMetricsHttpServerData*>( param );
+
+    while ( !self->NeedToExit )
+    {
+        fd_set   readSet;
+        fd_set   writeSet;
+        socket_t maxSocket = self->ListenSocket;
+        timeval  timeout   = { 0, SELECT_TIMEOUT_MS * 1000 };
+
+        FD_ZERO( &readSet );
+        FD_ZERO( &writeSet );
+        FD_SET( self->ListenSocket, &readSet );
+
+        for ( list<MetricsClient>::iterator it = self->Clients.begin( ); it != self->Clients.end( ); ++it )
+        {
+            if ( it->Response.empty( ) )
+            {
+                FD_SET( it->Socket, &readSet );
+            }
+            else
+            {
+                FD_SET( it->Socket, &writeSet );
+            }
+
+            maxSocket = XMAX( maxSocket, it->Socket );
+        }
+
+        if ( select( static_cast<int>( maxSocket + 1 ), &readSet, &writeSet, nullptr, &timeout ) == SOCKET_ERROR )
+        {
+            XThread::Sleep( 10 );
+            continue;
+        }
+
+        if ( FD_ISSET( self->ListenSocket, &readSet ) )
+        {
+            self->AcceptClients( );
+        }
+
+        for ( list<MetricsClient>::iterator it = self->Clients.begin( ); it != self->Clients.end( ); ++it )
+        {
+            if ( FD_ISSET( it->Socket, &readSet ) )
+            {
+                self->ReadRequest( *it );
+            }
+            else if ( FD_ISSET( it->Socket, &writeSet ) )
+            {
+                self->SendResponse( *it );
+            }
+        }
+
+        // remove served clients and those, which take too long
+        steady_clock::time_point now = steady_clock::now( );
+
+        for ( list<MetricsClient>::iterator it = self->Clients.begin( ); it != self->Clients.end( ); )
+        {
+            if ( ( it->IsDone ) || ( duration_cast<milliseconds>( now - it->ConnectedTime ).count( ) > CLIENT_TIMEOUT_MS ) )
+            {
+                CLOSE_SOCKET( it->Socket );
+                it = self->Clients.erase( it );
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    for ( list<MetricsClient>::iterator it = self->Clients.begin( ); it != self->Clients.end( ); ++it )
+    {
+        CLOSE_SOCKET( it->Socket );
+    }
+    self->Clients.clear( );
+}
+
+// Accept all pending connections
+void XMetricsHttpServerData::AcceptClients( )
+{
+    for ( ; ; )
+    {
+        socket_t clientSocket = accept( ListenSocket, nullptr, nullptr );
+
+        if ( clientSocket == INVALID_SOCKET )
+        {
+            break;
+        }
+
+        if ( ( Clients.size( ) >= MAX_CLIENTS ) || ( !SetNonBlocking( clientSocket ) ) )
+        {
+            CLOSE_SOCKET( clientSocket );
+        }
+        else
+        {
+        #ifdef SO_NOSIGPIPE
+            int noSigPipe = 1;
+            setsockopt( clientSocket, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof( noSigPipe ) );
+        #endif
+            Clients.push_back( MetricsClient( clientSocket ) );
+        }
+    }
+}
+
+// Read HTTP request from the client and prepare response to it
+void XMetricsHttpServerData::ReadRequest( MetricsClient& client )
+{
+    char buffer[512];
+    int  received = recv( client.Socket, buffer, sizeof( buffer ), 0 );
+
+    if ( received <= 0 )
+    {
+        // client disconnected or failed
+        if ( ( received == 0 ) || ( !WOULD_BLOCK( ) ) )
+        {
+            client.IsDone = true;
+        }
+    }
+    else
+    {
+        client.Request.append( buffer, received );
+
+        if ( client.Request.find( "\r\n\r\n" ) != string::npos )
+        {
+            char method[16] = { 0 };
+            char path[256]  = { 0 };
+
+            if ( ( sscanf( client.Request.c_str( ), "%15s %255s", method, path ) != 2 ) || ( strcmp( method, "GET" ) != 0 ) )
+            {
+                PrepareResponse( client, "405 Method Not Allowed", string( ) );
+            }
+            else
+            {
+                string uri( path );
+                size_t queryStart = uri.find( '?' );
+
+                if ( queryStart != string::npos )
+                {
+                    uri.erase( queryStart );
+                }
+
+                if ( uri == "/metrics" )
+                {
+                    PrepareResponse( client, "200 OK", Server->GetMetrics( ) );
+
+                    XScopedLock lock( &Sync );
+                    RequestsServed++;
+                }
+                else
+                {
+                    PrepareResponse( client, "404 Not Found", string( ) );
+                }
+            }
+
+            client.Request.clear( );
+            SendResponse( client );
+        }
+        else if ( client.Request.size( ) > MAX_REQUEST_LENGTH )
+        {
+            client.IsDone = true;
+        }
+    }
+}
+
+// Send as much of the response as the socket accepts without blocking
+void XMetricsHttpServerData::SendResponse( MetricsClient& client )
+{
+    while ( client.ResponseSent < client.Response.size( ) )
+    {
+        int sent = send( client.Socket, client.Response.c_str( ) + client.ResponseSent,
+                         static_cast<int>( client.Response.size( ) - client.ResponseSent ), SEND_FLAGS );
+
+        if ( sent <= 0 )
+        {
+            if ( ( sent == 0 ) || ( !WOULD_BLOCK( ) ) )
+            {
+                client.IsDone = true;
+            }
+            break;
+        }
+
+        client.ResponseSent += sent;
+    }
+
+    if ( client.ResponseSent == client.Response.size( ) )
+    {
+        client.IsDone = true;
+    }
+}
+
+// Prepare HTTP response with the specified status and body
+void XMetricsHttpServerData::PrepareResponse( MetricsClient& client, const char* status, const string& body )
+{
+    char header[256];
+
+    sprintf( header, "HTTP/1.0 %s\r\n"
+                     "Server: CVSandbox\r\n"
+                     "Connection: close\r\n"
+                     "Cache-Control: no-cache\r\n"
+                     "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                     "Content-Length: %u\r\n\r\n", status, static_cast<uint32_t>( body.size( ) ) );
+
+    client.Response.reserve( strlen( header ) + body.size( ) );
+    client.Response     = header;
+    client.Response    += body;
+    client.ResponseSent = 0;
+}
+
+} } } // namespace CVSandbox::Automation::Private
@@ -0,0 +1,72 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XMETRICS_HTTP_SERVER_HPP
+#define CVS_XMETRICS_HTTP_SERVER_HPP
+
+#include <stdint.h>
+#include <memory>
+#include <xtypes.h>
+#include <XInterfaces.hpp>
+
+namespace CVSandbox { namespace Automation
+{
+
+class XAutomationServer;
+
+namespace Private
+{
+    class XMetricsHttpServerData;
+}
+
+// Embedded HTTP server providing metrics of automation server in Prometheus text format on "GET /metrics"
+// requests. Requests are served by a single low priority thread - metrics are collected only when requested,
+// so there is no cost for video processing when nobody scrapes them.
+class XMetricsHttpServer : private CVSandbox::Uncopyable
+{
+private:
+    XMetricsHttpServer( const std::shared_ptr<XAutomationServer>& server );
+
+public:
+    ~XMetricsHttpServer( );
+
+    static const std::shared_ptr<XMetricsHttpServer> Create( const std::shared_ptr<XAutomationServer>& server );
+
+    // Start serving metrics on the specified port - on all network interfaces or on loopback interface only
+    XErrorCode Start( uint16_t port, bool localOnly = false );
+    // Stop the server and disconnect all clients
+    void Stop( );
+    // Check if the server is running
+    bool IsRunning( ) const;
+
+    // Get port the server is listening on
+    uint16_t Port( ) const;
+    // Get number of metrics requests served since the server was started
+    uint32_t RequestsServed( ) const;
+
+private:
+    const std::auto_ptr<Private::XMetricsHttpServerData> mData;
+};
+
+} } // namespace CVSandbox::Automation
+
+#endif // CVS_XMETRICS_HTTP_SERVER_HPP
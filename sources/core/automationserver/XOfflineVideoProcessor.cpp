@@ -0,0 +1,596 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XOfflineVideoProcessor.hpp"
+#include "XAutomationServer.hpp"
+#include "XVideoSourceProcessingGraph.hpp"
+#include "XVideoSourceFrameInfo.hpp"
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+#include <XMutex.hpp>
+#include <XManualResetEvent.hpp>
+#include <XError.hpp>
+
+using namespace std;
+using namespace CVSandbox;
+using namespace CVSandbox::Threading;
+using namespace CVSandbox::Automation::Private;
+
+namespace CVSandbox { namespace Automation { namespace Private
+{
+    // Names of video source's properties/functions used for splitting video into segments
+    static const char* STR_PROP_END_FRAME          = "endFrame";
+    static const char* STR_PROP_OVERRIDE_INTERVAL  = "overrideFrameInterval";
+    static const char* STR_PROP_FRAME_INTERVAL     = "frameInterval";
+    static const char* STR_FUNC_SEEK_TO_FRAME      = "SeekToFrame";
+    static const char* STR_FUNC_GET_KEY_FRAMES     = "GetKeyFrames";
+
+    // Time (ms) to wait for new results, before checking if a segment is complete
+    static const uint32_t RESULTS_WAIT_TIME = 100;
+
+    class XOfflineVideoProcessorData;
+
+    // A segment of video, which is processed by its own automation server
+    class VideoSegment : public IAutomationVideoSourceListener,
+                         public IAutomationVariablesListener,
+                         private CVSandbox::Uncopyable
+    {
+    public:
+        VideoSegment( XOfflineVideoProcessorData* owner, uint32_t firstFrame, uint32_t endFrame ) :
+            Owner( owner ), FirstFrame( firstFrame ), EndFrame( endFrame ),
+            Server( ), VideoSource( ), VideoSourceId( 0 ), Sync( ), Results( ), PendingVariables( ),
+            FramesProvided( 0 ), IsFinalizing( false ), ErrorMessage( ), ResultsAvailable( ), SpaceAvailable( )
+        {
+        }
+
+        // Create automation server and start the segment's video source
+        XErrorCode Start( const shared_ptr<const XPluginDescriptor>& videoSourceDescriptor,
+                          const map<string, XVariant>& videoSourceConfiguration,
+                          const XVideoSourceProcessingGraph& graph, bool seekToFirstFrame );
+        // Stop the automation server and wait till it finalizes
+        void Finalize( );
+        // Wake up video processing thread, if it waits for buffer space
+        void ReleaseWaiting( );
+
+        // Take results collected so far - the most recent one is kept until the segment completes, so
+        // errors reported after the frame notification are attached to it
+        bool TakeResults( deque<XOfflineFrameResult>& results );
+
+        // IAutomationVideoSourceListener interface
+        virtual void OnNewVideoFrame( uint32_t videoSourceId, const shared_ptr<const XImage>& image );
+        virtual void OnErrorMessage( uint32_t videoSourceId, const string& errorMessage );
+
+        // IAutomationVariablesListener interface
+        virtual void OnVariableSet( const string& name, const XVariant& value );
+        virtual void OnClearAllVariables( );
+
+    public:
+        XOfflineVideoProcessorData*     Owner;
+        uint32_t                        FirstFrame;
+        uint32_t                        EndFrame;
+
+        shared_ptr<XAutomationServer>   Server;
+        shared_ptr<XVideoSourcePlugin>  VideoSource;
+        uint32_t                        VideoSourceId;
+
+        XMutex                          Sync;
+        deque<XOfflineFrameResult>      Results;
+        vector<pair<string, XVariant>>  PendingVariables;
+        uint32_t                        FramesProvided;
+        bool                            IsFinalizing;
+        string                          ErrorMessage;   // error reported before any frame was provided
+
+        XManualResetEvent               ResultsAvailable;
+        XManualResetEvent               SpaceAvailable;
+    };
+
+    class XOfflineVideoProcessorData
+    {
+    public:
+        XOfflineVideoProcessorData( const shared_ptr<XPluginsEngine>& pluginsEngine, const string& hostName, const xversion& hostVersion ) :
+            PluginsEngine( pluginsEngine ), HostName( hostName ), HostVersion( hostVersion ),
+            SegmentsCount( 4 ), ProvideImages( false ), MaxBufferedFrames( 0 ), NeedToStop( false ), Sync( )
+        {
+        }
+
+        // Get frame numbers to start segments from
+        vector<uint32_t> PlanSegments( const shared_ptr<const XPluginDescriptor>& videoSourceDescriptor,
+                                       const map<string, XVariant>& videoSourceConfiguration,
+                                       uint32_t segmentsCount );
+
+    public:
+        shared_ptr<XPluginsEngine>  PluginsEngine;
+        string                      HostName;
+        xversion                    HostVersion;
+
+        uint32_t                    SegmentsCount;
+        bool                        ProvideImages;
+        uint32_t                    MaxBufferedFrames;
+        volatile bool               NeedToStop;
+
+        XMutex                      Sync;
+        vector<VideoSegment*>       RunningSegments;
+    };
+} } }
+
+namespace CVSandbox { namespace Automation
+{
+
+XOfflineVideoProcessor::XOfflineVideoProcessor( const shared_ptr<XPluginsEngine>& pluginsEngine, const string& hostName, const xversion& hostVersion ) :
+    mData( new XOfflineVideoProcessorData( pluginsEngine, hostName, hostVersion ) )
+{
+}
+
+XOfflineVideoProcessor::~XOfflineVideoProcessor( )
+{
+}
+
+const shared_ptr<XOfflineVideoProcessor> XOfflineVideoProcessor::Create( const shared_ptr<XPluginsEngine>& pluginsEngine, const string& hostName, const xversion& hostVersion )
+{
+    return shared_ptr<XOfflineVideoProcessor>( new (nothrow) XOfflineVideoProcessor( pluginsEngine, hostName, hostVersion ) );
+}
+
+// Get/Set maximum number of segments to process in parallel
+uint32_t XOfflineVideoProcessor::SegmentsCount( ) const
+{
+    return mData->SegmentsCount;
+}
+void XOfflineVideoProcessor::SetSegmentsCount( uint32_t segmentsCount )
+{
+    mData->SegmentsCount = XMAX( segmentsCount, 1u );
+}
+
+// Enable/disable providing processed images to the listener
+bool XOfflineVideoProcessor::IsImagesOutputEnabled( ) const
+{
+    return mData->ProvideImages;
+}
+void XOfflineVideoProcessor::EnableImagesOutput( bool enable )
+{
+    mData->ProvideImages = enable;
+}
+
+// Get/Set maximum number of frames' results buffered by a segment
+uint32_t XOfflineVideoProcessor::MaxBufferedFrames( ) const
+{
+    return mData->MaxBufferedFrames;
+}
+void XOfflineVideoProcessor::SetMaxBufferedFrames( uint32_t maxBufferedFrames )
+{
+    mData->MaxBufferedFrames = maxBufferedFrames;
+}
+
+// Check if the processing graph allows splitting video into independently processed segments
+bool XOfflineVideoProcessor::IsGraphSplittable( const XVideoSourceProcessingGraph& graph ) const
+{
+    bool ret = true;
+
+    if ( mData->PluginsEngine )
+    {
+        for ( auto stepIt = graph.begin( ), endIt = graph.end( ); ( stepIt != endIt ) && ( ret ); ++stepIt )
+        {
+            shared_ptr<const XPluginDescriptor> pluginDesc = mData->PluginsEngine->GetPlugin( stepIt->PluginId( ) );
+
+            if ( ( pluginDesc ) && ( ( pluginDesc->Flags( ) & PluginFlag_NotSplittable ) != 0 ) )
+            {
+                ret = false;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Process the video provided by the video source plug-in with the specified configuration
+XErrorCode XOfflineVideoProcessor::Process( const shared_ptr<const XPluginDescriptor>& videoSourceDescriptor,
+                                            const map<string, XVariant>& videoSourceConfiguration,
+                                            const XVideoSourceProcessingGraph& graph,
+                                            IOfflineProcessingListener* listener )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( !videoSourceDescriptor ) || ( listener == nullptr ) || ( !mData->PluginsEngine ) )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( videoSourceDescriptor->Type( ) != PluginType_VideoSource )
+    {
+        ret = ErrorInvalidArgument;
+    }
+    else
+    {
+        uint32_t         segmentsCount = ( IsGraphSplittable( graph ) ) ? mData->SegmentsCount : 1;
+        vector<uint32_t> firstFrames   = mData->PlanSegments( videoSourceDescriptor, videoSourceConfiguration, segmentsCount );
+        bool             split         = ( firstFrames.size( ) > 1 );
+
+        mData->NeedToStop = false;
+
+        // create and start all segments
+        {
+            XScopedLock lock( &mData->Sync );
+
+            for ( size_t i = 0; i < firstFrames.size( ); i++ )
+            {
+                uint32_t endFrame = ( i + 1 < firstFrames.size( ) ) ? firstFrames[i + 1] : 0;
+
+                mData->RunningSegments.push_back( new VideoSegment( mData.get( ), firstFrames[i], endFrame ) );
+            }
+
+            for ( auto segment : mData->RunningSegments )
+            {
+                XErrorCode ecode = segment->Start( videoSourceDescriptor, videoSourceConfiguration, graph, split );
+
+                if ( ( ecode != SuccessCode ) && ( ret == SuccessCode ) )
+                {
+                    ret = ecode;
+                }
+            }
+        }
+
+        // merge results of the segments in order
+        if ( ret == SuccessCode )
+        {
+            deque<XOfflineFrameResult> results;
+
+            for ( size_t i = 0; ( i < mData->RunningSegments.size( ) ) && ( !mData->NeedToStop ); i++ )
+            {
+                VideoSegment* segment  = mData->RunningSegments[i];
+                bool          complete = false;
+
+                while ( ( !complete ) && ( !mData->NeedToStop ) )
+                {
+                    segment->ResultsAvailable.Wait( RESULTS_WAIT_TIME );
+
+                    complete = segment->TakeResults( results );
+
+                    while ( ( !results.empty( ) ) && ( !mData->NeedToStop ) )
+                    {
+                        listener->OnFrameProcessed( results.front( ) );
+                        results.pop_front( );
+                    }
+                }
+
+                // nothing came from the segment - failed starting video or decoding it
+                if ( ( complete ) && ( segment->FramesProvided == 0 ) && ( !segment->ErrorMessage.empty( ) ) )
+                {
+                    ret = ErrorFailed;
+                }
+            }
+        }
+
+        // stop everything, which may still run
+        mData->NeedToStop = true;
+
+        {
+            XScopedLock lock( &mData->Sync );
+
+            for ( auto segment : mData->RunningSegments )
+            {
+                segment->Finalize( );
+                delete segment;
+            }
+
+            mData->RunningSegments.clear( );
+        }
+    }
+
+    return ret;
+}
+
+// Signal running processing to stop
+void XOfflineVideoProcessor::SignalToStop( )
+{
+    XScopedLock lock( &mData->Sync );
+
+    mData->NeedToStop = true;
+
+    for ( auto segment : mData->RunningSegments )
+    {
+        segment->ReleaseWaiting( );
+    }
+}
+
+} } // namespace CVSandbox::Automation
+
+namespace CVSandbox { namespace Automation { namespace Private
+{
+
+// Get frame numbers to start segments from
+vector<uint32_t> XOfflineVideoProcessorData::PlanSegments( const shared_ptr<const XPluginDescriptor>& videoSourceDescriptor,
+                                                           const map<string, XVariant>& videoSourceConfiguration,
+                                                           uint32_t segmentsCount )
+{
+    vector<uint32_t> firstFrames;
+    int32_t          getKeyFramesId = videoSourceDescriptor->GetFunctionIndexByName( STR_FUNC_GET_KEY_FRAMES );
+
+    firstFrames.push_back( 0 );
+
+    if ( ( segmentsCount > 1 ) && ( getKeyFramesId != -1 ) &&
+         ( videoSourceDescriptor->GetFunctionIndexByName( STR_FUNC_SEEK_TO_FRAME ) != -1 ) &&
+         ( videoSourceDescriptor->GetPropertyIndexByName( STR_PROP_END_FRAME ) != -1 ) )
+    {
+        shared_ptr<XPlugin> videoSource = videoSourceDescriptor->CreateInstance( );
+
+        if ( videoSource )
+        {
+            XVariant keyFramesVar;
+            xarray   noArguments = { XVT_Any, nullptr, 0 };
+
+            videoSourceDescriptor->SetPluginConfiguration( videoSource, videoSourceConfiguration );
+
+            if ( ( videoSource->CallFunction( getKeyFramesId, &keyFramesVar, &noArguments ) == SuccessCode ) &&
+                 ( keyFramesVar.Type( ) == ( XVT_Array | XVT_U4 ) ) )
+            {
+                const xarray*    keyFramesArray = static_cast<const xvariant*>( keyFramesVar )->value.arrayVal;
+                vector<uint32_t> keyFrames;
+
+                for ( uint32_t i = 0; i < keyFramesArray->length; i++ )
+                {
+                    keyFrames.push_back( keyFramesArray->elements[i].value.uiVal );
+                }
+
+                sort( keyFrames.begin( ), keyFrames.end( ) );
+
+                if ( keyFrames.size( ) > 1 )
+                {
+                    // estimate length of the video assuming its last group of frames is of average size
+                    uint32_t lastKeyFrame = keyFrames.back( );
+                    uint32_t framesTotal  = lastKeyFrame + lastKeyFrame / static_cast<uint32_t>( keyFrames.size( ) - 1 );
+
+                    // start every segment at the first key frame after its ideal start
+                    for ( uint32_t i = 1; i < segmentsCount; i++ )
+                    {
+                        uint32_t idealStart = static_cast<uint32_t>( static_cast<uint64_t>( framesTotal ) * i / segmentsCount );
+                        auto     keyFrameIt = lower_bound( keyFrames.begin( ), keyFrames.end( ), idealStart );
+
+                        if ( ( keyFrameIt != keyFrames.end( ) ) && ( *keyFrameIt > firstFrames.back( ) ) )
+                        {
+                            firstFrames.push_back( *keyFrameIt );
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return firstFrames;
+}
+
+// Create automation server and start the segment's video source
+XErrorCode VideoSegment::Start( const shared_ptr<const XPluginDescriptor>& videoSourceDescriptor,
+                                const map<string, XVariant>& videoSourceConfiguration,
+                                const XVideoSourceProcessingGraph& graph, bool seekToFirstFrame )
+{
+    XErrorCode          ret    = ErrorOutOfMemory;
+    shared_ptr<XPlugin> plugin = videoSourceDescriptor->CreateInstance( );
+
+    Server      = XAutomationServer::Create( Owner->PluginsEngine, Owner->HostName, Owner->HostVersion );
+    VideoSource = static_pointer_cast<XVideoSourcePlugin>( plugin );
+
+    if ( ( Server ) && ( VideoSource ) )
+    {
+        int32_t overrideIntervalId = videoSourceDescriptor->GetPropertyIndexByName( STR_PROP_OVERRIDE_INTERVAL );
+        int32_t frameIntervalId    = videoSourceDescriptor->GetPropertyIndexByName( STR_PROP_FRAME_INTERVAL );
+
+        videoSourceDescriptor->SetPluginConfiguration( VideoSource, videoSourceConfiguration );
+
+        // don't wait between frames - processing is done as fast as possible
+        if ( ( overrideIntervalId != -1 ) && ( frameIntervalId != -1 ) )
+        {
+            VideoSource->SetProperty( overrideIntervalId, XVariant( true ) );
+            VideoSource->SetProperty( frameIntervalId, XVariant( static_cast<uint16_t>( 0 ) ) );
+        }
+
+        if ( seekToFirstFrame )
+        {
+            xvariant frameArgument;
+            xarray   arguments = { XVT_U4, &frameArgument, 1 };
+
+            frameArgument.type        = XVT_U4;
+            frameArgument.value.uiVal = FirstFrame;
+
+            VideoSource->SetProperty( videoSourceDescriptor->GetPropertyIndexByName( STR_PROP_END_FRAME ), XVariant( EndFrame ) );
+            VideoSource->CallFunction( videoSourceDescriptor->GetFunctionIndexByName( STR_FUNC_SEEK_TO_FRAME ), nullptr, &arguments );
+        }
+
+        ret = Server->Start( );
+
+        if ( ret == SuccessCode )
+        {
+            VideoSourceId = Server->AddVideoSource( videoSourceDescriptor, VideoSource );
+
+            Server->SetVideoProcessingGraph( VideoSourceId, graph );
+            Server->EnableVideoFrameDropping( VideoSourceId, false );
+            Server->AddVideoSourceListener( VideoSourceId, this, false );
+            Server->SetVariablesListener( this );
+
+            if ( !Server->StartVideoSource( VideoSourceId ) )
+            {
+                ret = ErrorFailed;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Stop the automation server and wait till it finalizes
+void VideoSegment::Finalize( )
+{
+    {
+        XScopedLock lock( &Sync );
+        IsFinalizing = true;
+    }
+
+    SpaceAvailable.Signal( );
+
+    if ( Server )
+    {
+        Server->ClearVariablesListener( );
+        Server->FinalizeVideoSource( VideoSourceId );
+        Server->WaitForStop( );
+    }
+}
+
+// Wake up video processing thread, if it waits for buffer space
+void VideoSegment::ReleaseWaiting( )
+{
+    SpaceAvailable.Signal( );
+}
+
+// Take results collected so far
+bool VideoSegment::TakeResults( deque<XOfflineFrameResult>& results )
+{
+    bool     complete = false;
+    bool     sourceStopped;
+    uint32_t framesReceived;
+
+    {
+        XScopedLock lock( &Sync );
+
+        while ( Results.size( ) > 1 )
+        {
+            results.push_back( std::move( Results.front( ) ) );
+            Results.pop_front( );
+        }
+
+        ResultsAvailable.Reset( );
+        SpaceAvailable.Signal( );
+    }
+
+    // check video source's state without holding the lock - the source calls us (indirectly) while holding its
+    // own lock and it may wait for the processing thread, which could be waiting for the space we've just freed
+    sourceStopped  = ( ( !VideoSource ) || ( !VideoSource->IsRunning( ) ) );
+    framesReceived = ( VideoSource ) ? VideoSource->FramesReceived( ) : 0;
+
+    if ( sourceStopped )
+    {
+        XScopedLock lock( &Sync );
+
+        if ( FramesProvided >= framesReceived )
+        {
+            complete = true;
+
+            while ( !Results.empty( ) )
+            {
+                results.push_back( std::move( Results.front( ) ) );
+                Results.pop_front( );
+            }
+        }
+    }
+
+    return complete;
+}
+
+// New video frame was processed by the segment's automation server
+void VideoSegment::OnNewVideoFrame( uint32_t videoSourceId, const shared_ptr<const XImage>& image )
+{
+    XUNREFERENCED_PARAMETER( videoSourceId )
+
+    {
+        XScopedLock         lock( &Sync );
+        XVideoSourceFrameInfo frameInfo;
+        XOfflineFrameResult frameResult;
+
+        if ( IsFinalizing )
+        {
+            return;
+        }
+
+        frameResult.FrameNumber = FirstFrame + FramesProvided;
+        frameResult.Variables.swap( PendingVariables );
+
+        if ( ( Owner->ProvideImages ) && ( image ) )
+        {
+            frameResult.Image = image->Clone( );
+        }
+
+        if ( Server->GetVideoSourceFrameInfo( VideoSourceId, &frameInfo ) )
+        {
+            frameResult.TriggeredDetectionSteps.swap( frameInfo.TriggeredDetectionSteps );
+        }
+
+        Results.push_back( std::move( frameResult ) );
+        FramesProvided++;
+
+        ResultsAvailable.Signal( );
+    }
+
+    // block processing of the segment if too many results are waiting to be merged
+    while ( Owner->MaxBufferedFrames != 0 )
+    {
+        {
+            XScopedLock lock( &Sync );
+
+            if ( ( IsFinalizing ) || ( Owner->NeedToStop ) || ( Results.size( ) <= Owner->MaxBufferedFrames ) )
+            {
+                break;
+            }
+
+            SpaceAvailable.Reset( );
+        }
+
+        SpaceAvailable.Wait( );
+    }
+}
+
+// Error reported by the segment's video source or processing graph
+void VideoSegment::OnErrorMessage( uint32_t videoSourceId, const string& errorMessage )
+{
+    XUNREFERENCED_PARAMETER( videoSourceId )
+
+    // reaching end of the video is not an error for offline processing
+    if ( errorMessage != XError::Description( ErrorEOF ) )
+    {
+        XScopedLock lock( &Sync );
+
+        if ( !Results.empty( ) )
+        {
+            string& frameError = Results.back( ).ErrorMessage;
+
+            if ( !frameError.empty( ) )
+            {
+                frameError.append( "\n" );
+            }
+            frameError.append( errorMessage );
+        }
+        else if ( FramesProvided == 0 )
+        {
+            ErrorMessage = errorMessage;
+        }
+    }
+}
+
+// Host variable was set by the segment's processing graph
+void VideoSegment::OnVariableSet( const string& name, const XVariant& value )
+{
+    XScopedLock lock( &Sync );
+    PendingVariables.push_back( pair<string, XVariant>( name, value ) );
+}
+
+// Segment's host variables were cleared
+void VideoSegment::OnClearAllVariables( )
+{
+}
+
+} } } // namespace CVSandbox::Automation::Private
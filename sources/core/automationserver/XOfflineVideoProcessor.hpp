@@ -0,0 +1,100 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XOFFLINE_VIDEO_PROCESSOR_HPP
+#define CVS_XOFFLINE_VIDEO_PROCESSOR_HPP
+
+#include <memory>
+#include <map>
+#include <xtypes.h>
+#include <XInterfaces.hpp>
+#include <XVariant.hpp>
+
+#include <XPluginsEngine.hpp>
+
+#include "IOfflineProcessingListener.hpp"
+
+namespace CVSandbox { namespace Automation
+{
+
+class XVideoSourceProcessingGraph;
+
+namespace Private
+{
+    class XOfflineVideoProcessorData;
+}
+
+// Runs video processing graph on a video file as fast as possible. The video is split at key
+// frames into segments, which are processed in parallel - each segment by its own video source
+// and its own instance of the processing graph. Outputs of the graph are merged and provided
+// to the listener in the order of video frames.
+//
+// Splitting requires video source to provide "endFrame" property and "SeekToFrame"/"GetKeyFrames"
+// functions (like the "Video File" plug-in does). If it does not or any of the graph's steps is
+// declared with PluginFlag_NotSplittable, the video is processed as a single segment.
+// Note: scripts of the graph run independently in every segment, starting from a fresh state.
+class XOfflineVideoProcessor : private CVSandbox::Uncopyable
+{
+private:
+    XOfflineVideoProcessor( const std::shared_ptr<XPluginsEngine>& pluginsEngine, const std::string& hostName, const xversion& hostVersion );
+
+public:
+    ~XOfflineVideoProcessor( );
+
+    static const std::shared_ptr<XOfflineVideoProcessor> Create( const std::shared_ptr<XPluginsEngine>& pluginsEngine,
+                                                                 const std::string& hostName = std::string( ),
+                                                                 const xversion& hostVersion = { 0, 0, 0 } );
+
+    // Get/Set maximum number of segments to process in parallel
+    uint32_t SegmentsCount( ) const;
+    void SetSegmentsCount( uint32_t segmentsCount );
+
+    // Enable/disable providing processed images to the listener (disabled by default)
+    bool IsImagesOutputEnabled( ) const;
+    void EnableImagesOutput( bool enable );
+
+    // Get/Set maximum number of frames' results buffered by a segment, which waits for previous
+    // segments to be completed (0 - no limit). Limiting it saves memory when images are provided,
+    // but makes segments wait for each other.
+    uint32_t MaxBufferedFrames( ) const;
+    void SetMaxBufferedFrames( uint32_t maxBufferedFrames );
+
+    // Check if the processing graph allows splitting video into independently processed segments
+    bool IsGraphSplittable( const XVideoSourceProcessingGraph& graph ) const;
+
+    // Process the video provided by the video source plug-in with the specified configuration.
+    // The call blocks until all segments are processed or processing is signalled to stop.
+    XErrorCode Process( const std::shared_ptr<const XPluginDescriptor>& videoSourceDescriptor,
+                        const std::map<std::string, CVSandbox::XVariant>& videoSourceConfiguration,
+                        const XVideoSourceProcessingGraph& graph,
+                        IOfflineProcessingListener* listener );
+
+    // Signal running processing to stop (can be called from the listener or any other thread)
+    void SignalToStop( );
+
+private:
+    const std::auto_ptr<Private::XOfflineVideoProcessorData> mData;
+};
+
+} } // namespace CVSandbox::Automation
+
+#endif // CVS_XOFFLINE_VIDEO_PROCESSOR_HPP
@@ -0,0 +1,356 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XStepCaptureCase.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+using namespace CVSandbox;
+
+namespace CVSandbox { namespace Automation
+{
+
+namespace Private
+{
+    // The first line of capture files
+    static const char*  CAPTURE_FILE_SIGNATURE = "CVSandbox step capture 1";
+    // Headers longer than this are not expected (the limit protects from reading wrong files)
+    static const size_t MAX_HEADER_LENGTH      = 16 * 1024 * 1024;
+
+    // Escape new lines, so any value can be saved as single line of the header
+    static string EscapeValue( const string& value )
+    {
+        string escaped;
+
+        escaped.reserve( value.size( ) );
+
+        for ( string::const_iterator it = value.begin( ); it != value.end( ); ++it )
+        {
+            switch ( *it )
+            {
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            default:   escaped += *it; break;
+            }
+        }
+
+        return escaped;
+    }
+
+    static string UnescapeValue( const string& value )
+    {
+        string unescaped;
+
+        unescaped.reserve( value.size( ) );
+
+        for ( size_t i = 0, n = value.size( ); i < n; i++ )
+        {
+            if ( ( value[i] == '\\' ) && ( i + 1 < n ) )
+            {
+                i++;
+
+                switch ( value[i] )
+                {
+                case 'n':  unescaped += '\n'; break;
+                case 'r':  unescaped += '\r'; break;
+                default:   unescaped += value[i]; break;
+                }
+            }
+            else
+            {
+                unescaped += value[i];
+            }
+        }
+
+        return unescaped;
+    }
+
+    // Read single line of header (without the new line character)
+    static bool ReadHeaderLine( FILE* file, string& line, size_t& headerLength )
+    {
+        int c;
+
+        line.clear( );
+
+        while ( ( ( c = fgetc( file ) ) != EOF ) && ( c != '\n' ) )
+        {
+            line += static_cast<char>( c );
+        }
+
+        headerLength += line.size( ) + 1;
+
+        return ( ( c == '\n' ) && ( headerLength <= MAX_HEADER_LENGTH ) );
+    }
+}
+
+XStepCaptureCase::XStepCaptureCase( ) :
+    Reason( XStepCaptureReason::Error ), VideoSourceId( 0 ), StepIndex( -1 ), StepName( ), PluginId( ), PluginName( ),
+    ErrorCode( SuccessCode ), ErrorMessage( ), TimeTaken( 0.0f ), LatencyThreshold( 0.0f ), Timestamps( ),
+    Configuration( ), Image( )
+{
+}
+
+// Save case into the specified file
+XErrorCode XStepCaptureCase::Save( const string& fileName ) const
+{
+    XErrorCode ret  = SuccessCode;
+    FILE*      file = nullptr;
+
+    if ( !Image )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( ( file = fopen( fileName.c_str( ), "wb" ) ) == nullptr )
+    {
+        ret = ErrorIOFailure;
+    }
+    else
+    {
+        const ximage* image        = Image->ImageData( );
+        uint32_t      lineSize     = XImageBytesPerLine( image->width * XImageBitsPerPixel( image->format ) );
+        int32_t       paletteSize  = ( image->palette != nullptr ) ? image->palette->colorsCount : 0;
+        bool          writtenAll   = true;
+
+        fprintf( file, "%s\n", Private::CAPTURE_FILE_SIGNATURE );
+        fprintf( file, "reason=%s\n", ( Reason == XStepCaptureReason::Slow ) ? "slow" : "error" );
+        fprintf( file, "videoSource=%u\n", VideoSourceId );
+        fprintf( file, "step=%d\n", StepIndex );
+        fprintf( file, "stepName=%s\n", Private::EscapeValue( StepName ).c_str( ) );
+        fprintf( file, "pluginId=%s\n", PluginId.ToString( ).c_str( ) );
+        fprintf( file, "pluginName=%s\n", Private::EscapeValue( PluginName ).c_str( ) );
+        fprintf( file, "errorCode=%d\n", static_cast<int>( ErrorCode ) );
+        fprintf( file, "errorMessage=%s\n", Private::EscapeValue( ErrorMessage ).c_str( ) );
+        fprintf( file, "timeTaken=%.3f\n", TimeTaken );
+        fprintf( file, "latencyThreshold=%.3f\n", LatencyThreshold );
+        fprintf( file, "captured=%lld\n", static_cast<long long>( Timestamps.Captured ) );
+        fprintf( file, "arrived=%lld\n", static_cast<long long>( Timestamps.Arrived ) );
+        fprintf( file, "processingStarted=%lld\n", static_cast<long long>( Timestamps.ProcessingStarted ) );
+        fprintf( file, "processingFinished=%lld\n", static_cast<long long>( Timestamps.ProcessingFinished ) );
+
+        // properties are saved same way as cvsandbox saves them into project - type and value converted to string
+        for ( map<string, XVariant>::const_iterator it = Configuration.begin( ); it != Configuration.end( ); ++it )
+        {
+            fprintf( file, "property=%s %d %s\n", it->first.c_str( ), static_cast<int>( it->second.Type( ) ),
+                     Private::EscapeValue( it->second.ToString( ) ).c_str( ) );
+        }
+
+        fprintf( file, "pixelFormat=%s\n", XImage::PixelFormatName( image->format ).c_str( ) );
+        fprintf( file, "image=%d %d %d %d\n", image->width, image->height, static_cast<int>( image->format ), paletteSize );
+
+        // image lines are saved without stride's padding
+        for ( int32_t y = 0; ( y < image->height ) && ( writtenAll ); y++ )
+        {
+            writtenAll = ( fwrite( image->data + y * image->stride, 1, lineSize, file ) == lineSize );
+        }
+
+        for ( int32_t i = 0; ( i < paletteSize ) && ( writtenAll ); i++ )
+        {
+            writtenAll = ( fwrite( &image->palette->values[i].argb, sizeof( uint32_t ), 1, file ) == 1 );
+        }
+
+        if ( ( fclose( file ) != 0 ) || ( !writtenAll ) )
+        {
+            ret = ErrorIOFailure;
+        }
+    }
+
+    return ret;
+}
+
+// Load case from the specified file
+XErrorCode XStepCaptureCase::Load( const string& fileName )
+{
+    XErrorCode ret  = SuccessCode;
+    FILE*      file = fopen( fileName.c_str( ), "rb" );
+
+    if ( file == nullptr )
+    {
+        ret = ErrorIOFailure;
+    }
+    else
+    {
+        string line;
+        size_t headerLength = 0;
+        bool   gotImage     = false;
+
+        *this = XStepCaptureCase( );
+
+        if ( ( !Private::ReadHeaderLine( file, line, headerLength ) ) || ( line != Private::CAPTURE_FILE_SIGNATURE ) )
+        {
+            ret = ErrorInvalidFormat;
+        }
+
+        while ( ( ret == SuccessCode ) && ( !gotImage ) )
+        {
+            size_t separator;
+
+            if ( ( !Private::ReadHeaderLine( file, line, headerLength ) ) || ( ( separator = line.find( '=' ) ) == string::npos ) )
+            {
+                ret = ErrorInvalidFormat;
+                break;
+            }
+
+            string key   = line.substr( 0, separator );
+            string value = line.substr( separator + 1 );
+
+            if ( key == "reason" )
+            {
+                Reason = ( value == "slow" ) ? XStepCaptureReason::Slow : XStepCaptureReason::Error;
+            }
+            else if ( key == "videoSource" )
+            {
+                VideoSourceId = static_cast<uint32_t>( strtoul( value.c_str( ), nullptr, 10 ) );
+            }
+            else if ( key == "step" )
+            {
+                StepIndex = static_cast<int32_t>( strtol( value.c_str( ), nullptr, 10 ) );
+            }
+            else if ( key == "stepName" )
+            {
+                StepName = Private::UnescapeValue( value );
+            }
+            else if ( key == "pluginId" )
+            {
+                PluginId = XGuid::FromString( value );
+            }
+            else if ( key == "pluginName" )
+            {
+                PluginName = Private::UnescapeValue( value );
+            }
+            else if ( key == "errorCode" )
+            {
+                ErrorCode = static_cast<XErrorCode>( strtol( value.c_str( ), nullptr, 10 ) );
+            }
+            else if ( key == "errorMessage" )
+            {
+                ErrorMessage = Private::UnescapeValue( value );
+            }
+            else if ( key == "timeTaken" )
+            {
+                TimeTaken = static_cast<float>( atof( value.c_str( ) ) );
+            }
+            else if ( key == "latencyThreshold" )
+            {
+                LatencyThreshold = static_cast<float>( atof( value.c_str( ) ) );
+            }
+            else if ( key == "captured" )
+            {
+                Timestamps.Captured = strtoll( value.c_str( ), nullptr, 10 );
+            }
+            else if ( key == "arrived" )
+            {
+                Timestamps.Arrived = strtoll( value.c_str( ), nullptr, 10 );
+            }
+            else if ( key == "processingStarted" )
+            {
+                Timestamps.ProcessingStarted = strtoll( value.c_str( ), nullptr, 10 );
+            }
+            else if ( key == "processingFinished" )
+            {
+                Timestamps.ProcessingFinished = strtoll( value.c_str( ), nullptr, 10 );
+            }
+            else if ( key == "property" )
+            {
+                size_t nameEnd = value.find( ' ' );
+                size_t typeEnd = ( nameEnd == string::npos ) ? string::npos : value.find( ' ', nameEnd + 1 );
+
+                if ( typeEnd == string::npos )
+                {
+                    ret = ErrorInvalidFormat;
+                }
+                else
+                {
+                    XVarType   type       = static_cast<XVarType>( atoi( value.substr( nameEnd + 1, typeEnd - nameEnd - 1 ).c_str( ) ) );
+                    XVariant   strVariant( Private::UnescapeValue( value.substr( typeEnd + 1 ) ) );
+                    XErrorCode ec;
+                    XVariant   propValue  = strVariant.ChangeType( type, &ec );
+
+                    if ( ec != SuccessCode )
+                    {
+                        ret = ec;
+                    }
+                    else
+                    {
+                        Configuration.insert( pair<string, XVariant>( value.substr( 0, nameEnd ), propValue ) );
+                    }
+                }
+            }
+            else if ( key == "image" )
+            {
+                int width = 0, height = 0, format = 0, paletteSize = 0;
+
+                if ( ( sscanf( value.c_str( ), "%d %d %d %d", &width, &height, &format, &paletteSize ) != 4 ) ||
+                     ( width <= 0 ) || ( height <= 0 ) || ( paletteSize < 0 ) || ( paletteSize > 256 ) )
+                {
+                    ret = ErrorInvalidFormat;
+                }
+                else if ( !( Image = XImage::Allocate( width, height, static_cast<XPixelFormat>( format ) ) ) )
+                {
+                    ret = ErrorOutOfMemory;
+                }
+                else
+                {
+                    ximage*  image    = Image->ImageData( );
+                    uint32_t lineSize = XImageBytesPerLine( image->width * XImageBitsPerPixel( image->format ) );
+
+                    for ( int32_t y = 0; ( y < image->height ) && ( ret == SuccessCode ); y++ )
+                    {
+                        if ( fread( image->data + y * image->stride, 1, lineSize, file ) != lineSize )
+                        {
+                            ret = ErrorIOFailure;
+                        }
+                    }
+
+                    if ( ( ret == SuccessCode ) && ( paletteSize != 0 ) )
+                    {
+                        if ( ( ret = XPalleteAllocate( paletteSize, &image->palette ) ) == SuccessCode )
+                        {
+                            for ( int32_t i = 0; ( i < paletteSize ) && ( ret == SuccessCode ); i++ )
+                            {
+                                if ( fread( &image->palette->values[i].argb, sizeof( uint32_t ), 1, file ) != 1 )
+                                {
+                                    ret = ErrorIOFailure;
+                                }
+                            }
+                        }
+                    }
+
+                    gotImage = true;
+                }
+            }
+            // unknown keys are skipped, so newer files could be still read
+        }
+
+        fclose( file );
+
+        if ( ret != SuccessCode )
+        {
+            Image.reset( );
+        }
+    }
+
+    return ret;
+}
+
+} } // namespace CVSandbox::Automation
@@ -0,0 +1,110 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XSTEP_CAPTURE_CASE_HPP
+#define CVS_XSTEP_CAPTURE_CASE_HPP
+
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <memory>
+#include <xtypes.h>
+#include <XGuid.hpp>
+#include <XVariant.hpp>
+#include <XImage.hpp>
+
+#include "XVideoSourceFrameInfo.hpp"
+
+namespace CVSandbox { namespace Automation
+{
+
+// Configuration of capturing video processing steps, which fail or run longer than expected
+struct XStepCaptureConfiguration
+{
+    // Folder to save captured cases to (empty - capturing is disabled)
+    std::string Folder;
+    // Max number of cases kept in the folder - new cases overwrite the oldest ones
+    uint32_t    MaxCases;
+    // Time (ms) a step may take before it is captured as slow one (0 - capture only failed steps)
+    float       LatencyThreshold;
+
+    XStepCaptureConfiguration( ) :
+        Folder( ), MaxCases( 16 ), LatencyThreshold( 0.0f )
+    {
+    }
+};
+
+// Statistics of capturing processing steps
+struct XStepCaptureInfo
+{
+    // Number of cases saved, dropped since previous ones were still being saved and failed to be saved
+    uint32_t CasesSaved;
+    uint32_t CasesDropped;
+    uint32_t CasesFailed;
+
+    XStepCaptureInfo( ) :
+        CasesSaved( 0 ), CasesDropped( 0 ), CasesFailed( 0 )
+    {
+    }
+};
+
+// Why video processing step was captured
+enum class XStepCaptureReason
+{
+    Error = 0,
+    Slow
+};
+
+// Video processing step, which failed or ran over the latency threshold, along with its input frame and
+// configuration, so it could be run again in isolation. Cases are saved into files, which start with
+// text header (one "key=value" per line, so can be inspected with any text viewer) followed by raw image data.
+class XStepCaptureCase
+{
+public:
+    XStepCaptureCase( );
+
+    // Save case into the specified file or load it from there
+    XErrorCode Save( const std::string& fileName ) const;
+    XErrorCode Load( const std::string& fileName );
+
+public:
+    XStepCaptureReason                          Reason;
+    uint32_t                                    VideoSourceId;
+    int32_t                                     StepIndex;
+    std::string                                 StepName;
+    CVSandbox::XGuid                            PluginId;
+    std::string                                 PluginName;
+    XErrorCode                                  ErrorCode;
+    std::string                                 ErrorMessage;
+    // Time (ms) taken by the step and the threshold it was checked against
+    float                                       TimeTaken;
+    float                                       LatencyThreshold;
+    XVideoFrameTimestamps                       Timestamps;
+    // Configuration of the step's plug-in at the time it was captured
+    std::map<std::string, CVSandbox::XVariant>  Configuration;
+    // Frame given to the step
+    std::shared_ptr<CVSandbox::XImage>          Image;
+};
+
+} } // namespace CVSandbox::Automation
+
+#endif // CVS_XSTEP_CAPTURE_CASE_HPP
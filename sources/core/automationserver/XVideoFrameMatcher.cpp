@@ -0,0 +1,285 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XVideoFrameMatcher.hpp"
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+
+using namespace std;
+using namespace CVSandbox;
+
+namespace CVSandbox { namespace Automation
+{
+
+namespace Private
+{
+    // Number of matched groups to average skew over
+    static const size_t SKEW_HISTORY_LENGTH = 40;
+}
+
+XVideoFrameMatcher::XVideoFrameMatcher( const vector<uint32_t>& videoSourceIds ) :
+    mVideoSourceIds( videoSourceIds ),
+    mTolerance( 20 ), mPolicy( XFrameSyncPolicy::DropUnmatched ), mTimeout( 100 ), mBufferLength( 4 ),
+    mBuffers( videoSourceIds.size( ) ), mInfo( ), mSkewHistory( ), mSkewHistoryIndex( 0 )
+{
+}
+
+// Set synchronization policy and time to wait for missing frames
+void XVideoFrameMatcher::SetPolicy( XFrameSyncPolicy policy, uint32_t msecTimeout )
+{
+    mPolicy  = policy;
+    mTimeout = msecTimeout;
+}
+
+// Set maximum number of frames buffered for every video source
+void XVideoFrameMatcher::SetBufferLength( uint32_t bufferLength )
+{
+    mBufferLength = XMAX( bufferLength, 1u );
+}
+
+// Put new frame of the specified video source into its buffer
+bool XVideoFrameMatcher::AddFrame( uint32_t videoSourceId, const shared_ptr<const XImage>& image, const XVideoFrameTimestamps& timestamps )
+{
+    // the same video source may be in the group only once
+    vector<uint32_t>::const_iterator it  = find( mVideoSourceIds.begin( ), mVideoSourceIds.end( ), videoSourceId );
+    bool                             ret = false;
+
+    if ( ( it != mVideoSourceIds.end( ) ) && ( image ) )
+    {
+        deque<BufferedFrame>& buffer = mBuffers[it - mVideoSourceIds.begin( )];
+
+        while ( buffer.size( ) >= mBufferLength )
+        {
+            buffer.pop_front( );
+            mInfo.FramesDropped++;
+        }
+
+        buffer.push_back( BufferedFrame( ) );
+        buffer.back( ).Image      = image;
+        buffer.back( ).Timestamps = timestamps;
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+// Match buffered frames and collect groups to provide
+void XVideoFrameMatcher::MatchFrames( int64_t now, vector<XSynchronizedFrames>& matchedFrames )
+{
+    const int64_t   tolerance  = static_cast<int64_t>( mTolerance ) * 1000;
+    const size_t    count      = mBuffers.size( );
+    vector<bool>    takeMask( count );
+
+    for ( ; ; )
+    {
+        bool allAvailable = true;
+
+        for ( size_t i = 0; i < count; i++ )
+        {
+            allAvailable &= !mBuffers[i].empty( );
+        }
+
+        if ( allAvailable )
+        {
+            // match around the newest of the oldest frames - older frames of other video sources can not
+            // match anything else, since the video source providing the newest frame has nothing older
+            int64_t matchTime   = mBuffers[0].front( ).Timestamps.Captured;
+            int64_t newestTime;
+            bool    allMatching = true;
+
+            for ( size_t i = 1; i < count; i++ )
+            {
+                matchTime = std::max( matchTime, mBuffers[i].front( ).Timestamps.Captured );
+            }
+
+            newestTime = matchTime;
+
+            for ( size_t i = 0; i < count; i++ )
+            {
+                deque<BufferedFrame>& buffer = mBuffers[i];
+
+                // skip frames if the next one is even closer to the match time
+                while ( ( buffer.size( ) > 1 ) && ( matchTime - buffer[1].Timestamps.Captured >= 0 ) )
+                {
+                    buffer.pop_front( );
+                    mInfo.FramesDropped++;
+                }
+
+                if ( ( buffer.size( ) > 1 ) &&
+                     ( buffer[1].Timestamps.Captured - matchTime < matchTime - buffer[0].Timestamps.Captured ) )
+                {
+                    buffer.pop_front( );
+                    mInfo.FramesDropped++;
+                }
+
+                // the closest frame may be older or newer than the match time
+                takeMask[i]  = ( std::abs( buffer.front( ).Timestamps.Captured - matchTime ) <= tolerance );
+                allMatching &= takeMask[i];
+                newestTime   = std::max( newestTime, buffer.front( ).Timestamps.Captured );
+            }
+
+            if ( allMatching )
+            {
+                matchedFrames.push_back( XSynchronizedFrames( ) );
+                TakeFrames( takeMask, matchedFrames.back( ) );
+            }
+            else
+            {
+                // frames too old to match the newest of the closest frames can not be matched at all, while
+                // the newest ones are kept for the next match (some frame is always dropped, since one of the
+                // closest frames is either too old or too new for the frame providing match time)
+                for ( size_t i = 0; i < count; i++ )
+                {
+                    if ( newestTime - mBuffers[i].front( ).Timestamps.Captured > tolerance )
+                    {
+                        mBuffers[i].pop_front( );
+                        mInfo.FramesDropped++;
+                    }
+                }
+            }
+        }
+        else if ( mPolicy == XFrameSyncPolicy::WaitWithTimeout )
+        {
+            // find the oldest buffered frame and check if it waited long enough for frames of other video sources
+            int oldestIndex = -1;
+
+            for ( size_t i = 0; i < count; i++ )
+            {
+                if ( ( !mBuffers[i].empty( ) ) &&
+                     ( ( oldestIndex == -1 ) || ( mBuffers[i].front( ).Timestamps.Arrived < mBuffers[oldestIndex].front( ).Timestamps.Arrived ) ) )
+                {
+                    oldestIndex = static_cast<int>( i );
+                }
+            }
+
+            if ( ( oldestIndex == -1 ) || ( now - mBuffers[oldestIndex].front( ).Timestamps.Arrived < static_cast<int64_t>( mTimeout ) * 1000 ) )
+            {
+                break;
+            }
+
+            // provide the oldest frame along with any other frames matching it
+            {
+                int64_t matchTime = mBuffers[oldestIndex].front( ).Timestamps.Captured;
+
+                for ( size_t i = 0; i < count; i++ )
+                {
+                    takeMask[i] = ( ( !mBuffers[i].empty( ) ) &&
+                                    ( std::abs( mBuffers[i].front( ).Timestamps.Captured - matchTime ) <= tolerance ) );
+                }
+
+                matchedFrames.push_back( XSynchronizedFrames( ) );
+                TakeFrames( takeMask, matchedFrames.back( ) );
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+// Remove all buffered frames
+void XVideoFrameMatcher::ClearBuffers( )
+{
+    for ( auto& buffer : mBuffers )
+    {
+        buffer.clear( );
+    }
+}
+
+// Reset statistics
+void XVideoFrameMatcher::ResetInfo( )
+{
+    mInfo = XVideoSourceSyncGroupInfo( );
+    mSkewHistory.clear( );
+    mSkewHistoryIndex = 0;
+}
+
+// Take the front frames specified by the mask of buffers to the group of frames
+void XVideoFrameMatcher::TakeFrames( const vector<bool>& takeMask, XSynchronizedFrames& frames )
+{
+    const size_t count      = mBuffers.size( );
+    int64_t      oldestTime = 0;
+    int64_t      newestTime = 0;
+    bool         first      = true;
+
+    frames.VideoSourceIds = mVideoSourceIds;
+    frames.Images.resize( count );
+    frames.Timestamps.resize( count );
+
+    for ( size_t i = 0; i < count; i++ )
+    {
+        if ( takeMask[i] )
+        {
+            frames.Images[i]     = mBuffers[i].front( ).Image;
+            frames.Timestamps[i] = mBuffers[i].front( ).Timestamps;
+            mBuffers[i].pop_front( );
+
+            if ( first )
+            {
+                oldestTime = newestTime = frames.Timestamps[i].Captured;
+                first = false;
+            }
+            else
+            {
+                oldestTime = std::min( oldestTime, frames.Timestamps[i].Captured );
+                newestTime = std::max( newestTime, frames.Timestamps[i].Captured );
+            }
+        }
+        else
+        {
+            frames.IsPartial = true;
+        }
+    }
+
+    frames.Skew = static_cast<float>( newestTime - oldestTime ) / 1000.0f;
+
+    if ( frames.IsPartial )
+    {
+        mInfo.PartialFramesProvided++;
+    }
+    else
+    {
+        mInfo.FramesProvided++;
+        UpdateSkewStatistics( frames.Skew );
+    }
+}
+
+// Update skew statistics with the skew of just matched frames
+void XVideoFrameMatcher::UpdateSkewStatistics( float skew )
+{
+    if ( mSkewHistory.size( ) < Private::SKEW_HISTORY_LENGTH )
+    {
+        mSkewHistory.push_back( skew );
+    }
+    else
+    {
+        mSkewHistory[mSkewHistoryIndex++] = skew;
+        mSkewHistoryIndex %= Private::SKEW_HISTORY_LENGTH;
+    }
+
+    mInfo.AverageSkew = std::accumulate( mSkewHistory.begin( ), mSkewHistory.end( ), 0.0f ) / mSkewHistory.size( );
+    mInfo.MaxSkew     = *std::max_element( mSkewHistory.begin( ), mSkewHistory.end( ) );
+}
+
+} } // namespace CVSandbox::Automation
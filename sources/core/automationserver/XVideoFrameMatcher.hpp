@@ -0,0 +1,129 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XVIDEO_FRAME_MATCHER_HPP
+#define CVS_XVIDEO_FRAME_MATCHER_HPP
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <XInterfaces.hpp>
+#include <XImage.hpp>
+
+#include "IVideoSourceSyncGroupListener.hpp"
+
+namespace CVSandbox { namespace Automation
+{
+
+// What to do when some of the group's video sources don't provide frames to match
+enum class XFrameSyncPolicy
+{
+    // Provide only complete groups of frames - frames, which can not be matched, are dropped
+    DropUnmatched = 0,
+    // Wait for missing frames up to the timeout and then provide a partial group of frames
+    WaitWithTimeout
+};
+
+// Statistics of a synchronization group
+struct XVideoSourceSyncGroupInfo
+{
+    // Number of complete and partial groups of frames provided to the listener
+    uint32_t FramesProvided;
+    uint32_t PartialFramesProvided;
+    // Number of video frames dropped, since they could not be matched with frames of other video sources
+    uint32_t FramesDropped;
+    // Skew (ms) between frames of recent complete groups
+    float    AverageSkew;
+    float    MaxSkew;
+
+    XVideoSourceSyncGroupInfo( ) :
+        FramesProvided( 0 ), PartialFramesProvided( 0 ), FramesDropped( 0 ), AverageSkew( 0.0f ), MaxSkew( 0.0f )
+    {
+    }
+};
+
+// Buffers video frames of several video sources and matches them by capture time. A frame of every video source
+// is taken into a group if its capture time differs by no more than the tolerance from the match time - the newest
+// of the oldest buffered frames.
+//
+// The class is not thread safe - XVideoSourceSyncGroup uses it under its own lock.
+class XVideoFrameMatcher : private CVSandbox::Uncopyable
+{
+public:
+    XVideoFrameMatcher( const std::vector<uint32_t>& videoSourceIds );
+
+    // Get/Set maximum difference of frames' capture time (ms) to consider them as matching
+    uint32_t Tolerance( ) const { return mTolerance; }
+    void SetTolerance( uint32_t msecTolerance ) { mTolerance = msecTolerance; }
+
+    // Get/Set synchronization policy and time to wait for missing frames (ms) for the WaitWithTimeout policy
+    XFrameSyncPolicy Policy( ) const { return mPolicy; }
+    uint32_t Timeout( ) const { return mTimeout; }
+    void SetPolicy( XFrameSyncPolicy policy, uint32_t msecTimeout );
+
+    // Get/Set maximum number of frames buffered for every video source (the oldest frame is dropped when buffer is full)
+    uint32_t BufferLength( ) const { return mBufferLength; }
+    void SetBufferLength( uint32_t bufferLength );
+
+    // Get statistics of matched/dropped frames
+    const XVideoSourceSyncGroupInfo& Info( ) const { return mInfo; }
+
+    // Put new frame of the specified video source into its buffer (returns false if the video source is not in the group)
+    bool AddFrame( uint32_t videoSourceId, const std::shared_ptr<const CVSandbox::XImage>& image, const XVideoFrameTimestamps& timestamps );
+
+    // Match buffered frames and collect groups to provide (current time is used to check timeout of partial groups)
+    void MatchFrames( int64_t now, std::vector<XSynchronizedFrames>& matchedFrames );
+
+    // Remove all buffered frames
+    void ClearBuffers( );
+    // Reset statistics
+    void ResetInfo( );
+
+private:
+    // Take the front frames specified by the mask of buffers to the group of frames
+    void TakeFrames( const std::vector<bool>& takeMask, XSynchronizedFrames& frames );
+    void UpdateSkewStatistics( float skew );
+
+private:
+    // Video frame buffered for matching
+    struct BufferedFrame
+    {
+        std::shared_ptr<const CVSandbox::XImage> Image;
+        XVideoFrameTimestamps                    Timestamps;
+    };
+
+    std::vector<uint32_t>                   mVideoSourceIds;
+    uint32_t                                mTolerance;
+    XFrameSyncPolicy                        mPolicy;
+    uint32_t                                mTimeout;
+    uint32_t                                mBufferLength;
+
+    std::vector<std::deque<BufferedFrame>>  mBuffers;           // frames of every video source waiting to be matched
+    XVideoSourceSyncGroupInfo               mInfo;
+    std::vector<float>                      mSkewHistory;
+    size_t                                  mSkewHistoryIndex;
+};
+
+} } // namespace CVSandbox::Automation
+
+#endif // CVS_XVIDEO_FRAME_MATCHER_HPP
@@ -24,11 +24,29 @@
 #define CVS_XVIDEO_SOURCE_FRAME_INFO_HPP
 
 #include <stdint.h>
+#include <vector>
 #include <ximage.h>
 
 namespace CVSandbox { namespace Automation
 {
 
+// Time stamps of a video frame on its way from video source to listeners (XTimestampNow() time stamps, microseconds)
+struct XVideoFrameTimestamps
+{
+    // Frame was captured by video source (or received from it, if video source does not tell)
+    int64_t Captured;
+    // Frame arrived to the automation server
+    int64_t Arrived;
+    // Processing graph started/finished processing the frame
+    int64_t ProcessingStarted;
+    int64_t ProcessingFinished;
+
+    XVideoFrameTimestamps( ) :
+        Captured( 0 ), Arrived( 0 ), ProcessingStarted( 0 ), ProcessingFinished( 0 )
+    {
+    }
+};
+
 struct XVideoSourceFrameInfo
 {
     // Total number of video frames received
@@ -42,12 +60,32 @@ struct XVideoSourceFrameInfo
     int32_t      ProcessedFrameHeight;
     XPixelFormat ProcessedPixelFormat;
     uint32_t     VideoProcessingStepsDone;
+    // Number of frames dropped or reduced to fit into frame memory budget of the server
+    uint32_t     FramesThrottled;
+    // Number of errors reported by video source and processing steps
+    uint32_t     ErrorsReported;
+    // Memory (bytes) taken by video frames of the video source
+    uint64_t     FrameMemoryUsed;
+    // Indexes of detection steps, which triggered on the last processed frame
+    std::vector<int32_t> TriggeredDetectionSteps;
+    // Time stamps of the last processed frame
+    XVideoFrameTimestamps LastFrameTimestamps;
+    // Latency (ms) averaged over recent frames: capture to arrival (decoding, delivery by video source),
+    // arrival to processing start (waiting for processing thread), processing and total capture to processing end
+    float        AverageSourceLatency;
+    float        AverageQueueLatency;
+    float        AverageProcessingLatency;
+    float        AverageTotalLatency;
+    // Maximum total latency of recent frames
+    float        MaxTotalLatency;
 
     XVideoSourceFrameInfo( ) :
         FramesReceived( 0 ), FramesDropped( 0 ), FramesBlocked( 0 ),
         OriginalFrameWidth( 0 ), OriginalFrameHeight( 0 ), OriginalPixelFormat( XPixelFormatUnknown ),
         ProcessedFrameWidth( 0 ), ProcessedFrameHeight( 0 ), ProcessedPixelFormat( XPixelFormatUnknown ),
-        VideoProcessingStepsDone( 0 )
+        VideoProcessingStepsDone( 0 ), FramesThrottled( 0 ), ErrorsReported( 0 ), FrameMemoryUsed( 0 ), TriggeredDetectionSteps( ),
+        LastFrameTimestamps( ), AverageSourceLatency( 0.0f ), AverageQueueLatency( 0.0f ),
+        AverageProcessingLatency( 0.0f ), AverageTotalLatency( 0.0f ), MaxTotalLatency( 0.0f )
     {
     }
 };
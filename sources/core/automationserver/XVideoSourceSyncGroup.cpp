@@ -0,0 +1,333 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "XVideoSourceSyncGroup.hpp"
+#include "XAutomationServer.hpp"
+#include <vector>
+
+#include <XMutex.hpp>
+#include <XManualResetEvent.hpp>
+#include <XThread.hpp>
+#include <xtimestamp.h>
+
+using namespace std;
+using namespace CVSandbox;
+using namespace CVSandbox::Threading;
+using namespace CVSandbox::Automation::Private;
+
+namespace CVSandbox { namespace Automation { namespace Private
+{
+    // Length of mailboxes the group uses to get frames from video sources (frames are taken quickly from them)
+    static const uint32_t MAILBOX_QUEUE_LENGTH    = 2;
+    // Time (ms) to wait for new frames, before checking if buffered frames have timed out
+    static const uint32_t MAX_TIMEOUT_CHECK_PERIOD = 20;
+
+    class XVideoSourceSyncGroupData : public IAutomationVideoSourceListener, private Uncopyable
+    {
+    public:
+        XVideoSourceSyncGroupData( const shared_ptr<XAutomationServer>& server, const vector<uint32_t>& videoSourceIds ) :
+            Server( server ), VideoSourceIds( videoSourceIds ), Listener( nullptr ),
+            Sync( ), Matcher( videoSourceIds ),
+            NewFrameEvent( ), NeedToExit( false ), IsRunning( false ), SyncThread( )
+        {
+            SyncThread.SetName( "cvs-vsync" );
+        }
+
+        // IAutomationVideoSourceListener interface
+        virtual void OnNewVideoFrame( uint32_t videoSourceId, const shared_ptr<const XImage>& image );
+        virtual void OnNewVideoFrame( uint32_t videoSourceId, const shared_ptr<const XImage>& image, const XVideoFrameTimestamps& timestamps );
+        virtual void OnErrorMessage( uint32_t videoSourceId, const string& errorMessage );
+
+        // Unsubscribe from the specified number of video sources
+        void Unsubscribe( size_t count );
+
+        static void SyncThreadHandler( void* param );
+
+    public:
+        shared_ptr<XAutomationServer>   Server;
+        vector<uint32_t>                VideoSourceIds;
+        IVideoSourceSyncGroupListener*  Listener;
+
+        mutable XMutex                  Sync;                   // mutex to protect matcher (buffers, settings and statistics)
+        XVideoFrameMatcher              Matcher;
+
+        XManualResetEvent               NewFrameEvent;
+        volatile bool                   NeedToExit;
+        bool                            IsRunning;
+        XThread                         SyncThread;
+    };
+} } }
+
+namespace CVSandbox { namespace Automation
+{
+
+XVideoSourceSyncGroup::XVideoSourceSyncGroup( const shared_ptr<XAutomationServer>& server, const vector<uint32_t>& videoSourceIds ) :
+    mData( new XVideoSourceSyncGroupData( server, videoSourceIds ) )
+{
+}
+
+XVideoSourceSyncGroup::~XVideoSourceSyncGroup( )
+{
+    Stop( );
+}
+
+const shared_ptr<XVideoSourceSyncGroup> XVideoSourceSyncGroup::Create( const shared_ptr<XAutomationServer>& server,
+                                                                       const vector<uint32_t>& videoSourceIds )
+{
+    shared_ptr<XVideoSourceSyncGroup> group;
+
+    if ( ( server ) && ( !videoSourceIds.empty( ) ) )
+    {
+        group.reset( new (nothrow) XVideoSourceSyncGroup( server, videoSourceIds ) );
+    }
+
+    return group;
+}
+
+// Get/Set maximum difference of frames' capture time (ms) to consider them as matching
+uint32_t XVideoSourceSyncGroup::Tolerance( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->Matcher.Tolerance( );
+}
+void XVideoSourceSyncGroup::SetTolerance( uint32_t msecTolerance )
+{
+    XScopedLock lock( &mData->Sync );
+    mData->Matcher.SetTolerance( msecTolerance );
+}
+
+// Get/Set synchronization policy and time to wait for missing frames
+XFrameSyncPolicy XVideoSourceSyncGroup::Policy( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->Matcher.Policy( );
+}
+uint32_t XVideoSourceSyncGroup::Timeout( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->Matcher.Timeout( );
+}
+void XVideoSourceSyncGroup::SetPolicy( XFrameSyncPolicy policy, uint32_t msecTimeout )
+{
+    XScopedLock lock( &mData->Sync );
+    mData->Matcher.SetPolicy( policy, msecTimeout );
+}
+
+// Get/Set maximum number of frames buffered for every video source
+uint32_t XVideoSourceSyncGroup::BufferLength( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->Matcher.BufferLength( );
+}
+void XVideoSourceSyncGroup::SetBufferLength( uint32_t bufferLength )
+{
+    XScopedLock lock( &mData->Sync );
+
+    if ( !mData->IsRunning )
+    {
+        mData->Matcher.SetBufferLength( bufferLength );
+    }
+}
+
+// Start synchronizing frames of the video sources
+XErrorCode XVideoSourceSyncGroup::Start( IVideoSourceSyncGroupListener* listener )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( listener == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( mData->IsRunning )
+    {
+        ret = ErrorFailed;
+    }
+    else
+    {
+        mData->Listener   = listener;
+        mData->NeedToExit = false;
+        mData->NewFrameEvent.Reset( );
+
+        {
+            XScopedLock lock( &mData->Sync );
+            mData->Matcher.ResetInfo( );
+        }
+
+        if ( !mData->SyncThread.Create( XVideoSourceSyncGroupData::SyncThreadHandler, mData.get( ) ) )
+        {
+            ret = ErrorInitializationFailed;
+        }
+        else
+        {
+            size_t subscribed = 0;
+
+            for ( ; subscribed < mData->VideoSourceIds.size( ); subscribed++ )
+            {
+                if ( !mData->Server->AddVideoSourceListener( mData->VideoSourceIds[subscribed],
+                                                             static_cast<IAutomationVideoSourceListener*>( mData.get( ) ),
+                                                             false, MAILBOX_QUEUE_LENGTH ) )
+                {
+                    break;
+                }
+            }
+
+            if ( subscribed != mData->VideoSourceIds.size( ) )
+            {
+                // one of the video sources is not known to the server
+                mData->Unsubscribe( subscribed );
+
+                mData->NeedToExit = true;
+                mData->NewFrameEvent.Signal( );
+                mData->SyncThread.Join( );
+
+                ret = ErrorInvalidConfiguration;
+            }
+            else
+            {
+                XScopedLock lock( &mData->Sync );
+                mData->IsRunning = true;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Stop synchronizing frames
+void XVideoSourceSyncGroup::Stop( )
+{
+    if ( mData->IsRunning )
+    {
+        // unsubscribe first (without holding the lock), so no new frames come
+        mData->Unsubscribe( mData->VideoSourceIds.size( ) );
+
+        mData->NeedToExit = true;
+        mData->NewFrameEvent.Signal( );
+        mData->SyncThread.Join( );
+
+        {
+            XScopedLock lock( &mData->Sync );
+
+            mData->Matcher.ClearBuffers( );
+            mData->IsRunning = false;
+        }
+
+        mData->Listener = nullptr;
+    }
+}
+
+// Check if the group is running
+bool XVideoSourceSyncGroup::IsRunning( ) const
+{
+    return mData->IsRunning;
+}
+
+// Get statistics of the group
+XVideoSourceSyncGroupInfo XVideoSourceSyncGroup::GetInfo( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->Matcher.Info( );
+}
+
+} } // namespace CVSandbox::Automation
+
+namespace CVSandbox { namespace Automation { namespace Private
+{
+
+// Unsubscribe from the specified number of video sources
+void XVideoSourceSyncGroupData::Unsubscribe( size_t count )
+{
+    for ( size_t i = 0; i < count; i++ )
+    {
+        Server->RemoveVideoSourceListener( VideoSourceIds[i], static_cast<IAutomationVideoSourceListener*>( this ) );
+    }
+}
+
+// New video frame notification without time stamps - should not happen, since the server provides them
+void XVideoSourceSyncGroupData::OnNewVideoFrame( uint32_t videoSourceId, const shared_ptr<const XImage>& image )
+{
+    XVideoFrameTimestamps timestamps;
+
+    timestamps.Captured = timestamps.Arrived = XTimestampNow( );
+
+    OnNewVideoFrame( videoSourceId, image, timestamps );
+}
+
+// New video frame notification - put the frame into the buffer of its video source
+void XVideoSourceSyncGroupData::OnNewVideoFrame( uint32_t videoSourceId, const shared_ptr<const XImage>& image, const XVideoFrameTimestamps& timestamps )
+{
+    XScopedLock lock( &Sync );
+
+    if ( Matcher.AddFrame( videoSourceId, image, timestamps ) )
+    {
+        NewFrameEvent.Signal( );
+    }
+}
+
+// Video source error notification - nothing to do about it
+void XVideoSourceSyncGroupData::OnErrorMessage( uint32_t videoSourceId, const string& errorMessage )
+{
+    XUNREFERENCED_PARAMETER( videoSourceId )
+    XUNREFERENCED_PARAMETER( errorMessage )
+}
+
+// Synchronization thread - matches buffered frames and provides them to the listener
+void XVideoSourceSyncGroupData::SyncThreadHandler( void* param )
+{
+    XVideoSourceSyncGroupData*  self = static_cast<XVideoSourceSyncGroupData*>( param );
+    vector<XSynchronizedFrames> matchedFrames;
+
+    while ( !self->NeedToExit )
+    {
+        uint32_t checkPeriod;
+
+        {
+            XScopedLock lock( &self->Sync );
+
+            self->NewFrameEvent.Reset( );
+            self->Matcher.MatchFrames( XTimestampNow( ), matchedFrames );
+
+            checkPeriod = ( self->Matcher.Policy( ) == XFrameSyncPolicy::WaitWithTimeout ) ?
+                          XINRANGE( self->Matcher.Timeout( ) / 2, 1, MAX_TIMEOUT_CHECK_PERIOD ) : MAX_TIMEOUT_CHECK_PERIOD;
+        }
+
+        // provide matched frames without holding the lock, so video sources are not blocked by the listener
+        for ( auto& frames : matchedFrames )
+        {
+            if ( self->NeedToExit )
+            {
+                break;
+            }
+
+            self->Listener->OnSynchronizedFrames( frames );
+        }
+
+        // release frames, so the server could reuse them
+        matchedFrames.clear( );
+
+        if ( !self->NeedToExit )
+        {
+            self->NewFrameEvent.Wait( checkPeriod );
+        }
+    }
+}
+
+} } } // namespace CVSandbox::Automation::Private
@@ -0,0 +1,92 @@
+/*
+    Automation server library of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_XVIDEO_SOURCE_SYNC_GROUP_HPP
+#define CVS_XVIDEO_SOURCE_SYNC_GROUP_HPP
+
+#include <memory>
+#include <vector>
+#include <xtypes.h>
+#include <XInterfaces.hpp>
+
+#include "IVideoSourceSyncGroupListener.hpp"
+#include "XVideoFrameMatcher.hpp"
+
+namespace CVSandbox { namespace Automation
+{
+
+class XAutomationServer;
+
+namespace Private
+{
+    class XVideoSourceSyncGroupData;
+}
+
+// Synchronizes video frames of several video sources running by automation server (stereo, multi-view
+// setups). Frames of every video source are buffered and matched by capture time (see XVideoFrameMatcher)
+// - frames are grouped if their capture time differs from the match time by no more than the tolerance. Groups
+// of matched frames are provided to the listener on a separate thread, so video processing is not blocked.
+//
+// Frames are taken after the processing graphs of video sources (if any) and are shared with the automation
+// server's frame pool, so nothing is cloned by the group itself.
+class XVideoSourceSyncGroup : private CVSandbox::Uncopyable
+{
+private:
+    XVideoSourceSyncGroup( const std::shared_ptr<XAutomationServer>& server, const std::vector<uint32_t>& videoSourceIds );
+
+public:
+    ~XVideoSourceSyncGroup( );
+
+    static const std::shared_ptr<XVideoSourceSyncGroup> Create( const std::shared_ptr<XAutomationServer>& server,
+                                                                const std::vector<uint32_t>& videoSourceIds );
+
+    // Get/Set maximum difference of frames' capture time (ms) to consider them as matching
+    uint32_t Tolerance( ) const;
+    void SetTolerance( uint32_t msecTolerance );
+
+    // Get/Set synchronization policy and time to wait for missing frames (ms) for the WaitWithTimeout policy
+    XFrameSyncPolicy Policy( ) const;
+    uint32_t Timeout( ) const;
+    void SetPolicy( XFrameSyncPolicy policy, uint32_t msecTimeout = 100 );
+
+    // Get/Set maximum number of frames buffered for every video source, while waiting for frames of other
+    // video sources (the oldest frame is dropped when buffer is full). Can be changed only when not running.
+    uint32_t BufferLength( ) const;
+    void SetBufferLength( uint32_t bufferLength );
+
+    // Start synchronizing frames of the video sources - the group subscribes to them as listener
+    XErrorCode Start( IVideoSourceSyncGroupListener* listener );
+    // Stop synchronizing frames (must not be called from the listener)
+    void Stop( );
+    // Check if the group is running
+    bool IsRunning( ) const;
+
+    // Get statistics of the group
+    XVideoSourceSyncGroupInfo GetInfo( ) const;
+
+private:
+    const std::auto_ptr<Private::XVideoSourceSyncGroupData> mData;
+};
+
+} } // namespace CVSandbox::Automation
+
+#endif // CVS_XVIDEO_SOURCE_SYNC_GROUP_HPP
@@ -4,7 +4,8 @@
 VPATH = ../../
 
 # source files
-SRC =  XAutomationServer.cpp XVideoSourceProcessingGraph.cpp XVideoSourceProcessingStep.cpp
+SRC =  XAutomationServer.cpp XOfflineVideoProcessor.cpp XVideoSourceProcessingGraph.cpp XVideoSourceProcessingStep.cpp \
+	XVideoSourceSyncGroup.cpp XVideoFrameMatcher.cpp XMetricsHttpServer.cpp XStepCaptureCase.cpp
 
 # additional include folders
 INCLUDES = -I../../../../afx/afx_types -I../../../../afx/afx_types+ \
@@ -42,7 +42,8 @@ public:
         int32_t propsCount = 0, PropertyDescriptor** props = 0,
         PluginInitializationHandler init = 0, PluginCleanupHandler cleanup = 0,
         PropertyDescriptorUpdater updater = 0,
-        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0 ) : cleanupHandler( cleanup )
+        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0,
+        PluginFlags flags = PluginFlag_None ) : cleanupHandler( cleanup )
     {
         if ( init != 0 )
         {
@@ -67,7 +68,8 @@ public:
             props,
             updater,
             functionsCount,
-            funcs
+            funcs,
+            flags
         };
 
         RegisterPlugin( &desc );
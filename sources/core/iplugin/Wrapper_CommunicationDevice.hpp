@@ -126,12 +126,13 @@ public:
         int32_t propsCount = 0, PropertyDescriptor** props = 0,
         PluginInitializationHandler init = 0, PluginCleanupHandler cleanup = 0,
         PropertyDescriptorUpdater updater = 0,
-        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0 )
+        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0,
+        PluginFlags flags = PluginFlag_None )
         :
         PluginRegisterAndWrapper( id, family, type, version, name, shortName,
                                   description, help, creator,
                                   smallIcon, icon, propsCount, props,
-                                  init, cleanup, updater, functionsCount, funcs )
+                                  init, cleanup, updater, functionsCount, funcs, flags )
     {
     }
 
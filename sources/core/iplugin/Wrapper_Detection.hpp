@@ -120,12 +120,13 @@ public:
         int32_t propsCount = 0, PropertyDescriptor** props = nullptr,
         PluginInitializationHandler init = nullptr, PluginCleanupHandler cleanup = nullptr,
         PropertyDescriptorUpdater updater = nullptr,
-        int32_t functionsCount = 0, FunctionDescriptor** funcs = nullptr )
+        int32_t functionsCount = 0, FunctionDescriptor** funcs = nullptr,
+        PluginFlags flags = PluginFlag_None )
         :
         PluginRegisterAndWrapper( id, family, type, version, name, shortName,
                                   description, help, creator,
                                   smallIcon, icon, propsCount, props,
-                                  init, cleanup, updater, functionsCount, funcs )
+                                  init, cleanup, updater, functionsCount, funcs, flags )
     {
     }
 
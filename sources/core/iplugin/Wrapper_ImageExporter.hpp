@@ -105,6 +105,12 @@ private:
         return reinterpret_cast<CppImageExporterWrapper*>( me )->PluginObject->ExportImage( fileName, image );
     }
 
+    // Wrapper for ExportImageToMemory() method
+    static XErrorCode Wrapper_ExportImageToMemory( SImageExportingPlugin* me, const ximage* image, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize )
+    {
+        return reinterpret_cast<CppImageExporterWrapper*>( me )->PluginObject->ExportImageToMemory( image, buffer, bufferSize, encodedSize );
+    }
+
 public:
     PluginRegister_PluginType_ImageExporter( xguid id, xguid family,
         uint32_t type, xversion version,
@@ -114,12 +120,13 @@ public:
         int32_t propsCount = 0, PropertyDescriptor** props = 0,
         PluginInitializationHandler init = 0, PluginCleanupHandler cleanup = 0,
         PropertyDescriptorUpdater updater = 0,
-        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0 )
+        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0,
+        PluginFlags flags = PluginFlag_None )
         :
         PluginRegisterAndWrapper( id, family, type, version, name, shortName,
                                   description, help, creator,
                                   smallIcon, icon, propsCount, props,
-                                  init, cleanup, updater, functionsCount, funcs )
+                                  init, cleanup, updater, functionsCount, funcs, flags )
     {
     }
 
@@ -145,6 +152,7 @@ public:
         wrapper->Api.GetSupportedExtensions   = Wrapper_GetSupportedExtensions;
         wrapper->Api.GetSupportedPixelFormats = Wrapper_GetSupportedPixelFormats;
         wrapper->Api.ExportImage              = Wrapper_ExportImage;
+        wrapper->Api.ExportImageToMemory      = Wrapper_ExportImageToMemory;
 
         return reinterpret_cast<SImageExportingPlugin*>( wrapper );
     }
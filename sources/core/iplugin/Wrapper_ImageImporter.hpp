@@ -99,6 +99,12 @@ private:
         return reinterpret_cast<CppImageImporterWrapper*>( me )->PluginObject->ImportImage( fileName, image );
     }
 
+    // Wrapper for ImportImageFromMemory() method
+    static XErrorCode Wrapper_ImportImageFromMemory( SImageImportingPlugin* me, const uint8_t* buffer, uint32_t bufferLength, ximage** image )
+    {
+        return reinterpret_cast<CppImageImporterWrapper*>( me )->PluginObject->ImportImageFromMemory( buffer, bufferLength, image );
+    }
+
 public:
     PluginRegister_PluginType_ImageImporter( xguid id, xguid family,
         PluginType type, xversion version,
@@ -108,12 +114,13 @@ public:
         int32_t propsCount = 0, PropertyDescriptor** props = 0,
         PluginInitializationHandler init = 0, PluginCleanupHandler cleanup = 0,
         PropertyDescriptorUpdater updater = 0,
-        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0 )
+        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0,
+        PluginFlags flags = PluginFlag_None )
         :
         PluginRegisterAndWrapper( id, family, type, version, name, shortName,
                                   description, help, creator,
                                   smallIcon, icon, propsCount, props,
-                                  init, cleanup, updater, functionsCount, funcs )
+                                  init, cleanup, updater, functionsCount, funcs, flags )
     {
     }
 
@@ -138,6 +145,7 @@ public:
         wrapper->Api.GetFileTypeDescription = Wrapper_GetFileTypeDescription;
         wrapper->Api.GetSupportedExtensions = Wrapper_GetSupportedExtensions;
         wrapper->Api.ImportImage            = Wrapper_ImportImage;
+        wrapper->Api.ImportImageFromMemory  = Wrapper_ImportImageFromMemory;
 
         return reinterpret_cast<SImageImportingPlugin*>( wrapper );
     }
@@ -25,3 +25,4 @@
 const char* ModuleInitializeFuncName = "ModuleInitialize";
 const char* GetDescriptorFuncName    = "GetDescriptor";
 const char* ModuleCleanupFuncName    = "ModuleCleanup";
+const char* GetInterfaceVersionFuncName = "GetInterfaceVersion";
@@ -67,6 +67,19 @@ extern const char* GetDescriptorFuncName;
 typedef void (*ModuleCleanupFunc)( );
 extern const char* ModuleCleanupFuncName;
 
+// --- Optional function, which is exported by modules built against version 2 (or later) of the interface
+
+// Version of plug-ins' interface, which is increased when fields are added to the end of the interface's structures
+//   1 - modules not exporting the function below;
+//   2 - PluginDescriptor::Flags;
+//   3 - PluginDescriptor::InterfaceVersion, memory import/export of image importing/exporting plug-ins.
+#define PLUGINS_INTERFACE_VERSION (3)
+
+// Function to provide version of plug-ins' interface the module was built with (it is provided by the
+// iplugin library, so modules don't need to implement it)
+typedef uint32_t (*GetInterfaceVersionFunc)( );
+extern const char* GetInterfaceVersionFuncName;
+
 // --- Define shared module export attributes
 #if defined _WIN32 || defined __CYGWIN__
     #ifdef __GNUC__
@@ -53,6 +53,13 @@ static const PluginType PluginType_CommunicationDevice      = 0x0800;
 static const PluginType PluginType_Detection                = 0x1000;
 static const PluginType PluginType_All                      = 0xFFFFFFFF;
 
+// Flags describing plug-in's behaviour
+typedef uint32_t PluginFlags;
+
+static const PluginFlags PluginFlag_None                    = 0x0000;
+// Plug-in keeps state between processed video frames, so a video cannot be split into
+// segments, which are processed by independent instances of the plug-in
+static const PluginFlags PluginFlag_NotSplittable           = 0x0001;
 
 struct _PluginDescriptor;
 
@@ -83,6 +90,13 @@ typedef struct _PluginDescriptor
 
     int32_t                     FunctionsCount;
     FunctionDescriptor**        Functions;
+
+    // available since version 2 of plug-ins' interface (see PLUGINS_INTERFACE_VERSION)
+    PluginFlags                 Flags;
+
+    // available since version 3 of plug-ins' interface - version of the interface the plug-in was built with
+    // (set by plug-ins' registry and by the host for older modules, so plug-ins don't set it)
+    uint32_t                    InterfaceVersion;
 }
 PluginDescriptor;
 
@@ -54,7 +54,8 @@ public:
         int32_t propsCount = 0, PropertyDescriptor** props = 0,
         PluginInitializationHandler init = 0, PluginCleanupHandler cleanup = 0,
         PropertyDescriptorUpdater updater = 0,
-        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0 ) : cleanupHandler( cleanup )
+        int32_t functionsCount = 0, FunctionDescriptor** funcs = 0,
+        PluginFlags flags = PluginFlag_None ) : cleanupHandler( cleanup )
     {
         if ( init != 0 )
         {
@@ -79,7 +80,8 @@ public:
             props,
             updater,
             functionsCount,
-            funcs
+            funcs,
+            flags
         };
 
         RegisterPlugin( &desc );
@@ -115,4 +117,9 @@ public:
     static void* VARNAME(_creator_)( void ) { return _VARNAME(PluginRegister_,type)::CreateWrapper( new className( ) ); } \
     static PluginRegister_##type VARNAME(_pr_)( id, family, type, version, name, shortName, desc, help, VARNAME(_creator_), smallIcon, icon, propsCount, props, init, cleanup, updater, funcCount, functions );
 
+// Plugin registration macro with properties, functions and plug-in flags
+#define REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS( id, family, type, version, name, shortName, desc, help, smallIcon, icon, className, propsCount, props, init, cleanup, updater, funcCount, functions, flags ) \
+    static void* VARNAME(_creator_)( void ) { return _VARNAME(PluginRegister_,type)::CreateWrapper( new className( ) ); } \
+    static PluginRegister_##type VARNAME(_pr_)( id, family, type, version, name, shortName, desc, help, VARNAME(_creator_), smallIcon, icon, propsCount, props, init, cleanup, updater, funcCount, functions, flags );
+
 #endif // CVS_IPLUGINCPP_HPP
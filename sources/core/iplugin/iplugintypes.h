@@ -165,6 +165,8 @@ typedef xstring (*IImpPlugin_GetFileTypeDescription)( struct SImageImportingPlug
 typedef XErrorCode (*IImpPlugin_GetSupportedExtensions)( struct SImageImportingPlugin_* me, xstring* fileExtensions, int32_t* count );
 // Load image from the specified file
 typedef XErrorCode (*IImpPlugin_ImportImage)( struct SImageImportingPlugin_* me, xstring fileName, ximage** image );
+// Load image from the specified memory buffer, which contains encoded image (same as file's content)
+typedef XErrorCode (*IImpPlugin_ImportImageFromMemory)( struct SImageImportingPlugin_* me, const uint8_t* buffer, uint32_t bufferLength, ximage** image );
 
 typedef struct SImageImportingPlugin_
 {
@@ -172,6 +174,8 @@ typedef struct SImageImportingPlugin_
     IImpPlugin_GetFileTypeDescription GetFileTypeDescription;
     IImpPlugin_GetSupportedExtensions GetSupportedExtensions;
     IImpPlugin_ImportImage            ImportImage;
+    // available since version 3 of plug-ins' interface (see PLUGINS_INTERFACE_VERSION)
+    IImpPlugin_ImportImageFromMemory  ImportImageFromMemory;
 }
 SImageImportingPlugin;
 
@@ -187,6 +191,11 @@ typedef XErrorCode (*IExpPlugin_GetSupportedExtensions)( struct SImageExportingP
 typedef XErrorCode (*IExpPlugin_GetSupportedPixelFormats)( struct SImageExportingPlugin_* me, XPixelFormat* pixelFormats, int32_t* count );
 // Save image to the specified file
 typedef XErrorCode (*IExpPlugin_ExportImage)( struct SImageExportingPlugin_* me, xstring fileName, const ximage* image );
+// Save image into the specified memory buffer. The buffer is either NULL or allocated with XMAlloc(), so the plug-in
+// can re-allocate it if it is too small (bufferSize is updated then). This allows reusing the same buffer for many
+// images. Size of the encoded image is put into encodedSize. The caller frees the buffer with XFree().
+typedef XErrorCode (*IExpPlugin_ExportImageToMemory)( struct SImageExportingPlugin_* me, const ximage* image,
+                                                      uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize );
 
 typedef struct SImageExportingPlugin_
 {
@@ -195,6 +204,8 @@ typedef struct SImageExportingPlugin_
     IExpPlugin_GetSupportedExtensions   GetSupportedExtensions;
     IExpPlugin_GetSupportedPixelFormats GetSupportedPixelFormats;
     IExpPlugin_ExportImage              ExportImage;
+    // available since version 3 of plug-ins' interface (see PLUGINS_INTERFACE_VERSION)
+    IExpPlugin_ExportImageToMemory      ExportImageToMemory;
 }
 SImageExportingPlugin;
 
@@ -206,11 +217,15 @@ struct SVideoSourcePlugin_;
 typedef void( *VideoSourcePluginCallback_NewImage )( void* userParam, const ximage* image );
 // Callback type to provide error messages from video source
 typedef void( *VideoSourcePluginCallback_ErrorMessage )( void* userParam, const char* errorMessage );
+// Callback type to provide video frames along with time they were captured/received by plug-in (XTimestampNow() time
+// stamp). Plug-ins which know the time use it instead of NewImageCallback, if the host provides it (not null).
+typedef void( *VideoSourcePluginCallback_NewImageWithTimestamp )( void* userParam, const ximage* image, int64_t captureTime );
 
 typedef struct VideoSourcePluginCallbacks_
 {
-    VideoSourcePluginCallback_NewImage      NewImageCallback;
-    VideoSourcePluginCallback_ErrorMessage  ErrorMessageCallback;
+    VideoSourcePluginCallback_NewImage               NewImageCallback;
+    VideoSourcePluginCallback_ErrorMessage           ErrorMessageCallback;
+    VideoSourcePluginCallback_NewImageWithTimestamp  NewImageWithTimestampCallback;
 }
 VideoSourcePluginCallbacks;
 
@@ -384,6 +399,19 @@ typedef XErrorCode( *ScriptingEnginePluginCallback_GetVideoSource )( void* userP
                                                                      PluginDescriptor** pDescriptor,
                                                                      void** pPlugin );
 
+// Time stamps of a video frame (XTimestampNow() time stamps, 0 if not known)
+typedef struct _xframetimestamps
+{
+    int64_t captured;               // frame was captured by video source (or received by host if video source does not tell)
+    int64_t arrived;                // frame arrived to host
+    int64_t processingStarted;      // processing graph started processing the frame
+    int64_t processingFinished;     // processing graph finished processing the frame
+}
+xframetimestamps;
+
+// Callback type to get time stamps of the video frame being processed by the running script (if any)
+typedef XErrorCode( *ScriptingEnginePluginCallback_GetFrameTimestamps )( void* userParam, xframetimestamps* timestamps );
+
 typedef struct ScriptingEnginePluginCallbacks_
 {
     ScriptingEnginePluginCallback_GetHostName           GetHostName;
@@ -397,6 +425,7 @@ typedef struct ScriptingEnginePluginCallbacks_
     ScriptingEnginePluginCallback_GetImageVariable      GetImageVariable;
     ScriptingEnginePluginCallback_SetImageVariable      SetImageVariable;
     ScriptingEnginePluginCallback_GetVideoSource        GetVideoSource;
+    ScriptingEnginePluginCallback_GetFrameTimestamps    GetFrameTimestamps;
 }
 ScriptingEnginePluginCallbacks;
 
@@ -127,6 +127,14 @@ public:
     virtual XErrorCode GetSupportedExtensions( xstring* fileExtensions, int32_t* count ) = 0;
     // Load image from the specified file
     virtual XErrorCode ImportImage( xstring fileName, ximage** image ) = 0;
+    // Load image from the specified memory buffer - not supported by default
+    virtual XErrorCode ImportImageFromMemory( const uint8_t* buffer, uint32_t bufferLength, ximage** image )
+    {
+        XUNREFERENCED_PARAMETER( buffer )
+        XUNREFERENCED_PARAMETER( bufferLength )
+        XUNREFERENCED_PARAMETER( image )
+        return ErrorUnsupportedInterface;
+    }
 };
 
 // ===== Interface for image exporting plug-in =====
@@ -141,6 +149,15 @@ public:
     virtual XErrorCode GetSupportedPixelFormats( XPixelFormat* pixelFormats, int32_t* count ) = 0;
     // Save image to the specified file
     virtual XErrorCode ExportImage( xstring fileName, const ximage* image ) = 0;
+    // Save image into the specified memory buffer - not supported by default
+    virtual XErrorCode ExportImageToMemory( const ximage* image, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize )
+    {
+        XUNREFERENCED_PARAMETER( image )
+        XUNREFERENCED_PARAMETER( buffer )
+        XUNREFERENCED_PARAMETER( bufferSize )
+        XUNREFERENCED_PARAMETER( encodedSize )
+        return ErrorUnsupportedInterface;
+    }
 };
 
 // ===== Interface for video source plug-in =====
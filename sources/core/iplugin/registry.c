@@ -21,9 +21,17 @@
 
 #include <xlist.h>
 #include "iplugin.h"
+#include "imodule.h"
 
 static xlist* pluginStore;
 
+// Get version of plug-ins' interface the module was built with (every module registers its plug-ins,
+// so this is exported by all modules linked with the library)
+MODULE_PUBLIC uint32_t GetInterfaceVersion( )
+{
+    return PLUGINS_INTERFACE_VERSION;
+}
+
 // Register plugin with the provided description
 void RegisterPlugin( const PluginDescriptor* desc )
 {
@@ -40,6 +48,7 @@ void RegisterPlugin( const PluginDescriptor* desc )
 
         if ( descToStore != 0 )
         {
+            descToStore->InterfaceVersion = PLUGINS_INTERFACE_VERSION;
             XListAddTail( pluginStore, descToStore );
         }
     }
@@ -38,6 +38,8 @@ PluginDescriptor* CopyPluginDescriptor( const PluginDescriptor* src )
             copy->Type     = src->Type;
             copy->Creator  = src->Creator;
             copy->Version  = src->Version;
+            copy->Flags    = src->Flags;
+            copy->InterfaceVersion = src->InterfaceVersion;
 
             copy->Name          = XStringAlloc( src->Name );
             copy->ShortName     = XStringAlloc( src->ShortName );
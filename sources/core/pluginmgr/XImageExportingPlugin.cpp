@@ -24,10 +24,11 @@
 using namespace std;
 using namespace CVSandbox;
 
-XImageExportingPlugin::XImageExportingPlugin( void* plugin, bool ownIt ) :
+XImageExportingPlugin::XImageExportingPlugin( void* plugin, bool ownIt, uint32_t interfaceVersion ) :
     XPlugin( plugin, PluginType_ImageExporter, ownIt ),
     mSupportedExtensions( ),
-    mSupportedPixelFormats( )
+    mSupportedPixelFormats( ),
+    mInterfaceVersion( interfaceVersion )
 {
     XErrorCode    extensionsRet     = ErrorFailed;
     xstring*      extensions        = nullptr;
@@ -90,9 +91,9 @@ XImageExportingPlugin::~XImageExportingPlugin( )
 }
 
 // Create plug-in wrapper
-const shared_ptr<XImageExportingPlugin> XImageExportingPlugin::Create( void* plugin, bool ownIt )
+const shared_ptr<XImageExportingPlugin> XImageExportingPlugin::Create( void* plugin, bool ownIt, uint32_t interfaceVersion )
 {
-    return shared_ptr<XImageExportingPlugin>( new XImageExportingPlugin( plugin, ownIt ) );
+    return shared_ptr<XImageExportingPlugin>( new XImageExportingPlugin( plugin, ownIt, interfaceVersion ) );
 }
 
 // Get some short description of the file type
@@ -131,3 +132,33 @@ XErrorCode XImageExportingPlugin::ExportImage( const string& fileName, const sha
     SImageExportingPlugin* iexp = static_cast<SImageExportingPlugin*>( mPlugin );
     return iexp->ExportImage( iexp, fileName.c_str( ), src->ImageData( ) );
 }
+
+// Save image into the specified memory buffer
+XErrorCode XImageExportingPlugin::ExportImageToMemory( const shared_ptr<const XImage>& src,
+                                                       uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize ) const
+{
+    SImageExportingPlugin* iexp = static_cast<SImageExportingPlugin*>( mPlugin );
+
+    // modules built against older interface don't have the slot at all, so it must not be read for them;
+    // newer plug-ins not based on the C++ wrapper may still leave it NULL
+    return ( ( mInterfaceVersion < 3 ) || ( iexp->ExportImageToMemory == nullptr ) ) ? ErrorUnsupportedInterface :
+             iexp->ExportImageToMemory( iexp, src->ImageData( ), buffer, bufferSize, encodedSize );
+}
+
+// Save image into the specified vector
+XErrorCode XImageExportingPlugin::ExportImageToMemory( const shared_ptr<const XImage>& src, vector<uint8_t>& encodedImage ) const
+{
+    uint8_t*   buffer      = nullptr;
+    uint32_t   bufferSize  = 0;
+    uint32_t   encodedSize = 0;
+    XErrorCode ret         = ExportImageToMemory( src, &buffer, &bufferSize, &encodedSize );
+
+    if ( ret == SuccessCode )
+    {
+        encodedImage.assign( buffer, buffer + encodedSize );
+    }
+
+    XFree( (void**) &buffer );
+
+    return ret;
+}
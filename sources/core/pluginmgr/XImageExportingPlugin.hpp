@@ -26,18 +26,20 @@
 #include <vector>
 #include <string>
 #include <XImage.hpp>
+#include <imodule.h>
 #include "XPlugin.hpp"
 
 class XImageExportingPlugin : public XPlugin
 {
 private:
-    XImageExportingPlugin( void* plugin, bool ownIt );
+    XImageExportingPlugin( void* plugin, bool ownIt, uint32_t interfaceVersion );
 
 public:
     virtual ~XImageExportingPlugin( );
 
-    // Create plug-in wrapper
-    static const std::shared_ptr<XImageExportingPlugin> Create( void* plugin, bool ownIt = true );
+    // Create plug-in wrapper (memory functions are available only for plug-ins built against version 3 of the interface or later)
+    static const std::shared_ptr<XImageExportingPlugin> Create( void* plugin, bool ownIt = true,
+                                                               uint32_t interfaceVersion = PLUGINS_INTERFACE_VERSION );
 
     // Get some short description of the file type
     const std::string GetFileTypeDescription( ) const;
@@ -47,10 +49,17 @@ public:
     const std::vector<XPixelFormat> GetSupportedPixelFormats( ) const;
     // Save image to the specified file
     XErrorCode ExportImage( const std::string& fileName, const std::shared_ptr<const CVSandbox::XImage>& src ) const;
+    // Save image into the specified memory buffer. The buffer must be NULL or allocated with XMAlloc(), so it can be
+    // re-allocated when it is too small - reusing it for many images saves memory allocations. Free it with XFree().
+    XErrorCode ExportImageToMemory( const std::shared_ptr<const CVSandbox::XImage>& src,
+                                    uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize ) const;
+    // Save image into the specified vector (it is resized to the size of the encoded image)
+    XErrorCode ExportImageToMemory( const std::shared_ptr<const CVSandbox::XImage>& src, std::vector<uint8_t>& encodedImage ) const;
 
 private:
     std::vector<std::string>  mSupportedExtensions;
     std::vector<XPixelFormat> mSupportedPixelFormats;
+    uint32_t                  mInterfaceVersion;
 };
 
 #endif // CVS_XIMAGE_EXPORTING_PLUGIN_HPP
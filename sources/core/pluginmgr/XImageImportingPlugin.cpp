@@ -25,9 +25,10 @@
 using namespace std;
 using namespace CVSandbox;
 
-XImageImportingPlugin::XImageImportingPlugin( void* plugin, bool ownIt ) :
+XImageImportingPlugin::XImageImportingPlugin( void* plugin, bool ownIt, uint32_t interfaceVersion ) :
     XPlugin( plugin, PluginType_ImageImporter, ownIt ),
-    mSupportedExtensions( )
+    mSupportedExtensions( ),
+    mInterfaceVersion( interfaceVersion )
 {
     XErrorCode ret        = ErrorFailed;
     xstring*   extensions = nullptr;
@@ -67,9 +68,9 @@ XImageImportingPlugin::~XImageImportingPlugin( )
 }
 
 // Create plug-in wrapper
-const shared_ptr<XImageImportingPlugin> XImageImportingPlugin::Create( void* plugin, bool ownIt )
+const shared_ptr<XImageImportingPlugin> XImageImportingPlugin::Create( void* plugin, bool ownIt, uint32_t interfaceVersion )
 {
-    return shared_ptr<XImageImportingPlugin>( new XImageImportingPlugin( plugin, ownIt ) );
+    return shared_ptr<XImageImportingPlugin>( new XImageImportingPlugin( plugin, ownIt, interfaceVersion ) );
 }
 
 // Get some short description of the file type
@@ -105,6 +106,34 @@ XErrorCode XImageImportingPlugin::ImportImage( const string& fileName, shared_pt
     SImageImportingPlugin* iimp = static_cast<SImageImportingPlugin*>( mPlugin );
     ret = iimp->ImportImage( iimp, fileName.c_str( ), &dstCImage );
 
+    UpdateImportedImage( ret, dstCImage, dst );
+
+    return ret;
+}
+
+// Load image from the specified memory buffer
+XErrorCode XImageImportingPlugin::ImportImageFromMemory( const uint8_t* buffer, uint32_t bufferLength, shared_ptr<XImage>& dst ) const
+{
+    XErrorCode  ret       = ErrorUnsupportedInterface;
+    ximage*     dstCImage = ( !dst ) ? nullptr : dst->ImageData( );
+
+    SImageImportingPlugin* iimp = static_cast<SImageImportingPlugin*>( mPlugin );
+
+    // modules built against older interface don't have the slot at all, so it must not be read for them;
+    // newer plug-ins not based on the C++ wrapper may still leave it NULL
+    if ( ( mInterfaceVersion >= 3 ) && ( iimp->ImportImageFromMemory != nullptr ) )
+    {
+        ret = iimp->ImportImageFromMemory( iimp, buffer, bufferLength, &dstCImage );
+
+        UpdateImportedImage( ret, dstCImage, dst );
+    }
+
+    return ret;
+}
+
+// Update destination image after calling plug-in to import an image
+void XImageImportingPlugin::UpdateImportedImage( XErrorCode ret, ximage* dstCImage, shared_ptr<XImage>& dst )
+{
     if ( !dst )
     {
         // if destination was not allocated before, we do it only on success
@@ -129,6 +158,4 @@ XErrorCode XImageImportingPlugin::ImportImage( const string& fileName, shared_pt
             dst->Reset( dstCImage );
         }
     }
-
-    return ret;
 }
@@ -26,18 +26,20 @@
 #include <vector>
 #include <string>
 #include <XImage.hpp>
+#include <imodule.h>
 #include "XPlugin.hpp"
 
 class XImageImportingPlugin : public XPlugin
 {
 private:
-    XImageImportingPlugin( void* plugin, bool ownIt );
+    XImageImportingPlugin( void* plugin, bool ownIt, uint32_t interfaceVersion );
 
 public:
     virtual ~XImageImportingPlugin( );
 
-    // Create plug-in wrapper
-    static const std::shared_ptr<XImageImportingPlugin> Create( void* plugin, bool ownIt = true );
+    // Create plug-in wrapper (memory functions are available only for plug-ins built against version 3 of the interface or later)
+    static const std::shared_ptr<XImageImportingPlugin> Create( void* plugin, bool ownIt = true,
+                                                               uint32_t interfaceVersion = PLUGINS_INTERFACE_VERSION );
 
     // Get some short description of the file type
     const std::string GetFileTypeDescription( ) const;
@@ -45,9 +47,15 @@ public:
     const std::vector<std::string> GetSupportedExtensions( ) const;
     // Load image from the specified file
     XErrorCode ImportImage( const std::string& fileName, std::shared_ptr<CVSandbox::XImage>& dst ) const;
+    // Load image from the specified memory buffer (encoded image, same as file's content)
+    XErrorCode ImportImageFromMemory( const uint8_t* buffer, uint32_t bufferLength, std::shared_ptr<CVSandbox::XImage>& dst ) const;
+
+private:
+    static void UpdateImportedImage( XErrorCode ret, ximage* dstCImage, std::shared_ptr<CVSandbox::XImage>& dst );
 
 private:
     std::vector<std::string> mSupportedExtensions;
+    uint32_t                 mInterfaceVersion;
 };
 
 #endif // CVS_XIMAGE_IMPORTING_PLUGIN_HPP
@@ -227,7 +227,7 @@ int32_t XPluginDescriptor::GetFunctionIndexByName( const string& name ) const
 // Create instance of the plug-in
 const shared_ptr<XPlugin> XPluginDescriptor::CreateInstance( ) const
 {
-    return XPluginWrapperFactory::CreateWrapper( mDescriptor->Creator( ), mDescriptor->Type );
+    return XPluginWrapperFactory::CreateWrapper( mDescriptor->Creator( ), mDescriptor->Type, true, mDescriptor->InterfaceVersion );
 }
 
 // Helper function to get plug-in's configuration
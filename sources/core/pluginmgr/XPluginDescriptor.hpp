@@ -66,6 +66,17 @@ public:
         return mDescriptor->Type;
     }
 
+    PluginFlags Flags( ) const
+    {
+        return mDescriptor->Flags;
+    }
+
+    // Version of plug-ins' interface the plug-in was built with
+    uint32_t InterfaceVersion( ) const
+    {
+        return mDescriptor->InterfaceVersion;
+    }
+
     // Total number of properties
     int32_t PropertiesCount( ) const
     {
@@ -35,7 +35,7 @@
 
 using namespace std;
 
-shared_ptr<XPlugin> XPluginWrapperFactory::CreateWrapper( void* pluginObject, PluginType type, bool ownIt )
+shared_ptr<XPlugin> XPluginWrapperFactory::CreateWrapper( void* pluginObject, PluginType type, bool ownIt, uint32_t interfaceVersion )
 {
     shared_ptr<XPlugin> pluginInstance;
 
@@ -52,11 +52,11 @@ shared_ptr<XPlugin> XPluginWrapperFactory::CreateWrapper( void* pluginObject, Pl
             break;
 
         case PluginType_ImageImporter:
-            pluginInstance = XImageImportingPlugin::Create( pluginObject, ownIt );
+            pluginInstance = XImageImportingPlugin::Create( pluginObject, ownIt, interfaceVersion );
             break;
 
         case PluginType_ImageExporter:
-            pluginInstance = XImageExportingPlugin::Create( pluginObject, ownIt );
+            pluginInstance = XImageExportingPlugin::Create( pluginObject, ownIt, interfaceVersion );
             break;
 
         case PluginType_VideoSource:
@@ -24,6 +24,7 @@
 #define CVS_XPLUGIN_WRAPPER_FACTORY_HPP
 
 #include <memory>
+#include <imodule.h>
 #include "XPlugin.hpp"
 
 class XPluginWrapperFactory
@@ -32,7 +33,9 @@ private:
     XPluginWrapperFactory( ) { }
 
 public:
-    static std::shared_ptr<XPlugin> CreateWrapper( void* pluginObject, PluginType type, bool ownIt = true );
+    // Create wrapper for the plug-in object (version of plug-ins' interface tells which of plug-in's functions are available)
+    static std::shared_ptr<XPlugin> CreateWrapper( void* pluginObject, PluginType type, bool ownIt = true,
+                                                   uint32_t interfaceVersion = PLUGINS_INTERFACE_VERSION );
 };
 
 #endif // CVS_XPLUGIN_WRAPPER_FACTORY_HPP
@@ -20,10 +20,45 @@
 */
 
 #include "XPluginsCollection.hpp"
+#include <stddef.h>
+#include <string.h>
 
 using namespace std;
 using namespace CVSandbox;
 
+// Move descriptor provided by a module built against older interface into a complete structure, so the
+// fields the module does not know about get defaults instead of being read past the end of its structure
+static PluginDescriptor* CompletePluginDescriptor( PluginDescriptor* desc, uint32_t interfaceVersion )
+{
+    if ( interfaceVersion < 3 )
+    {
+        PluginDescriptor* completeDesc = static_cast<PluginDescriptor*>( XCAlloc( 1, sizeof( PluginDescriptor ) ) );
+
+        if ( completeDesc == nullptr )
+        {
+            FreePluginDescriptor( &desc );
+        }
+        else
+        {
+            // the copy takes over all memory referenced by the original structure
+            memcpy( completeDesc, desc, ( interfaceVersion < 2 ) ? offsetof( PluginDescriptor, Flags ) :
+                                                                   offsetof( PluginDescriptor, InterfaceVersion ) );
+            XFree( reinterpret_cast<void**>( &desc ) );
+            desc = completeDesc;
+
+            // nothing is known about plug-in's state, so it is not safe to split video for it
+            if ( interfaceVersion < 2 )
+            {
+                desc->Flags = PluginFlag_NotSplittable;
+            }
+
+            desc->InterfaceVersion = interfaceVersion;
+        }
+    }
+
+    return desc;
+}
+
 XPluginsCollection::XPluginsCollection( ) :
     mPlugins( )
 {
@@ -45,7 +80,8 @@ void XPluginsCollection::Clear( )
 }
 
 // Collect plug-ins given a pointer to a function which provides plug-in descriptors
-size_t XPluginsCollection::CollectPlugins( GetDescriptorFunc pluginsNest, int32_t count, PluginType typesToCollec )
+size_t XPluginsCollection::CollectPlugins( GetDescriptorFunc pluginsNest, int32_t count, PluginType typesToCollec,
+                                           uint32_t interfaceVersion )
 {
     Clear( );
 
@@ -53,6 +89,11 @@ size_t XPluginsCollection::CollectPlugins( GetDescriptorFunc pluginsNest, int32_
     {
         PluginDescriptor* desc = pluginsNest( i );
 
+        if ( desc != 0 )
+        {
+            desc = CompletePluginDescriptor( desc, interfaceVersion );
+        }
+
         if ( desc != 0 )
         {
             shared_ptr<const XPluginDescriptor> descriptor = XPluginDescriptor::Create( desc );
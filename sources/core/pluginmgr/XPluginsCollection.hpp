@@ -44,8 +44,10 @@ public:
 
     // Create empty collection
     static const std::shared_ptr<XPluginsCollection> Create( );
-    // Collect plug-ins given a pointer to a function which provides plug-in descriptors
-    size_t CollectPlugins( GetDescriptorFunc pluginsNest, int32_t count, PluginType typesToCollec = PluginType_All );
+    // Collect plug-ins given a pointer to a function which provides plug-in descriptors (the version of plug-ins'
+    // interface tells which fields of the descriptors are provided)
+    size_t CollectPlugins( GetDescriptorFunc pluginsNest, int32_t count, PluginType typesToCollec = PluginType_All,
+                           uint32_t interfaceVersion = PLUGINS_INTERFACE_VERSION );
     // Create copy of the collection
     const std::shared_ptr<XPluginsCollection> Copy( ) const;
 
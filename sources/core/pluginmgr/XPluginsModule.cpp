@@ -67,6 +67,8 @@ XErrorCode XPluginsModule::Load( PluginType typesToCollect )
             XModuleGetSymbol( mModule, ModuleInitializeFuncName );
         GetDescriptorFunc pluginDescProvider = (GetDescriptorFunc)
             XModuleGetSymbol( mModule, GetDescriptorFuncName );
+        GetInterfaceVersionFunc interfaceVersionProvider = (GetInterfaceVersionFunc)
+            XModuleGetSymbol( mModule, GetInterfaceVersionFuncName );
 
         if ( ( moduleInitilizer == 0 ) || ( pluginDescProvider == 0 ) )
         {
@@ -84,7 +86,8 @@ XErrorCode XPluginsModule::Load( PluginType typesToCollect )
             else
             {
                 mDescriptor = desc;
-                mPlugins->CollectPlugins( pluginDescProvider, mDescriptor->PluginsCount, typesToCollect );
+                mPlugins->CollectPlugins( pluginDescProvider, mDescriptor->PluginsCount, typesToCollect,
+                                          ( interfaceVersionProvider == 0 ) ? 1 : interfaceVersionProvider( ) );
             }
         }
     }
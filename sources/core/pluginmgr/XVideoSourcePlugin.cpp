@@ -20,6 +20,7 @@
 */
 
 #include "XVideoSourcePlugin.hpp"
+#include <xtimestamp.h>
 
 using namespace std;
 using namespace CVSandbox;
@@ -99,8 +100,9 @@ void XVideoSourcePlugin::SetListener( IVideoSourcePluginListener* listener )
         {
             VideoSourcePluginCallbacks callbacks = { 0 };
 
-            callbacks.NewImageCallback      = NewImageHandler;
-            callbacks.ErrorMessageCallback  = ErrorMessageHandler;
+            callbacks.NewImageCallback              = NewImageHandler;
+            callbacks.ErrorMessageCallback          = ErrorMessageHandler;
+            callbacks.NewImageWithTimestampCallback = NewImageWithTimestampHandler;
 
             // subscribe again
             vsp->SetCallbacks( vsp, &callbacks, this );
@@ -108,15 +110,21 @@ void XVideoSourcePlugin::SetListener( IVideoSourcePluginListener* listener )
     }
 }
 
-// New image comes from a plug-in
+// New image comes from a plug-in - it does not tell capture time, so use the time of receiving it
 void XVideoSourcePlugin::NewImageHandler( void* userParam, const ximage* image )
+{
+    NewImageWithTimestampHandler( userParam, image, XTimestampNow( ) );
+}
+
+// New image comes from a plug-in along with its capture time
+void XVideoSourcePlugin::NewImageWithTimestampHandler( void* userParam, const ximage* image, int64_t captureTime )
 {
     XVideoSourcePlugin*      me           = static_cast<XVideoSourcePlugin*>( userParam );
     shared_ptr<const XImage> guardedImage = XImage::Create( image );
 
     if ( me->mListener != nullptr )
     {
-        me->mListener->OnNewImage( guardedImage );
+        me->mListener->OnNewImage( guardedImage, captureTime );
     }
 }
 
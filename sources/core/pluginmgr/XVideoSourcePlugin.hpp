@@ -34,6 +34,14 @@ public:
     // New video frame notification
     virtual void OnNewImage( const std::shared_ptr<const CVSandbox::XImage>& image ) = 0;
 
+    // New video frame notification, which also tells when the frame was captured (XTimestampNow() time
+    // stamp). Video sources, which don't tell it, provide time of receiving the frame by the host.
+    virtual void OnNewImage( const std::shared_ptr<const CVSandbox::XImage>& image, int64_t captureTime )
+    {
+        XUNREFERENCED_PARAMETER( captureTime )
+        OnNewImage( image );
+    }
+
     // Video source error notification
     virtual void OnError( const std::string& errorMessage ) = 0;
 };
@@ -70,6 +78,7 @@ public:
 
 private:
     static void NewImageHandler( void* userParam, const ximage* image );
+    static void NewImageWithTimestampHandler( void* userParam, const ximage* image, int64_t captureTime );
     static void ErrorMessageHandler( void* userParam, const char* errorMessage );
 
 private:
@@ -57,6 +57,8 @@ public:
 
     virtual XErrorCode GetVideoSource( std::shared_ptr<const XPluginDescriptor>& descriptor,
                                        std::shared_ptr<XPlugin>& plugin ) const = 0;
+
+    virtual XErrorCode GetFrameTimestamps( xframetimestamps* timestamps ) const = 0;
 };
 
 #endif // CVS_ISCRIPTING_HOST_HPP
@@ -311,3 +311,10 @@ XErrorCode XDefaultScriptingHost::GetVideoSource( shared_ptr<const XPluginDescri
 
     return ErrorNotImplemented;
 }
+
+XErrorCode XDefaultScriptingHost::GetFrameTimestamps( xframetimestamps* timestamps ) const
+{
+    XUNREFERENCED_PARAMETER( timestamps )
+
+    return ErrorNotImplemented;
+}
@@ -64,6 +64,8 @@ public:
     virtual XErrorCode GetVideoSource( std::shared_ptr<const XPluginDescriptor>& descriptor,
                                        std::shared_ptr<XPlugin>& plugin ) const;
 
+    virtual XErrorCode GetFrameTimestamps( xframetimestamps* timestamps ) const;
+
 private:
     Private::XDefaultScriptingHostData* mData;
 };
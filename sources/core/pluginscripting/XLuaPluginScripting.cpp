@@ -21,6 +21,7 @@
 
 #include <assert.h>
 #include <XError.hpp>
+#include <xtimestamp.h>
 #include "XLuaPluginScripting.hpp"
 #include "XLuaPluginScripting_UserTypes.hpp"
 
@@ -37,7 +38,7 @@ using namespace CVSandbox;
 namespace Private
 {
     static const char   LuaRegistryKey       = 'k';
-    static const int    LuaScriptingRevision = 8;
+    static const int    LuaScriptingRevision = 10;
 
     class XLuaPluginScriptingData
     {
@@ -396,6 +397,41 @@ namespace Private
         return ret;
     }
 
+    static int HostGetFrameTimestamps( lua_State* luaState )
+    {
+        xframetimestamps timestamps = { 0 };
+        int              ret = 0;
+
+        CheckArgumentsCount( luaState, 0 );
+
+        XErrorCode errorCode = GetHostFromLuaRegistry( luaState )->GetFrameTimestamps( &timestamps );
+
+        if ( errorCode == SuccessCode )
+        {
+            // time stamps are in microseconds - keep them as Lua numbers, since integers may be 32 bit
+            lua_newtable( luaState );
+
+            lua_pushnumber( luaState, static_cast<lua_Number>( timestamps.captured ) );
+            lua_setfield( luaState, -2, "captured" );
+            lua_pushnumber( luaState, static_cast<lua_Number>( timestamps.arrived ) );
+            lua_setfield( luaState, -2, "arrived" );
+            lua_pushnumber( luaState, static_cast<lua_Number>( timestamps.processingStarted ) );
+            lua_setfield( luaState, -2, "processingStarted" );
+            lua_pushnumber( luaState, static_cast<lua_Number>( timestamps.processingFinished ) );
+            lua_setfield( luaState, -2, "processingFinished" );
+            lua_pushnumber( luaState, static_cast<lua_Number>( XTimestampNow( ) ) );
+            lua_setfield( luaState, -2, "now" );
+
+            ret = 1;
+        }
+        else
+        {
+            ReportXError( luaState, errorCode );
+        }
+
+        return ret;
+    }
+
     static const struct luaL_Reg HostLibrary[] =
     {
         { "Name",                   HostName                 },
@@ -407,6 +443,7 @@ namespace Private
         { "GetVariable",            HostGetVariable          },
         { "SetVariable",            HostSetVariable          },
         { "GetVideoSource",         HostGetVideoSource       },
+        { "GetFrameTimestamps",     HostGetFrameTimestamps   },
         { nullptr,                  nullptr                  }
     };
 
@@ -1300,11 +1300,36 @@ static int PluginImageImporter_ImportImage( lua_State* luaState )
     return 1;
 }
 
+// Load an image from memory (string containing encoded image) using the plug-in
+static int PluginImageImporter_ImportImageFromMemory( lua_State* luaState )
+{
+    CheckArgumentsCount( luaState, 2 );
+
+    PluginShell*        pluginShell = GetPluginShellFromLuaStack( luaState, 1, METATABLE_IMAGE_IMPORTER_PLUGIN );
+    size_t              dataLength  = 0;
+    const char*         data        = luaL_checklstring( luaState, 2, &dataLength );
+    shared_ptr<XImage>  image;
+    XErrorCode          errorCode   = static_pointer_cast<XImageImportingPlugin>( pluginShell->Plugin )->
+                                      ImportImageFromMemory( reinterpret_cast<const uint8_t*>( data ), static_cast<uint32_t>( dataLength ), image );
+
+    if ( errorCode != SuccessCode )
+    {
+        ReportXError( luaState, errorCode );
+    }
+    else
+    {
+        PutImageOnLuaStack( luaState, image );
+    }
+
+    return 1;
+}
+
 static const struct luaL_Reg ImageImporterPluginFunctions[] =
 {
-    { "FileTypeDescription", PluginImageImporter_FileTypeDescription },
-    { "SupportedExtensions", PluginImageImporter_SupportedExtensions },
-    { "ImportImage",         PluginImageImporter_ImportImage },
+    { "FileTypeDescription",   PluginImageImporter_FileTypeDescription },
+    { "SupportedExtensions",   PluginImageImporter_SupportedExtensions },
+    { "ImportImage",           PluginImageImporter_ImportImage },
+    { "ImportImageFromMemory", PluginImageImporter_ImportImageFromMemory },
     { nullptr, nullptr }
 };
 
@@ -1396,12 +1421,42 @@ static int PluginImageExporter_ExportImage( lua_State* luaState )
     return 0;
 }
 
+// Export specified image into memory using the plug-in (encoded image is returned as string)
+static int PluginImageExporter_ExportImageToMemory( lua_State* luaState )
+{
+    CheckArgumentsCount( luaState, 2 );
+
+    PluginShell*       pluginShell = GetPluginShellFromLuaStack( luaState, 1, METATABLE_IMAGE_EXPORTER_PLUGIN );
+    shared_ptr<XImage> image       = GetImageFromLuaStack( luaState, 2 );
+    uint8_t*           buffer      = nullptr;
+    uint32_t           bufferSize  = 0;
+    uint32_t           encodedSize = 0;
+    XErrorCode         errorCode   = static_pointer_cast<XImageExportingPlugin>( pluginShell->Plugin )->
+                                     ExportImageToMemory( image, &buffer, &bufferSize, &encodedSize );
+
+    if ( errorCode == SuccessCode )
+    {
+        lua_pushlstring( luaState, reinterpret_cast<const char*>( buffer ), encodedSize );
+    }
+
+    // free the buffer before reporting error, since error does not return
+    XFree( (void**) &buffer );
+
+    if ( errorCode != SuccessCode )
+    {
+        ReportXError( luaState, errorCode );
+    }
+
+    return 1;
+}
+
 static const struct luaL_Reg ImageExporterPluginFunctions[] =
 {
     { "FileTypeDescription",   PluginImageExporter_FileTypeDescription },
     { "SupportedExtensions",   PluginImageExporter_SupportedExtensions },
     { "SupportedPixelFormats", PluginImageExporter_SupportedPixelFormats },
     { "ExportImage",           PluginImageExporter_ExportImage },
+    { "ExportImageToMemory",   PluginImageExporter_ExportImageToMemory },
     { nullptr, nullptr }
 };
 
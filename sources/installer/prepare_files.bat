@@ -5,7 +5,7 @@ rmdir /S /Q Files
 mkdir Files
 
 @rem  2 - Copy main binaries
-set TO_COPY=cvsandbox.exe cvsandboxtools.dll cvssr.exe ^
+set TO_COPY=cvsandbox.exe cvsandboxtools.dll cvssr.exe cvsreplay.exe ^
             libcurl.dll libexif-12.dll libjpeg-8.dll libpng16-16.dll zlib1.dll ^
             avcodec-57.dll avfilter-6.dll avformat-57.dll avutil-55.dll ^
             swresample-2.dll swscale-4.dll ^
@@ -31,9 +31,9 @@ mkdir .\Files\platforms
 xcopy "%QT_MINGW_BIN%\..\plugins\platforms\qwindows.dll" .\Files\platforms
 
 @rem  3 - Copy main plug-ins
-set TO_COPY=cv_bar_codes cv_glyphs dev_com dev_sysinfo fmt_jpeg fmt_png ip_blobs_processing ^
-            ip_effects ip_stdimaging ip_tools vp_ffmpeg_io vs_dshow vs_ffmpeg ^
-            vs_image_folder vs_mjpeg vs_repeater vs_screen_cap
+set TO_COPY=cv_bar_codes cv_features cv_glyphs cv_hough dev_com dev_sysinfo fmt_jpeg fmt_png ip_blobs_processing ^
+            ip_effects ip_stdimaging ip_tools vp_ffmpeg_io vp_mjpeg_server vs_dshow vs_ffmpeg ^
+            vs_frame_store vs_image_folder vs_mjpeg vs_repeater vs_screen_cap vs_shared_memory
 mkdir .\Files\cvsplugins
 for %%F in (%TO_COPY%) do (
     mkdir ".\Files\cvsplugins\%%F"
@@ -0,0 +1,262 @@
+/*
+    Feature points detection and tracking plug-ins for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "CornersDetectorPlugin.hpp"
+#include <xvision.h>
+
+namespace Private
+{
+    class CornersDetectorPluginData
+    {
+    public:
+        CornersDetectionContext* Context;
+        bool                     LastProcessingSucceeded;
+        uint8_t                  Detector;
+        uint8_t                  FastThreshold;
+        float                    QualityLevel;
+        uint16_t                 CellSize;
+        uint32_t                 MaxCorners;
+
+    public:
+        CornersDetectorPluginData( ) :
+            Context( nullptr ), LastProcessingSucceeded( false ), Detector( 0 ), FastThreshold( 20 ),
+            QualityLevel( 0.01f ), CellSize( 16 ), MaxCorners( 500 )
+        {
+        }
+
+        ~CornersDetectorPluginData( )
+        {
+            FreeCornersDetectionContext( &Context );
+        }
+    };
+};
+
+// Supported pixel formats of input images
+const XPixelFormat CornersDetectorPlugin::supportedFormats[] =
+{
+    XPixelFormatGrayscale8, XPixelFormatRGB24, XPixelFormatRGBA32
+};
+
+CornersDetectorPlugin::CornersDetectorPlugin( ) :
+    mData( new Private::CornersDetectorPluginData( ) )
+{
+}
+
+CornersDetectorPlugin::~CornersDetectorPlugin( )
+{
+    delete mData;
+}
+
+void CornersDetectorPlugin::Dispose( )
+{
+    delete this;
+}
+
+// Provide supported pixel formats
+XErrorCode CornersDetectorPlugin::GetSupportedPixelFormats( XPixelFormat* formats, int32_t* count )
+{
+    return GetSupportedPixelFormatsImpl( supportedFormats, XARRAY_SIZE( supportedFormats ), formats, count );
+}
+
+// Find corners in the specified image
+XErrorCode CornersDetectorPlugin::ProcessImage( const ximage* image )
+{
+    XErrorCode ret;
+
+    if ( mData->Detector == 0 )
+    {
+        ret = FindFastCorners( image, mData->FastThreshold, mData->CellSize, mData->MaxCorners, &mData->Context );
+    }
+    else
+    {
+        ret = FindHarrisCorners( image, mData->QualityLevel, mData->CellSize, mData->MaxCorners, &mData->Context );
+    }
+
+    mData->LastProcessingSucceeded = ( ret == SuccessCode );
+
+    return ret;
+}
+
+// Get the specified property value of the plug-in
+XErrorCode CornersDetectorPlugin::GetProperty( int32_t id, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( id >= 5 ) && ( !mData->LastProcessingSucceeded ) )
+    {
+        ret = ErrorInitializationFailed;
+    }
+    else
+    {
+        switch ( id )
+        {
+        case 0:
+            value->type = XVT_U1;
+            value->value.ubVal = mData->Detector;
+            break;
+
+        case 1:
+            value->type = XVT_U1;
+            value->value.ubVal = mData->FastThreshold;
+            break;
+
+        case 2:
+            value->type = XVT_R4;
+            value->value.fVal = mData->QualityLevel;
+            break;
+
+        case 3:
+            value->type = XVT_U2;
+            value->value.usVal = mData->CellSize;
+            break;
+
+        case 4:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->MaxCorners;
+            break;
+
+        case 5:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->Context->CornersCount;
+            break;
+
+        case 6:
+        case 7:
+            {
+                xarray*  array = nullptr;
+                XVarType type  = ( id == 6 ) ? XVT_Point : XVT_R4;
+
+                ret = XArrayAllocate( &array, type, mData->Context->CornersCount );
+
+                if ( ret == SuccessCode )
+                {
+                    xvariant v;
+
+                    v.type = type;
+
+                    for ( uint32_t i = 0; i < mData->Context->CornersCount; i++ )
+                    {
+                        if ( id == 6 )
+                        {
+                            v.value.pointVal = mData->Context->Corners[i].Point;
+                        }
+                        else
+                        {
+                            v.value.fVal = mData->Context->Corners[i].Score;
+                        }
+
+                        XArraySet( array, i, &v );
+                    }
+
+                    value->type = type | XVT_Array;
+                    value->value.arrayVal = array;
+                }
+            }
+            break;
+
+        default:
+            ret = ErrorInvalidProperty;
+        }
+    }
+
+    return ret;
+}
+
+// Set the specified property value of the plug-in
+XErrorCode CornersDetectorPlugin::SetProperty( int32_t id, const xvariant* value )
+{
+    XErrorCode ret = SuccessCode;
+
+    xvariant convertedValue;
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 8, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            mData->Detector = XMIN( convertedValue.value.ubVal, 1 );
+            break;
+
+        case 1:
+            mData->FastThreshold = XMAX( convertedValue.value.ubVal, 1 );
+            break;
+
+        case 2:
+            mData->QualityLevel = XINRANGE( convertedValue.value.fVal, 0.0f, 1.0f );
+            break;
+
+        case 3:
+            mData->CellSize = XINRANGE( convertedValue.value.usVal, 2, 256 );
+            break;
+
+        case 4:
+            mData->MaxCorners = XINRANGE( convertedValue.value.uiVal, 1, 10000 );
+            break;
+
+        default:
+            ret = ErrorReadOnlyProperty;
+            break;
+        }
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
+}
+
+// Get individual corners' values
+XErrorCode CornersDetectorPlugin::GetIndexedProperty( int32_t id, uint32_t index, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( id < 6 )
+    {
+        ret = ErrorNotIndexedProperty;
+    }
+    else if ( id > 7 )
+    {
+        ret = ErrorInvalidProperty;
+    }
+    else if ( !mData->LastProcessingSucceeded )
+    {
+        ret = ErrorInitializationFailed;
+    }
+    else if ( index >= mData->Context->CornersCount )
+    {
+        ret = ErrorIndexOutOfBounds;
+    }
+    else if ( id == 6 )
+    {
+        value->type = XVT_Point;
+        value->value.pointVal = mData->Context->Corners[index].Point;
+    }
+    else
+    {
+        value->type = XVT_R4;
+        value->value.fVal = mData->Context->Corners[index].Score;
+    }
+
+    return ret;
+}
@@ -0,0 +1,210 @@
+/*
+    Feature points detection and tracking plug-ins for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include "CornersDetectorPlugin.hpp"
+#include <image_detection_plugin_16x16.h>
+
+static void PluginInitializer( );
+static void PluginCleaner( );
+static XErrorCode UpdateFastProperties( PropertyDescriptor* desc, const xvariant* parentValue );
+static XErrorCode UpdateHarrisProperties( PropertyDescriptor* desc, const xvariant* parentValue );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000025, 0x00000001 };
+
+// Detector property
+static PropertyDescriptor detectorProperty =
+{ XVT_U1, "Detector", "detector", "Corners detector to use.", PropertyFlag_SelectionByIndex };
+// FAST Threshold property
+static PropertyDescriptor fastThresholdProperty =
+{ XVT_U1, "FAST Threshold", "fastThreshold", "Minimum difference between the center pixel and pixels of the circle around it.", PropertyFlag_Dependent };
+// Quality Level property
+static PropertyDescriptor qualityLevelProperty =
+{ XVT_R4, "Quality Level", "qualityLevel", "Minimum Harris response relative to the strongest one in the image.", PropertyFlag_Dependent };
+// Cell Size property
+static PropertyDescriptor cellSizeProperty =
+{ XVT_U2, "Cell Size", "cellSize", "Size of grid's cells - only the strongest corner is kept in each cell.", PropertyFlag_None };
+// Max Corners property
+static PropertyDescriptor maxCornersProperty =
+{ XVT_U4, "Max Corners", "maxCorners", "Maximum number of corners to provide (the strongest ones).", PropertyFlag_None };
+
+// Corners Found property
+static PropertyDescriptor cornersFoundProperty =
+{ XVT_U4, "Corners Found", "cornersFound", "Number of corners found in the processed image.", PropertyFlag_ReadOnly };
+// Corners property
+static PropertyDescriptor cornersProperty =
+{ XVT_Point | XVT_Array, "Corners", "corners", "Coordinates of found corners.", PropertyFlag_ReadOnly };
+// Corners Score property
+static PropertyDescriptor cornersScoreProperty =
+{ XVT_R4 | XVT_Array, "Corners Score", "cornersScore", "Score of found corners.", PropertyFlag_ReadOnly };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &detectorProperty, &fastThresholdProperty, &qualityLevelProperty, &cellSizeProperty, &maxCornersProperty,
+    &cornersFoundProperty, &cornersProperty, &cornersScoreProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** CornersDetectorPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS
+(
+    PluginID,
+    PluginFamilyID_Default,
+
+    PluginType_ImageProcessing,
+    PluginVersion,
+    "Corners Detector",
+    "CornersDetector",
+    "Finds corners in images using FAST or Harris detector.",
+
+    /* Long description */
+    "The plug-in finds corners (feature points), which are good for tracking. <b>FAST</b> detector treats a "
+    "pixel as corner if at least 9 contiguous pixels on the circle around it are all brighter or darker by the "
+    "specified threshold. <b>Harris</b> detector finds pixels where image changes significantly in all directions "
+    "and it is a bit slower.<br><br>"
+    "To get corners distributed evenly, the image is divided into grid of cells and only the strongest corner "
+    "is kept in each cell. Found corners are sorted by their score in descending order."
+    ,
+    &image_detection_plugin_16x16, // small icon
+    nullptr,
+    CornersDetectorPlugin,
+
+    XARRAY_SIZE( pluginProperties ),
+    pluginProperties,
+    PluginInitializer,
+    PluginCleaner,
+    nullptr  // no dynamic properties update
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    // Detector property
+    static const char* detectors[] = { "FAST", "Harris" };
+
+    InitSelectionProperty( &detectorProperty, detectors, XARRAY_SIZE( detectors ), 0 );
+
+    // FAST Threshold property
+    fastThresholdProperty.DefaultValue.type        = XVT_U1;
+    fastThresholdProperty.DefaultValue.value.ubVal = 20;
+
+    fastThresholdProperty.MinValue.type        = XVT_U1;
+    fastThresholdProperty.MinValue.value.ubVal = 1;
+
+    fastThresholdProperty.MaxValue.type        = XVT_U1;
+    fastThresholdProperty.MaxValue.value.ubVal = 255;
+
+    fastThresholdProperty.ParentProperty = 0;
+    fastThresholdProperty.Updater        = UpdateFastProperties;
+
+    // Quality Level property
+    qualityLevelProperty.DefaultValue.type       = XVT_R4;
+    qualityLevelProperty.DefaultValue.value.fVal = 0.01f;
+
+    qualityLevelProperty.MinValue.type       = XVT_R4;
+    qualityLevelProperty.MinValue.value.fVal = 0.0f;
+
+    qualityLevelProperty.MaxValue.type       = XVT_R4;
+    qualityLevelProperty.MaxValue.value.fVal = 1.0f;
+
+    qualityLevelProperty.ParentProperty = 0;
+    qualityLevelProperty.Updater        = UpdateHarrisProperties;
+
+    // Cell Size property
+    cellSizeProperty.DefaultValue.type        = XVT_U2;
+    cellSizeProperty.DefaultValue.value.usVal = 16;
+
+    cellSizeProperty.MinValue.type        = XVT_U2;
+    cellSizeProperty.MinValue.value.usVal = 2;
+
+    cellSizeProperty.MaxValue.type        = XVT_U2;
+    cellSizeProperty.MaxValue.value.usVal = 256;
+
+    // Max Corners property
+    maxCornersProperty.DefaultValue.type        = XVT_U4;
+    maxCornersProperty.DefaultValue.value.uiVal = 500;
+
+    maxCornersProperty.MinValue.type        = XVT_U4;
+    maxCornersProperty.MinValue.value.uiVal = 1;
+
+    maxCornersProperty.MaxValue.type        = XVT_U4;
+    maxCornersProperty.MaxValue.value.uiVal = 10000;
+}
+
+// Clean-up plugin - deallocate strings
+static void PluginCleaner( )
+{
+    CleanSelectionProperty( &detectorProperty );
+}
+
+// Enable FAST's properties only if it is the selected detector
+XErrorCode UpdateFastProperties( PropertyDescriptor* desc, const xvariant* parentValue )
+{
+    XErrorCode ret = ErrorFailed;
+    uint8_t    detector;
+
+    ret = XVariantToUByte( parentValue, &detector );
+
+    if ( ret == SuccessCode )
+    {
+        if ( detector == 0 )
+        {
+            desc->Flags &= ( ~PropertyFlag_Disabled );
+        }
+        else
+        {
+            desc->Flags |= PropertyFlag_Disabled;
+        }
+    }
+
+    return ret;
+}
+
+// Enable Harris' properties only if it is the selected detector
+XErrorCode UpdateHarrisProperties( PropertyDescriptor* desc, const xvariant* parentValue )
+{
+    XErrorCode ret = ErrorFailed;
+    uint8_t    detector;
+
+    ret = XVariantToUByte( parentValue, &detector );
+
+    if ( ret == SuccessCode )
+    {
+        if ( detector == 1 )
+        {
+            desc->Flags &= ( ~PropertyFlag_Disabled );
+        }
+        else
+        {
+            desc->Flags |= PropertyFlag_Disabled;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,415 @@
+/*
+    Feature points detection and tracking plug-ins for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <math.h>
+#include <vector>
+#include <xvision.h>
+#include "FeaturePointsTrackerPlugin.hpp"
+
+using namespace std;
+
+namespace Private
+{
+    class FeaturePointsTrackerPluginData
+    {
+    public:
+        OpticalFlowContext*      FlowContext;
+        CornersDetectionContext* CornersContext;
+
+        uint32_t        MaxPoints;
+        uint32_t        MinPoints;
+        uint8_t         FastThreshold;
+        uint16_t        WindowSize;
+        uint8_t         PyramidLevels;
+        uint8_t         MaxIterations;
+        float           MaxError;
+        float           MotionThreshold;
+        float           MotionLevel;
+
+        vector<xpointf> Points;          // points tracked to the last frame
+        vector<xpointf> PreviousPoints;  // their positions in the previous frame
+        vector<xpointf> NextPoints;      // points to track to the next frame (tracked + newly detected)
+        vector<bool>    OccupiedCells;
+
+    public:
+        FeaturePointsTrackerPluginData( ) :
+            FlowContext( nullptr ), CornersContext( nullptr ),
+            MaxPoints( 300 ), MinPoints( 150 ), FastThreshold( 20 ), WindowSize( 15 ),
+            PyramidLevels( 3 ), MaxIterations( 10 ), MaxError( 30.0f ), MotionThreshold( 2.0f ), MotionLevel( 0.0f )
+        {
+        }
+
+        ~FeaturePointsTrackerPluginData( )
+        {
+            FreeOpticalFlowContext( &FlowContext );
+            FreeCornersDetectionContext( &CornersContext );
+        }
+
+        XErrorCode DetectNewPoints( const ximage* image );
+    };
+}
+
+// Supported pixel formats of input images
+const XPixelFormat FeaturePointsTrackerPlugin::supportedPixelFormats[] =
+{
+    XPixelFormatGrayscale8, XPixelFormatRGB24, XPixelFormatRGBA32
+};
+
+FeaturePointsTrackerPlugin::FeaturePointsTrackerPlugin( ) :
+    mData( new ::Private::FeaturePointsTrackerPluginData( ) )
+{
+}
+
+FeaturePointsTrackerPlugin::~FeaturePointsTrackerPlugin( )
+{
+    delete mData;
+}
+
+void FeaturePointsTrackerPlugin::Dispose( )
+{
+    delete this;
+}
+
+// Get specified property value of the plug-in
+XErrorCode FeaturePointsTrackerPlugin::GetProperty( int32_t id, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    switch ( id )
+    {
+    case 0:
+        value->type        = XVT_U4;
+        value->value.uiVal = mData->MaxPoints;
+        break;
+
+    case 1:
+        value->type        = XVT_U4;
+        value->value.uiVal = mData->MinPoints;
+        break;
+
+    case 2:
+        value->type        = XVT_U1;
+        value->value.ubVal = mData->FastThreshold;
+        break;
+
+    case 3:
+        value->type        = XVT_U2;
+        value->value.usVal = mData->WindowSize;
+        break;
+
+    case 4:
+        value->type        = XVT_U1;
+        value->value.ubVal = mData->PyramidLevels;
+        break;
+
+    case 5:
+        value->type        = XVT_U1;
+        value->value.ubVal = mData->MaxIterations;
+        break;
+
+    case 6:
+        value->type       = XVT_R4;
+        value->value.fVal = mData->MaxError;
+        break;
+
+    case 7:
+        value->type       = XVT_R4;
+        value->value.fVal = mData->MotionThreshold;
+        break;
+
+    case 8:
+        value->type        = XVT_U4;
+        value->value.uiVal = static_cast<uint32_t>( mData->Points.size( ) );
+        break;
+
+    case 9:
+    case 10:
+    case 11:
+        {
+            uint32_t count = static_cast<uint32_t>( mData->Points.size( ) );
+            xarray*  array = nullptr;
+
+            ret = XArrayAllocate( &array, XVT_PointF, count );
+
+            if ( ret == SuccessCode )
+            {
+                xvariant v;
+
+                v.type = XVT_PointF;
+
+                for ( uint32_t i = 0; i < count; i++ )
+                {
+                    GetIndexedProperty( id, i, &v );
+                    XArraySet( array, i, &v );
+                }
+
+                value->type           = XVT_PointF | XVT_Array;
+                value->value.arrayVal = array;
+            }
+        }
+        break;
+
+    case 12:
+        value->type       = XVT_R4;
+        value->value.fVal = mData->MotionLevel;
+        break;
+
+    default:
+        ret = ErrorInvalidProperty;
+        break;
+    }
+
+    return ret;
+}
+
+// Set specified property value of the plug-in
+XErrorCode FeaturePointsTrackerPlugin::SetProperty( int32_t id, const xvariant* value )
+{
+    XErrorCode ret = SuccessCode;
+
+    xvariant convertedValue;
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 13, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            mData->MaxPoints = XINRANGE( convertedValue.value.uiVal, 10, 2000 );
+            break;
+
+        case 1:
+            mData->MinPoints = XMIN( convertedValue.value.uiVal, 2000 );
+            break;
+
+        case 2:
+            mData->FastThreshold = XMAX( convertedValue.value.ubVal, 1 );
+            break;
+
+        case 3:
+            // window size must be odd
+            mData->WindowSize = XINRANGE( convertedValue.value.usVal, 3, 31 ) | 1;
+            break;
+
+        case 4:
+            mData->PyramidLevels = XINRANGE( convertedValue.value.ubVal, 1, 6 );
+            break;
+
+        case 5:
+            mData->MaxIterations = XINRANGE( convertedValue.value.ubVal, 1, 50 );
+            break;
+
+        case 6:
+            mData->MaxError = XINRANGE( convertedValue.value.fVal, 1.0f, 255.0f );
+            break;
+
+        case 7:
+            mData->MotionThreshold = XINRANGE( convertedValue.value.fVal, 0.0f, 100.0f );
+            break;
+
+        default:
+            ret = ErrorReadOnlyProperty;
+            break;
+        }
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
+}
+
+// Get individual points of tracking results
+XErrorCode FeaturePointsTrackerPlugin::GetIndexedProperty( int32_t id, uint32_t index, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( id < 9 )
+    {
+        ret = ErrorNotIndexedProperty;
+    }
+    else if ( id > 11 )
+    {
+        ret = ( id == 12 ) ? ErrorNotIndexedProperty : ErrorInvalidProperty;
+    }
+    else if ( index >= mData->Points.size( ) )
+    {
+        ret = ErrorIndexOutOfBounds;
+    }
+    else
+    {
+        value->type = XVT_PointF;
+
+        if ( id == 9 )
+        {
+            value->value.fpointVal = mData->Points[index];
+        }
+        else if ( id == 10 )
+        {
+            value->value.fpointVal = mData->PreviousPoints[index];
+        }
+        else
+        {
+            value->value.fpointVal.x = mData->Points[index].x - mData->PreviousPoints[index].x;
+            value->value.fpointVal.y = mData->Points[index].y - mData->PreviousPoints[index].y;
+        }
+    }
+
+    return ret;
+}
+
+// Check if the plug-in does changes to input video frames or not
+bool FeaturePointsTrackerPlugin::IsReadOnlyMode( )
+{
+    return true;
+}
+
+// Get pixel formats supported by the plug-in
+XErrorCode FeaturePointsTrackerPlugin::GetSupportedPixelFormats( XPixelFormat* pixelFormats, int32_t* count )
+{
+    return GetSupportedPixelFormatsImpl( supportedPixelFormats, XARRAY_SIZE( supportedPixelFormats ), pixelFormats, count );
+}
+
+// Process the specified video frame
+XErrorCode FeaturePointsTrackerPlugin::ProcessImage( ximage* src )
+{
+    XErrorCode ret = ErrorFailed;
+
+    mData->MotionLevel = 0.0f;
+    mData->Points.clear( );
+    mData->PreviousPoints.clear( );
+
+    if ( src == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else
+    {
+        // track points found/tracked on the previous frame (pyramid of this frame is kept for the next call)
+        ret = TrackPointsLucasKanade( src, ( mData->NextPoints.empty( ) ) ? nullptr : &mData->NextPoints[0],
+                                      static_cast<uint32_t>( mData->NextPoints.size( ) ),
+                                      mData->WindowSize, mData->PyramidLevels, mData->MaxIterations, &mData->FlowContext );
+
+        if ( ret == SuccessCode )
+        {
+            float motionSum = 0.0f;
+
+            for ( uint32_t i = 0; i < mData->FlowContext->PointsCount; i++ )
+            {
+                const TrackedPoint* tracked = &mData->FlowContext->Points[i];
+
+                if ( ( tracked->Found ) && ( tracked->Error <= mData->MaxError ) )
+                {
+                    const xpointf& prev = mData->NextPoints[i];
+                    float          dx   = tracked->Point.x - prev.x;
+                    float          dy   = tracked->Point.y - prev.y;
+
+                    mData->PreviousPoints.push_back( prev );
+                    mData->Points.push_back( tracked->Point );
+
+                    motionSum += sqrtf( dx * dx + dy * dy );
+                }
+            }
+
+            if ( !mData->Points.empty( ) )
+            {
+                mData->MotionLevel = motionSum / mData->Points.size( );
+            }
+
+            mData->NextPoints = mData->Points;
+
+            if ( mData->NextPoints.size( ) < XMAX( mData->MinPoints, 1u ) )
+            {
+                ret = mData->DetectNewPoints( src );
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Check if the plug-in triggered detection on the last processed image
+bool FeaturePointsTrackerPlugin::Detected( )
+{
+    return ( ( !mData->Points.empty( ) ) && ( mData->MotionLevel >= mData->MotionThreshold ) );
+}
+
+// Reset run time state of the video processing plug-in
+void FeaturePointsTrackerPlugin::Reset( )
+{
+    if ( mData->FlowContext != nullptr )
+    {
+        ResetOpticalFlowContext( mData->FlowContext );
+    }
+
+    mData->Points.clear( );
+    mData->PreviousPoints.clear( );
+    mData->NextPoints.clear( );
+    mData->MotionLevel = 0.0f;
+}
+
+namespace Private
+{
+
+// Detect new corners in the areas not covered by tracked points and add them to the list of points to track
+XErrorCode FeaturePointsTrackerPluginData::DetectNewPoints( const ximage* image )
+{
+    // size of cells is chosen so the grid has about as many cells as points to track
+    uint16_t   cellSize = static_cast<uint16_t>( XMAX( 8, static_cast<int>( sqrtf( static_cast<float>( image->width ) * image->height / MaxPoints ) ) ) );
+    XErrorCode ret      = FindFastCorners( image, FastThreshold, cellSize, MaxPoints, &CornersContext );
+
+    if ( ret == SuccessCode )
+    {
+        int cellsX = ( image->width  + cellSize - 1 ) / cellSize;
+        int cellsY = ( image->height + cellSize - 1 ) / cellSize;
+
+        OccupiedCells.assign( cellsX * cellsY, false );
+
+        for ( vector<xpointf>::const_iterator it = NextPoints.begin( ); it != NextPoints.end( ); ++it )
+        {
+            int cx = XINRANGE( static_cast<int>( it->x ) / cellSize, 0, cellsX - 1 );
+            int cy = XINRANGE( static_cast<int>( it->y ) / cellSize, 0, cellsY - 1 );
+
+            OccupiedCells[cy * cellsX + cx] = true;
+        }
+
+        // corners are sorted by score, so the strongest ones are taken first
+        for ( uint32_t i = 0; ( i < CornersContext->CornersCount ) && ( NextPoints.size( ) < MaxPoints ); i++ )
+        {
+            const xpoint& corner = CornersContext->Corners[i].Point;
+            int           cell   = ( corner.y / cellSize ) * cellsX + corner.x / cellSize;
+
+            if ( !OccupiedCells[cell] )
+            {
+                xpointf point = { static_cast<float>( corner.x ), static_cast<float>( corner.y ) };
+
+                OccupiedCells[cell] = true;
+                NextPoints.push_back( point );
+            }
+        }
+    }
+
+    return ret;
+}
+
+} // namespace Private
@@ -0,0 +1,194 @@
+/*
+    Feature points detection and tracking plug-ins for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include "FeaturePointsTrackerPlugin.hpp"
+#include <image_simple_motion_detection_16x16.h>
+
+static void PluginInitializer( );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000025, 0x00000002 };
+
+// Plug-in properties
+static PropertyDescriptor maxPointsProperty =
+{ XVT_U4, "Max Points", "maxPoints", "Maximum number of points to track.", PropertyFlag_None };
+static PropertyDescriptor minPointsProperty =
+{ XVT_U4, "Min Points", "minPoints", "Number of tracked points, below which new points are detected.", PropertyFlag_None };
+static PropertyDescriptor fastThresholdProperty =
+{ XVT_U1, "FAST Threshold", "fastThreshold", "Threshold of FAST corners detector used to find new points.", PropertyFlag_None };
+static PropertyDescriptor windowSizeProperty =
+{ XVT_U2, "Window Size", "windowSize", "Size of window around points used by optical flow.", PropertyFlag_None };
+static PropertyDescriptor pyramidLevelsProperty =
+{ XVT_U1, "Pyramid Levels", "pyramidLevels", "Number of image pyramid's levels to use for tracking.", PropertyFlag_None };
+static PropertyDescriptor maxIterationsProperty =
+{ XVT_U1, "Max Iterations", "maxIterations", "Maximum number of iterations done on each level of pyramid.", PropertyFlag_None };
+static PropertyDescriptor maxErrorProperty =
+{ XVT_R4, "Max Error", "maxError", "Maximum average difference of pixels around a point to keep tracking it.", PropertyFlag_None };
+static PropertyDescriptor motionThresholdProperty =
+{ XVT_R4, "Motion Threshold", "motionThreshold", "Average movement of points (in pixels) to trigger motion detection.", PropertyFlag_None };
+
+static PropertyDescriptor pointsTrackedProperty =
+{ XVT_U4, "Points Tracked", "pointsTracked", "Number of points tracked from the previous frame.", PropertyFlag_ReadOnly };
+static PropertyDescriptor pointsProperty =
+{ XVT_PointF | XVT_Array, "Points", "points", "Positions of tracked points in the last frame.", PropertyFlag_ReadOnly };
+static PropertyDescriptor previousPointsProperty =
+{ XVT_PointF | XVT_Array, "Previous Points", "previousPoints", "Positions of tracked points in the previous frame.", PropertyFlag_ReadOnly };
+static PropertyDescriptor flowProperty =
+{ XVT_PointF | XVT_Array, "Flow", "flow", "Movement of tracked points since the previous frame.", PropertyFlag_ReadOnly };
+static PropertyDescriptor motionLevelProperty =
+{ XVT_R4, "Motion Level", "motionLevel", "Average movement of tracked points, pixels.", PropertyFlag_ReadOnly };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &maxPointsProperty, &minPointsProperty, &fastThresholdProperty, &windowSizeProperty,
+    &pyramidLevelsProperty, &maxIterationsProperty, &maxErrorProperty, &motionThresholdProperty,
+    &pointsTrackedProperty, &pointsProperty, &previousPointsProperty, &flowProperty, &motionLevelProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** FeaturePointsTrackerPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS
+(
+    PluginID,
+    PluginFamilyID_Detection,
+
+    PluginType_Detection,
+    PluginVersion,
+    "Feature Points Tracker",
+    "FeaturePointsTracker",
+    "Tracks feature points between video frames using pyramidal Lucas-Kanade optical flow.",
+
+    /* Long description */
+    "The plug-in finds corners in video frames using FAST detector and tracks them to the next frames "
+    "using sparse pyramidal Lucas-Kanade optical flow. Points, which are lost or whose neighbourhood has "
+    "changed too much (see <b>max error</b>), are dropped. When number of tracked points drops below "
+    "the <b>min points</b> value, new points are detected in the areas, which have no tracked points yet.<br><br>"
+    "The plug-in provides positions of tracked points in the previous and the last frames, as well as their "
+    "movement (flow). Motion is reported as detected when average movement of points exceeds the specified "
+    "<b>motion threshold</b>.<br><br>"
+    "Pyramid of every frame is built once and reused as the previous one for the next frame. The "
+    "plug-in does not modify video frames."
+    ,
+    &image_simple_motion_detection_16x16,
+    nullptr,
+    FeaturePointsTrackerPlugin,
+
+    XARRAY_SIZE( pluginProperties ),
+    pluginProperties,
+    PluginInitializer,
+    nullptr,
+    nullptr,
+    0,
+    nullptr,
+    PluginFlag_NotSplittable
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    // Max Points
+    maxPointsProperty.DefaultValue.type        = XVT_U4;
+    maxPointsProperty.DefaultValue.value.uiVal = 300;
+
+    maxPointsProperty.MinValue.type        = XVT_U4;
+    maxPointsProperty.MinValue.value.uiVal = 10;
+
+    maxPointsProperty.MaxValue.type        = XVT_U4;
+    maxPointsProperty.MaxValue.value.uiVal = 2000;
+
+    // Min Points
+    minPointsProperty.DefaultValue.type        = XVT_U4;
+    minPointsProperty.DefaultValue.value.uiVal = 150;
+
+    minPointsProperty.MinValue.type        = XVT_U4;
+    minPointsProperty.MinValue.value.uiVal = 0;
+
+    minPointsProperty.MaxValue.type        = XVT_U4;
+    minPointsProperty.MaxValue.value.uiVal = 2000;
+
+    // FAST Threshold
+    fastThresholdProperty.DefaultValue.type        = XVT_U1;
+    fastThresholdProperty.DefaultValue.value.ubVal = 20;
+
+    fastThresholdProperty.MinValue.type        = XVT_U1;
+    fastThresholdProperty.MinValue.value.ubVal = 1;
+
+    fastThresholdProperty.MaxValue.type        = XVT_U1;
+    fastThresholdProperty.MaxValue.value.ubVal = 255;
+
+    // Window Size
+    windowSizeProperty.DefaultValue.type        = XVT_U2;
+    windowSizeProperty.DefaultValue.value.usVal = 15;
+
+    windowSizeProperty.MinValue.type        = XVT_U2;
+    windowSizeProperty.MinValue.value.usVal = 3;
+
+    windowSizeProperty.MaxValue.type        = XVT_U2;
+    windowSizeProperty.MaxValue.value.usVal = 31;
+
+    // Pyramid Levels
+    pyramidLevelsProperty.DefaultValue.type        = XVT_U1;
+    pyramidLevelsProperty.DefaultValue.value.ubVal = 3;
+
+    pyramidLevelsProperty.MinValue.type        = XVT_U1;
+    pyramidLevelsProperty.MinValue.value.ubVal = 1;
+
+    pyramidLevelsProperty.MaxValue.type        = XVT_U1;
+    pyramidLevelsProperty.MaxValue.value.ubVal = 6;
+
+    // Max Iterations
+    maxIterationsProperty.DefaultValue.type        = XVT_U1;
+    maxIterationsProperty.DefaultValue.value.ubVal = 10;
+
+    maxIterationsProperty.MinValue.type        = XVT_U1;
+    maxIterationsProperty.MinValue.value.ubVal = 1;
+
+    maxIterationsProperty.MaxValue.type        = XVT_U1;
+    maxIterationsProperty.MaxValue.value.ubVal = 50;
+
+    // Max Error
+    maxErrorProperty.DefaultValue.type       = XVT_R4;
+    maxErrorProperty.DefaultValue.value.fVal = 30.0f;
+
+    maxErrorProperty.MinValue.type       = XVT_R4;
+    maxErrorProperty.MinValue.value.fVal = 1.0f;
+
+    maxErrorProperty.MaxValue.type       = XVT_R4;
+    maxErrorProperty.MaxValue.value.fVal = 255.0f;
+
+    // Motion Threshold
+    motionThresholdProperty.DefaultValue.type       = XVT_R4;
+    motionThresholdProperty.DefaultValue.value.fVal = 2.0f;
+
+    motionThresholdProperty.MinValue.type       = XVT_R4;
+    motionThresholdProperty.MinValue.value.fVal = 0.0f;
+
+    motionThresholdProperty.MaxValue.type       = XVT_R4;
+    motionThresholdProperty.MaxValue.value.fVal = 100.0f;
+}
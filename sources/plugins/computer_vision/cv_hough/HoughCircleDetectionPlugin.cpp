@@ -0,0 +1,264 @@
+/*
+    Hough transformation plug-ins for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "HoughCircleDetectionPlugin.hpp"
+#include <xvision.h>
+
+namespace Private
+{
+    class HoughCircleDetectionPluginData
+    {
+    public:
+        HoughCirclesContext* Context;
+        bool                 LastProcessingSucceeded;
+        uint32_t             MinRadius;
+        uint32_t             MaxRadius;
+        uint32_t             MinIntensity;
+        uint32_t             MaxCircles;
+
+    public:
+        HoughCircleDetectionPluginData( ) :
+            Context( nullptr ), LastProcessingSucceeded( false ),
+            MinRadius( 10 ), MaxRadius( 50 ), MinIntensity( 50 ), MaxCircles( 10 )
+        {
+        }
+
+        ~HoughCircleDetectionPluginData( )
+        {
+            FreeHoughCirclesContext( &Context );
+        }
+
+        void GetCircleValues( uint32_t index, uint32_t* values ) const
+        {
+            HoughCircle* circle = &Context->Circles[index];
+
+            values[0] = (uint32_t) circle->Center.x;
+            values[1] = (uint32_t) circle->Center.y;
+            values[2] = circle->Radius;
+            values[3] = circle->Intensity;
+        }
+    };
+};
+
+// Supported pixel formats of input/output images
+const XPixelFormat HoughCircleDetectionPlugin::supportedFormats[] =
+{
+    XPixelFormatGrayscale8
+};
+
+HoughCircleDetectionPlugin::HoughCircleDetectionPlugin( ) :
+    mData( new Private::HoughCircleDetectionPluginData( ) )
+{
+}
+
+HoughCircleDetectionPlugin::~HoughCircleDetectionPlugin( )
+{
+    delete mData;
+}
+
+void HoughCircleDetectionPlugin::Dispose( )
+{
+    delete this;
+}
+
+// Provide supported pixel formats
+XErrorCode HoughCircleDetectionPlugin::GetSupportedPixelFormats( XPixelFormat* formats, int32_t* count )
+{
+    return GetSupportedPixelFormatsImpl( supportedFormats, XARRAY_SIZE( supportedFormats ), formats, count );
+}
+
+// Find circles in the specified edges image
+XErrorCode HoughCircleDetectionPlugin::ProcessImage( const ximage* image )
+{
+    XErrorCode ret = FindHoughCircles( image, nullptr, XMIN( mData->MinRadius, mData->MaxRadius ), XMAX( mData->MinRadius, mData->MaxRadius ),
+                                       mData->MinIntensity, mData->MaxCircles, &mData->Context );
+
+    mData->LastProcessingSucceeded = ( ret == SuccessCode );
+
+    return ret;
+}
+
+// Get the specified property value of the plug-in
+XErrorCode HoughCircleDetectionPlugin::GetProperty( int32_t id, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( id >= 4 ) && ( !mData->LastProcessingSucceeded ) )
+    {
+        ret = ErrorInitializationFailed;
+    }
+    else
+    {
+        switch ( id )
+        {
+        case 0:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->MinRadius;
+            break;
+
+        case 1:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->MaxRadius;
+            break;
+
+        case 2:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->MinIntensity;
+            break;
+
+        case 3:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->MaxCircles;
+            break;
+
+        case 4:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->Context->CirclesCount;
+            break;
+
+        case 5:
+            {
+                xarray2d* array = nullptr;
+
+                ret = XArrayAllocate2d( &array, XVT_U4, mData->Context->CirclesCount, 4 );
+
+                if ( ret == SuccessCode )
+                {
+                    xvariant v;
+                    uint32_t values[4];
+
+                    v.type = XVT_U4;
+
+                    for ( uint32_t i = 0; i < mData->Context->CirclesCount; i++ )
+                    {
+                        mData->GetCircleValues( i, values );
+
+                        for ( uint32_t j = 0; j < 4; j++ )
+                        {
+                            v.value.uiVal = values[j];
+                            XArraySet2d( array, i, j, &v );
+                        }
+                    }
+
+                    value->type = XVT_U4 | XVT_Array2d;
+                    value->value.array2Val = array;
+                }
+            }
+            break;
+
+        default:
+            ret = ErrorInvalidProperty;
+        }
+    }
+
+    return ret;
+}
+
+// Set the specified property value of the plug-in
+XErrorCode HoughCircleDetectionPlugin::SetProperty( int32_t id, const xvariant* value )
+{
+    XErrorCode ret = SuccessCode;
+
+    xvariant convertedValue;
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 6, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            mData->MinRadius = XINRANGE( convertedValue.value.uiVal, 1, 1000 );
+            break;
+
+        case 1:
+            mData->MaxRadius = XINRANGE( convertedValue.value.uiVal, 1, 1000 );
+            break;
+
+        case 2:
+            mData->MinIntensity = XINRANGE( convertedValue.value.uiVal, 1, 10000 );
+            break;
+
+        case 3:
+            mData->MaxCircles = XINRANGE( convertedValue.value.uiVal, 1, 100 );
+            break;
+
+        default:
+            ret = ErrorReadOnlyProperty;
+            break;
+        }
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
+}
+
+// Get individual circles' values
+XErrorCode HoughCircleDetectionPlugin::GetIndexedProperty( int32_t id, uint32_t index, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( id < 5 )
+    {
+        ret = ErrorNotIndexedProperty;
+    }
+    else if ( id > 5 )
+    {
+        ret = ErrorInvalidProperty;
+    }
+    else if ( !mData->LastProcessingSucceeded )
+    {
+        ret = ErrorInitializationFailed;
+    }
+    else if ( index >= mData->Context->CirclesCount )
+    {
+        ret = ErrorIndexOutOfBounds;
+    }
+    else
+    {
+        xarray* array = nullptr;
+
+        ret = XArrayAllocate( &array, XVT_U4, 4 );
+        if ( ret == SuccessCode )
+        {
+            xvariant v;
+            uint32_t values[4];
+
+            mData->GetCircleValues( index, values );
+
+            v.type = XVT_U4;
+
+            for ( uint32_t i = 0; i < 4; i++ )
+            {
+                v.value.uiVal = values[i];
+                XArraySet( array, i, &v );
+            }
+
+            value->type = XVT_U4 | XVT_Array;
+            value->value.arrayVal = array;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,139 @@
+/*
+    Hough transformation plug-ins for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include "HoughCircleDetectionPlugin.hpp"
+#include <image_filter_circles_16x16.h>
+
+static void PluginInitializer( );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000024, 0x00000002 };
+
+// Min Radius property
+static PropertyDescriptor minRadiusProperty =
+{ XVT_U4, "Min Radius", "minRadius", "Minimum radius of circles to find.", PropertyFlag_None };
+// Max Radius property
+static PropertyDescriptor maxRadiusProperty =
+{ XVT_U4, "Max Radius", "maxRadius", "Maximum radius of circles to find.", PropertyFlag_None };
+// Min Intensity property
+static PropertyDescriptor minIntensityProperty =
+{ XVT_U4, "Min Intensity", "minIntensity", "Minimum number of edge pixels, which must lie on a circle for it to be found.", PropertyFlag_None };
+// Max Circles property
+static PropertyDescriptor maxCirclesProperty =
+{ XVT_U4, "Max Circles", "maxCircles", "Maximum number of circles to provide.", PropertyFlag_None };
+
+// Circles Found property
+static PropertyDescriptor circlesFoundProperty =
+{ XVT_U4, "Circles Found", "circlesFound", "Number of circles found in the processed image.", PropertyFlag_ReadOnly };
+// Circles property
+static PropertyDescriptor circlesProperty =
+{ XVT_U4 | XVT_Array2d, "Circles", "circles", "Found circles - a row for every circle: center's X/Y, radius and intensity.", PropertyFlag_ReadOnly };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &minRadiusProperty, &maxRadiusProperty, &minIntensityProperty, &maxCirclesProperty,
+    &circlesFoundProperty, &circlesProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** HoughCircleDetectionPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS
+(
+    PluginID,
+    PluginFamilyID_Default,
+
+    PluginType_ImageProcessing,
+    PluginVersion,
+    "Hough Circle Detection",
+    "HoughCircleDetection",
+    "Finds circles in edges images using Hough transformation.",
+
+    /* Long description */
+    "The plug-in finds circles in images containing edges, like the ones provided by Canny Edge Detector "
+    "plug-in (non zero pixels are treated as edges). Every edge pixel votes for circles' centers lying along "
+    "its gradient direction (estimated from orientation of neighbour edge pixels) within the specified radius "
+    "range. Centers collecting the most votes are then checked to find radius of the circle and the number of "
+    "edge pixels lying on it (intensity).<br><br>"
+    "Note: circles with centers closer than minimum radius to an already found circle are ignored, which means "
+    "concentric circles are reported only once."
+    ,
+    &image_filter_circles_16x16, // small icon
+    nullptr,
+    HoughCircleDetectionPlugin,
+
+    XARRAY_SIZE( pluginProperties ),
+    pluginProperties,
+    PluginInitializer,
+    nullptr,
+    nullptr  // no dynamic properties update
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    // Min Radius property
+    minRadiusProperty.DefaultValue.type        = XVT_U4;
+    minRadiusProperty.DefaultValue.value.uiVal = 10;
+
+    minRadiusProperty.MinValue.type        = XVT_U4;
+    minRadiusProperty.MinValue.value.uiVal = 1;
+
+    minRadiusProperty.MaxValue.type        = XVT_U4;
+    minRadiusProperty.MaxValue.value.uiVal = 1000;
+
+    // Max Radius property
+    maxRadiusProperty.DefaultValue.type        = XVT_U4;
+    maxRadiusProperty.DefaultValue.value.uiVal = 50;
+
+    maxRadiusProperty.MinValue.type        = XVT_U4;
+    maxRadiusProperty.MinValue.value.uiVal = 1;
+
+    maxRadiusProperty.MaxValue.type        = XVT_U4;
+    maxRadiusProperty.MaxValue.value.uiVal = 1000;
+
+    // Min Intensity property
+    minIntensityProperty.DefaultValue.type        = XVT_U4;
+    minIntensityProperty.DefaultValue.value.uiVal = 50;
+
+    minIntensityProperty.MinValue.type        = XVT_U4;
+    minIntensityProperty.MinValue.value.uiVal = 1;
+
+    minIntensityProperty.MaxValue.type        = XVT_U4;
+    minIntensityProperty.MaxValue.value.uiVal = 10000;
+
+    // Max Circles property
+    maxCirclesProperty.DefaultValue.type        = XVT_U4;
+    maxCirclesProperty.DefaultValue.value.uiVal = 10;
+
+    maxCirclesProperty.MinValue.type        = XVT_U4;
+    maxCirclesProperty.MinValue.value.uiVal = 1;
+
+    maxCirclesProperty.MaxValue.type        = XVT_U4;
+    maxCirclesProperty.MaxValue.value.uiVal = 100;
+}
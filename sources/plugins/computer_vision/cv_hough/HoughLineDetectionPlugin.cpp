@@ -0,0 +1,336 @@
+/*
+    Hough transformation plug-ins for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "HoughLineDetectionPlugin.hpp"
+#include <xvision.h>
+
+namespace Private
+{
+    class HoughLineDetectionPluginData
+    {
+    public:
+        HoughLinesContext* Context;
+        bool               LastProcessingSucceeded;
+        int32_t            ImageWidth;
+        int32_t            ImageHeight;
+        uint32_t           MinIntensity;
+        uint32_t           MaxLines;
+        uint16_t           LocalPeakRadius;
+        uint16_t           GradientWindow;
+
+    public:
+        HoughLineDetectionPluginData( ) :
+            Context( nullptr ), LastProcessingSucceeded( false ), ImageWidth( 0 ), ImageHeight( 0 ),
+            MinIntensity( 100 ), MaxLines( 10 ), LocalPeakRadius( 4 ), GradientWindow( 0 )
+        {
+        }
+
+        ~HoughLineDetectionPluginData( )
+        {
+            FreeHoughLinesContext( &Context );
+        }
+
+        XErrorCode GetLineEndPoints( uint32_t index, xpoint* point1, xpoint* point2 ) const
+        {
+            return GetHoughLineEndPoints( &Context->Lines[index], ImageWidth, ImageHeight, point1, point2 );
+        }
+    };
+};
+
+// Supported pixel formats of input/output images
+const XPixelFormat HoughLineDetectionPlugin::supportedFormats[] =
+{
+    XPixelFormatGrayscale8
+};
+
+HoughLineDetectionPlugin::HoughLineDetectionPlugin( ) :
+    mData( new Private::HoughLineDetectionPluginData( ) )
+{
+}
+
+HoughLineDetectionPlugin::~HoughLineDetectionPlugin( )
+{
+    delete mData;
+}
+
+void HoughLineDetectionPlugin::Dispose( )
+{
+    delete this;
+}
+
+// Provide supported pixel formats
+XErrorCode HoughLineDetectionPlugin::GetSupportedPixelFormats( XPixelFormat* formats, int32_t* count )
+{
+    return GetSupportedPixelFormatsImpl( supportedFormats, XARRAY_SIZE( supportedFormats ), formats, count );
+}
+
+// Find lines in the specified edges image
+XErrorCode HoughLineDetectionPlugin::ProcessImage( const ximage* image )
+{
+    XErrorCode ret = FindHoughLines( image, nullptr, mData->GradientWindow, mData->MinIntensity,
+                                     mData->LocalPeakRadius, mData->MaxLines, &mData->Context );
+
+    mData->LastProcessingSucceeded = ( ret == SuccessCode );
+
+    if ( ret == SuccessCode )
+    {
+        mData->ImageWidth  = image->width;
+        mData->ImageHeight = image->height;
+    }
+
+    return ret;
+}
+
+// Get the specified property value of the plug-in
+XErrorCode HoughLineDetectionPlugin::GetProperty( int32_t id, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( ( id >= 4 ) && ( !mData->LastProcessingSucceeded ) )
+    {
+        ret = ErrorInitializationFailed;
+    }
+    else
+    {
+        switch ( id )
+        {
+        case 0:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->MinIntensity;
+            break;
+
+        case 1:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->MaxLines;
+            break;
+
+        case 2:
+            value->type = XVT_U2;
+            value->value.usVal = mData->LocalPeakRadius;
+            break;
+
+        case 3:
+            value->type = XVT_U2;
+            value->value.usVal = mData->GradientWindow;
+            break;
+
+        case 4:
+            value->type = XVT_U4;
+            value->value.uiVal = mData->Context->LinesCount;
+            break;
+
+        case 5:
+            {
+                xarray2d* array = nullptr;
+
+                ret = XArrayAllocate2d( &array, XVT_R4, mData->Context->LinesCount, 3 );
+
+                if ( ret == SuccessCode )
+                {
+                    xvariant v;
+
+                    v.type = XVT_R4;
+
+                    for ( uint32_t i = 0; i < mData->Context->LinesCount; i++ )
+                    {
+                        HoughLine* line = &mData->Context->Lines[i];
+
+                        v.value.fVal = line->Theta;
+                        XArraySet2d( array, i, 0, &v );
+                        v.value.fVal = line->Radius;
+                        XArraySet2d( array, i, 1, &v );
+                        v.value.fVal = (float) line->Intensity;
+                        XArraySet2d( array, i, 2, &v );
+                    }
+
+                    value->type = XVT_R4 | XVT_Array2d;
+                    value->value.array2Val = array;
+                }
+            }
+            break;
+
+        case 6:
+            {
+                xarrayJagged* array = nullptr;
+                uint32_t      i;
+
+                ret = XArrayAllocateJagged( &array, XVT_Point, mData->Context->LinesCount );
+                if ( ret == SuccessCode )
+                {
+                    for ( i = 0; i < mData->Context->LinesCount; i++ )
+                    {
+                        xvariant pointVar;
+                        xpoint   point1 = { 0, 0 }, point2 = { 0, 0 };
+
+                        ret = XArrayAllocateJaggedSub( array, i, 2 );
+
+                        if ( ret != SuccessCode )
+                        {
+                            break;
+                        }
+                        else
+                        {
+                            // lines are found within the image, so they always cross its borders
+                            mData->GetLineEndPoints( i, &point1, &point2 );
+
+                            pointVar.type           = XVT_Point;
+                            pointVar.value.pointVal = point1;
+                            XArraySetJagged( array, i, 0, &pointVar );
+
+                            pointVar.value.pointVal = point2;
+                            XArraySetJagged( array, i, 1, &pointVar );
+                        }
+                    }
+
+                    if ( ret != SuccessCode )
+                    {
+                        // free the main array if any of the inner array failed to create
+                        XArrayFreeJagged( &array );
+                    }
+                    else
+                    {
+                        value->type = XVT_Point | XVT_ArrayJagged;
+                        value->value.arrayJaggedVal = array;
+                    }
+                }
+            }
+            break;
+
+        default:
+            ret = ErrorInvalidProperty;
+        }
+    }
+
+    return ret;
+}
+
+// Set the specified property value of the plug-in
+XErrorCode HoughLineDetectionPlugin::SetProperty( int32_t id, const xvariant* value )
+{
+    XErrorCode ret = SuccessCode;
+
+    xvariant convertedValue;
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 7, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            mData->MinIntensity = XINRANGE( convertedValue.value.uiVal, 1, 10000 );
+            break;
+
+        case 1:
+            mData->MaxLines = XINRANGE( convertedValue.value.uiVal, 1, 100 );
+            break;
+
+        case 2:
+            mData->LocalPeakRadius = XINRANGE( convertedValue.value.usVal, 1, 20 );
+            break;
+
+        case 3:
+            mData->GradientWindow = XMIN( convertedValue.value.usVal, 45 );
+            break;
+
+        default:
+            ret = ErrorReadOnlyProperty;
+            break;
+        }
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
+}
+
+// Get individual lines' values
+XErrorCode HoughLineDetectionPlugin::GetIndexedProperty( int32_t id, uint32_t index, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( id < 5 )
+    {
+        ret = ErrorNotIndexedProperty;
+    }
+    else if ( id > 6 )
+    {
+        ret = ErrorInvalidProperty;
+    }
+    else if ( !mData->LastProcessingSucceeded )
+    {
+        ret = ErrorInitializationFailed;
+    }
+    else if ( index >= mData->Context->LinesCount )
+    {
+        ret = ErrorIndexOutOfBounds;
+    }
+    else
+    {
+        xarray*  array = nullptr;
+        xvariant v;
+
+        if ( id == 5 )
+        {
+            ret = XArrayAllocate( &array, XVT_R4, 3 );
+            if ( ret == SuccessCode )
+            {
+                HoughLine* line = &mData->Context->Lines[index];
+
+                v.type = XVT_R4;
+
+                v.value.fVal = line->Theta;
+                XArraySet( array, 0, &v );
+                v.value.fVal = line->Radius;
+                XArraySet( array, 1, &v );
+                v.value.fVal = (float) line->Intensity;
+                XArraySet( array, 2, &v );
+
+                value->type = XVT_R4 | XVT_Array;
+                value->value.arrayVal = array;
+            }
+        }
+        else
+        {
+            ret = XArrayAllocate( &array, XVT_Point, 2 );
+            if ( ret == SuccessCode )
+            {
+                xpoint point1 = { 0, 0 }, point2 = { 0, 0 };
+
+                mData->GetLineEndPoints( index, &point1, &point2 );
+
+                v.type = XVT_Point;
+
+                v.value.pointVal = point1;
+                XArraySet( array, 0, &v );
+                v.value.pointVal = point2;
+                XArraySet( array, 1, &v );
+
+                value->type = XVT_Point | XVT_Array;
+                value->value.arrayVal = array;
+            }
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,142 @@
+/*
+    Hough transformation plug-ins for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include "HoughLineDetectionPlugin.hpp"
+#include <image_objects_edges_16x16.h>
+
+static void PluginInitializer( );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000024, 0x00000001 };
+
+// Min Intensity property
+static PropertyDescriptor minIntensityProperty =
+{ XVT_U4, "Min Intensity", "minIntensity", "Minimum number of edge pixels, which must vote for a line to be found.", PropertyFlag_None };
+// Max Lines property
+static PropertyDescriptor maxLinesProperty =
+{ XVT_U4, "Max Lines", "maxLines", "Maximum number of lines to provide (the most intensive ones).", PropertyFlag_None };
+// Local Peak Radius property
+static PropertyDescriptor localPeakRadiusProperty =
+{ XVT_U2, "Local Peak Radius", "localPeakRadius", "Radius of Hough space's neighbourhood, where a line must have maximum intensity.", PropertyFlag_None };
+// Gradient Window property
+static PropertyDescriptor gradientWindowProperty =
+{ XVT_U2, "Gradient Window", "gradientWindow", "Maximum deviation of line's normal from edge's direction (degrees) for the edge pixel to vote for the line. Set to 0 to vote for all directions.", PropertyFlag_None };
+
+// Lines Found property
+static PropertyDescriptor linesFoundProperty =
+{ XVT_U4, "Lines Found", "linesFound", "Number of lines found in the processed image.", PropertyFlag_ReadOnly };
+// Lines property
+static PropertyDescriptor linesProperty =
+{ XVT_R4 | XVT_Array2d, "Lines", "lines", "Found lines - a row for every line: theta (degrees), radius and intensity.", PropertyFlag_ReadOnly };
+// Line End Points property
+static PropertyDescriptor lineEndPointsProperty =
+{ XVT_Point | XVT_ArrayJagged, "Line End Points", "lineEndPoints", "Points where found lines cross image's borders (2 points for each line).", PropertyFlag_ReadOnly };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &minIntensityProperty, &maxLinesProperty, &localPeakRadiusProperty, &gradientWindowProperty,
+    &linesFoundProperty, &linesProperty, &lineEndPointsProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** HoughLineDetectionPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS
+(
+    PluginID,
+    PluginFamilyID_Default,
+
+    PluginType_ImageProcessing,
+    PluginVersion,
+    "Hough Line Detection",
+    "HoughLineDetection",
+    "Finds straight lines in edges images using Hough transformation.",
+
+    /* Long description */
+    "The plug-in finds straight lines in images containing edges, like the ones provided by Canny Edge Detector "
+    "plug-in (non zero pixels are treated as edges). Every edge pixel votes for all lines which may go through "
+    "it and the lines collecting the most votes are provided. Each line is described in polar coordinates relative "
+    "to the image's center: <b>x*cos(theta) + y*sin(theta) = radius</b>, where Y axis goes down.<br><br>"
+    "If <b>Gradient Window</b> is set, edge pixels vote only for lines, which are nearly perpendicular to their "
+    "gradient direction (estimated from orientation of neighbour edge pixels). This reduces noise of Hough "
+    "space and speeds up processing."
+    ,
+    &image_objects_edges_16x16, // small icon
+    nullptr,
+    HoughLineDetectionPlugin,
+
+    XARRAY_SIZE( pluginProperties ),
+    pluginProperties,
+    PluginInitializer,
+    nullptr,
+    nullptr  // no dynamic properties update
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    // Min Intensity property
+    minIntensityProperty.DefaultValue.type        = XVT_U4;
+    minIntensityProperty.DefaultValue.value.uiVal = 100;
+
+    minIntensityProperty.MinValue.type        = XVT_U4;
+    minIntensityProperty.MinValue.value.uiVal = 1;
+
+    minIntensityProperty.MaxValue.type        = XVT_U4;
+    minIntensityProperty.MaxValue.value.uiVal = 10000;
+
+    // Max Lines property
+    maxLinesProperty.DefaultValue.type        = XVT_U4;
+    maxLinesProperty.DefaultValue.value.uiVal = 10;
+
+    maxLinesProperty.MinValue.type        = XVT_U4;
+    maxLinesProperty.MinValue.value.uiVal = 1;
+
+    maxLinesProperty.MaxValue.type        = XVT_U4;
+    maxLinesProperty.MaxValue.value.uiVal = 100;
+
+    // Local Peak Radius property
+    localPeakRadiusProperty.DefaultValue.type        = XVT_U2;
+    localPeakRadiusProperty.DefaultValue.value.usVal = 4;
+
+    localPeakRadiusProperty.MinValue.type        = XVT_U2;
+    localPeakRadiusProperty.MinValue.value.usVal = 1;
+
+    localPeakRadiusProperty.MaxValue.type        = XVT_U2;
+    localPeakRadiusProperty.MaxValue.value.usVal = 20;
+
+    // Gradient Window property
+    gradientWindowProperty.DefaultValue.type        = XVT_U2;
+    gradientWindowProperty.DefaultValue.value.usVal = 0;
+
+    gradientWindowProperty.MinValue.type        = XVT_U2;
+    gradientWindowProperty.MinValue.value.usVal = 0;
+
+    gradientWindowProperty.MaxValue.type        = XVT_U2;
+    gradientWindowProperty.MaxValue.value.usVal = 45;
+}
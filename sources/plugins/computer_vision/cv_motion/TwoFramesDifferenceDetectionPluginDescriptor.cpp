@@ -58,7 +58,7 @@ static PropertyDescriptor* pluginProperties[] =
 const PropertyDescriptor** TwoFramesDifferenceDetectionPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
 
 // Register the plug-in
-REGISTER_CPP_PLUGIN_WITH_PROPS
+REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS
 (
     PluginID,
     PluginFamilyID_Detection,
@@ -86,7 +86,10 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     pluginProperties,
     PluginInitializer,
     nullptr,
-    nullptr
+    nullptr,
+    0,
+    nullptr,
+    PluginFlag_NotSplittable
 );
 
 // Complete properties description by initializing those parts, which were not
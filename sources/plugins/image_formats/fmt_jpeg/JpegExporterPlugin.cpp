@@ -115,3 +115,9 @@ XErrorCode JpegExporterPlugin::ExportImage( xstring fileName, const ximage* imag
 {
     return XEncodeJpeg( fileName, image, quality );
 }
+
+// Save image into the specified memory buffer
+XErrorCode JpegExporterPlugin::ExportImageToMemory( const ximage* image, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize )
+{
+    return XEncodeJpegToMemory( image, quality, buffer, bufferSize, encodedSize );
+}
@@ -41,6 +41,7 @@ public:
     virtual XErrorCode GetSupportedExtensions( xstring* fileExtensions, int32_t* count );
     virtual XErrorCode GetSupportedPixelFormats( XPixelFormat* pixelFormats, int32_t* count );
     virtual XErrorCode ExportImage( xstring fileName, const ximage* image );
+    virtual XErrorCode ExportImageToMemory( const ximage* image, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize );
 
 private:
     static const PropertyDescriptor** propertiesDescription;
@@ -25,7 +25,7 @@
 static void PluginInitializer( );
 
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 0 };
+static xversion PluginVersion = { 1, 0, 1 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000002, 0x00000002 };
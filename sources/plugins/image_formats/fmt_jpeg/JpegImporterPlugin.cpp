@@ -71,3 +71,9 @@ XErrorCode JpegImporterPlugin::ImportImage( xstring fileName, ximage** image )
 {
     return XDecodeJpeg( fileName, image );
 }
+
+// Load image from the specified memory buffer
+XErrorCode JpegImporterPlugin::ImportImageFromMemory( const uint8_t* buffer, uint32_t bufferLength, ximage** image )
+{
+    return XDecodeJpegFromMemory( buffer, (int) bufferLength, image );
+}
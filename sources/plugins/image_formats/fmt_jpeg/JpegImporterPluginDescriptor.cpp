@@ -23,7 +23,7 @@
 #include "JpegImporterPlugin.hpp"
 
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 1 };
+static xversion PluginVersion = { 1, 0, 2 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000002, 0x00000001 };
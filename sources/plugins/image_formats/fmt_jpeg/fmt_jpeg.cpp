@@ -25,7 +25,7 @@
 ModuleDescriptor moduleInfo =
 {
     { 0xAF000001, 0x00000000, 0x00000000, 0x00000002 },
-    { 1, 0, 1 },
+    { 1, 0, 2 },
     "JPEG Format Handler",
     "fmt_jpeg",
     "The module contains plug-ins to read/write JPEG images.",
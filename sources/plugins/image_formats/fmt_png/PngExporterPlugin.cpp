@@ -36,6 +36,10 @@ const XPixelFormat PngExporterPlugin::supportedPixelFormats[] =
 
 PngExporterPlugin::PngExporterPlugin( )
 {
+    options.compressionLevel = 6;
+    options.strategy         = PngStrategy_Default;
+    options.filter           = PngFilter_Adaptive;
+    options.stripsCount      = 1;
 }
 
 void PngExporterPlugin::Dispose( )
@@ -46,19 +50,74 @@ void PngExporterPlugin::Dispose( )
 // Get property of the plug-in
 XErrorCode PngExporterPlugin::GetProperty( int32_t id, xvariant* value ) const
 {
-    XUNREFERENCED_PARAMETER( id )
-    XUNREFERENCED_PARAMETER( value )
-
-    return ErrorInvalidProperty;
+    XErrorCode ret = SuccessCode;
+
+    switch ( id )
+    {
+    case 0:
+        value->type        = XVT_U1;
+        value->value.ubVal = (uint8_t) options.compressionLevel;
+        break;
+
+    case 1:
+        value->type        = XVT_U1;
+        value->value.ubVal = options.strategy;
+        break;
+
+    case 2:
+        value->type        = XVT_U1;
+        value->value.ubVal = options.filter;
+        break;
+
+    case 3:
+        value->type          = XVT_Bool;
+        value->value.boolVal = ( options.stripsCount != 1 );
+        break;
+
+    default:
+        ret = ErrorInvalidProperty;
+        break;
+    }
+
+    return ret;
 }
 
 // Set property of the plug-in
 XErrorCode PngExporterPlugin::SetProperty( int32_t id, const xvariant* value )
 {
-    XUNREFERENCED_PARAMETER( id )
-    XUNREFERENCED_PARAMETER( value )
+    XErrorCode ret = SuccessCode;
+
+    xvariant convertedValue;
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 4, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            options.compressionLevel = (int8_t) convertedValue.value.ubVal;
+            break;
+
+        case 1:
+            options.strategy = convertedValue.value.ubVal;
+            break;
+
+        case 2:
+            options.filter = convertedValue.value.ubVal;
+            break;
 
-    return ErrorInvalidProperty;
+        case 3:
+            options.stripsCount = ( convertedValue.value.boolVal ) ? XPNG_STRIPS_AUTO : 1;
+            break;
+        }
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
 }
 
 // Get some short description of the file type
@@ -84,5 +143,11 @@ XErrorCode PngExporterPlugin::GetSupportedPixelFormats( XPixelFormat* pixelForma
 // Save image to the specified file
 XErrorCode PngExporterPlugin::ExportImage( xstring fileName, const ximage* image )
 {
-    return XEncodePng( fileName, image );
+    return XEncodePng( fileName, image, &options );
+}
+
+// Save image into the specified memory buffer
+XErrorCode PngExporterPlugin::ExportImageToMemory( const ximage* image, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize )
+{
+    return XEncodePngToMemory( image, &options, buffer, bufferSize, encodedSize );
 }
@@ -24,6 +24,7 @@
 #define CVS_PNG_EXPORTER_PLUGIN_HPP
 
 #include <iplugintypescpp.hpp>
+#include <ximaging_formats.h>
 
 class PngExporterPlugin : public IImageExportingPlugin
 {
@@ -41,8 +42,11 @@ public:
     virtual XErrorCode GetSupportedExtensions( xstring* fileExtensions, int32_t* count );
     virtual XErrorCode GetSupportedPixelFormats( XPixelFormat* pixelFormats, int32_t* count );
     virtual XErrorCode ExportImage( xstring fileName, const ximage* image );
+    virtual XErrorCode ExportImageToMemory( const ximage* image, uint8_t** buffer, uint32_t* bufferSize, uint32_t* encodedSize );
 
 private:
+    xpngoptions options;
+
     static const PropertyDescriptor** propertiesDescription;
     static const char*                supportedFileExtensions[];
     static const XPixelFormat         supportedPixelFormats[];
@@ -22,14 +22,39 @@
 #include <iplugincpp.hpp>
 #include "PngExporterPlugin.hpp"
 
+static void PluginInitializer( );
+static void PluginCleaner( );
+
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 0 };
+static xversion PluginVersion = { 1, 0, 2 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000003, 0x00000002 };
 
+// Compression Level property
+static PropertyDescriptor compressionLevelProperty =
+{ XVT_U1, "Compression Level", "compressionLevel", "Compression level: 0 - no compression, 9 - best (slowest) compression.", PropertyFlag_None };
+// Compression Strategy property
+static PropertyDescriptor compressionStrategyProperty =
+{ XVT_U1, "Compression Strategy", "compressionStrategy", "Compression strategy. Huffman only and RLE strategies are much faster, but compress worse.", PropertyFlag_SelectionByIndex };
+// Row Filter property
+static PropertyDescriptor rowFilterProperty =
+{ XVT_U1, "Row Filter", "rowFilter", "Filter applied to image rows before compression.", PropertyFlag_SelectionByIndex };
+// Parallel Compression property
+static PropertyDescriptor parallelCompressionProperty =
+{ XVT_Bool, "Parallel Compression", "parallelCompression", "Split image into strips, which are compressed in parallel.", PropertyFlag_None };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &compressionLevelProperty, &compressionStrategyProperty, &rowFilterProperty, &parallelCompressionProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** PngExporterPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
+
 // Register the plug-in
-REGISTER_CPP_PLUGIN
+REGISTER_CPP_PLUGIN_WITH_PROPS
 (
     PluginID,
     PluginFamilyID_Default,
@@ -40,8 +65,48 @@ REGISTER_CPP_PLUGIN
     "PngExporter",
     "PNG files saving plug-in.",
 
-    "The plug-in allows saving images in PNG format.",
+    "The plug-in allows saving images in PNG format.<br><br>"
+    "For faster saving of big images, it is possible to lower compression level or to choose a faster compression "
+    "strategy (like RLE or Huffman only). Also compression can be done in parallel - the image is split into strips, "
+    "which are compressed on multiple threads. The result is still a standard PNG file, which is a bit bigger though."
+    ,
     0,
     0,
-    PngExporterPlugin
+    PngExporterPlugin,
+
+    XARRAY_SIZE( pluginProperties ),
+    pluginProperties,
+    PluginInitializer,
+    PluginCleaner,
+    0  // no dynamic properties update
 );
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    static const char* strategies[] = { "Default", "Filtered", "Huffman only", "RLE", "Fixed" };
+    static const char* filters[]    = { "Adaptive", "None", "Sub", "Up", "Average", "Paeth" };
+
+    compressionLevelProperty.DefaultValue.type        = XVT_U1;
+    compressionLevelProperty.DefaultValue.value.ubVal = 6;
+
+    compressionLevelProperty.MinValue.type        = XVT_U1;
+    compressionLevelProperty.MinValue.value.ubVal = 0;
+
+    compressionLevelProperty.MaxValue.type        = XVT_U1;
+    compressionLevelProperty.MaxValue.value.ubVal = 9;
+
+    InitSelectionProperty( &compressionStrategyProperty, strategies, XARRAY_SIZE( strategies ), 0 );
+    InitSelectionProperty( &rowFilterProperty, filters, XARRAY_SIZE( filters ), 0 );
+
+    parallelCompressionProperty.DefaultValue.type          = XVT_Bool;
+    parallelCompressionProperty.DefaultValue.value.boolVal = false;
+}
+
+// Clean-up plug-in - deallocate strings
+static void PluginCleaner( )
+{
+    CleanSelectionProperty( &compressionStrategyProperty );
+    CleanSelectionProperty( &rowFilterProperty );
+}
@@ -69,3 +69,9 @@ XErrorCode PngImporterPlugin::ImportImage( xstring fileName, ximage** image )
 {
 	return XDecodePng( fileName, image );
 }
+
+// Load image from the specified memory buffer
+XErrorCode PngImporterPlugin::ImportImageFromMemory( const uint8_t* buffer, uint32_t bufferLength, ximage** image )
+{
+    return XDecodePngFromMemory( buffer, (int) bufferLength, image );
+}
@@ -40,6 +40,7 @@ public:
     xstring GetFileTypeDescription( );
     XErrorCode GetSupportedExtensions( xstring* fileExtensions, int32_t* count );
     XErrorCode ImportImage( xstring fileName, ximage** image );
+    XErrorCode ImportImageFromMemory( const uint8_t* buffer, uint32_t bufferLength, ximage** image );
 
 private:
     static const char* supportedFileExtensions[];
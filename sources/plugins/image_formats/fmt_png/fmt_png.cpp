@@ -25,7 +25,7 @@
 ModuleDescriptor moduleInfo =
 {
     { 0xAF000001, 0x00000000, 0x00000000, 0x00000003 },
-    { 1, 0, 0 },
+    { 1, 0, 2 },
     "PNG Format Handler",
     "fmt_png",
     "The module contains plug-ins to read/write PNG images.",
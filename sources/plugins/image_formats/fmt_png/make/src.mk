@@ -13,4 +13,4 @@ INCLUDES = -I../../../../../afx/afx_types -I../../../../../afx/afx_imaging_forma
 	-I../../../../../core/iplugin -I../../../../../images
 
 # libraries to use
-LIBS = -liplugin -lafx_imaging_formats -lafx_types -lpng
+LIBS = -liplugin -lafx_imaging_formats -lafx_types -lpng -lz
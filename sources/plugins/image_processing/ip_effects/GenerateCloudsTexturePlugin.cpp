@@ -24,10 +24,16 @@
 #include "GenerateCloudsTexturePlugin.hpp"
 
 GenerateCloudsTexturePlugin::GenerateCloudsTexturePlugin( ) :
-    width( 640 ), height( 480 ), randValue( (uint16_t) ( rand( ) % 10000 ) )
+    width( 640 ), height( 480 ), randValue( (uint16_t) ( rand( ) % 10000 ) ),
+    textureCache( nullptr )
 {
 }
 
+GenerateCloudsTexturePlugin::~GenerateCloudsTexturePlugin( )
+{
+    XTextureCacheFree( &textureCache );
+}
+
 void GenerateCloudsTexturePlugin::Dispose( )
 {
     delete this;
@@ -44,16 +50,29 @@ XErrorCode GenerateCloudsTexturePlugin::GenerateImage( ximage** dst )
     }
     else
     {
-        ret = XImageAllocateTexture( width, height, dst );
+        const ximage*  texture = nullptr;
+        xtextureparams params;
+
+        params.generator  = TextureGenerator_Clouds;
+        params.randNumber = randValue;
+        params.param1     = 0;
+        params.param2     = 0;
+        params.param3     = 0;
+
+        // the texture is generated only when its size or parameters change, otherwise cached copy is provided
+        if ( textureCache == nullptr )
+        {
+            ret = XTextureCacheCreate( 1, &textureCache );
+        }
 
         if ( ret == SuccessCode )
         {
-            ret = GenerateCloudsTexture( *dst, randValue );
+            ret = XTextureCacheGetTexture( textureCache, &params, width, height, &texture );
+        }
 
-            if ( ret != SuccessCode )
-            {
-                XImageFree( dst );
-            }
+        if ( ret == SuccessCode )
+        {
+            ret = XImageClone( texture, dst );
         }
     }
 
@@ -24,9 +24,13 @@
 #define CVS_GENERATE_CLOUDS_TEXTURE_PLUGIN_HPP
 
 #include <iplugintypescpp.hpp>
+#include <xtextures.h>
 
 class GenerateCloudsTexturePlugin : public IImageGenerationPlugin
 {
+private:
+    ~GenerateCloudsTexturePlugin( );
+
 public:
     GenerateCloudsTexturePlugin( );
 
@@ -45,6 +49,7 @@ private:
     uint16_t    width;
     uint16_t    height;
     uint16_t    randValue;
+    xtexturecache* textureCache;
 };
 
 #endif // CVS_GENERATE_CLOUDS_TEXTURE_PLUGIN_HPP
@@ -24,10 +24,16 @@
 #include "GenerateGrainTexturePlugin.hpp"
 
 GenerateGrainTexturePlugin::GenerateGrainTexturePlugin( ) :
-    width( 640 ), height( 480 ), spacing( 50 ), density( 0.5 ), isVertical( true ), randValue( (uint16_t) ( rand( ) % 10000 ) )
+    width( 640 ), height( 480 ), spacing( 50 ), density( 0.5 ), isVertical( true ), randValue( (uint16_t) ( rand( ) % 10000 ) ),
+    textureCache( nullptr )
 {
 }
 
+GenerateGrainTexturePlugin::~GenerateGrainTexturePlugin( )
+{
+    XTextureCacheFree( &textureCache );
+}
+
 void GenerateGrainTexturePlugin::Dispose( )
 {
     delete this;
@@ -44,16 +50,29 @@ XErrorCode GenerateGrainTexturePlugin::GenerateImage( ximage** dst )
     }
     else
     {
-        ret = XImageAllocateTexture( width, height, dst );
+        const ximage*  texture = nullptr;
+        xtextureparams params;
+
+        params.generator  = TextureGenerator_Grain;
+        params.randNumber = randValue;
+        params.param1     = spacing;
+        params.param2     = density;
+        params.param3     = ( isVertical ) ? 1.0f : 0.0f;
+
+        // the texture is generated only when its size or parameters change, otherwise cached copy is provided
+        if ( textureCache == nullptr )
+        {
+            ret = XTextureCacheCreate( 1, &textureCache );
+        }
 
         if ( ret == SuccessCode )
         {
-            ret = GenerateGrainTexture( *dst, randValue, spacing, density, isVertical );
+            ret = XTextureCacheGetTexture( textureCache, &params, width, height, &texture );
+        }
 
-            if ( ret != SuccessCode )
-            {
-                XImageFree( dst );
-            }
+        if ( ret == SuccessCode )
+        {
+            ret = XImageClone( texture, dst );
         }
     }
 
@@ -24,9 +24,13 @@
 #define CVS_GENERATE_GRAIN_TEXTURE_PLUGIN_HPP
 
 #include <iplugintypescpp.hpp>
+#include <xtextures.h>
 
 class GenerateGrainTexturePlugin : public IImageGenerationPlugin
 {
+private:
+    ~GenerateGrainTexturePlugin( );
+
 public:
     GenerateGrainTexturePlugin( );
 
@@ -48,6 +52,7 @@ private:
     float       density;
     bool        isVertical;
     uint16_t    randValue;
+    xtexturecache* textureCache;
 };
 
 #endif // CVS_GENERATE_GRAIN_TEXTURE_PLUGIN_HPP
@@ -25,10 +25,16 @@
 
 GenerateMarbleTexturePlugin::GenerateMarbleTexturePlugin( ) :
     width( 640 ), height( 480 ), randValue( (uint16_t) ( rand( ) % 10000 ) ),
-    xPeriod( 5.0f ), yPeriod( 10.0f )
+    xPeriod( 5.0f ), yPeriod( 10.0f ),
+    textureCache( nullptr )
 {
 }
 
+GenerateMarbleTexturePlugin::~GenerateMarbleTexturePlugin( )
+{
+    XTextureCacheFree( &textureCache );
+}
+
 void GenerateMarbleTexturePlugin::Dispose( )
 {
     delete this;
@@ -45,16 +51,29 @@ XErrorCode GenerateMarbleTexturePlugin::GenerateImage( ximage** dst )
     }
     else
     {
-        ret = XImageAllocateTexture( width, height, dst );
+        const ximage*  texture = nullptr;
+        xtextureparams params;
+
+        params.generator  = TextureGenerator_Marble;
+        params.randNumber = randValue;
+        params.param1     = xPeriod;
+        params.param2     = yPeriod;
+        params.param3     = 0;
+
+        // the texture is generated only when its size or parameters change, otherwise cached copy is provided
+        if ( textureCache == nullptr )
+        {
+            ret = XTextureCacheCreate( 1, &textureCache );
+        }
 
         if ( ret == SuccessCode )
         {
-            ret = GenerateMarbleTexture( *dst, randValue, xPeriod, yPeriod );
+            ret = XTextureCacheGetTexture( textureCache, &params, width, height, &texture );
+        }
 
-            if ( ret != SuccessCode )
-            {
-                XImageFree( dst );
-            }
+        if ( ret == SuccessCode )
+        {
+            ret = XImageClone( texture, dst );
         }
     }
 
@@ -24,9 +24,13 @@
 #define CVS_GENERATE_MARBLE_TEXTURE_PLUGIN_HPP
 
 #include <iplugintypescpp.hpp>
+#include <xtextures.h>
 
 class GenerateMarbleTexturePlugin : public IImageGenerationPlugin
 {
+private:
+    ~GenerateMarbleTexturePlugin( );
+
 public:
     GenerateMarbleTexturePlugin( );
 
@@ -47,6 +51,7 @@ private:
     uint16_t    randValue;
     float       xPeriod;
     float       yPeriod;
+    xtexturecache* textureCache;
 };
 
 #endif // CVS_GENERATE_MARBLE_TEXTURE_PLUGIN_HPP
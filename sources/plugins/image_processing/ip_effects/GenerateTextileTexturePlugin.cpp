@@ -25,10 +25,16 @@
 
 GenerateTextileTexturePlugin::GenerateTextileTexturePlugin( ) :
     width( 640 ), height( 480 ), randValue( (uint16_t) ( rand( ) % 10000 ) ),
-    stitchSize( 7 ), stitchOffset( 0 )
+    stitchSize( 7 ), stitchOffset( 0 ),
+    textureCache( nullptr )
 {
 }
 
+GenerateTextileTexturePlugin::~GenerateTextileTexturePlugin( )
+{
+    XTextureCacheFree( &textureCache );
+}
+
 void GenerateTextileTexturePlugin::Dispose( )
 {
     delete this;
@@ -45,16 +51,29 @@ XErrorCode GenerateTextileTexturePlugin::GenerateImage( ximage** dst )
     }
     else
     {
-        ret = XImageAllocateTexture( width, height, dst );
+        const ximage*  texture = nullptr;
+        xtextureparams params;
+
+        params.generator  = TextureGenerator_Textile;
+        params.randNumber = randValue;
+        params.param1     = stitchSize;
+        params.param2     = stitchOffset;
+        params.param3     = 0;
+
+        // the texture is generated only when its size or parameters change, otherwise cached copy is provided
+        if ( textureCache == nullptr )
+        {
+            ret = XTextureCacheCreate( 1, &textureCache );
+        }
 
         if ( ret == SuccessCode )
         {
-            ret = GenerateTextileTexture( *dst, randValue, stitchSize, stitchOffset );
+            ret = XTextureCacheGetTexture( textureCache, &params, width, height, &texture );
+        }
 
-            if ( ret != SuccessCode )
-            {
-                XImageFree( dst );
-            }
+        if ( ret == SuccessCode )
+        {
+            ret = XImageClone( texture, dst );
         }
     }
 
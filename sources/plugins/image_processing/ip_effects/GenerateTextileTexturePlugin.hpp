@@ -24,9 +24,13 @@
 #define CVS_GENERATE_TEXTILE_TEXTURE_PLUGIN_HPP
 
 #include <iplugintypescpp.hpp>
+#include <xtextures.h>
 
 class GenerateTextileTexturePlugin : public IImageGenerationPlugin
 {
+private:
+    ~GenerateTextileTexturePlugin( );
+
 public:
     GenerateTextileTexturePlugin( );
 
@@ -47,6 +51,7 @@ private:
     uint16_t    randValue;
 	uint8_t     stitchSize;
     uint8_t     stitchOffset;
+    xtexturecache* textureCache;
 };
 
 #endif // CVS_GENERATE_TEXTILE_TEXTURE_PLUGIN_HPP
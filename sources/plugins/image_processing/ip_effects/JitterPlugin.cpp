@@ -19,9 +19,12 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
 */
 
+#include <chrono>
 #include <ximaging_effects.h>
 #include "JitterPlugin.hpp"
 
+using namespace std::chrono;
+
 // Supported pixel formats of input/output images
 const XPixelFormat JitterPlugin::supportedFormats[] =
 {
@@ -72,7 +75,9 @@ XErrorCode JitterPlugin::ProcessImage( const ximage* src, ximage** dst )
 // Process the specified source image by changing it
 XErrorCode JitterPlugin::ProcessImageInPlace( ximage* src )
 {
-    return ImageJitter( src, radius );
+    return ImageJitter( src,
+        static_cast<uint32_t>( duration_cast<std::chrono::microseconds>( steady_clock::now( ).time_since_epoch( ) ).count( ) ),
+        radius );
 }
 
 // Get specified property value of the plug-in
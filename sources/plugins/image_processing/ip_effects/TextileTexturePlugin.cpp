@@ -30,10 +30,16 @@ const XPixelFormat TextileTexturePlugin::supportedFormats[] =
 };
 
 TextileTexturePlugin::TextileTexturePlugin( ) :
-    stitchSize( 7 ), stitchOffset( 0 ), amountToKeep( 0.5f ), randValue( (uint16_t) ( rand( ) % 10000 ) )
+    stitchSize( 7 ), stitchOffset( 0 ), amountToKeep( 0.5f ), randValue( (uint16_t) ( rand( ) % 10000 ) ),
+    textureCache( nullptr )
 {
 }
 
+TextileTexturePlugin::~TextileTexturePlugin( )
+{
+    XTextureCacheFree( &textureCache );
+}
+
 void TextileTexturePlugin::Dispose( )
 {
     delete this;
@@ -81,18 +87,33 @@ XErrorCode TextileTexturePlugin::ProcessImageInPlace( ximage* src )
     }
     else
     {
-        ximage* texture = 0;
-        
-        ret = XImageAllocateTexture( src->width, src->height, &texture );
+        // texture is regenerated only when image size or texture's parameters change
+        if ( textureCache == nullptr )
+        {
+            ret = XTextureCacheCreate( 1, &textureCache );
+        }
+        else
+        {
+            ret = SuccessCode;
+        }
 
         if ( ret == SuccessCode )
         {
-            if ( GenerateTextileTexture( texture, randValue, stitchSize, stitchOffset ) == SuccessCode )
+            const ximage*  texture = nullptr;
+            xtextureparams params;
+
+            params.generator  = TextureGenerator_Textile;
+            params.randNumber = randValue;
+            params.param1     = stitchSize;
+            params.param2     = stitchOffset;
+            params.param3     = 0;
+
+            ret = XTextureCacheGetTexture( textureCache, &params, src->width, src->height, &texture );
+
+            if ( ret == SuccessCode )
             {
                 ret = XImageApplyTexture( texture, src, amountToKeep, 255 );
             }
-
-            XImageFree( &texture );
         }
     }
 
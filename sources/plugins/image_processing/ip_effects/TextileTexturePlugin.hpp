@@ -24,9 +24,13 @@
 #define CVS_TEXTILE_TEXTURE_PLUGIN_HPP
 
 #include <iplugintypescpp.hpp>
+#include <xtextures.h>
 
 class TextileTexturePlugin : public IImageProcessingFilterPlugin
 {
+private:
+    ~TextileTexturePlugin( );
+
 public:
     TextileTexturePlugin( );
 
@@ -50,7 +54,7 @@ private:
     uint8_t     stitchOffset;
     float       amountToKeep;
     uint16_t    randValue;
-
+    xtexturecache* textureCache;
 };
 
 #endif // CVS_TEXTILE_TEXTURE_PLUGIN_HPP
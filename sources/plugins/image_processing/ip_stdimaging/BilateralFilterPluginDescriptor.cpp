@@ -0,0 +1,107 @@
+/*
+    Standard image processing plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2018, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include <image_mean_shift_16x16.h>
+#include "BilateralFilterPlugin.hpp"
+
+static void PluginInitializer( );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000001, 0x0000003D };
+
+// Spatial Sigma property
+static PropertyDescriptor spatialSigmaProperty =
+{ XVT_R4, "Spatial sigma", "spatialSigma", "Spatial extent of the smoothing, pixels.", PropertyFlag_None };
+
+// Color Sigma property
+static PropertyDescriptor colorSigmaProperty =
+{ XVT_R4, "Color sigma", "colorSigma", "Intensity difference, which is still smoothed out rather than kept as an edge.", PropertyFlag_None };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &spatialSigmaProperty, &colorSigmaProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** BilateralFilterPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS
+(
+    PluginID,
+    PluginFamilyID_ImageSmoothing,
+
+    PluginType_ImageProcessingFilter,
+    PluginVersion,
+    "Bilateral Filter",
+    "BilateralFilter",
+    "Performs edge preserving image smoothing.",
+
+    /* Long description */
+    "The plug-in performs bilateral filtering, which averages pixels weighting them both by their spatial distance "
+    "(<b>spatial sigma</b>) and by difference of their intensity (<b>color sigma</b>). As a result, small details and noise "
+    "get smoothed, while edges between areas of different color are preserved. Color images use pixels' luminance "
+    "to find intensity difference.<br><br>"
+
+    "The filter is implemented using downsampled bilateral grid, so its performance does not depend much on the "
+    "specified sigma values. This makes it much faster alternative to <a href='{AF000003-00000000-00000001-00000035}'>mean shift</a> "
+    "for larger filter sizes."
+    ,
+    &image_mean_shift_16x16,
+    nullptr,
+    BilateralFilterPlugin,
+
+    sizeof( pluginProperties ) / sizeof( PropertyDescriptor* ),
+    pluginProperties,
+    PluginInitializer,
+    nullptr,
+    nullptr  // no dynamic properties update
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    // Spatial Sigma property
+    spatialSigmaProperty.DefaultValue.type = XVT_R4;
+    spatialSigmaProperty.DefaultValue.value.fVal = 8.0f;
+
+    spatialSigmaProperty.MinValue.type = XVT_R4;
+    spatialSigmaProperty.MinValue.value.fVal = 4.0f;
+
+    spatialSigmaProperty.MaxValue.type = XVT_R4;
+    spatialSigmaProperty.MaxValue.value.fVal = 100.0f;
+
+    // Color Sigma property
+    colorSigmaProperty.DefaultValue.type = XVT_R4;
+    colorSigmaProperty.DefaultValue.value.fVal = 20.0f;
+
+    colorSigmaProperty.MinValue.type = XVT_R4;
+    colorSigmaProperty.MinValue.value.fVal = 4.0f;
+
+    colorSigmaProperty.MaxValue.type = XVT_R4;
+    colorSigmaProperty.MaxValue.value.fVal = 128.0f;
+}
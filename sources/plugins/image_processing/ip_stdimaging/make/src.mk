@@ -8,6 +8,7 @@ VPATH = ../../
 # source files
 SRC = ip_stdimaging.cpp \
 	AddImagesPlugin.cpp AddImagesPluginDescriptor.cpp \
+	BilateralFilterPlugin.cpp BilateralFilterPluginDescriptor.cpp \
 	BinaryDilatation3x3Plugin.cpp BinaryDilatation3x3PluginDescriptor.cpp \
 	BinaryErosion3x3Plugin.cpp BinaryErosion3x3PluginDescriptor.cpp \
 	BlurPlugin.cpp BlurPluginDescriptor.cpp \
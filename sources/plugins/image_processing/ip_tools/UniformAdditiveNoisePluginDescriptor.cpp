@@ -27,7 +27,7 @@ static void PluginInitializer( );
 static XErrorCode UpdateSeedValueProperty( PropertyDescriptor* desc, const xvariant* parentValue );
 
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 0 };
+static xversion PluginVersion = { 1, 0, 1 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000007, 0x00000001 };
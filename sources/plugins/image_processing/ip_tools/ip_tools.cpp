@@ -26,7 +26,7 @@
 ModuleDescriptor moduleInfo =
 {
     { 0xAF000001, 0x00000000, 0x00000000, 0x00000007 },
-    { 1, 0, 3 },
+    { 1, 0, 4 },
     "Image Processing Tools",
     "ip_tools",
     "The module contains different image processing tools.",
@@ -108,7 +108,7 @@ namespace Private
                 if ( ecode == SuccessCode )
                 {
                     descriptor = XPluginDescriptor::Create( pDescriptor );
-                    plugin     = XPluginWrapperFactory::CreateWrapper( pPlugin, pDescriptor->Type );
+                    plugin     = XPluginWrapperFactory::CreateWrapper( pPlugin, pDescriptor->Type, true, pDescriptor->InterfaceVersion );
 
                 }
             }
@@ -234,13 +234,25 @@ namespace Private
                 if ( ecode == SuccessCode )
                 {
                     descriptor = XPluginDescriptor::Create( pDescriptor );
-                    plugin     = XPluginWrapperFactory::CreateWrapper( pPlugin, pDescriptor->Type, false );
+                    plugin     = XPluginWrapperFactory::CreateWrapper( pPlugin, pDescriptor->Type, false, pDescriptor->InterfaceVersion );
                 }
             }
 
             return ecode;
         }
 
+        XErrorCode GetFrameTimestamps( xframetimestamps* timestamps ) const
+        {
+            XErrorCode ecode = ErrorInvalidConfiguration;
+
+            if ( mCallbacks.GetFrameTimestamps != nullptr )
+            {
+                ecode = mCallbacks.GetFrameTimestamps( mUserParam, timestamps );
+            }
+
+            return ecode;
+        }
+
     private:
         ScriptingEnginePluginCallbacks  mCallbacks;
         void*                           mUserParam;
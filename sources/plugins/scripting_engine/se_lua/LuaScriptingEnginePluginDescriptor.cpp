@@ -26,7 +26,7 @@
 static void PluginInitializer( );
 
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 7 };
+static xversion PluginVersion = { 1, 0, 9 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x0000000D, 0x00000001 };
@@ -93,6 +93,9 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     "<li>variant <b>Host.GetVariable</b>( name:string ) - Gets variable stored on the host side.</li>"
     "<li>pluginObject <b>Host.GetVideoSource</b>( ) - Gets video source object for which the script is running for. Allows to get access "
     "to video source's run time properties, if any.</li>"
+    "<li>table <b>Host.GetFrameTimestamps</b>( ) - Gets time stamps (microseconds) of the video frame being processed: <b>captured</b>, "
+    "<b>arrived</b> (to the host), <b>processingStarted</b> and <b>processingFinished</b> (0, while the frame is still being processed). "
+    "The <b>now</b> field provides current time stamp, so the script can tell latency of the frame.</li>"
     "</ul><br>"
 
     "<h3>Image class interface</h3>"
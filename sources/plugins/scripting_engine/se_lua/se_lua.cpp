@@ -26,7 +26,7 @@
 ModuleDescriptor moduleInfo =
 {
     { 0xAF000001, 0x00000000, 0x00000000, 0x0000000D },
-    { 1, 0, 7 },
+    { 1, 0, 9 },
     "Lua Scripting Engine",
     "se_lua",
     "The module contains Lua scripting engine plug-ins.",
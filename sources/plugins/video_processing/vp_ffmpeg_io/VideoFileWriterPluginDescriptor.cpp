@@ -79,7 +79,7 @@ static PropertyDescriptor* pluginProperties[] =
 const PropertyDescriptor** VideoFileWriterPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
 
 // Register the plug-in
-REGISTER_CPP_PLUGIN_WITH_PROPS
+REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS
 (
     PluginID,
     PluginFamilyID_VideoProcessing,
@@ -118,7 +118,10 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     pluginProperties,
     PluginInitializer,
     PluginCleaner,
-    0
+    0,
+    0,
+    0,
+    PluginFlag_NotSplittable
 );
 
 // Complete properties description by initializing those parts, which were not
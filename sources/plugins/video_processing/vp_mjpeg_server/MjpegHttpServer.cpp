@@ -0,0 +1,650 @@
+/*
+    MJPEG HTTP server plug-in for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+
+    typedef SOCKET socket_t;
+
+    #define CLOSE_SOCKET( s )   closesocket( s )
+    #define WOULD_BLOCK( )      ( WSAGetLastError( ) == WSAEWOULDBLOCK )
+    #define SEND_FLAGS          0
+#else
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <errno.h>
+
+    typedef int socket_t;
+
+    #define INVALID_SOCKET      ( -1 )
+    #define SOCKET_ERROR        ( -1 )
+    #define CLOSE_SOCKET( s )   close( s )
+    #define WOULD_BLOCK( )      ( ( errno == EAGAIN ) || ( errno == EWOULDBLOCK ) || ( errno == EINTR ) )
+    #define SEND_FLAGS          MSG_NOSIGNAL
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <list>
+#include <XThread.hpp>
+#include <XMutex.hpp>
+
+#include "MjpegHttpServer.hpp"
+
+using namespace std;
+using namespace CVSandbox;
+using namespace CVSandbox::Threading;
+
+namespace Private
+{
+    static const char*    STREAM_BOUNDARY      = "cvsframe";
+    static const uint32_t MAX_REQUEST_LENGTH   = 4096;
+    static const uint32_t SELECT_TIMEOUT_MS    = 500;
+
+    enum ClientState
+    {
+        ClientState_ReadingRequest,
+        ClientState_Streaming,
+        ClientState_Snapshot,
+        ClientState_Done
+    };
+
+    // State of a single connected client
+    class ClientData
+    {
+    public:
+        ClientData( socket_t socket ) :
+            Socket( socket ), State( ClientState_ReadingRequest ), Request( ), Header( ), HeaderSent( 0 ),
+            Frame( ), FrameSent( 0 ), LastSequence( 0 ), PartsSent( 0 )
+        {
+        }
+
+        // Check if client has something still to send
+        bool IsSending( ) const
+        {
+            return ( HeaderSent < Header.size( ) ) || ( ( Frame ) && ( FrameSent < Frame->Size ) );
+        }
+
+    public:
+        socket_t                    Socket;
+        ClientState                 State;
+        string                      Request;
+        string                      Header;
+        size_t                      HeaderSent;
+        shared_ptr<EncodedFrame>    Frame;
+        uint32_t                    FrameSent;
+        uint32_t                    LastSequence;
+        uint32_t                    PartsSent;
+    };
+
+    class MjpegHttpServerData
+    {
+    public:
+        MjpegHttpServerData( ) :
+            ListenSocket( INVALID_SOCKET ), WakeSocket( INVALID_SOCKET ), MaxClients( 0 ),
+            ServerThread( ), Sync( ), NeedToExit( false ), CurrentFrame( ), FramesPublished( 0 ),
+            ConnectedClients( 0 ), Clients( )
+        {
+        }
+
+        bool CreateSockets( uint16_t port );
+        void CloseSockets( );
+        void Wake( );
+
+        static void ServerThreadHandler( void* param );
+
+    private:
+        void AcceptClients( );
+        void ReadRequest( ClientData& client );
+        void SendData( ClientData& client );
+        void PrepareNextFrame( ClientData& client, const shared_ptr<EncodedFrame>& frame );
+        void SendSimpleResponse( ClientData& client, const char* status );
+
+    public:
+        socket_t                    ListenSocket;
+        socket_t                    WakeSocket;
+        uint32_t                    MaxClients;
+
+        XThread                     ServerThread;
+        mutable XMutex              Sync;
+        volatile bool               NeedToExit;
+        shared_ptr<EncodedFrame>    CurrentFrame;
+        uint32_t                    FramesPublished;
+        uint32_t                    ConnectedClients;
+
+    private:
+        list<ClientData>            Clients;
+    };
+
+    // Switch the socket into non-blocking mode
+    static bool SetNonBlocking( socket_t socket )
+    {
+    #ifdef WIN32
+        u_long mode = 1;
+        return ( ioctlsocket( socket, FIONBIO, &mode ) == 0 );
+    #else
+        int flags = fcntl( socket, F_GETFL, 0 );
+        return ( flags != -1 ) && ( fcntl( socket, F_SETFL, flags | O_NONBLOCK ) == 0 );
+    #endif
+    }
+}
+
+EncodedFrame::EncodedFrame( ) :
+    Buffer( nullptr ), BufferSize( 0 ), Size( 0 ), Sequence( 0 )
+{
+}
+
+EncodedFrame::~EncodedFrame( )
+{
+    XFree( (void**) &Buffer );
+}
+
+MjpegHttpServer::MjpegHttpServer( ) :
+    mData( new ::Private::MjpegHttpServerData( ) )
+{
+}
+
+MjpegHttpServer::~MjpegHttpServer( )
+{
+    Stop( );
+    delete mData;
+}
+
+// Start the server on the specified port
+bool MjpegHttpServer::Start( uint16_t port, uint32_t maxClients )
+{
+    bool ret = false;
+
+    Stop( );
+
+#ifdef WIN32
+    WSADATA wsaData;
+
+    if ( WSAStartup( MAKEWORD( 2, 2 ), &wsaData ) != 0 )
+    {
+        return false;
+    }
+#endif
+
+    mData->MaxClients      = maxClients;
+    mData->NeedToExit      = false;
+    mData->FramesPublished = 0;
+
+    if ( mData->CreateSockets( port ) )
+    {
+        ret = mData->ServerThread.Create( ::Private::MjpegHttpServerData::ServerThreadHandler, mData );
+    }
+
+    if ( !ret )
+    {
+        mData->CloseSockets( );
+#ifdef WIN32
+        WSACleanup( );
+#endif
+    }
+
+    return ret;
+}
+
+// Stop the server and disconnect all clients
+void MjpegHttpServer::Stop( )
+{
+    if ( mData->ServerThread.IsRunning( ) )
+    {
+        mData->NeedToExit = true;
+        mData->Wake( );
+        mData->ServerThread.Join( );
+
+        mData->CloseSockets( );
+#ifdef WIN32
+        WSACleanup( );
+#endif
+    }
+
+    XScopedLock lock( &mData->Sync );
+    mData->CurrentFrame.reset( );
+    mData->ConnectedClients = 0;
+}
+
+// Check if the server is running
+bool MjpegHttpServer::IsRunning( ) const
+{
+    return mData->ServerThread.IsRunning( );
+}
+
+// Number of currently connected clients
+uint32_t MjpegHttpServer::ClientsCount( ) const
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->ConnectedClients;
+}
+
+// Publish new frame to be sent to clients
+void MjpegHttpServer::PublishFrame( const shared_ptr<EncodedFrame>& frame )
+{
+    {
+        XScopedLock lock( &mData->Sync );
+
+        if ( ++mData->FramesPublished == 0 )
+        {
+            mData->FramesPublished = 1;
+        }
+
+        frame->Sequence     = mData->FramesPublished;
+        mData->CurrentFrame = frame;
+    }
+
+    mData->Wake( );
+}
+
+namespace Private
+{
+
+// Create listening socket and the loopback socket used to wake up server thread
+bool MjpegHttpServerData::CreateSockets( uint16_t port )
+{
+    sockaddr_in address;
+    socklen_t   addressLength = sizeof( address );
+    int         reuse         = 1;
+    bool        ret           = false;
+
+    ListenSocket = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+    WakeSocket   = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+
+    if ( ( ListenSocket != INVALID_SOCKET ) && ( WakeSocket != INVALID_SOCKET ) )
+    {
+        setsockopt( ListenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>( &reuse ), sizeof( reuse ) );
+
+        memset( &address, 0, sizeof( address ) );
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl( INADDR_ANY );
+        address.sin_port        = htons( port );
+
+        if ( ( bind( ListenSocket, reinterpret_cast<sockaddr*>( &address ), sizeof( address ) ) == 0 ) &&
+             ( listen( ListenSocket, SOMAXCONN ) == 0 ) &&
+             ( SetNonBlocking( ListenSocket ) ) )
+        {
+            // wake socket is an UDP socket connected to itself, so it can be put into select()
+            // on any platform and a datagram sent to it interrupts the wait
+            memset( &address, 0, sizeof( address ) );
+            address.sin_family      = AF_INET;
+            address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+            address.sin_port        = 0;
+
+            if ( ( bind( WakeSocket, reinterpret_cast<sockaddr*>( &address ), sizeof( address ) ) == 0 ) &&
+                 ( getsockname( WakeSocket, reinterpret_cast<sockaddr*>( &address ), &addressLength ) == 0 ) &&
+                 ( connect( WakeSocket, reinterpret_cast<sockaddr*>( &address ), addressLength ) == 0 ) &&
+                 ( SetNonBlocking( WakeSocket ) ) )
+            {
+                ret = true;
+            }
+        }
+    }
+
+    if ( !ret )
+    {
+        CloseSockets( );
+    }
+
+    return ret;
+}
+
+// Close listening and wake up sockets
+void MjpegHttpServerData::CloseSockets( )
+{
+    if ( ListenSocket != INVALID_SOCKET )
+    {
+        CLOSE_SOCKET( ListenSocket );
+        ListenSocket = INVALID_SOCKET;
+    }
+    if ( WakeSocket != INVALID_SOCKET )
+    {
+        CLOSE_SOCKET( WakeSocket );
+        WakeSocket = INVALID_SOCKET;
+    }
+}
+
+// Interrupt server thread waiting in select()
+void MjpegHttpServerData::Wake( )
+{
+    if ( WakeSocket != INVALID_SOCKET )
+    {
+        char signal = 0;
+        send( WakeSocket, &signal, 1, 0 );
+    }
+}
+
+// Server thread - accepts clients and sends them frames
+void MjpegHttpServerData::ServerThreadHandler( void* param )
+{
+    MjpegHttpServerData* self = static_cast<MjpegHttpServerData*>( param );
+    char                 drainBuffer[64];
+
+    while ( !self->NeedToExit )
+    {
+        shared_ptr<EncodedFrame> frame;
+        fd_set                   readSet;
+        fd_set                   writeSet;
+        socket_t                 maxSocket = XMAX( self->ListenSocket, self->WakeSocket );
+        timeval                  timeout   = { 0, SELECT_TIMEOUT_MS * 1000 };
+
+        {
+            XScopedLock lock( &self->Sync );
+            frame = self->CurrentFrame;
+        }
+
+        FD_ZERO( &readSet );
+        FD_ZERO( &writeSet );
+        FD_SET( self->ListenSocket, &readSet );
+        FD_SET( self->WakeSocket, &readSet );
+
+        for ( list<ClientData>::iterator it = self->Clients.begin( ); it != self->Clients.end( ); ++it )
+        {
+            // clients, which are done with previous frame, jump straight to the latest one - any frames
+            // published while a slow client was busy sending are simply dropped for that client
+            if ( ( !it->IsSending( ) ) && ( frame ) && ( it->LastSequence != frame->Sequence ) &&
+                 ( ( it->State == ClientState_Streaming ) || ( ( it->State == ClientState_Snapshot ) && ( it->PartsSent == 0 ) ) ) )
+            {
+                self->PrepareNextFrame( *it, frame );
+            }
+
+            if ( it->State == ClientState_ReadingRequest )
+            {
+                FD_SET( it->Socket, &readSet );
+            }
+            else if ( it->IsSending( ) )
+            {
+                FD_SET( it->Socket, &writeSet );
+            }
+            else
+            {
+                // watch idle clients for disconnection
+                FD_SET( it->Socket, &readSet );
+            }
+
+            maxSocket = XMAX( maxSocket, it->Socket );
+        }
+
+        if ( select( static_cast<int>( maxSocket + 1 ), &readSet, &writeSet, nullptr, &timeout ) == SOCKET_ERROR )
+        {
+            XThread::Sleep( 10 );
+            continue;
+        }
+
+        if ( FD_ISSET( self->WakeSocket, &readSet ) )
+        {
+            while ( recv( self->WakeSocket, drainBuffer, sizeof( drainBuffer ), 0 ) > 0 )
+            {
+            }
+        }
+
+        if ( FD_ISSET( self->ListenSocket, &readSet ) )
+        {
+            self->AcceptClients( );
+        }
+
+        for ( list<ClientData>::iterator it = self->Clients.begin( ); it != self->Clients.end( ); ++it )
+        {
+            if ( FD_ISSET( it->Socket, &readSet ) )
+            {
+                self->ReadRequest( *it );
+            }
+            else if ( FD_ISSET( it->Socket, &writeSet ) )
+            {
+                self->SendData( *it );
+            }
+        }
+
+        // remove disconnected clients
+        for ( list<ClientData>::iterator it = self->Clients.begin( ); it != self->Clients.end( ); )
+        {
+            if ( it->State == ClientState_Done )
+            {
+                CLOSE_SOCKET( it->Socket );
+                it = self->Clients.erase( it );
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        {
+            XScopedLock lock( &self->Sync );
+            self->ConnectedClients = static_cast<uint32_t>( self->Clients.size( ) );
+        }
+    }
+
+    for ( list<ClientData>::iterator it = self->Clients.begin( ); it != self->Clients.end( ); ++it )
+    {
+        CLOSE_SOCKET( it->Socket );
+    }
+    self->Clients.clear( );
+}
+
+// Accept all pending connections
+void MjpegHttpServerData::AcceptClients( )
+{
+    for ( ; ; )
+    {
+        socket_t clientSocket = accept( ListenSocket, nullptr, nullptr );
+
+        if ( clientSocket == INVALID_SOCKET )
+        {
+            break;
+        }
+
+        // select() can not handle more than FD_SETSIZE sockets, so keep some room for the listening ones
+        if ( ( Clients.size( ) >= MaxClients ) || ( Clients.size( ) + 2 >= FD_SETSIZE ) ||
+             ( !SetNonBlocking( clientSocket ) ) )
+        {
+            CLOSE_SOCKET( clientSocket );
+        }
+        else
+        {
+        #ifdef SO_NOSIGPIPE
+            int noSigPipe = 1;
+            setsockopt( clientSocket, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof( noSigPipe ) );
+        #endif
+            Clients.push_back( ClientData( clientSocket ) );
+        }
+    }
+}
+
+// Read HTTP request from the client and decide what to send back
+void MjpegHttpServerData::ReadRequest( ClientData& client )
+{
+    char buffer[512];
+    int  received = recv( client.Socket, buffer, sizeof( buffer ), 0 );
+
+    if ( received <= 0 )
+    {
+        // client disconnected or failed
+        if ( ( received == 0 ) || ( !WOULD_BLOCK( ) ) )
+        {
+            client.State = ClientState_Done;
+        }
+    }
+    else if ( client.State == ClientState_ReadingRequest )
+    {
+        client.Request.append( buffer, received );
+
+        if ( client.Request.find( "\r\n\r\n" ) != string::npos )
+        {
+            char method[16] = { 0 };
+            char path[256]  = { 0 };
+
+            if ( ( sscanf( client.Request.c_str( ), "%15s %255s", method, path ) != 2 ) || ( strcmp( method, "GET" ) != 0 ) )
+            {
+                SendSimpleResponse( client, "405 Method Not Allowed" );
+            }
+            else
+            {
+                string uri( path );
+                size_t queryStart = uri.find( '?' );
+
+                if ( queryStart != string::npos )
+                {
+                    uri.erase( queryStart );
+                }
+
+                if ( ( uri == "/" ) || ( uri == "/video" ) || ( uri == "/video.mjpg" ) || ( uri == "/stream" ) )
+                {
+                    char header[512];
+
+                    sprintf( header, "HTTP/1.0 200 OK\r\n"
+                                     "Server: CVSandbox\r\n"
+                                     "Connection: close\r\n"
+                                     "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+                                     "Pragma: no-cache\r\n"
+                                     "Content-Type: multipart/x-mixed-replace; boundary=%s\r\n\r\n", STREAM_BOUNDARY );
+
+                    client.State      = ClientState_Streaming;
+                    client.Header     = header;
+                    client.HeaderSent = 0;
+                }
+                else if ( ( uri == "/snapshot" ) || ( uri == "/snapshot.jpg" ) || ( uri == "/image.jpg" ) )
+                {
+                    // response is prepared once the frame is available
+                    client.State = ClientState_Snapshot;
+                }
+                else
+                {
+                    SendSimpleResponse( client, "404 Not Found" );
+                }
+            }
+
+            client.Request.clear( );
+        }
+        else if ( client.Request.size( ) > MAX_REQUEST_LENGTH )
+        {
+            client.State = ClientState_Done;
+        }
+    }
+    // anything else received from client, which is not expecting it, is ignored
+}
+
+// Start sending next frame to the client
+void MjpegHttpServerData::PrepareNextFrame( ClientData& client, const shared_ptr<EncodedFrame>& frame )
+{
+    char header[256];
+
+    if ( client.State == ClientState_Snapshot )
+    {
+        sprintf( header, "HTTP/1.0 200 OK\r\n"
+                         "Server: CVSandbox\r\n"
+                         "Connection: close\r\n"
+                         "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+                         "Pragma: no-cache\r\n"
+                         "Content-Type: image/jpeg\r\n"
+                         "Content-Length: %u\r\n\r\n", frame->Size );
+        client.Header = header;
+    }
+    else
+    {
+        // the HTTP response header may not be fully sent yet for the first part
+        client.Header.erase( 0, client.HeaderSent );
+
+        sprintf( header, "%s--%s\r\n"
+                         "Content-Type: image/jpeg\r\n"
+                         "Content-Length: %u\r\n\r\n", ( client.PartsSent == 0 ) ? "" : "\r\n", STREAM_BOUNDARY, frame->Size );
+        client.Header += header;
+    }
+
+    client.HeaderSent   = 0;
+    client.Frame        = frame;
+    client.FrameSent    = 0;
+    client.LastSequence = frame->Sequence;
+    client.PartsSent++;
+}
+
+// Send as much pending data as the socket accepts without blocking
+void MjpegHttpServerData::SendData( ClientData& client )
+{
+    while ( client.IsSending( ) )
+    {
+        const char* data;
+        size_t      toSend;
+
+        if ( client.HeaderSent < client.Header.size( ) )
+        {
+            data   = client.Header.c_str( ) + client.HeaderSent;
+            toSend = client.Header.size( ) - client.HeaderSent;
+        }
+        else
+        {
+            data   = reinterpret_cast<const char*>( client.Frame->Buffer ) + client.FrameSent;
+            toSend = client.Frame->Size - client.FrameSent;
+        }
+
+        int sent = send( client.Socket, data, static_cast<int>( toSend ), SEND_FLAGS );
+
+        if ( sent <= 0 )
+        {
+            if ( ( sent == 0 ) || ( !WOULD_BLOCK( ) ) )
+            {
+                client.State = ClientState_Done;
+            }
+            break;
+        }
+
+        if ( client.HeaderSent < client.Header.size( ) )
+        {
+            client.HeaderSent += sent;
+        }
+        else
+        {
+            client.FrameSent += sent;
+        }
+    }
+
+    if ( !client.IsSending( ) )
+    {
+        // release the frame as soon as possible, so its buffer could be reused for encoding
+        client.Frame.reset( );
+        client.FrameSent = 0;
+
+        if ( ( client.State == ClientState_Snapshot ) && ( client.PartsSent != 0 ) )
+        {
+            client.State = ClientState_Done;
+        }
+    }
+}
+
+// Send short response with the specified status and close connection
+void MjpegHttpServerData::SendSimpleResponse( ClientData& client, const char* status )
+{
+    string response = string( "HTTP/1.0 " ) + status + "\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+
+    // best effort - it is short enough to fit into socket's buffer
+    send( client.Socket, response.c_str( ), static_cast<int>( response.size( ) ), SEND_FLAGS );
+
+    client.State = ClientState_Done;
+}
+
+} // namespace Private
@@ -0,0 +1,76 @@
+/*
+    MJPEG HTTP server plug-in for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_MJPEG_HTTP_SERVER_HPP
+#define CVS_MJPEG_HTTP_SERVER_HPP
+
+#include <stdint.h>
+#include <memory>
+#include <xtypes.h>
+#include <XInterfaces.hpp>
+
+namespace Private
+{
+    class MjpegHttpServerData;
+}
+
+// JPEG encoded frame shared between all clients of the server
+class EncodedFrame : private CVSandbox::Uncopyable
+{
+public:
+    EncodedFrame( );
+    ~EncodedFrame( );
+
+public:
+    uint8_t*    Buffer;         // allocated with XMAlloc() and owned by the frame
+    uint32_t    BufferSize;
+    uint32_t    Size;           // size of JPEG data in the buffer
+    uint32_t    Sequence;       // set by the server when the frame is published
+};
+
+// Simple HTTP server, which streams JPEG frames to its clients either
+// as MJPEG stream (multipart/x-mixed-replace) or as single snapshots
+class MjpegHttpServer : private CVSandbox::Uncopyable
+{
+public:
+    MjpegHttpServer( );
+    ~MjpegHttpServer( );
+
+    // Start the server on the specified port
+    bool Start( uint16_t port, uint32_t maxClients );
+    // Stop the server and disconnect all clients
+    void Stop( );
+    // Check if the server is running
+    bool IsRunning( ) const;
+
+    // Number of currently connected clients
+    uint32_t ClientsCount( ) const;
+
+    // Publish new frame to be sent to clients. Clients which are still busy
+    // sending previous frame will skip to the latest one once they are done.
+    void PublishFrame( const std::shared_ptr<EncodedFrame>& frame );
+
+private:
+    Private::MjpegHttpServerData* mData;
+};
+
+#endif // CVS_MJPEG_HTTP_SERVER_HPP
@@ -0,0 +1,248 @@
+/*
+    MJPEG HTTP server plug-in for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "MjpegServerPlugin.hpp"
+#include "MjpegHttpServer.hpp"
+#include <ximaging_formats.h>
+#include <XTimer.hpp>
+
+using namespace std;
+using namespace CVSandbox;
+
+// List of supported pixel formats
+const XPixelFormat MjpegServerPlugin::supportedPixelFormats[] =
+{
+    XPixelFormatGrayscale8, XPixelFormatRGB24
+};
+
+namespace Private
+{
+    // Time interval (ms) between attempts to start the server, if it failed to start (port is in use, etc.)
+    static const uint32_t START_RETRY_INTERVAL = 5000;
+
+    // Internals of MJPEG server plug-in
+    class MjpegServerPluginData : private Uncopyable
+    {
+    public:
+        MjpegServerPluginData( ) :
+            Port( 8080 ), Quality( 85 ), MaxClients( 10 ), Server( ), LastFrame( ), SpareFrame( ),
+            StartFailed( false ), LastStartAttempt( 0 )
+        {
+        }
+
+        // Stop the server and forget about failed start, so it is started again with the next frame
+        void StopServer( )
+        {
+            Server.Stop( );
+            StartFailed = false;
+        }
+
+    public:
+        uint16_t                    Port;
+        uint8_t                     Quality;
+        uint16_t                    MaxClients;
+        MjpegHttpServer             Server;
+        shared_ptr<EncodedFrame>    LastFrame;
+        shared_ptr<EncodedFrame>    SpareFrame;
+        bool                        StartFailed;
+        uint64_t                    LastStartAttempt;
+    };
+}
+
+MjpegServerPlugin::MjpegServerPlugin( ) :
+    mData( new ::Private::MjpegServerPluginData( ) )
+{
+}
+
+MjpegServerPlugin::~MjpegServerPlugin( )
+{
+    delete mData;
+}
+
+void MjpegServerPlugin::Dispose( )
+{
+    Reset( );
+    delete this;
+}
+
+// Get specified property value of the plug-in
+XErrorCode MjpegServerPlugin::GetProperty( int32_t id, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    switch ( id )
+    {
+    case 0:
+        value->type         = XVT_U2;
+        value->value.usVal  = mData->Port;
+        break;
+
+    case 1:
+        value->type         = XVT_U1;
+        value->value.ubVal  = mData->Quality;
+        break;
+
+    case 2:
+        value->type         = XVT_U2;
+        value->value.usVal  = mData->MaxClients;
+        break;
+
+    case 3:
+        value->type         = XVT_U4;
+        value->value.uiVal  = mData->Server.ClientsCount( );
+        break;
+
+    default:
+        ret = ErrorInvalidProperty;
+        break;
+    }
+
+    return ret;
+}
+
+// Set specified property value of the plug-in
+XErrorCode MjpegServerPlugin::SetProperty( int32_t id, const xvariant* value )
+{
+    XErrorCode ret = SuccessCode;
+    xvariant   convertedValue;
+
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 4, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            mData->Port = convertedValue.value.usVal;
+            // server will be restarted on the new port with the next frame
+            mData->StopServer( );
+            break;
+
+        case 1:
+            mData->Quality = convertedValue.value.ubVal;
+            break;
+
+        case 2:
+            mData->MaxClients = convertedValue.value.usVal;
+            mData->StopServer( );
+            break;
+
+        default:
+            ret = ErrorInvalidProperty;
+            break;
+        }
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
+}
+
+// Check if the plug-in does changes to input video frames or not
+bool MjpegServerPlugin::IsReadOnlyMode( )
+{
+    return true;
+}
+
+// Get pixel formats supported by the video processing plug-in
+XErrorCode MjpegServerPlugin::GetSupportedPixelFormats( XPixelFormat* pixelFormats, int32_t* count )
+{
+    return GetSupportedPixelFormatsImpl( supportedPixelFormats, XARRAY_SIZE( supportedPixelFormats ), pixelFormats, count );
+}
+
+// Process the specified video frame
+XErrorCode MjpegServerPlugin::ProcessImage( ximage* src )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( src == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else
+    {
+        if ( !mData->Server.IsRunning( ) )
+        {
+            uint64_t now = XTimer::GetTickCount( );
+
+            // don't try binding the port on every frame if it failed recently
+            if ( ( !mData->StartFailed ) || ( now - mData->LastStartAttempt >= ::Private::START_RETRY_INTERVAL ) )
+            {
+                mData->LastStartAttempt = now;
+
+                if ( mData->Server.Start( mData->Port, mData->MaxClients ) )
+                {
+                    mData->StartFailed = false;
+                }
+                else
+                {
+                    // the error is reported only once, while the server keeps trying to start in the background
+                    if ( !mData->StartFailed )
+                    {
+                        ret = ErrorInitializationFailed;
+                    }
+                    mData->StartFailed = true;
+                }
+            }
+        }
+
+        // nothing to encode if nobody is watching
+        if ( ( mData->Server.IsRunning( ) ) && ( mData->Server.ClientsCount( ) != 0 ) )
+        {
+            shared_ptr<EncodedFrame> frame;
+
+            // reuse buffer of the frame before the last one, if it is no longer referenced by any
+            // of the clients; otherwise start with a new one, so clients still sending it are not affected
+            if ( ( mData->SpareFrame ) && ( mData->SpareFrame.use_count( ) == 1 ) )
+            {
+                frame.swap( mData->SpareFrame );
+            }
+            else
+            {
+                frame = make_shared<EncodedFrame>( );
+            }
+
+            // the frame is encoded only once, no matter how many clients are connected
+            ret = XEncodeJpegToMemory( src, mData->Quality, &frame->Buffer, &frame->BufferSize, &frame->Size );
+
+            if ( ret == SuccessCode )
+            {
+                mData->Server.PublishFrame( frame );
+                // keep the previous frame to try reusing its buffer next time
+                mData->SpareFrame = mData->LastFrame;
+                mData->LastFrame  = frame;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// Reset run time state of the video processing plug-in
+void MjpegServerPlugin::Reset( )
+{
+    mData->StopServer( );
+    mData->LastFrame.reset( );
+    mData->SpareFrame.reset( );
+}
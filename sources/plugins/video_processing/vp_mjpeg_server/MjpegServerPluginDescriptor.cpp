@@ -0,0 +1,131 @@
+/*
+    MJPEG HTTP server plug-in for Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include "MjpegServerPlugin.hpp"
+#include <image_mjpeg_stream_16x16.h>
+
+static void PluginInitializer( );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000022, 0x00000001 };
+
+// Port property
+static PropertyDescriptor portProperty =
+{ XVT_U2, "Port", "port", "TCP port to listen for clients' connections on.", PropertyFlag_None };
+// Quality property
+static PropertyDescriptor qualityProperty =
+{ XVT_U1, "Quality", "quality", "Quality of JPEG encoding, [0, 100].", PropertyFlag_None };
+// Max Clients property
+static PropertyDescriptor maxClientsProperty =
+{ XVT_U2, "Max Clients", "maxClients", "Maximum number of simultaneously connected clients.", PropertyFlag_None };
+// Clients Count property
+static PropertyDescriptor clientsCountProperty =
+{ XVT_U4, "Clients Count", "clientsCount", "Number of currently connected clients.", PropertyFlag_ReadOnly };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &portProperty, &qualityProperty, &maxClientsProperty, &clientsCountProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** MjpegServerPlugin::propertiesDescription = ( const PropertyDescriptor** ) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS
+(
+    PluginID,
+    PluginFamilyID_VideoProcessing,
+
+    PluginType_VideoProcessing,
+    PluginVersion,
+    "MJPEG Server",
+    "MjpegServer",
+    "Plug-in to stream video frames over HTTP as MJPEG stream.",
+
+    "This plug-in runs a small HTTP server, which streams processed video frames to any number of connected "
+    "clients (web browsers, for example). The server is started on the first processed frame and provides the "
+    "next end points:"
+    "<ul>"
+    "<li><b>/</b>, <b>/video</b>, <b>/video.mjpg</b> or <b>/stream</b> - MJPEG stream (multipart/x-mixed-replace);</li>"
+    "<li><b>/snapshot</b>, <b>/snapshot.jpg</b> or <b>/image.jpg</b> - single JPEG image.</li>"
+    "</ul>"
+
+    "Each video frame is JPEG encoded only once, no matter how many clients are connected, and it is not encoded "
+    "at all if there are no clients. Sending is done by a background thread using non-blocking sockets, so "
+    "slow clients never delay video processing - if a client did not manage to receive previous frame by the "
+    "time a new one arrives, it simply skips all intermediate frames and gets the latest one.<br><br>"
+
+    "<b>Note</b>: changing port number or maximum number of clients restarts the server, which disconnects "
+    "all clients."
+    ,
+    &image_mjpeg_stream_16x16,
+    0,
+    MjpegServerPlugin,
+
+    sizeof( pluginProperties ) / sizeof( PropertyDescriptor* ),
+    pluginProperties,
+    PluginInitializer,
+    0,
+    0,
+    0,
+    0,
+    PluginFlag_NotSplittable
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    portProperty.DefaultValue.type = XVT_U2;
+    portProperty.DefaultValue.value.usVal = 8080;
+
+    portProperty.MinValue.type = XVT_U2;
+    portProperty.MinValue.value.usVal = 1;
+
+    portProperty.MaxValue.type = XVT_U2;
+    portProperty.MaxValue.value.usVal = 65535;
+
+    qualityProperty.DefaultValue.type = XVT_U1;
+    qualityProperty.DefaultValue.value.ubVal = 85;
+
+    qualityProperty.MinValue.type = XVT_U1;
+    qualityProperty.MinValue.value.ubVal = 0;
+
+    qualityProperty.MaxValue.type = XVT_U1;
+    qualityProperty.MaxValue.value.ubVal = 100;
+
+    maxClientsProperty.DefaultValue.type = XVT_U2;
+    maxClientsProperty.DefaultValue.value.usVal = 10;
+
+    maxClientsProperty.MinValue.type = XVT_U2;
+    maxClientsProperty.MinValue.value.usVal = 1;
+
+    maxClientsProperty.MaxValue.type = XVT_U2;
+    maxClientsProperty.MaxValue.value.usVal = 50;
+
+    clientsCountProperty.DefaultValue.type = XVT_U4;
+    clientsCountProperty.DefaultValue.value.uiVal = 0;
+}
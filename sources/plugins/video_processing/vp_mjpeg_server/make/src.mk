@@ -0,0 +1,17 @@
+# vp_mjpeg_server plug-in source files
+
+# search path for source files
+VPATH = ../../
+
+# source files
+SRC = vp_mjpeg_server.cpp \
+	MjpegServerPlugin.cpp MjpegServerPluginDescriptor.cpp \
+	MjpegHttpServer.cpp
+
+# additional include folders
+INCLUDES = -I../../../../../afx/afx_types -I../../../../../afx/afx_types+ \
+	-I../../../../../afx/afx_platform+ -I../../../../../afx/afx_imaging_formats \
+	-I../../../../../core/iplugin -I../../../../../images
+
+# libraries to use
+LIBS =  -liplugin -lafx_imaging_formats -lafx_platform+ -lafx_types+ -lafx_types -ljpeg -lexif -lws2_32
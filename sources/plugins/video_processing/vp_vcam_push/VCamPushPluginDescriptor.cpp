@@ -30,7 +30,7 @@ static xversion PluginVersion = { 1, 1, 0 };
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x0000000E, 0x00000001 };
 
 // Register the plug-in
-REGISTER_CPP_PLUGIN
+REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS
 (
     PluginID,
     PluginFamilyID_VideoProcessing,
@@ -51,5 +51,14 @@ REGISTER_CPP_PLUGIN
     ,
     &image_camera_push_16x16,
     nullptr,
-    VCamPushPlugin
+    VCamPushPlugin,
+
+    0,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    0,
+    nullptr,
+    PluginFlag_NotSplittable
 );
@@ -47,7 +47,8 @@ namespace Private
     {
     public:
         FileVideoSourcePluginData( ) : UserCallbacks( { 0 } ), UserParam( nullptr ),
-            VideoFile( ), FrameInterval( 40 ), OverrideFrameInterval( false )
+            VideoFile( ), FrameInterval( 40 ), OverrideFrameInterval( false ), StartTime( 0 ),
+            FramesCount( 0 ), Duration( 0 ), CurrentFrame( 0 ), CurrentTime( 0 ), EndFrame( 0 ), SeekFrame( -1 ), SeekTime( -1 )
         {
         }
 
@@ -59,6 +60,10 @@ namespace Private
         void ErrorMessageNotify( const char* errorMessage );
         // Get rectangle of the specified window
         bool GetWindowRectangle( xrect* windowRect );
+        // Get numbers of key frames of the video file
+        XErrorCode GetKeyFrames( xvariant* keyFrames );
+        // Perform seek requested by user (if any)
+        XErrorCode HandleSeekRequest( const shared_ptr<XFFmpegVideoFileReader>& videoFile );
         // Run video loop in a background worker thread
         void VideoSourceWorker( );
 
@@ -69,6 +74,15 @@ namespace Private
         string              VideoFile;
         uint16_t            FrameInterval;
         bool                OverrideFrameInterval;
+        uint32_t            StartTime;
+
+        uint32_t            FramesCount;
+        uint32_t            Duration;
+        uint32_t            CurrentFrame;
+        uint32_t            CurrentTime;
+        uint32_t            EndFrame;
+        int64_t             SeekFrame;
+        int64_t             SeekTime;
 
         XMutex              Sync;
         XManualResetEvent   ExitEvent;
@@ -103,6 +117,12 @@ XErrorCode FileVideoSourcePlugin::Start( )
     mData->FramesCounter = 0;
     mData->ExitEvent.Reset( );
 
+    // start playing from the configured time, unless a seek was requested before starting
+    if ( ( mData->SeekFrame < 0 ) && ( mData->SeekTime < 0 ) && ( mData->StartTime != 0 ) )
+    {
+        mData->SeekTime = mData->StartTime;
+    }
+
     if ( mData->BackgroundThread.Create( ::Private::FileVideoSourcePluginData::WorkerThreadHandler, mData ) )
     {
         ret = SuccessCode;
@@ -199,6 +219,36 @@ XErrorCode FileVideoSourcePlugin::GetProperty( int32_t id, xvariant* value ) con
         value->value.usVal = mData->FrameInterval;
         break;
 
+    case 3:
+        value->type = XVT_U4;
+        value->value.uiVal = mData->StartTime;
+        break;
+
+    case 4:
+        value->type = XVT_U4;
+        value->value.uiVal = mData->FramesCount;
+        break;
+
+    case 5:
+        value->type = XVT_U4;
+        value->value.uiVal = mData->Duration;
+        break;
+
+    case 6:
+        value->type = XVT_U4;
+        value->value.uiVal = mData->CurrentFrame;
+        break;
+
+    case 7:
+        value->type = XVT_U4;
+        value->value.uiVal = mData->CurrentTime;
+        break;
+
+    case 8:
+        value->type = XVT_U4;
+        value->value.uiVal = mData->EndFrame;
+        break;
+
     default:
         ret = ErrorInvalidProperty;
         break;
@@ -217,7 +267,7 @@ XErrorCode FileVideoSourcePlugin::SetProperty( int32_t id, const xvariant* value
     XVariantInit( &convertedValue );
 
     // make sure property value has expected type
-    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 3, &convertedValue );
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 9, &convertedValue );
 
     if ( ret == SuccessCode )
     {
@@ -235,6 +285,14 @@ XErrorCode FileVideoSourcePlugin::SetProperty( int32_t id, const xvariant* value
             mData->FrameInterval = convertedValue.value.usVal;
             break;
 
+        case 3:
+            mData->StartTime = convertedValue.value.uiVal;
+            break;
+
+        case 8:
+            mData->EndFrame = convertedValue.value.uiVal;
+            break;
+
         default:
             ret = ErrorInvalidProperty;
             break;
@@ -246,6 +304,41 @@ XErrorCode FileVideoSourcePlugin::SetProperty( int32_t id, const xvariant* value
     return ret;
 }
 
+// Call the specified function of the plug-in
+XErrorCode FileVideoSourcePlugin::CallFunction( int32_t id, xvariant* returnValue, const xarray* arguments )
+{
+    XErrorCode ret = ValidateFunctionArguments( id, arguments, functionsDescription, functionsCount );
+
+    if ( ( ret == SuccessCode ) && ( id == 2 ) )
+    {
+        ret = mData->GetKeyFrames( returnValue );
+    }
+    else if ( ret == SuccessCode )
+    {
+        XScopedLock lock( &mData->Sync );
+
+        // seek is done by the video thread before providing the next frame (or on start, if not running yet)
+        switch ( id )
+        {
+        case 0:
+            mData->SeekFrame = arguments->elements[0].value.uiVal;
+            mData->SeekTime  = -1;
+            break;
+
+        case 1:
+            mData->SeekTime  = arguments->elements[0].value.uiVal;
+            mData->SeekFrame = -1;
+            break;
+
+        default:
+            ret = ErrorInvalidFunction;
+            break;
+        }
+    }
+
+    return ret;
+}
+
 namespace Private
 {
     // Video thread entry point
@@ -279,12 +372,92 @@ namespace Private
         }
     }
 
+    // Get numbers of key frames of the video file
+    XErrorCode FileVideoSourcePluginData::GetKeyFrames( xvariant* keyFrames )
+    {
+        shared_ptr<XFFmpegVideoFileReader> videoFile = XFFmpegVideoFileReader::Create( );
+        string                             videoFileName;
+        XErrorCode                         ret;
+
+        {
+            XScopedLock lock( &Sync );
+            videoFileName = VideoFile;
+        }
+
+        if ( !videoFile )
+        {
+            ret = ErrorOutOfMemory;
+        }
+        else if ( ( ret = videoFile->Open( videoFileName ) ) == SuccessCode )
+        {
+            uint32_t keyFramesCount = static_cast<uint32_t>( videoFile->KeyFramesCount( ) );
+            xarray*  array          = nullptr;
+            xvariant v;
+
+            // a video without index still has its first frame to start from
+            ret = XArrayAllocate( &array, XVT_U4, ( keyFramesCount == 0 ) ? 1 : keyFramesCount );
+
+            if ( ret == SuccessCode )
+            {
+                v.type        = XVT_U4;
+                v.value.uiVal = 0;
+
+                if ( keyFramesCount == 0 )
+                {
+                    XArraySet( array, 0, &v );
+                }
+
+                for ( uint32_t i = 0; i < keyFramesCount; i++ )
+                {
+                    v.value.uiVal = static_cast<uint32_t>( videoFile->KeyFrameNumber( i ) );
+                    XArraySet( array, i, &v );
+                }
+
+                keyFrames->type = XVT_U4 | XVT_Array;
+                keyFrames->value.arrayVal = array;
+            }
+
+            videoFile->Close( );
+        }
+
+        return ret;
+    }
+
+    // Perform seek requested by user (if any)
+    XErrorCode FileVideoSourcePluginData::HandleSeekRequest( const shared_ptr<XFFmpegVideoFileReader>& videoFile )
+    {
+        XErrorCode ret       = SuccessCode;
+        int64_t    seekFrame = -1;
+        int64_t    seekTime  = -1;
+
+        {
+            XScopedLock lock( &Sync );
+
+            seekFrame = SeekFrame;
+            seekTime  = SeekTime;
+            SeekFrame = -1;
+            SeekTime  = -1;
+        }
+
+        if ( seekFrame >= 0 )
+        {
+            ret = videoFile->SeekToFrame( seekFrame );
+        }
+        else if ( seekTime >= 0 )
+        {
+            ret = videoFile->SeekToTime( seekTime );
+        }
+
+        return ret;
+    }
+
     // Run video loop in a background thread
     void FileVideoSourcePluginData::VideoSourceWorker( )
     {
         string   videoFileName;
         uint16_t frameInterval;
         bool     overrideFrameInterval;
+        uint32_t endFrame;
 
         // get copies of the properties we need
         {
@@ -293,6 +466,7 @@ namespace Private
             videoFileName         = VideoFile;
             frameInterval         = FrameInterval;
             overrideFrameInterval = OverrideFrameInterval;
+            endFrame              = EndFrame;
         }
 
         shared_ptr<XFFmpegVideoFileReader> videoFile = XFFmpegVideoFileReader::Create( );
@@ -322,11 +496,29 @@ namespace Private
                     timeBetweenFrames = frameInterval;
                 }
 
+                {
+                    XScopedLock lock( &Sync );
+
+                    FramesCount = static_cast<uint32_t>( videoFile->FramesTotal( ) );
+                    Duration    = static_cast<uint32_t>( videoFile->Duration( ) );
+                }
+
                 do
                 {
                     steady_clock::time_point captureStartTime = steady_clock::now( );
 
-                    ecode = videoFile->GetNextFrame( videoFrame );
+                    ecode = HandleSeekRequest( videoFile );
+
+                    // stop quietly once the end frame is reached
+                    if ( ( ecode == SuccessCode ) && ( endFrame != 0 ) && ( videoFile->NextFrameNumber( ) >= endFrame ) )
+                    {
+                        break;
+                    }
+
+                    if ( ecode == SuccessCode )
+                    {
+                        ecode = videoFile->GetNextFrame( videoFrame );
+                    }
 
                     if ( ecode != SuccessCode )
                     {
@@ -339,6 +531,13 @@ namespace Private
                     }
                     else
                     {
+                        {
+                            XScopedLock lock( &Sync );
+
+                            CurrentFrame = static_cast<uint32_t>( videoFile->NextFrameNumber( ) - 1 );
+                            CurrentTime  = static_cast<uint32_t>( videoFile->FrameTime( ) );
+                        }
+
                         NewFrameNotify( videoFrame->ImageData( ) );
                     }
 
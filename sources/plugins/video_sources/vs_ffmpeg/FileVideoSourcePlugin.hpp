@@ -44,6 +44,8 @@ public:
     virtual XErrorCode GetProperty( int32_t id, xvariant* value ) const;
     virtual XErrorCode SetProperty( int32_t id, const xvariant* value );
 
+    virtual XErrorCode CallFunction( int32_t id, xvariant* returnValue, const xarray* arguments );
+
     // IVideoSource interface
 
     // Start video source so it initializes and begins providing video frames
@@ -68,6 +70,8 @@ public:
 private:
     ::Private::FileVideoSourcePluginData* mData;
     static const PropertyDescriptor**     propertiesDescription;
+    static const FunctionDescriptor**     functionsDescription;
+    static const int32_t                  functionsCount;
 };
 
 #endif // CVS_FILE_VIDEO_SOURCE_PLUGIN_HPP
@@ -27,7 +27,7 @@ static void PluginInitializer( );
 static XErrorCode UpdateFrameIntervalProperty( PropertyDescriptor* desc, const xvariant* parentValue );
 
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 1 };
+static xversion PluginVersion = { 1, 2, 0 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x0000000B, 0x00000002 };
@@ -41,18 +41,70 @@ static PropertyDescriptor overrideFrameIntervalProperty =
 // Frame Interval property
 static PropertyDescriptor frameIntervalProperty =
 { XVT_U2, "Frame Interval", "frameInterval", "Desired frame interval between video frames (ms).", PropertyFlag_Dependent };
+// Start Time property
+static PropertyDescriptor startTimeProperty =
+{ XVT_U4, "Start Time", "startTime", "Time (ms) to start playing the video from.", PropertyFlag_None };
+// Frames Count property
+static PropertyDescriptor framesCountProperty =
+{ XVT_U4, "Frames Count", "framesCount", "Total number of frames in the video file (if known).", PropertyFlag_ReadOnly };
+// Duration property
+static PropertyDescriptor durationProperty =
+{ XVT_U4, "Duration", "duration", "Duration (ms) of the video file (if known).", PropertyFlag_ReadOnly };
+// Current Frame property
+static PropertyDescriptor currentFrameProperty =
+{ XVT_U4, "Current Frame", "currentFrame", "Number of the last provided video frame.", PropertyFlag_ReadOnly };
+// Current Time property
+static PropertyDescriptor currentTimeProperty =
+{ XVT_U4, "Current Time", "currentTime", "Time (ms) of the last provided video frame.", PropertyFlag_ReadOnly };
+// End Frame property
+static PropertyDescriptor endFrameProperty =
+{ XVT_U4, "End Frame", "endFrame", "Number of the frame to stop playing at (not provided). Zero plays the video till its end.", PropertyFlag_None };
 
 // Array of available properties
 static PropertyDescriptor* pluginProperties[] =
 {
-    &fileNameProperty, &overrideFrameIntervalProperty, &frameIntervalProperty
+    &fileNameProperty, &overrideFrameIntervalProperty, &frameIntervalProperty, &startTimeProperty,
+    &framesCountProperty, &durationProperty, &currentFrameProperty, &currentTimeProperty,
+    &endFrameProperty
 };
 
 // Let the class itself know description of its properties
 const PropertyDescriptor** FileVideoSourcePlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
 
+// ----------------------------------------------------------------------------------------------------------------
+
+// Seek To Frame
+static ArgumentDescriptor  frameNumberArg = { XVT_U4, "frame", "Number of the frame to seek to (zero based)" };
+
+static ArgumentDescriptor* seekToFrameArgs[]   = { &frameNumberArg };
+static FunctionDescriptor  seekToFrameFunction =
+{ XVT_Empty, "SeekToFrame", "Seek to the specified frame, so it is the next one provided by the video source.", XARRAY_SIZE( seekToFrameArgs ), seekToFrameArgs };
+
+// Seek To Time
+static ArgumentDescriptor  timeArg = { XVT_U4, "time", "Time (ms) to seek to" };
+
+static ArgumentDescriptor* seekToTimeArgs[]   = { &timeArg };
+static FunctionDescriptor  seekToTimeFunction =
+{ XVT_Empty, "SeekToTime", "Seek to the frame displayed at the specified time, so it is the next one provided by the video source.", XARRAY_SIZE( seekToTimeArgs ), seekToTimeArgs };
+
+// Get Key Frames
+static FunctionDescriptor  getKeyFramesFunction =
+{ XVT_Array | XVT_U4, "GetKeyFrames", "Get numbers of key frames found in the video file (the file is opened if the video source is not running).", 0, nullptr };
+
+// Array of available functions
+static FunctionDescriptor* pluginFunctions[] =
+{
+    &seekToFrameFunction, &seekToTimeFunction, &getKeyFramesFunction
+};
+
+// Let the class itself know description of its functions
+const FunctionDescriptor** FileVideoSourcePlugin::functionsDescription = (const FunctionDescriptor**) pluginFunctions;
+const int32_t              FileVideoSourcePlugin::functionsCount       = XARRAY_SIZE( pluginFunctions );
+
+// ----------------------------------------------------------------------------------------------------------------
+
 // Register the plug-in
-REGISTER_CPP_PLUGIN_WITH_PROPS
+REGISTER_CPP_PLUGIN_WITH_PROPS_AND_FUNCS
 (
     PluginID,
     PluginFamilyID_VirtualVideoSource,
@@ -71,7 +123,16 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     "<b>Note</b>: when default frame rate is used, frames' presentation time is still ignored. As the result video may play faster, "
     "if it contains less frames per second than its FPS says, but they have presentation time associated to control "
     "playback. The plug-in is not aimed to provide video player functionality, but mostly to play previously saved videos for "
-    "image processing and computer vision projects."
+    "image processing and computer vision projects.<br><br>"
+
+    "Playing can be started from the specified <b>start time</b>. While the video source is running, it is possible to jump "
+    "to any frame or time of the video by calling <b>SeekToFrame</b>() or <b>SeekToTime</b>() functions from scripting. Seeking "
+    "starts decoding from the nearest key frame before the requested position, so it does not require decoding the video "
+    "from its beginning. If the video file's container does not provide an index of key frames, the file is scanned when it "
+    "is opened for the first time and the built index is saved next to it (*.cvskfi file).<br><br>"
+
+    "Setting <b>end frame</b> makes the video source stop once it reaches the specified frame. Together with "
+    "<b>GetKeyFrames</b>() this allows splitting a video file into segments, which can be processed independently."
     ,
     &image_video_16x16,
     nullptr,
@@ -81,7 +142,9 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     pluginProperties,
     PluginInitializer,
     nullptr,
-    nullptr
+    nullptr,
+    XARRAY_SIZE( pluginFunctions ),
+    pluginFunctions
 );
 
 // Complete properties description by initializing those parts, which were not 
@@ -102,6 +165,19 @@ static void PluginInitializer( )
 
     frameIntervalProperty.ParentProperty = 1;
     frameIntervalProperty.Updater = UpdateFrameIntervalProperty;
+
+    startTimeProperty.DefaultValue.type = XVT_U4;
+    startTimeProperty.DefaultValue.value.uiVal = 0;
+
+    // run time information properties
+    for ( int i = 4; i < 8; i++ )
+    {
+        pluginProperties[i]->DefaultValue.type = XVT_U4;
+        pluginProperties[i]->DefaultValue.value.uiVal = 0;
+    }
+
+    endFrameProperty.DefaultValue.type = XVT_U4;
+    endFrameProperty.DefaultValue.value.uiVal = 0;
 }
 
 static XErrorCode UpdateFrameIntervalProperty( PropertyDescriptor* desc, const xvariant* parentValue )
@@ -42,6 +42,7 @@ namespace Private
         }
 
         virtual void OnNewImage( const shared_ptr<const XImage>& image );
+        virtual void OnNewImage( const shared_ptr<const XImage>& image, int64_t captureTime );
         virtual void OnError( const string& errorMessage );
 
     public:
@@ -256,6 +257,22 @@ namespace Private
         }
     }
 
+    // Handle new image arrived from the video source along with its capture time
+    void NetworkStreamVideoSourcePluginData::OnNewImage( const shared_ptr<const XImage>& image, int64_t captureTime )
+    {
+        if ( image )
+        {
+            if ( UserCallbacks.NewImageWithTimestampCallback != 0 )
+            {
+                UserCallbacks.NewImageWithTimestampCallback( UserParam, image->ImageData( ), captureTime );
+            }
+            else if ( UserCallbacks.NewImageCallback != 0 )
+            {
+                UserCallbacks.NewImageCallback( UserParam, image->ImageData( ) );
+            }
+        }
+    }
+
     // Handle error message arrived from the video source
     void NetworkStreamVideoSourcePluginData::OnError( const string& errorMessage )
     {
@@ -26,7 +26,7 @@
 ModuleDescriptor moduleInfo =
 {
     { 0xAF000001, 0x00000000, 0x00000000, 0x0000000B },
-    { 1, 0, 2 },
+    { 1, 0, 5 },
     "FFmpeg Based Video Sources",
     "vs_ffmpeg",
     "The module contains different video source plug-ins based on FFmpeg library.",
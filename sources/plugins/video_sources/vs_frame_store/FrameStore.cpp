@@ -0,0 +1,506 @@
+/*
+    Frame store plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "FrameStore.hpp"
+#include <string.h>
+
+#ifdef WIN32
+    #include <windows.h>
+#endif
+
+using namespace std;
+using namespace CVSandbox;
+
+namespace Private
+{
+    static const uint32_t INDEX_MAGIC         = 0x49535643; // "CVSI"
+    static const uint32_t SEGMENT_MAGIC       = 0x53535643; // "CVSS"
+    static const uint32_t STORE_VERSION       = 1;
+    static const uint32_t SEGMENT_HEADER_SIZE = 64;
+    static const uint32_t FRAME_ALIGNMENT     = 64;
+
+    static const uint32_t FRAME_FLAG_LZ4      = 1;
+
+    static const char*    INDEX_EXTENSION     = ".cvsfi";
+    static const char*    SEGMENT_EXTENSION   = ".cvsfs";
+
+    // Header of the index file
+    struct FrameStoreIndexHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t EntrySize;
+        uint32_t Reserved;
+    };
+
+    // Index entry describing single frame
+    struct FrameStoreIndexEntry
+    {
+        uint64_t Timestamp;     // microseconds
+        uint64_t Offset;        // offset of frame's data in the segment file
+        uint32_t Segment;
+        uint32_t StoredSize;    // size of frame's data in the segment file
+        int32_t  Width;
+        int32_t  Height;
+        int32_t  Format;
+        uint32_t Flags;
+    };
+
+    // Header of a segment file, which is padded to SEGMENT_HEADER_SIZE
+    struct FrameStoreSegmentHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t Segment;
+        uint32_t Reserved;
+    };
+
+    // Get base name of frame store files out of index file name
+    static string GetBaseName( const string& indexFileName )
+    {
+        size_t extLength = strlen( INDEX_EXTENSION );
+
+        return ( ( indexFileName.length( ) > extLength ) &&
+                 ( indexFileName.compare( indexFileName.length( ) - extLength, extLength, INDEX_EXTENSION ) == 0 ) ) ?
+                 indexFileName.substr( 0, indexFileName.length( ) - extLength ) : indexFileName;
+    }
+
+    // Get name of the specified segment file
+    static string GetSegmentFileName( const string& baseName, uint32_t segment )
+    {
+        char buffer[32];
+
+        sprintf( buffer, ".%04u", segment );
+
+        return baseName + buffer + SEGMENT_EXTENSION;
+    }
+
+    // Get number of bytes in a line of image's pixels (zero if the format is not supported)
+    static uint32_t GetLineSize( int32_t width, XPixelFormat format )
+    {
+        return ( ( XImageIsPixelFormatIndexed( format ) ) || ( format == XPixelFormatJPEG ) ||
+                 ( format == XPixelFormatUnknown ) || ( format >= XPixelFormatLastValue ) || ( width <= 0 ) ) ?
+                 0 : XImageBytesPerLine( XImageBitsPerPixel( format ) * static_cast<uint32_t>( width ) );
+    }
+
+    // Open file with UTF8 name
+    static FILE* OpenFile( const string& fileName, const char* mode )
+    {
+        FILE* file = nullptr;
+
+    #ifdef WIN32
+        int charsRequired = MultiByteToWideChar( CP_UTF8, 0, fileName.c_str( ), -1, NULL, 0 );
+
+        if ( charsRequired > 0 )
+        {
+            WCHAR* fileNameUtf16 = new WCHAR[charsRequired];
+            WCHAR  modeUtf16[8]  = { 0 };
+
+            for ( int i = 0; ( mode[i] != '\0' ) && ( i < 7 ); i++ )
+            {
+                modeUtf16[i] = static_cast<WCHAR>( mode[i] );
+            }
+
+            if ( MultiByteToWideChar( CP_UTF8, 0, fileName.c_str( ), -1, fileNameUtf16, charsRequired ) > 0 )
+            {
+                file = _wfopen( fileNameUtf16, modeUtf16 );
+            }
+
+            delete [] fileNameUtf16;
+        }
+    #else
+        file = fopen( fileName.c_str( ), mode );
+    #endif
+
+        return file;
+    }
+}
+
+// ==========================================================================
+
+FrameStoreWriter::FrameStoreWriter( ) :
+    mBaseName( ), mIndexFile( nullptr ), mSegmentFile( nullptr ), mSegment( 0 ), mSegmentOffset( 0 ),
+    mMaxSegmentSize( 0 ), mCompress( false ), mCompressor( ), mPackBuffer( ), mCompressBuffer( )
+{
+}
+
+FrameStoreWriter::~FrameStoreWriter( )
+{
+    Close( );
+}
+
+// Create new frame store
+bool FrameStoreWriter::Create( const string& indexFileName, uint32_t maxSegmentSize, bool compress )
+{
+    ::Private::FrameStoreIndexHeader header = { ::Private::INDEX_MAGIC, ::Private::STORE_VERSION,
+                                                sizeof( ::Private::FrameStoreIndexEntry ), 0 };
+    bool ret = false;
+
+    Close( );
+
+    mBaseName       = ::Private::GetBaseName( indexFileName );
+    mMaxSegmentSize = maxSegmentSize;
+    mCompress       = compress;
+    mIndexFile      = ::Private::OpenFile( mBaseName + ::Private::INDEX_EXTENSION, "wb" );
+
+    if ( mIndexFile != nullptr )
+    {
+        ret = ( fwrite( &header, sizeof( header ), 1, mIndexFile ) == 1 ) && ( OpenSegment( 0 ) );
+    }
+
+    if ( !ret )
+    {
+        Close( );
+    }
+
+    return ret;
+}
+
+// Finish writing and close frame store
+void FrameStoreWriter::Close( )
+{
+    if ( mSegmentFile != nullptr )
+    {
+        fclose( mSegmentFile );
+        mSegmentFile = nullptr;
+    }
+    if ( mIndexFile != nullptr )
+    {
+        fclose( mIndexFile );
+        mIndexFile = nullptr;
+    }
+}
+
+// Check if frame store is open
+bool FrameStoreWriter::IsOpen( ) const
+{
+    return ( mIndexFile != nullptr );
+}
+
+// Close current segment file and start the specified one
+bool FrameStoreWriter::OpenSegment( uint32_t segment )
+{
+    uint8_t                            header[::Private::SEGMENT_HEADER_SIZE] = { 0 };
+    ::Private::FrameStoreSegmentHeader segmentHeader = { ::Private::SEGMENT_MAGIC, ::Private::STORE_VERSION, segment, 0 };
+    bool                               ret = false;
+
+    if ( mSegmentFile != nullptr )
+    {
+        fclose( mSegmentFile );
+    }
+
+    memcpy( header, &segmentHeader, sizeof( segmentHeader ) );
+
+    mSegment       = segment;
+    mSegmentOffset = ::Private::SEGMENT_HEADER_SIZE;
+    mSegmentFile   = ::Private::OpenFile( ::Private::GetSegmentFileName( mBaseName, segment ), "wb" );
+
+    if ( mSegmentFile != nullptr )
+    {
+        ret = ( fwrite( header, sizeof( header ), 1, mSegmentFile ) == 1 );
+
+        // make sure index describes only frames, which are already in segment files
+        fflush( mIndexFile );
+    }
+
+    return ret;
+}
+
+// Append image to the frame store
+XErrorCode FrameStoreWriter::WriteImage( const ximage* image, uint64_t timestamp )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( image == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( !IsOpen( ) )
+    {
+        ret = ErrorIOFailure;
+    }
+    else
+    {
+        uint32_t lineSize = ::Private::GetLineSize( image->width, image->format );
+        uint64_t rawSize  = static_cast<uint64_t>( lineSize ) * static_cast<uint32_t>( XMAX( 0, image->height ) );
+
+        if ( ( lineSize == 0 ) || ( image->height <= 0 ) )
+        {
+            ret = ErrorUnsupportedPixelFormat;
+        }
+        else if ( rawSize > 0xFFFFFFFF - ::Private::FRAME_ALIGNMENT )
+        {
+            ret = ErrorImageIsTooBig;
+        }
+        else
+        {
+            ::Private::FrameStoreIndexEntry entry;
+            const uint8_t*                  data = image->data;
+            uint32_t                        size = static_cast<uint32_t>( rawSize );
+
+            memset( &entry, 0, sizeof( entry ) );
+
+            // lines are stored without padding, so need to pack them first if the image has any
+            if ( static_cast<uint32_t>( image->stride ) != lineSize )
+            {
+                mPackBuffer.resize( size );
+
+                for ( int32_t y = 0; y < image->height; y++ )
+                {
+                    memcpy( &mPackBuffer[y * lineSize], image->data + y * image->stride, lineSize );
+                }
+
+                data = &mPackBuffer[0];
+            }
+
+            if ( mCompress )
+            {
+                uint32_t compressedSize;
+
+                mCompressBuffer.resize( Lz4Block::CompressBound( size ) );
+                compressedSize = mCompressor.Compress( data, size, &mCompressBuffer[0], static_cast<uint32_t>( mCompressBuffer.size( ) ) );
+
+                // keep the frame as is if it does not compress
+                if ( ( compressedSize != 0 ) && ( compressedSize < size ) )
+                {
+                    data         = &mCompressBuffer[0];
+                    size         = compressedSize;
+                    entry.Flags |= ::Private::FRAME_FLAG_LZ4;
+                }
+            }
+
+            uint64_t offset = ( mSegmentOffset + ::Private::FRAME_ALIGNMENT - 1 ) & ~static_cast<uint64_t>( ::Private::FRAME_ALIGNMENT - 1 );
+
+            // start new segment if the frame does not fit into the current one (unless it is empty)
+            if ( ( offset + size > mMaxSegmentSize ) && ( mSegmentOffset > ::Private::SEGMENT_HEADER_SIZE ) )
+            {
+                if ( !OpenSegment( mSegment + 1 ) )
+                {
+                    ret = ErrorIOFailure;
+                }
+                offset = mSegmentOffset;
+            }
+
+            if ( ret == SuccessCode )
+            {
+                static const uint8_t padding[::Private::FRAME_ALIGNMENT] = { 0 };
+                size_t               paddingSize = static_cast<size_t>( offset - mSegmentOffset );
+
+                entry.Timestamp  = timestamp;
+                entry.Offset     = offset;
+                entry.Segment    = mSegment;
+                entry.StoredSize = size;
+                entry.Width      = image->width;
+                entry.Height     = image->height;
+                entry.Format     = image->format;
+
+                if ( ( ( paddingSize != 0 ) && ( fwrite( padding, 1, paddingSize, mSegmentFile ) != paddingSize ) ) ||
+                     ( fwrite( data, 1, size, mSegmentFile ) != size ) ||
+                     ( fwrite( &entry, sizeof( entry ), 1, mIndexFile ) != 1 ) )
+                {
+                    ret = ErrorIOFailure;
+                }
+
+                mSegmentOffset = offset + size;
+            }
+        }
+    }
+
+    return ret;
+}
+
+// ==========================================================================
+
+FrameStoreReader::FrameStoreReader( ) :
+    mBaseName( ), mIndexFile( ), mSegmentFile( ), mEntries( nullptr ), mFramesCount( 0 ), mSegment( 0 ),
+    mImage( nullptr ), mDecompressedImage( nullptr )
+{
+}
+
+FrameStoreReader::~FrameStoreReader( )
+{
+    Close( );
+}
+
+// Open frame store by its index file name
+bool FrameStoreReader::Open( const string& indexFileName )
+{
+    bool ret = false;
+
+    Close( );
+
+    mBaseName = ::Private::GetBaseName( indexFileName );
+
+    if ( ( mIndexFile.Open( mBaseName + ::Private::INDEX_EXTENSION ) ) &&
+         ( mIndexFile.Size( ) >= sizeof( ::Private::FrameStoreIndexHeader ) ) )
+    {
+        const ::Private::FrameStoreIndexHeader* header = reinterpret_cast<const ::Private::FrameStoreIndexHeader*>( mIndexFile.Data( ) );
+
+        if ( ( header->Magic == ::Private::INDEX_MAGIC ) && ( header->Version == ::Private::STORE_VERSION ) &&
+             ( header->EntrySize == sizeof( ::Private::FrameStoreIndexEntry ) ) )
+        {
+            // a partially written entry at the end (recording was interrupted) is ignored
+            mEntries     = reinterpret_cast<const ::Private::FrameStoreIndexEntry*>( mIndexFile.Data( ) + sizeof( ::Private::FrameStoreIndexHeader ) );
+            mFramesCount = static_cast<uint32_t>( ( mIndexFile.Size( ) - sizeof( ::Private::FrameStoreIndexHeader ) ) / sizeof( ::Private::FrameStoreIndexEntry ) );
+            ret = true;
+        }
+    }
+
+    if ( !ret )
+    {
+        Close( );
+    }
+
+    return ret;
+}
+
+// Close frame store and unmap its files
+void FrameStoreReader::Close( )
+{
+    XImageFree( &mImage );
+    XImageFree( &mDecompressedImage );
+
+    mSegmentFile.Close( );
+    mIndexFile.Close( );
+
+    mEntries     = nullptr;
+    mFramesCount = 0;
+}
+
+// Get number of frames in the store
+uint32_t FrameStoreReader::FramesCount( ) const
+{
+    return mFramesCount;
+}
+
+// Get time stamp of the specified frame
+uint64_t FrameStoreReader::FrameTimestamp( uint32_t frameIndex ) const
+{
+    return ( frameIndex < mFramesCount ) ? mEntries[frameIndex].Timestamp : 0;
+}
+
+// Get the specified frame
+XErrorCode FrameStoreReader::GetFrame( uint32_t frameIndex, const ximage** image )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( image == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( frameIndex >= mFramesCount )
+    {
+        ret = ErrorIndexOutOfBounds;
+    }
+    else
+    {
+        const ::Private::FrameStoreIndexEntry& entry = mEntries[frameIndex];
+        XPixelFormat                           format   = static_cast<XPixelFormat>( entry.Format );
+        uint32_t                               lineSize = ::Private::GetLineSize( entry.Width, format );
+        uint64_t                               rawSize  = static_cast<uint64_t>( lineSize ) * static_cast<uint32_t>( XMAX( 0, entry.Height ) );
+
+        // only one segment is mapped at a time, so that 32 bit processes don't run out of address space
+        if ( ( !mSegmentFile.IsOpen( ) ) || ( mSegment != entry.Segment ) )
+        {
+            mSegmentFile.Close( );
+
+            if ( ( !mSegmentFile.Open( ::Private::GetSegmentFileName( mBaseName, entry.Segment ) ) ) ||
+                 ( mSegmentFile.Size( ) < ::Private::SEGMENT_HEADER_SIZE ) ||
+                 ( reinterpret_cast<const ::Private::FrameStoreSegmentHeader*>( mSegmentFile.Data( ) )->Magic != ::Private::SEGMENT_MAGIC ) )
+            {
+                mSegmentFile.Close( );
+                ret = ErrorIOFailure;
+            }
+
+            mSegment = entry.Segment;
+        }
+
+        if ( ( ret == SuccessCode ) && ( ( lineSize == 0 ) || ( entry.Height <= 0 ) ) )
+        {
+            ret = ErrorUnsupportedPixelFormat;
+        }
+        else if ( ( ret == SuccessCode ) && ( ( entry.Offset > mSegmentFile.Size( ) ) || ( entry.StoredSize > mSegmentFile.Size( ) - entry.Offset ) ) )
+        {
+            // the index refers to data, which did not make it into segment file
+            ret = ErrorEOF;
+        }
+        else if ( ret == SuccessCode )
+        {
+            const uint8_t* data = mSegmentFile.Data( ) + entry.Offset;
+
+            XImageFree( &mImage );
+
+            if ( ( entry.Flags & ::Private::FRAME_FLAG_LZ4 ) == 0 )
+            {
+                if ( entry.StoredSize != rawSize )
+                {
+                    ret = ErrorInvalidFormat;
+                }
+                else
+                {
+                    // wrap the mapped memory - the image is provided to clients as read only anyway
+                    ret = XImageCreate( const_cast<uint8_t*>( data ), entry.Width, entry.Height, static_cast<int32_t>( lineSize ), format, &mImage );
+                }
+            }
+            else
+            {
+                ret = XImageAllocateRaw( entry.Width, entry.Height, format, &mDecompressedImage );
+
+                if ( ret == SuccessCode )
+                {
+                    if ( static_cast<uint32_t>( mDecompressedImage->stride ) == lineSize )
+                    {
+                        if ( !Lz4Block::Decompress( data, entry.StoredSize, mDecompressedImage->data, static_cast<uint32_t>( rawSize ) ) )
+                        {
+                            ret = ErrorInvalidFormat;
+                        }
+                    }
+                    else
+                    {
+                        // allocated image has padded lines, so decompress into a temporary buffer first
+                        vector<uint8_t> buffer( static_cast<size_t>( rawSize ) );
+
+                        if ( !Lz4Block::Decompress( data, entry.StoredSize, &buffer[0], static_cast<uint32_t>( rawSize ) ) )
+                        {
+                            ret = ErrorInvalidFormat;
+                        }
+                        else
+                        {
+                            for ( int32_t y = 0; y < entry.Height; y++ )
+                            {
+                                memcpy( mDecompressedImage->data + y * mDecompressedImage->stride, &buffer[y * lineSize], lineSize );
+                            }
+                        }
+                    }
+                }
+
+                if ( ret == SuccessCode )
+                {
+                    ret = XImageCreate( mDecompressedImage->data, entry.Width, entry.Height, mDecompressedImage->stride, format, &mImage );
+                }
+            }
+
+            *image = mImage;
+        }
+    }
+
+    return ret;
+}
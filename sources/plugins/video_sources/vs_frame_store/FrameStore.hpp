@@ -0,0 +1,110 @@
+/*
+    Frame store plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_FRAME_STORE_HPP
+#define CVS_FRAME_STORE_HPP
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <ximage.h>
+#include <XInterfaces.hpp>
+#include <XMappedFile.hpp>
+#include "Lz4Block.hpp"
+
+// Frame store keeps raw video frames in a set of files:
+//   <name>.cvsfi      - index file with fixed size entries describing every frame (time stamp, location, size, format);
+//   <name>.NNNN.cvsfs - segment files with frames' data, each frame is aligned to 64 bytes.
+// Frames are stored either as is (lines of pixels without padding) or LZ4 compressed. Segment files
+// are never bigger than the configured size, so they can be memory mapped even in 32 bit processes.
+
+namespace Private
+{
+    struct FrameStoreIndexEntry;
+}
+
+// Writer of frame store
+class FrameStoreWriter : private CVSandbox::Uncopyable
+{
+public:
+    FrameStoreWriter( );
+    ~FrameStoreWriter( );
+
+    // Create new frame store, the index file name is expected to have .cvsfi extension
+    bool Create( const std::string& indexFileName, uint32_t maxSegmentSize, bool compress );
+    // Finish writing and close frame store
+    void Close( );
+    // Check if frame store is open
+    bool IsOpen( ) const;
+
+    // Append image to the frame store (timestamp is in microseconds)
+    XErrorCode WriteImage( const ximage* image, uint64_t timestamp );
+
+private:
+    bool OpenSegment( uint32_t segment );
+
+private:
+    std::string             mBaseName;
+    FILE*                   mIndexFile;
+    FILE*                   mSegmentFile;
+    uint32_t                mSegment;
+    uint64_t                mSegmentOffset;
+    uint64_t                mMaxSegmentSize;
+    bool                    mCompress;
+    Lz4Block                mCompressor;
+    std::vector<uint8_t>    mPackBuffer;
+    std::vector<uint8_t>    mCompressBuffer;
+};
+
+// Reader of frame store, which memory maps its segments
+class FrameStoreReader : private CVSandbox::Uncopyable
+{
+public:
+    FrameStoreReader( );
+    ~FrameStoreReader( );
+
+    // Open frame store by its index file name
+    bool Open( const std::string& indexFileName );
+    // Close frame store and unmap its files
+    void Close( );
+
+    // Get number of frames in the store
+    uint32_t FramesCount( ) const;
+    // Get time stamp of the specified frame (microseconds)
+    uint64_t FrameTimestamp( uint32_t frameIndex ) const;
+
+    // Get the specified frame. Uncompressed frames are not copied - the provided image points directly to
+    // the mapped memory. The image is owned by the reader and is valid till the next call or till closing.
+    XErrorCode GetFrame( uint32_t frameIndex, const ximage** image );
+
+private:
+    std::string                             mBaseName;
+    CVSandbox::XMappedFile                  mIndexFile;
+    CVSandbox::XMappedFile                  mSegmentFile;
+    const ::Private::FrameStoreIndexEntry*  mEntries;
+    uint32_t                                mFramesCount;
+    uint32_t                                mSegment;
+    ximage*                                 mImage;
+    ximage*                                 mDecompressedImage;
+};
+
+#endif // CVS_FRAME_STORE_HPP
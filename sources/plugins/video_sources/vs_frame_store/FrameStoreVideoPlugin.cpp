@@ -0,0 +1,409 @@
+/*
+    Frame store plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "FrameStoreVideoPlugin.hpp"
+#include "FrameStore.hpp"
+#include <memory.h>
+#include <string>
+#include <chrono>
+#include <XMutex.hpp>
+#include <XManualResetEvent.hpp>
+#include <XThread.hpp>
+#include <XError.hpp>
+
+using namespace std;
+using namespace std::chrono;
+using namespace CVSandbox;
+using namespace CVSandbox::Threading;
+
+namespace Private
+{
+    enum
+    {
+        PlaybackOriginalTiming = 0,
+        PlaybackScaledRate     = 1,
+        PlaybackAsFastAsPossible
+    };
+
+    // Internal class which hides private parts of the FrameStoreVideoPlugin class,
+    // so those are not exposed in the main class
+    class FrameStoreVideoPluginData
+    {
+    public:
+        FrameStoreVideoPluginData( ) : UserCallbacks( { 0 } ), UserParam( nullptr ),
+            FileName( ), PlaybackMode( PlaybackOriginalTiming ), PlaybackRate( 1.0f ), Loop( false )
+        {
+        }
+
+        // Video thread entry point
+        static void WorkerThreadHandler( void* param );
+        // Notify client about new video frame
+        void NewFrameNotify( const ximage* image );
+        // Notify client about error
+        void ErrorMessageNotify( const char* errorMessage );
+        // Wait till the specified time point, returns true if video source was signalled to stop
+        bool WaitTill( const steady_clock::time_point& timePoint );
+        // Run video loop in a background worker thread
+        void VideoSourceWorker( );
+
+    public:
+        VideoSourcePluginCallbacks  UserCallbacks;
+        void*                       UserParam;
+
+        string              FileName;
+        uint8_t             PlaybackMode;
+        float               PlaybackRate;
+        bool                Loop;
+
+        XMutex              Sync;
+        XManualResetEvent   ExitEvent;
+        XThread             BackgroundThread;
+        uint32_t            FramesCounter;
+    };
+}
+
+// ==========================================================================
+
+FrameStoreVideoPlugin::FrameStoreVideoPlugin( ) :
+    mData( new ::Private::FrameStoreVideoPluginData( ) )
+{
+}
+
+FrameStoreVideoPlugin::~FrameStoreVideoPlugin( )
+{
+    delete mData;
+}
+
+void FrameStoreVideoPlugin::Dispose( )
+{
+    delete this;
+}
+
+// Start video source so it initializes and begins providing video frames
+XErrorCode FrameStoreVideoPlugin::Start( )
+{
+    XScopedLock lock( &mData->Sync );
+    XErrorCode  ret = ErrorFailed;
+
+    mData->FramesCounter = 0;
+    mData->ExitEvent.Reset( );
+
+    if ( mData->FileName.empty( ) )
+    {
+        ret = ErrorInvalidConfiguration;
+    }
+    else if ( mData->BackgroundThread.Create( ::Private::FrameStoreVideoPluginData::WorkerThreadHandler, mData ) )
+    {
+        ret = SuccessCode;
+    }
+
+    return ret;
+}
+
+// Signal video to stop, so it could finalize and clean-up
+void FrameStoreVideoPlugin::SignalToStop( )
+{
+    XScopedLock lock( &mData->Sync );
+
+    if ( IsRunning( ) )
+    {
+        mData->ExitEvent.Signal( );
+    }
+}
+
+// Wait till video source stops
+void FrameStoreVideoPlugin::WaitForStop( )
+{
+    if ( IsRunning( ) )
+    {
+        XScopedLock lock( &mData->Sync );
+        mData->ExitEvent.Signal( );
+    }
+
+    mData->BackgroundThread.Join( );
+}
+
+// Check if video source (its thread) is still running
+bool FrameStoreVideoPlugin::IsRunning( )
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->BackgroundThread.IsRunning( );
+}
+
+// Terminate video source - call *ONLY* if video source looks to be frozen and does not stop
+// by itself when signalled (ideally this method should not exist and be called at all)
+void FrameStoreVideoPlugin::Terminate( )
+{
+    XScopedLock lock( &mData->Sync );
+
+    if ( IsRunning( ) )
+    {
+        mData->BackgroundThread.Terminate( );
+    }
+}
+
+// Get number of frames received since the the start of the video source
+uint32_t FrameStoreVideoPlugin::FramesReceived( )
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->FramesCounter;
+}
+
+// Set callbacks for the video source
+void FrameStoreVideoPlugin::SetCallbacks( const VideoSourcePluginCallbacks* callbacks, void* userParam )
+{
+    XScopedLock lock( &mData->Sync );
+
+    if ( callbacks != 0 )
+    {
+        memcpy( &mData->UserCallbacks, callbacks, sizeof( mData->UserCallbacks ) );
+        mData->UserParam = userParam;
+    }
+    else
+    {
+        memset( &mData->UserCallbacks, 0, sizeof( mData->UserCallbacks ) );
+        mData->UserParam = 0;
+    }
+}
+
+// Get specified property value of the plug-in
+XErrorCode FrameStoreVideoPlugin::GetProperty( int32_t id, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    switch ( id )
+    {
+    case 0:
+        value->type         = XVT_String;
+        value->value.strVal = XStringAlloc( mData->FileName.c_str( ) );
+        break;
+
+    case 1:
+        value->type         = XVT_U1;
+        value->value.ubVal  = mData->PlaybackMode;
+        break;
+
+    case 2:
+        value->type         = XVT_R4;
+        value->value.fVal   = mData->PlaybackRate;
+        break;
+
+    case 3:
+        value->type         = XVT_Bool;
+        value->value.boolVal = mData->Loop;
+        break;
+
+    default:
+        ret = ErrorInvalidProperty;
+        break;
+    }
+
+    return ret;
+}
+
+// Set specified property value of the plug-in
+XErrorCode FrameStoreVideoPlugin::SetProperty( int32_t id, const xvariant* value )
+{
+    XErrorCode  ret = SuccessCode;
+    XScopedLock lock( &mData->Sync );
+
+    xvariant convertedValue;
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 4, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            mData->FileName = string( convertedValue.value.strVal );
+            break;
+
+        case 1:
+            mData->PlaybackMode = XMIN( convertedValue.value.ubVal,
+                static_cast<uint8_t>( ::Private::PlaybackAsFastAsPossible ) );
+            break;
+
+        case 2:
+            mData->PlaybackRate = XINRANGE( convertedValue.value.fVal, 0.01f, 100.0f );
+            break;
+
+        case 3:
+            mData->Loop = convertedValue.value.boolVal;
+            break;
+
+        default:
+            ret = ErrorInvalidProperty;
+            break;
+        }
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
+}
+
+namespace Private
+{
+    // Video thread entry point
+    void FrameStoreVideoPluginData::WorkerThreadHandler( void* param )
+    {
+        static_cast<FrameStoreVideoPluginData*>( param )->VideoSourceWorker( );
+    }
+
+    // Notify client about new video frame
+    void FrameStoreVideoPluginData::NewFrameNotify( const ximage* image )
+    {
+        XScopedLock lock( &Sync );
+
+        FramesCounter++;
+
+        // provide image only if someone needs it
+        if ( UserCallbacks.NewImageCallback != NULL )
+        {
+            UserCallbacks.NewImageCallback( UserParam, image );
+        }
+    }
+
+    // Notify client about error
+    void FrameStoreVideoPluginData::ErrorMessageNotify( const char* errorMessage )
+    {
+        XScopedLock lock( &Sync );
+
+        if ( UserCallbacks.ErrorMessageCallback != nullptr )
+        {
+            UserCallbacks.ErrorMessageCallback( UserParam, errorMessage );
+        }
+    }
+
+    // Wait till the specified time point, returns true if video source was signalled to stop
+    bool FrameStoreVideoPluginData::WaitTill( const steady_clock::time_point& timePoint )
+    {
+        bool exitSignaled = false;
+
+        for ( ; ; )
+        {
+            int64_t timeLeft = duration_cast<microseconds>( timePoint - steady_clock::now( ) ).count( );
+
+            if ( timeLeft <= 0 )
+            {
+                exitSignaled = ExitEvent.IsSignaled( );
+                break;
+            }
+
+            if ( timeLeft >= 1000 )
+            {
+                // sleep for whole milliseconds waiting for exit event at the same time
+                if ( ExitEvent.Wait( static_cast<uint32_t>( timeLeft / 1000 ) ) )
+                {
+                    exitSignaled = true;
+                    break;
+                }
+            }
+            else
+            {
+                // spin for the remaining fraction of millisecond
+                XThread::YieldCpu( );
+            }
+        }
+
+        return exitSignaled;
+    }
+
+    // Run video loop in a background thread
+    void FrameStoreVideoPluginData::VideoSourceWorker( )
+    {
+        FrameStoreReader reader;
+        string           fileName;
+        uint8_t          playbackMode;
+        float            playbackRate;
+        bool             loop;
+
+        {
+            XScopedLock lock( &Sync );
+            fileName     = FileName;
+            playbackMode = PlaybackMode;
+            playbackRate = ( PlaybackMode == PlaybackOriginalTiming ) ? 1.0f : PlaybackRate;
+            loop         = Loop;
+        }
+
+        if ( !reader.Open( fileName ) )
+        {
+            ErrorMessageNotify( "Failed opening frame store" );
+        }
+        else if ( reader.FramesCount( ) == 0 )
+        {
+            ErrorMessageNotify( "Frame store does not contain any frames" );
+        }
+        else
+        {
+            uint32_t framesCount    = reader.FramesCount( );
+            uint64_t firstTimestamp = reader.FrameTimestamp( 0 );
+            bool     exitSignaled   = false;
+
+            do
+            {
+                steady_clock::time_point startTime = steady_clock::now( );
+
+                for ( uint32_t frameIndex = 0; frameIndex < framesCount; frameIndex++ )
+                {
+                    if ( playbackMode == PlaybackAsFastAsPossible )
+                    {
+                        exitSignaled = ExitEvent.IsSignaled( );
+                    }
+                    else
+                    {
+                        // frame's offset from the start of the recording, scaled by the play back rate
+                        uint64_t frameTime = static_cast<uint64_t>(
+                            ( reader.FrameTimestamp( frameIndex ) - firstTimestamp ) / playbackRate );
+
+                        exitSignaled = WaitTill( startTime + microseconds( frameTime ) );
+                    }
+
+                    if ( exitSignaled )
+                    {
+                        break;
+                    }
+
+                    const ximage* image = nullptr;
+                    XErrorCode    ecode = reader.GetFrame( frameIndex, &image );
+
+                    if ( ecode == SuccessCode )
+                    {
+                        NewFrameNotify( image );
+                    }
+                    else
+                    {
+                        ErrorMessageNotify( XError::Description( ecode ).c_str( ) );
+                    }
+                }
+            }
+            while ( ( loop ) && ( !exitSignaled ) );
+
+            if ( !exitSignaled )
+            {
+                ErrorMessageNotify( "End of frame store reached" );
+            }
+        }
+    }
+}
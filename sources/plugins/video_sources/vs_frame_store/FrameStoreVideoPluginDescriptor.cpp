@@ -0,0 +1,165 @@
+/*
+    Frame store plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include "FrameStoreVideoPlugin.hpp"
+#include <image_video_16x16.h>
+
+static void PluginInitializer( );
+static void PluginCleaner( );
+static XErrorCode UpdatePlaybackRateProperty( PropertyDescriptor* desc, const xvariant* parentValue );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000023, 0x00000001 };
+
+// File Name property
+static PropertyDescriptor fileNameProperty =
+{ XVT_String, "File Name", "fileName", "Index file (*.cvsfi) of the frame store to play.", PropertyFlag_PreferredEditor_FileBrowser };
+// Playback Mode property
+static PropertyDescriptor playbackModeProperty =
+{ XVT_U1, "Playback Mode", "playbackMode", "Specifies how to time provided video frames.", PropertyFlag_SelectionByIndex };
+// Playback Rate property
+static PropertyDescriptor playbackRateProperty =
+{ XVT_R4, "Playback Rate", "playbackRate", "Play back speed relative to the original timing.", PropertyFlag_Dependent };
+// Loop property
+static PropertyDescriptor loopProperty =
+{ XVT_Bool, "Loop", "loop", "Start playing from the beginning, when the end of frame store is reached.", PropertyFlag_None };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &fileNameProperty, &playbackModeProperty, &playbackRateProperty, &loopProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** FrameStoreVideoPlugin::propertiesDescription = ( const PropertyDescriptor** ) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS
+(
+    PluginID,
+    PluginFamilyID_VirtualVideoSource,
+
+    PluginType_VideoSource,
+    PluginVersion,
+    "Frame Store Video",
+    "FrameStoreVideo",
+    "Video source plug-in, which plays raw video frames recorded into frame store.",
+
+    "This plug-in plays video frames recorded by the <a href='{AF000003-00000000-00000023-00000002}'>Frame Store Writer</a> "
+    "plug-in. Since frames are stored without lossy compression, the video source provides exactly the same images, "
+    "which were recorded, so it can be used for reproducible testing and benchmarking of image/video processing.<br><br>"
+
+    "Frames can be played with their original timing, with the timing scaled by the specified <b>Playback Rate</b> "
+    "(2.0 plays twice as fast, 0.5 - twice as slow), or as fast as possible without any delays between frames. "
+    "Segment files of the frame store are memory mapped, so uncompressed frames are provided without any copying."
+    ,
+    &image_video_16x16,
+    0,
+    FrameStoreVideoPlugin,
+
+    XARRAY_SIZE( pluginProperties ),
+    pluginProperties,
+    PluginInitializer,
+    PluginCleaner,
+    0
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    // Playback Mode property
+    playbackModeProperty.DefaultValue.type = XVT_U1;
+    playbackModeProperty.DefaultValue.value.ubVal = 0;
+
+    playbackModeProperty.MinValue.type = XVT_U1;
+    playbackModeProperty.MinValue.value.ubVal = 0;
+
+    playbackModeProperty.MaxValue.type = XVT_U1;
+    playbackModeProperty.MaxValue.value.ubVal = 2;
+
+    playbackModeProperty.ChoicesCount = 3;
+    playbackModeProperty.Choices = new xvariant[3];
+
+    playbackModeProperty.Choices[0].type = XVT_String;
+    playbackModeProperty.Choices[0].value.strVal = XStringAlloc( "Original timing" );
+
+    playbackModeProperty.Choices[1].type = XVT_String;
+    playbackModeProperty.Choices[1].value.strVal = XStringAlloc( "Scaled rate" );
+
+    playbackModeProperty.Choices[2].type = XVT_String;
+    playbackModeProperty.Choices[2].value.strVal = XStringAlloc( "As fast as possible" );
+
+    // Playback Rate property
+    playbackRateProperty.DefaultValue.type = XVT_R4;
+    playbackRateProperty.DefaultValue.value.fVal = 1.0f;
+
+    playbackRateProperty.MinValue.type = XVT_R4;
+    playbackRateProperty.MinValue.value.fVal = 0.01f;
+
+    playbackRateProperty.MaxValue.type = XVT_R4;
+    playbackRateProperty.MaxValue.value.fVal = 100.0f;
+
+    playbackRateProperty.ParentProperty = 1;
+    playbackRateProperty.Updater = UpdatePlaybackRateProperty;
+
+    // Loop property
+    loopProperty.DefaultValue.type = XVT_Bool;
+    loopProperty.DefaultValue.value.boolVal = false;
+}
+
+// Clean-up plug-in - deallocate strings
+static void PluginCleaner( )
+{
+    for ( int i = 0; i < playbackModeProperty.ChoicesCount; i++ )
+    {
+        XVariantClear( &playbackModeProperty.Choices[i] );
+    }
+
+    delete[] playbackModeProperty.Choices;
+}
+
+// Enable Playback Rate property only for the scaled rate mode
+static XErrorCode UpdatePlaybackRateProperty( PropertyDescriptor* desc, const xvariant* parentValue )
+{
+    XErrorCode ret = ErrorFailed;
+    uint8_t    mode;
+
+    ret = XVariantToUByte( parentValue, &mode );
+
+    if ( ret == SuccessCode )
+    {
+        if ( mode == 1 )
+        {
+            desc->Flags &= ( ~PropertyFlag_Disabled );
+        }
+        else
+        {
+            desc->Flags |= PropertyFlag_Disabled;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,229 @@
+/*
+    Frame store plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "FrameStoreWriterPlugin.hpp"
+#include "FrameStore.hpp"
+#include <chrono>
+#include <ctime>
+
+using namespace std;
+using namespace std::chrono;
+
+// List of supported pixel formats
+const XPixelFormat FrameStoreWriterPlugin::supportedPixelFormats[] =
+{
+    XPixelFormatGrayscale8, XPixelFormatRGB24, XPixelFormatRGBA32,
+    XPixelFormatGrayscale16, XPixelFormatRGB48, XPixelFormatRGBA64
+};
+
+namespace Private
+{
+    // Internals of frame store writer plug-in
+    class FrameStoreWriterPluginData
+    {
+    public:
+        FrameStoreWriterPluginData( ) :
+            FolderToWrite( ), FileNamePrefix( "frames" ), Compression( 0 ), SegmentSize( 1024 ),
+            Writer( ), RecordingStart( )
+        {
+        }
+
+        XErrorCode StartRecording( );
+
+    public:
+        string      FolderToWrite;
+        string      FileNamePrefix;
+        uint8_t     Compression;
+        uint16_t    SegmentSize;
+
+        FrameStoreWriter            Writer;
+        steady_clock::time_point    RecordingStart;
+    };
+}
+
+FrameStoreWriterPlugin::FrameStoreWriterPlugin( ) :
+    mData( new ::Private::FrameStoreWriterPluginData( ) )
+{
+}
+
+FrameStoreWriterPlugin::~FrameStoreWriterPlugin( )
+{
+    delete mData;
+}
+
+void FrameStoreWriterPlugin::Dispose( )
+{
+    Reset( );
+
+    delete this;
+}
+
+// Get specified property value of the plug-in
+XErrorCode FrameStoreWriterPlugin::GetProperty( int32_t id, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    switch ( id )
+    {
+    case 0:
+        value->type         = XVT_String;
+        value->value.strVal = XStringAlloc( mData->FolderToWrite.c_str( ) );
+        break;
+
+    case 1:
+        value->type         = XVT_String;
+        value->value.strVal = XStringAlloc( mData->FileNamePrefix.c_str( ) );
+        break;
+
+    case 2:
+        value->type        = XVT_U1;
+        value->value.ubVal = mData->Compression;
+        break;
+
+    case 3:
+        value->type        = XVT_U2;
+        value->value.usVal = mData->SegmentSize;
+        break;
+
+    default:
+        ret = ErrorInvalidProperty;
+    }
+
+    return ret;
+}
+
+// Set specified property value of the plug-in
+XErrorCode FrameStoreWriterPlugin::SetProperty( int32_t id, const xvariant* value )
+{
+    XErrorCode  ret = ErrorFailed;
+    xvariant    convertedValue;
+
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 4, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            mData->FolderToWrite = convertedValue.value.strVal;
+            break;
+
+        case 1:
+            mData->FileNamePrefix = convertedValue.value.strVal;
+            break;
+
+        case 2:
+            mData->Compression = convertedValue.value.ubVal;
+            break;
+
+        case 3:
+            mData->SegmentSize = convertedValue.value.usVal;
+            break;
+
+        default:
+            ret = ErrorInvalidProperty;
+            break;
+        }
+
+        // new configuration is used for the next recording
+        mData->Writer.Close( );
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
+}
+
+// Check if the plug-in does changes to input video frames or not
+bool FrameStoreWriterPlugin::IsReadOnlyMode( )
+{
+    return true;
+}
+
+// Get pixel formats supported by the video processing plug-in
+XErrorCode FrameStoreWriterPlugin::GetSupportedPixelFormats( XPixelFormat* pixelFormats, int32_t* count )
+{
+    return GetSupportedPixelFormatsImpl( supportedPixelFormats, XARRAY_SIZE( supportedPixelFormats ), pixelFormats, count );
+}
+
+// Process the specified video frame
+XErrorCode FrameStoreWriterPlugin::ProcessImage( ximage* src )
+{
+    XErrorCode               ret     = SuccessCode;
+    steady_clock::time_point justNow = steady_clock::now( );
+
+    if ( src == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else
+    {
+        if ( !mData->Writer.IsOpen( ) )
+        {
+            ret = mData->StartRecording( );
+            mData->RecordingStart = justNow;
+        }
+
+        if ( ret == SuccessCode )
+        {
+            ret = mData->Writer.WriteImage( src, static_cast<uint64_t>( duration_cast<microseconds>( justNow - mData->RecordingStart ).count( ) ) );
+        }
+    }
+
+    return ret;
+}
+
+// Reset run time state of the video processing plug-in
+void FrameStoreWriterPlugin::Reset( )
+{
+    mData->Writer.Close( );
+}
+
+namespace Private
+{
+    // Create new frame store named after the current date/time
+    XErrorCode FrameStoreWriterPluginData::StartRecording( )
+    {
+        string     fileName = FolderToWrite;
+        size_t     length   = fileName.length( );
+        char       buffer[32] = { 0 };
+        time_t     time = system_clock::to_time_t( system_clock::now( ) );
+        struct tm* tm   = localtime( &time );
+
+        if ( ( length != 0 ) && ( fileName[length - 1] != '/' ) && ( fileName[length - 1] != '\\' ) )
+        {
+            fileName += '/';
+        }
+
+        sprintf( buffer, " %04d-%02d-%02d %02d-%02d-%02d", tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
+                                                           tm->tm_hour, tm->tm_min, tm->tm_sec );
+
+        fileName += FileNamePrefix;
+        fileName += buffer;
+        fileName += ".cvsfi";
+
+        return ( Writer.Create( fileName, static_cast<uint32_t>( SegmentSize ) * 1024 * 1024, ( Compression == 1 ) ) ) ?
+                 SuccessCode : ErrorIOFailure;
+    }
+}
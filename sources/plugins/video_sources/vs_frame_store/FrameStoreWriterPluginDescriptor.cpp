@@ -0,0 +1,143 @@
+/*
+    Frame store plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include <image_image_folder_writer_16x16.h>
+#include "FrameStoreWriterPlugin.hpp"
+
+static void PluginInitializer( );
+static void PluginCleaner( );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000023, 0x00000002 };
+
+// Folder property
+static PropertyDescriptor folderProperty =
+{ XVT_String, "Folder", "folder", "Folder to write frame store files to.", PropertyFlag_PreferredEditor_FolderBrowser };
+// File Name Prefix property
+static PropertyDescriptor fileNamePrefixProperty =
+{ XVT_String, "File Name Prefix", "fileNamePrefix", "Prefix to add to frame store file names. The rest of file name is time stamp.", PropertyFlag_None };
+// Compression property
+static PropertyDescriptor compressionProperty =
+{ XVT_U1, "Compression", "compression", "Lossless compression to apply to frames.", PropertyFlag_SelectionByIndex };
+// Segment Size property
+static PropertyDescriptor segmentSizeProperty =
+{ XVT_U2, "Segment Size", "segmentSize", "Maximum size (MB) of a single segment file.", PropertyFlag_None };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &folderProperty, &fileNamePrefixProperty, &compressionProperty, &segmentSizeProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** FrameStoreWriterPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS
+(
+    PluginID,
+    PluginFamilyID_VideoProcessing,
+
+    PluginType_VideoProcessing,
+    PluginVersion,
+    "Frame Store Writer",
+    "FrameStoreWriter",
+    "Plug-in to record raw video frames into frame store.",
+
+    /* Long description */
+    "The plug-in records every video frame it gets together with its time stamp into a frame store - an index file "
+    "(*.cvsfi) and a set of segment files (*.cvsfs) with frames' data. Unlike video files, frames are kept without any "
+    "lossy compression, so recorded video can be played back by the <a href='{AF000003-00000000-00000023-00000001}'>Frame "
+    "Store Video</a> plug-in providing exactly the same images. Frames can be optionally compressed with LZ4, which is "
+    "fast enough for recording high frame rate video, but may not reduce size much for noisy images.<br><br>"
+
+    "Recording starts with the first frame received and a new frame store is created every time video processing "
+    "is restarted or the plug-in's properties are changed. Segment files are limited by the <b>Segment Size</b> "
+    "property, so those could be memory mapped during play back."
+    ,
+    &image_image_folder_writer_16x16,
+    nullptr,
+    FrameStoreWriterPlugin,
+
+    XARRAY_SIZE( pluginProperties ),
+    pluginProperties,
+    PluginInitializer,
+    PluginCleaner,
+    nullptr,
+    0,
+    nullptr,
+    PluginFlag_NotSplittable
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    // File Name Prefix property
+    fileNamePrefixProperty.DefaultValue.type = XVT_String;
+    fileNamePrefixProperty.DefaultValue.value.strVal = XStringAlloc( "frames" );
+
+    // Compression property
+    compressionProperty.DefaultValue.type = XVT_U1;
+    compressionProperty.DefaultValue.value.ubVal = 0;
+
+    compressionProperty.MinValue.type = XVT_U1;
+    compressionProperty.MinValue.value.ubVal = 0;
+
+    compressionProperty.MaxValue.type = XVT_U1;
+    compressionProperty.MaxValue.value.ubVal = 1;
+
+    compressionProperty.ChoicesCount = 2;
+    compressionProperty.Choices = new xvariant[2];
+
+    compressionProperty.Choices[0].type = XVT_String;
+    compressionProperty.Choices[0].value.strVal = XStringAlloc( "None" );
+
+    compressionProperty.Choices[1].type = XVT_String;
+    compressionProperty.Choices[1].value.strVal = XStringAlloc( "LZ4" );
+
+    // Segment Size property
+    segmentSizeProperty.DefaultValue.type = XVT_U2;
+    segmentSizeProperty.DefaultValue.value.usVal = 1024;
+
+    segmentSizeProperty.MinValue.type = XVT_U2;
+    segmentSizeProperty.MinValue.value.usVal = 16;
+
+    segmentSizeProperty.MaxValue.type = XVT_U2;
+    segmentSizeProperty.MaxValue.value.usVal = 4096;
+}
+
+// Clean-up plug-in - deallocate strings
+static void PluginCleaner( )
+{
+    XVariantClear( &fileNamePrefixProperty.DefaultValue );
+
+    for ( int i = 0; i < compressionProperty.ChoicesCount; i++ )
+    {
+        XVariantClear( &compressionProperty.Choices[i] );
+    }
+
+    delete[] compressionProperty.Choices;
+}
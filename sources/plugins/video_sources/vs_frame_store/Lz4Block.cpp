@@ -0,0 +1,389 @@
+/*
+    Frame store plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "Lz4Block.hpp"
+#include <string.h>
+
+using namespace std;
+
+namespace Private
+{
+    static const uint32_t MIN_MATCH     = 4;
+    static const uint32_t LAST_LITERALS = 5;        // last bytes of a block are always literals
+    static const uint32_t MF_LIMIT      = 12;       // last match must start this far from the end
+    static const uint32_t MAX_DISTANCE  = 65535;
+    static const uint32_t HASH_LOG      = 16;
+    static const uint32_t SKIP_TRIGGER  = 6;        // speed up search in data which does not compress
+    static const uint32_t WILD_COPY     = 16;       // size of fixed copies used by decompression
+
+    static inline uint32_t Read32( const uint8_t* ptr )
+    {
+        uint32_t value;
+        memcpy( &value, ptr, sizeof( value ) );
+        return value;
+    }
+
+    static inline uint32_t Hash( const uint8_t* ptr )
+    {
+        return ( Read32( ptr ) * 2654435761U ) >> ( 32 - HASH_LOG );
+    }
+
+    // Count number of matching bytes, but not beyond the specified limit
+    static inline uint32_t CountMatch( const uint8_t* ptr, const uint8_t* ref, const uint8_t* limit )
+    {
+        const uint8_t* start = ptr;
+
+        while ( ( ptr + sizeof( uint64_t ) <= limit ) )
+        {
+            uint64_t a, b;
+
+            memcpy( &a, ptr, sizeof( a ) );
+            memcpy( &b, ref, sizeof( b ) );
+
+            if ( a != b )
+            {
+                break;
+            }
+
+            ptr += sizeof( uint64_t );
+            ref += sizeof( uint64_t );
+        }
+
+        while ( ( ptr < limit ) && ( *ptr == *ref ) )
+        {
+            ptr++;
+            ref++;
+        }
+
+        return static_cast<uint32_t>( ptr - start );
+    }
+
+    // Write length, which did not fit into 4 bits of the token
+    static inline uint8_t* WriteLength( uint8_t* op, uint32_t length )
+    {
+        while ( length >= 255 )
+        {
+            *op++   = 255;
+            length -= 255;
+        }
+        *op++ = static_cast<uint8_t>( length );
+
+        return op;
+    }
+
+    // Read length, which did not fit into 4 bits of the token
+    static inline bool ReadLength( const uint8_t** ip, const uint8_t* iend, uint32_t* length )
+    {
+        uint32_t s;
+
+        do
+        {
+            if ( *ip >= iend )
+            {
+                return false;
+            }
+
+            s        = *( *ip )++;
+            *length += s;
+        }
+        while ( s == 255 );
+
+        return true;
+    }
+}
+
+Lz4Block::Lz4Block( ) :
+    mHashTable( 1 << ::Private::HASH_LOG )
+{
+}
+
+// Get the worst case size of compressed data for the specified input size
+uint32_t Lz4Block::CompressBound( uint32_t srcSize )
+{
+    return srcSize + srcSize / 255 + 16;
+}
+
+// Compress the specified data
+uint32_t Lz4Block::Compress( const uint8_t* src, uint32_t srcSize, uint8_t* dst, uint32_t dstCapacity )
+{
+    using namespace ::Private;
+
+    // empty input is a single token with no literals, source pointer may not be valid then
+    if ( srcSize == 0 )
+    {
+        if ( dstCapacity == 0 )
+        {
+            return 0;
+        }
+
+        *dst = 0;
+        return 1;
+    }
+
+    const uint8_t* ip      = src;
+    const uint8_t* anchor  = src;
+    const uint8_t* iend    = src + srcSize;
+    const uint8_t* mflimit = iend - MF_LIMIT;
+    const uint8_t* mlimit  = iend - LAST_LITERALS;
+    uint8_t*       op      = dst;
+    uint8_t*       oend    = dst + dstCapacity;
+    uint32_t*      table   = &mHashTable[0];
+
+    if ( srcSize > MF_LIMIT )
+    {
+        memset( table, 0, mHashTable.size( ) * sizeof( uint32_t ) );
+
+        table[Hash( ip )] = 0;
+        ip++;
+
+        for ( ; ; )
+        {
+            const uint8_t* ref;
+            uint32_t       attempts = 1 << SKIP_TRIGGER;
+            uint32_t       step     = 1;
+
+            // find a match
+            for ( ; ; )
+            {
+                if ( ip > mflimit )
+                {
+                    goto lastLiterals;
+                }
+
+                uint32_t h = Hash( ip );
+
+                ref      = src + table[h];
+                table[h] = static_cast<uint32_t>( ip - src );
+
+                if ( ( ref < ip ) && ( static_cast<uint32_t>( ip - ref ) <= MAX_DISTANCE ) && ( Read32( ref ) == Read32( ip ) ) )
+                {
+                    break;
+                }
+
+                ip  += step;
+                step = attempts++ >> SKIP_TRIGGER;
+            }
+
+            // extend the match backwards
+            while ( ( ip > anchor ) && ( ref > src ) && ( ip[-1] == ref[-1] ) )
+            {
+                ip--;
+                ref--;
+            }
+
+            uint32_t literalsLength = static_cast<uint32_t>( ip - anchor );
+            uint32_t matchLength    = CountMatch( ip + MIN_MATCH, ref + MIN_MATCH, mlimit );
+
+            // token + literals + offset + lengths
+            if ( op + 1 + literalsLength + literalsLength / 255 + 2 + matchLength / 255 + 2 > oend )
+            {
+                return 0;
+            }
+
+            uint8_t* token = op++;
+
+            if ( literalsLength >= 15 )
+            {
+                *token = 15 << 4;
+                op     = WriteLength( op, literalsLength - 15 );
+            }
+            else
+            {
+                *token = static_cast<uint8_t>( literalsLength << 4 );
+            }
+
+            memcpy( op, anchor, literalsLength );
+            op += literalsLength;
+
+            uint32_t offset = static_cast<uint32_t>( ip - ref );
+
+            *op++ = static_cast<uint8_t>( offset );
+            *op++ = static_cast<uint8_t>( offset >> 8 );
+
+            if ( matchLength >= 15 )
+            {
+                *token |= 15;
+                op      = WriteLength( op, matchLength - 15 );
+            }
+            else
+            {
+                *token |= static_cast<uint8_t>( matchLength );
+            }
+
+            ip    += MIN_MATCH + matchLength;
+            anchor = ip;
+
+            if ( ip > mflimit )
+            {
+                break;
+            }
+
+            // fill table with a position from the match, so next matches are found easier
+            table[Hash( ip - 2 )] = static_cast<uint32_t>( ip - 2 - src );
+        }
+    }
+
+lastLiterals:
+    {
+        uint32_t literalsLength = static_cast<uint32_t>( iend - anchor );
+
+        if ( op + 1 + literalsLength + literalsLength / 255 + 1 > oend )
+        {
+            return 0;
+        }
+
+        if ( literalsLength >= 15 )
+        {
+            *op++ = 15 << 4;
+            op    = WriteLength( op, literalsLength - 15 );
+        }
+        else
+        {
+            *op++ = static_cast<uint8_t>( literalsLength << 4 );
+        }
+
+        memcpy( op, anchor, literalsLength );
+        op += literalsLength;
+    }
+
+    return static_cast<uint32_t>( op - dst );
+}
+
+// Decompress the specified data
+bool Lz4Block::Decompress( const uint8_t* src, uint32_t srcSize, uint8_t* dst, uint32_t dstSize )
+{
+    using namespace ::Private;
+
+    // empty output is valid only for no input or a single token with no literals (pointers may not be valid then)
+    if ( ( srcSize == 0 ) || ( dstSize == 0 ) )
+    {
+        return ( dstSize == 0 ) && ( ( srcSize == 0 ) || ( ( srcSize == 1 ) && ( src[0] == 0 ) ) );
+    }
+
+    const uint8_t* ip   = src;
+    const uint8_t* iend = src + srcSize;
+    uint8_t*       op   = dst;
+    uint8_t*       oend = dst + dstSize;
+
+    while ( ip < iend )
+    {
+        uint32_t token          = *ip++;
+        uint32_t literalsLength = token >> 4;
+
+        if ( ( literalsLength == 15 ) && ( !ReadLength( &ip, iend, &literalsLength ) ) )
+        {
+            return false;
+        }
+
+        if ( ( literalsLength > static_cast<uint32_t>( iend - ip ) ) || ( literalsLength > static_cast<uint32_t>( oend - op ) ) )
+        {
+            return false;
+        }
+
+        // short literals are copied with a fixed size copy, if there is enough room left
+        if ( ( literalsLength <= WILD_COPY ) && ( iend - ip >= static_cast<int>( WILD_COPY ) ) && ( oend - op >= static_cast<int>( WILD_COPY ) ) )
+        {
+            memcpy( op, ip, WILD_COPY );
+        }
+        else
+        {
+            memcpy( op, ip, literalsLength );
+        }
+        op += literalsLength;
+        ip += literalsLength;
+
+        // the last sequence has literals only
+        if ( ip == iend )
+        {
+            break;
+        }
+
+        if ( iend - ip < 2 )
+        {
+            return false;
+        }
+
+        uint32_t offset      = ip[0] | ( ip[1] << 8 );
+        uint32_t matchLength = token & 15;
+
+        ip += 2;
+
+        if ( ( offset == 0 ) || ( offset > static_cast<uint32_t>( op - dst ) ) )
+        {
+            return false;
+        }
+
+        if ( ( matchLength == 15 ) && ( !ReadLength( &ip, iend, &matchLength ) ) )
+        {
+            return false;
+        }
+
+        matchLength += MIN_MATCH;
+
+        if ( matchLength > static_cast<uint32_t>( oend - op ) )
+        {
+            return false;
+        }
+
+        const uint8_t* match = op - offset;
+
+        if ( ( offset >= WILD_COPY ) && ( static_cast<uint32_t>( oend - op ) >= matchLength + WILD_COPY ) )
+        {
+            // copy in fixed size chunks, which never overlap, but may write a bit beyond the match
+            uint8_t* matchEnd = op + matchLength;
+
+            do
+            {
+                memcpy( op, match, WILD_COPY );
+                op    += WILD_COPY;
+                match += WILD_COPY;
+            }
+            while ( op < matchEnd );
+
+            op = matchEnd;
+        }
+        else if ( matchLength <= WILD_COPY * 2 )
+        {
+            // short overlapping match - simply copy it byte by byte
+            uint8_t* matchEnd = op + matchLength;
+
+            while ( op < matchEnd )
+            {
+                *op++ = *match++;
+            }
+        }
+        else
+        {
+            // long matches may overlap with the data they produce (repeating pattern), in which
+            // case the pattern is copied in chunks doubling in size
+            while ( matchLength != 0 )
+            {
+                uint32_t chunk = XMIN( static_cast<uint32_t>( op - match ), matchLength );
+
+                memcpy( op, match, chunk );
+                op          += chunk;
+                matchLength -= chunk;
+            }
+        }
+    }
+
+    return ( op == oend );
+}
@@ -0,0 +1,49 @@
+/*
+    Frame store plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_LZ4_BLOCK_HPP
+#define CVS_LZ4_BLOCK_HPP
+
+#include <stdint.h>
+#include <vector>
+#include <XInterfaces.hpp>
+
+// Compressor/decompressor of LZ4 block format. Only the fast greedy compression is
+// implemented, which is all we need to keep up with video frames coming at sensor rate.
+class Lz4Block : private CVSandbox::Uncopyable
+{
+public:
+    Lz4Block( );
+
+    // Get the worst case size of compressed data for the specified input size
+    static uint32_t CompressBound( uint32_t srcSize );
+
+    // Compress the specified data. Returns size of compressed data or 0 if it does not fit into destination buffer.
+    uint32_t Compress( const uint8_t* src, uint32_t srcSize, uint8_t* dst, uint32_t dstCapacity );
+    // Decompress the specified data, which must produce exactly dstSize bytes
+    static bool Decompress( const uint8_t* src, uint32_t srcSize, uint8_t* dst, uint32_t dstSize );
+
+private:
+    std::vector<uint32_t> mHashTable;
+};
+
+#endif // CVS_LZ4_BLOCK_HPP
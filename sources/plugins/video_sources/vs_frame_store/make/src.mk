@@ -0,0 +1,18 @@
+# vs_frame_store plug-in source files
+
+# search path for source files
+VPATH = ../../
+
+# source files
+SRC = vs_frame_store.cpp \
+	FrameStoreVideoPlugin.cpp FrameStoreVideoPluginDescriptor.cpp \
+	FrameStoreWriterPlugin.cpp FrameStoreWriterPluginDescriptor.cpp \
+	FrameStore.cpp Lz4Block.cpp
+
+# additional include folders
+INCLUDES = -I../../../../../afx/afx_types -I../../../../../afx/afx_types+ \
+	-I../../../../../afx/afx_platform+ \
+	-I../../../../../core/iplugin -I../../../../../images
+
+# libraries to use
+LIBS =  -liplugin -lafx_platform+ -lafx_types+ -lafx_types
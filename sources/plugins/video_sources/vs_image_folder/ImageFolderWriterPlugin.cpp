@@ -41,10 +41,14 @@ namespace Private
     public:
         ImageFolderWriterPluginData( ) :
             FolderToWrite( ), FileNamePrefix( ), BaseFullFileName( ),
-            FrameInterval( 1000 ), Codec( 0 ), Quality( 90 ),
+            FrameInterval( 1000 ), Codec( 0 ), Quality( 90 ), PngOptions( ),
             FirstWrite( true ), LastWrite( ),
             LastWriteSeconds( 0 ), CounterValue( 0 )
         {
+            PngOptions.compressionLevel = 6;
+            PngOptions.strategy         = PngStrategy_Default;
+            PngOptions.filter           = PngFilter_Adaptive;
+            PngOptions.stripsCount      = 1;
         }
 
         void UpdateBaseFullFileName( );
@@ -57,6 +61,7 @@ namespace Private
         uint16_t    FrameInterval;
         uint8_t     Codec;
         uint8_t     Quality;
+        xpngoptions PngOptions;
 
         bool                        FirstWrite;
         steady_clock::time_point    LastWrite;
@@ -118,6 +123,26 @@ XErrorCode ImageFolderWriterPlugin::GetProperty( int32_t id, xvariant* value ) c
         value->value.ubVal = mData->Quality;
         break;
 
+    case 5:
+        value->type        = XVT_U1;
+        value->value.ubVal = (uint8_t) mData->PngOptions.compressionLevel;
+        break;
+
+    case 6:
+        value->type        = XVT_U1;
+        value->value.ubVal = mData->PngOptions.strategy;
+        break;
+
+    case 7:
+        value->type        = XVT_U1;
+        value->value.ubVal = mData->PngOptions.filter;
+        break;
+
+    case 8:
+        value->type          = XVT_Bool;
+        value->value.boolVal = ( mData->PngOptions.stripsCount != 1 );
+        break;
+
     default:
         ret = ErrorInvalidProperty;
     }
@@ -134,7 +159,7 @@ XErrorCode ImageFolderWriterPlugin::SetProperty( int32_t id, const xvariant* val
     XVariantInit( &convertedValue );
 
     // make sure property value has expected type
-    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 5, &convertedValue );
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 9, &convertedValue );
 
     if ( ret == SuccessCode )
     {
@@ -162,6 +187,22 @@ XErrorCode ImageFolderWriterPlugin::SetProperty( int32_t id, const xvariant* val
             mData->Quality = convertedValue.value.ubVal;
             break;
 
+        case 5:
+            mData->PngOptions.compressionLevel = (int8_t) convertedValue.value.ubVal;
+            break;
+
+        case 6:
+            mData->PngOptions.strategy = convertedValue.value.ubVal;
+            break;
+
+        case 7:
+            mData->PngOptions.filter = convertedValue.value.ubVal;
+            break;
+
+        case 8:
+            mData->PngOptions.stripsCount = ( convertedValue.value.boolVal ) ? XPNG_STRIPS_AUTO : 1;
+            break;
+
         default:
             ret = ErrorInvalidProperty;
             break;
@@ -241,7 +282,7 @@ XErrorCode ImageFolderWriterPlugin::ProcessImage( ximage* src )
             {
             case 1:
                 fileName += ".png";
-                ret = XEncodePng( fileName.c_str( ), src );
+                ret = XEncodePng( fileName.c_str( ), src, &mData->PngOptions );
                 break;
 
             default:
@@ -26,9 +26,10 @@
 static void PluginInitializer( );
 static void PluginCleaner( );
 static XErrorCode UpdateQualityProperties( PropertyDescriptor* desc, const xvariant* parentValue );
+static XErrorCode UpdatePngProperties( PropertyDescriptor* desc, const xvariant* parentValue );
 
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 1 };
+static xversion PluginVersion = { 1, 0, 2 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000013, 0x00000001 };
@@ -48,20 +49,33 @@ static PropertyDescriptor imageTypeProperty =
 // Quality property
 static PropertyDescriptor qualityProperty =
 { XVT_U1, "Quality", "quality", "Image compression quality (JPEG only).", PropertyFlag_Dependent };
+// PNG Compression Level property
+static PropertyDescriptor pngCompressionLevelProperty =
+{ XVT_U1, "PNG Compression Level", "pngCompressionLevel", "Compression level of PNG images: 0 - no compression, 9 - best (slowest) compression.", PropertyFlag_Dependent };
+// PNG Compression Strategy property
+static PropertyDescriptor pngCompressionStrategyProperty =
+{ XVT_U1, "PNG Compression Strategy", "pngCompressionStrategy", "Compression strategy of PNG images. Huffman only and RLE strategies are much faster, but compress worse.", PropertyFlag_Dependent | PropertyFlag_SelectionByIndex };
+// PNG Row Filter property
+static PropertyDescriptor pngRowFilterProperty =
+{ XVT_U1, "PNG Row Filter", "pngRowFilter", "Filter applied to rows of PNG images before compression.", PropertyFlag_Dependent | PropertyFlag_SelectionByIndex };
+// PNG Parallel Compression property
+static PropertyDescriptor pngParallelCompressionProperty =
+{ XVT_Bool, "PNG Parallel Compression", "pngParallelCompression", "Split PNG images into strips, which are compressed in parallel.", PropertyFlag_Dependent };
 
 
 // Array of available properties
 static PropertyDescriptor* pluginProperties[] =
 {
     &folderProperty, &fileNamePrefixProperty, &frameIntervalProperty,
-    &imageTypeProperty, &qualityProperty
+    &imageTypeProperty, &qualityProperty, &pngCompressionLevelProperty,
+    &pngCompressionStrategyProperty, &pngRowFilterProperty, &pngParallelCompressionProperty
 };
 
 // Let the class itself know description of its properties
 const PropertyDescriptor** ImageFolderWriterPlugin::propertiesDescription = (const PropertyDescriptor**) pluginProperties;
 
 // Register the plug-in
-REGISTER_CPP_PLUGIN_WITH_PROPS
+REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS
 (
     PluginID,
     PluginFamilyID_VideoProcessing,
@@ -77,7 +91,10 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     "interval is set to zero (or is less than the time interval between frames provided by a video source), then every "
     "frame is written as an image. However, if the set time interval is higher, then the plug-in can be used to create "
     "time lapse image slide-show. Using <a href='{AF000003-00000000-00000005-00000003}'>Image Folder Video Source</a> plug-in "
-    "with a video writing plug-in, it is possible to make a time lapse video afterwards."
+    "with a video writing plug-in, it is possible to make a time lapse video afterwards.<br><br>"
+    "When writing PNG images of big size at high frame rate, compression may become the bottleneck. In this case "
+    "it is worth lowering PNG compression level, choosing faster compression strategy (like RLE or Huffman only) "
+    "or enabling parallel compression, which compresses strips of an image on multiple threads."
     ,
     &image_image_folder_writer_16x16,
     nullptr,
@@ -87,7 +104,10 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     pluginProperties,
     PluginInitializer,
     PluginCleaner,
-    nullptr
+    nullptr,
+    0,
+    nullptr,
+    PluginFlag_NotSplittable
 );
 
 // Complete properties description by initializing those parts, which were not
@@ -135,6 +155,40 @@ static void PluginInitializer( )
 
     qualityProperty.ParentProperty = 3;
     qualityProperty.Updater = UpdateQualityProperties;
+
+    // PNG Compression Level property
+    pngCompressionLevelProperty.DefaultValue.type = XVT_U1;
+    pngCompressionLevelProperty.DefaultValue.value.ubVal = 6;
+
+    pngCompressionLevelProperty.MinValue.type = XVT_U1;
+    pngCompressionLevelProperty.MinValue.value.ubVal = 0;
+
+    pngCompressionLevelProperty.MaxValue.type = XVT_U1;
+    pngCompressionLevelProperty.MaxValue.value.ubVal = 9;
+
+    // PNG Compression Strategy property
+    static const char* pngStrategies[] = { "Default", "Filtered", "Huffman only", "RLE", "Fixed" };
+
+    InitSelectionProperty( &pngCompressionStrategyProperty, pngStrategies, XARRAY_SIZE( pngStrategies ), 0 );
+
+    // PNG Row Filter property
+    static const char* pngFilters[] = { "Adaptive", "None", "Sub", "Up", "Average", "Paeth" };
+
+    InitSelectionProperty( &pngRowFilterProperty, pngFilters, XARRAY_SIZE( pngFilters ), 0 );
+
+    // PNG Parallel Compression property
+    pngParallelCompressionProperty.DefaultValue.type = XVT_Bool;
+    pngParallelCompressionProperty.DefaultValue.value.boolVal = false;
+
+    pngCompressionLevelProperty.ParentProperty    = 3;
+    pngCompressionStrategyProperty.ParentProperty = 3;
+    pngRowFilterProperty.ParentProperty           = 3;
+    pngParallelCompressionProperty.ParentProperty = 3;
+
+    pngCompressionLevelProperty.Updater    = UpdatePngProperties;
+    pngCompressionStrategyProperty.Updater = UpdatePngProperties;
+    pngRowFilterProperty.Updater           = UpdatePngProperties;
+    pngParallelCompressionProperty.Updater = UpdatePngProperties;
 }
 
 // Clean-up plug-in - deallocate strings
@@ -146,6 +200,9 @@ static void PluginCleaner( )
     }
 
     delete[] imageTypeProperty.Choices;
+
+    CleanSelectionProperty( &pngCompressionStrategyProperty );
+    CleanSelectionProperty( &pngRowFilterProperty );
 }
 
 static XErrorCode UpdateQualityProperties( PropertyDescriptor* desc, const xvariant* parentValue )
@@ -169,3 +226,25 @@ static XErrorCode UpdateQualityProperties( PropertyDescriptor* desc, const xvari
 
     return ret;
 }
+
+static XErrorCode UpdatePngProperties( PropertyDescriptor* desc, const xvariant* parentValue )
+{
+    XErrorCode ret = ErrorFailed;
+    uint8_t    codec;
+
+    ret = XVariantToUByte( parentValue, &codec );
+
+    if ( ret == SuccessCode )
+    {
+        if ( codec == 1 )
+        {
+            desc->Flags &= ( ~PropertyFlag_Disabled );
+        }
+        else
+        {
+            desc->Flags |= PropertyFlag_Disabled;
+        }
+    }
+
+    return ret;
+}
@@ -17,4 +17,4 @@ INCLUDES = -I../../../../../afx/afx_types -I../../../../../afx/afx_types+ \
 
 # libraries to use
 LIBS = -liplugin -lafx_imaging_formats -lafx_imaging \
-	-lafx_platform+ -lafx_types+ -lafx_types -ljpeg -lexif -lpng
+	-lafx_platform+ -lafx_types+ -lafx_types -ljpeg -lexif -lpng -lz
@@ -26,7 +26,7 @@
 ModuleDescriptor moduleInfo =
 {
     { 0xAF000001, 0x00000000, 0x00000000, 0x00000013 },
-    { 1, 0, 1 },
+    { 1, 0, 2 },
     "Image Folder Video Sources",
     "vs_image_folder",
     "The module contains plug-ins to read/write images from/to specified folder.",
@@ -36,11 +36,12 @@ namespace Private
     public:
         JpegStreamVideoSourcePluginData( const shared_ptr<XJpegHttpStream>& device ) :
             Device( device ), JpegUrl( ), UserName( ), Password( ), ForceBasicAuthorization( false ), FrameIntervalMs( 100 ),
-            UserCallbacks( { 0 } ), UserParam( 0 )
+            ConcurrentRequests( 1 ), UserCallbacks( { 0 } ), UserParam( 0 )
         {
         }
 
         virtual void OnNewImage( const shared_ptr<const XImage>& image );
+        virtual void OnNewImage( const shared_ptr<const XImage>& image, int64_t captureTime );
         virtual void OnError( const string& errorMessage );
 
     public:
@@ -50,6 +51,7 @@ namespace Private
         string                      Password;
         bool                        ForceBasicAuthorization;
         uint16_t                    FrameIntervalMs;
+        uint16_t                    ConcurrentRequests;
 
         VideoSourcePluginCallbacks  UserCallbacks;
         void*                       UserParam;
@@ -103,6 +105,11 @@ XErrorCode JpegStreamVideoSourcePlugin::GetProperty( int32_t id, xvariant* value
         value->value.boolVal = mData->ForceBasicAuthorization;
         break;
 
+    case 5:
+        value->type        = XVT_U2;
+        value->value.usVal = mData->ConcurrentRequests;
+        break;
+
     default:
         ret = ErrorInvalidProperty;
     }
@@ -190,6 +197,19 @@ XErrorCode JpegStreamVideoSourcePlugin::SetProperty( int32_t id, const xvariant*
             ret = ErrorCannotSetPropertyWhileRunning;
         }
     }
+    else if ( id == 5 )
+    {
+        uint16_t concurrentRequests = XINRANGE( xvar.ToUShort( ), 1, 16 );
+
+        if ( mData->Device->SetConcurrentRequests( concurrentRequests ) )
+        {
+            mData->ConcurrentRequests = concurrentRequests;
+        }
+        else
+        {
+            ret = ErrorCannotSetPropertyWhileRunning;
+        }
+    }
     else
     {
         ret = ErrorInvalidProperty;
@@ -267,6 +287,22 @@ void JpegStreamVideoSourcePluginData::OnNewImage( const std::shared_ptr<const XI
     }
 }
 
+// Handle new image arrived from the video source along with its capture time
+void JpegStreamVideoSourcePluginData::OnNewImage( const std::shared_ptr<const XImage>& image, int64_t captureTime )
+{
+    if ( image )
+    {
+        if ( UserCallbacks.NewImageWithTimestampCallback != 0 )
+        {
+            UserCallbacks.NewImageWithTimestampCallback( UserParam, image->ImageData( ), captureTime );
+        }
+        else if ( UserCallbacks.NewImageCallback != 0 )
+        {
+            UserCallbacks.NewImageCallback( UserParam, image->ImageData( ) );
+        }
+    }
+}
+
 // Handle error message arrived from the video source
 void JpegStreamVideoSourcePluginData::OnError( const std::string& errorMessage )
 {
@@ -26,7 +26,7 @@
 static void PluginInitializer( );
 
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 1 };
+static xversion PluginVersion = { 1, 1, 0 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000005, 0x00000001 };
@@ -46,11 +46,15 @@ static PropertyDescriptor passwordProperty =
 // Force basic authentication property
 static PropertyDescriptor forceBasicAuthenticationProperty =
 { XVT_Bool, "Force basic authentication", "forceBasicAuthentication", "Force basic authentication or negotiate it.", PropertyFlag_None };
+// Concurrent requests property
+static PropertyDescriptor concurrentRequestsProperty =
+{ XVT_U2, "Concurrent requests", "concurrentRequests", "Number of snapshot requests to keep in flight.", PropertyFlag_None };
 
 // Array of available properties
 static PropertyDescriptor* pluginProperties[] =
 {
-    &jpegUrlProperty, &frameIntervalProperty, &userNameProperty, &passwordProperty, &forceBasicAuthenticationProperty
+    &jpegUrlProperty, &frameIntervalProperty, &userNameProperty, &passwordProperty, &forceBasicAuthenticationProperty,
+    &concurrentRequestsProperty
 };
 
 // Register the plug-in
@@ -82,7 +86,13 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     "If the video source (IP camera) is configured to require authentication, then <b>User name</b> and "
     "<b>Password</b> properties must be set. Otherwise those should be left blank. <b>Note</b>: some camera "
     "models fail negotiating authentication method and so <b>basic authentication</b>must be forced "
-    "for those."
+    "for those.<br><br>"
+
+    "Cameras with long response time may not provide high frame rate, when the next snapshot is queried only "
+    "after the previous one is received. Setting number of <b>concurrent requests</b> to a value greater than 1 "
+    "makes the plug-in keep that many snapshot requests in flight over persistent connections, while decoding "
+    "received images in a separate thread. The images are still provided in the order they were requested. "
+    "New requests are not made more often than the configured frame interval."
     ,
     &image_jpeg_stream_16x16,
     nullptr,
@@ -112,4 +122,14 @@ static void PluginInitializer( )
     // Force Basic Authentication
     forceBasicAuthenticationProperty.DefaultValue.type          = XVT_Bool;
     forceBasicAuthenticationProperty.DefaultValue.value.boolVal = false;
+
+    // Concurrent Requests
+    concurrentRequestsProperty.DefaultValue.type        = XVT_U2;
+    concurrentRequestsProperty.DefaultValue.value.usVal = 1;
+
+    concurrentRequestsProperty.MinValue.type            = XVT_U2;
+    concurrentRequestsProperty.MinValue.value.usVal     = 1;
+
+    concurrentRequestsProperty.MaxValue.type            = XVT_U2;
+    concurrentRequestsProperty.MaxValue.value.usVal     = 16;
 }
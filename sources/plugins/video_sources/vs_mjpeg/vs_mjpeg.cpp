@@ -26,7 +26,7 @@
 ModuleDescriptor moduleInfo =
 {
     { 0xAF000001, 0x00000000, 0x00000000, 0x00000005 },
-    { 1, 0, 3 },
+    { 1, 0, 5 },
     "JPEG/MJPEG Video Sources",
     "vs_mjpeg",
     "The module contains plug-ins to access JPEG/MJPEG streams over HTTP protocol as well as local JPEG folders.",
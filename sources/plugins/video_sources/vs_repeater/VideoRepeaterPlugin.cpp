@@ -32,8 +32,6 @@ using namespace std;
 using namespace CVSandbox;
 using namespace CVSandbox::Threading;
 
-static const char* ERROR_MESSAGE = "Failed re-translating image - out of memory";
-
 namespace Private
 {
     // Internal class which hides private parts of the VideoRepeaterPlugin class,
@@ -41,33 +39,24 @@ namespace Private
     class VideoRepeaterPluginData
     {
     public:
-        VideoRepeaterPluginData( ) : RepeaterId( ), UserCallbacks( { 0 } ), UserParam( nullptr ),
-            PushedImage( nullptr ), NotifiedImage( nullptr )
-        {
-        }
-
-        ~VideoRepeaterPluginData( )
+        VideoRepeaterPluginData( VideoRepeaterPlugin* parent ) : Parent( parent ), RepeaterId( ),
+            UserCallbacks( { 0 } ), UserParam( nullptr ), PushedImage( )
         {
-            XImageFree( &PushedImage );
-            XImageFree( &NotifiedImage );
         }
 
         // Video thread entry point
         static void WorkerThreadHandler( void* param );
         // Notify client about new video frame
         void NewFrameNotify( const ximage* image );
-        // Notify client about error in the video source
-        void ErrorMessageNotify( const char* errorMessage );
         // Run video loop in a background worker thread
         void VideoSourceWorker( );
 
     public:
+        VideoRepeaterPlugin*        Parent;
         string                      RepeaterId;
         VideoSourcePluginCallbacks  UserCallbacks;
         void*                       UserParam;
-
-        ximage*             PushedImage;
-        ximage*             NotifiedImage;
+        shared_ptr<const XImage>    PushedImage;
 
         XMutex              Sync;
         XMutex              ImageSync;
@@ -81,7 +70,7 @@ namespace Private
 // ==========================================================================
 
 VideoRepeaterPlugin::VideoRepeaterPlugin( ) :
-    mData( new ::Private::VideoRepeaterPluginData( ) )
+    mData( new ::Private::VideoRepeaterPluginData( this ) )
 {
 }
 
@@ -154,7 +143,7 @@ void VideoRepeaterPlugin::Terminate( )
     if ( IsRunning( ) )
     {
         mData->BackgroundThread.Terminate( );
-        VideoRepeaterRegistry::Instance( )->RemoveRepeater( mData->RepeaterId );
+        VideoRepeaterRegistry::Instance( )->RemoveRepeater( mData->RepeaterId, this );
     }
 }
 
@@ -230,18 +219,12 @@ XErrorCode VideoRepeaterPlugin::SetProperty( int32_t id, const xvariant* value )
 }
 
 // Push image into the repeater causing it to re-translate as a video source
-void VideoRepeaterPlugin::PushImage( const ximage* image )
+void VideoRepeaterPlugin::PushImage( const shared_ptr<const XImage>& image )
 {
     XScopedLock lock( &mData->ImageSync );
 
-    if ( XImageClone( image, &mData->PushedImage ) != SuccessCode )
-    {
-        mData->ErrorMessageNotify( ERROR_MESSAGE );
-    }
-    else
-    {
-        mData->NewImageEvent.Signal( );
-    }
+    mData->PushedImage = image;
+    mData->NewImageEvent.Signal( );
 }
 
 namespace Private
@@ -266,20 +249,11 @@ namespace Private
         }
     }
 
-    // Notify client about error in the video source
-    void VideoRepeaterPluginData::ErrorMessageNotify( const char* errorMessage )
-    {
-        XScopedLock lock( &Sync );
-
-        if ( UserCallbacks.ErrorMessageCallback != NULL )
-        {
-            UserCallbacks.ErrorMessageCallback( UserParam, errorMessage );
-        }
-    }
-
     // Run video loop in a background thread
     void VideoRepeaterPluginData::VideoSourceWorker( )
     {
+        shared_ptr<const XImage> notifiedImage;
+
         for ( ; ; )
         {
             NewImageEvent.Wait( );
@@ -289,23 +263,27 @@ namespace Private
                 break;
             }
 
+            // take the latest pushed image - it is shared with other repeaters, so no copy is done
             {
                 XScopedLock lock( &ImageSync );
 
-                if ( XImageClone( PushedImage, &NotifiedImage ) != SuccessCode )
-                {
-                    ErrorMessageNotify( ERROR_MESSAGE );
-                }
+                notifiedImage = PushedImage;
+                PushedImage.reset( );
+                NewImageEvent.Reset( );
             }
 
-            NewImageEvent.Reset( );
-
-            if ( NotifiedImage != nullptr )
+            if ( notifiedImage )
             {
-                NewFrameNotify( NotifiedImage );
+                NewFrameNotify( notifiedImage->ImageData( ) );
+                notifiedImage.reset( );
             }
         }
 
-        VideoRepeaterRegistry::Instance( )->RemoveRepeater( RepeaterId );
+        {
+            XScopedLock lock( &ImageSync );
+            PushedImage.reset( );
+        }
+
+        VideoRepeaterRegistry::Instance( )->RemoveRepeater( RepeaterId, Parent );
     }
 }
@@ -23,7 +23,9 @@
 #ifndef CVS_VIDEO_REPEATER_PLUGIN_HPP
 #define CVS_VIDEO_REPEATER_PLUGIN_HPP
 
+#include <memory>
 #include <iplugintypescpp.hpp>
+#include <XImage.hpp>
 
 namespace Private
 {
@@ -65,8 +67,10 @@ public:
 
 public:
 
-    // Push image into the repeater causing it to re-translate as a video source
-    void PushImage( const ximage* image );
+    // Push image into the repeater causing it to re-translate as a video source. The image is not copied,
+    // but kept till it is provided to the client. If the client is still busy with a previous frame, any
+    // older image not yet provided is simply replaced - slow clients skip frames instead of queueing them.
+    void PushImage( const std::shared_ptr<const CVSandbox::XImage>& image );
 
 private:
     ::Private::VideoRepeaterPluginData* mData;
@@ -24,7 +24,7 @@
 #include <image_video_repeater_plugin_16x16.h>
 
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 0 };
+static xversion PluginVersion = { 1, 0, 1 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000010, 0x00000001 };
@@ -57,10 +57,15 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     "This plug-in is aimed to provide a video source, which is comprised from images pushed into it. On its own this "
     "plug-in does nothing - it does not generate any images. All it does is waiting until an image is pushed into "
     "it using <a href='{AF000003-00000000-00000010-00000002}'>Video Repeater Push</a> plug-in. Once an image is pushed, "
-    "the video source will generate a new frame event with a copy of the pushed image. Using the concept of video "
+    "the video source will generate a new frame event with the pushed image. Using the concept of video "
     "repeaters it is possible to re-translate an arbitrary video source into multiple repeaters, where each may have its "
     "own video processing graph.<br><br>"
 
+    "Any number of repeaters may share the same <b>Repeater ID</b>. A pushed image is copied only once and then shared "
+    "by all of them, so fanning out a video source into several repeaters does not cost extra copies. If a repeater's "
+    "client is still busy with a previous frame, the repeater skips frames instead of queueing them - it always provides "
+    "the most recent image only.<br><br>"
+
     "<b>Note:</b> in order for this plug-in to accept images from a push plug-in, both must be configured with the same "
     "<b>Repeater ID</b>.<br><br>"
 
@@ -21,7 +21,6 @@
 
 #include "VideoRepeaterPushPlugin.hpp"
 #include "VideoRepeaterRegistry.hpp"
-#include "VideoRepeaterPlugin.hpp"
 #include <XVariant.hpp>
 
 using namespace std;
@@ -128,7 +127,7 @@ XErrorCode VideoRepeaterPushPlugin::GetSupportedPixelFormats( XPixelFormat* pixe
 // Process the specified video frame
 XErrorCode VideoRepeaterPushPlugin::ProcessImage( ximage* src )
 {
-    XErrorCode ret = ErrorInvalidConfiguration;
+    XErrorCode ret;
 
     if ( src == nullptr )
     {
@@ -136,13 +135,7 @@ XErrorCode VideoRepeaterPushPlugin::ProcessImage( ximage* src )
     }
     else
     {
-        VideoRepeaterPlugin* repeater = VideoRepeaterRegistry::Instance( )->GetRepeater( mData->RepeaterId );
-
-        if ( repeater != nullptr )
-        {
-            repeater->PushImage( src );
-            ret = SuccessCode;
-        }
+        ret = VideoRepeaterRegistry::Instance( )->PushImage( mData->RepeaterId, src );
     }
 
     return ret;
@@ -24,7 +24,7 @@
 #include <image_video_repeater_push_plugin_16x16.h>
 
 // Version of the plug-in
-static xversion PluginVersion = { 1, 0, 0 };
+static xversion PluginVersion = { 1, 0, 1 };
 
 // ID of the plug-in
 static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000010, 0x00000002 };
@@ -43,7 +43,7 @@ static PropertyDescriptor* pluginProperties[] =
 const PropertyDescriptor** VideoRepeaterPushPlugin::propertiesDescription = ( const PropertyDescriptor** ) pluginProperties;
 
 // Register the plug-in
-REGISTER_CPP_PLUGIN_WITH_PROPS
+REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS
 (
     PluginID,
     PluginFamilyID_VideoProcessing,
@@ -56,7 +56,8 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
 
     "This plug-in is used to push images into <a href='{AF000003-00000000-00000010-00000001}'>Video Repeater</a> "
     "with specified <b>Repeater ID</b>. Once image is pushed into repeater, it will generate a new video frame as "
-    "any other video source would do.<br><br>"
+    "any other video source would do. If there are several repeaters with the same ID, all of them share a single "
+    "copy of the pushed image.<br><br>"
     
     "More information : <a href = 'http://www.cvsandbox.com/cvsandbox/tutorials/video_repeaters/'>Video Repeaters</a>"
     ,
@@ -68,5 +69,8 @@ REGISTER_CPP_PLUGIN_WITH_PROPS
     pluginProperties,
     0,
     0,
-0
+    0,
+    0,
+    0,
+    PluginFlag_NotSplittable
 );
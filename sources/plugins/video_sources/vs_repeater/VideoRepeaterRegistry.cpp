@@ -46,13 +46,24 @@ VideoRepeaterRegistry* VideoRepeaterRegistry::Instance( )
 void VideoRepeaterRegistry::AddRepeater( string id, VideoRepeaterPlugin* repeater )
 {
     XScopedLock lock( &mSync );
-    mRepeaters[id] = repeater;
+    mRepeaters.insert( RepeatersMap::value_type( id, repeater ) );
 }
 
-void VideoRepeaterRegistry::RemoveRepeater( string id )
+void VideoRepeaterRegistry::RemoveRepeater( string id, VideoRepeaterPlugin* repeater )
 {
     XScopedLock lock( &mSync );
-    mRepeaters.erase( id );
+
+    pair<RepeatersMap::iterator, RepeatersMap::iterator> range = mRepeaters.equal_range( id );
+
+    for ( RepeatersMap::iterator it = range.first; it != range.second; it++ )
+    {
+        if ( it->second == repeater )
+        {
+            mRepeaters.erase( it );
+            break;
+        }
+    }
+
     if ( mRepeaters.empty( ) )
     {
         mInstance = nullptr;
@@ -60,16 +71,38 @@ void VideoRepeaterRegistry::RemoveRepeater( string id )
     }
 }
 
-VideoRepeaterPlugin* VideoRepeaterRegistry::GetRepeater( string id ) const
+XErrorCode VideoRepeaterRegistry::PushImage( string id, const ximage* image )
 {
-    VideoRepeaterPlugin* ret = nullptr;
+    XErrorCode ret = ErrorInvalidConfiguration;
 
     XScopedLock lock( &mSync );
 
-    std::map<std::string, VideoRepeaterPlugin*>::const_iterator it = mRepeaters.find( id );
-    if ( it != mRepeaters.end( ) )
+    pair<RepeatersMap::iterator, RepeatersMap::iterator> range = mRepeaters.equal_range( id );
+
+    if ( range.first != range.second )
     {
-        ret = it->second;
+        ximage* imageCopy = nullptr;
+
+        // repeaters keep the image for as long as their clients need it, so
+        // it is copied only once and then just referenced by all of them
+        ret = XImageClone( image, &imageCopy );
+
+        if ( ret == SuccessCode )
+        {
+            shared_ptr<const XImage> sharedImage = XImage::Create( &imageCopy, true );
+
+            if ( !sharedImage )
+            {
+                ret = ErrorOutOfMemory;
+            }
+            else
+            {
+                for ( RepeatersMap::iterator it = range.first; it != range.second; it++ )
+                {
+                    it->second->PushImage( sharedImage );
+                }
+            }
+        }
     }
 
     return ret;
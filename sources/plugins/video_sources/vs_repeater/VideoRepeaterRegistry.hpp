@@ -25,7 +25,9 @@
 
 #include <string>
 #include <map>
+#include <memory>
 #include <XInterfaces.hpp>
+#include <XImage.hpp>
 #include <XMutex.hpp>
 
 class VideoRepeaterPlugin;
@@ -39,13 +41,18 @@ public:
     static VideoRepeaterRegistry* Instance( );
 
     void AddRepeater( std::string id, VideoRepeaterPlugin* repeater );
-    void RemoveRepeater( std::string id );
-    VideoRepeaterPlugin* GetRepeater( std::string id ) const;
+    void RemoveRepeater( std::string id, VideoRepeaterPlugin* repeater );
+
+    // Push image into all repeaters with the specified ID. The image is copied only once and then
+    // shared by all the repeaters, so fan-out to any number of repeaters does not cost extra copies.
+    XErrorCode PushImage( std::string id, const ximage* image );
 
 private:
+    typedef std::multimap<std::string, VideoRepeaterPlugin*> RepeatersMap;
+
     static VideoRepeaterRegistry*       mInstance;
     static CVSandbox::Threading::XMutex mSync;
-    std::map<std::string, VideoRepeaterPlugin*> mRepeaters;
+    RepeatersMap                        mRepeaters;
 };
 
 #endif // CVS_VIDEO_REPEATER_REGISTRY_HPP
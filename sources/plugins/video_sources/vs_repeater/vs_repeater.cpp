@@ -26,7 +26,7 @@
 ModuleDescriptor moduleInfo =
 {
     { 0xAF000001, 0x00000000, 0x00000000, 0x00000010 },
-    { 1, 0, 0 },
+    { 1, 0, 1 },
     "Video Repeater Plug-ins",
     "vs_repeater",
     "The module contains video repeater's plug-ins.",
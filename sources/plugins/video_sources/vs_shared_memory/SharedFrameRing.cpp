@@ -0,0 +1,351 @@
+/*
+    Shared memory video plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "SharedFrameRing.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory.h>
+
+using namespace std;
+using namespace CVSandbox;
+
+namespace Private
+{
+    static const uint32_t RING_MAGIC       = 0x46535643; // "CVSF"
+    static const uint32_t RING_VERSION     = 2;
+    static const uint32_t RING_HEADER_SIZE = 64;
+    static const uint32_t SLOT_HEADER_SIZE = 64;
+
+    // Header of the ring, which is at the start of the shared memory
+    struct SharedFrameRingHeader
+    {
+        uint32_t          Magic;
+        uint32_t          Version;
+        uint32_t          SlotsCount;
+        uint32_t          SlotSize;         // size of a slot including its header
+        volatile uint32_t IsClosed;         // set by writer when it closes the ring
+        volatile uint32_t FramesWritten;    // number of frames written so far
+        uint64_t          Generation;       // unique for every ring created by a writer
+    };
+
+    // Header of a ring's slot, which is followed by image data
+    struct SharedFrameSlotHeader
+    {
+        volatile uint32_t Sequence;         // odd while the slot is being written
+        uint32_t          FrameIndex;
+        int32_t           Width;
+        int32_t           Height;
+        int32_t           Stride;
+        int32_t           Format;
+        uint64_t          Timestamp;
+    };
+
+    // Get number of bytes in a line of image's pixels (zero if the format is not supported)
+    static uint32_t GetLineSize( int32_t width, XPixelFormat format )
+    {
+        uint32_t bitsPerPixel = XImageBitsPerPixel( format );
+
+        return ( ( XImageIsPixelFormatIndexed( format ) ) || ( format == XPixelFormatJPEG ) || ( width <= 0 ) ) ?
+                 0 : XImageBytesPerLine( bitsPerPixel * static_cast<uint32_t>( width ) );
+    }
+
+    // Copy lines of image's pixels, which may have different strides
+    static void CopyImageLines( const uint8_t* src, int32_t srcStride, uint8_t* dst, int32_t dstStride,
+                                uint32_t lineSize, int32_t height )
+    {
+        for ( int32_t y = 0; y < height; y++ )
+        {
+            memcpy( dst, src, lineSize );
+            src += srcStride;
+            dst += dstStride;
+        }
+    }
+}
+
+using namespace ::Private;
+
+SharedFrameRing::SharedFrameRing( ) :
+    mMemory( ), mHeader( nullptr ), mName( ), mGeneration( 0 ), mLastFrameIndex( 0 ), mIsWriter( false )
+{
+}
+
+SharedFrameRing::~SharedFrameRing( )
+{
+    Close( );
+}
+
+// Create ring with the specified number of slots, each able to keep a frame of the specified size
+bool SharedFrameRing::Create( const string& name, uint32_t slotsCount, uint32_t maxFrameSize )
+{
+    uint32_t slotSize = SLOT_HEADER_SIZE + ( ( maxFrameSize + 63 ) & ~63 );
+    bool     ret      = false;
+
+    Close( );
+
+    if ( ( slotsCount != 0 ) && ( mMemory.Create( name, RING_HEADER_SIZE + static_cast<size_t>( slotSize ) * slotsCount ) ) )
+    {
+        mHeader   = static_cast<SharedFrameRingHeader*>( mMemory.Data( ) );
+        mIsWriter = true;
+
+        // memory could be left from a previous writer, so reset all headers
+        memset( mHeader, 0, RING_HEADER_SIZE );
+
+        mHeader->Version    = RING_VERSION;
+        mHeader->SlotsCount = slotsCount;
+        mHeader->SlotSize   = slotSize;
+        mHeader->Generation = static_cast<uint64_t>( chrono::high_resolution_clock::now( ).time_since_epoch( ).count( ) );
+
+        mName       = name;
+        mGeneration = mHeader->Generation;
+
+        for ( uint32_t i = 0; i < slotsCount; i++ )
+        {
+            memset( GetSlot( i ), 0, SLOT_HEADER_SIZE );
+        }
+
+        // readers check the magic number, so it is set only when everything else is ready
+        atomic_thread_fence( memory_order_release );
+        mHeader->Magic = RING_MAGIC;
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+// Attach to an existing ring for reading frames
+bool SharedFrameRing::Open( const string& name )
+{
+    bool ret = false;
+
+    Close( );
+
+    if ( ( mMemory.Open( name ) ) && ( mMemory.Size( ) >= RING_HEADER_SIZE ) )
+    {
+        SharedFrameRingHeader* header = static_cast<SharedFrameRingHeader*>( mMemory.Data( ) );
+
+        if ( ( header->Magic == RING_MAGIC ) && ( header->Version == RING_VERSION ) && ( header->IsClosed == 0 ) &&
+             ( header->SlotsCount != 0 ) && ( header->SlotSize > SLOT_HEADER_SIZE ) &&
+             ( RING_HEADER_SIZE + static_cast<uint64_t>( header->SlotSize ) * header->SlotsCount <= mMemory.Size( ) ) )
+        {
+            atomic_thread_fence( memory_order_acquire );
+
+            mHeader         = header;
+            mName           = name;
+            mGeneration     = header->Generation;
+            mLastFrameIndex = 0;
+            ret             = true;
+        }
+    }
+
+    if ( !ret )
+    {
+        mMemory.Close( );
+    }
+
+    return ret;
+}
+
+// Close the ring
+void SharedFrameRing::Close( )
+{
+    if ( mHeader != nullptr )
+    {
+        // let readers know the ring is not going to be updated any more (the writer may be re-creating it)
+        if ( mIsWriter )
+        {
+            mHeader->IsClosed = 1;
+        }
+
+        mHeader   = nullptr;
+        mIsWriter = false;
+    }
+
+    mMemory.Close( );
+}
+
+// Check if the ring is open
+bool SharedFrameRing::IsOpen( ) const
+{
+    return ( mHeader != nullptr );
+}
+
+// Check if the ring was closed by its writer (or re-initialized by a new one)
+bool SharedFrameRing::IsClosedByWriter( ) const
+{
+    return ( ( mHeader != nullptr ) && ( ( mHeader->IsClosed != 0 ) || ( mHeader->Generation != mGeneration ) ) );
+}
+
+// Check if ring's name refers to another ring now
+bool SharedFrameRing::IsReplaced( ) const
+{
+    bool ret = false;
+
+    if ( ( mHeader != nullptr ) && ( !mIsWriter ) )
+    {
+        XSharedMemory memory;
+
+        if ( ( memory.Open( mName ) ) && ( memory.Size( ) >= RING_HEADER_SIZE ) )
+        {
+            const SharedFrameRingHeader* header = static_cast<const SharedFrameRingHeader*>( memory.Data( ) );
+
+            ret = ( ( header->Magic == RING_MAGIC ) && ( header->Generation != mGeneration ) );
+        }
+    }
+
+    return ret;
+}
+
+// Get size of memory required to keep the specified image in ring's slot
+uint32_t SharedFrameRing::GetFrameSize( const ximage* image )
+{
+    return GetLineSize( image->width, image->format ) * static_cast<uint32_t>( XMAX( image->height, 0 ) );
+}
+
+// Check if the specified image fits into ring's slot
+bool SharedFrameRing::CanHoldImage( const ximage* image ) const
+{
+    uint32_t frameSize = GetFrameSize( image );
+
+    return ( ( mHeader != nullptr ) && ( frameSize != 0 ) && ( frameSize <= mHeader->SlotSize - SLOT_HEADER_SIZE ) );
+}
+
+// Get slot keeping the frame with the specified index
+SharedFrameSlotHeader* SharedFrameRing::GetSlot( uint32_t frameIndex ) const
+{
+    return reinterpret_cast<SharedFrameSlotHeader*>( reinterpret_cast<uint8_t*>( mHeader ) + RING_HEADER_SIZE +
+           static_cast<size_t>( frameIndex % mHeader->SlotsCount ) * mHeader->SlotSize );
+}
+
+// Write image into the next slot of the ring
+XErrorCode SharedFrameRing::WriteImage( const ximage* image, uint64_t timestamp )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( image == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( mHeader == nullptr )
+    {
+        ret = ErrorNotConnected;
+    }
+    else if ( !CanHoldImage( image ) )
+    {
+        ret = ErrorImageIsTooBig;
+    }
+    else
+    {
+        uint32_t               frameIndex = mHeader->FramesWritten;
+        SharedFrameSlotHeader* slot       = GetSlot( frameIndex );
+        uint32_t               sequence   = slot->Sequence;
+        uint32_t               lineSize   = GetLineSize( image->width, image->format );
+
+        // mark the slot as being updated
+        slot->Sequence = sequence + 1;
+        atomic_thread_fence( memory_order_release );
+
+        slot->FrameIndex = frameIndex;
+        slot->Width      = image->width;
+        slot->Height     = image->height;
+        slot->Stride     = static_cast<int32_t>( lineSize );
+        slot->Format     = image->format;
+        slot->Timestamp  = timestamp;
+
+        CopyImageLines( image->data, image->stride, reinterpret_cast<uint8_t*>( slot ) + SLOT_HEADER_SIZE,
+                        static_cast<int32_t>( lineSize ), lineSize, image->height );
+
+        // mark the slot as consistent again and then publish it
+        atomic_thread_fence( memory_order_release );
+        slot->Sequence = sequence + 2;
+        atomic_thread_fence( memory_order_release );
+        mHeader->FramesWritten = frameIndex + 1;
+    }
+
+    return ret;
+}
+
+// Read the most recent image from the ring, if there is a new one since the last call
+bool SharedFrameRing::ReadImage( ximage** image, uint64_t* timestamp )
+{
+    bool ret = false;
+
+    if ( ( mHeader != nullptr ) && ( image != nullptr ) )
+    {
+        uint32_t framesWritten = mHeader->FramesWritten;
+
+        atomic_thread_fence( memory_order_acquire );
+
+        if ( framesWritten != mLastFrameIndex )
+        {
+            SharedFrameSlotHeader* slot     = GetSlot( framesWritten - 1 );
+            uint32_t               sequence = slot->Sequence;
+
+            atomic_thread_fence( memory_order_acquire );
+
+            if ( ( sequence & 1 ) == 0 )
+            {
+                // slot's header may be torn as well, so it must be validated before using it
+                uint32_t     frameIndex = slot->FrameIndex;
+                int32_t      width      = slot->Width;
+                int32_t      height     = slot->Height;
+                int32_t      stride     = slot->Stride;
+                XPixelFormat format     = static_cast<XPixelFormat>( slot->Format );
+                uint64_t     frameTime  = slot->Timestamp;
+                uint32_t     lineSize   = GetLineSize( width, format );
+
+                if ( ( frameIndex == framesWritten - 1 ) && ( lineSize != 0 ) && ( height > 0 ) &&
+                     ( stride == static_cast<int32_t>( lineSize ) ) &&
+                     ( static_cast<uint64_t>( lineSize ) * height <= mHeader->SlotSize - SLOT_HEADER_SIZE ) )
+                {
+                    if ( ( *image == nullptr ) || ( ( *image )->width != width ) || ( ( *image )->height != height ) ||
+                         ( ( *image )->format != format ) )
+                    {
+                        XImageFree( image );
+                        XImageAllocateRaw( width, height, format, image );
+                    }
+
+                    if ( *image != nullptr )
+                    {
+                        CopyImageLines( reinterpret_cast<const uint8_t*>( slot ) + SLOT_HEADER_SIZE, stride,
+                                        ( *image )->data, ( *image )->stride, lineSize, height );
+
+                        // the frame is good only if the writer did not touch the slot while it was copied
+                        atomic_thread_fence( memory_order_acquire );
+
+                        if ( slot->Sequence == sequence )
+                        {
+                            mLastFrameIndex = framesWritten;
+                            ret             = true;
+
+                            if ( timestamp != nullptr )
+                            {
+                                *timestamp = frameTime;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return ret;
+}
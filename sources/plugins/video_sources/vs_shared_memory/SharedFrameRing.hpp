@@ -0,0 +1,85 @@
+/*
+    Shared memory video plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+#ifndef CVS_SHARED_FRAME_RING_HPP
+#define CVS_SHARED_FRAME_RING_HPP
+
+#include <string>
+#include <ximage.h>
+#include <XInterfaces.hpp>
+#include <XSharedMemory.hpp>
+
+namespace Private
+{
+    struct SharedFrameRingHeader;
+    struct SharedFrameSlotHeader;
+}
+
+// Ring of video frames kept in named shared memory, which is written by one process and read by any
+// number of other processes. Each slot of the ring is protected by a sequence lock - a writer makes
+// slot's sequence number odd while updating it, so readers can detect if they got a torn frame and
+// re-read it. Writer never waits for readers, while readers always pick the most recent frame.
+class SharedFrameRing : private CVSandbox::Uncopyable
+{
+public:
+    SharedFrameRing( );
+    ~SharedFrameRing( );
+
+    // Create ring with the specified number of slots, each able to keep a frame of the specified size
+    bool Create( const std::string& name, uint32_t slotsCount, uint32_t maxFrameSize );
+    // Attach to an existing ring for reading frames
+    bool Open( const std::string& name );
+    // Close the ring (if the ring was created, readers are notified they need to re-open it)
+    void Close( );
+
+    // Check if the ring is open
+    bool IsOpen( ) const;
+    // Check if the ring was closed by its writer (or re-initialized by a new one)
+    bool IsClosedByWriter( ) const;
+    // Check if ring's name refers to another ring now, which happens when a new writer re-creates the ring
+    // after the previous writer has crashed without closing it
+    bool IsReplaced( ) const;
+    // Check if the specified image fits into ring's slot
+    bool CanHoldImage( const ximage* image ) const;
+
+    // Get size of memory required to keep the specified image in ring's slot
+    static uint32_t GetFrameSize( const ximage* image );
+
+    // Write image into the next slot of the ring
+    XErrorCode WriteImage( const ximage* image, uint64_t timestamp );
+    // Read the most recent image from the ring, if there is a new one since the last call. The
+    // image is re-allocated only if it does not match the size/format of the frame in the ring.
+    // Returns false if there is no new frame (or it was being written while reading).
+    bool ReadImage( ximage** image, uint64_t* timestamp );
+
+private:
+    CVSandbox::XSharedMemory               mMemory;
+    ::Private::SharedFrameRingHeader*      mHeader;
+    std::string                            mName;
+    uint64_t                               mGeneration;
+    uint32_t                               mLastFrameIndex;
+    bool                                   mIsWriter;
+
+    ::Private::SharedFrameSlotHeader* GetSlot( uint32_t frameIndex ) const;
+};
+
+#endif // CVS_SHARED_FRAME_RING_HPP
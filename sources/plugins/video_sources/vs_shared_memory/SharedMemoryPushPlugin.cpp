@@ -0,0 +1,181 @@
+/*
+    Shared memory video plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "SharedMemoryPushPlugin.hpp"
+#include "SharedFrameRing.hpp"
+#include <string>
+#include <XTimer.hpp>
+
+using namespace std;
+using namespace CVSandbox;
+
+// List of supported pixel formats
+const XPixelFormat SharedMemoryPushPlugin::supportedPixelFormats[] =
+{
+    XPixelFormatGrayscale8, XPixelFormatRGB24, XPixelFormatRGBA32
+};
+
+namespace Private
+{
+    // Internals of shared memory push plug-in
+    class SharedMemoryPushPluginData : private Uncopyable
+    {
+    public:
+        SharedMemoryPushPluginData( ) :
+            Name( "cvsandbox_video" ), SlotsCount( 4 ), Ring( )
+        {
+        }
+
+    public:
+        string          Name;
+        uint32_t        SlotsCount;
+        SharedFrameRing Ring;
+    };
+}
+
+SharedMemoryPushPlugin::SharedMemoryPushPlugin( ) :
+    mData( new ::Private::SharedMemoryPushPluginData( ) )
+{
+}
+
+SharedMemoryPushPlugin::~SharedMemoryPushPlugin( )
+{
+    delete mData;
+}
+
+void SharedMemoryPushPlugin::Dispose( )
+{
+    Reset( );
+    delete this;
+}
+
+// Get specified property value of the plug-in
+XErrorCode SharedMemoryPushPlugin::GetProperty( int32_t id, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    switch ( id )
+    {
+    case 0:
+        value->type         = XVT_String;
+        value->value.strVal = XStringAlloc( mData->Name.c_str( ) );
+        break;
+
+    case 1:
+        value->type         = XVT_U4;
+        value->value.uiVal  = mData->SlotsCount;
+        break;
+
+    default:
+        ret = ErrorInvalidProperty;
+        break;
+    }
+
+    return ret;
+}
+
+// Set specified property value of the plug-in
+XErrorCode SharedMemoryPushPlugin::SetProperty( int32_t id, const xvariant* value )
+{
+    XErrorCode ret = SuccessCode;
+    xvariant   convertedValue;
+
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 2, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            mData->Name = string( convertedValue.value.strVal );
+            break;
+
+        case 1:
+            mData->SlotsCount = convertedValue.value.uiVal;
+            break;
+
+        default:
+            ret = ErrorInvalidProperty;
+            break;
+        }
+
+        // shared memory will be re-created with new configuration on next frame
+        mData->Ring.Close( );
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
+}
+
+// Check if the plug-in does changes to input video frames or not
+bool SharedMemoryPushPlugin::IsReadOnlyMode( )
+{
+    return true;
+}
+
+// Get pixel formats supported by the video processing plug-in
+XErrorCode SharedMemoryPushPlugin::GetSupportedPixelFormats( XPixelFormat* pixelFormats, int32_t* count )
+{
+    return GetSupportedPixelFormatsImpl( supportedPixelFormats, XARRAY_SIZE( supportedPixelFormats ), pixelFormats, count );
+}
+
+// Process the specified video frame
+XErrorCode SharedMemoryPushPlugin::ProcessImage( ximage* src )
+{
+    XErrorCode ret = SuccessCode;
+
+    if ( src == nullptr )
+    {
+        ret = ErrorNullParameter;
+    }
+    else if ( mData->Name.empty( ) )
+    {
+        ret = ErrorInvalidConfiguration;
+    }
+    else
+    {
+        // create the ring on first frame or re-create it if a bigger frame arrived, which does not fit
+        if ( !mData->Ring.CanHoldImage( src ) )
+        {
+            if ( !mData->Ring.Create( mData->Name, mData->SlotsCount, SharedFrameRing::GetFrameSize( src ) ) )
+            {
+                ret = ErrorFailed;
+            }
+        }
+
+        if ( ret == SuccessCode )
+        {
+            ret = mData->Ring.WriteImage( src, XTimer::GetTickCount( ) );
+        }
+    }
+
+    return ret;
+}
+
+// Reset run time state of the video processing plug-in
+void SharedMemoryPushPlugin::Reset( )
+{
+    mData->Ring.Close( );
+}
@@ -0,0 +1,107 @@
+/*
+    Shared memory video plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include "SharedMemoryPushPlugin.hpp"
+#include <image_video_repeater_push_plugin_16x16.h>
+
+static void PluginInitializer( );
+static void PluginCleaner( );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000021, 0x00000002 };
+
+// Name property
+static PropertyDescriptor nameProperty =
+{ XVT_String, "Name", "name", "Name of shared memory to write video frames to.", PropertyFlag_None };
+// Slots Count property
+static PropertyDescriptor slotsCountProperty =
+{ XVT_U4, "Slots Count", "slotsCount", "Number of video frames kept in shared memory ring.", PropertyFlag_None };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &nameProperty, &slotsCountProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** SharedMemoryPushPlugin::propertiesDescription = ( const PropertyDescriptor** ) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS_FUNCS_AND_FLAGS
+(
+    PluginID,
+    PluginFamilyID_VideoProcessing,
+
+    PluginType_VideoProcessing,
+    PluginVersion,
+    "Shared Memory Push",
+    "SharedMemoryPush",
+    "Plug-in to push video frames into named shared memory.",
+
+    "This plug-in writes video frames into named shared memory, so those can be picked by "
+    "<a href='{AF000003-00000000-00000021-00000001}'>Shared Memory Video</a> source running in another process "
+    "(or in the same one). Shared memory keeps a ring of the specified number of frames, each of which is "
+    "protected by a sequence lock. The plug-in never waits for readers - it simply overwrites the oldest frame, "
+    "while readers detect if a frame was changed while they were copying it.<br><br>"
+
+    "Shared memory is created on the first processed frame, its size is chosen to fit that frame. If a bigger "
+    "frame arrives later, shared memory gets re-created and readers re-attach to it automatically."
+    ,
+    &image_video_repeater_push_plugin_16x16,
+    0,
+    SharedMemoryPushPlugin,
+
+    sizeof( pluginProperties ) / sizeof( PropertyDescriptor* ),
+    pluginProperties,
+    PluginInitializer,
+    PluginCleaner,
+    0,
+    0,
+    0,
+    PluginFlag_NotSplittable
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    nameProperty.DefaultValue.type = XVT_String;
+    nameProperty.DefaultValue.value.strVal = XStringAlloc( "cvsandbox_video" );
+
+    slotsCountProperty.DefaultValue.type = XVT_U4;
+    slotsCountProperty.DefaultValue.value.uiVal = 4;
+
+    slotsCountProperty.MinValue.type = XVT_U4;
+    slotsCountProperty.MinValue.value.uiVal = 2;
+
+    slotsCountProperty.MaxValue.type = XVT_U4;
+    slotsCountProperty.MaxValue.value.uiVal = 16;
+}
+
+// Clean-up plug-in - deallocate strings
+static void PluginCleaner( )
+{
+    XVariantClear( &nameProperty.DefaultValue );
+}
@@ -0,0 +1,324 @@
+/*
+    Shared memory video plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "SharedMemoryVideoPlugin.hpp"
+#include "SharedFrameRing.hpp"
+#include <memory.h>
+#include <string>
+#include <XMutex.hpp>
+#include <XManualResetEvent.hpp>
+#include <XThread.hpp>
+#include <XTimer.hpp>
+
+using namespace std;
+using namespace CVSandbox;
+using namespace CVSandbox::Threading;
+
+namespace Private
+{
+    // Time interval (ms) between attempts to open shared memory, if it does not exist yet
+    static const uint32_t OPEN_RETRY_INTERVAL = 100;
+    // Time interval (ms) without new frames, after which it is checked if the writer has re-created shared memory
+    static const uint32_t STALE_CHECK_INTERVAL = 1000;
+
+    // Internal class which hides private parts of the SharedMemoryVideoPlugin class,
+    // so those are not exposed in the main class
+    class SharedMemoryVideoPluginData
+    {
+    public:
+        SharedMemoryVideoPluginData( ) : UserCallbacks( { 0 } ), UserParam( nullptr ),
+            Name( "cvsandbox_video" ), PollInterval( 1 )
+        {
+        }
+
+        // Video thread entry point
+        static void WorkerThreadHandler( void* param );
+        // Notify client about new video frame
+        void NewFrameNotify( const ximage* image );
+        // Run video loop in a background worker thread
+        void VideoSourceWorker( );
+
+    public:
+        VideoSourcePluginCallbacks  UserCallbacks;
+        void*                       UserParam;
+
+        string              Name;
+        uint16_t            PollInterval;
+
+        XMutex              Sync;
+        XManualResetEvent   ExitEvent;
+        XThread             BackgroundThread;
+        uint32_t            FramesCounter;
+    };
+}
+
+// ==========================================================================
+
+SharedMemoryVideoPlugin::SharedMemoryVideoPlugin( ) :
+    mData( new ::Private::SharedMemoryVideoPluginData( ) )
+{
+}
+
+SharedMemoryVideoPlugin::~SharedMemoryVideoPlugin( )
+{
+    delete mData;
+}
+
+void SharedMemoryVideoPlugin::Dispose( )
+{
+    delete this;
+}
+
+// Start video source so it initializes and begins providing video frames
+XErrorCode SharedMemoryVideoPlugin::Start( )
+{
+    XScopedLock lock( &mData->Sync );
+    XErrorCode  ret = ErrorFailed;
+
+    mData->FramesCounter = 0;
+    mData->ExitEvent.Reset( );
+
+    if ( mData->Name.empty( ) )
+    {
+        ret = ErrorInvalidConfiguration;
+    }
+    else if ( mData->BackgroundThread.Create( ::Private::SharedMemoryVideoPluginData::WorkerThreadHandler, mData ) )
+    {
+        ret = SuccessCode;
+    }
+
+    return ret;
+}
+
+// Signal video to stop, so it could finalize and clean-up
+void SharedMemoryVideoPlugin::SignalToStop( )
+{
+    XScopedLock lock( &mData->Sync );
+
+    if ( IsRunning( ) )
+    {
+        mData->ExitEvent.Signal( );
+    }
+}
+
+// Wait till video source stops
+void SharedMemoryVideoPlugin::WaitForStop( )
+{
+    if ( IsRunning( ) )
+    {
+        XScopedLock lock( &mData->Sync );
+        mData->ExitEvent.Signal( );
+    }
+
+    mData->BackgroundThread.Join( );
+}
+
+// Check if video source (its thread) is still running
+bool SharedMemoryVideoPlugin::IsRunning( )
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->BackgroundThread.IsRunning( );
+}
+
+// Terminate video source - call *ONLY* if video source looks to be frozen and does not stop
+// by itself when signalled (ideally this method should not exist and be called at all)
+void SharedMemoryVideoPlugin::Terminate( )
+{
+    XScopedLock lock( &mData->Sync );
+
+    if ( IsRunning( ) )
+    {
+        mData->BackgroundThread.Terminate( );
+    }
+}
+
+// Get number of frames received since the the start of the video source
+uint32_t SharedMemoryVideoPlugin::FramesReceived( )
+{
+    XScopedLock lock( &mData->Sync );
+    return mData->FramesCounter;
+}
+
+// Set callbacks for the video source
+void SharedMemoryVideoPlugin::SetCallbacks( const VideoSourcePluginCallbacks* callbacks, void* userParam )
+{
+    XScopedLock lock( &mData->Sync );
+
+    if ( callbacks != 0 )
+    {
+        memcpy( &mData->UserCallbacks, callbacks, sizeof( mData->UserCallbacks ) );
+        mData->UserParam = userParam;
+    }
+    else
+    {
+        memset( &mData->UserCallbacks, 0, sizeof( mData->UserCallbacks ) );
+        mData->UserParam = 0;
+    }
+}
+
+// Get specified property value of the plug-in
+XErrorCode SharedMemoryVideoPlugin::GetProperty( int32_t id, xvariant* value ) const
+{
+    XErrorCode ret = SuccessCode;
+
+    switch ( id )
+    {
+    case 0:
+        value->type         = XVT_String;
+        value->value.strVal = XStringAlloc( mData->Name.c_str( ) );
+        break;
+
+    case 1:
+        value->type         = XVT_U2;
+        value->value.usVal  = mData->PollInterval;
+        break;
+
+    default:
+        ret = ErrorInvalidProperty;
+        break;
+    }
+
+    return ret;
+}
+
+// Set specified property value of the plug-in
+XErrorCode SharedMemoryVideoPlugin::SetProperty( int32_t id, const xvariant* value )
+{
+    XErrorCode  ret = SuccessCode;
+    XScopedLock lock( &mData->Sync );
+
+    xvariant convertedValue;
+    XVariantInit( &convertedValue );
+
+    // make sure property value has expected type
+    ret = PropertyChangeTypeHelper( id, value, propertiesDescription, 2, &convertedValue );
+
+    if ( ret == SuccessCode )
+    {
+        switch ( id )
+        {
+        case 0:
+            mData->Name = string( convertedValue.value.strVal );
+            break;
+
+        case 1:
+            mData->PollInterval = convertedValue.value.usVal;
+            break;
+
+        default:
+            ret = ErrorInvalidProperty;
+            break;
+        }
+    }
+
+    XVariantClear( &convertedValue );
+
+    return ret;
+}
+
+namespace Private
+{
+    // Video thread entry point
+    void SharedMemoryVideoPluginData::WorkerThreadHandler( void* param )
+    {
+        static_cast<SharedMemoryVideoPluginData*>( param )->VideoSourceWorker( );
+    }
+
+    // Notify client about new video frame
+    void SharedMemoryVideoPluginData::NewFrameNotify( const ximage* image )
+    {
+        XScopedLock lock( &Sync );
+
+        FramesCounter++;
+
+        // provide image only if someone needs it
+        if ( UserCallbacks.NewImageCallback != NULL )
+        {
+            UserCallbacks.NewImageCallback( UserParam, image );
+        }
+    }
+
+    // Run video loop in a background thread
+    void SharedMemoryVideoPluginData::VideoSourceWorker( )
+    {
+        SharedFrameRing ring;
+        ximage*         image     = nullptr;
+        uint64_t        timestamp = 0;
+        uint64_t        lastCheck = 0;
+        string          name;
+        uint32_t        pollInterval;
+
+        {
+            XScopedLock lock( &Sync );
+            name         = Name;
+            pollInterval = PollInterval;
+        }
+
+        for ( ; ; )
+        {
+            uint32_t waitTime = pollInterval;
+
+            uint64_t now      = XTimer::GetTickCount( );
+
+            if ( ring.IsClosedByWriter( ) )
+            {
+                // writer has gone or is re-creating shared memory
+                ring.Close( );
+            }
+            else if ( ( ring.IsOpen( ) ) && ( now - lastCheck >= STALE_CHECK_INTERVAL ) )
+            {
+                // writer could crash without closing the ring, so check if a new one was created since then
+                if ( ring.IsReplaced( ) )
+                {
+                    ring.Close( );
+                }
+                lastCheck = now;
+            }
+
+            if ( !ring.IsOpen( ) )
+            {
+                if ( ring.Open( name ) )
+                {
+                    lastCheck = now;
+                }
+                else
+                {
+                    waitTime = OPEN_RETRY_INTERVAL;
+                }
+            }
+
+            // provide the most recent frame, if there is a new one since the last check
+            if ( ( ring.IsOpen( ) ) && ( ring.ReadImage( &image, &timestamp ) ) )
+            {
+                NewFrameNotify( image );
+                waitTime  = 0;
+                lastCheck = now;
+            }
+
+            if ( ExitEvent.Wait( waitTime ) )
+            {
+                break;
+            }
+        }
+
+        XImageFree( &image );
+    }
+}
@@ -0,0 +1,106 @@
+/*
+    Shared memory video plug-ins of Computer Vision Sandbox
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include <iplugincpp.hpp>
+#include "SharedMemoryVideoPlugin.hpp"
+#include <image_video_repeater_plugin_16x16.h>
+
+static void PluginInitializer( );
+static void PluginCleaner( );
+
+// Version of the plug-in
+static xversion PluginVersion = { 1, 0, 0 };
+
+// ID of the plug-in
+static xguid PluginID = { 0xAF000003, 0x00000000, 0x00000021, 0x00000001 };
+
+// Name property
+static PropertyDescriptor nameProperty =
+{ XVT_String, "Name", "name", "Name of shared memory to read video frames from.", PropertyFlag_None };
+// Poll Interval property
+static PropertyDescriptor pollIntervalProperty =
+{ XVT_U2, "Poll Interval", "pollInterval", "Time interval (ms) between checks for new video frames.", PropertyFlag_None };
+
+// Array of available properties
+static PropertyDescriptor* pluginProperties[] =
+{
+    &nameProperty, &pollIntervalProperty
+};
+
+// Let the class itself know description of its properties
+const PropertyDescriptor** SharedMemoryVideoPlugin::propertiesDescription = ( const PropertyDescriptor** ) pluginProperties;
+
+// Register the plug-in
+REGISTER_CPP_PLUGIN_WITH_PROPS
+(
+    PluginID,
+    PluginFamilyID_VirtualVideoSource,
+
+    PluginType_VideoSource,
+    PluginVersion,
+    "Shared Memory Video",
+    "SharedMemoryVideo",
+    "Video source plug-in, which provides video frames from shared memory.",
+
+    "This plug-in provides video frames written into named shared memory by the "
+    "<a href='{AF000003-00000000-00000021-00000002}'>Shared Memory Push</a> plug-in, which may run in another process. "
+    "Frames are exchanged through a ring of slots in shared memory without any encoding, so video can be passed "
+    "between processes at full frame rate. If the writer does not keep up, the video source always provides the "
+    "most recent frame skipping older ones.<br><br>"
+
+    "The video source keeps running if the shared memory does not exist yet or was closed by its writer - it "
+    "re-attaches to it as soon as the writer starts pushing frames again.<br><br>"
+
+    "<b>Note:</b> in order to get frames from a push plug-in, both must be configured with the same <b>Name</b>."
+    ,
+    &image_video_repeater_plugin_16x16,
+    0,
+    SharedMemoryVideoPlugin,
+
+    sizeof( pluginProperties ) / sizeof( PropertyDescriptor* ),
+    pluginProperties,
+    PluginInitializer,
+    PluginCleaner,
+    0
+);
+
+// Complete properties description by initializing those parts, which were not
+// initialized during properties array declaration
+static void PluginInitializer( )
+{
+    nameProperty.DefaultValue.type = XVT_String;
+    nameProperty.DefaultValue.value.strVal = XStringAlloc( "cvsandbox_video" );
+
+    pollIntervalProperty.DefaultValue.type = XVT_U2;
+    pollIntervalProperty.DefaultValue.value.usVal = 1;
+
+    pollIntervalProperty.MinValue.type = XVT_U2;
+    pollIntervalProperty.MinValue.value.usVal = 1;
+
+    pollIntervalProperty.MaxValue.type = XVT_U2;
+    pollIntervalProperty.MaxValue.value.usVal = 1000;
+}
+
+// Clean-up plug-in - deallocate strings
+static void PluginCleaner( )
+{
+    XVariantClear( &nameProperty.DefaultValue );
+}
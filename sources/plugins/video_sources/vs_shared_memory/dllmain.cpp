@@ -0,0 +1,23 @@
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <xtypes.h>
+
+BOOL APIENTRY DllMain( HMODULE hModule,
+                       DWORD  ul_reason_for_call,
+                       LPVOID lpReserved
+					 )
+{
+    XUNREFERENCED_PARAMETER( hModule )
+    XUNREFERENCED_PARAMETER( lpReserved )
+
+    switch ( ul_reason_for_call )
+    {
+        case DLL_PROCESS_ATTACH:
+        case DLL_THREAD_ATTACH:
+        case DLL_THREAD_DETACH:
+        case DLL_PROCESS_DETACH:
+            break;
+    }
+    return TRUE;
+}
+
@@ -0,0 +1,18 @@
+# vs_shared_memory plug-in source files
+
+# search path for source files
+VPATH = ../../
+
+# source files
+SRC = vs_shared_memory.cpp \
+	SharedMemoryVideoPlugin.cpp SharedMemoryVideoPluginDescriptor.cpp \
+	SharedMemoryPushPlugin.cpp SharedMemoryPushPluginDescriptor.cpp \
+	SharedFrameRing.cpp
+
+# additional include folders
+INCLUDES = -I../../../../../afx/afx_types -I../../../../../afx/afx_types+ \
+	-I../../../../../afx/afx_platform+ \
+	-I../../../../../core/iplugin -I../../../../../images
+
+# libraries to use
+LIBS =  -liplugin -lafx_platform+ -lafx_types+ -lafx_types
@@ -29,6 +29,7 @@
 
 #include <XThread.hpp>
 #include <XAutomationServer.hpp>
+#include <XVideoSourceSyncGroup.hpp>
 #include <XPluginsEngine.hpp>
 #include <XScriptingEnginePlugin.hpp>
 #include <XVideoSourceProcessingGraph.hpp>
@@ -61,6 +62,17 @@ private:
     string mPrefix;
 };
 
+// Listener to get groups of synchronized video frames
+class SyncGroupListener : public IVideoSourceSyncGroupListener
+{
+public:
+    virtual void OnSynchronizedFrames( const XSynchronizedFrames& frames )
+    {
+        printf( "## Got %s group of %d frames, skew %.1f ms \n", ( frames.IsPartial ) ? "partial" : "complete",
+                static_cast<int>( frames.Images.size( ) ), frames.Skew );
+    }
+};
+
 // Create instance of the specified video source and add it to the automation server
 static uint32_t AddVideoSourceToServer( const shared_ptr<const XPluginDescriptor>& pluginDescription,
                                         const shared_ptr<XAutomationServer>& server )
@@ -97,6 +109,7 @@ int main( int , char* [] )
         shared_ptr<XAutomationServer> server = XAutomationServer::Create( engine );
         VideoSourceListener           videoListener( "->" );
         VideoSourceListener           videoListener2( "=>" );
+        SyncGroupListener             syncListener;
         int                           serverTestsCount = 1; // 10;
         int                           videoTestsCount  = 1; // 100;
 
@@ -212,6 +225,20 @@ int main( int , char* [] )
                     printf( "failed starting performance monitor: %u \n", videoId1 );
                 }
 
+                // synchronize frames of both video sources
+                shared_ptr<XVideoSourceSyncGroup> syncGroup = XVideoSourceSyncGroup::Create( server, { videoId1, videoId2 } );
+
+                if ( syncGroup )
+                {
+                    syncGroup->SetTolerance( 40 );
+                    syncGroup->SetPolicy( XFrameSyncPolicy::WaitWithTimeout, 200 );
+
+                    if ( syncGroup->Start( &syncListener ) != SuccessCode )
+                    {
+                        printf( "failed starting synchronization group \n" );
+                    }
+                }
+
                 XThread::Sleep( 100 );
 
                 server->AddVideoSourceListener( videoId1, &videoListener2 );
@@ -221,6 +248,18 @@ int main( int , char* [] )
 
                 server->RemoveVideoSourceListener( videoId2, &videoListener2 );
 
+                // get statistics of the synchronization group
+                if ( syncGroup )
+                {
+                    syncGroup->Stop( );
+
+                    XVideoSourceSyncGroupInfo syncInfo = syncGroup->GetInfo( );
+
+                    printf( "Synchronized groups: %u complete, %u partial, %u frames dropped, skew %.1f / %.1f ms \n",
+                            syncInfo.FramesProvided, syncInfo.PartialFramesProvided, syncInfo.FramesDropped,
+                            syncInfo.AverageSkew, syncInfo.MaxSkew );
+                }
+
                 // get performance info for the 1st video source
                 server->EnableVideoProcessingPerformanceMonitor( videoId1, false );
                 vector<float> graphTiming = server->GetVideoProcessingGraphTiming( videoId1 );
@@ -0,0 +1,40 @@
+@echo off
+
+set PATH=%PATH%;%MINGW_BIN%
+
+set BUILD_FOLDER=out_make
+set PRO_FOLDER=..\..
+set PRO_NAME=player_display_test.pro
+
+if "%1"=="clean" (
+    echo "Cleaning player_display_test.exe build ..."
+    
+    rd /S /Q %BUILD_FOLDER%
+    
+) else (
+
+    if "%MINGW_BIN%"=="" (
+        echo "Cannot build player_display_test.exe because MinGW binary folder is not set (MINGW_BIN)."
+        goto EOF
+    )
+
+    if "%QT_MINGW_BIN%"=="" (
+        echo "Cannot build player_display_test.exe because Qt's MinGW binary folder is not set (QT_MINGW_BIN)."
+        goto EOF
+    )
+
+    mkdir %BUILD_FOLDER%
+    cd %BUILD_FOLDER%
+        
+    %QT_MINGW_BIN%\qmake.exe ..\%PRO_FOLDER%\%PRO_NAME%
+    
+    if "%1"=="debug" (
+        %MINGW_BIN%\mingw32-make.exe -f Makefile.Debug
+    ) else (
+        %MINGW_BIN%\mingw32-make.exe -f Makefile.Release
+    )
+    
+    cd ..
+)
+
+:EOF
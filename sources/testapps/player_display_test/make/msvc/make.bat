@@ -0,0 +1,33 @@
+@echo off
+
+set BUILD_FOLDER=out_make
+set PRO_FOLDER=..\..
+set PRO_NAME=player_display_test.pro
+
+if "%1"=="clean" (
+    echo "Cleaning player_display_test.exe build ..."
+    
+    rd /S /Q %BUILD_FOLDER%
+    
+) else (
+
+    if "%QT_MSVC_BIN%"=="" (
+        echo "Cannot build player_display_test.exe because Qt's MSVC binary folder is not set (QT_MSVC_BIN)."
+        goto EOF
+    )
+
+    mkdir %BUILD_FOLDER%
+    cd %BUILD_FOLDER%
+        
+    %QT_MSVC_BIN%\qmake.exe -o Makefile ..\%PRO_FOLDER%\%PRO_NAME%
+    
+    if "%1"=="debug" (
+        nmake -f Makefile.Debug
+    ) else (
+        nmake -f Makefile.Release
+    )
+    
+    cd ..
+)
+
+:EOF
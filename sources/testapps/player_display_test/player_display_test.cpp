@@ -0,0 +1,316 @@
+/*
+    Test application for measuring cost of displaying video in cvsandbox's video player
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// The application runs a grid of video players (like multi camera view of cvsandbox does), each
+// receiving synthetic video frames of the specified resolution from its own thread. It runs on
+// the "offscreen" Qt platform by default, so it does not need a display and can be run as
+// benchmark. Reported is the time spent by UI thread, the time spent by video threads in
+// delivering frames to players and the number of frames painted.
+//
+// Usage: player_display_test [cameras] [width] [height] [fps] [seconds] [hidden]
+//   cameras - number of video players/sources (16 by default);
+//   width, height - resolution of video frames (3840x2160 by default);
+//   fps - frame rate of video sources (30 by default);
+//   seconds - duration of the test (10 by default);
+//   hidden - number of players to hide (0 by default).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWidget>
+#include <QEvent>
+
+#include <XImage.hpp>
+#include <IVideoSource.hpp>
+#include "VideoSourcePlayerQt.hpp"
+
+using namespace std;
+using namespace CVSandbox;
+using namespace CVSandbox::Video;
+
+#define CELL_WIDTH  (320)
+#define CELL_HEIGHT (240)
+
+// Video source generating synthetic frames in a background thread
+class SyntheticVideoSource : public IVideoSource, private QThread
+{
+public:
+    SyntheticVideoSource( int width, int height, int fps ) :
+        mWidth( width ), mHeight( height ), mFps( fps ), mNeedToStop( false ),
+        mListener( 0 ), mSync( ), mFramesCount( 0 ), mDeliveryTime( 0 )
+    {
+    }
+
+    ~SyntheticVideoSource( )
+    {
+        SignalToStop( );
+        WaitForStop( );
+    }
+
+    virtual XErrorCode Start( )
+    {
+        mNeedToStop = false;
+        start( );
+        return SuccessCode;
+    }
+    virtual void SignalToStop( )
+    {
+        mNeedToStop = true;
+    }
+    virtual void WaitForStop( )
+    {
+        wait( );
+    }
+    virtual bool IsRunning( )
+    {
+        return isRunning( );
+    }
+    virtual void Terminate( )
+    {
+        terminate( );
+    }
+    virtual uint32_t FramesReceived( )
+    {
+        return mFramesCount;
+    }
+    virtual void SetListener( IVideoSourceListener* listener )
+    {
+        // the lock makes sure the old listener is not called anymore once the method returns
+        QMutexLocker locker( &mSync );
+        mListener = listener;
+    }
+
+    // Total time spent in the listener (nanoseconds)
+    qint64 DeliveryTime( ) const
+    {
+        return mDeliveryTime;
+    }
+
+private:
+    virtual void run( )
+    {
+        shared_ptr<XImage> image = XImage::Allocate( mWidth, mHeight, XPixelFormatRGB24 );
+        qint64             frameInterval = 1000000000 / mFps;
+        QElapsedTimer      clock;
+
+        clock.start( );
+
+        for ( uint32_t frame = 0; !mNeedToStop; frame++ )
+        {
+            // draw a moving gradient, so every frame is different
+            for ( int y = 0; y < mHeight; y++ )
+            {
+                memset( image->Data( ) + y * image->Stride( ), static_cast<uint8_t>( y + frame * 4 ), mWidth * 3 );
+            }
+
+            {
+                QMutexLocker locker( &mSync );
+
+                if ( mListener != 0 )
+                {
+                    QElapsedTimer deliveryClock;
+
+                    deliveryClock.start( );
+                    mListener->OnNewImage( image );
+                    mDeliveryTime += deliveryClock.nsecsElapsed( );
+                }
+            }
+
+            mFramesCount++;
+
+            qint64 sleepTime = ( frame + 1 ) * frameInterval - clock.nsecsElapsed( );
+            if ( sleepTime > 0 )
+            {
+                QThread::usleep( static_cast<unsigned long>( sleepTime / 1000 ) );
+            }
+        }
+    }
+
+private:
+    int                   mWidth;
+    int                   mHeight;
+    int                   mFps;
+    volatile bool         mNeedToStop;
+    IVideoSourceListener* mListener;
+    QMutex                mSync;
+    volatile uint32_t     mFramesCount;
+    qint64                mDeliveryTime;
+};
+
+// Event filter counting paint events of video players
+class PaintCounter : public QObject
+{
+public:
+    PaintCounter( ) : Count( 0 ) { }
+
+    virtual bool eventFilter( QObject* watched, QEvent* event )
+    {
+        if ( event->type( ) == QEvent::Paint )
+        {
+            Count++;
+        }
+        return QObject::eventFilter( watched, event );
+    }
+
+public:
+    uint32_t Count;
+};
+
+static int GetArgument( int argc, char* argv[], int index, int defaultValue )
+{
+    int value = ( argc > index ) ? atoi( argv[index] ) : defaultValue;
+    return ( value > 0 ) ? value : defaultValue;
+}
+
+int main( int argc, char* argv[] )
+{
+    int camerasCount = GetArgument( argc, argv, 1, 16 );
+    int frameWidth   = GetArgument( argc, argv, 2, 3840 );
+    int frameHeight  = GetArgument( argc, argv, 3, 2160 );
+    int fps          = GetArgument( argc, argv, 4, 30 );
+    int seconds      = GetArgument( argc, argv, 5, 10 );
+    int hiddenCount  = ( argc > 6 ) ? atoi( argv[6] ) : 0;
+    int columns      = 1;
+
+    while ( columns * columns < camerasCount )
+    {
+        columns++;
+    }
+
+    // run without display, unless some other platform is requested explicitly
+    if ( qgetenv( "QT_QPA_PLATFORM" ).isEmpty( ) )
+    {
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
+    }
+
+    QApplication app( argc, argv );
+    QWidget      window;
+    PaintCounter paintCounter;
+
+    vector<VideoSourcePlayerQt*>            players;
+    vector<shared_ptr<SyntheticVideoSource>> videoSources;
+
+    window.resize( columns * CELL_WIDTH, ( ( camerasCount + columns - 1 ) / columns ) * CELL_HEIGHT );
+
+    for ( int i = 0; i < camerasCount; i++ )
+    {
+        VideoSourcePlayerQt*             player      = new VideoSourcePlayerQt( &window );
+        shared_ptr<SyntheticVideoSource> videoSource = make_shared<SyntheticVideoSource>( frameWidth, frameHeight, fps );
+
+        player->setGeometry( ( i % columns ) * CELL_WIDTH, ( i / columns ) * CELL_HEIGHT, CELL_WIDTH, CELL_HEIGHT );
+        player->SetContolSize( QSize( CELL_WIDTH, CELL_HEIGHT ) );
+        player->installEventFilter( &paintCounter );
+        player->SetVideoSource( videoSource );
+
+        players.push_back( player );
+        videoSources.push_back( videoSource );
+    }
+
+    window.show( );
+
+    for ( int i = camerasCount - hiddenCount; i < camerasCount; i++ )
+    {
+        if ( i >= 0 )
+        {
+            players[i]->setVisible( false );
+        }
+    }
+
+    printf( "Players: %d (%d hidden), video: %dx%d at %d fps, platform: %s \n", camerasCount, hiddenCount,
+            frameWidth, frameHeight, fps, QApplication::platformName( ).toUtf8( ).constData( ) );
+
+    for ( size_t i = 0; i < videoSources.size( ); i++ )
+    {
+        videoSources[i]->Start( );
+    }
+
+    // run events' loop manually, so time spent in UI thread can be measured
+    QElapsedTimer testClock;
+    QElapsedTimer eventsClock;
+    qint64        uiTime = 0;
+
+    testClock.start( );
+
+    while ( testClock.elapsed( ) < seconds * 1000 )
+    {
+        eventsClock.start( );
+        app.processEvents( QEventLoop::AllEvents );
+        uiTime += eventsClock.nsecsElapsed( );
+
+        QThread::usleep( 500 );
+    }
+
+    double   testTime       = testClock.nsecsElapsed( ) / 1000000000.0;
+    uint32_t framesTotal    = 0;
+    qint64   visibleTime    = 0;
+    uint32_t visibleFrames  = 0;
+    qint64   hiddenTime     = 0;
+    uint32_t hiddenFrames   = 0;
+
+    for ( int i = 0; i < camerasCount; i++ )
+    {
+        videoSources[i]->SignalToStop( );
+    }
+    for ( int i = 0; i < camerasCount; i++ )
+    {
+        videoSources[i]->WaitForStop( );
+
+        framesTotal += videoSources[i]->FramesReceived( );
+
+        if ( players[i]->isVisible( ) )
+        {
+            visibleTime   += videoSources[i]->DeliveryTime( );
+            visibleFrames += videoSources[i]->FramesReceived( );
+        }
+        else
+        {
+            hiddenTime   += videoSources[i]->DeliveryTime( );
+            hiddenFrames += videoSources[i]->FramesReceived( );
+        }
+    }
+
+    printf( "Frames generated      : %u (%.1f fps per camera) \n", framesTotal, framesTotal / testTime / camerasCount );
+    printf( "Frames painted        : %u (%.1f fps per camera) \n", paintCounter.Count, paintCounter.Count / testTime / camerasCount );
+    printf( "UI thread busy        : %.1f %% \n", uiTime / 10000000.0 / testTime );
+    if ( visibleFrames != 0 )
+    {
+        printf( "Delivery, visible     : %.3f ms per frame \n", visibleTime / 1000000.0 / visibleFrames );
+    }
+    if ( hiddenFrames != 0 )
+    {
+        printf( "Delivery, hidden      : %.3f ms per frame \n", hiddenTime / 1000000.0 / hiddenFrames );
+    }
+
+    // players unsubscribe from video sources when destroyed
+    for ( int i = 0; i < camerasCount; i++ )
+    {
+        delete players[i];
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+TARGET = player_display_test
+TEMPLATE = app
+
+CONFIG += qt console
+greaterThan(QT_MAJOR_VERSION, 4): QT *= widgets
+
+INCLUDEPATH += ../../afx/afx_types/ \
+               ../../afx/afx_types+/ \
+               ../../afx/afx_imaging/ \
+               ../../afx/afx_video+/ \
+               ../../apps/cvsandbox \
+               ../../apps/cvsandboxtools
+
+message( $$MAKEFILE_GENERATOR )
+
+contains(QMAKE_TARGET.arch, x86_64) {
+    message("64-bit build")
+    CONFIG (debug, debug|release) {
+        message( "Debug build" )
+        OUTDIR = debug64
+    } else {
+        message( "Release build" )
+        OUTDIR = release64
+    }
+} else {
+    message("32-bit build")
+    CONFIG (debug, debug|release) {
+        message( "Debug build" )
+        OUTDIR = debug
+    } else {
+        message( "Release build" )
+        OUTDIR = release
+    }
+}
+
+contains(MAKEFILE_GENERATOR, "MSBUILD") || contains(MAKEFILE_GENERATOR, "MSVC.NET") {
+    message( "MSVC build" )
+    
+    MSVC_LIBS_DIR = $$PWD/../../../build/msvc/$$OUTDIR/lib
+
+    DESTDIR = $${MSVC_LIBS_DIR}/../bin
+
+    LIBS += $$MSVC_LIBS_DIR/cvsandboxtools.lib \
+            $$MSVC_LIBS_DIR/afx_imaging.lib \
+            $$MSVC_LIBS_DIR/afx_types+.lib \
+            $$MSVC_LIBS_DIR/afx_types.lib
+
+    QMAKE_CXXFLAGS += /D "_CRT_SECURE_NO_WARNINGS"
+    QMAKE_LFLAGS += /INCREMENTAL:NO
+}
+
+contains(MAKEFILE_GENERATOR, "MINGW") {
+    message( "MinGW build" )
+
+    MINGW_LIBS_DIR = $$PWD/../../../build/mingw/$$OUTDIR/lib
+
+    DESTDIR = $${MINGW_LIBS_DIR}/../bin
+
+    LIBS += -L$${MINGW_LIBS_DIR} \
+            -lcvsandboxtools \
+            -lafx_imaging \
+            -lafx_types+ \
+            -lafx_types
+
+    QMAKE_CXXFLAGS += -std=c++0x
+    LIBS += -fopenmp
+}
+
+message( "Out: " $$DESTDIR )
+
+SOURCES += player_display_test.cpp \
+    ../../apps/cvsandbox/VideoSourcePlayer.cpp \
+    ../../apps/cvsandbox/VideoSourcePlayerQt.cpp
+
+HEADERS += ../../apps/cvsandbox/VideoSourcePlayer.hpp \
+    ../../apps/cvsandbox/VideoSourcePlayerQt.hpp
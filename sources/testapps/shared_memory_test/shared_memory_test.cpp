@@ -0,0 +1,270 @@
+/*
+    Shared memory video plug-ins' test application
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#ifdef _MSC_VER
+#define _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include <stdio.h>
+#include <memory.h>
+#include <memory>
+#include <string>
+
+#include <XError.hpp>
+#include <XMutex.hpp>
+#include <XThread.hpp>
+#include <XPluginsEngine.hpp>
+#include <XVideoProcessingPlugin.hpp>
+#include <XVideoSourcePlugin.hpp>
+
+using namespace std;
+using namespace CVSandbox;
+using namespace CVSandbox::Threading;
+
+// Name of shared memory used by the test
+static const char* SHARED_MEMORY_NAME = "cvsandbox_shared_memory_test";
+// Time (ms) to wait for a pushed frame to arrive to the video source
+static const uint32_t FRAME_WAIT_TIME = 3000;
+
+// Video source listener keeping the last received frame
+class VideoSourceListener : public IVideoSourcePluginListener
+{
+public:
+    VideoSourceListener( ) : FramesCount( 0 ) { }
+
+    virtual void OnNewImage( const shared_ptr<const XImage>& image );
+    virtual void OnError( const string& errorMessage );
+
+    // Wait till the specified number of frames is received and get copy of the last one
+    shared_ptr<XImage> WaitForFrame( uint32_t framesCount );
+
+private:
+    XMutex             Sync;
+    uint32_t           FramesCount;
+    shared_ptr<XImage> LastImage;
+};
+
+static shared_ptr<XPlugin> CreatePlugin( const shared_ptr<const XPluginsModule>& module, const string& shortName );
+static shared_ptr<XImage> CreateTestImage( uint8_t seed );
+static bool CompareImages( const shared_ptr<const XImage>& image1, const shared_ptr<const XImage>& image2 );
+
+int main( int argc, char* argv[] )
+{
+    int failed = 0;
+
+    {
+        VideoSourceListener listener;
+
+        printf( "Testing shared memory push -> video source round trip ... \n" );
+
+        // load plug-ins
+        shared_ptr<XPluginsEngine> engine = XPluginsEngine::Create( );
+        engine->CollectModules( "./cvsplugins/" );
+
+        shared_ptr<const XPluginsModule> module = engine->GetModule( "vs_shared_memory" );
+
+        shared_ptr<XVideoProcessingPlugin> writer  = static_pointer_cast<XVideoProcessingPlugin>( CreatePlugin( module, "SharedMemoryPush" ) );
+        shared_ptr<XVideoProcessingPlugin> writer2 = static_pointer_cast<XVideoProcessingPlugin>( CreatePlugin( module, "SharedMemoryPush" ) );
+        shared_ptr<XVideoSourcePlugin>     source  = static_pointer_cast<XVideoSourcePlugin>( CreatePlugin( module, "SharedMemoryVideo" ) );
+
+        if ( ( !writer ) || ( !writer2 ) || ( !source ) )
+        {
+            printf( "Failed creating shared memory plug-ins \n" );
+            failed++;
+        }
+        else
+        {
+            uint32_t framesCount = 0;
+
+            writer->SetProperty( 0, XVariant( SHARED_MEMORY_NAME ) );
+            writer2->SetProperty( 0, XVariant( SHARED_MEMORY_NAME ) );
+            source->SetProperty( 0, XVariant( SHARED_MEMORY_NAME ) );
+
+            source->SetListener( &listener );
+            source->Start( );
+
+            // push few frames and check each of them arrives unchanged
+            printf( "> Pushing frames \n" );
+
+            for ( uint8_t i = 0; i < 5; i++ )
+            {
+                shared_ptr<XImage> image = CreateTestImage( i );
+                XErrorCode         ret   = writer->ProcessImage( image );
+
+                if ( ret != SuccessCode )
+                {
+                    printf( "Failed pushing frame #%u : %d (%s) \n", i, ret, XError::Description( ret ).c_str( ) );
+                    failed++;
+                }
+                else if ( !CompareImages( listener.WaitForFrame( ++framesCount ), image ) )
+                {
+                    printf( "Frame #%u did not arrive or differs from the pushed one \n", i );
+                    failed++;
+                }
+            }
+
+            // simulate crashed writer - another one re-creates shared memory, while the first one never closes it
+            printf( "> Pushing frame from a new writer \n" );
+            {
+                shared_ptr<XImage> image = CreateTestImage( 100 );
+                XErrorCode         ret   = writer2->ProcessImage( image );
+
+                if ( ret != SuccessCode )
+                {
+                    printf( "Failed pushing frame from a new writer : %d (%s) \n", ret, XError::Description( ret ).c_str( ) );
+                    failed++;
+                }
+                else
+                {
+                    shared_ptr<XImage> received;
+
+                    // the new writer may not be noticed till the source checks the ring, so keep pushing
+                    for ( int i = 0; ( i < 30 ) && ( !CompareImages( received, image ) ); i++ )
+                    {
+                        writer2->ProcessImage( image );
+                        received = listener.WaitForFrame( ++framesCount );
+
+                        if ( !received )
+                        {
+                            framesCount--;
+                        }
+                    }
+
+                    if ( !CompareImages( received, image ) )
+                    {
+                        printf( "Frame from a new writer did not arrive \n" );
+                        failed++;
+                    }
+                }
+            }
+
+            source->SignalToStop( );
+            source->WaitForStop( );
+            source->SetListener( nullptr );
+
+            writer->Reset( );
+            writer2->Reset( );
+        }
+    }
+
+    printf( "========================== \n" );
+    printf( "Test %s \n", ( failed == 0 ) ? "Passed" : "Failed" );
+    printf( "========================== \n" );
+
+#ifdef _MSC_VER
+    _CrtDumpMemoryLeaks( );
+#endif
+
+    return ( failed == 0 ) ? 0 : 1;
+}
+
+// Video source provides a new image
+void VideoSourceListener::OnNewImage( const shared_ptr<const XImage>& image )
+{
+    XScopedLock lock( &Sync );
+
+    if ( image )
+    {
+        LastImage = image->Clone( );
+    }
+    FramesCount++;
+}
+
+// An error occurred in the video source
+void VideoSourceListener::OnError( const string& errorMessage )
+{
+    printf( "! Error: %s \n", errorMessage.c_str( ) );
+}
+
+// Wait till the specified number of frames is received and get copy of the last one
+shared_ptr<XImage> VideoSourceListener::WaitForFrame( uint32_t framesCount )
+{
+    shared_ptr<XImage> ret;
+
+    for ( uint32_t waited = 0; waited < FRAME_WAIT_TIME; waited += 10 )
+    {
+        {
+            XScopedLock lock( &Sync );
+
+            if ( FramesCount >= framesCount )
+            {
+                ret = LastImage;
+                break;
+            }
+        }
+
+        XThread::Sleep( 10 );
+    }
+
+    return ret;
+}
+
+// Create instance of the plug-in from the specified module
+shared_ptr<XPlugin> CreatePlugin( const shared_ptr<const XPluginsModule>& module, const string& shortName )
+{
+    shared_ptr<XPlugin> plugin;
+
+    if ( module )
+    {
+        shared_ptr<const XPluginDescriptor> pluginDesc = module->GetPlugin( shortName );
+
+        if ( pluginDesc )
+        {
+            plugin = pluginDesc->CreateInstance( );
+        }
+    }
+
+    return plugin;
+}
+
+// Create RGB image filled with a pattern depending on the specified seed value
+shared_ptr<XImage> CreateTestImage( uint8_t seed )
+{
+    shared_ptr<XImage> image = XImage::Allocate( 320, 240, XPixelFormatRGB24 );
+
+    for ( int32_t y = 0; y < image->Height( ); y++ )
+    {
+        uint8_t* row = image->Data( ) + y * image->Stride( );
+
+        for ( int32_t x = 0; x < image->Width( ) * 3; x++ )
+        {
+            row[x] = static_cast<uint8_t>( x + y * 7 + seed * 13 );
+        }
+    }
+
+    return image;
+}
+
+// Check if two images have same size, format and pixels
+bool CompareImages( const shared_ptr<const XImage>& image1, const shared_ptr<const XImage>& image2 )
+{
+    bool ret = ( ( image1 ) && ( image2 ) && ( image1->Width( ) == image2->Width( ) ) &&
+                 ( image1->Height( ) == image2->Height( ) ) && ( image1->Format( ) == image2->Format( ) ) );
+
+    for ( int32_t y = 0; ( ret ) && ( y < image1->Height( ) ); y++ )
+    {
+        ret = ( memcmp( image1->Data( ) + y * image1->Stride( ), image2->Data( ) + y * image2->Stride( ),
+                        static_cast<size_t>( image1->Width( ) ) * 3 ) == 0 );
+    }
+
+    return ret;
+}
@@ -0,0 +1,259 @@
+/*
+    Video source synchronization group's test application
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#ifdef _MSC_VER
+#define _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include <stdio.h>
+#include <math.h>
+#include <memory>
+#include <vector>
+
+#include <XVideoFrameMatcher.hpp>
+
+using namespace std;
+using namespace CVSandbox;
+using namespace CVSandbox::Automation;
+
+// IDs of video sources used by the test
+static const uint32_t SOURCE_A = 1;
+static const uint32_t SOURCE_B = 2;
+
+// Test case feeding frames with the specified capture time (ms) into matcher and checking matched groups
+class MatchTest
+{
+public:
+    MatchTest( const char* name, uint32_t tolerance, XFrameSyncPolicy policy = XFrameSyncPolicy::DropUnmatched );
+
+    // Feed frame of the video source captured at the specified time
+    void AddFrame( uint32_t videoSourceId, int64_t msecCaptured );
+    // Match buffered frames at the specified time
+    void Match( int64_t msecNow = 0 );
+
+    // Check number of matched groups and the specified group
+    bool CheckCount( size_t count );
+    bool CheckGroup( size_t index, int64_t msecCapturedA, int64_t msecCapturedB, float skew );
+    bool CheckDropped( uint32_t framesDropped );
+
+    int Failed( ) const { return mFailed; }
+
+private:
+    const char*                 mName;
+    XVideoFrameMatcher          mMatcher;
+    vector<XSynchronizedFrames> mMatched;
+    shared_ptr<XImage>          mImage;
+    int                         mFailed;
+};
+
+int main( int, char* [] )
+{
+    int failed = 0;
+
+    printf( "Testing matching of video frames by capture time ... \n" );
+
+    // frames within tolerance are grouped
+    {
+        MatchTest test( "Basic match", 20 );
+
+        test.AddFrame( SOURCE_A, 100 );
+        test.AddFrame( SOURCE_B, 110 );
+        test.Match( );
+
+        test.CheckCount( 1 );
+        test.CheckGroup( 0, 100, 110, 10.0f );
+
+        failed += test.Failed( );
+    }
+
+    // newer frame of other video source does not match, even if the older one is further away
+    {
+        MatchTest test( "Newer frame outside tolerance", 20 );
+
+        test.AddFrame( SOURCE_A, 100 );
+        test.AddFrame( SOURCE_B, 50 );
+        test.AddFrame( SOURCE_B, 130 );
+        test.Match( );
+
+        test.CheckCount( 0 );
+        test.CheckDropped( 2 );
+
+        // the newer frame must be kept for the next match
+        test.AddFrame( SOURCE_A, 135 );
+        test.Match( );
+
+        test.CheckCount( 1 );
+        test.CheckGroup( 0, 135, 130, 5.0f );
+
+        failed += test.Failed( );
+    }
+
+    // the newer frame is taken, when it is closer to match time and within tolerance
+    {
+        MatchTest test( "Newer frame within tolerance", 20 );
+
+        test.AddFrame( SOURCE_A, 100 );
+        test.AddFrame( SOURCE_B, 50 );
+        test.AddFrame( SOURCE_B, 115 );
+        test.Match( );
+
+        test.CheckCount( 1 );
+        test.CheckGroup( 0, 100, 115, 15.0f );
+        test.CheckDropped( 1 );
+
+        failed += test.Failed( );
+    }
+
+    // too old frame is dropped, while the newest one waits for a match
+    {
+        MatchTest test( "Older frame outside tolerance", 20 );
+
+        test.AddFrame( SOURCE_A, 100 );
+        test.AddFrame( SOURCE_B, 50 );
+        test.Match( );
+
+        test.CheckCount( 0 );
+        test.CheckDropped( 1 );
+
+        test.AddFrame( SOURCE_B, 90 );
+        test.Match( );
+
+        test.CheckCount( 1 );
+        test.CheckGroup( 0, 100, 90, 10.0f );
+
+        failed += test.Failed( );
+    }
+
+    // frame without match is provided alone after timeout
+    {
+        MatchTest test( "Partial group after timeout", 20, XFrameSyncPolicy::WaitWithTimeout );
+
+        test.AddFrame( SOURCE_A, 100 );
+        test.Match( 150 );
+
+        test.CheckCount( 0 );
+
+        test.Match( 250 );
+
+        test.CheckCount( 1 );
+        test.CheckGroup( 0, 100, -1, 0.0f );
+
+        failed += test.Failed( );
+    }
+
+    printf( "========================== \n" );
+    printf( "Test %s \n", ( failed == 0 ) ? "Passed" : "Failed" );
+    printf( "========================== \n" );
+
+#ifdef _MSC_VER
+    _CrtDumpMemoryLeaks( );
+#endif
+
+    return ( failed == 0 ) ? 0 : 1;
+}
+
+MatchTest::MatchTest( const char* name, uint32_t tolerance, XFrameSyncPolicy policy ) :
+    mName( name ), mMatcher( vector<uint32_t>( { SOURCE_A, SOURCE_B } ) ), mMatched( ),
+    mImage( XImage::Allocate( 8, 8, XPixelFormatGrayscale8 ) ), mFailed( 0 )
+{
+    printf( "> %s \n", name );
+
+    mMatcher.SetTolerance( tolerance );
+    mMatcher.SetPolicy( policy, 100 );
+}
+
+// Feed frame of the video source captured at the specified time (it also arrives at that time)
+void MatchTest::AddFrame( uint32_t videoSourceId, int64_t msecCaptured )
+{
+    XVideoFrameTimestamps timestamps;
+
+    timestamps.Captured = timestamps.Arrived = msecCaptured * 1000;
+
+    mMatcher.AddFrame( videoSourceId, mImage, timestamps );
+}
+
+// Match buffered frames at the specified time
+void MatchTest::Match( int64_t msecNow )
+{
+    mMatched.clear( );
+    mMatcher.MatchFrames( msecNow * 1000, mMatched );
+}
+
+// Check number of matched groups
+bool MatchTest::CheckCount( size_t count )
+{
+    bool ret = ( mMatched.size( ) == count );
+
+    if ( !ret )
+    {
+        printf( "%s: expected %u groups of frames, got %u \n", mName,
+                static_cast<uint32_t>( count ), static_cast<uint32_t>( mMatched.size( ) ) );
+        mFailed++;
+    }
+
+    return ret;
+}
+
+// Check capture time of frames in the specified group (-1 for missing frame) and its skew
+bool MatchTest::CheckGroup( size_t index, int64_t msecCapturedA, int64_t msecCapturedB, float skew )
+{
+    bool ret = ( index < mMatched.size( ) );
+
+    if ( ret )
+    {
+        const XSynchronizedFrames& frames     = mMatched[index];
+        int64_t                    expected[] = { msecCapturedA, msecCapturedB };
+
+        ret = ( frames.Images.size( ) == 2 ) && ( frames.Timestamps.size( ) == 2 ) &&
+              ( frames.IsPartial == ( ( msecCapturedA == -1 ) || ( msecCapturedB == -1 ) ) ) &&
+              ( fabs( frames.Skew - skew ) < 0.001f );
+
+        for ( size_t i = 0; ( ret ) && ( i < 2 ); i++ )
+        {
+            ret = ( expected[i] == -1 ) ? ( !frames.Images[i] ) :
+                  ( ( frames.Images[i] ) && ( frames.Timestamps[i].Captured == expected[i] * 1000 ) );
+        }
+    }
+
+    if ( !ret )
+    {
+        printf( "%s: group #%u does not match expected frames (%d, %d) with skew %.1f \n", mName,
+                static_cast<uint32_t>( index ), static_cast<int>( msecCapturedA ), static_cast<int>( msecCapturedB ), skew );
+        mFailed++;
+    }
+
+    return ret;
+}
+
+// Check total number of dropped frames
+bool MatchTest::CheckDropped( uint32_t framesDropped )
+{
+    bool ret = ( mMatcher.Info( ).FramesDropped == framesDropped );
+
+    if ( !ret )
+    {
+        printf( "%s: expected %u dropped frames, got %u \n", mName, framesDropped, mMatcher.Info( ).FramesDropped );
+        mFailed++;
+    }
+
+    return ret;
+}
@@ -0,0 +1,13 @@
+# two_source_routines_test test application's source files
+
+# search path for source files
+VPATH = ../../
+
+# source files
+SRC = two_source_routines_test.cpp
+
+# additional include folders
+INCLUDES = -I../../../../afx/afx_types -I../../../../afx/afx_imaging
+
+# libraries to use
+LIBS = -lafx_imaging -lafx_types
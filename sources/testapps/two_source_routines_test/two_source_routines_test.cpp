@@ -0,0 +1,236 @@
+/*
+    Test application comparing SSE2 and plain C versions of two source image routines
+
+    Copyright (C) 2011-2019, cvsandbox
+    http://www.cvsandbox.com/contacts.html
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#ifdef _MSC_VER
+#define _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <functional>
+
+#include <ximaging.h>
+#include <xcpuid.h>
+
+using namespace std;
+
+// Routine to test - it gets optional counter of pixels for routines providing one
+typedef function<XErrorCode( ximage*, const ximage*, uint32_t* )> TwoSourceRoutine;
+
+// Size of test images - rows are long enough for SSE2 code and have some bytes left for plain C code
+static const int32_t IMAGE_WIDTH  = 37;
+static const int32_t IMAGE_HEIGHT = 5;
+
+static int TestRoutine( const char* name, const TwoSourceRoutine& routine );
+static int TestRoutine( const char* name, const TwoSourceRoutine& routine, XPixelFormat format );
+
+int main( int, char* [] )
+{
+    static const float factors[] = { 0.0f, 0.1f, 0.3f, 0.5f, 0.77f, 0.9f, 1.0f };
+    char               name[64];
+    int                failed = 0;
+
+    if ( !IsSSE2( ) )
+    {
+        printf( "CPU does not support SSE2, so only plain C code is tested \n\n" );
+    }
+
+    printf( "Comparing SSE2 and plain C versions of two source image routines ... \n" );
+
+    failed += TestRoutine( "Merge", [] ( ximage* image1, const ximage* image2, uint32_t* )
+    {
+        return MergeImages( image1, image2 );
+    } );
+
+    failed += TestRoutine( "Intersect", [] ( ximage* image1, const ximage* image2, uint32_t* )
+    {
+        return IntersectImages( image1, image2 );
+    } );
+
+    failed += TestRoutine( "Move towards", [] ( ximage* image1, const ximage* image2, uint32_t* )
+    {
+        return MoveTowardsImages( image1, image2, 20 );
+    } );
+
+    for ( float factor : factors )
+    {
+        sprintf( name, "Fade (%.2f)", factor );
+        failed += TestRoutine( name, [factor] ( ximage* image1, const ximage* image2, uint32_t* )
+        {
+            return FadeImages( image1, image2, factor );
+        } );
+
+        sprintf( name, "Add (%.2f)", factor );
+        failed += TestRoutine( name, [factor] ( ximage* image1, const ximage* image2, uint32_t* )
+        {
+            return AddImages( image1, image2, factor );
+        } );
+
+        sprintf( name, "Subtract (%.2f)", factor );
+        failed += TestRoutine( name, [factor] ( ximage* image1, const ximage* image2, uint32_t* )
+        {
+            return SubtractImages( image1, image2, factor );
+        } );
+    }
+
+    failed += TestRoutine( "Diff", [] ( ximage* image1, const ximage* image2, uint32_t* )
+    {
+        return DiffImages( image1, image2 );
+    } );
+
+    failed += TestRoutine( "Thresholded diff", [] ( ximage* image1, const ximage* image2, uint32_t* counter )
+    {
+        xargb hiColor  = { 0xFFFF8040 };
+        xargb lowColor = { 0xFF000000 };
+
+        return DiffImagesThresholded( image1, image2, 60, counter, hiColor, lowColor );
+    } );
+
+    failed += TestRoutine( "Multiply blending", [] ( ximage* image1, const ximage* image2, uint32_t* )
+    {
+        return BlendImages( image1, image2, BlendMode_Multiply );
+    } );
+
+    failed += TestRoutine( "Screen blending", [] ( ximage* image1, const ximage* image2, uint32_t* )
+    {
+        return BlendImages( image1, image2, BlendMode_Screen );
+    } );
+
+    failed += TestRoutine( "Overlay blending", [] ( ximage* image1, const ximage* image2, uint32_t* )
+    {
+        return BlendImages( image1, image2, BlendMode_Overlay );
+    } );
+
+    printf( "========================== \n" );
+    printf( "Test %s \n", ( failed == 0 ) ? "Passed" : "Failed" );
+    printf( "========================== \n" );
+
+#ifdef _MSC_VER
+    _CrtDumpMemoryLeaks( );
+#endif
+
+    return ( failed == 0 ) ? 0 : 1;
+}
+
+// Test the routine with all supported pixel formats
+int TestRoutine( const char* name, const TwoSourceRoutine& routine )
+{
+    static const XPixelFormat formats[] = { XPixelFormatGrayscale8, XPixelFormatRGB24, XPixelFormatRGBA32 };
+    int                       failed    = 0;
+
+    printf( "> %s \n", name );
+
+    for ( XPixelFormat format : formats )
+    {
+        failed += TestRoutine( name, routine, format );
+    }
+
+    return failed;
+}
+
+// Process complete image, which is done mostly by SSE2 code, and then compare it with every pixel processed
+// on its own, which is done by plain C code only (1 pixel is too small for SSE2 code)
+int TestRoutine( const char* name, const TwoSourceRoutine& routine, XPixelFormat format )
+{
+    ximage*  source1    = nullptr;
+    ximage*  source2    = nullptr;
+    ximage*  result     = nullptr;
+    ximage*  pixel1     = nullptr;
+    ximage*  pixel2     = nullptr;
+    uint32_t counter    = 0;
+    uint32_t pixelCount = 0;
+    int      failed     = 0;
+
+    XImageAllocate( IMAGE_WIDTH, IMAGE_HEIGHT, format, &source1 );
+    XImageAllocate( IMAGE_WIDTH, IMAGE_HEIGHT, format, &source2 );
+    XImageAllocate( 1, 1, format, &pixel1 );
+    XImageAllocate( 1, 1, format, &pixel2 );
+
+    int pixelSize = static_cast<int>( XImageBitsPerPixel( format ) / 8 );
+    int lineSize  = IMAGE_WIDTH * pixelSize;
+
+    // same random values every time, so any failure can be reproduced
+    srand( 1234 );
+
+    for ( int y = 0; y < IMAGE_HEIGHT; y++ )
+    {
+        uint8_t* row1 = source1->data + y * source1->stride;
+        uint8_t* row2 = source2->data + y * source2->stride;
+
+        for ( int x = 0; x < lineSize; x++ )
+        {
+            row1[x] = static_cast<uint8_t>( rand( ) & 0xFF );
+            row2[x] = static_cast<uint8_t>( rand( ) & 0xFF );
+        }
+    }
+
+    // make sure extreme values are checked as well
+    source1->data[0] = 0;
+    source2->data[0] = 255;
+    source1->data[1] = 255;
+    source2->data[1] = 0;
+    source1->data[2] = source2->data[2] = 255;
+    source1->data[3] = source2->data[3] = 0;
+
+    XImageClone( source1, &result );
+
+    if ( routine( result, source2, &counter ) != SuccessCode )
+    {
+        printf( "%s: failed processing image of %u bpp \n", name, XImageBitsPerPixel( format ) );
+        failed++;
+    }
+
+    for ( int y = 0; ( y < IMAGE_HEIGHT ) && ( failed == 0 ); y++ )
+    {
+        for ( int x = 0; ( x < IMAGE_WIDTH ) && ( failed == 0 ); x++ )
+        {
+            uint32_t pixelCounter = 0;
+
+            memcpy( pixel1->data, source1->data + y * source1->stride + x * pixelSize, pixelSize );
+            memcpy( pixel2->data, source2->data + y * source2->stride + x * pixelSize, pixelSize );
+
+            routine( pixel1, pixel2, &pixelCounter );
+            pixelCount += pixelCounter;
+
+            if ( memcmp( pixel1->data, result->data + y * result->stride + x * pixelSize, pixelSize ) != 0 )
+            {
+                printf( "%s: results differ for pixel (%d, %d) of %u bpp image \n", name, x, y, XImageBitsPerPixel( format ) );
+                failed++;
+            }
+        }
+    }
+
+    if ( ( failed == 0 ) && ( pixelCount != counter ) )
+    {
+        printf( "%s: pixel counters differ for %u bpp image - %u vs %u \n", name, XImageBitsPerPixel( format ), counter, pixelCount );
+        failed++;
+    }
+
+    XImageFree( &source1 );
+    XImageFree( &source2 );
+    XImageFree( &result );
+    XImageFree( &pixel1 );
+    XImageFree( &pixel2 );
+
+    return failed;
+}
@@ -90,14 +90,14 @@ void ReadVideoFile( const shared_ptr<XFFmpegVideoFileReader>& fileReader, const
         if ( counter == 1 )
         {
             sprintf( imageFileName, "%s.%d.png", fileName.c_str( ), counter );
-            XEncodePng( imageFileName, image->ImageData( ) );
+            XEncodePng( imageFileName, image->ImageData( ), nullptr );
         }
     }
 
     if ( counter != 0 )
     {
         sprintf( imageFileName, "%s.%d.png", fileName.c_str( ), counter );
-        XEncodePng( imageFileName, image->ImageData( ) );
+        XEncodePng( imageFileName, image->ImageData( ), nullptr );
     }
 
     printf( "Got %d frames \n", counter );